@@ -260,9 +260,15 @@ if (WAMR_BUILD_MEMORY64 EQUAL 1)
     message (FATAL_ERROR "-- Memory64 is only available on the 64-bit platform/target")
   endif()
   add_definitions (-DWASM_ENABLE_MEMORY64=1)
-  set (WAMR_DISABLE_HW_BOUND_CHECK 1)
   message ("     Memory64 memory enabled")
 endif ()
+if (WAMR_BUILD_MULTI_MEMORY EQUAL 1)
+  if (WAMR_BUILD_FAST_JIT EQUAL 1 OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message (FATAL_ERROR "-- Multi-memory isn't supported by fast jit and mini loader")
+  endif ()
+  add_definitions (-DWASM_ENABLE_MULTI_MEMORY=1)
+  message ("     Multi-memory enabled")
+endif ()
 if (WAMR_BUILD_THREAD_MGR EQUAL 1)
   message ("     Thread manager enabled")
 endif ()
@@ -323,6 +329,10 @@ if (WAMR_BUILD_MEMORY_PROFILING EQUAL 1)
   add_definitions (-DWASM_ENABLE_MEMORY_PROFILING=1)
   message ("     Memory profiling enabled")
 endif ()
+if (WAMR_BUILD_SHARED_HEAP EQUAL 1)
+  add_definitions (-DWASM_ENABLE_SHARED_HEAP=1)
+  message ("     Shared heap enabled")
+endif ()
 if (WAMR_BUILD_PERF_PROFILING EQUAL 1)
   add_definitions (-DWASM_ENABLE_PERF_PROFILING=1)
   message ("     Performance profiling enabled")
@@ -319,6 +319,11 @@
 #define WASM_ENABLE_MEMORY_PROFILING 0
 #endif
 
+/* Shared heap mapped into the linear memories of the instances */
+#ifndef WASM_ENABLE_SHARED_HEAP
+#define WASM_ENABLE_SHARED_HEAP 0
+#endif
+
 /* Memory tracing */
 #ifndef WASM_ENABLE_MEMORY_TRACING
 #define WASM_ENABLE_MEMORY_TRACING 0
@@ -372,6 +377,54 @@
 #define WASM_GLOBAL_HEAP_SIZE (10 * 1024 * 1024)
 #endif
 
+/* The per-thread caches of small blocks in front of the global heap pool
+   (Alloc_With_Pool): the max size of the cached blocks in bytes, 0 to
+   disable the caches, and the max count of the blocks cached in each
+   size class of a thread */
+#ifndef GC_THREAD_CACHE_MAX_SIZE
+#define GC_THREAD_CACHE_MAX_SIZE 256
+#endif
+
+#ifndef GC_THREAD_CACHE_CLASS_CAPACITY
+#define GC_THREAD_CACHE_CLASS_CAPACITY 16
+#endif
+
+/* The max size in bytes of the blocks kept in the slab lists of the EMS
+   heaps (the global heap and the app heaps), which are freed and reused
+   in O(1) without being merged, 0 to disable the slab lists */
+#ifndef GC_SLAB_MAX_SIZE
+#define GC_SLAB_MAX_SIZE 128
+#endif
+
+/* The max count of the minor collections of the WasmGC heap between two
+   major collections, the minor collection only traces the objects
+   allocated since the previous collection and the old objects written
+   since then, 0 to always do the major collection */
+#ifndef GC_MINOR_GC_MAX_COUNT
+#define GC_MINOR_GC_MAX_COUNT 8
+#endif
+
+/* The max time in microseconds of a marking step of the WasmGC heap,
+   the marking is done in small steps interleaved with the allocations
+   to bound the pause time, 0 to mark all objects in one pause */
+#ifndef GC_INCREMENTAL_MARK_TIME_BUDGET
+#define GC_INCREMENTAL_MARK_TIME_BUDGET 0
+#endif
+
+/* Number of the helper threads which mark the objects of the WasmGC heap
+   together with the thread triggering the collection, 0 to disable */
+#ifndef GC_PARALLEL_MARK_THREAD_NUM
+#define GC_PARALLEL_MARK_THREAD_NUM 0
+#endif
+
+/* The max number of the super types recorded in the display of a WasmGC
+   type, which checks in constant time whether the type is a subtype of
+   another type whose inherit depth is less than it, the check of a deeper
+   super type walks the parent types from the type */
+#ifndef GC_TYPE_SUPER_DISPLAY_SIZE
+#define GC_TYPE_SUPER_DISPLAY_SIZE 32
+#endif
+
 /* Default length of queue */
 #ifndef DEFAULT_QUEUE_LENGTH
 #define DEFAULT_QUEUE_LENGTH 50
@@ -396,6 +449,34 @@
 #define GC_HEAP_SIZE_MIN (4 * 1024)
 #define GC_HEAP_SIZE_MAX (1024 * 1024 * 1024)
 
+/* The sizing policy of the gc heap which can grow from its initial size
+   to RuntimeInitArgs.gc_heap_max_size: after a collection the heap grows
+   until GC_HEAP_MIN_FREE_RATIO percent of it is free, and shrinks until
+   GC_HEAP_MAX_FREE_RATIO percent of it is free if GC_HEAP_RESIZE_STEP
+   bytes at least can be released. If the heap has to grow and the
+   collection is done within GC_HEAP_MIN_GC_INTERVAL microseconds after
+   the previous one, the allocation rate is regarded as high and the heap
+   grows by half of its size at least. The heap also grows by
+   GC_HEAP_RESIZE_STEP bytes at least when an allocation fails after the
+   collection, and it doesn't shrink until GC_HEAP_SHRINK_DELAY
+   collections are done after it grew, so as not to shrink and grow
+   again and again. */
+#ifndef GC_HEAP_MIN_FREE_RATIO
+#define GC_HEAP_MIN_FREE_RATIO 30
+#endif
+#ifndef GC_HEAP_MAX_FREE_RATIO
+#define GC_HEAP_MAX_FREE_RATIO 70
+#endif
+#ifndef GC_HEAP_RESIZE_STEP
+#define GC_HEAP_RESIZE_STEP (64 * 1024)
+#endif
+#ifndef GC_HEAP_MIN_GC_INTERVAL
+#define GC_HEAP_MIN_GC_INTERVAL 1000
+#endif
+#ifndef GC_HEAP_SHRINK_DELAY
+#define GC_HEAP_SHRINK_DELAY 8
+#endif
+
 /* Default wasm stack size of each app */
 #if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
 #define DEFAULT_WASM_STACK_SIZE (16 * 1024)
@@ -659,6 +740,11 @@
 #define WASM_ENABLE_MEMORY64 0
 #endif
 
+/* Disable multi-memory by default */
+#ifndef WASM_ENABLE_MULTI_MEMORY
+#define WASM_ENABLE_MULTI_MEMORY 0
+#endif
+
 #ifndef WASM_TABLE_MAX_SIZE
 #define WASM_TABLE_MAX_SIZE 1024
 #endif
@@ -667,6 +753,19 @@
 #define WASM_MEM_ALLOC_WITH_USAGE 0
 #endif
 
+/* The max count of the released linear memory reservations (8 GB each when
+   the hardware bound check is enabled) kept for reuse, 0 to disable it */
+#ifndef WASM_MEM_SLOT_CACHE_SIZE
+#define WASM_MEM_SLOT_CACHE_SIZE 32
+#endif
+
+/* The minimum total size of the active data segments of a module for
+   which a copy-on-write image of the initial linear memory is created
+   at load time, 0 to disable the image */
+#ifndef WASM_MEM_DATA_IMAGE_MIN_SIZE
+#define WASM_MEM_DATA_IMAGE_MIN_SIZE (64 * 1024)
+#endif
+
 #ifndef WASM_ENABLE_FUZZ_TEST
 #define WASM_ENABLE_FUZZ_TEST 0
 #endif
@@ -10,6 +10,7 @@
 #include "../common/wasm_runtime_common.h"
 #include "../common/wasm_native.h"
 #include "../common/wasm_loader_common.h"
+#include "../common/wasm_memory.h"
 #include "../compilation/aot.h"
 
 #if WASM_ENABLE_DEBUG_AOT != 0
@@ -21,6 +22,16 @@
 #include "aot_perf_map.h"
 #endif
 
+#if (defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+     || defined(BUILD_TARGET_X86_32))                              \
+    && !defined(BH_PLATFORM_LINUX_SGX)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 #define YMM_PLT_PREFIX "__ymm@"
 #define XMM_PLT_PREFIX "__xmm@"
 #define REAL_PLT_PREFIX "__real@"
@@ -468,6 +479,32 @@ check_feature_flags(char *error_buf, uint32 error_buf_size,
                       "garbage collection is not enabled in this build");
         return false;
     }
+#elif GC_MINOR_GC_MAX_COUNT > 0 || GC_INCREMENTAL_MARK_TIME_BUDGET > 0
+    /* The minor collection and the incremental marking require the
+       write barrier */
+    if ((feature_flags & WASM_FEATURE_GARBAGE_COLLECTION)
+        && !(feature_flags & WASM_FEATURE_GC_WRITE_BARRIER)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "the AOT file is compiled without the GC write barrier, "
+                      "please re-generate it with the latest wamrc");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_EXCE_HANDLING == 0
+    if (feature_flags & WASM_FEATURE_EXCEPTION_HANDLING) {
+        set_error_buf(error_buf, error_buf_size,
+                      "exception handling is not enabled in this build");
+        return false;
+    }
+#endif
+
+#if WASM_ENABLE_MULTI_MEMORY == 0
+    if (feature_flags & WASM_FEATURE_MULTI_MEMORY) {
+        set_error_buf(error_buf, error_buf_size,
+                      "multi-memory is not enabled in this build");
+        return false;
+    }
 #endif
 
     return true;
@@ -936,6 +973,9 @@ load_custom_section(const uint8 *buf, const uint8 *buf_end, AOTModule *module,
             else
                 LOG_VERBOSE("Load name section success.");
             break;
+        case AOT_CUSTOM_SECTION_FUNC_VARIANT:
+            /* Loaded together with the function section */
+            break;
 #if WASM_ENABLE_STRINGREF != 0
         case AOT_CUSTOM_SECTION_STRING_LITERAL:
             if (!load_string_literal_section(buf, buf_end, module,
@@ -1580,6 +1620,9 @@ destroy_type(AOTType *type)
         return;
     }
 
+    if (type->super_types)
+        wasm_runtime_free(type->super_types);
+
     if (type->type_flag == WASM_TYPE_FUNC) {
         AOTFuncType *func_type = (AOTFuncType *)type;
         if (func_type->ref_type_maps != NULL) {
@@ -1943,6 +1986,12 @@ load_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
                     module->types[j]->root_type = module->types[j];
                     module->types[j]->inherit_depth = 0;
                 }
+
+                if (!wasm_type_create_super_types(module->types[j])) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "allocate memory failed");
+                    goto fail;
+                }
             }
 
             for (j = i - rec_idx; j <= i; j++) {
@@ -2719,6 +2768,202 @@ fail:
     return false;
 }
 
+#if (defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+     || defined(BUILD_TARGET_X86_32))                              \
+    && !defined(BH_PLATFORM_LINUX_SGX)
+static void
+get_cpuid(uint32 leaf, uint32 subleaf, uint32 regs[4])
+{
+#if defined(_MSC_VER)
+    __cpuidex((int *)regs, (int)leaf, (int)subleaf);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64
+get_xcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32 eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64)edx << 32) | eax;
+#endif
+}
+
+/* Get the AOT_CPU_FEATURE_XXX flags supported by the host CPU and OS */
+static uint64
+get_host_cpu_features()
+{
+    uint32 regs[4], max_leaf;
+    uint64 features = 0, xcr0 = 0;
+    bool os_avx, os_avx512;
+
+    get_cpuid(0, 0, regs);
+    max_leaf = regs[0];
+    if (max_leaf < 1)
+        return 0;
+
+    get_cpuid(1, 0, regs);
+    if (regs[2] & (1 << 0))
+        features |= AOT_CPU_FEATURE_SSE3;
+    if (regs[2] & (1 << 9))
+        features |= AOT_CPU_FEATURE_SSSE3;
+    if (regs[2] & (1 << 19))
+        features |= AOT_CPU_FEATURE_SSE4_1;
+    if (regs[2] & (1 << 20))
+        features |= AOT_CPU_FEATURE_SSE4_2;
+    if (regs[2] & (1 << 22))
+        features |= AOT_CPU_FEATURE_MOVBE;
+    if (regs[2] & (1 << 23))
+        features |= AOT_CPU_FEATURE_POPCNT;
+    /* OSXSAVE */
+    if (regs[2] & (1 << 27))
+        xcr0 = get_xcr0();
+
+    /* The OS saves the XMM/YMM registers, and the opmask/ZMM registers
+       on context switch */
+    os_avx = (xcr0 & 0x6) == 0x6;
+    os_avx512 = (xcr0 & 0xE6) == 0xE6;
+
+    if (os_avx) {
+        if (regs[2] & (1 << 28))
+            features |= AOT_CPU_FEATURE_AVX;
+        if (regs[2] & (1 << 12))
+            features |= AOT_CPU_FEATURE_FMA;
+        if (regs[2] & (1 << 29))
+            features |= AOT_CPU_FEATURE_F16C;
+    }
+
+    if (max_leaf >= 7) {
+        get_cpuid(7, 0, regs);
+        if (regs[1] & (1 << 3))
+            features |= AOT_CPU_FEATURE_BMI;
+        if (regs[1] & (1 << 8))
+            features |= AOT_CPU_FEATURE_BMI2;
+        if (os_avx && (regs[1] & (1 << 5)))
+            features |= AOT_CPU_FEATURE_AVX2;
+        if (os_avx512) {
+            if (regs[1] & (1 << 16))
+                features |= AOT_CPU_FEATURE_AVX512F;
+            if (regs[1] & (1 << 17))
+                features |= AOT_CPU_FEATURE_AVX512DQ;
+            if (regs[1] & (1 << 21))
+                features |= AOT_CPU_FEATURE_AVX512IFMA;
+            if (regs[1] & (1 << 28))
+                features |= AOT_CPU_FEATURE_AVX512CD;
+            if (regs[1] & (1 << 30))
+                features |= AOT_CPU_FEATURE_AVX512BW;
+            if (regs[1] & (1u << 31))
+                features |= AOT_CPU_FEATURE_AVX512VL;
+            if (regs[2] & (1 << 1))
+                features |= AOT_CPU_FEATURE_AVX512VBMI;
+            if (regs[2] & (1 << 6))
+                features |= AOT_CPU_FEATURE_AVX512VBMI2;
+            if (regs[2] & (1 << 11))
+                features |= AOT_CPU_FEATURE_AVX512VNNI;
+            if (regs[2] & (1 << 12))
+                features |= AOT_CPU_FEATURE_AVX512BITALG;
+            if (regs[2] & (1 << 14))
+                features |= AOT_CPU_FEATURE_AVX512VPOPCNTDQ;
+        }
+    }
+
+    get_cpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000001) {
+        get_cpuid(0x80000001, 0, regs);
+        /* ABM */
+        if (regs[2] & (1 << 5))
+            features |= AOT_CPU_FEATURE_LZCNT;
+    }
+
+    return features;
+}
+#else
+static uint64
+get_host_cpu_features()
+{
+    return 0;
+}
+#endif
+
+static bool
+load_func_variant_section(const uint8 *buf, const uint8 *buf_end,
+                          AOTModule *module, char *error_buf,
+                          uint32 error_buf_size)
+{
+    const uint8 *p = buf, *p_end = buf_end;
+    uint64 cpu_features, host_cpu_features = get_host_cpu_features();
+    uint32 variant_count, func_count, func_index, text_offset, i, j;
+
+    read_uint32(p, p_end, variant_count);
+
+    /* The variants are sorted from the least capable CPU to the most
+       capable one, the last variant supported by the host CPU wins */
+    for (i = 0; i < variant_count; i++) {
+        read_uint64(p, p_end, cpu_features);
+        read_uint32(p, p_end, func_count);
+
+        for (j = 0; j < func_count; j++) {
+            read_uint32(p, p_end, func_index);
+            read_uint32(p, p_end, text_offset);
+
+            if (func_index >= module->func_count
+                || text_offset >= module->code_size) {
+                set_error_buf(error_buf, error_buf_size,
+                              "invalid function variant");
+                return false;
+            }
+
+            if ((cpu_features & host_cpu_features) != cpu_features)
+                continue;
+
+            module->func_ptrs[func_index] = (uint8 *)module->code + text_offset;
+            if (module->start_func_index
+                == module->import_func_count + func_index)
+                module->start_function = module->func_ptrs[func_index];
+        }
+
+        if ((cpu_features & host_cpu_features) == cpu_features)
+            LOG_VERBOSE("Select %u function variants for CPU features "
+                        "0x%" PRIx64,
+                        func_count, cpu_features);
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/* The function variant section is emitted after the relocation section,
+   load it right after the function section so that the relocations to
+   the functions are resolved to the selected variants */
+static bool
+load_func_variants(AOTModule *module, AOTSection *section, char *error_buf,
+                   uint32 error_buf_size)
+{
+    const uint8 *p, *p_end;
+    uint32 sub_section_type;
+
+    for (; section; section = section->next) {
+        if (section->section_type != AOT_SECTION_TYPE_CUSTOM)
+            continue;
+
+        p = section->section_body;
+        p_end = p + section->section_body_size;
+        read_uint32(p, p_end, sub_section_type);
+        if (sub_section_type == AOT_CUSTOM_SECTION_FUNC_VARIANT)
+            return load_func_variant_section(p, p_end, module, error_buf,
+                                             error_buf_size);
+    }
+
+    return true;
+fail:
+    return false;
+}
+
 static void
 destroy_exports(AOTExport *exports)
 {
@@ -2896,6 +3141,314 @@ is_text_section(const char *section_name)
     return !strcmp(section_name, ".text") || !strcmp(section_name, ".ltext");
 }
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+/* The modules whose text is materialized lazily, searched by the
+   signal handler to resolve the faults on the text pages. The handler
+   walks the list without lock, the lock only serializes the updates */
+static bh_atomic_64_t lazy_text_list = 0;
+static korp_mutex lazy_text_lock = OS_THREAD_MUTEX_INITIALIZER;
+
+/* The number of signal handlers which may be walking the list, a node
+   removed from the list is freed after it drops to zero */
+static bh_atomic_32_t lazy_text_handler_count = 0;
+
+#define LAZY_TEXT_LOAD(v) ((AOTLazyText *)(uintptr_t)BH_ATOMIC_64_LOAD(v))
+#define LAZY_TEXT_STORE(v, node) BH_ATOMIC_64_STORE(v, (uintptr_t)(node))
+
+/* The fault address which was found already materialized by the last
+   fault of current thread, used to detect faults not caused by the lazy
+   materialization (e.g. writing to the text) */
+static os_thread_local_attribute void *lazy_text_last_fault = NULL;
+
+static bool
+create_lazy_text(AOTModule *module, uint8 *base, uint32 size,
+                 const uint8 *src, uint32 src_size, char *error_buf,
+                 uint32 error_buf_size)
+{
+    AOTLazyText *lazy_text;
+    uint32 page_size = os_getpagesize();
+    uint32 page_count = (uint32)(((uint64)size + page_size - 1) / page_size);
+
+    if (!(lazy_text =
+              loader_malloc(sizeof(AOTLazyText), error_buf, error_buf_size)))
+        return false;
+
+    lazy_text->module = module;
+    lazy_text->base = base;
+    lazy_text->size = size;
+    lazy_text->src = src;
+    lazy_text->src_size = src_size;
+    lazy_text->page_size = page_size;
+    lazy_text->page_count = page_count;
+    module->lazy_text = lazy_text;
+
+    if (!(lazy_text->page_joined =
+              loader_malloc(page_count, error_buf, error_buf_size))
+        || !(lazy_text->page_state =
+                 loader_malloc(sizeof(bh_atomic_32_t) * (uint64)page_count,
+                               error_buf, error_buf_size))
+        || !(lazy_text->reloc_start =
+                 loader_malloc(sizeof(uint32) * ((uint64)page_count + 1),
+                               error_buf, error_buf_size)))
+        return false;
+
+    return true;
+}
+
+static void
+destroy_lazy_text(AOTLazyText *lazy_text)
+{
+    bh_atomic_64_t *p_next;
+    AOTLazyText *node;
+    bool removed = false;
+
+    os_mutex_lock(&lazy_text_lock);
+    for (p_next = &lazy_text_list; (node = LAZY_TEXT_LOAD(*p_next));
+         p_next = &node->next) {
+        if (node == lazy_text) {
+            LAZY_TEXT_STORE(*p_next, LAZY_TEXT_LOAD(lazy_text->next));
+            removed = true;
+            break;
+        }
+    }
+    os_mutex_unlock(&lazy_text_lock);
+
+    /* A signal handler of another thread may still be reading the node */
+    while (removed && BH_ATOMIC_32_LOAD(lazy_text_handler_count) != 0)
+        os_usleep(10);
+
+    if (lazy_text->page_joined)
+        wasm_runtime_free(lazy_text->page_joined);
+    if (lazy_text->page_state)
+        wasm_runtime_free(lazy_text->page_state);
+    if (lazy_text->reloc_start)
+        wasm_runtime_free(lazy_text->reloc_start);
+    if (lazy_text->relocs)
+        wasm_runtime_free(lazy_text->relocs);
+    wasm_runtime_free(lazy_text);
+}
+
+static bool
+reserve_lazy_relocations(AOTLazyText *lazy_text, uint32 count,
+                         char *error_buf, uint32 error_buf_size)
+{
+    AOTLazyRelocation *relocs;
+    uint64 capacity = (uint64)lazy_text->reloc_count + count;
+
+    if (capacity <= lazy_text->reloc_capacity)
+        return true;
+
+    if (!(relocs = loader_malloc(sizeof(AOTLazyRelocation) * capacity,
+                                 error_buf, error_buf_size)))
+        return false;
+
+    if (lazy_text->relocs) {
+        bh_memcpy_s(relocs, (uint32)(sizeof(AOTLazyRelocation) * capacity),
+                    lazy_text->relocs,
+                    (uint32)sizeof(AOTLazyRelocation)
+                        * lazy_text->reloc_count);
+        wasm_runtime_free(lazy_text->relocs);
+    }
+    lazy_text->relocs = relocs;
+    lazy_text->reloc_capacity = (uint32)capacity;
+    return true;
+}
+
+/* Copy the pages [start_page, end_page] from the AOT file buffer, apply
+   their relocations and make them executable, the caller must have set
+   the state of start_page to loading or be the loader */
+static bool
+materialize_lazy_text(AOTLazyText *lazy_text, uint32 start_page,
+                      uint32 end_page, char *error_buf, uint32 error_buf_size)
+{
+    AOTModule *module = lazy_text->module;
+    AOTLazyRelocation *reloc, *reloc_end;
+    uint32 offset = lazy_text->page_size * start_page;
+    uint32 size = lazy_text->page_size * (end_page - start_page + 1);
+    uint32 copy_size;
+    uint8 *addr = lazy_text->base + offset, *target;
+
+    if (os_mprotect(addr, size, MMAP_PROT_READ | MMAP_PROT_WRITE) != 0) {
+        set_error_buf(error_buf, error_buf_size, "mprotect memory failed");
+        return false;
+    }
+
+    /* The plt table after the text section body is filled by the loader */
+    if (offset < lazy_text->src_size) {
+        copy_size = lazy_text->src_size - offset;
+        if (copy_size > size)
+            copy_size = size;
+        bh_memcpy_s(addr, size, lazy_text->src + offset, copy_size);
+    }
+
+    reloc = lazy_text->relocs + lazy_text->reloc_start[start_page];
+    reloc_end = lazy_text->relocs + lazy_text->reloc_start[end_page + 1];
+    for (; reloc < reloc_end; reloc++) {
+        target = reloc->is_literal ? module->literal : (uint8 *)module->code;
+        if (!apply_relocation(
+                module, target,
+                reloc->is_literal ? module->literal_size : module->code_size,
+                (uint64)(lazy_text->base + reloc->offset - target),
+                reloc->addend, reloc->type, reloc->symbol_addr,
+                reloc->symbol_index, error_buf, error_buf_size))
+            return false;
+    }
+
+    if (os_mprotect(addr, size, MMAP_PROT_READ | MMAP_PROT_EXEC) != 0) {
+        set_error_buf(error_buf, error_buf_size, "mprotect memory failed");
+        return false;
+    }
+    os_icache_flush(addr, size);
+    return true;
+}
+
+static void
+get_lazy_text_unit(AOTLazyText *lazy_text, uint32 page, uint32 *p_start_page,
+                   uint32 *p_end_page)
+{
+    uint32 start_page = page, end_page = page;
+
+    while (start_page > 0 && lazy_text->page_joined[start_page - 1])
+        start_page--;
+    while (end_page + 1 < lazy_text->page_count
+           && lazy_text->page_joined[end_page])
+        end_page++;
+
+    *p_start_page = start_page;
+    *p_end_page = end_page;
+}
+
+/* Sort the recorded relocations by page, protect the text pages and
+   materialize the pages of the plt table which are already in use */
+static bool
+init_lazy_text_pages(AOTLazyText *lazy_text, char *error_buf,
+                     uint32 error_buf_size)
+{
+    AOTLazyRelocation *relocs = NULL, *reloc;
+    uint32 page_size = lazy_text->page_size, page, i;
+    uint32 start_page, end_page;
+    uint32 *reloc_start = lazy_text->reloc_start;
+
+    for (i = 0, reloc = lazy_text->relocs; i < lazy_text->reloc_count;
+         i++, reloc++) {
+        page = reloc->offset / page_size;
+        reloc_start[page + 1]++;
+        /* The relocated bytes, at most 8, may straddle two pages */
+        if (reloc->offset % page_size + sizeof(uint64) > page_size
+            && page + 1 < lazy_text->page_count)
+            lazy_text->page_joined[page] = 1;
+    }
+    for (i = 0; i < lazy_text->page_count; i++)
+        reloc_start[i + 1] += reloc_start[i];
+
+    if (lazy_text->reloc_count > 0) {
+        if (!(relocs = loader_malloc(sizeof(AOTLazyRelocation)
+                                         * (uint64)lazy_text->reloc_count,
+                                     error_buf, error_buf_size)))
+            return false;
+        for (i = 0, reloc = lazy_text->relocs; i < lazy_text->reloc_count;
+             i++, reloc++) {
+            page = reloc->offset / page_size;
+            relocs[reloc_start[page]++] = *reloc;
+        }
+        /* reloc_start[i] now points to the end of page i, shift it back */
+        for (i = lazy_text->page_count; i > 0; i--)
+            reloc_start[i] = reloc_start[i - 1];
+        reloc_start[0] = 0;
+        wasm_runtime_free(lazy_text->relocs);
+        lazy_text->relocs = relocs;
+        lazy_text->reloc_capacity = lazy_text->reloc_count;
+    }
+
+    if (os_mprotect(lazy_text->base, lazy_text->size, MMAP_PROT_NONE) != 0) {
+        set_error_buf(error_buf, error_buf_size, "mprotect memory failed");
+        return false;
+    }
+
+    if (lazy_text->size > lazy_text->src_size) {
+        for (page = lazy_text->src_size / page_size;
+             page < lazy_text->page_count; page = end_page + 1) {
+            get_lazy_text_unit(lazy_text, page, &start_page, &end_page);
+            if (!materialize_lazy_text(lazy_text, start_page, end_page,
+                                       error_buf, error_buf_size))
+                return false;
+            BH_ATOMIC_32_STORE(lazy_text->page_state[start_page],
+                               AOT_LAZY_TEXT_PAGE_LOADED);
+        }
+    }
+
+    /* Publish the node after it is fully initialized */
+    os_mutex_lock(&lazy_text_lock);
+    LAZY_TEXT_STORE(lazy_text->next, LAZY_TEXT_LOAD(lazy_text_list));
+    LAZY_TEXT_STORE(lazy_text_list, lazy_text);
+    os_mutex_unlock(&lazy_text_lock);
+
+    LOG_VERBOSE("Lazy AOT text: %u pages, %u relocations\n",
+                lazy_text->page_count, lazy_text->reloc_count);
+    return true;
+}
+
+bool
+aot_lazy_text_handle_fault(void *addr, char *error_buf, uint32 error_buf_size)
+{
+    AOTLazyText *lazy_text;
+    bh_atomic_32_t *p_state;
+    uint32 page, start_page, end_page, state;
+    bool ret = false;
+
+    error_buf[0] = '\0';
+
+    /* Count the handler before reading the list, see destroy_lazy_text */
+    BH_ATOMIC_32_FETCH_ADD(lazy_text_handler_count, 1);
+
+    for (lazy_text = LAZY_TEXT_LOAD(lazy_text_list); lazy_text;
+         lazy_text = LAZY_TEXT_LOAD(lazy_text->next)) {
+        if (lazy_text->base <= (uint8 *)addr
+            && (uint8 *)addr < lazy_text->base + lazy_text->size)
+            break;
+    }
+
+    if (lazy_text) {
+        page = (uint32)((uint8 *)addr - lazy_text->base) / lazy_text->page_size;
+        get_lazy_text_unit(lazy_text, page, &start_page, &end_page);
+        p_state = &lazy_text->page_state[start_page];
+
+        /* The first thread which sets the loading flag materializes the
+           pages, the others wait for it */
+        state = BH_ATOMIC_32_FETCH_OR(*p_state, AOT_LAZY_TEXT_PAGE_LOADING);
+        if (state == 0) {
+            if (materialize_lazy_text(lazy_text, start_page, end_page,
+                                      error_buf, error_buf_size)) {
+                BH_ATOMIC_32_FETCH_OR(*p_state, AOT_LAZY_TEXT_PAGE_LOADED);
+                ret = true;
+            }
+            else
+                BH_ATOMIC_32_FETCH_OR(*p_state, AOT_LAZY_TEXT_PAGE_FAILED);
+            lazy_text_last_fault = NULL;
+        }
+        else {
+            while (state == AOT_LAZY_TEXT_PAGE_LOADING)
+                state = BH_ATOMIC_32_LOAD(*p_state);
+
+            if (state & AOT_LAZY_TEXT_PAGE_FAILED) {
+                set_error_buf(error_buf, error_buf_size,
+                              "materialize lazy AOT text failed");
+            }
+            else {
+                /* Another thread materialized the page after the fault,
+                   retry once, a second fault on it isn't caused by the
+                   lazy loading */
+                ret = lazy_text_last_fault != addr;
+                lazy_text_last_fault = ret ? addr : NULL;
+            }
+        }
+    }
+
+    BH_ATOMIC_32_FETCH_SUB(lazy_text_handler_count, 1);
+    return ret;
+}
+#endif /* end of AOT_LAZY_TEXT_SUPPORTED != 0 */
+
 static bool
 do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
                    char *error_buf, uint32 error_buf_size)
@@ -2919,6 +3472,14 @@ do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
         return false;
     }
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    if (module->lazy_text
+        && !reserve_lazy_relocations(module->lazy_text,
+                                     group->relocation_count, error_buf,
+                                     error_buf_size))
+        return false;
+#endif
+
     for (i = 0; i < group->relocation_count; i++, relocation++) {
         int32 symbol_index = -1;
         symbol_len = (uint32)strlen(relocation->symbol_name);
@@ -3108,6 +3669,30 @@ do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
         if (symbol != symbol_buf)
             wasm_runtime_free(symbol);
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+        if (module->lazy_text) {
+            /* Applied when the page is materialized */
+            AOTLazyText *lazy_text = module->lazy_text;
+            AOTLazyRelocation *lazy_reloc =
+                lazy_text->relocs + lazy_text->reloc_count++;
+
+            if (relocation->relocation_offset >= aot_text_size) {
+                set_error_buf(error_buf, error_buf_size,
+                              "invalid relocation offset");
+                return false;
+            }
+            lazy_reloc->offset =
+                (uint32)(aot_text + relocation->relocation_offset
+                         - lazy_text->base);
+            lazy_reloc->type = relocation->relocation_type;
+            lazy_reloc->addend = (int64)relocation->relocation_addend;
+            lazy_reloc->symbol_addr = symbol_addr;
+            lazy_reloc->symbol_index = symbol_index;
+            lazy_reloc->is_literal = is_literal;
+            continue;
+        }
+#endif
+
         if (!apply_relocation(
                 module, aot_text, aot_text_size, relocation->relocation_offset,
                 relocation->relocation_addend, relocation->relocation_type,
@@ -3654,6 +4239,14 @@ load_relocation_section(const uint8 *buf, const uint8 *buf_end,
         os_mprotect(mmap_addr, total_size, map_prot);
     }
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    /* Hide the text pages again until they are materialized */
+    if (module->lazy_text
+        && !init_lazy_text_pages(module->lazy_text, error_buf,
+                                 error_buf_size))
+        goto fail;
+#endif
+
     map_prot = MMAP_PROT_READ;
 
 #if defined(BH_PLATFORM_WINDOWS)
@@ -3709,6 +4302,82 @@ has_module_memory64(AOTModule *module)
 }
 #endif
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+static bool
+get_data_image_offset(const AOTMemInitData *data_seg, uint64 *p_offset)
+{
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (data_seg->memory_index != 0)
+        return false;
+#endif
+    if (data_seg->offset.init_expr_type == INIT_EXPR_TYPE_I32_CONST)
+        *p_offset = data_seg->offset.u.u32;
+    else if (data_seg->offset.init_expr_type == INIT_EXPR_TYPE_I64_CONST)
+        *p_offset = (uint64)data_seg->offset.u.i64;
+    else
+        /* The offset may differ between instances */
+        return false;
+    return true;
+}
+
+/* Create the copy-on-write image of the active data segments, so that
+   the instantiation maps it instead of copying the segments. Nothing is
+   created if the offset of any segment isn't a constant or any segment
+   doesn't fit in the initial memory, the instantiation copies them and
+   reports the error then */
+static void
+create_data_image(AOTModule *module)
+{
+    AOTMemInitData *data_seg;
+    WASMDataImage *image;
+    uint64 memory_size, offset, data_size = 0, image_size = 0;
+    uint32 i;
+
+    if (module->import_memory_count > 0 || module->memory_count == 0
+        || (module->memories[0].flags & SHARED_MEMORY_FLAG))
+        return;
+
+    memory_size = (uint64)module->memories[0].num_bytes_per_page
+                  * module->memories[0].init_page_count;
+
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (!get_data_image_offset(data_seg, &offset)
+            || offset + data_seg->byte_count > memory_size)
+            return;
+        data_size += data_seg->byte_count;
+        if (image_size < offset + data_seg->byte_count)
+            image_size = offset + data_seg->byte_count;
+    }
+
+    if (WASM_MEM_DATA_IMAGE_MIN_SIZE == 0
+        || data_size < WASM_MEM_DATA_IMAGE_MIN_SIZE
+        || !(image = wasm_data_image_create(image_size)))
+        return;
+
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        get_data_image_offset(data_seg, &offset);
+        if (!wasm_data_image_write(image, offset, data_seg->bytes,
+                                   data_seg->byte_count)) {
+            wasm_data_image_destroy(image);
+            return;
+        }
+    }
+
+    module->data_image = image;
+    LOG_VERBOSE("Create data image of %" PRIu64 " bytes.", image->size);
+}
+#endif /* end of WASM_MEM_DATA_IMAGE_SUPPORTED != 0 */
+
 static bool
 load_from_sections(AOTModule *module, AOTSection *sections,
                    bool is_load_from_file_buf, char *error_buf,
@@ -3755,6 +4424,8 @@ load_from_sections(AOTModule *module, AOTSection *sections,
                 break;
             case AOT_SECTION_TYPE_FUNCTION:
                 if (!load_function_section(buf, buf_end, module, error_buf,
+                                           error_buf_size)
+                    || !load_func_variants(module, section->next, error_buf,
                                            error_buf_size))
                     return false;
                 break;
@@ -3884,6 +4555,10 @@ load_from_sections(AOTModule *module, AOTSection *sections,
         }
     }
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    create_data_image(module);
+#endif
+
     /* Flush data cache before executing AOT code,
      * otherwise unpredictable behavior can occur. */
     os_dcache_flush();
@@ -4023,7 +4698,7 @@ fail:
 
 static bool
 create_sections(AOTModule *module, const uint8 *buf, uint32 size,
-                AOTSection **p_section_list, char *error_buf,
+                bool lazy_text, AOTSection **p_section_list, char *error_buf,
                 uint32 error_buf_size)
 {
     AOTSection *section_list = NULL, *section_list_end = NULL, *section;
@@ -4075,6 +4750,11 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                     int map_flags = MMAP_MAP_32BIT;
 #else
                     int map_flags = MMAP_MAP_NONE;
+#endif
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+                    if (lazy_text)
+                        /* The pages are made executable when materialized */
+                        map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE;
 #endif
                     total_size =
                         (uint64)section_size + aot_get_plt_table_size();
@@ -4104,8 +4784,29 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                                 section->section_body, (uint32)section_size);
                     os_dcache_flush();
 #else
-                    bh_memcpy_s(aot_text, (uint32)total_size,
-                                section->section_body, (uint32)section_size);
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+                    if (lazy_text) {
+                        if (!create_lazy_text(module, aot_text,
+                                              (uint32)total_size, p,
+                                              section_size, error_buf,
+                                              error_buf_size)) {
+                            os_munmap(aot_text, (uint32)total_size);
+                            wasm_runtime_free(section);
+                            goto fail;
+                        }
+                        /* Only the literal size is read by the loader, the
+                           rest is copied when the page is materialized */
+                        bh_memcpy_s(aot_text, (uint32)total_size,
+                                    section->section_body,
+                                    section_size < sizeof(uint32)
+                                        ? section_size
+                                        : (uint32)sizeof(uint32));
+                    }
+                    else
+#endif
+                        bh_memcpy_s(aot_text, (uint32)total_size,
+                                    section->section_body,
+                                    (uint32)section_size);
 #endif
                     section->section_body = aot_text;
                     destroy_aot_text = true;
@@ -4148,7 +4849,8 @@ fail:
 
 static bool
 load(const uint8 *buf, uint32 size, AOTModule *module,
-     bool wasm_binary_freeable, char *error_buf, uint32 error_buf_size)
+     bool wasm_binary_freeable, bool lazy_text, char *error_buf,
+     uint32 error_buf_size)
 {
     const uint8 *buf_end = buf + size;
     const uint8 *p = buf, *p_end = buf_end;
@@ -4170,8 +4872,8 @@ load(const uint8 *buf, uint32 size, AOTModule *module,
 
     module->package_version = version;
 
-    if (!create_sections(module, buf, size, &section_list, error_buf,
-                         error_buf_size))
+    if (!create_sections(module, buf, size, lazy_text, &section_list,
+                         error_buf, error_buf_size))
         return false;
 
     ret = load_from_sections(module, section_list, !wasm_binary_freeable,
@@ -4214,18 +4916,28 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
                        char *error_buf, uint32 error_buf_size)
 {
     AOTModule *module = create_module(args->name, error_buf, error_buf_size);
+    bool lazy_text = false;
 
     if (!module)
         return NULL;
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    /* The text is copied from the buffer when the pages are touched */
+    lazy_text = args->aot_lazy_text && !args->wasm_binary_freeable;
+#endif
+
     os_thread_jit_write_protect_np(false); /* Make memory writable */
-    if (!load(buf, size, module, args->wasm_binary_freeable, error_buf,
-              error_buf_size)) {
+    if (!load(buf, size, module, args->wasm_binary_freeable, lazy_text,
+              error_buf, error_buf_size)) {
         aot_unload(module);
         return NULL;
     }
     os_thread_jit_write_protect_np(true); /* Make memory executable */
-    os_icache_flush(module->code, module->code_size);
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    /* The materialized pages of lazy text are flushed separately */
+    if (!module->lazy_text)
+#endif
+        os_icache_flush(module->code, module->code_size);
 
     LOG_VERBOSE("Load module success.\n");
     return module;
@@ -4244,6 +4956,11 @@ aot_unload(AOTModule *module)
         destroy_mem_init_data_list(module->mem_init_data_list,
                                    module->mem_init_data_count);
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    if (module->data_image)
+        wasm_data_image_destroy(module->data_image);
+#endif
+
     if (module->native_symbol_list)
         wasm_runtime_free(module->native_symbol_list);
 
@@ -4329,6 +5046,12 @@ aot_unload(AOTModule *module)
     }
 #endif
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    /* Unregister it before the text is unmapped */
+    if (module->lazy_text)
+        destroy_lazy_text(module->lazy_text);
+#endif
+
     if (module->code && !module->is_indirect_mode) {
         /* The layout is: literal size + literal + code (with plt table) */
         uint8 *mmap_addr = module->literal - sizeof(uint32);
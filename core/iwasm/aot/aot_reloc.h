@@ -13,6 +13,10 @@
 #include "string_object.h"
 #endif
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+#include "../common/wasm_memory.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,7 +29,12 @@ typedef struct {
 /* clang-format off */
 #define REG_SYM(symbol) { #symbol, (void *)symbol }
 
-#if WASM_ENABLE_BULK_MEMORY != 0
+#if WASM_ENABLE_BULK_MEMORY != 0 && WASM_ENABLE_MULTI_MEMORY != 0
+#define REG_BULK_MEMORY_SYM()             \
+    REG_SYM(aot_memory_init),             \
+    REG_SYM(aot_memory_init_with_idx),    \
+    REG_SYM(aot_data_drop),
+#elif WASM_ENABLE_BULK_MEMORY != 0
 #define REG_BULK_MEMORY_SYM()             \
     REG_SYM(aot_memory_init),             \
     REG_SYM(aot_data_drop),
@@ -150,6 +159,7 @@ typedef struct {
     REG_SYM(wasm_externref_obj_to_internal_obj), \
     REG_SYM(wasm_internal_obj_to_externref_obj), \
     REG_SYM(wasm_obj_is_type_of),          \
+    REG_SYM(wasm_obj_write_barrier),       \
     REG_SYM(wasm_struct_obj_new),
 #else
 #define REG_GC_SYM()
@@ -181,11 +191,27 @@ typedef struct {
 #define REG_STRINGREF_SYM()
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+#define REG_EXCE_HANDLING_SYM()                 \
+    REG_SYM(wasm_runtime_throw_wasm_exception), \
+    REG_SYM(wasm_runtime_catch_wasm_exception),
+#else
+#define REG_EXCE_HANDLING_SYM()
+#endif
+
+#if WASM_ENABLE_SHARED_HEAP != 0
+#define REG_SHARED_HEAP_SYM()                        \
+    REG_SYM(wasm_runtime_is_app_addr_in_shared_heap),
+#else
+#define REG_SHARED_HEAP_SYM()
+#endif
+
 #define REG_COMMON_SYMBOLS                \
     REG_SYM(aot_set_exception_with_id),   \
     REG_SYM(aot_invoke_native),           \
     REG_SYM(aot_call_indirect),           \
     REG_SYM(aot_enlarge_memory),          \
+    REG_SYM(aot_enlarge_memory_with_idx),\
     REG_SYM(aot_set_exception),           \
     REG_SYM(aot_check_app_addr_and_convert),\
     REG_SYM(wasm_runtime_quick_invoke_c_api_native),\
@@ -214,6 +240,8 @@ typedef struct {
     REG_LLVM_PGO_SYM()                    \
     REG_GC_SYM()                          \
     REG_STRINGREF_SYM()                   \
+    REG_EXCE_HANDLING_SYM()               \
+    REG_SHARED_HEAP_SYM()                 \
 
 #define CHECK_RELOC_OFFSET(data_size) do {              \
     if (!check_reloc_offset(target_section_size,        \
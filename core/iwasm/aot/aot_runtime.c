@@ -800,6 +800,7 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     uint64 memory_data_size, max_memory_data_size;
     uint8 *p = NULL, *global_addr;
     bool is_memory64 = memory->flags & MEMORY64_FLAG;
+    bool is_data_image_mapped = false;
 
     bool is_shared_memory = false;
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -825,6 +826,11 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
         default_max_pages = DEFAULT_MAX_PAGES;
     }
 
+    if (memory_idx > 0) {
+        /* Only the default memory hosts the app heap */
+        heap_size = 0;
+    }
+
     if (heap_size > 0 && module->malloc_func_index != (uint32)-1
         && module->free_func_index != (uint32)-1) {
         /* Disable app heap, use malloc/free function exported
@@ -915,6 +921,24 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
             max_page_count = default_max_pages;
     }
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_ENABLE_MEMORY64 != 0
+    if (is_memory64) {
+        /* Keep the guard page at the end of the reserved space, see
+           MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE */
+        if ((uint64)num_bytes_per_page * init_page_count
+            > MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE) {
+            set_error_buf(error_buf, error_buf_size,
+                          "memory64 size exceeds the limit of the hardware "
+                          "bound check");
+            return NULL;
+        }
+        if ((uint64)num_bytes_per_page * max_page_count
+            > MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE)
+            max_page_count = (uint32)(MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE
+                                      / num_bytes_per_page);
+    }
+#endif
+
     LOG_VERBOSE("Memory instantiate:");
     LOG_VERBOSE("  page bytes: %u, init pages: %u, max pages: %u",
                 num_bytes_per_page, init_page_count, max_page_count);
@@ -937,7 +961,16 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
         return NULL;
     }
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* Map the data segments before the app heap is created in the memory,
+       they needn't be copied then */
+    if (memory_idx == 0 && !parent && module->data_image)
+        is_data_image_mapped =
+            wasm_data_image_map(module->data_image, p, memory_data_size);
+#endif
+
     memory_inst->module_type = Wasm_Module_AoT;
+    memory_inst->is_data_image_mapped = is_data_image_mapped;
     memory_inst->num_bytes_per_page = num_bytes_per_page;
     memory_inst->cur_page_count = init_page_count;
     memory_inst->max_page_count = max_page_count;
@@ -1054,6 +1087,11 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                initialized */
             continue;
 
+#if WASM_ENABLE_BULK_MEMORY != 0
+        bh_assert(data_seg->memory_index < memory_count);
+        memory_inst = module_inst->memories[data_seg->memory_index];
+#endif
+
         bh_assert(data_seg->offset.init_expr_type
                       == (memory_inst->is_memory64 ? INIT_EXPR_TYPE_I64_CONST
                                                    : INIT_EXPR_TYPE_I32_CONST)
@@ -1137,7 +1175,7 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
             return false;
         }
 
-        if (memory_inst->memory_data) {
+        if (memory_inst->memory_data && !memory_inst->is_data_image_mapped) {
             bh_memcpy_s((uint8 *)memory_inst->memory_data + base_offset,
                         (uint32)(memory_inst->memory_data_size - base_offset),
                         data_seg->bytes, length);
@@ -1620,21 +1658,33 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
        globals and others */
     if (!is_sub_inst) {
         uint32 gc_heap_size = wasm_runtime_get_gc_heap_size_default();
+        uint32 gc_heap_max_size = wasm_runtime_get_gc_heap_max_size_default();
 
         if (gc_heap_size < GC_HEAP_SIZE_MIN)
             gc_heap_size = GC_HEAP_SIZE_MIN;
         if (gc_heap_size > GC_HEAP_SIZE_MAX)
             gc_heap_size = GC_HEAP_SIZE_MAX;
+        if (gc_heap_max_size > GC_HEAP_SIZE_MAX)
+            gc_heap_max_size = GC_HEAP_SIZE_MAX;
+
+        if (gc_heap_max_size > gc_heap_size) {
+            /* the pages of the heap are committed as it grows, fall back
+               to the fixed size heap if it isn't supported */
+            extra->common.gc_heap_handle =
+                mem_allocator_create_growable(gc_heap_size, gc_heap_max_size);
+        }
 
-        extra->common.gc_heap_pool =
-            runtime_malloc(gc_heap_size, error_buf, error_buf_size);
-        if (!extra->common.gc_heap_pool)
-            goto fail;
+        if (!extra->common.gc_heap_handle) {
+            extra->common.gc_heap_pool =
+                runtime_malloc(gc_heap_size, error_buf, error_buf_size);
+            if (!extra->common.gc_heap_pool)
+                goto fail;
 
-        extra->common.gc_heap_handle =
-            mem_allocator_create(extra->common.gc_heap_pool, gc_heap_size);
-        if (!extra->common.gc_heap_handle)
-            goto fail;
+            extra->common.gc_heap_handle =
+                mem_allocator_create(extra->common.gc_heap_pool, gc_heap_size);
+            if (!extra->common.gc_heap_handle)
+                goto fail;
+        }
     }
 #endif
 
@@ -1988,6 +2038,10 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
     if (module_inst->tables)
         wasm_runtime_free(module_inst->tables);
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    wasm_runtime_detach_shared_heap((WASMModuleInstanceCommon *)module_inst);
+#endif
+
     if (module_inst->memories)
         memories_deinstantiate(module_inst);
 
@@ -2026,6 +2080,8 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
         wasm_native_call_context_dtors((WASMModuleInstanceCommon *)module_inst);
     }
 
+    wasm_runtime_destroy_clone_image((WASMModuleInstanceCommon *)module_inst);
+
 #if WASM_ENABLE_BULK_MEMORY != 0
     bh_bitmap_delete(common->data_dropped);
 #endif
@@ -2306,6 +2362,10 @@ aot_call_function(WASMExecEnv *exec_env, AOTFunctionInstance *function,
         ret = invoke_native_internal(exec_env, function->u.func.func_ptr,
                                      func_type, NULL, attachment, argv1, argc,
                                      argv);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        /* the uncaught wasm exception is returned to the host as a trap */
+        wasm_runtime_clear_wasm_exception(exec_env);
+#endif
 
         if (!ret) {
 #ifdef AOT_STACK_FRAME_DEBUG
@@ -2376,6 +2436,9 @@ aot_call_function(WASMExecEnv *exec_env, AOTFunctionInstance *function,
 
         ret = invoke_native_internal(exec_env, func_ptr, func_type, NULL,
                                      attachment, argv, argc, argv);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        wasm_runtime_clear_wasm_exception(exec_env);
+#endif
 
         if (aot_copy_exception(module_inst, NULL)) {
 #ifdef AOT_STACK_FRAME_DEBUG
@@ -2817,6 +2880,13 @@ aot_enlarge_memory(AOTModuleInstance *module_inst, uint32 inc_page_count)
     return wasm_enlarge_memory(module_inst, inc_page_count);
 }
 
+bool
+aot_enlarge_memory_with_idx(AOTModuleInstance *module_inst,
+                            uint32 inc_page_count, uint32 memidx)
+{
+    return wasm_enlarge_memory_with_idx(module_inst, inc_page_count, memidx);
+}
+
 bool
 aot_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
                   uint32 *argv)
@@ -3166,6 +3236,45 @@ aot_memory_init(AOTModuleInstance *module_inst, uint32 seg_index, uint32 offset,
     return true;
 }
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+bool
+aot_memory_init_with_idx(AOTModuleInstance *module_inst, uint32 seg_index,
+                         uint32 offset, uint32 len, size_t dst, uint32 memidx)
+{
+    AOTMemoryInstance *memory_inst;
+    AOTModule *aot_module;
+    uint8 *data = NULL;
+    uint64 seg_len = 0;
+
+    if (memidx == 0)
+        return aot_memory_init(module_inst, seg_index, offset, len, dst);
+
+    bh_assert(memidx < module_inst->memory_count);
+    memory_inst = module_inst->memories[memidx];
+
+    if (!bh_bitmap_get_bit(
+            ((AOTModuleInstanceExtra *)module_inst->e)->common.data_dropped,
+            seg_index)) {
+        aot_module = (AOTModule *)module_inst->module;
+        seg_len = aot_module->mem_init_data_list[seg_index]->byte_count;
+        data = aot_module->mem_init_data_list[seg_index]->bytes;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    if ((uint64)dst + (uint64)len > memory_inst->memory_data_size
+        || (uint64)offset + (uint64)len > seg_len) {
+        SHARED_MEMORY_UNLOCK(memory_inst);
+        aot_set_exception(module_inst, "out of bounds memory access");
+        return false;
+    }
+    bh_memcpy_s(memory_inst->memory_data + dst,
+                CLAMP_U64_TO_U32(memory_inst->memory_data_size - dst),
+                data + offset, len);
+    SHARED_MEMORY_UNLOCK(memory_inst);
+    return true;
+}
+#endif
+
 bool
 aot_data_drop(AOTModuleInstance *module_inst, uint32 seg_index)
 {
@@ -31,6 +31,8 @@ extern "C" {
 #define WASM_FEATURE_COMPONENT_MODEL (1 << 9)
 #define WASM_FEATURE_RELAXED_SIMD (1 << 10)
 #define WASM_FEATURE_FLEXIBLE_VECTORS (1 << 11)
+/* The GC instructions are compiled with the write barrier */
+#define WASM_FEATURE_GC_WRITE_BARRIER (1 << 12)
 
 typedef enum AOTSectionType {
     AOT_SECTION_TYPE_TARGET_INFO = 0,
@@ -49,8 +51,36 @@ typedef enum AOTCustomSectionType {
     AOT_CUSTOM_SECTION_ACCESS_CONTROL = 2,
     AOT_CUSTOM_SECTION_NAME = 3,
     AOT_CUSTOM_SECTION_STRING_LITERAL = 4,
+    AOT_CUSTOM_SECTION_FUNC_VARIANT = 5,
 } AOTCustomSectionType;
 
+/* x86 CPU features required by the function variants,
+   mainly used by the function variant section */
+#define AOT_CPU_FEATURE_SSE3 (1 << 0)
+#define AOT_CPU_FEATURE_SSSE3 (1 << 1)
+#define AOT_CPU_FEATURE_SSE4_1 (1 << 2)
+#define AOT_CPU_FEATURE_SSE4_2 (1 << 3)
+#define AOT_CPU_FEATURE_POPCNT (1 << 4)
+#define AOT_CPU_FEATURE_AVX (1 << 5)
+#define AOT_CPU_FEATURE_AVX2 (1 << 6)
+#define AOT_CPU_FEATURE_FMA (1 << 7)
+#define AOT_CPU_FEATURE_BMI (1 << 8)
+#define AOT_CPU_FEATURE_BMI2 (1 << 9)
+#define AOT_CPU_FEATURE_LZCNT (1 << 10)
+#define AOT_CPU_FEATURE_MOVBE (1 << 11)
+#define AOT_CPU_FEATURE_F16C (1 << 12)
+#define AOT_CPU_FEATURE_AVX512F (1 << 13)
+#define AOT_CPU_FEATURE_AVX512CD (1 << 14)
+#define AOT_CPU_FEATURE_AVX512BW (1 << 15)
+#define AOT_CPU_FEATURE_AVX512DQ (1 << 16)
+#define AOT_CPU_FEATURE_AVX512VL (1 << 17)
+#define AOT_CPU_FEATURE_AVX512VNNI (1 << 18)
+#define AOT_CPU_FEATURE_AVX512VBMI (1 << 19)
+#define AOT_CPU_FEATURE_AVX512IFMA (1 << 20)
+#define AOT_CPU_FEATURE_AVX512VPOPCNTDQ (1 << 21)
+#define AOT_CPU_FEATURE_AVX512BITALG (1 << 22)
+#define AOT_CPU_FEATURE_AVX512VBMI2 (1 << 23)
+
 typedef struct AOTObjectDataSection {
     char *name;
     uint8 *data;
@@ -120,6 +150,61 @@ typedef struct GOTItem {
 } GOTItem, *GOTItemList;
 #endif
 
+/* Lazy AOT text relies on the signal handler of the hardware bound check
+   to materialize the code pages on first touch, and on the atomic
+   operations to do it without lock */
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && !defined(BH_PLATFORM_WINDOWS) \
+    && WASM_ENABLE_DEBUG_AOT == 0 && WASM_MEM_DUAL_BUS_MIRROR == 0    \
+    && BH_ATOMIC_64_IS_ATOMIC != 0 && BH_ATOMIC_32_IS_ATOMIC != 0
+#define AOT_LAZY_TEXT_SUPPORTED 1
+#else
+#define AOT_LAZY_TEXT_SUPPORTED 0
+#endif
+
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+/* A text relocation whose symbol address was resolved at load time,
+   applied when the page containing it is materialized */
+typedef struct AOTLazyRelocation {
+    /* offset of the relocated bytes from the start of the text mapping */
+    uint32 offset;
+    uint32 type;
+    int64 addend;
+    void *symbol_addr;
+    int32 symbol_index;
+    bool is_literal;
+} AOTLazyRelocation;
+
+/* The materialization state of a page, only kept for the first page of
+   the pages which are materialized together */
+#define AOT_LAZY_TEXT_PAGE_LOADING 1
+#define AOT_LAZY_TEXT_PAGE_LOADED 2
+#define AOT_LAZY_TEXT_PAGE_FAILED 4
+
+typedef struct AOTLazyText {
+    /* address of the next node, accessed atomically since the signal
+       handler walks the list without lock */
+    bh_atomic_64_t next;
+    struct AOTModule *module;
+    /* the text mapping: literal size + literal + code (with plt table) */
+    uint8 *base;
+    uint32 size;
+    /* the text section body in the AOT file buffer */
+    const uint8 *src;
+    uint32 src_size;
+    uint32 page_size;
+    uint32 page_count;
+    /* page_joined[i] means page i and page i + 1 are materialized together
+       as a relocation straddles them */
+    uint8 *page_joined;
+    bh_atomic_32_t *page_state;
+    /* relocations of page i are relocs[reloc_start[i], reloc_start[i + 1]) */
+    uint32 *reloc_start;
+    AOTLazyRelocation *relocs;
+    uint32 reloc_count;
+    uint32 reloc_capacity;
+} AOTLazyText;
+#endif
+
 #if WASM_ENABLE_GC != 0
 typedef struct LocalRefFlag {
     uint32 local_ref_flag_cell_num;
@@ -144,6 +229,11 @@ typedef struct AOTModule {
     /* init data */
     uint32 mem_init_data_count;
     AOTMemInitData **mem_init_data_list;
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* The image of the active data segments of the first memory,
+       NULL if it isn't created */
+    WASMDataImage *data_image;
+#endif
 
     /* native symbol */
     void **native_symbol_list;
@@ -218,6 +308,11 @@ typedef struct AOTModule {
     uint8 *literal;
     uint32 literal_size;
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+    /* Not NULL if the text is materialized page by page on first touch */
+    AOTLazyText *lazy_text;
+#endif
+
 #if defined(BH_PLATFORM_WINDOWS)
     /* extra plt data area for __ymm, __xmm and __real constants
        in Windows platform */
@@ -465,6 +560,24 @@ AOTModule *
 aot_load_from_sections(AOTSection *section_list, char *error_buf,
                        uint32 error_buf_size);
 
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+/**
+ * Materialize the lazy AOT text page which contains the fault address,
+ * called by the signal handler, so it takes no lock and doesn't print.
+ *
+ * @param addr the fault address
+ * @param error_buf output of the error if the page can't be materialized
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if the page is materialized and the faulting instruction
+ *         can be re-executed, false if the address isn't lazy AOT text or
+ *         the materialization failed, error_buf isn't empty for the latter
+ */
+bool
+aot_lazy_text_handle_fault(void *addr, char *error_buf,
+                           uint32 error_buf_size);
+#endif
+
 /**
  * Unload a AOT module.
  *
@@ -605,6 +718,14 @@ aot_module_dup_data(AOTModuleInstance *module_inst, const char *src,
 bool
 aot_enlarge_memory(AOTModuleInstance *module_inst, uint32 inc_page_count);
 
+/**
+ * Enlarge the memory of index memidx, it is called by the AOT code of
+ * memory.grow on a non-default memory
+ */
+bool
+aot_enlarge_memory_with_idx(AOTModuleInstance *module_inst,
+                            uint32 inc_page_count, uint32 memidx);
+
 /**
  * Invoke native function from aot code
  */
@@ -645,6 +766,12 @@ bool
 aot_memory_init(AOTModuleInstance *module_inst, uint32 seg_index, uint32 offset,
                 uint32 len, size_t dst);
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+bool
+aot_memory_init_with_idx(AOTModuleInstance *module_inst, uint32 seg_index,
+                         uint32 offset, uint32 len, size_t dst, uint32 memidx);
+#endif
+
 bool
 aot_data_drop(AOTModuleInstance *module_inst, uint32 seg_index);
 #endif
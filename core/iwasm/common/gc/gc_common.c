@@ -5,6 +5,7 @@
 
 #include "../wasm_runtime_common.h"
 #include "gc_export.h"
+#include "mem_alloc.h"
 #if WASM_ENABLE_INTERP != 0
 #include "../interpreter/wasm_runtime.h"
 #endif
@@ -792,35 +793,8 @@ bool
 wasm_obj_is_instance_of_defined_type(WASMObjectRef obj, WASMType *defined_type,
                                      WASMModuleCommon *const module)
 {
-    WASMType **types = NULL;
-    uint32 type_count = 0;
-    uint32 type_idx = 0;
-
-#if WASM_ENABLE_INTERP != 0
-    if (module->module_type == Wasm_Module_Bytecode) {
-        WASMModule *wasm_module = (WASMModule *)module;
-
-        type_count = wasm_module->type_count;
-        types = wasm_module->types;
-    }
-#endif
-#if WASM_ENABLE_AOT != 0
-    if (module->module_type == Wasm_Module_AoT) {
-        AOTModule *aot_module = (AOTModule *)module;
-
-        type_count = aot_module->type_count;
-        types = (WASMType **)aot_module->types;
-    }
-#endif
-
-    for (type_idx = 0; type_idx < type_count; type_idx++) {
-        if (types[type_idx] == defined_type) {
-            break;
-        }
-    }
-    bh_assert(type_idx < type_count);
-
-    return wasm_obj_is_instance_of(obj, type_idx, types, type_count);
+    (void)module;
+    return wasm_obj_is_instance_of_type(obj, defined_type);
 }
 
 bool
@@ -834,6 +808,7 @@ wasm_obj_is_instance_of_type_idx(WASMObjectRef obj, uint32 type_idx,
     if (module->module_type == Wasm_Module_Bytecode) {
         WASMModule *wasm_module = (WASMModule *)module;
 
+        type_count = wasm_module->type_count;
         types = wasm_module->types;
     }
 #endif
@@ -841,6 +816,7 @@ wasm_obj_is_instance_of_type_idx(WASMObjectRef obj, uint32 type_idx,
     if (module->module_type == Wasm_Module_AoT) {
         AOTModule *aot_module = (AOTModule *)module;
 
+        type_count = aot_module->type_count;
         types = (WASMType **)aot_module->types;
     }
 #endif
@@ -976,6 +952,18 @@ wasm_runtime_get_gc_heap_handle(WASMModuleInstanceCommon *module_inst)
     return NULL;
 }
 
+bool
+wasm_runtime_get_gc_heap_stats(WASMModuleInstanceCommon *module_inst,
+                               wasm_gc_heap_stats_t *stats)
+{
+    void *gc_heap_handle = wasm_runtime_get_gc_heap_handle(module_inst);
+
+    if (!gc_heap_handle)
+        return false;
+
+    return mem_allocator_get_gc_heap_stats(gc_heap_handle, stats);
+}
+
 bool
 wasm_runtime_get_wasm_object_extra_info_flag(WASMObjectRef obj)
 {
@@ -143,6 +143,9 @@ wasm_struct_obj_set_field(WASMStructObjectRef struct_obj, uint32 field_idx,
     else {
         bh_assert(0);
     }
+
+    if (wasm_is_type_reftype(field->field_type))
+        wasm_obj_write_barrier((WASMObjectRef)struct_obj);
 }
 
 void
@@ -272,6 +275,16 @@ wasm_array_obj_new(WASMExecEnv *exec_env, WASMRttTypeRef rtt_type,
                                        init_value);
 }
 
+static bool
+array_obj_is_ref_array(const WASMArrayObjectRef array_obj)
+{
+    WASMRttTypeRef rtt_type =
+        (WASMRttTypeRef)wasm_object_header((WASMObjectRef)array_obj);
+    WASMArrayType *array_type = (WASMArrayType *)rtt_type->defined_type;
+
+    return wasm_is_type_reftype(array_type->elem_type);
+}
+
 void
 wasm_array_obj_set_elem(WASMArrayObjectRef array_obj, uint32 elem_idx,
                         const WASMValue *value)
@@ -293,6 +306,9 @@ wasm_array_obj_set_elem(WASMArrayObjectRef array_obj, uint32 elem_idx,
             PUT_I64_TO_ADDR((uint32 *)elem_data, value->i64);
             break;
     }
+
+    if (array_obj_is_ref_array(array_obj))
+        wasm_obj_write_barrier((WASMObjectRef)array_obj);
 }
 
 void
@@ -347,6 +363,9 @@ wasm_array_obj_fill(const WASMArrayObjectRef array_obj, uint32 elem_idx,
         }
         elem_data += elem_size;
     }
+
+    if (array_obj_is_ref_array(array_obj))
+        wasm_obj_write_barrier((WASMObjectRef)array_obj);
 }
 
 void
@@ -358,6 +377,9 @@ wasm_array_obj_copy(WASMArrayObjectRef dst_obj, uint32 dst_idx,
     uint32 elem_size = 1 << wasm_array_obj_elem_size_log(dst_obj);
 
     bh_memmove_s(dst_data, elem_size * len, src_data, elem_size * len);
+
+    if (array_obj_is_ref_array(dst_obj))
+        wasm_obj_write_barrier((WASMObjectRef)dst_obj);
 }
 
 uint32
@@ -649,34 +671,30 @@ wasm_obj_is_eq_obj(WASMObjectRef obj)
 }
 
 bool
-wasm_obj_is_instance_of(WASMObjectRef obj, uint32 type_idx, WASMType **types,
-                        uint32 type_count)
+wasm_obj_is_instance_of_type(WASMObjectRef obj, const WASMType *type)
 {
     WASMRttTypeRef rtt_type_sub;
-    WASMType *type_sub, *type_parent;
-    uint32 distance, i;
 
     bh_assert(obj);
-    bh_assert(type_idx < type_count);
 
     if (wasm_obj_is_i31_externref_or_anyref_obj(obj))
         return false;
 
     rtt_type_sub = (WASMRttTypeRef)wasm_object_header(obj);
-    type_parent = types[type_idx];
-
-    if (!(rtt_type_sub->root_type == type_parent->root_type
-          && rtt_type_sub->inherit_depth >= type_parent->inherit_depth))
-        return false;
 
-    type_sub = rtt_type_sub->defined_type;
-    distance = type_sub->inherit_depth - type_parent->inherit_depth;
+    /* look up the super type display of the object's type instead of
+       walking its parent types */
+    return wasm_type_is_super_or_self_of(type, rtt_type_sub->defined_type);
+}
 
-    for (i = 0; i < distance; i++) {
-        type_sub = type_sub->parent_type;
-    }
+bool
+wasm_obj_is_instance_of(WASMObjectRef obj, uint32 type_idx, WASMType **types,
+                        uint32 type_count)
+{
+    bh_assert(type_idx < type_count);
+    (void)type_count;
 
-    return (type_sub == type_parent) ? true : false;
+    return wasm_obj_is_instance_of_type(obj, types[type_idx]);
 }
 
 bool
@@ -725,6 +743,13 @@ wasm_obj_equal(WASMObjectRef obj1, WASMObjectRef obj2)
     return obj1 == obj2 ? true : false;
 }
 
+void
+wasm_obj_write_barrier(WASMObjectRef obj)
+{
+    bh_assert(wasm_obj_is_created_from_heap(obj));
+    mem_allocator_write_barrier(obj);
+}
+
 bool
 wasm_object_get_ref_list(WASMObjectRef obj, bool *p_is_compact_mode,
                          uint32 *p_ref_num, uint16 **p_ref_list,
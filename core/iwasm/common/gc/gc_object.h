@@ -322,6 +322,10 @@ bool
 wasm_obj_is_instance_of(WASMObjectRef obj, uint32 type_idx, WASMType **types,
                         uint32 type_count);
 
+/* Whether the object is an instance of the defined type or its subtypes */
+bool
+wasm_obj_is_instance_of_type(WASMObjectRef obj, const WASMType *type);
+
 bool
 wasm_obj_is_type_of(WASMObjectRef obj, int32 heap_type);
 
@@ -333,6 +337,14 @@ wasm_object_get_ref_list(WASMObjectRef obj, bool *p_is_compact_mode,
                          uint32 *p_ref_num, uint16 **p_ref_list,
                          uint32 *p_ref_start_offset);
 
+/**
+ * Write barrier of the generational GC, it is called after a reference is
+ * stored into a field or an element of the object, so that the next minor
+ * GC traces the object if it is an old object.
+ */
+void
+wasm_obj_write_barrier(WASMObjectRef obj);
+
 #if WASM_ENABLE_STRINGREF != 0
 WASMStringrefObjectRef
 wasm_stringref_obj_new(struct WASMExecEnv *exec_env, const void *str_obj);
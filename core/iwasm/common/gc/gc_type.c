@@ -903,27 +903,42 @@ wasm_is_reftype_supers_of_noextern(uint8 type)
                : false;
 }
 
-/* Whether type1 is one of super types of type2 */
-static bool
-wasm_type_is_supers_of(const WASMType *type1, const WASMType *type2)
+bool
+wasm_type_create_super_types(WASMType *type)
 {
-    uint32 i, inherit_depth_diff;
+    uint32 inherit_depth = type->inherit_depth, count;
 
-    if (type1 == type2)
+    if (type->super_types)
+        /* already created for an equivalence type */
         return true;
 
-    if (!(type1->root_type == type2->root_type
-          && type1->inherit_depth < type2->inherit_depth))
+    count = inherit_depth < GC_TYPE_SUPER_DISPLAY_SIZE
+                ? inherit_depth + 1
+                : GC_TYPE_SUPER_DISPLAY_SIZE;
+    if (!(type->super_types =
+              wasm_runtime_malloc(sizeof(WASMType *) * count)))
         return false;
 
-    inherit_depth_diff = type2->inherit_depth - type1->inherit_depth;
-    for (i = 0; i < inherit_depth_diff; i++) {
-        type2 = type2->parent_type;
-        if (type2 == type1)
-            return true;
+    if (type->parent_type) {
+        bh_assert(type->parent_type->super_types);
+        bh_memcpy_s(type->super_types, sizeof(WASMType *) * count,
+                    type->parent_type->super_types,
+                    sizeof(WASMType *) * (inherit_depth < count ? inherit_depth
+                                                                : count));
     }
+    if (inherit_depth < count)
+        type->super_types[inherit_depth] = type;
+    return true;
+}
 
-    return false;
+/* Whether type1 is one of super types of type2 */
+static bool
+wasm_type_is_supers_of(const WASMType *type1, const WASMType *type2)
+{
+    if (type1 == type2)
+        return true;
+
+    return wasm_type_is_super_or_self_of(type1, type2);
 }
 
 bool
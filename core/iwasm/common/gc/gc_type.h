@@ -120,6 +120,29 @@ bool
 wasm_type_is_subtype_of(const WASMType *type1, const WASMType *type2,
                         const WASMTypePtr *types, uint32 type_count);
 
+/* Create the super type display of a wasm type, its parent_type and
+   inherit_depth must have been set and the display of its parent type
+   must have been created */
+bool
+wasm_type_create_super_types(WASMType *type);
+
+/* Whether wasm type1 is type2 or one of the super types of type2 */
+inline static bool
+wasm_type_is_super_or_self_of(const WASMType *type1, const WASMType *type2)
+{
+    uint32 inherit_depth = type1->inherit_depth, i;
+
+    if (inherit_depth > type2->inherit_depth)
+        return false;
+
+    if (inherit_depth < GC_TYPE_SUPER_DISPLAY_SIZE)
+        return type2->super_types[inherit_depth] == type1 ? true : false;
+
+    for (i = type2->inherit_depth; i > inherit_depth; i--)
+        type2 = type2->parent_type;
+    return type2 == type1 ? true : false;
+}
+
 /* Operations of reference type */
 
 /* Whether a value type is a reference type */
@@ -125,6 +125,10 @@ wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
 #endif
 #if WASM_ENABLE_AOT != 0
     wasm_runtime_free(exec_env->argv_buf);
+#endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (exec_env->exce_payload)
+        wasm_runtime_free(exec_env->exce_payload);
 #endif
     wasm_runtime_free(exec_env);
 }
@@ -154,7 +158,7 @@ wasm_exec_env_create(struct WASMModuleInstanceCommon *module_inst,
             (uintptr_t)module->aux_stack_bottom - module->aux_stack_size;
 #if WASM_ENABLE_GC != 0
         gc_heap_handle =
-            ((WASMModuleInstance *)module_inst)->e->common.gc_heap_pool;
+            ((WASMModuleInstance *)module_inst)->e->common.gc_heap_handle;
 #endif
     }
 #endif
@@ -153,6 +153,18 @@ typedef struct WASMExecEnv {
     uint32 max_wasm_stack_used;
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* The tag index and the payload of the wasm exception which is
+       being propagated by the AOT/JITed code */
+    uint32 exce_tag_index;
+    uint32 exce_payload_cell_num;
+    uint32 exce_payload_buf_cell_num;
+    uint32 *exce_payload;
+    /* Whether the exception of the module instance is the wasm exception
+       thrown by the AOT/JITed code, traps can't be caught */
+    bool exce_thrown;
+#endif
+
     /* The WASM stack size */
     uint32 wasm_stack_size;
 
@@ -0,0 +1,548 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_common.h"
+#include "wasm_memory.h"
+#include "bh_platform.h"
+#if WASM_ENABLE_INTERP != 0
+#include "../interpreter/wasm_runtime.h"
+#endif
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+/* The non-zero pages of a linear memory */
+typedef struct WASMMemoryImage {
+    uint32 page_count;
+    /* offset and size of each run of the non-zero pages */
+    uint32 run_count;
+    uint64 *runs;
+    /* content of the runs */
+    uint8 *data;
+} WASMMemoryImage;
+
+typedef struct WASMTableImage {
+    uint32 cur_size;
+    table_elem_type_t *elems;
+} WASMTableImage;
+
+/* The state of the instances right after instantiation */
+typedef struct WASMInstanceTemplate {
+    uint8 *global_data;
+    uint32 global_data_size;
+    uint32 memory_count;
+    WASMMemoryImage *memories;
+    uint32 table_count;
+    WASMTableImage *tables;
+    uint8 *data_dropped;
+    uint32 data_dropped_size;
+    uint8 *elem_dropped;
+    uint32 elem_dropped_size;
+    void *custom_data;
+} WASMInstanceTemplate;
+
+typedef struct WASMInstancePool {
+    WASMModuleCommon *module;
+    InstantiationArgs args;
+    korp_mutex lock;
+    /* Whether the released instances can be reset to the template,
+       otherwise they are re-instantiated */
+    bool is_resettable;
+    WASMInstanceTemplate template;
+    uint32 capacity;
+    uint32 idle_count;
+    WASMModuleInstanceCommon **idle_insts;
+} WASMInstancePool;
+
+static void *
+runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX || !(mem = wasm_runtime_malloc((uint32)size))) {
+        if (error_buf != NULL)
+            snprintf(error_buf, error_buf_size,
+                     "allocate memory for instance pool failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
+static WASMModuleInstanceExtraCommon *
+get_extra_common(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &((WASMModuleInstance *)module_inst)->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                     ->e)
+                    ->common;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+
+static bool
+is_instance_resettable(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_GC != 0
+    /* The globals and tables may refer to the objects of the GC heap */
+    (void)module_inst;
+    return false;
+#else
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    uint32 i;
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    bh_list *sub_module_inst_list = NULL;
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        sub_module_inst_list = inst->e->sub_module_inst_list;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        sub_module_inst_list =
+            ((AOTModuleInstanceExtra *)inst->e)->sub_module_inst_list;
+#endif
+    /* The imported memories, tables and globals belong to the
+       sub-instances */
+    if (sub_module_inst_list && bh_list_length(sub_module_inst_list) > 0)
+        return false;
+#endif
+
+    for (i = 0; i < inst->memory_count; i++) {
+        if (inst->memories[i]->is_shared_memory)
+            return false;
+    }
+    return true;
+#endif /* end of WASM_ENABLE_GC != 0 */
+}
+
+static bool
+is_zero_page(const uint8 *page, uint32 page_size)
+{
+    const uint64 *p = (const uint64 *)page, *p_end = p + page_size / 8;
+
+    while (p < p_end) {
+        if (*p++ != 0)
+            return false;
+    }
+    return true;
+}
+
+static bool
+create_memory_image(WASMMemoryImage *image, WASMMemoryInstance *memory,
+                    char *error_buf, uint32 error_buf_size)
+{
+    uint32 page_size = os_getpagesize(), run_count = 0, i;
+    uint64 data_size = 0, offset, run_start = 0;
+    bool in_run = false;
+
+    image->page_count = memory->cur_page_count;
+
+    /* Collect the runs of the non-zero pages twice, count them firstly
+       and then copy them */
+    for (i = 0; i < 2; i++) {
+        for (offset = 0; offset <= memory->memory_data_size;
+             offset += page_size) {
+            bool is_zero = offset == memory->memory_data_size
+                           || is_zero_page(memory->memory_data + offset,
+                                           page_size);
+
+            if (!is_zero && !in_run) {
+                run_start = offset;
+                in_run = true;
+            }
+            else if (is_zero && in_run) {
+                if (i == 0) {
+                    data_size += offset - run_start;
+                }
+                else {
+                    image->runs[run_count * 2] = run_start;
+                    image->runs[run_count * 2 + 1] = offset - run_start;
+                    memcpy(image->data + data_size,
+                           memory->memory_data + run_start, offset - run_start);
+                    data_size += offset - run_start;
+                }
+                run_count++;
+                in_run = false;
+            }
+        }
+
+        if (i == 0) {
+            if (run_count > 0
+                && (!(image->runs = runtime_malloc(
+                          sizeof(uint64) * 2 * (uint64)run_count, error_buf,
+                          error_buf_size))
+                    || !(image->data = runtime_malloc(data_size, error_buf,
+                                                      error_buf_size))))
+                return false;
+            image->run_count = run_count;
+            run_count = 0;
+            data_size = 0;
+        }
+    }
+
+    return true;
+}
+
+static void
+destroy_template(WASMInstanceTemplate *template)
+{
+    uint32 i;
+
+    if (template->global_data)
+        wasm_runtime_free(template->global_data);
+    if (template->memories) {
+        for (i = 0; i < template->memory_count; i++) {
+            if (template->memories[i].runs)
+                wasm_runtime_free(template->memories[i].runs);
+            if (template->memories[i].data)
+                wasm_runtime_free(template->memories[i].data);
+        }
+        wasm_runtime_free(template->memories);
+    }
+    if (template->tables) {
+        for (i = 0; i < template->table_count; i++) {
+            if (template->tables[i].elems)
+                wasm_runtime_free(template->tables[i].elems);
+        }
+        wasm_runtime_free(template->tables);
+    }
+    if (template->data_dropped)
+        wasm_runtime_free(template->data_dropped);
+    if (template->elem_dropped)
+        wasm_runtime_free(template->elem_dropped);
+}
+
+static bool
+copy_bitmap(uint8 **p_map, uint32 *p_map_size, bh_bitmap *bitmap,
+            char *error_buf, uint32 error_buf_size)
+{
+    uint32 map_size;
+
+    if (!bitmap)
+        return true;
+
+    map_size = (uint32)((bitmap->end_index - bitmap->begin_index + 7) / 8);
+    if (map_size == 0)
+        return true;
+
+    if (!(*p_map = runtime_malloc(map_size, error_buf, error_buf_size)))
+        return false;
+    bh_memcpy_s(*p_map, map_size, bitmap->map, map_size);
+    *p_map_size = map_size;
+    return true;
+}
+
+static bool
+create_template(WASMInstanceTemplate *template,
+                WASMModuleInstanceCommon *module_inst, char *error_buf,
+                uint32 error_buf_size)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMTableInstance *table;
+    uint64 size;
+    uint32 i;
+
+    (void)common;
+
+    if (inst->global_data_size > 0) {
+        if (!(template->global_data = runtime_malloc(
+                  inst->global_data_size, error_buf, error_buf_size)))
+            goto fail;
+        bh_memcpy_s(template->global_data, inst->global_data_size,
+                    inst->global_data, inst->global_data_size);
+        template->global_data_size = inst->global_data_size;
+    }
+
+    if (inst->memory_count > 0) {
+        size = sizeof(WASMMemoryImage) * (uint64)inst->memory_count;
+        if (!(template->memories =
+                  runtime_malloc(size, error_buf, error_buf_size)))
+            goto fail;
+        template->memory_count = inst->memory_count;
+        for (i = 0; i < inst->memory_count; i++) {
+            if (!create_memory_image(&template->memories[i], inst->memories[i],
+                                     error_buf, error_buf_size))
+                goto fail;
+        }
+    }
+
+    if (inst->table_count > 0) {
+        size = sizeof(WASMTableImage) * (uint64)inst->table_count;
+        if (!(template->tables =
+                  runtime_malloc(size, error_buf, error_buf_size)))
+            goto fail;
+        template->table_count = inst->table_count;
+        for (i = 0; i < inst->table_count; i++) {
+            table = inst->tables[i];
+            template->tables[i].cur_size = table->cur_size;
+            if (table->cur_size == 0)
+                continue;
+            size = sizeof(table_elem_type_t) * (uint64)table->cur_size;
+            if (!(template->tables[i].elems =
+                      runtime_malloc(size, error_buf, error_buf_size)))
+                goto fail;
+            bh_memcpy_s(template->tables[i].elems, (uint32)size, table->elems,
+                        (uint32)size);
+        }
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (!copy_bitmap(&template->data_dropped, &template->data_dropped_size,
+                     common->data_dropped, error_buf, error_buf_size))
+        goto fail;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (!copy_bitmap(&template->elem_dropped, &template->elem_dropped_size,
+                     common->elem_dropped, error_buf, error_buf_size))
+        goto fail;
+#endif
+
+    template->custom_data = inst->custom_data;
+    return true;
+
+fail:
+    destroy_template(template);
+    memset(template, 0, sizeof(WASMInstanceTemplate));
+    return false;
+}
+
+/* Copy the run back to the linear memory except the part overlapping
+   the app heap, which holds the native pointers of the instance that the
+   template was taken from and has been re-initialized already */
+static void
+restore_memory_run(WASMMemoryInstance *memory, uint64 offset, uint64 size,
+                   const uint8 *data)
+{
+    uint64 heap_start = (uint64)(memory->heap_data - memory->memory_data);
+    uint64 heap_end = (uint64)(memory->heap_data_end - memory->memory_data);
+    uint64 end = offset + size;
+
+    if (heap_start == heap_end || end <= heap_start || offset >= heap_end) {
+        memcpy(memory->memory_data + offset, data, size);
+        return;
+    }
+
+    if (offset < heap_start)
+        memcpy(memory->memory_data + offset, data, heap_start - offset);
+    if (end > heap_end)
+        memcpy(memory->memory_data + heap_end, data + (heap_end - offset),
+               end - heap_end);
+}
+
+/* Reset the instance to the template, the memory image is re-applied
+   to the zeroed linear memory, and the globals, tables and dropped
+   segments are restored */
+static bool
+reset_instance(WASMInstanceTemplate *template,
+               WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMMemoryInstance *memory;
+    WASMMemoryImage *image;
+    WASMTableInstance *table;
+    uint8 *data;
+    uint32 i, j;
+
+    (void)common;
+
+    if (inst->memory_count != template->memory_count
+        || inst->table_count != template->table_count
+        || inst->global_data_size != template->global_data_size)
+        return false;
+
+    for (i = 0; i < inst->memory_count; i++) {
+        memory = inst->memories[i];
+        image = &template->memories[i];
+        if (!wasm_reset_linear_memory(memory, image->page_count))
+            return false;
+        for (j = 0, data = image->data; j < image->run_count; j++) {
+            uint64 offset = image->runs[j * 2], size = image->runs[j * 2 + 1];
+
+            bh_assert(offset + size <= memory->memory_data_size);
+            restore_memory_run(memory, offset, size, data);
+            data += size;
+        }
+    }
+
+    if (template->global_data_size > 0)
+        bh_memcpy_s(inst->global_data, inst->global_data_size,
+                    template->global_data, template->global_data_size);
+
+    for (i = 0; i < inst->table_count; i++) {
+        table = inst->tables[i];
+        table->cur_size = template->tables[i].cur_size;
+        if (table->cur_size > 0)
+            bh_memcpy_s(table->elems,
+                        (uint32)sizeof(table_elem_type_t) * table->cur_size,
+                        template->tables[i].elems,
+                        (uint32)sizeof(table_elem_type_t) * table->cur_size);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (template->data_dropped)
+        bh_memcpy_s(common->data_dropped->map, template->data_dropped_size,
+                    template->data_dropped, template->data_dropped_size);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (template->elem_dropped)
+        bh_memcpy_s(common->elem_dropped->map, template->elem_dropped_size,
+                    template->elem_dropped, template->elem_dropped_size);
+#endif
+
+    inst->custom_data = template->custom_data;
+    wasm_runtime_clear_exception(module_inst);
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    /* Close the files opened by the previous user */
+    if (wasm_runtime_get_wasi_ctx(module_inst)
+        && !wasm_runtime_reset_wasi(module_inst, NULL, 0))
+        return false;
+#endif
+    return true;
+}
+
+static WASMModuleInstanceCommon *
+pool_instantiate(WASMInstancePool *pool, char *error_buf,
+                 uint32 error_buf_size)
+{
+    return wasm_runtime_instantiate_ex(pool->module, &pool->args, error_buf,
+                                       error_buf_size);
+}
+
+WASMInstancePool *
+wasm_runtime_create_instance_pool(WASMModuleCommon *module,
+                                  const InstantiationArgs *args,
+                                  uint32 pool_size, char *error_buf,
+                                  uint32 error_buf_size)
+{
+    WASMInstancePool *pool;
+    WASMModuleInstanceCommon *module_inst;
+
+    if (!(pool = runtime_malloc(sizeof(WASMInstancePool), error_buf,
+                                error_buf_size)))
+        return NULL;
+
+    if (pool_size > 0
+        && !(pool->idle_insts = runtime_malloc(
+                 sizeof(WASMModuleInstanceCommon *) * (uint64)pool_size,
+                 error_buf, error_buf_size))) {
+        wasm_runtime_free(pool);
+        return NULL;
+    }
+
+    if (os_mutex_init(&pool->lock) != 0) {
+        snprintf(error_buf, error_buf_size, "init instance pool lock failed");
+        if (pool->idle_insts)
+            wasm_runtime_free(pool->idle_insts);
+        wasm_runtime_free(pool);
+        return NULL;
+    }
+
+    pool->module = module;
+    pool->args = *args;
+    pool->capacity = pool_size;
+
+    /* Instantiate the pool, the template is captured from the first
+       instance before it is used */
+    while (pool->idle_count < pool_size) {
+        if (!(module_inst = pool_instantiate(pool, error_buf, error_buf_size)))
+            goto fail;
+        if (pool->idle_count == 0 && is_instance_resettable(module_inst)) {
+            if (!create_template(&pool->template, module_inst, error_buf,
+                                 error_buf_size)) {
+                wasm_runtime_deinstantiate(module_inst);
+                goto fail;
+            }
+            pool->is_resettable = true;
+        }
+        pool->idle_insts[pool->idle_count++] = module_inst;
+    }
+
+    return pool;
+
+fail:
+    wasm_runtime_destroy_instance_pool(pool);
+    return NULL;
+}
+
+void
+wasm_runtime_destroy_instance_pool(WASMInstancePool *pool)
+{
+    uint32 i;
+
+    for (i = 0; i < pool->idle_count; i++)
+        wasm_runtime_deinstantiate(pool->idle_insts[i]);
+    if (pool->idle_insts)
+        wasm_runtime_free(pool->idle_insts);
+    destroy_template(&pool->template);
+    os_mutex_destroy(&pool->lock);
+    wasm_runtime_free(pool);
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_instance_pool_acquire(WASMInstancePool *pool, char *error_buf,
+                                   uint32 error_buf_size)
+{
+    WASMModuleInstanceCommon *module_inst = NULL;
+
+    os_mutex_lock(&pool->lock);
+    if (pool->idle_count > 0)
+        module_inst = pool->idle_insts[--pool->idle_count];
+    os_mutex_unlock(&pool->lock);
+
+    if (!module_inst)
+        /* The pool is exhausted */
+        module_inst = pool_instantiate(pool, error_buf, error_buf_size);
+
+    return module_inst;
+}
+
+void
+wasm_runtime_instance_pool_release(WASMInstancePool *pool,
+                                   WASMModuleInstanceCommon *module_inst)
+{
+    bool is_full;
+
+    bh_assert(wasm_runtime_get_module(module_inst) == pool->module);
+
+    os_mutex_lock(&pool->lock);
+    is_full = pool->idle_count >= pool->capacity;
+    os_mutex_unlock(&pool->lock);
+
+    if (is_full) {
+        wasm_runtime_deinstantiate(module_inst);
+        return;
+    }
+
+    if (!pool->is_resettable
+        || !reset_instance(&pool->template, module_inst)) {
+        /* Replace it with a new instance, so that the next acquire
+           still needn't to instantiate */
+        wasm_runtime_deinstantiate(module_inst);
+        if (!(module_inst = pool_instantiate(pool, NULL, 0)))
+            return;
+    }
+
+    os_mutex_lock(&pool->lock);
+    if (pool->idle_count < pool->capacity) {
+        pool->idle_insts[pool->idle_count++] = module_inst;
+        module_inst = NULL;
+    }
+    os_mutex_unlock(&pool->lock);
+
+    if (module_inst)
+        wasm_runtime_deinstantiate(module_inst);
+}
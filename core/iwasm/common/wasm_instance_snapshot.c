@@ -0,0 +1,732 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_common.h"
+#include "wasm_memory.h"
+#include "bh_platform.h"
+#include "mem_alloc.h"
+#if WASM_ENABLE_INTERP != 0
+#include "../interpreter/wasm_runtime.h"
+#endif
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+/**
+ * Layout of the snapshot, the integers are in the native byte order:
+ *
+ *   SnapshotHeader
+ *   for each memory:
+ *     SnapshotMemory
+ *     the heap structure if heap_size > 0
+ *     run_count * (uint64 offset, uint64 size, size bytes of content)
+ *   global_data_size bytes of the global data
+ *   for each table: uint32 cur_size, cur_size elements
+ *   data_dropped_size bytes of the dropped data segment bitmap
+ *   elem_dropped_size bytes of the dropped element segment bitmap
+ */
+#define SNAPSHOT_MAGIC 0x70616e73 /* "snap" */
+#define SNAPSHOT_VERSION 1
+
+typedef struct SnapshotHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 module_type;
+    /* The snapshot can only be restored by the same kind of runtime */
+    uint32 pointer_size;
+    uint32 heap_struct_size;
+    uint32 memory_count;
+    uint32 table_count;
+    uint32 global_data_size;
+    uint32 data_dropped_size;
+    uint32 elem_dropped_size;
+} SnapshotHeader;
+
+typedef struct SnapshotMemory {
+    uint32 num_bytes_per_page;
+    uint32 cur_page_count;
+    uint64 memory_data_size;
+    uint64 heap_offset;
+    uint64 heap_size;
+    uint32 run_count;
+    uint32 __padding__;
+} SnapshotMemory;
+
+typedef struct SnapshotWriter {
+    /* NULL when only the size is calculated */
+    uint8 *buf;
+    uint64 pos;
+    /* Size of the beginning of the default memory which isn't written,
+       it is saved in the memory image of the clone image */
+    uint64 mapped_size;
+} SnapshotWriter;
+
+typedef struct SnapshotReader {
+    const uint8 *buf;
+    uint64 size;
+    uint64 pos;
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* The image mapped to the beginning of the default memory */
+    const WASMDataImage *memory_image;
+#endif
+} SnapshotReader;
+
+/* The state of the instance captured when it is cloned the first time,
+   from which all its clones are created */
+typedef struct WASMCloneImage {
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* The beginning of the default memory, mapped copy-on-write */
+    WASMDataImage *memory_image;
+#endif
+    /* The snapshot of the rest of the state */
+    uint8 *state;
+    uint32 state_size;
+} WASMCloneImage;
+
+static korp_mutex clone_lock = OS_THREAD_MUTEX_INITIALIZER;
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL)
+        snprintf(error_buf, error_buf_size, "%s", string);
+}
+
+static WASMModuleInstanceExtraCommon *
+get_extra_common(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &((WASMModuleInstance *)module_inst)->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                     ->e)
+                    ->common;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+
+static bool
+check_instance(WASMModuleInstanceCommon *module_inst, char *error_buf,
+               uint32 error_buf_size)
+{
+#if WASM_ENABLE_GC != 0
+    /* The globals and tables may refer to the objects of the GC heap */
+    (void)module_inst;
+    set_error_buf(error_buf, error_buf_size,
+                  "snapshot isn't supported when GC is enabled");
+    return false;
+#else
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    uint32 i;
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    bh_list *sub_module_inst_list = NULL;
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        sub_module_inst_list = inst->e->sub_module_inst_list;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        sub_module_inst_list =
+            ((AOTModuleInstanceExtra *)inst->e)->sub_module_inst_list;
+#endif
+    if (sub_module_inst_list && bh_list_length(sub_module_inst_list) > 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot isn't supported by instance with sub-modules");
+        return false;
+    }
+#endif
+
+    for (i = 0; i < inst->memory_count; i++) {
+        if (inst->memories[i]->is_shared_memory) {
+            set_error_buf(error_buf, error_buf_size,
+                          "snapshot isn't supported by shared memory");
+            return false;
+        }
+    }
+    return true;
+#endif /* end of WASM_ENABLE_GC != 0 */
+}
+
+static bool
+is_zero_range(const uint8 *data, uint64 size)
+{
+    const uint64 *p = (const uint64 *)data, *p_end = p + size / 8;
+    const uint8 *p_tail = (const uint8 *)p_end, *p_tail_end = data + size;
+
+    while (p < p_end) {
+        if (*p++ != 0)
+            return false;
+    }
+    while (p_tail < p_tail_end) {
+        if (*p_tail++ != 0)
+            return false;
+    }
+    return true;
+}
+
+static void
+write_data(SnapshotWriter *writer, const void *data, uint64 size)
+{
+    if (writer->buf && size > 0)
+        memcpy(writer->buf + writer->pos, data, size);
+    writer->pos += size;
+}
+
+static const uint8 *
+read_data(SnapshotReader *reader, uint64 size)
+{
+    const uint8 *data = reader->buf + reader->pos;
+
+    if (size > reader->size - reader->pos)
+        return NULL;
+    reader->pos += size;
+    return data;
+}
+
+/* Write the runs of the non-zero pages of the linear memory */
+static void
+write_memory(SnapshotWriter *writer, WASMMemoryInstance *memory,
+             uint64 mapped_size)
+{
+    uint32 page_size = os_getpagesize();
+    SnapshotMemory info = { 0 };
+    uint64 offset, size, run_start = 0, run_count_pos;
+    bool in_run = false;
+
+    info.num_bytes_per_page = memory->num_bytes_per_page;
+    info.cur_page_count = memory->cur_page_count;
+    info.memory_data_size = memory->memory_data_size;
+    info.heap_offset = (uint64)(memory->heap_data - memory->memory_data);
+    info.heap_size = (uint64)(memory->heap_data_end - memory->heap_data);
+
+    run_count_pos = writer->pos + offsetof(SnapshotMemory, run_count);
+    write_data(writer, &info, sizeof(SnapshotMemory));
+    if (info.heap_size > 0)
+        write_data(writer, memory->heap_handle,
+                   mem_allocator_get_heap_struct_size());
+
+    for (offset = mapped_size; offset <= memory->memory_data_size;
+         offset += size) {
+        bool is_zero;
+
+        size = memory->memory_data_size - offset;
+        if (size > page_size)
+            size = page_size;
+        is_zero = size == 0
+                  || is_zero_range(memory->memory_data + offset, size);
+
+        if (!is_zero && !in_run) {
+            run_start = offset;
+            in_run = true;
+        }
+        else if (is_zero && in_run) {
+            uint64 run[2] = { run_start, offset - run_start };
+
+            write_data(writer, run, sizeof(run));
+            write_data(writer, memory->memory_data + run_start, run[1]);
+            info.run_count++;
+            in_run = false;
+        }
+
+        if (size == 0)
+            break;
+    }
+
+    if (writer->buf)
+        bh_memcpy_s(writer->buf + run_count_pos, sizeof(uint32),
+                    &info.run_count, sizeof(uint32));
+}
+
+#if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_REF_TYPES != 0
+static void
+write_bitmap(SnapshotWriter *writer, bh_bitmap *bitmap, uint32 *p_map_size)
+{
+    uint32 map_size = 0;
+
+    if (bitmap)
+        map_size = (uint32)((bitmap->end_index - bitmap->begin_index + 7) / 8);
+    write_data(writer, bitmap ? bitmap->map : NULL, map_size);
+    *p_map_size = map_size;
+}
+#endif
+
+static void
+write_snapshot(SnapshotWriter *writer, WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    SnapshotHeader header = { 0 };
+    WASMTableInstance *table;
+    uint32 i;
+
+    (void)common;
+
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.module_type = module_inst->module_type;
+    header.pointer_size = (uint32)sizeof(void *);
+    header.heap_struct_size = mem_allocator_get_heap_struct_size();
+    header.memory_count = inst->memory_count;
+    header.table_count = inst->table_count;
+    header.global_data_size = inst->global_data_size;
+    /* The sizes of the bitmaps are filled after they are written */
+    write_data(writer, &header, sizeof(SnapshotHeader));
+
+    for (i = 0; i < inst->memory_count; i++)
+        write_memory(writer, inst->memories[i],
+                     i == 0 ? writer->mapped_size : 0);
+
+    write_data(writer, inst->global_data, inst->global_data_size);
+
+    for (i = 0; i < inst->table_count; i++) {
+        table = inst->tables[i];
+        write_data(writer, &table->cur_size, sizeof(uint32));
+        write_data(writer, table->elems,
+                   sizeof(table_elem_type_t) * (uint64)table->cur_size);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    write_bitmap(writer, common->data_dropped, &header.data_dropped_size);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    write_bitmap(writer, common->elem_dropped, &header.elem_dropped_size);
+#endif
+
+    if (writer->buf)
+        bh_memcpy_s(writer->buf, sizeof(SnapshotHeader), &header,
+                    sizeof(SnapshotHeader));
+}
+
+bool
+wasm_runtime_snapshot_instance(WASMModuleInstanceCommon *module_inst,
+                               uint8 **p_buf, uint32 *p_size, char *error_buf,
+                               uint32 error_buf_size)
+{
+    SnapshotWriter writer = { 0 };
+
+    if (!check_instance(module_inst, error_buf, error_buf_size))
+        return false;
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    /* The WASI context is re-created from the WASI arguments of the module
+       when the snapshot is restored, the other opened files are lost */
+    if (!wasm_runtime_wasi_has_only_preopens(module_inst)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot isn't supported when WASI files are opened");
+        return false;
+    }
+#endif
+
+    /* Calculate the size firstly and then write the snapshot */
+    write_snapshot(&writer, module_inst);
+    if (writer.pos >= UINT32_MAX
+        || !(writer.buf = wasm_runtime_malloc((uint32)writer.pos))) {
+        set_error_buf(error_buf, error_buf_size,
+                      "allocate memory for snapshot failed");
+        return false;
+    }
+
+    *p_size = (uint32)writer.pos;
+    writer.pos = 0;
+    write_snapshot(&writer, module_inst);
+    bh_assert(writer.pos == *p_size);
+
+    *p_buf = writer.buf;
+    return true;
+}
+
+#if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_REF_TYPES != 0
+static bool
+restore_bitmap(SnapshotReader *reader, bh_bitmap *bitmap, uint32 map_size)
+{
+    const uint8 *data;
+
+    if (map_size == 0)
+        return !bitmap || bitmap->end_index == bitmap->begin_index;
+
+    if (!bitmap
+        || map_size
+               != (uint32)((bitmap->end_index - bitmap->begin_index + 7) / 8)
+        || !(data = read_data(reader, map_size)))
+        return false;
+
+    bh_memcpy_s(bitmap->map, map_size, data, map_size);
+    return true;
+}
+#endif
+
+/* Zero the non-zero pages of [offset, end) of the linear memory */
+static void
+zero_memory_range(WASMMemoryInstance *memory, uint64 offset, uint64 end)
+{
+    uint32 page_size = os_getpagesize();
+    uint64 size;
+
+    for (; offset < end; offset += size) {
+        size = end - offset;
+        if (size > page_size)
+            size = page_size;
+        if (!is_zero_range(memory->memory_data + offset, size))
+            memset(memory->memory_data + offset, 0, size);
+    }
+}
+
+static bool
+restore_memory(SnapshotReader *reader, WASMModuleInstanceCommon *module_inst,
+               uint32 memory_idx, uint32 heap_struct_size)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMMemoryInstance *memory = inst->memories[memory_idx];
+    SnapshotMemory info;
+    const uint8 *data, *heap_struct = NULL;
+    uint64 end = 0, run[2];
+    uint32 i;
+
+    if (!(data = read_data(reader, sizeof(SnapshotMemory))))
+        return false;
+    bh_memcpy_s(&info, sizeof(SnapshotMemory), data, sizeof(SnapshotMemory));
+
+    if (info.num_bytes_per_page != memory->num_bytes_per_page
+        || info.cur_page_count < memory->cur_page_count)
+        return false;
+
+    /* Only the default memory can be grown by the runtime */
+    if (info.cur_page_count > memory->cur_page_count
+        && (memory_idx != 0
+            || !wasm_runtime_enlarge_memory(
+                module_inst, info.cur_page_count - memory->cur_page_count)))
+        return false;
+    /* The memory instance may be re-allocated when it is grown */
+    memory = inst->memories[memory_idx];
+
+    if (info.memory_data_size != memory->memory_data_size
+        || info.heap_offset
+               != (uint64)(memory->heap_data - memory->memory_data)
+        || info.heap_size
+               != (uint64)(memory->heap_data_end - memory->heap_data))
+        return false;
+
+    if (info.heap_size > 0
+        && !(heap_struct = read_data(reader, heap_struct_size)))
+        return false;
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    if (memory_idx == 0 && reader->memory_image) {
+        if (!wasm_data_image_map(reader->memory_image, memory->memory_data,
+                                 memory->memory_data_size))
+            return false;
+        /* The pages discarded from now on read as the image */
+        memory->is_data_image_mapped = true;
+        end = reader->memory_image->size;
+    }
+#endif
+
+    for (i = 0; i < info.run_count; i++) {
+        if (!(data = read_data(reader, sizeof(run))))
+            return false;
+        bh_memcpy_s(run, sizeof(run), data, sizeof(run));
+        if (run[0] < end || run[1] > memory->memory_data_size
+            || run[0] > memory->memory_data_size - run[1]
+            || !(data = read_data(reader, run[1])))
+            return false;
+        /* Only touch the pages which aren't zero, so that the pages never
+           used aren't committed */
+        zero_memory_range(memory, end, run[0]);
+        memcpy(memory->memory_data + run[0], data, run[1]);
+        end = run[0] + run[1];
+    }
+    zero_memory_range(memory, end, memory->memory_data_size);
+
+    /* The heap structure holds the native pointers to the pool buffer of
+       the saved instance, migrate them to this instance */
+    if (heap_struct
+        && mem_allocator_restore(memory->heap_handle, heap_struct,
+                                 (char *)memory->heap_data,
+                                 (uint32)info.heap_size)
+               != 0)
+        return false;
+
+    return true;
+}
+
+static bool
+restore_snapshot(SnapshotReader *reader,
+                 WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    SnapshotHeader header;
+    WASMTableInstance *table;
+    const uint8 *data;
+    uint32 i, cur_size;
+
+    (void)common;
+
+    if (!(data = read_data(reader, sizeof(SnapshotHeader))))
+        return false;
+    bh_memcpy_s(&header, sizeof(SnapshotHeader), data, sizeof(SnapshotHeader));
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION
+        || header.module_type != module_inst->module_type
+        || header.pointer_size != (uint32)sizeof(void *)
+        || header.heap_struct_size != mem_allocator_get_heap_struct_size()
+        || header.memory_count != inst->memory_count
+        || header.table_count != inst->table_count
+        || header.global_data_size != inst->global_data_size)
+        return false;
+
+    for (i = 0; i < inst->memory_count; i++) {
+        if (!restore_memory(reader, module_inst, i, header.heap_struct_size))
+            return false;
+    }
+
+    if (!(data = read_data(reader, header.global_data_size)))
+        return false;
+    if (header.global_data_size > 0)
+        bh_memcpy_s(inst->global_data, inst->global_data_size, data,
+                    header.global_data_size);
+
+    for (i = 0; i < inst->table_count; i++) {
+        table = inst->tables[i];
+        if (!(data = read_data(reader, sizeof(uint32))))
+            return false;
+        bh_memcpy_s(&cur_size, sizeof(uint32), data, sizeof(uint32));
+        if (cur_size > table->max_size
+            || !(data = read_data(reader, sizeof(table_elem_type_t)
+                                              * (uint64)cur_size)))
+            return false;
+        table->cur_size = cur_size;
+        if (cur_size > 0)
+            bh_memcpy_s(table->elems,
+                        (uint32)sizeof(table_elem_type_t) * cur_size, data,
+                        (uint32)sizeof(table_elem_type_t) * cur_size);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (!restore_bitmap(reader, common->data_dropped,
+                        header.data_dropped_size))
+        return false;
+#else
+    if (header.data_dropped_size > 0)
+        return false;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (!restore_bitmap(reader, common->elem_dropped,
+                        header.elem_dropped_size))
+        return false;
+#else
+    if (header.elem_dropped_size > 0)
+        return false;
+#endif
+
+    return reader->pos == reader->size;
+}
+
+static WASMModuleInstanceCommon *
+instantiate_from_snapshot(WASMModuleCommon *module,
+                          const InstantiationArgs *args,
+                          SnapshotReader *reader, char *error_buf,
+                          uint32 error_buf_size)
+{
+    WASMModuleInstanceCommon *module_inst;
+
+    if (!(module_inst = wasm_runtime_instantiate_ex(module, args, error_buf,
+                                                    error_buf_size)))
+        return NULL;
+
+    if (!check_instance(module_inst, error_buf, error_buf_size))
+        goto fail;
+
+    if (!restore_snapshot(reader, module_inst)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "restore instance failed: invalid or mismatched "
+                      "snapshot");
+        goto fail;
+    }
+
+    wasm_runtime_clear_exception(module_inst);
+    return module_inst;
+
+fail:
+    wasm_runtime_deinstantiate(module_inst);
+    return NULL;
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_restore_instance(WASMModuleCommon *module,
+                              const InstantiationArgs *args, const uint8 *buf,
+                              uint32 size, char *error_buf,
+                              uint32 error_buf_size)
+{
+    SnapshotReader reader = { 0 };
+
+    reader.buf = buf;
+    reader.size = size;
+    return instantiate_from_snapshot(module, args, &reader, error_buf,
+                                     error_buf_size);
+}
+
+void
+wasm_runtime_destroy_clone_image(WASMModuleInstanceCommon *module_inst)
+{
+    WASMCloneImage *image = get_extra_common(module_inst)->clone_image;
+
+    if (!image)
+        return;
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* The clones still mapping the image keep its content */
+    if (image->memory_image)
+        wasm_data_image_destroy(image->memory_image);
+#endif
+    if (image->state)
+        wasm_runtime_free(image->state);
+    wasm_runtime_free(image);
+    get_extra_common(module_inst)->clone_image = NULL;
+}
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+/* Save the non-zero pages of the beginning of the default memory to the
+   memory image of the clone image */
+static WASMDataImage *
+create_memory_image(WASMMemoryInstance *memory, uint64 mapped_size)
+{
+    WASMDataImage *image;
+    uint32 page_size = os_getpagesize();
+    uint64 offset, run_start = 0;
+    bool in_run = false;
+
+    if (!(image = wasm_data_image_create(mapped_size)))
+        return NULL;
+    bh_assert(image->size == mapped_size);
+
+    for (offset = 0; offset <= mapped_size; offset += page_size) {
+        bool is_zero =
+            offset == mapped_size
+            || is_zero_range(memory->memory_data + offset, page_size);
+
+        if (!is_zero && !in_run) {
+            run_start = offset;
+            in_run = true;
+        }
+        /* Flush the long runs in pieces as the length of the write is
+           32-bit */
+        else if (in_run && (is_zero || offset - run_start >= UINT32_MAX / 2)) {
+            if (!wasm_data_image_write(image, run_start,
+                                       memory->memory_data + run_start,
+                                       (uint32)(offset - run_start))) {
+                wasm_data_image_destroy(image);
+                return NULL;
+            }
+            run_start = offset;
+            in_run = !is_zero;
+        }
+    }
+    return image;
+}
+#endif
+
+static WASMCloneImage *
+create_clone_image(WASMModuleInstanceCommon *module_inst, char *error_buf,
+                   uint32 error_buf_size)
+{
+    WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+    WASMCloneImage *image;
+    SnapshotWriter writer = { 0 };
+
+    (void)inst;
+
+    if (!(image = wasm_runtime_malloc(sizeof(WASMCloneImage)))) {
+        set_error_buf(error_buf, error_buf_size,
+                      "allocate memory for clone image failed");
+        return NULL;
+    }
+    memset(image, 0, sizeof(WASMCloneImage));
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    if (inst->memory_count > 0) {
+        WASMMemoryInstance *memory = inst->memories[0];
+        uint64 mapped_size = memory->memory_data_size
+                             / os_getpagesize() * os_getpagesize();
+
+        /* The memory is copied by the clones if the image can't be
+           created */
+        if (mapped_size > 0
+            && (image->memory_image =
+                    create_memory_image(memory, mapped_size)))
+            writer.mapped_size = mapped_size;
+    }
+#endif
+
+    write_snapshot(&writer, module_inst);
+    if (writer.pos >= UINT32_MAX
+        || !(writer.buf = wasm_runtime_malloc((uint32)writer.pos))) {
+        set_error_buf(error_buf, error_buf_size,
+                      "allocate memory for clone image failed");
+        goto fail;
+    }
+
+    image->state = writer.buf;
+    image->state_size = (uint32)writer.pos;
+    writer.pos = 0;
+    write_snapshot(&writer, module_inst);
+    bh_assert(writer.pos == image->state_size);
+    return image;
+
+fail:
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    if (image->memory_image)
+        wasm_data_image_destroy(image->memory_image);
+#endif
+    wasm_runtime_free(image);
+    return NULL;
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_clone_instance(WASMModuleInstanceCommon *module_inst,
+                            const InstantiationArgs *args, char *error_buf,
+                            uint32 error_buf_size)
+{
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMCloneImage *image;
+    SnapshotReader reader = { 0 };
+
+    os_mutex_lock(&clone_lock);
+    if (!(image = common->clone_image)) {
+        if (!check_instance(module_inst, error_buf, error_buf_size))
+            goto fail;
+#if WASM_ENABLE_LIBC_WASI != 0
+        if (!wasm_runtime_wasi_has_only_preopens(module_inst)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "clone isn't supported when WASI files are opened");
+            goto fail;
+        }
+#endif
+        if (!(image = create_clone_image(module_inst, error_buf,
+                                         error_buf_size)))
+            goto fail;
+        common->clone_image = image;
+    }
+    os_mutex_unlock(&clone_lock);
+
+    reader.buf = image->state;
+    reader.size = image->state_size;
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    reader.memory_image = image->memory_image;
+#endif
+    return instantiate_from_snapshot(
+        wasm_runtime_get_module(module_inst), args, &reader, error_buf,
+        error_buf_size);
+
+fail:
+    os_mutex_unlock(&clone_lock);
+    return NULL;
+}
@@ -60,6 +60,24 @@ static void (*free_func)(
 
 static unsigned int global_pool_size;
 
+/* The 8 GB regions reserved for the linear memories when the hardware
+   bound check is enabled are cached when the memories are released and
+   reused by the later instantiations, which avoids the contention of the
+   process-wide mmap lock and the TLB shootdowns of munmap on all cores
+   when the instances are created and destroyed frequently */
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0 \
+    && WASM_MEM_SLOT_CACHE_SIZE > 0
+#define WASM_MEM_SLOT_CACHE_ENABLED 1
+#else
+#define WASM_MEM_SLOT_CACHE_ENABLED 0
+#endif
+
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+static void *memory_slots[WASM_MEM_SLOT_CACHE_SIZE];
+static uint32 memory_slot_count;
+static korp_mutex memory_slot_lock;
+#endif
+
 static uint64
 align_as_and_cast(uint64 size, uint64 alignment)
 {
@@ -74,6 +92,9 @@ wasm_memory_init_with_pool(void *mem, unsigned int bytes)
     mem_allocator_t allocator = mem_allocator_create(mem, bytes);
 
     if (allocator) {
+        /* The pool is shared by all threads, cache the small blocks
+           freed by each thread to reduce the contention of its lock */
+        mem_allocator_enable_thread_cache(allocator);
         memory_mode = MEMORY_MODE_POOL;
         pool_allocator = allocator;
         global_pool_size = bytes;
@@ -132,16 +153,96 @@ is_bounds_checks_enabled(WASMModuleInstanceCommon *module_inst)
 #endif
 }
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+#if WASM_MEM_DATA_IMAGE_SUPPORTED == 0
+#error "Shared heap requires the hardware bound check"
+#endif
+
+/* The shared heap is mapped to the top of the 4 GB app address space,
+   so an app offset in it is valid in all the instances attached */
+#define SHARED_HEAP_END_OFFSET ((uint64)1 << 32)
+#define SHARED_HEAP_START_OFFSET(heap) (SHARED_HEAP_END_OFFSET - (heap)->size)
+
+typedef struct WASMSharedHeap {
+    /* The memory file mapped by the host and the instances */
+    os_file_handle file;
+    /* The mapping of the file in the host */
+    uint8 *base_addr;
+    /* Size of the heap, aligned to the system page size */
+    uint64 size;
+    /* The allocator, its struct is kept out of the heap so that the
+       apps can't corrupt it */
+    mem_allocator_t heap_handle;
+    /* The number of the instances attached */
+    uint32 attach_count;
+} WASMSharedHeap;
+
+static korp_mutex shared_heap_lock = OS_THREAD_MUTEX_INITIALIZER;
+
+static WASMModuleInstanceExtraCommon *
+get_extra_common(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &((WASMModuleInstance *)module_inst)->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                     ->e)
+                    ->common;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+#endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
+
+bool
+wasm_runtime_is_app_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
+                                        uint64 app_offset, uint64 bytes)
+{
+#if WASM_ENABLE_SHARED_HEAP != 0
+    WASMSharedHeap *heap = get_extra_common(module_inst)->shared_heap;
+
+    return heap && app_offset >= SHARED_HEAP_START_OFFSET(heap)
+           && bytes <= SHARED_HEAP_END_OFFSET - app_offset;
+#else
+    (void)module_inst;
+    (void)app_offset;
+    (void)bytes;
+    return false;
+#endif
+}
+
+#if WASM_ENABLE_SHARED_HEAP != 0
+static bool
+is_native_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
+                              WASMMemoryInstance *memory_inst, uint8 *addr,
+                              uint64 bytes)
+{
+    return memory_inst->memory_data <= addr
+           && wasm_runtime_is_app_addr_in_shared_heap(
+               module_inst, (uint64)(addr - memory_inst->memory_data), bytes);
+}
+#endif
+
 bool
 wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
                          const MemAllocOption *alloc_option)
 {
+    bool ret;
+
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+    if (os_mutex_init(&memory_slot_lock) != 0)
+        return false;
+#endif
+
     if (mem_alloc_type == Alloc_With_Pool) {
-        return wasm_memory_init_with_pool(alloc_option->pool.heap_buf,
-                                          alloc_option->pool.heap_size);
+        ret = wasm_memory_init_with_pool(alloc_option->pool.heap_buf,
+                                         alloc_option->pool.heap_size);
     }
     else if (mem_alloc_type == Alloc_With_Allocator) {
-        return wasm_memory_init_with_allocator(
+        ret = wasm_memory_init_with_allocator(
 #if WASM_MEM_ALLOC_WITH_USER_DATA != 0
             alloc_option->allocator.user_data,
 #endif
@@ -151,16 +252,28 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
     }
     else if (mem_alloc_type == Alloc_With_System_Allocator) {
         memory_mode = MEMORY_MODE_SYSTEM_ALLOCATOR;
-        return true;
+        ret = true;
     }
     else {
-        return false;
+        ret = false;
     }
+
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+    if (!ret)
+        os_mutex_destroy(&memory_slot_lock);
+#endif
+    return ret;
 }
 
 void
 wasm_runtime_memory_destroy()
 {
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+    while (memory_slot_count > 0)
+        os_munmap(memory_slots[--memory_slot_count], 8 * (uint64)BH_GB);
+    os_mutex_destroy(&memory_slot_lock);
+#endif
+
     if (memory_mode == MEMORY_MODE_POOL) {
 #if BH_ENABLE_GC_VERIFY == 0
         (void)mem_allocator_destroy(pool_allocator);
@@ -175,6 +288,13 @@ wasm_runtime_memory_destroy()
     memory_mode = MEMORY_MODE_UNKNOWN;
 }
 
+void
+wasm_runtime_memory_flush_thread_cache()
+{
+    if (memory_mode == MEMORY_MODE_POOL)
+        mem_allocator_flush_thread_cache(pool_allocator);
+}
+
 unsigned
 wasm_runtime_memory_pool_size()
 {
@@ -354,6 +474,12 @@ wasm_runtime_validate_app_addr(WASMModuleInstanceCommon *module_inst_comm,
 
     SHARED_MEMORY_UNLOCK(memory_inst);
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    if (wasm_runtime_is_app_addr_in_shared_heap(module_inst_comm, app_offset,
+                                                size))
+        return true;
+#endif
+
 fail:
     wasm_set_exception(module_inst, "out of bounds memory access");
     return false;
@@ -441,6 +567,12 @@ wasm_runtime_validate_native_addr(WASMModuleInstanceCommon *module_inst_comm,
 
     SHARED_MEMORY_UNLOCK(memory_inst);
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    if (is_native_addr_in_shared_heap(module_inst_comm, memory_inst, addr,
+                                      size))
+        return true;
+#endif
+
 fail:
     wasm_set_exception(module_inst, "out of bounds memory access");
     return false;
@@ -470,8 +602,13 @@ wasm_runtime_addr_app_to_native(WASMModuleInstanceCommon *module_inst_comm,
     addr = memory_inst->memory_data + (uintptr_t)app_offset;
 
     if (bounds_checks) {
-        if (memory_inst->memory_data <= addr
-            && addr < memory_inst->memory_data_end) {
+        if ((memory_inst->memory_data <= addr
+             && addr < memory_inst->memory_data_end)
+#if WASM_ENABLE_SHARED_HEAP != 0
+            || wasm_runtime_is_app_addr_in_shared_heap(module_inst_comm,
+                                                       app_offset, 1)
+#endif
+        ) {
             SHARED_MEMORY_UNLOCK(memory_inst);
             return addr;
         }
@@ -507,8 +644,13 @@ wasm_runtime_addr_native_to_app(WASMModuleInstanceCommon *module_inst_comm,
     SHARED_MEMORY_LOCK(memory_inst);
 
     if (bounds_checks) {
-        if (memory_inst->memory_data <= addr
-            && addr < memory_inst->memory_data_end) {
+        if ((memory_inst->memory_data <= addr
+             && addr < memory_inst->memory_data_end)
+#if WASM_ENABLE_SHARED_HEAP != 0
+            || is_native_addr_in_shared_heap(module_inst_comm, memory_inst,
+                                             addr, 1)
+#endif
+        ) {
             ret = (uint64)(addr - memory_inst->memory_data);
             SHARED_MEMORY_UNLOCK(memory_inst);
             return ret;
@@ -556,6 +698,19 @@ wasm_runtime_get_app_addr_range(WASMModuleInstanceCommon *module_inst_comm,
     }
 
     SHARED_MEMORY_UNLOCK(memory_inst);
+
+#if WASM_ENABLE_SHARED_HEAP != 0
+    if (wasm_runtime_is_app_addr_in_shared_heap(module_inst_comm, app_offset,
+                                                1)) {
+        WASMSharedHeap *heap = get_extra_common(module_inst_comm)->shared_heap;
+
+        if (p_app_start_offset)
+            *p_app_start_offset = SHARED_HEAP_START_OFFSET(heap);
+        if (p_app_end_offset)
+            *p_app_end_offset = SHARED_HEAP_END_OFFSET;
+        return true;
+    }
+#endif
     return false;
 }
 
@@ -590,6 +745,21 @@ wasm_runtime_get_native_addr_range(WASMModuleInstanceCommon *module_inst_comm,
     }
 
     SHARED_MEMORY_UNLOCK(memory_inst);
+
+#if WASM_ENABLE_SHARED_HEAP != 0
+    if (is_native_addr_in_shared_heap(module_inst_comm, memory_inst, addr,
+                                      1)) {
+        WASMSharedHeap *heap = get_extra_common(module_inst_comm)->shared_heap;
+
+        if (p_native_start_addr)
+            *p_native_start_addr =
+                memory_inst->memory_data + SHARED_HEAP_START_OFFSET(heap);
+        if (p_native_end_addr)
+            *p_native_end_addr =
+                memory_inst->memory_data + SHARED_HEAP_END_OFFSET;
+        return true;
+    }
+#endif
     return false;
 }
 
@@ -621,8 +791,13 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     }
 
     /* No need to check the app_offset and buf_size if memory access
-       boundary check with hardware trap is enabled */
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+       boundary check with hardware trap is enabled, except for memory64
+       whose address may be out of the reserved space */
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    if (!memory_inst->is_memory64)
+        goto success;
+#endif
+
     SHARED_MEMORY_LOCK(memory_inst);
 
     if (app_buf_addr >= memory_inst->memory_data_size) {
@@ -647,18 +822,15 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     }
 
     SHARED_MEMORY_UNLOCK(memory_inst);
-#endif
 
 success:
     *p_native_addr = (void *)native_addr;
     return true;
 
-#ifndef OS_ENABLE_HW_BOUND_CHECK
 fail:
     SHARED_MEMORY_UNLOCK(memory_inst);
     wasm_set_exception(module_inst, "out of bounds memory access");
     return false;
-#endif
 }
 
 WASMMemoryInstance *
@@ -740,16 +912,81 @@ wasm_mremap_linear_memory(void *mapped_mem, uint64 old_size, uint64 new_size,
     return new_mem;
 }
 
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+static void *
+acquire_memory_slot(uint64 commit_size)
+{
+    void *slot = NULL;
+
+    os_mutex_lock(&memory_slot_lock);
+    if (memory_slot_count > 0)
+        slot = memory_slots[--memory_slot_count];
+    os_mutex_unlock(&memory_slot_lock);
+
+    if (!slot)
+        return NULL;
+
+#ifdef BH_PLATFORM_WINDOWS
+    if (commit_size > 0
+        && !os_mem_commit(slot, commit_size,
+                          MMAP_PROT_READ | MMAP_PROT_WRITE)) {
+        os_munmap(slot, 8 * (uint64)BH_GB);
+        return NULL;
+    }
+#endif
+
+    if (os_mprotect(slot, commit_size, MMAP_PROT_READ | MMAP_PROT_WRITE)
+        != 0) {
+        wasm_munmap_linear_memory(slot, commit_size, 8 * (uint64)BH_GB);
+        return NULL;
+    }
+    return slot;
+}
+
+/* Return the pages of the memory to the system and keep its reservation,
+   return false if it should be unmapped instead */
+static bool
+release_memory_slot(void *slot, uint64 commit_size)
+{
+    bool ret = false;
+
+#ifdef BH_PLATFORM_WINDOWS
+    os_mem_decommit(slot, commit_size);
+#else
+    if (os_mem_discard(slot, commit_size) != 0
+        || os_mprotect(slot, commit_size, MMAP_PROT_NONE) != 0)
+        return false;
+#endif
+
+    os_mutex_lock(&memory_slot_lock);
+    if (memory_slot_count < WASM_MEM_SLOT_CACHE_SIZE) {
+        memory_slots[memory_slot_count++] = slot;
+        ret = true;
+    }
+    os_mutex_unlock(&memory_slot_lock);
+    return ret;
+}
+#endif /* end of WASM_MEM_SLOT_CACHE_ENABLED != 0 */
+
 static void *
 wasm_mmap_linear_memory(uint64_t map_size, uint64 commit_size)
 {
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+    void *slot;
+
+    bh_assert(map_size == 8 * (uint64)BH_GB);
+    if ((slot = acquire_memory_slot(commit_size)))
+        return slot;
+#endif
     return wasm_mremap_linear_memory(NULL, 0, map_size, commit_size);
 }
 
-bool
-wasm_enlarge_memory_internal(WASMModuleInstance *module, uint32 inc_page_count)
+static bool
+wasm_enlarge_memory_internal(WASMModuleInstance *module, uint32 inc_page_count,
+                             uint32 memidx)
 {
-    WASMMemoryInstance *memory = wasm_get_default_memory(module);
+    WASMMemoryInstance *memory =
+        memidx < module->memory_count ? module->memories[memidx] : NULL;
     uint8 *memory_data_old, *memory_data_new, *heap_data_old;
     uint32 num_bytes_per_page, heap_size;
     uint32 cur_page_count, max_page_count, total_page_count;
@@ -878,7 +1115,8 @@ wasm_enlarge_memory_internal(WASMModuleInstance *module, uint32 inc_page_count)
         memory->memory_data = memory_data_new;
 #if defined(os_writegsbase)
         /* write base addr of linear memory to GS segment register */
-        os_writegsbase(memory_data_new);
+        if (memidx == 0)
+            os_writegsbase(memory_data_new);
 #endif
     }
 #endif /* end of WASM_MEM_ALLOC_WITH_USAGE */
@@ -943,6 +1181,431 @@ wasm_runtime_enlarge_memory(WASMModuleInstanceCommon *module_inst,
     return false;
 }
 
+/* Zero the pages [offset, offset + size) of the memory and return them
+   to the system, offset and size are aligned to the system page size */
+static bool
+discard_memory_pages(WASMMemoryInstance *memory, uint64 offset, uint64 size)
+{
+    uint8 *addr = memory->memory_data + offset;
+
+    if (size == 0)
+        return true;
+
+#if WASM_MEM_ALLOC_WITH_USAGE != 0
+    /* The memory is allocated by the embedder, just clear it */
+    memset(addr, 0, (size_t)size);
+    return true;
+#else
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* Discarding the pages mapped from a file restores the content of
+       the file, replace them with new zero-filled pages instead */
+    if (memory->is_data_image_mapped)
+        return os_mem_map_file(addr, (size_t)size, os_get_invalid_handle(),
+                               0, false)
+               == 0;
+#endif
+    return os_mem_discard(addr, (size_t)size) == 0;
+#endif
+}
+
+bool
+wasm_runtime_discard_memory(WASMModuleInstanceCommon *module_inst,
+                            uint64 app_offset, uint64 size)
+{
+    WASMMemoryInstance *memory_inst;
+    uint64 page_size = os_getpagesize(), start, end;
+    bool ret = false;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode
+              || module_inst->module_type == Wasm_Module_AoT);
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    if (!memory_inst) {
+        wasm_runtime_set_exception(module_inst, "out of bounds memory access");
+        return false;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+
+    if (size > memory_inst->memory_data_size
+        || app_offset > memory_inst->memory_data_size - size) {
+        wasm_runtime_set_exception(module_inst, "out of bounds memory access");
+        goto unlock;
+    }
+
+    /* Clear the partial pages at both ends and release the whole pages
+       between them */
+    start = align_as_and_cast(app_offset, page_size);
+    end = (app_offset + size) & ~(page_size - 1);
+    if (start >= end) {
+        memset(memory_inst->memory_data + app_offset, 0, (size_t)size);
+        ret = true;
+        goto unlock;
+    }
+
+    memset(memory_inst->memory_data + app_offset, 0,
+           (size_t)(start - app_offset));
+    memset(memory_inst->memory_data + end, 0,
+           (size_t)(app_offset + size - end));
+    if (!discard_memory_pages(memory_inst, start, end - start)) {
+        wasm_runtime_set_exception(module_inst, "discard memory failed");
+        goto unlock;
+    }
+    ret = true;
+
+unlock:
+    SHARED_MEMORY_UNLOCK(memory_inst);
+    return ret;
+}
+
+bool
+wasm_runtime_shrink_memory(WASMModuleInstanceCommon *module_inst,
+                           uint64 page_count)
+{
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+    WASMMemoryInstance *memory_inst;
+    uint64 memory_data_size, shrunk_size;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode
+              || module_inst->module_type == Wasm_Module_AoT);
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    /* The other threads may access the shared memory with its old size */
+    if (!memory_inst || memory_inst->is_shared_memory
+        || page_count > memory_inst->cur_page_count) {
+        wasm_runtime_set_exception(module_inst, "shrink memory failed");
+        return false;
+    }
+
+    memory_data_size = align_as_and_cast(
+        (uint64)memory_inst->num_bytes_per_page * page_count,
+        os_getpagesize());
+
+    /* The app heap inserted by the runtime must be kept */
+    if (memory_inst->heap_data_end > memory_inst->heap_data
+        && (uint64)(memory_inst->heap_data_end - memory_inst->memory_data)
+               > memory_data_size) {
+        wasm_runtime_set_exception(module_inst,
+                                   "shrink memory failed: app heap is in "
+                                   "the pages to release");
+        return false;
+    }
+
+    /* Release the trailing pages and make them inaccessible again, the
+       memory is reserved so that it doesn't move */
+    if (memory_inst->memory_data_size > memory_data_size) {
+        shrunk_size = memory_inst->memory_data_size - memory_data_size;
+        if (!discard_memory_pages(memory_inst, memory_data_size, shrunk_size)
+            || os_mprotect(memory_inst->memory_data + memory_data_size,
+                           (size_t)shrunk_size, MMAP_PROT_NONE)
+                   != 0) {
+            wasm_runtime_set_exception(module_inst, "shrink memory failed");
+            return false;
+        }
+#ifdef BH_PLATFORM_WINDOWS
+        os_mem_decommit(memory_inst->memory_data + memory_data_size,
+                        shrunk_size);
+#endif
+    }
+
+    memory_inst->cur_page_count = (uint32)page_count;
+    SET_LINEAR_MEMORY_SIZE(memory_inst, memory_data_size);
+    memory_inst->memory_data_end =
+        memory_inst->memory_data + memory_data_size;
+    wasm_runtime_set_mem_bound_check_bytes(memory_inst, memory_data_size);
+    return true;
+#else
+    (void)page_count;
+    /* The memory isn't reserved, it may move when it is shrunk */
+    wasm_runtime_set_exception(module_inst,
+                               "shrink memory isn't supported");
+    return false;
+#endif
+}
+
+/* Map the file, or zero-filled pages if file is os_get_invalid_handle(),
+   to the window [app_offset, app_offset + size) of the default memory */
+static bool
+map_memory_window(WASMModuleInstanceCommon *module_inst, uint64 app_offset,
+                  uint64 size, os_file_handle file, uint64 file_offset,
+                  bool is_shared)
+{
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    WASMMemoryInstance *memory_inst;
+    uint64 page_size = os_getpagesize();
+    bool ret = false;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode
+              || module_inst->module_type == Wasm_Module_AoT);
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    if (!memory_inst || size == 0 || ((app_offset | size) & (page_size - 1))) {
+        wasm_runtime_set_exception(module_inst,
+                                   "invalid host buffer mapping window");
+        return false;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    /* The window is within the linear memory, which doesn't move when it
+       is grown with the hardware bound check */
+    if (size <= memory_inst->memory_data_size
+        && app_offset <= memory_inst->memory_data_size - size) {
+        if (os_mem_map_file(memory_inst->memory_data + app_offset,
+                            (size_t)size, file, file_offset, is_shared)
+            == 0) {
+            /* The pages of the memory can't be discarded to zero any more,
+               so the memory isn't reset or reused by other instances */
+            memory_inst->is_data_image_mapped = true;
+            ret = true;
+        }
+        else {
+            wasm_runtime_set_exception(module_inst,
+                                       "map host buffer failed");
+        }
+    }
+    else {
+        wasm_runtime_set_exception(module_inst, "out of bounds memory access");
+    }
+    SHARED_MEMORY_UNLOCK(memory_inst);
+    return ret;
+#else
+    (void)app_offset;
+    (void)size;
+    (void)file;
+    (void)file_offset;
+    (void)is_shared;
+    /* The linear memory isn't reserved with the page mappings */
+    wasm_runtime_set_exception(module_inst,
+                               "map host buffer isn't supported");
+    return false;
+#endif
+}
+
+bool
+wasm_runtime_map_host_buffer(WASMModuleInstanceCommon *module_inst,
+                             uint64 app_offset, uint64 size, int64 fd,
+                             uint64 fd_offset, bool share_writes)
+{
+    if ((os_file_handle)(intptr_t)fd == os_get_invalid_handle()) {
+        wasm_runtime_set_exception(module_inst, "invalid host buffer");
+        return false;
+    }
+
+    return map_memory_window(module_inst, app_offset, size,
+                             (os_file_handle)(intptr_t)fd, fd_offset,
+                             share_writes);
+}
+
+bool
+wasm_runtime_unmap_host_buffer(WASMModuleInstanceCommon *module_inst,
+                               uint64 app_offset, uint64 size)
+{
+    return map_memory_window(module_inst, app_offset, size,
+                             os_get_invalid_handle(), 0, false);
+}
+
+#if WASM_ENABLE_SHARED_HEAP != 0
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL) {
+        snprintf(error_buf, error_buf_size,
+                 "Create shared heap failed: %s", string);
+    }
+}
+
+WASMSharedHeap *
+wasm_runtime_create_shared_heap(uint64 size, char *error_buf,
+                                uint32 error_buf_size)
+{
+    WASMSharedHeap *heap;
+    uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
+    uint64 page_size = os_getpagesize();
+
+    size = align_as_and_cast(size, page_size);
+    if (size < APP_HEAP_SIZE_MIN || size > APP_HEAP_SIZE_MAX) {
+        set_error_buf(error_buf, error_buf_size, "invalid heap size");
+        return NULL;
+    }
+
+    if (!(heap = wasm_runtime_malloc(sizeof(WASMSharedHeap)
+                                     + heap_struct_size))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+    memset(heap, 0, sizeof(WASMSharedHeap));
+    heap->size = size;
+
+    heap->file = os_mem_image_create("wasm-shared-heap", (size_t)size);
+    if (heap->file == os_get_invalid_handle()) {
+        set_error_buf(error_buf, error_buf_size, "create memory file failed");
+        goto fail1;
+    }
+
+    /* Reserve the range and map the file shared, so that the writes of
+       the host and the instances are visible to each other */
+    if (!(heap->base_addr = os_mmap(NULL, (size_t)size, MMAP_PROT_NONE,
+                                    MMAP_MAP_NONE, os_get_invalid_handle()))) {
+        set_error_buf(error_buf, error_buf_size, "mmap memory failed");
+        goto fail2;
+    }
+    if (os_mem_map_file(heap->base_addr, (size_t)size, heap->file, 0, true)
+        != 0) {
+        set_error_buf(error_buf, error_buf_size, "map memory file failed");
+        goto fail3;
+    }
+
+    if (!(heap->heap_handle = mem_allocator_create_with_struct_and_pool(
+              (uint8 *)heap + sizeof(WASMSharedHeap), heap_struct_size,
+              heap->base_addr, (uint32)size))) {
+        set_error_buf(error_buf, error_buf_size, "init heap failed");
+        goto fail3;
+    }
+
+    return heap;
+
+fail3:
+    os_munmap(heap->base_addr, (size_t)size);
+fail2:
+    os_mem_image_destroy(heap->file);
+fail1:
+    wasm_runtime_free(heap);
+    return NULL;
+}
+
+void
+wasm_runtime_destroy_shared_heap(WASMSharedHeap *heap)
+{
+    /* The instances must be detached or destroyed before */
+    bh_assert(heap->attach_count == 0);
+
+    mem_allocator_destroy(heap->heap_handle);
+    os_munmap(heap->base_addr, (size_t)heap->size);
+    os_mem_image_destroy(heap->file);
+    wasm_runtime_free(heap);
+}
+
+uint64
+wasm_runtime_shared_heap_malloc(WASMSharedHeap *heap, uint64 size,
+                                void **p_native_addr)
+{
+    uint8 *addr;
+
+    if (size > UINT32_MAX
+        || !(addr = mem_allocator_malloc(heap->heap_handle, (uint32)size)))
+        return 0;
+
+    if (p_native_addr)
+        *p_native_addr = addr;
+    return SHARED_HEAP_START_OFFSET(heap) + (uint64)(addr - heap->base_addr);
+}
+
+void
+wasm_runtime_shared_heap_free(WASMSharedHeap *heap, uint64 app_offset)
+{
+    if (app_offset >= SHARED_HEAP_START_OFFSET(heap)
+        && app_offset < SHARED_HEAP_END_OFFSET) {
+        mem_allocator_free(heap->heap_handle,
+                           heap->base_addr + app_offset
+                               - SHARED_HEAP_START_OFFSET(heap));
+    }
+}
+
+bool
+wasm_runtime_attach_shared_heap(WASMModuleInstanceCommon *module_inst,
+                                WASMSharedHeap *heap, bool read_only)
+{
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMMemoryInstance *memory_inst;
+    uint64 start_offset = SHARED_HEAP_START_OFFSET(heap);
+    uint32 max_page_count;
+    bool ret = false;
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    if (!memory_inst || memory_inst->is_memory64
+        || memory_inst->is_shared_memory) {
+        wasm_runtime_set_exception(module_inst,
+                                   "shared heap requires a non-shared "
+                                   "32-bit memory");
+        return false;
+    }
+    if (common->shared_heap) {
+        wasm_runtime_set_exception(module_inst,
+                                   "shared heap is already attached");
+        return false;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    /* The memory can't grow into the heap any more */
+    if (memory_inst->memory_data_size > start_offset) {
+        wasm_runtime_set_exception(module_inst,
+                                   "memory overlaps the shared heap");
+        goto unlock;
+    }
+    if (os_mem_map_file(memory_inst->memory_data + start_offset,
+                        (size_t)heap->size, heap->file, 0, true)
+            != 0
+        || (read_only
+            && os_mprotect(memory_inst->memory_data + start_offset,
+                           (size_t)heap->size, MMAP_PROT_READ)
+                   != 0)) {
+        wasm_runtime_set_exception(module_inst, "map shared heap failed");
+        goto unlock;
+    }
+    memory_inst->is_shared_heap_attached = true;
+
+    common->max_page_count_unclamped = memory_inst->max_page_count;
+    if (memory_inst->num_bytes_per_page > 0) {
+        max_page_count =
+            (uint32)(start_offset / memory_inst->num_bytes_per_page);
+        if (memory_inst->max_page_count > max_page_count)
+            memory_inst->max_page_count = max_page_count;
+    }
+    common->shared_heap = heap;
+    ret = true;
+
+unlock:
+    SHARED_MEMORY_UNLOCK(memory_inst);
+
+    if (ret) {
+        os_mutex_lock(&shared_heap_lock);
+        heap->attach_count++;
+        os_mutex_unlock(&shared_heap_lock);
+    }
+    return ret;
+}
+
+void
+wasm_runtime_detach_shared_heap(WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMSharedHeap *heap = common->shared_heap;
+    WASMMemoryInstance *memory_inst;
+    uint8 *addr;
+
+    if (!heap)
+        return;
+
+    memory_inst = wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    bh_assert(memory_inst);
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    /* Drop the pages of the heap and make the range inaccessible again */
+    addr = memory_inst->memory_data + SHARED_HEAP_START_OFFSET(heap);
+    os_mem_map_file(addr, (size_t)heap->size, os_get_invalid_handle(), 0,
+                    false);
+    os_mprotect(addr, (size_t)heap->size, MMAP_PROT_NONE);
+    memory_inst->max_page_count = common->max_page_count_unclamped;
+    memory_inst->is_shared_heap_attached = false;
+    common->shared_heap = NULL;
+    SHARED_MEMORY_UNLOCK(memory_inst);
+
+    os_mutex_lock(&shared_heap_lock);
+    heap->attach_count--;
+    os_mutex_unlock(&shared_heap_lock);
+}
+#endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
+
 void
 wasm_runtime_set_enlarge_mem_error_callback(
     const enlarge_memory_error_callback_t callback, void *user_data)
@@ -953,22 +1616,102 @@ wasm_runtime_set_enlarge_mem_error_callback(
 
 bool
 wasm_enlarge_memory(WASMModuleInstance *module, uint32 inc_page_count)
+{
+    return wasm_enlarge_memory_with_idx(module, inc_page_count, 0);
+}
+
+bool
+wasm_enlarge_memory_with_idx(WASMModuleInstance *module, uint32 inc_page_count,
+                             uint32 memidx)
 {
     bool ret = false;
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
-    if (module->memory_count > 0)
-        shared_memory_lock(module->memories[0]);
+    if (memidx < module->memory_count)
+        shared_memory_lock(module->memories[memidx]);
 #endif
-    ret = wasm_enlarge_memory_internal(module, inc_page_count);
+    ret = wasm_enlarge_memory_internal(module, inc_page_count, memidx);
 #if WASM_ENABLE_SHARED_MEMORY != 0
-    if (module->memory_count > 0)
-        shared_memory_unlock(module->memories[0]);
+    if (memidx < module->memory_count)
+        shared_memory_unlock(module->memories[memidx]);
 #endif
 
     return ret;
 }
 
+bool
+wasm_reset_linear_memory(WASMMemoryInstance *memory, uint32 page_count)
+{
+    uint32 heap_size = (uint32)(memory->heap_data_end - memory->heap_data);
+    uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
+    uint64 memory_data_size;
+
+    /* Discarding the pages mapped from the data image restores the
+       image rather than zero-fills them, and the pages of an attached
+       shared heap must be kept */
+    if (page_count > memory->cur_page_count || memory->is_data_image_mapped
+        || memory->is_shared_heap_attached
+#if WASM_ENABLE_SHARED_MEMORY != 0
+        || shared_memory_is_shared(memory)
+#endif
+    )
+        return false;
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+    memory_data_size =
+        align_as_and_cast((uint64)memory->num_bytes_per_page * page_count,
+                          os_getpagesize());
+#else
+    /* The memory isn't reserved, it can't be shrunk */
+    if (page_count != memory->cur_page_count)
+        return false;
+    memory_data_size = memory->memory_data_size;
+#endif
+
+    /* The heap is placed in the remaining pages */
+    if (heap_size > 0
+        && (uint64)(memory->heap_data_end - memory->memory_data)
+               > memory_data_size)
+        return false;
+
+    if (heap_size > 0)
+        mem_allocator_destroy(memory->heap_handle);
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+    /* Return the dirty pages to the system rather than clearing them,
+       and make the pages grown after instantiation inaccessible again */
+    if (os_mem_discard(memory->memory_data, memory_data_size) != 0)
+        return false;
+    if (memory->memory_data_size > memory_data_size) {
+        uint64 shrunk_size = memory->memory_data_size - memory_data_size;
+
+        os_mem_discard(memory->memory_data + memory_data_size, shrunk_size);
+        if (os_mprotect(memory->memory_data + memory_data_size, shrunk_size,
+                        MMAP_PROT_NONE)
+            != 0)
+            return false;
+#ifdef BH_PLATFORM_WINDOWS
+        os_mem_decommit(memory->memory_data + memory_data_size, shrunk_size);
+#endif
+    }
+#else
+    memset(memory->memory_data, 0, memory_data_size);
+#endif
+
+    memory->cur_page_count = page_count;
+    SET_LINEAR_MEMORY_SIZE(memory, memory_data_size);
+    memory->memory_data_end = memory->memory_data + memory_data_size;
+    wasm_runtime_set_mem_bound_check_bytes(memory, memory_data_size);
+
+    if (heap_size > 0
+        && !mem_allocator_create_with_struct_and_pool(
+            memory->heap_handle, heap_struct_size, memory->heap_data,
+            heap_size))
+        return false;
+
+    return true;
+}
+
 void
 wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 {
@@ -1001,8 +1744,16 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 #endif
               memory_inst->memory_data);
 #else
-    wasm_munmap_linear_memory(memory_inst->memory_data,
-                              memory_inst->memory_data_size, map_size);
+#if WASM_MEM_SLOT_CACHE_ENABLED != 0
+    /* The pages mapped from the data image or a shared heap can't be
+       discarded */
+    if (memory_inst->is_data_image_mapped
+        || memory_inst->is_shared_heap_attached
+        || !release_memory_slot(memory_inst->memory_data,
+                                memory_inst->memory_data_size))
+#endif
+        wasm_munmap_linear_memory(memory_inst->memory_data,
+                                  memory_inst->memory_data_size, map_size);
 #endif
 
     memory_inst->memory_data = NULL;
@@ -1034,7 +1785,8 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
     /* Totally 8G is mapped, the opcode load/store address range is 0 to 8G:
      *   ea = i + memarg.offset
      * both i and memarg.offset are u32 in range 0 to 4G
-     * so the range of ea is 0 to 8G
+     * so the range of ea is 0 to 8G, and the ea of memory64 is clamped to
+     * the last page of it, see MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE
      */
     map_size = 8 * (uint64)BH_GB;
 #endif /* end of OS_ENABLE_HW_BOUND_CHECK */
@@ -1070,3 +1822,58 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
 
     return BHT_OK;
 }
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+WASMDataImage *
+wasm_data_image_create(uint64 size)
+{
+    WASMDataImage *image;
+    uint64 page_size = os_getpagesize();
+
+    size = align_as_and_cast(size, page_size);
+    if (size == 0)
+        return NULL;
+
+    if (!(image = wasm_runtime_malloc(sizeof(WASMDataImage))))
+        return NULL;
+
+    image->file = os_mem_image_create("wasm-data", (size_t)size);
+    if (image->file == os_get_invalid_handle()) {
+        wasm_runtime_free(image);
+        return NULL;
+    }
+    image->size = size;
+    return image;
+}
+
+bool
+wasm_data_image_write(WASMDataImage *image, uint64 offset, const uint8 *data,
+                      uint32 length)
+{
+    if (offset + length > image->size)
+        return false;
+
+    return os_mem_image_write(image->file, (size_t)offset, data, length) == 0;
+}
+
+void
+wasm_data_image_destroy(WASMDataImage *image)
+{
+    os_mem_image_destroy(image->file);
+    wasm_runtime_free(image);
+}
+
+bool
+wasm_data_image_map(const WASMDataImage *image, uint8 *memory_data,
+                    uint64 memory_data_size)
+{
+    if (image->size > memory_data_size)
+        return false;
+
+    /* The pages are shared by the instances until they are written */
+    return os_mmap(memory_data, (size_t)image->size,
+                   MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_FIXED,
+                   image->file)
+           == memory_data;
+}
+#endif /* end of WASM_MEM_DATA_IMAGE_SUPPORTED != 0 */
@@ -48,6 +48,13 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
 void
 wasm_runtime_memory_destroy();
 
+/**
+ * Return the blocks cached by the current thread to the global pool,
+ * it is called before the thread exits.
+ */
+void
+wasm_runtime_memory_flush_thread_cache();
+
 unsigned
 wasm_runtime_memory_pool_size();
 
@@ -62,12 +69,59 @@ wasm_runtime_set_enlarge_mem_error_callback(
 void
 wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst);
 
+/**
+ * Reset the linear memory to page_count pages filled with zero and
+ * re-create the app heap in it, the dirty pages are returned to the
+ * system when the memory is reserved (OS_ENABLE_HW_BOUND_CHECK).
+ * Return false if the memory can't be reset, e.g. it is shared, it is
+ * mapped from the data image of the module or it can't be shrunk to
+ * page_count pages.
+ */
+bool
+wasm_reset_linear_memory(WASMMemoryInstance *memory, uint32 page_count);
+
+/**
+ * Check whether the app address range is in the shared heap attached to
+ * the module instance, which is mapped above its default memory. It is
+ * called on the slow path of the explicit bounds checks, including the
+ * ones emitted by the AOT/JIT compiler.
+ */
+bool
+wasm_runtime_is_app_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
+                                        uint64 app_offset, uint64 bytes);
+
 int
 wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
                             bool is_memory64, uint64 num_bytes_per_page,
                             uint64 init_page_count, uint64 max_page_count,
                             uint64 *memory_data_size);
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+/**
+ * Create the image of the initial content of a linear memory, the size is
+ * aligned to the system page size and the content reads as zero until it
+ * is written. Return NULL if the platform doesn't support it.
+ */
+WASMDataImage *
+wasm_data_image_create(uint64 size);
+
+bool
+wasm_data_image_write(WASMDataImage *image, uint64 offset, const uint8 *data,
+                      uint32 length);
+
+void
+wasm_data_image_destroy(WASMDataImage *image);
+
+/**
+ * Map the image to the beginning of the linear memory copy-on-write, the
+ * memory must be reserved by wasm_allocate_linear_memory and the image must
+ * fit in it.
+ */
+bool
+wasm_data_image_map(const WASMDataImage *image, uint8 *memory_data,
+                    uint64 memory_data_size);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -166,11 +166,12 @@ static JitCompOptions jit_options = { 0 };
 #if WASM_ENABLE_JIT != 0
 /* opt_level: 3, size_level: 3, segue-flags: 0,
    quick_invoke_c_api_import: false */
-static LLVMJITOptions llvm_jit_options = { 3, 3, 0, false };
+static LLVMJITOptions llvm_jit_options = { 3, 3, 0, false, NULL };
 #endif
 
 #if WASM_ENABLE_GC != 0
 static uint32 gc_heap_size_default = GC_HEAP_SIZE_DEFAULT;
+static uint32 gc_heap_max_size_default = 0;
 #endif
 
 static RunningMode runtime_running_mode = Mode_Default;
@@ -181,43 +182,65 @@ static RunningMode runtime_running_mode = Mode_Default;
    of signal handler */
 static os_thread_local_attribute WASMExecEnv *exec_env_tls = NULL;
 
+/* Check whether the address is inside the reserved regions (including
+   the guard regions) of the linear memories of the module instance */
+static bool
+is_addr_in_linear_memories(WASMModuleInstance *module_inst, uint8 *addr)
+{
+    WASMMemoryInstance *memory_inst;
+    uint32 i;
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        memory_inst = module_inst->memories[i];
+        if (memory_inst->memory_data <= addr
+            && addr < memory_inst->memory_data + 8 * (uint64)BH_GB)
+            return true;
+    }
+    return false;
+}
+
 #ifndef BH_PLATFORM_WINDOWS
-static void
+static bool
 runtime_signal_handler(void *sig_addr)
 {
     WASMModuleInstance *module_inst;
-    WASMMemoryInstance *memory_inst;
     WASMJmpBuf *jmpbuf_node;
-    uint8 *mapped_mem_start_addr = NULL;
-    uint8 *mapped_mem_end_addr = NULL;
     uint32 page_size = os_getpagesize();
 #if WASM_DISABLE_STACK_HW_BOUND_CHECK == 0
     uint8 *stack_min_addr;
     uint32 guard_page_count = STACK_OVERFLOW_CHECK_GUARD_PAGE_COUNT;
 #endif
 
+#if WASM_ENABLE_AOT != 0 && AOT_LAZY_TEXT_SUPPORTED != 0
+    char error_buf[128];
+
+    /* The address may be a not yet materialized page of lazy AOT text,
+       which can be touched by any thread calling into the AOT code */
+    if (aot_lazy_text_handle_fault(sig_addr, error_buf, sizeof(error_buf)))
+        return true;
+#endif
+
     /* Check whether current thread is running wasm function */
     if (exec_env_tls && exec_env_tls->handle == os_self_thread()
         && (jmpbuf_node = exec_env_tls->jmpbuf_stack_top)) {
-        /* Get mapped mem info of current instance */
         module_inst = (WASMModuleInstance *)exec_env_tls->module_inst;
-        /* Get the default memory instance */
-        memory_inst = wasm_get_default_memory(module_inst);
-        if (memory_inst) {
-            mapped_mem_start_addr = memory_inst->memory_data;
-            mapped_mem_end_addr = memory_inst->memory_data + 8 * (uint64)BH_GB;
-        }
 
 #if WASM_DISABLE_STACK_HW_BOUND_CHECK == 0
         /* Get stack info of current thread */
         stack_min_addr = os_thread_get_stack_boundary();
 #endif
 
-        if (memory_inst
-            && (mapped_mem_start_addr <= (uint8 *)sig_addr
-                && (uint8 *)sig_addr < mapped_mem_end_addr)) {
+#if WASM_ENABLE_AOT != 0 && AOT_LAZY_TEXT_SUPPORTED != 0
+        if (error_buf[0] != '\0') {
+            /* The lazy AOT text page can't be materialized */
+            wasm_set_exception(module_inst, error_buf);
+            os_longjmp(jmpbuf_node->jmpbuf, 1);
+        }
+#endif
+
+        if (is_addr_in_linear_memories(module_inst, (uint8 *)sig_addr)) {
             /* The address which causes segmentation fault is inside
-               the memory instance's guard regions */
+               the memory instances' guard regions */
             wasm_set_exception(module_inst, "out of bounds memory access");
             os_longjmp(jmpbuf_node->jmpbuf, 1);
         }
@@ -238,6 +261,8 @@ runtime_signal_handler(void *sig_addr)
             os_longjmp(jmpbuf_node->jmpbuf, 1);
         }
     }
+
+    return false;
 }
 #else /* else of BH_PLATFORM_WINDOWS */
 
@@ -329,10 +354,7 @@ runtime_exception_handler(EXCEPTION_POINTERS *exce_info)
     PEXCEPTION_RECORD ExceptionRecord = exce_info->ExceptionRecord;
     uint8 *sig_addr = (uint8 *)ExceptionRecord->ExceptionInformation[1];
     WASMModuleInstance *module_inst;
-    WASMMemoryInstance *memory_inst;
     WASMJmpBuf *jmpbuf_node;
-    uint8 *mapped_mem_start_addr = NULL;
-    uint8 *mapped_mem_end_addr = NULL;
     uint32 page_size = os_getpagesize();
     LONG ret;
 
@@ -340,18 +362,9 @@ runtime_exception_handler(EXCEPTION_POINTERS *exce_info)
         && (jmpbuf_node = exec_env_tls->jmpbuf_stack_top)) {
         module_inst = (WASMModuleInstance *)exec_env_tls->module_inst;
         if (ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION) {
-            /* Get the default memory instance */
-            memory_inst = wasm_get_default_memory(module_inst);
-            if (memory_inst) {
-                mapped_mem_start_addr = memory_inst->memory_data;
-                mapped_mem_end_addr =
-                    memory_inst->memory_data + 8 * (uint64)BH_GB;
-            }
-
-            if (memory_inst && mapped_mem_start_addr <= (uint8 *)sig_addr
-                && (uint8 *)sig_addr < mapped_mem_end_addr) {
+            if (is_addr_in_linear_memories(module_inst, sig_addr)) {
                 /* The address which causes segmentation fault is inside
-                   the memory instance's guard regions.
+                   the memory instances' guard regions.
                    Set exception and let the wasm func continue to run, when
                    the wasm func returns, the caller will check whether the
                    exception is thrown and return to runtime. */
@@ -719,6 +732,12 @@ wasm_runtime_get_gc_heap_size_default(void)
 {
     return gc_heap_size_default;
 }
+
+uint32
+wasm_runtime_get_gc_heap_max_size_default(void)
+{
+    return gc_heap_max_size_default;
+}
 #endif
 
 static bool
@@ -739,12 +758,14 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 
 #if WASM_ENABLE_GC != 0
     gc_heap_size_default = init_args->gc_heap_size;
+    gc_heap_max_size_default = init_args->gc_heap_max_size;
 #endif
 
 #if WASM_ENABLE_JIT != 0
     llvm_jit_options.size_level = init_args->llvm_jit_size_level;
     llvm_jit_options.opt_level = init_args->llvm_jit_opt_level;
     llvm_jit_options.segue_flags = init_args->segue_flags;
+    llvm_jit_options.cache_dir = init_args->llvm_jit_cache_dir;
 #endif
 
 #if WASM_ENABLE_LINUX_PERF != 0
@@ -1713,6 +1734,8 @@ wasm_runtime_init_thread_env(void)
 void
 wasm_runtime_destroy_thread_env(void)
 {
+    wasm_runtime_memory_flush_thread_cache();
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     runtime_signal_destroy();
 #endif
@@ -3051,6 +3074,14 @@ wasm_runtime_clear_exception(WASMModuleInstanceCommon *module_inst_comm)
     bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
               || module_inst_comm->module_type == Wasm_Module_AoT);
     wasm_runtime_set_exception(module_inst_comm, NULL);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* cur_exec_env may have been destroyed, only the exec_env owned by
+       the instance is reset here, the others are reset when the call
+       returns to the host */
+    if (((WASMModuleInstance *)module_inst_comm)->exec_env_singleton)
+        wasm_runtime_clear_wasm_exception(
+            ((WASMModuleInstance *)module_inst_comm)->exec_env_singleton);
+#endif
 }
 
 void
@@ -3944,6 +3975,40 @@ wasm_runtime_destroy_wasi(WASMModuleInstanceCommon *module_inst)
 }
 #endif
 
+bool
+wasm_runtime_reset_wasi(WASMModuleInstanceCommon *module_inst,
+                        char *error_buf, uint32 error_buf_size)
+{
+    WASIArguments *wasi_args =
+        get_wasi_args_from_module(wasm_runtime_get_module(module_inst));
+
+    wasm_runtime_destroy_wasi(module_inst);
+    wasm_runtime_set_wasi_ctx(module_inst, NULL);
+
+    return wasm_runtime_init_wasi(
+        module_inst, wasi_args->dir_list, wasi_args->dir_count,
+        wasi_args->map_dir_list, wasi_args->map_dir_count, wasi_args->env,
+        wasi_args->env_count, wasi_args->addr_pool, wasi_args->addr_count,
+        wasi_args->ns_lookup_pool, wasi_args->ns_lookup_count, wasi_args->argv,
+        wasi_args->argc, wasi_args->stdio[0], wasi_args->stdio[1],
+        wasi_args->stdio[2], error_buf, error_buf_size);
+}
+
+bool
+wasm_runtime_wasi_has_only_preopens(WASMModuleInstanceCommon *module_inst)
+{
+    WASIContext *wasi_ctx = wasm_runtime_get_wasi_ctx(module_inst);
+
+    if (!wasi_ctx)
+        return true;
+#if WASM_ENABLE_UVWASI == 0
+    return fd_table_has_only_preopens(wasi_ctx->curfds, wasi_ctx->prestats);
+#else
+    /* The fd table of uvwasi isn't inspected */
+    return false;
+#endif
+}
+
 uint32_t
 wasm_runtime_get_wasi_exit_code(WASMModuleInstanceCommon *module_inst)
 {
@@ -7071,6 +7136,70 @@ fail:
     return ret;
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+void
+wasm_runtime_throw_wasm_exception(WASMExecEnv *exec_env, uint32 tag_index,
+                                  const uint32 *payload,
+                                  uint32 payload_cell_num)
+{
+    WASMModuleInstance *module_inst =
+        (WASMModuleInstance *)exec_env->module_inst;
+    uint32 *payload_buf;
+
+    if (payload_cell_num > exec_env->exce_payload_buf_cell_num) {
+        if (!(payload_buf = wasm_runtime_malloc(sizeof(uint32)
+                                                * payload_cell_num))) {
+            wasm_set_exception_with_id(module_inst, EXCE_OUT_OF_MEMORY);
+            return;
+        }
+        if (exec_env->exce_payload)
+            wasm_runtime_free(exec_env->exce_payload);
+        exec_env->exce_payload = payload_buf;
+        exec_env->exce_payload_buf_cell_num = payload_cell_num;
+    }
+
+    if (payload_cell_num > 0)
+        bh_memcpy_s(exec_env->exce_payload,
+                    sizeof(uint32) * exec_env->exce_payload_buf_cell_num,
+                    payload, sizeof(uint32) * payload_cell_num);
+    exec_env->exce_tag_index = tag_index;
+    exec_env->exce_payload_cell_num = payload_cell_num;
+
+    /* Don't spread the exception to other threads of the cluster like
+       traps, it may be caught by the caller */
+    wasm_set_exception_local(module_inst, "uncaught wasm exception");
+    exec_env->exce_thrown = true;
+}
+
+int32
+wasm_runtime_catch_wasm_exception(WASMExecEnv *exec_env, uint32 *payload,
+                                  uint32 payload_cell_num)
+{
+    WASMModuleInstance *module_inst =
+        (WASMModuleInstance *)exec_env->module_inst;
+
+    /* A trap, which can't be caught by wasm code */
+    if (!exec_env->exce_thrown || !wasm_copy_exception(module_inst, NULL))
+        return -1;
+
+    if (payload_cell_num > exec_env->exce_payload_cell_num)
+        payload_cell_num = exec_env->exce_payload_cell_num;
+    if (payload_cell_num > 0)
+        bh_memcpy_s(payload, sizeof(uint32) * payload_cell_num,
+                    exec_env->exce_payload, sizeof(uint32) * payload_cell_num);
+
+    exec_env->exce_thrown = false;
+    wasm_set_exception_local(module_inst, NULL);
+    return (int32)exec_env->exce_tag_index;
+}
+
+void
+wasm_runtime_clear_wasm_exception(WASMExecEnv *exec_env)
+{
+    exec_env->exce_thrown = false;
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 void
 wasm_runtime_show_app_heap_corrupted_prompt()
 {
@@ -483,6 +483,7 @@ typedef struct LLVMJITOptions {
     uint32 size_level;
     uint32 segue_flags;
     bool quick_invoke_c_api_import;
+    const char *cache_dir;
 } LLVMJITOptions;
 #endif
 
@@ -524,6 +525,9 @@ wasm_runtime_get_llvm_jit_options(void);
 /* Internal API */
 uint32
 wasm_runtime_get_gc_heap_size_default(void);
+
+uint32
+wasm_runtime_get_gc_heap_max_size_default(void);
 #endif
 
 /* See wasm_export.h for description */
@@ -578,6 +582,10 @@ wasm_runtime_instantiate_internal(WASMModuleCommon *module,
                                   char *error_buf, uint32 error_buf_size);
 
 /* Internal API */
+/* Destroy the clone image created when the instance is cloned */
+void
+wasm_runtime_destroy_clone_image(WASMModuleInstanceCommon *module_inst);
+
 void
 wasm_runtime_deinstantiate_internal(WASMModuleInstanceCommon *module_inst,
                                     bool is_sub_inst);
@@ -968,6 +976,17 @@ wasm_runtime_init_wasi(WASMModuleInstanceCommon *module_inst,
 void
 wasm_runtime_destroy_wasi(WASMModuleInstanceCommon *module_inst);
 
+/* Re-create the WASI context of the instance from the WASI arguments
+   of its module */
+bool
+wasm_runtime_reset_wasi(WASMModuleInstanceCommon *module_inst,
+                        char *error_buf, uint32 error_buf_size);
+
+/* Whether the instance has no files open other than the stdio and the
+   pre-opened directories, true if it has no WASI context */
+bool
+wasm_runtime_wasi_has_only_preopens(WASMModuleInstanceCommon *module_inst);
+
 void
 wasm_runtime_set_wasi_ctx(WASMModuleInstanceCommon *module_inst,
                           WASIContext *wasi_ctx);
@@ -1167,6 +1186,28 @@ wasm_runtime_quick_invoke_c_api_native(WASMModuleInstanceCommon *module_inst,
                                        wasm_val_t *results,
                                        uint32 result_count);
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+/* Throw a wasm exception from AOT/JITed code, the payload cells are
+   saved in exec_env until the exception is caught */
+void
+wasm_runtime_throw_wasm_exception(WASMExecEnv *exec_env, uint32 tag_index,
+                                  const uint32 *payload,
+                                  uint32 payload_cell_num);
+
+/* Catch the pending wasm exception in AOT/JITed code, return the tag
+   index and copy the payload if it is a wasm exception, or return -1
+   and keep the exception if it is a trap */
+int32
+wasm_runtime_catch_wasm_exception(WASMExecEnv *exec_env, uint32 *payload,
+                                  uint32 payload_cell_num);
+
+/* Forget the wasm exception thrown in exec_env, it can't be caught after
+   it is returned to the host, which may clear the exception or set a
+   trap instead */
+void
+wasm_runtime_clear_wasm_exception(WASMExecEnv *exec_env);
+#endif
+
 void
 wasm_runtime_show_app_heap_corrupted_prompt();
 
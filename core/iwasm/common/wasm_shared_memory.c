@@ -243,11 +243,31 @@ map_try_release_wait_info(HashMap *wait_hash_map, AtomicWaitInfo *wait_info,
     destroy_wait_info(wait_info);
 }
 
+/* Get the memory instance which the native address (converted from the
+   app address by the caller) belongs to */
+static WASMMemoryInstance *
+get_memory_of_address(WASMModuleInstance *module_inst, const void *address)
+{
+#if WASM_ENABLE_MULTI_MEMORY != 0
+    WASMMemoryInstance *memory;
+    uint32 i;
+
+    for (i = 1; i < module_inst->memory_count; i++) {
+        memory = module_inst->memories[i];
+        if ((uint8 *)address >= memory->memory_data
+            && (uint8 *)address < memory->memory_data_end)
+            return memory;
+    }
+#endif
+    return module_inst->memories[0];
+}
+
 uint32
 wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
                          uint64 expect, int64 timeout, bool wait64)
 {
     WASMModuleInstance *module_inst = (WASMModuleInstance *)module;
+    WASMMemoryInstance *memory;
     AtomicWaitInfo *wait_info;
     AtomicWaitNode *wait_node;
     korp_mutex *lock;
@@ -264,21 +284,20 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
         return -1;
     }
 
-    /* Currently we have only one memory instance */
-    if (!shared_memory_is_shared(module_inst->memories[0])) {
+    memory = get_memory_of_address(module_inst, address);
+    if (!shared_memory_is_shared(memory)) {
         wasm_runtime_set_exception(module, "expected shared memory");
         return -1;
     }
 
-    shared_memory_lock(module_inst->memories[0]);
-    if ((uint8 *)address < module_inst->memories[0]->memory_data
-        || (uint8 *)address + (wait64 ? 8 : 4)
-               > module_inst->memories[0]->memory_data_end) {
-        shared_memory_unlock(module_inst->memories[0]);
+    shared_memory_lock(memory);
+    if ((uint8 *)address < memory->memory_data
+        || (uint8 *)address + (wait64 ? 8 : 4) > memory->memory_data_end) {
+        shared_memory_unlock(memory);
         wasm_runtime_set_exception(module, "out of bounds memory access");
         return -1;
     }
-    shared_memory_unlock(module_inst->memories[0]);
+    shared_memory_unlock(memory);
 
 #if WASM_ENABLE_THREAD_MGR != 0
     exec_env =
@@ -286,7 +305,7 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     bh_assert(exec_env);
 #endif
 
-    lock = shared_memory_get_lock_pointer(module_inst->memories[0]);
+    lock = shared_memory_get_lock_pointer(memory);
 
     /* Lock the shared_mem_lock for the whole atomic wait process,
        and use it to os_cond_reltimedwait */
@@ -387,6 +406,7 @@ wasm_runtime_atomic_notify(WASMModuleInstanceCommon *module, void *address,
                            uint32 count)
 {
     WASMModuleInstance *module_inst = (WASMModuleInstance *)module;
+    WASMMemoryInstance *memory;
     uint32 notify_result;
     AtomicWaitInfo *wait_info;
     korp_mutex *lock;
@@ -395,25 +415,24 @@ wasm_runtime_atomic_notify(WASMModuleInstanceCommon *module, void *address,
     bh_assert(module->module_type == Wasm_Module_Bytecode
               || module->module_type == Wasm_Module_AoT);
 
-    shared_memory_lock(module_inst->memories[0]);
-    out_of_bounds =
-        ((uint8 *)address < module_inst->memories[0]->memory_data
-         || (uint8 *)address + 4 > module_inst->memories[0]->memory_data_end);
-    shared_memory_unlock(module_inst->memories[0]);
+    memory = get_memory_of_address(module_inst, address);
+    shared_memory_lock(memory);
+    out_of_bounds = ((uint8 *)address < memory->memory_data
+                     || (uint8 *)address + 4 > memory->memory_data_end);
+    shared_memory_unlock(memory);
 
     if (out_of_bounds) {
         wasm_runtime_set_exception(module, "out of bounds memory access");
         return -1;
     }
 
-    /* Currently we have only one memory instance */
-    if (!shared_memory_is_shared(module_inst->memories[0])) {
+    if (!shared_memory_is_shared(memory)) {
         /* Always return 0 for ushared linear memory since there is
            no way to create a waiter on it */
         return 0;
     }
 
-    lock = shared_memory_get_lock_pointer(module_inst->memories[0]);
+    lock = shared_memory_get_lock_pointer(memory);
 
     /* Lock the shared_mem_lock for the whole atomic notify process,
        and use it to os_cond_signal */
@@ -770,3 +770,90 @@ aot_destroy_comp_data(AOTCompData *comp_data)
 
     wasm_runtime_free(comp_data);
 }
+
+bool
+aot_is_table_content_fixed(const AOTCompData *comp_data, uint32 tbl_idx)
+{
+#if WASM_ENABLE_WAMR_COMPILER != 0
+    WASMModule *module = comp_data->wasm_module;
+    AOTTableInitData *table_seg;
+    uint32 i;
+
+    /* The imported table may be modified by other modules */
+    if (tbl_idx < comp_data->import_table_count
+        || comp_data->tables[tbl_idx].table_type.possible_grow)
+        return false;
+
+    /* table.set, table.fill, table.copy and table.init are only
+       allowed when reference types are used */
+    if (module->is_ref_types_used)
+        return false;
+
+    /* The exported table may be modified by the host */
+    for (i = 0; i < module->export_count; i++) {
+        if (module->exports[i].kind == EXPORT_KIND_TABLE
+            && module->exports[i].index == tbl_idx)
+            return false;
+    }
+
+    /* The offsets of the active segments must be known */
+    for (i = 0; i < comp_data->table_init_data_count; i++) {
+        table_seg = comp_data->table_init_data_list[i];
+        if (table_seg->table_index == tbl_idx && !(table_seg->mode & 0x1)
+            && table_seg->offset.init_expr_type != INIT_EXPR_TYPE_I32_CONST)
+            return false;
+    }
+
+    return true;
+#else
+    /* The usage of table instructions isn't recorded by the loader */
+    (void)comp_data;
+    (void)tbl_idx;
+    return false;
+#endif
+}
+
+uint32
+aot_get_table_slot_of_func(const AOTCompData *comp_data, uint32 tbl_idx,
+                           uint32 func_idx)
+{
+    AOTTableInitData *table_seg, *table_seg1;
+    uint32 i, j, k, slot;
+
+    for (i = 0; i < comp_data->table_init_data_count; i++) {
+        table_seg = comp_data->table_init_data_list[i];
+        if (table_seg->table_index != tbl_idx || (table_seg->mode & 0x1))
+            continue;
+
+        for (j = 0; j < table_seg->value_count; j++) {
+            if (table_seg->init_values[j].init_expr_type
+                    != INIT_EXPR_TYPE_FUNCREF_CONST
+                || table_seg->init_values[j].u.ref_index != func_idx)
+                continue;
+
+            slot = (uint32)table_seg->offset.u.i32 + j;
+
+            /* Check that the slot isn't overwritten by the later segments */
+            for (k = i + 1; k < comp_data->table_init_data_count; k++) {
+                table_seg1 = comp_data->table_init_data_list[k];
+                if (table_seg1->table_index == tbl_idx
+                    && !(table_seg1->mode & 0x1)
+                    && slot >= (uint32)table_seg1->offset.u.i32
+                    && slot - (uint32)table_seg1->offset.u.i32
+                           < table_seg1->value_count) {
+                    InitializerExpression *init_value =
+                        &table_seg1->init_values[slot - (uint32)table_seg1
+                                                            ->offset.u.i32];
+                    if (init_value->init_expr_type
+                            != INIT_EXPR_TYPE_FUNCREF_CONST
+                        || init_value->u.ref_index != func_idx)
+                        break;
+                }
+            }
+            if (k == comp_data->table_init_data_count)
+                return slot;
+        }
+    }
+
+    return (uint32)-1;
+}
@@ -23,6 +23,10 @@ extern "C" {
 #define AOT_FUNC_INTERNAL_PREFIX "aot_func_internal#"
 #endif
 
+#ifndef AOT_FUNC_VARIANT_PREFIX
+#define AOT_FUNC_VARIANT_PREFIX "aot_func_variant#"
+#endif
+
 #ifndef AOT_STACK_SIZES_NAME
 #define AOT_STACK_SIZES_NAME "aot_stack_sizes"
 #endif
@@ -311,6 +315,21 @@ aot_create_comp_data(WASMModule *module, const char *target_arch,
 void
 aot_destroy_comp_data(AOTCompData *comp_data);
 
+/**
+ * Check whether the elements of a table never change after the module
+ * is instantiated, so that they can be resolved at compile time.
+ */
+bool
+aot_is_table_content_fixed(const AOTCompData *comp_data, uint32 tbl_idx);
+
+/**
+ * Get the index of a slot of a fixed table which refers to the function
+ * after the module is instantiated, return (uint32)-1 if not found.
+ */
+uint32
+aot_get_table_slot_of_func(const AOTCompData *comp_data, uint32 tbl_idx,
+                           uint32 func_idx);
+
 char *
 aot_get_last_error();
 
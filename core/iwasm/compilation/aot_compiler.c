@@ -125,6 +125,25 @@ read_leb(const uint8 *buf, const uint8 *buf_end, uint32 *p_offset,
 #define read_leb_mem_offset read_leb_uint32
 #endif
 
+/* NOLINTNEXTLINE */
+#if WASM_ENABLE_MULTI_MEMORY != 0
+#define read_leb_memarg(p, p_end, res)          \
+    do {                                        \
+        read_leb_uint32(p, p_end, res);         \
+        mem_idx = 0;                            \
+        if (res & OPT_MEMIDX_FLAG) {            \
+            res &= ~OPT_MEMIDX_FLAG;            \
+            read_leb_uint32(p, p_end, mem_idx); \
+        }                                       \
+    } while (0)
+#else
+#define read_leb_memarg(p, p_end, res)  \
+    do {                                \
+        read_leb_uint32(p, p_end, res); \
+        mem_idx = 0;                    \
+    } while (0)
+#endif
+
 /**
  * Since wamrc uses a full feature Wasm loader,
  * add a post-validator here to run checks according
@@ -619,10 +638,8 @@ aot_gen_commit_sp_ip(AOTCompFrame *frame, bool commit_sp, bool commit_ip)
                 value = I32_CONST((uint32)(uintptr_t)(ip - module->load_addr));
         }
         else {
-            if (is_64bit)
-                value = I64_CONST((uint64)(uintptr_t)ip);
-            else
-                value = I32_CONST((uint32)(uintptr_t)ip);
+            value = aot_get_jit_bytecode_addr(comp_ctx, ip,
+                                              is_64bit ? I64_TYPE : I32_TYPE);
         }
 
         if (!value) {
@@ -1000,7 +1017,14 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case WASM_OP_BLOCK:
             case WASM_OP_LOOP:
             case WASM_OP_IF:
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case WASM_OP_TRY:
+#endif
             {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                if (opcode == WASM_OP_TRY && !comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+#endif
                 value_type = *frame_ip++;
                 if (value_type == VALUE_TYPE_I32 || value_type == VALUE_TYPE_I64
                     || value_type == VALUE_TYPE_F32
@@ -1049,7 +1073,14 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case EXT_OP_BLOCK:
             case EXT_OP_LOOP:
             case EXT_OP_IF:
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case EXT_OP_TRY:
+#endif
             {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+                if (opcode == EXT_OP_TRY && !comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+#endif
                 read_leb_int32(frame_ip, frame_ip_end, type_index);
                 /* type index was checked in wasm loader */
                 bh_assert(type_index < comp_ctx->comp_data->type_count);
@@ -1077,6 +1108,48 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     return false;
                 break;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            case WASM_OP_CATCH:
+            case WASM_OP_CATCH_ALL:
+                if (!comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+                if (!aot_compile_op_catch(comp_ctx, func_ctx, &frame_ip))
+                    return false;
+                break;
+
+            case WASM_OP_DELEGATE:
+                if (!comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+                /* The label depth was recorded when translating the try
+                   opcode, finish the try block like the end opcode */
+                read_leb_uint32(frame_ip, frame_ip_end, br_depth);
+                if (!aot_compile_op_end(comp_ctx, func_ctx, &frame_ip))
+                    return false;
+                break;
+
+            case WASM_OP_THROW:
+            {
+                uint32 tag_index;
+
+                if (!comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+                read_leb_uint32(frame_ip, frame_ip_end, tag_index);
+                if (!aot_compile_op_throw(comp_ctx, func_ctx, tag_index,
+                                          &frame_ip))
+                    return false;
+                break;
+            }
+
+            case WASM_OP_RETHROW:
+                if (!comp_ctx->enable_exce_handling)
+                    goto unsupport_exce_handling;
+                read_leb_uint32(frame_ip, frame_ip_end, br_depth);
+                if (!aot_compile_op_rethrow(comp_ctx, func_ctx, br_depth,
+                                            &frame_ip))
+                    return false;
+                break;
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
             case WASM_OP_BR:
             {
                 read_leb_uint32(frame_ip, frame_ip_end, br_depth);
@@ -1912,10 +1985,10 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 bytes = 2;
                 sign = (opcode == WASM_OP_I32_LOAD16_S) ? true : false;
             op_i32_load:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_i32_load(comp_ctx, func_ctx, align, offset,
-                                             bytes, sign, false))
+                if (!aot_compile_op_i32_load(comp_ctx, func_ctx, mem_idx, align,
+                                             offset, bytes, sign, false))
                     return false;
                 break;
 
@@ -1938,24 +2011,26 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 bytes = 4;
                 sign = (opcode == WASM_OP_I64_LOAD32_S) ? true : false;
             op_i64_load:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_i64_load(comp_ctx, func_ctx, align, offset,
-                                             bytes, sign, false))
+                if (!aot_compile_op_i64_load(comp_ctx, func_ctx, mem_idx, align,
+                                             offset, bytes, sign, false))
                     return false;
                 break;
 
             case WASM_OP_F32_LOAD:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_f32_load(comp_ctx, func_ctx, align, offset))
+                if (!aot_compile_op_f32_load(comp_ctx, func_ctx, mem_idx, align,
+                                             offset))
                     return false;
                 break;
 
             case WASM_OP_F64_LOAD:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_f64_load(comp_ctx, func_ctx, align, offset))
+                if (!aot_compile_op_f64_load(comp_ctx, func_ctx, mem_idx, align,
+                                             offset))
                     return false;
                 break;
 
@@ -1968,10 +2043,10 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case WASM_OP_I32_STORE16:
                 bytes = 2;
             op_i32_store:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_i32_store(comp_ctx, func_ctx, align, offset,
-                                              bytes, false))
+                if (!aot_compile_op_i32_store(comp_ctx, func_ctx, mem_idx,
+                                              align, offset, bytes, false))
                     return false;
                 break;
 
@@ -1987,39 +2062,38 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
             case WASM_OP_I64_STORE32:
                 bytes = 4;
             op_i64_store:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_i64_store(comp_ctx, func_ctx, align, offset,
-                                              bytes, false))
+                if (!aot_compile_op_i64_store(comp_ctx, func_ctx, mem_idx,
+                                              align, offset, bytes, false))
                     return false;
                 break;
 
             case WASM_OP_F32_STORE:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_f32_store(comp_ctx, func_ctx, align,
-                                              offset))
+                if (!aot_compile_op_f32_store(comp_ctx, func_ctx, mem_idx,
+                                              align, offset))
                     return false;
                 break;
 
             case WASM_OP_F64_STORE:
-                read_leb_uint32(frame_ip, frame_ip_end, align);
+                read_leb_memarg(frame_ip, frame_ip_end, align);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                if (!aot_compile_op_f64_store(comp_ctx, func_ctx, align,
-                                              offset))
+                if (!aot_compile_op_f64_store(comp_ctx, func_ctx, mem_idx,
+                                              align, offset))
                     return false;
                 break;
 
             case WASM_OP_MEMORY_SIZE:
                 read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
-                if (!aot_compile_op_memory_size(comp_ctx, func_ctx))
+                if (!aot_compile_op_memory_size(comp_ctx, func_ctx, mem_idx))
                     return false;
-                (void)mem_idx;
                 break;
 
             case WASM_OP_MEMORY_GROW:
                 read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
-                if (!aot_compile_op_memory_grow(comp_ctx, func_ctx))
+                if (!aot_compile_op_memory_grow(comp_ctx, func_ctx, mem_idx))
                     return false;
                 break;
 
@@ -2446,9 +2520,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     {
                         uint32 seg_index;
                         read_leb_uint32(frame_ip, frame_ip_end, seg_index);
-                        frame_ip++;
+                        read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
                         if (!aot_compile_op_memory_init(comp_ctx, func_ctx,
-                                                        seg_index))
+                                                        mem_idx, seg_index))
                             return false;
                         break;
                     }
@@ -2463,15 +2537,19 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     }
                     case WASM_OP_MEMORY_COPY:
                     {
-                        frame_ip += 2;
-                        if (!aot_compile_op_memory_copy(comp_ctx, func_ctx))
+                        uint32 src_mem_idx;
+                        read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
+                        read_leb_uint32(frame_ip, frame_ip_end, src_mem_idx);
+                        if (!aot_compile_op_memory_copy(comp_ctx, func_ctx,
+                                                        mem_idx, src_mem_idx))
                             return false;
                         break;
                     }
                     case WASM_OP_MEMORY_FILL:
                     {
-                        frame_ip++;
-                        if (!aot_compile_op_memory_fill(comp_ctx, func_ctx))
+                        read_leb_uint32(frame_ip, frame_ip_end, mem_idx);
+                        if (!aot_compile_op_memory_fill(comp_ctx, func_ctx,
+                                                        mem_idx))
                             return false;
                         break;
                     }
@@ -2560,25 +2638,26 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 opcode = (uint8)opcode1;
 
                 if (opcode != WASM_OP_ATOMIC_FENCE) {
-                    read_leb_uint32(frame_ip, frame_ip_end, align);
+                    read_leb_memarg(frame_ip, frame_ip_end, align);
                     read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 }
                 switch (opcode) {
                     case WASM_OP_ATOMIC_WAIT32:
                         if (!aot_compile_op_atomic_wait(comp_ctx, func_ctx,
-                                                        VALUE_TYPE_I32, align,
-                                                        offset, 4))
+                                                        VALUE_TYPE_I32, mem_idx,
+                                                        align, offset, 4))
                             return false;
                         break;
                     case WASM_OP_ATOMIC_WAIT64:
                         if (!aot_compile_op_atomic_wait(comp_ctx, func_ctx,
-                                                        VALUE_TYPE_I64, align,
-                                                        offset, 8))
+                                                        VALUE_TYPE_I64, mem_idx,
+                                                        align, offset, 8))
                             return false;
                         break;
                     case WASM_OP_ATOMIC_NOTIFY:
-                        if (!aot_compiler_op_atomic_notify(
-                                comp_ctx, func_ctx, align, offset, bytes))
+                        if (!aot_compiler_op_atomic_notify(comp_ctx, func_ctx,
+                                                           mem_idx, align,
+                                                           offset, bytes))
                             return false;
                         break;
                     case WASM_OP_ATOMIC_FENCE:
@@ -2596,8 +2675,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case WASM_OP_ATOMIC_I32_LOAD16_U:
                         bytes = 2;
                     op_atomic_i32_load:
-                        if (!aot_compile_op_i32_load(comp_ctx, func_ctx, align,
-                                                     offset, bytes, sign, true))
+                        if (!aot_compile_op_i32_load(comp_ctx, func_ctx,
+                                                     mem_idx, align, offset,
+                                                     bytes, sign, true))
                             return false;
                         break;
 
@@ -2613,8 +2693,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case WASM_OP_ATOMIC_I64_LOAD32_U:
                         bytes = 4;
                     op_atomic_i64_load:
-                        if (!aot_compile_op_i64_load(comp_ctx, func_ctx, align,
-                                                     offset, bytes, sign, true))
+                        if (!aot_compile_op_i64_load(comp_ctx, func_ctx,
+                                                     mem_idx, align, offset,
+                                                     bytes, sign, true))
                             return false;
                         break;
 
@@ -2627,8 +2708,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case WASM_OP_ATOMIC_I32_STORE16:
                         bytes = 2;
                     op_atomic_i32_store:
-                        if (!aot_compile_op_i32_store(comp_ctx, func_ctx, align,
-                                                      offset, bytes, true))
+                        if (!aot_compile_op_i32_store(comp_ctx, func_ctx,
+                                                      mem_idx, align, offset,
+                                                      bytes, true))
                             return false;
                         break;
 
@@ -2644,8 +2726,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case WASM_OP_ATOMIC_I64_STORE32:
                         bytes = 4;
                     op_atomic_i64_store:
-                        if (!aot_compile_op_i64_store(comp_ctx, func_ctx, align,
-                                                      offset, bytes, true))
+                        if (!aot_compile_op_i64_store(comp_ctx, func_ctx,
+                                                      mem_idx, align, offset,
+                                                      bytes, true))
                             return false;
                         break;
 
@@ -2678,8 +2761,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         op_type = VALUE_TYPE_I64;
                     op_atomic_cmpxchg:
                         if (!aot_compile_op_atomic_cmpxchg(comp_ctx, func_ctx,
-                                                           op_type, align,
-                                                           offset, bytes))
+                                                           op_type, mem_idx,
+                                                           align, offset,
+                                                           bytes))
                             return false;
                         break;
 
@@ -2692,8 +2776,8 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
 
                     build_atomic_rmw:
                         if (!aot_compile_op_atomic_rmw(comp_ctx, func_ctx,
-                                                       bin_op, op_type, align,
-                                                       offset, bytes))
+                                                       bin_op, op_type, mem_idx,
+                                                       align, offset, bytes))
                             return false;
                         break;
 
@@ -2725,10 +2809,10 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     /* Memory instruction */
                     case SIMD_v128_load:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_v128_load(comp_ctx, func_ctx,
-                                                        align, offset))
+                                                        mem_idx, align, offset))
                             return false;
                         break;
                     }
@@ -2740,10 +2824,11 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case SIMD_v128_load32x2_s:
                     case SIMD_v128_load32x2_u:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
-                        if (!aot_compile_simd_load_extend(
-                                comp_ctx, func_ctx, opcode, align, offset))
+                        if (!aot_compile_simd_load_extend(comp_ctx, func_ctx,
+                                                          opcode, mem_idx,
+                                                          align, offset))
                             return false;
                         break;
                     }
@@ -2753,20 +2838,22 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case SIMD_v128_load32_splat:
                     case SIMD_v128_load64_splat:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_load_splat(comp_ctx, func_ctx,
-                                                         opcode, align, offset))
+                                                         opcode, mem_idx, align,
+                                                         offset))
                             return false;
                         break;
                     }
 
                     case SIMD_v128_store:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_v128_store(comp_ctx, func_ctx,
-                                                         align, offset))
+                                                         mem_idx, align,
+                                                         offset))
                             return false;
                         break;
                     }
@@ -3026,11 +3113,11 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case SIMD_v128_load32_lane:
                     case SIMD_v128_load64_lane:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_load_lane(comp_ctx, func_ctx,
-                                                        opcode, align, offset,
-                                                        *frame_ip++))
+                                                        opcode, mem_idx, align,
+                                                        offset, *frame_ip++))
                             return false;
                         break;
                     }
@@ -3040,11 +3127,11 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case SIMD_v128_store32_lane:
                     case SIMD_v128_store64_lane:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_store_lane(comp_ctx, func_ctx,
-                                                         opcode, align, offset,
-                                                         *frame_ip++))
+                                                         opcode, mem_idx, align,
+                                                         offset, *frame_ip++))
                             return false;
                         break;
                     }
@@ -3052,10 +3139,11 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     case SIMD_v128_load32_zero:
                     case SIMD_v128_load64_zero:
                     {
-                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_memarg(frame_ip, frame_ip_end, align);
                         read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                         if (!aot_compile_simd_load_zero(comp_ctx, func_ctx,
-                                                        opcode, align, offset))
+                                                        opcode, mem_idx, align,
+                                                        offset))
                             return false;
                         break;
                     }
@@ -3902,6 +3990,13 @@ unsupport_gc_and_ref_types:
     return false;
 #endif
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+unsupport_exce_handling:
+    aot_set_last_error("exception handling instruction was found, "
+                       "try adding --enable-exce-handling option");
+    return false;
+#endif
+
 #if WASM_ENABLE_BULK_MEMORY != 0
 unsupport_bulk_memory:
     aot_set_last_error("bulk memory instruction was found, "
@@ -3961,6 +4056,13 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
         }
     }
 
+    if (comp_ctx->cpu_variant_count > 0) {
+        bh_print_time("Begin to add CPU variants of functions");
+        if (!aot_add_cpu_variant_funcs(comp_ctx)) {
+            return false;
+        }
+    }
+
     /* Run IR optimization before feeding in ORCJIT and AOT codegen */
     if (comp_ctx->optimize) {
         /* Run passes for AOT/JIT mode.
@@ -3991,6 +4093,12 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
             return false;
         }
 
+        if (comp_ctx->orc_object_cache
+            && (!aot_promote_jit_local_symbols(comp_ctx)
+                || !aot_define_jit_symbols(comp_ctx, orc_main_dylib))) {
+            return false;
+        }
+
         orc_thread_safe_module = LLVMOrcCreateNewThreadSafeModule(
             comp_ctx->module, comp_ctx->orc_thread_safe_context);
         if (!orc_thread_safe_module) {
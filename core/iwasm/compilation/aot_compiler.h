@@ -732,13 +732,8 @@ set_local_gc_ref(AOTCompFrame *frame, int n, LLVMValueRef value, uint8 ref_type)
         }                                                                   \
         if (comp_ctx->is_jit_mode) {                                        \
             /* JIT mode, call the function directly */                      \
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {         \
-                aot_set_last_error("llvm add pointer type failed.");        \
-                goto fail;                                                  \
-            }                                                               \
-            if (!(value = I64_CONST((uint64)(uintptr_t)name))               \
-                || !(func = LLVMConstIntToPtr(value, func_ptr_type))) {     \
-                aot_set_last_error("create LLVM value failed.");            \
+            if (!(func = aot_get_jit_func_ref(comp_ctx, #name,              \
+                                              (void *)name, func_type))) {  \
                 goto fail;                                                  \
             }                                                               \
         }                                                                   \
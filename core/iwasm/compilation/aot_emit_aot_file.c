@@ -75,6 +75,11 @@ typedef struct AOTObjectData {
     AOTObjectFunc *funcs;
     uint32 func_count;
 
+    /* text offsets of the CPU variants of the functions, indexed by
+       variant index * func_count + func index, (uint32)-1 if the
+       function has no such variant */
+    uint32 *func_variant_text_offsets;
+
     AOTSymbolList symbol_list;
     AOTRelocationGroup *relocation_groups;
     uint32 relocation_group_count;
@@ -82,6 +87,10 @@ typedef struct AOTObjectData {
     const char *stack_sizes_section_name;
     uint32 stack_sizes_offset;
     uint32 *stack_sizes;
+
+    /* text merged with the read-only data sections, see
+       aot_resolve_shared_text */
+    uint8 *shared_text;
 } AOTObjectData;
 
 #if 0
@@ -119,6 +128,50 @@ str_starts_with(const char *str, const char *prefix)
     return (len_str >= len_pre) && !memcmp(str, prefix, len_pre);
 }
 
+/* Get the function index of symbol "<prefix><n>", return false if the
+   symbol isn't of that form, e.g. the cold part of a function outlined
+   by LLVM is named "aot_func#n.cold.1" */
+static bool
+get_func_index_of_symbol(const char *name, const char *prefix,
+                         uint32 *p_func_index)
+{
+    const char *p;
+    char *p_end;
+
+    if (!str_starts_with(name, prefix))
+        return false;
+
+    p = name + strlen(prefix);
+    if (*p < '0' || *p > '9')
+        return false;
+
+    *p_func_index = (uint32)strtoul(p, &p_end, 10);
+    return *p_end == '\0';
+}
+
+/* Get the variant index and the function index of symbol
+   "aot_func_variant#<variant index>#<function index>" */
+static bool
+get_func_variant_of_symbol(const char *name, uint32 *p_variant_index,
+                           uint32 *p_func_index)
+{
+    const char *p;
+    char *p_end;
+
+    if (!str_starts_with(name, AOT_FUNC_VARIANT_PREFIX))
+        return false;
+
+    p = name + strlen(AOT_FUNC_VARIANT_PREFIX);
+    if (*p < '0' || *p > '9')
+        return false;
+
+    *p_variant_index = (uint32)strtoul(p, &p_end, 10);
+    if (*p_end != '#')
+        return false;
+
+    return get_func_index_of_symbol(p_end, "#", p_func_index);
+}
+
 static uint32
 get_file_header_size()
 {
@@ -795,9 +848,18 @@ get_init_data_section_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     return size;
 }
 
+/* Alignment of the code and the merged read-only data in shared text */
+#define SHARED_TEXT_ALIGN 64
+
 static uint32
 get_text_section_size(AOTObjectData *obj_data)
 {
+    if (obj_data->comp_ctx->enable_shared_text)
+        /* literal size + padding before and after the code, see
+           aot_emit_text_section */
+        return sizeof(uint32) + SHARED_TEXT_ALIGN
+               + align_uint(obj_data->text_size, 4);
+
     return sizeof(uint32) + align_uint(obj_data->literal_size, 4)
            + align_uint(obj_data->text_size, 4)
            + align_uint(obj_data->text_unlikely_size, 4)
@@ -1181,6 +1243,28 @@ get_native_symbol_list_size(AOTCompContext *comp_ctx)
     return len;
 }
 
+static uint32
+get_func_variant_section_size(AOTCompContext *comp_ctx,
+                              AOTObjectData *obj_data)
+{
+    /* variant count */
+    uint32 size = (uint32)sizeof(uint32), i, j;
+
+    for (i = 0; i < comp_ctx->cpu_variant_count; i++) {
+        /* cpu features + function count */
+        size += (uint32)(sizeof(uint64) + sizeof(uint32));
+        for (j = 0; j < obj_data->func_count; j++) {
+            if (obj_data->func_variant_text_offsets[i * obj_data->func_count
+                                                    + j]
+                != (uint32)-1)
+                /* function index + text offset */
+                size += (uint32)sizeof(uint32) * 2;
+        }
+    }
+
+    return size;
+}
+
 #if WASM_ENABLE_STRINGREF != 0
 static uint32
 get_string_literal_section_size(AOTCompContext *comp_ctx,
@@ -1247,6 +1331,13 @@ aot_get_aot_file_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
         size += get_native_symbol_list_size(comp_ctx);
     }
 
+    if (obj_data->func_variant_text_offsets) {
+        size = align_uint(size, 4);
+        /* section id + section size + sub section id */
+        size += (uint32)sizeof(uint32) * 3;
+        size += get_func_variant_section_size(comp_ctx, obj_data);
+    }
+
     size_custom_section = get_custom_sections_size(comp_ctx, comp_data);
     if (size_custom_section > 0) {
         size = align_uint(size, 4);
@@ -2438,6 +2529,33 @@ aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
 
     EMIT_U32(AOT_SECTION_TYPE_TEXT);
     EMIT_U32(section_size);
+
+    if (obj_data->comp_ctx->enable_shared_text) {
+        /* Pad the code with the literal so that it is aligned in the file,
+           and the alignment of the merged read-only data is kept when the
+           file is mapped to a page aligned address */
+        uint32 padding =
+            align_uint(offset + sizeof(uint32), SHARED_TEXT_ALIGN)
+            - (offset + (uint32)sizeof(uint32));
+
+        EMIT_U32(padding);
+        for (i = 0; i < padding; i++)
+            EMIT_BUF(&placeholder, 1);
+        text = buf + offset;
+        EMIT_BUF(obj_data->text, obj_data->text_size);
+        /* keep the section size regardless of the padding */
+        for (i = padding + obj_data->text_size;
+             i < SHARED_TEXT_ALIGN + align_uint(obj_data->text_size, 4); i++)
+            EMIT_BUF(&placeholder, 1);
+
+        if (offset - *p_offset != section_size + sizeof(uint32) * 2) {
+            aot_set_last_error("emit text section failed.");
+            return false;
+        }
+        *p_offset = offset;
+        return true;
+    }
+
     EMIT_U32(obj_data->literal_size);
 
     if (obj_data->literal_size > 0) {
@@ -2894,6 +3012,49 @@ aot_emit_string_literal_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
 }
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
+static bool
+aot_emit_func_variant_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
+                              AOTCompContext *comp_ctx,
+                              AOTObjectData *obj_data)
+{
+    uint32 *text_offsets = obj_data->func_variant_text_offsets;
+    uint32 offset = *p_offset, func_count = obj_data->func_count;
+    uint32 i, j, variant_func_count;
+
+    if (!text_offsets)
+        return true;
+
+    *p_offset = offset = align_uint(offset, 4);
+
+    EMIT_U32(AOT_SECTION_TYPE_CUSTOM);
+    /* sub section id + function variant section size */
+    EMIT_U32(sizeof(uint32) * 1
+             + get_func_variant_section_size(comp_ctx, obj_data));
+    EMIT_U32(AOT_CUSTOM_SECTION_FUNC_VARIANT);
+    EMIT_U32(comp_ctx->cpu_variant_count);
+
+    for (i = 0; i < comp_ctx->cpu_variant_count; i++) {
+        variant_func_count = 0;
+        for (j = 0; j < func_count; j++) {
+            if (text_offsets[i * func_count + j] != (uint32)-1)
+                variant_func_count++;
+        }
+
+        EMIT_U64(comp_ctx->cpu_variants[i].cpu_features);
+        EMIT_U32(variant_func_count);
+        for (j = 0; j < func_count; j++) {
+            if (text_offsets[i * func_count + j] != (uint32)-1) {
+                EMIT_U32(j);
+                EMIT_U32(text_offsets[i * func_count + j]);
+            }
+        }
+    }
+
+    *p_offset = offset;
+
+    return true;
+}
+
 static bool
 aot_emit_custom_sections(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
                          AOTCompData *comp_data, AOTCompContext *comp_ctx)
@@ -3664,13 +3825,49 @@ fail:
     return false;
 }
 
+/* Get the offset of a function symbol in the text section emitted,
+   which is [.text][.text.unlikely.][.text.hot.] */
+static bool
+get_text_offset_of_symbol(AOTObjectData *obj_data,
+                          LLVMSymbolIteratorRef sym_itr, uint64 *p_offset)
+{
+    LLVMSectionIteratorRef contain_section;
+    char *contain_section_name;
+
+    if (!(contain_section =
+              LLVMObjectFileCopySectionIterator(obj_data->binary))) {
+        aot_set_last_error("llvm get section iterator failed.");
+        return false;
+    }
+    LLVMMoveToContainingSection(contain_section, sym_itr);
+    contain_section_name = (char *)LLVMGetSectionName(contain_section);
+    LLVMDisposeSectionIterator(contain_section);
+
+    if (!strcmp(contain_section_name, ".text.unlikely.")
+        || !strcmp(contain_section_name, ".ltext.unlikely.")) {
+        *p_offset =
+            align_uint(obj_data->text_size, 4) + LLVMGetSymbolAddress(sym_itr);
+    }
+    else if (!strcmp(contain_section_name, ".text.hot.")
+             || !strcmp(contain_section_name, ".ltext.hot.")) {
+        *p_offset = align_uint(obj_data->text_size, 4)
+                    + align_uint(obj_data->text_unlikely_size, 4)
+                    + LLVMGetSymbolAddress(sym_itr);
+    }
+    else {
+        *p_offset = LLVMGetSymbolAddress(sym_itr);
+    }
+    return true;
+}
+
 static bool
 aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
 {
     AOTObjectFunc *func;
     LLVMSymbolIteratorRef sym_itr;
     char *name, *prefix = AOT_FUNC_PREFIX;
-    uint32 func_index, total_size;
+    uint32 func_index, variant_index, total_size;
+    uint64 text_offset;
 
     /* allocate memory for aot function */
     obj_data->func_count = comp_ctx->comp_data->func_count;
@@ -3685,6 +3882,17 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
             return false;
         }
         memset(obj_data->funcs, 0, total_size);
+
+        if (comp_ctx->cpu_variant_count > 0) {
+            total_size = (uint32)sizeof(uint32) * comp_ctx->cpu_variant_count
+                         * obj_data->func_count;
+            if (!(obj_data->func_variant_text_offsets =
+                      wasm_runtime_malloc(total_size))) {
+                aot_set_last_error("allocate memory for functions failed.");
+                return false;
+            }
+            memset(obj_data->func_variant_text_offsets, 0xFF, total_size);
+        }
     }
 
     if (!(sym_itr = LLVMObjectFileCopySymbolIterator(obj_data->binary))) {
@@ -3694,82 +3902,49 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
 
     while (!LLVMObjectFileIsSymbolIteratorAtEnd(obj_data->binary, sym_itr)) {
         if ((name = (char *)LLVMGetSymbolName(sym_itr))
-            && str_starts_with(name, prefix)) {
+            && get_func_index_of_symbol(name, prefix, &func_index)) {
             /* symbol aot_func#n */
-            func_index = (uint32)atoi(name + strlen(prefix));
             if (func_index < obj_data->func_count) {
-                LLVMSectionIteratorRef contain_section;
-                char *contain_section_name;
-
                 func = obj_data->funcs + func_index;
                 func->func_name = name;
 
-                if (!(contain_section = LLVMObjectFileCopySectionIterator(
-                          obj_data->binary))) {
-                    aot_set_last_error("llvm get section iterator failed.");
+                if (!get_text_offset_of_symbol(obj_data, sym_itr,
+                                               &func->text_offset)) {
                     LLVMDisposeSymbolIterator(sym_itr);
                     return false;
                 }
-                LLVMMoveToContainingSection(contain_section, sym_itr);
-                contain_section_name =
-                    (char *)LLVMGetSectionName(contain_section);
-                LLVMDisposeSectionIterator(contain_section);
-
-                if (!strcmp(contain_section_name, ".text.unlikely.")
-                    || !strcmp(contain_section_name, ".ltext.unlikely.")) {
-                    func->text_offset = align_uint(obj_data->text_size, 4)
-                                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else if (!strcmp(contain_section_name, ".text.hot.")
-                         || !strcmp(contain_section_name, ".ltext.hot.")) {
-                    func->text_offset =
-                        align_uint(obj_data->text_size, 4)
-                        + align_uint(obj_data->text_unlikely_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else {
-                    func->text_offset = LLVMGetSymbolAddress(sym_itr);
-                }
             }
         }
         else if ((name = (char *)LLVMGetSymbolName(sym_itr))
-                 && str_starts_with(name, AOT_FUNC_INTERNAL_PREFIX)) {
+                 && get_func_index_of_symbol(name, AOT_FUNC_INTERNAL_PREFIX,
+                                             &func_index)) {
             /* symbol aot_func_internal#n */
-            func_index = (uint32)atoi(name + strlen(AOT_FUNC_INTERNAL_PREFIX));
             if (func_index < obj_data->func_count) {
-                LLVMSectionIteratorRef contain_section;
-                char *contain_section_name;
-
                 func = obj_data->funcs + func_index;
 
-                if (!(contain_section = LLVMObjectFileCopySectionIterator(
-                          obj_data->binary))) {
-                    aot_set_last_error("llvm get section iterator failed.");
+                if (!get_text_offset_of_symbol(
+                        obj_data, sym_itr,
+                        &func->text_offset_of_aot_func_internal)) {
                     LLVMDisposeSymbolIterator(sym_itr);
                     return false;
                 }
-                LLVMMoveToContainingSection(contain_section, sym_itr);
-                contain_section_name =
-                    (char *)LLVMGetSectionName(contain_section);
-                LLVMDisposeSectionIterator(contain_section);
-
-                if (!strcmp(contain_section_name, ".text.unlikely.")
-                    || !strcmp(contain_section_name, ".ltext.unlikely.")) {
-                    func->text_offset_of_aot_func_internal =
-                        align_uint(obj_data->text_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else if (!strcmp(contain_section_name, ".text.hot.")
-                         || !strcmp(contain_section_name, ".ltext.hot.")) {
-                    func->text_offset_of_aot_func_internal =
-                        align_uint(obj_data->text_size, 4)
-                        + align_uint(obj_data->text_unlikely_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else {
-                    func->text_offset_of_aot_func_internal =
-                        LLVMGetSymbolAddress(sym_itr);
+            }
+        }
+        else if (obj_data->func_variant_text_offsets
+                 && (name = (char *)LLVMGetSymbolName(sym_itr))
+                 && get_func_variant_of_symbol(name, &variant_index,
+                                               &func_index)) {
+            /* symbol aot_func_variant#v#n */
+            if (variant_index < comp_ctx->cpu_variant_count
+                && func_index < obj_data->func_count) {
+                if (!get_text_offset_of_symbol(obj_data, sym_itr,
+                                               &text_offset)) {
+                    LLVMDisposeSymbolIterator(sym_itr);
+                    return false;
                 }
+                obj_data->func_variant_text_offsets
+                    [variant_index * obj_data->func_count + func_index] =
+                    (uint32)text_offset;
             }
         }
         LLVMMoveToNextSymbol(sym_itr);
@@ -4190,6 +4365,7 @@ aot_resolve_object_relocation_groups(AOTObjectData *obj_data)
              * copy-on-write mappings.
              */
             if (obj_data->comp_ctx->is_indirect_mode
+                && !obj_data->comp_ctx->enable_shared_text
                 && is_readonly_section(relocation_group->section_name)) {
                 LOG_WARNING("%" PRIu32
                             " text relocations in %s section for indirect mode",
@@ -4250,6 +4426,8 @@ aot_obj_data_destroy(AOTObjectData *obj_data)
         LLVMDisposeMemoryBuffer(obj_data->mem_buf);
     if (obj_data->funcs)
         wasm_runtime_free(obj_data->funcs);
+    if (obj_data->func_variant_text_offsets)
+        wasm_runtime_free(obj_data->func_variant_text_offsets);
     if (obj_data->data_sections) {
         uint32 i;
         for (i = 0; i < obj_data->data_sections_count; i++) {
@@ -4271,9 +4449,273 @@ aot_obj_data_destroy(AOTObjectData *obj_data)
         destroy_relocation_symbol_list(&obj_data->symbol_list);
     if (obj_data->stack_sizes)
         wasm_runtime_free(obj_data->stack_sizes);
+    if (obj_data->shared_text)
+        wasm_runtime_free(obj_data->shared_text);
     wasm_runtime_free(obj_data);
 }
 
+/* x86_64 ELF relocation types which are resolved for shared text */
+#define SHARED_TEXT_R_X86_64_PC32 2
+#define SHARED_TEXT_R_X86_64_PLT32 4
+#define SHARED_TEXT_R_X86_64_PC64 24
+
+static bool
+is_shared_rodata_section(const char *name)
+{
+    return !strcmp(name, ".rodata")
+           /* ".rodata.cst4/8/16/.." */
+           || str_starts_with(name, ".rodata.cst")
+           /* ".rodata.strn.m" */
+           || str_starts_with(name, ".rodata.str");
+}
+
+/* Get the offset of a section in the shared text, return false if the
+   section isn't merged into it */
+static bool
+get_shared_text_offset(AOTObjectData *obj_data, const char *name,
+                       const uint32 *rodata_offsets, uint32 *p_offset)
+{
+    uint32 i;
+
+    if (!strcmp(name, ".text") || !strcmp(name, ".ltext")) {
+        *p_offset = 0;
+        return true;
+    }
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        if (rodata_offsets[i] != (uint32)-1
+            && !strcmp(obj_data->data_sections[i].name, name)) {
+            *p_offset = rodata_offsets[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool
+apply_shared_text_relocation(AOTObjectData *obj_data, AOTRelocation *relocation,
+                             uint32 place, uint32 symbol_offset)
+{
+    uint8 *p = obj_data->shared_text + place;
+    int64 value = (int64)symbol_offset + relocation->relocation_addend
+                  - (int64)place;
+
+    switch (relocation->relocation_type) {
+        case SHARED_TEXT_R_X86_64_PC32:
+        case SHARED_TEXT_R_X86_64_PLT32:
+        {
+            int32 value32 = (int32)value;
+
+            if (value != (int64)value32
+                || (uint64)place + sizeof(int32) > obj_data->text_size) {
+                aot_set_last_error("resolve shared text relocation failed.");
+                return false;
+            }
+            if (!is_little_endian())
+                exchange_uint32((uint8 *)&value32);
+            bh_memcpy_s(p, sizeof(int32), &value32, sizeof(int32));
+            return true;
+        }
+        case SHARED_TEXT_R_X86_64_PC64:
+        {
+            if ((uint64)place + sizeof(int64) > obj_data->text_size) {
+                aot_set_last_error("resolve shared text relocation failed.");
+                return false;
+            }
+            if (!is_little_endian())
+                exchange_uint64((uint8 *)&value);
+            bh_memcpy_s(p, sizeof(int64), &value, sizeof(int64));
+            return true;
+        }
+        default:
+            aot_set_last_error_v("unsupported relocation type %" PRIu32
+                                 " in shared text.",
+                                 relocation->relocation_type);
+            return false;
+    }
+}
+
+/**
+ * Make the text mappable from the AOT file and shareable among processes:
+ * merge the read-only data sections into the text and resolve the
+ * relocations between them, so that the runtime needn't to patch the text.
+ * The remaining relocations refer to the writable data sections or the
+ * runtime symbols.
+ */
+static bool
+aot_resolve_shared_text(AOTObjectData *obj_data)
+{
+    AOTObjectDataSection *data_section;
+    AOTRelocationGroup *group;
+    AOTRelocation *relocation;
+    uint32 *rodata_offsets = NULL, text_size, place_base, symbol_offset;
+    uint32 i, j, k, text_relocation_count = 0;
+    uint64 size;
+    const char *target;
+
+#if WASM_ENABLE_DEBUG_AOT != 0
+    aot_set_last_error("shared text is unsupported for debug AOT.");
+    return false;
+#endif
+
+    /* Only ELF64 little endian is supported */
+    if (obj_data->target_info.bin_type != 2) {
+        aot_set_last_error("shared text is only supported for ELF64 binary.");
+        return false;
+    }
+
+    /* Layout: text, unlikely text, hot text, then the read-only data
+       sections, each of them is aligned to SHARED_TEXT_ALIGN */
+    text_size = align_uint(obj_data->text_size, 4)
+                + align_uint(obj_data->text_unlikely_size, 4)
+                + align_uint(obj_data->text_hot_size, 4);
+
+    if (obj_data->data_sections_count > 0) {
+        size = sizeof(uint32) * (uint64)obj_data->data_sections_count;
+        if (!(rodata_offsets = wasm_runtime_malloc((uint32)size))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+    }
+
+    size = text_size;
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        data_section = obj_data->data_sections + i;
+        rodata_offsets[i] = (uint32)-1;
+        if (is_shared_rodata_section(data_section->name)) {
+            size = align_uint64(size, SHARED_TEXT_ALIGN);
+            rodata_offsets[i] = (uint32)size;
+            size += data_section->size;
+        }
+    }
+
+    if (size >= UINT32_MAX - SHARED_TEXT_ALIGN
+        || !(obj_data->shared_text =
+                 wasm_runtime_malloc(size > 0 ? (uint32)size : 1))) {
+        aot_set_last_error("allocate memory for shared text failed.");
+        goto fail;
+    }
+    memset(obj_data->shared_text, 0, (uint32)size);
+
+    if (obj_data->text_size > 0)
+        bh_memcpy_s(obj_data->shared_text, (uint32)size, obj_data->text,
+                    obj_data->text_size);
+    if (obj_data->text_unlikely_size > 0)
+        bh_memcpy_s(obj_data->shared_text
+                        + align_uint(obj_data->text_size, 4),
+                    (uint32)size - align_uint(obj_data->text_size, 4),
+                    obj_data->text_unlikely, obj_data->text_unlikely_size);
+    if (obj_data->text_hot_size > 0)
+        bh_memcpy_s(obj_data->shared_text + align_uint(obj_data->text_size, 4)
+                        + align_uint(obj_data->text_unlikely_size, 4),
+                    (uint32)size - align_uint(obj_data->text_size, 4)
+                        - align_uint(obj_data->text_unlikely_size, 4),
+                    obj_data->text_hot, obj_data->text_hot_size);
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        data_section = obj_data->data_sections + i;
+        if (rodata_offsets[i] != (uint32)-1 && data_section->size > 0)
+            bh_memcpy_s(obj_data->shared_text + rodata_offsets[i],
+                        (uint32)size - rodata_offsets[i], data_section->data,
+                        data_section->size);
+    }
+
+    obj_data->text = obj_data->shared_text;
+    obj_data->text_size = (uint32)size;
+    obj_data->text_unlikely = obj_data->text_hot = NULL;
+    obj_data->text_unlikely_size = obj_data->text_hot_size = 0;
+
+    /* Resolve the relocations */
+    group = obj_data->relocation_groups;
+    for (i = 0; i < obj_data->relocation_group_count; i++, group++) {
+        /* ".rela.text" is for ".text", ".rela.rodata" is for ".rodata" */
+        target = group->section_name + strlen(".rela");
+        if (!str_starts_with(group->section_name, ".rela")
+            || !get_shared_text_offset(obj_data, target, rodata_offsets,
+                                       &place_base)) {
+            /* Relocations of the writable data sections, refer to the
+               merged read-only data through the text */
+            for (j = 0; j < group->relocation_count; j++) {
+                relocation = group->relocations + j;
+                if (is_shared_rodata_section(relocation->symbol_name)
+                    && get_shared_text_offset(obj_data,
+                                              relocation->symbol_name,
+                                              rodata_offsets, &symbol_offset)) {
+                    relocation->symbol_name = ".text";
+                    relocation->relocation_addend += symbol_offset;
+                }
+            }
+            continue;
+        }
+
+        for (j = k = 0; j < group->relocation_count; j++) {
+            relocation = group->relocations + j;
+            if (get_shared_text_offset(obj_data, relocation->symbol_name,
+                                       rodata_offsets, &symbol_offset)) {
+                if (!apply_shared_text_relocation(
+                        obj_data, relocation,
+                        place_base + (uint32)relocation->relocation_offset,
+                        symbol_offset))
+                    goto fail;
+                if (relocation->is_symbol_name_allocated)
+                    wasm_runtime_free(relocation->symbol_name);
+                continue;
+            }
+            if (place_base != 0) {
+                /* The read-only data refers to a symbol out of the text */
+                aot_set_last_error_v("unsupported relocation to %s in %s "
+                                     "section for shared text.",
+                                     relocation->symbol_name, target);
+                goto fail;
+            }
+            group->relocations[k++] = *relocation;
+        }
+        group->relocation_count = k;
+        text_relocation_count += k;
+    }
+
+    /* Remove the empty relocation groups */
+    for (i = j = 0; i < obj_data->relocation_group_count; i++) {
+        group = obj_data->relocation_groups + i;
+        if (group->relocation_count == 0) {
+            if (group->relocations)
+                wasm_runtime_free(group->relocations);
+            if (group->is_section_name_allocated)
+                wasm_runtime_free(group->section_name);
+            continue;
+        }
+        obj_data->relocation_groups[j++] = *group;
+    }
+    obj_data->relocation_group_count = j;
+
+    /* Remove the merged read-only data sections */
+    for (i = j = 0; i < obj_data->data_sections_count; i++) {
+        data_section = obj_data->data_sections + i;
+        if (rodata_offsets[i] != (uint32)-1) {
+            if (data_section->is_name_allocated)
+                wasm_runtime_free(data_section->name);
+            if (data_section->is_data_allocated)
+                wasm_runtime_free(data_section->data);
+            continue;
+        }
+        obj_data->data_sections[j++] = *data_section;
+    }
+    obj_data->data_sections_count = j;
+
+    if (text_relocation_count > 0) {
+        /* The pages patched by the runtime are not shared any more */
+        LOG_WARNING("%" PRIu32 " text relocations remain for shared text",
+                    text_relocation_count);
+    }
+
+    if (rodata_offsets)
+        wasm_runtime_free(rodata_offsets);
+    return true;
+
+fail:
+    if (rodata_offsets)
+        wasm_runtime_free(rodata_offsets);
+    return false;
+}
+
 AOTObjectData *
 aot_obj_data_create(AOTCompContext *comp_ctx)
 {
@@ -4432,6 +4874,13 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     }
     if (comp_ctx->enable_gc) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_GARBAGE_COLLECTION;
+        obj_data->target_info.feature_flags |= WASM_FEATURE_GC_WRITE_BARRIER;
+    }
+    if (comp_ctx->enable_exce_handling) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_EXCEPTION_HANDLING;
+    }
+    if (comp_ctx->comp_data->memory_count > 1) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_MULTI_MEMORY;
     }
 
     bh_print_time("Begin to resolve object file info");
@@ -4444,6 +4893,9 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
         || !aot_resolve_object_relocation_groups(obj_data))
         goto fail;
 
+    if (comp_ctx->enable_shared_text && !aot_resolve_shared_text(obj_data))
+        goto fail;
+
     return obj_data;
 
 fail:
@@ -4512,6 +4964,8 @@ aot_emit_aot_file_buf_ex(AOTCompContext *comp_ctx, AOTCompData *comp_data,
         || !aot_emit_relocation_section(buf, buf_end, &offset, comp_ctx,
                                         comp_data, obj_data)
         || !aot_emit_native_symbol(buf, buf_end, &offset, comp_ctx)
+        || !aot_emit_func_variant_section(buf, buf_end, &offset, comp_ctx,
+                                          obj_data)
         || !aot_emit_custom_sections(buf, buf_end, &offset, comp_data, comp_ctx)
 #if WASM_ENABLE_STRINGREF != 0
         || !aot_emit_string_literal_section(buf, buf_end, &offset, comp_data,
@@ -6,17 +6,20 @@
 #include "aot_emit_control.h"
 #include "aot_compiler.h"
 #include "aot_emit_exception.h"
+#include "aot_emit_function.h"
 #if WASM_ENABLE_GC != 0
 #include "aot_emit_gc.h"
 #endif
 #include "../aot/aot_runtime.h"
 #include "../interpreter/wasm_loader.h"
+#include "../interpreter/wasm_opcode.h"
 
 #if WASM_ENABLE_DEBUG_AOT != 0
 #include "debug/dwarf_extractor.h"
 #endif
 
-static char *block_name_prefix[] = { "block", "loop", "if" };
+static char *block_name_prefix[] = { "block", "loop", "if",       "func",
+                                     "try",   "catch", "catch_all" };
 static char *block_name_suffix[] = { "begin", "else", "end" };
 
 /* clang-format off */
@@ -226,6 +229,469 @@ restore_frame_sp_for_op_end(AOTBlock *block, AOTCompFrame *aot_frame)
     aot_frame->sp = block->frame_sp_begin;
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+static uint32
+read_uint32_leb(uint8 **p_buf)
+{
+    uint8 *p = *p_buf, byte;
+    uint32 result = 0, shift = 0;
+
+    /* The leb was checked in wasm loader */
+    do {
+        byte = *p++;
+        result |= ((uint32)(byte & 0x7F)) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    *p_buf = p;
+    return result;
+}
+
+static WASMFuncType *
+get_tag_type(AOTCompContext *comp_ctx, uint32 tag_index)
+{
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+
+    /* The tag index was checked in wasm loader */
+    if (tag_index < module->import_tag_count)
+        return module->import_tags[tag_index].u.tag.tag_type;
+    return module->tags[tag_index - module->import_tag_count]->tag_type;
+}
+
+static uint32
+get_max_tag_param_cell_num(AOTCompContext *comp_ctx)
+{
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+    WASMFuncType *tag_type;
+    uint32 tag_count = module->import_tag_count + module->tag_count;
+    uint32 i, j, cell_num, max_cell_num = 1;
+
+    for (i = 0; i < tag_count; i++) {
+        tag_type = get_tag_type(comp_ctx, i);
+        for (j = 0, cell_num = 0; j < tag_type->param_count; j++)
+            cell_num += wasm_value_type_cell_num_internal(
+                tag_type->types[j], comp_ctx->pointer_size);
+        if (cell_num > max_cell_num)
+            max_cell_num = cell_num;
+    }
+    return max_cell_num;
+}
+
+/* Create the buffer to hold the payload of the wasm exception in the
+   entry block of the function */
+static LLVMValueRef
+create_exce_payload_buf(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                        const char *name)
+{
+    LLVMBasicBlockRef block_curr = CURR_BLOCK();
+    LLVMBasicBlockRef entry_block = LLVMGetEntryBasicBlock(func_ctx->func);
+    LLVMValueRef first_inst, cell_num, buf;
+
+    if (!(cell_num = I32_CONST(get_max_tag_param_cell_num(comp_ctx)))) {
+        aot_set_last_error("llvm build const failed.");
+        return NULL;
+    }
+
+    if ((first_inst = LLVMGetFirstInstruction(entry_block)))
+        LLVMPositionBuilderBefore(comp_ctx->builder, first_inst);
+    else
+        SET_BUILDER_POS(entry_block);
+
+    if (!(buf = LLVMBuildArrayAlloca(comp_ctx->builder, I32_TYPE, cell_num,
+                                     name))) {
+        aot_set_last_error("llvm build alloca failed.");
+        return NULL;
+    }
+    LLVMSetAlignment(buf, 8);
+
+    SET_BUILDER_POS(block_curr);
+    return buf;
+}
+
+static LLVMValueRef
+get_exce_payload_addr(AOTCompContext *comp_ctx, LLVMValueRef payload_buf,
+                      uint32 cell_offset, LLVMTypeRef value_type)
+{
+    LLVMValueRef offset, value_addr;
+
+    if (!(offset = I32_CONST(cell_offset))) {
+        aot_set_last_error("llvm build const failed.");
+        return NULL;
+    }
+
+    if (!(value_addr =
+              LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE, payload_buf,
+                                    &offset, 1, "exce_payload_addr"))
+        || !(value_addr = LLVMBuildBitCast(comp_ctx->builder, value_addr,
+                                           LLVMPointerType(value_type, 0),
+                                           "exce_payload_ptr"))) {
+        aot_set_last_error("llvm build gep failed.");
+        return NULL;
+    }
+    return value_addr;
+}
+
+static bool
+call_throw_wasm_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          LLVMValueRef tag_index, LLVMValueRef payload_buf)
+{
+    LLVMTypeRef param_types[4], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[4], func;
+
+    param_types[0] = comp_ctx->exec_env_type;
+    param_types[1] = I32_TYPE;
+    param_types[2] = INT32_PTR_TYPE;
+    param_types[3] = I32_TYPE;
+    ret_type = VOID_TYPE;
+
+    GET_AOT_FUNCTION(wasm_runtime_throw_wasm_exception, 4);
+
+    param_values[0] = func_ctx->exec_env;
+    param_values[1] = tag_index;
+    param_values[2] = payload_buf;
+    if (!(param_values[3] = I32_CONST(get_max_tag_param_cell_num(comp_ctx)))) {
+        aot_set_last_error("llvm build const failed.");
+        goto fail;
+    }
+
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 4,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+    return true;
+fail:
+    return false;
+}
+
+static bool
+create_exce_landing_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          AOTBlock *block);
+
+/* Get the try block which handles the exceptions thrown inside the
+   block: search the block stack outward for the innermost try block
+   which has catch/catch_all handlers, the try blocks ended with
+   delegate forward the exceptions to the block of the delegate label */
+static AOTBlock *
+get_exce_handler_block(AOTBlock *block)
+{
+    uint32 i;
+
+    while (block) {
+        if (block->label_type == LABEL_TYPE_TRY) {
+            if (block->is_delegate) {
+                for (i = 0; i <= block->delegate_depth && block; i++)
+                    block = block->prev;
+                continue;
+            }
+            if (block->handler_count > 0)
+                return block;
+        }
+        block = block->prev;
+    }
+
+    return NULL;
+}
+
+/* Get the landing pad which handles the exceptions thrown inside the
+   block, create it if it isn't created */
+static bool
+get_exce_landing_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       AOTBlock *block, LLVMBasicBlockRef *p_landing_block)
+{
+    *p_landing_block = NULL;
+
+    if (!(block = get_exce_handler_block(block)))
+        return true;
+
+    if (!block->llvm_landing_block
+        && !create_exce_landing_block(comp_ctx, func_ctx, block))
+        return false;
+    *p_landing_block = block->llvm_landing_block;
+    return true;
+}
+
+/* Create the landing pad of the try block, which catches the exception,
+   and dispatches it to the matched catch/catch_all handler, or rethrows
+   it to the outer landing pad if no handler matches */
+static bool
+create_exce_landing_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          AOTBlock *block)
+{
+    LLVMBasicBlockRef block_curr = CURR_BLOCK();
+    LLVMBasicBlockRef outer_landing_block, dispatch_block, default_block;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
+    LLVMValueRef param_values[3], func, value, is_caught, switch_inst;
+    uint32 i, j, tag_index, case_count = 0;
+    uint32 *tag_indexes = NULL;
+    uint8 *frame_ip;
+    uint64 size;
+    char name[32];
+
+    bh_assert(block->label_type == LABEL_TYPE_TRY && block->handler_count > 0);
+
+    /* Get the landing pad of the outer block first to rethrow the
+       exception which isn't caught */
+    if (!get_exce_landing_block(comp_ctx, func_ctx, block->prev,
+                                &outer_landing_block)
+        || !aot_create_func_return_block(comp_ctx, func_ctx))
+        return false;
+    if (!outer_landing_block)
+        outer_landing_block = func_ctx->func_return_block;
+
+    size = sizeof(LLVMBasicBlockRef) * (uint64)block->handler_count;
+    if (size >= UINT32_MAX
+        || !(block->llvm_handler_blocks = wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(block->llvm_handler_blocks, 0, (uint32)size);
+
+    size = sizeof(uint32) * (uint64)block->handler_count;
+    if (size >= UINT32_MAX
+        || !(tag_indexes = wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    if (!(block->exce_payload_buf =
+              create_exce_payload_buf(comp_ctx, func_ctx, "exce_payload"))) {
+        goto fail;
+    }
+
+    snprintf(name, sizeof(name), "try%d_landing", block->block_index);
+    CREATE_BLOCK(block->llvm_landing_block, name);
+    snprintf(name, sizeof(name), "try%d_dispatch", block->block_index);
+    CREATE_BLOCK(dispatch_block, name);
+
+    for (i = 0; i < block->handler_count; i++) {
+        frame_ip = block->wasm_code_handlers[i];
+        if (*frame_ip++ == WASM_OP_CATCH) {
+            tag_indexes[i] = read_uint32_leb(&frame_ip);
+            snprintf(name, sizeof(name), "catch%d_%d", block->block_index, i);
+        }
+        else {
+            /* catch_all must be the last handler */
+            bh_assert(i == block->handler_count - 1);
+            tag_indexes[i] = UINT32_MAX;
+            snprintf(name, sizeof(name), "catch_all%d", block->block_index);
+        }
+        CREATE_BLOCK(block->llvm_handler_blocks[i], name);
+    }
+
+    /* Translate the landing block: catch the exception, and restore the
+       frames of the callees which threw it */
+    SET_BUILDER_POS(block->llvm_landing_block);
+
+    param_types[0] = comp_ctx->exec_env_type;
+    param_types[1] = INT32_PTR_TYPE;
+    param_types[2] = I32_TYPE;
+    ret_type = I32_TYPE;
+
+    GET_AOT_FUNCTION(wasm_runtime_catch_wasm_exception, 3);
+
+    param_values[0] = func_ctx->exec_env;
+    param_values[1] = block->exce_payload_buf;
+    if (!(param_values[2] = I32_CONST(get_max_tag_param_cell_num(comp_ctx)))) {
+        aot_set_last_error("llvm build const failed.");
+        goto fail;
+    }
+    if (!(block->exce_tag_index =
+              LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values,
+                             3, "exce_tag_index"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    if (!aot_restore_frame_for_exce_handling(comp_ctx, func_ctx))
+        goto fail;
+
+    /* The traps can't be caught, return directly */
+    BUILD_ICMP(LLVMIntSGE, block->exce_tag_index, I32_ZERO, is_caught,
+               "is_caught");
+    BUILD_COND_BR(is_caught, dispatch_block, func_ctx->func_return_block);
+
+    /* Translate the dispatch block */
+    SET_BUILDER_POS(dispatch_block);
+
+    if (tag_indexes[block->handler_count - 1] == UINT32_MAX) {
+        default_block = block->llvm_handler_blocks[block->handler_count - 1];
+    }
+    else {
+        /* No catch_all handler, rethrow the exception if no catch
+           handler matches */
+        snprintf(name, sizeof(name), "try%d_rethrow", block->block_index);
+        CREATE_BLOCK(default_block, name);
+    }
+
+    for (i = 0; i < block->handler_count; i++) {
+        if (tag_indexes[i] != UINT32_MAX)
+            case_count++;
+    }
+
+    if (!(switch_inst = LLVMBuildSwitch(comp_ctx->builder,
+                                        block->exce_tag_index, default_block,
+                                        case_count))) {
+        aot_set_last_error("llvm build switch failed.");
+        goto fail;
+    }
+
+    for (i = 0; i < block->handler_count; i++) {
+        tag_index = tag_indexes[i];
+        if (tag_index == UINT32_MAX)
+            continue;
+        /* Only the first handler of the same tag can be reached */
+        for (j = 0; j < i; j++) {
+            if (tag_indexes[j] == tag_index)
+                break;
+        }
+        if (j < i)
+            continue;
+        if (!(value = I32_CONST(tag_index))) {
+            aot_set_last_error("llvm build const failed.");
+            goto fail;
+        }
+        LLVMAddCase(switch_inst, value, block->llvm_handler_blocks[i]);
+    }
+
+    if (default_block != block->llvm_handler_blocks[block->handler_count - 1]) {
+        SET_BUILDER_POS(default_block);
+        if (!call_throw_wasm_exception(comp_ctx, func_ctx,
+                                       block->exce_tag_index,
+                                       block->exce_payload_buf))
+            goto fail;
+        BUILD_BR(outer_landing_block);
+    }
+
+    SET_BUILDER_POS(block_curr);
+    wasm_runtime_free(tag_indexes);
+    return true;
+fail:
+    wasm_runtime_free(tag_indexes);
+    return false;
+}
+
+/* Switch to translate the next catch/catch_all handler of the try block
+   if there is and the handler is reachable */
+static bool
+switch_to_next_exce_handler(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                            AOTBlock *block, uint8 **p_frame_ip,
+                            bool *p_switched)
+{
+    AOTCompFrame *aot_frame = comp_ctx->aot_frame;
+    WASMFuncType *tag_type;
+    LLVMValueRef value, value_addr;
+    LLVMTypeRef value_type;
+    uint8 *frame_ip;
+    uint32 i, j, tag_index, cell_offset = 0;
+
+    *p_switched = false;
+
+    if ((block->label_type != LABEL_TYPE_TRY
+         && block->label_type != LABEL_TYPE_CATCH)
+        || !block->llvm_landing_block)
+        /* The handlers are unreachable if no exception can be thrown
+           inside the try block */
+        return true;
+
+    for (i = 0; i < block->handler_count; i++) {
+        if (block->wasm_code_handlers[i] >= *p_frame_ip)
+            break;
+    }
+    if (i == block->handler_count)
+        return true;
+
+    /* Clear value stack and start to translate the handler */
+    aot_value_stack_destroy(comp_ctx, &block->value_stack);
+
+    if (aot_frame) {
+        clear_frame_locals(aot_frame);
+        restore_frame_sp_for_op_else(block, aot_frame);
+    }
+
+    SET_BUILDER_POS(block->llvm_handler_blocks[i]);
+
+    frame_ip = block->wasm_code_handlers[i];
+    if (*frame_ip++ == WASM_OP_CATCH) {
+        /* Push the payload of the exception caught */
+        tag_index = read_uint32_leb(&frame_ip);
+        tag_type = get_tag_type(comp_ctx, tag_index);
+        for (j = 0; j < tag_type->param_count; j++) {
+            value_type = TO_LLVM_TYPE(tag_type->types[j]);
+            if (!(value_addr = get_exce_payload_addr(
+                      comp_ctx, block->exce_payload_buf, cell_offset,
+                      value_type)))
+                return false;
+            if (!(value = LLVMBuildLoad2(comp_ctx->builder, value_type,
+                                         value_addr, "exce_payload"))) {
+                aot_set_last_error("llvm build load failed.");
+                return false;
+            }
+            LLVMSetAlignment(value, 4);
+            PUSH(value, tag_type->types[j]);
+            cell_offset += wasm_value_type_cell_num_internal(
+                tag_type->types[j], comp_ctx->pointer_size);
+        }
+        block->label_type = LABEL_TYPE_CATCH;
+    }
+    else {
+        block->label_type = LABEL_TYPE_CATCH_ALL;
+    }
+
+    *p_frame_ip = frame_ip;
+    *p_switched = true;
+    return true;
+fail:
+    return false;
+}
+
+/* Find the catch/catch_all handlers of the try block, and the end
+   of the try block */
+static bool
+find_try_block_handlers(AOTBlock *block, uint8 *frame_ip_end,
+                        BlockAddr *block_addr_cache)
+{
+    uint8 *p = block->wasm_code_end, *else_addr, *end_addr, **handlers;
+    uint64 size;
+
+    /* wasm_code_end points to the first catch/catch_all/delegate/end
+       opcode of the try block now */
+    while (*p == WASM_OP_CATCH || *p == WASM_OP_CATCH_ALL) {
+        size = sizeof(uint8 *) * ((uint64)block->handler_count + 1);
+        if (size >= UINT32_MAX
+            || !(handlers = wasm_runtime_realloc(block->wasm_code_handlers,
+                                                 (uint32)size))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        block->wasm_code_handlers = handlers;
+        block->wasm_code_handlers[block->handler_count++] = p;
+
+        if (*p++ == WASM_OP_CATCH)
+            read_uint32_leb(&p);
+
+        if (!wasm_loader_find_block_addr(NULL, block_addr_cache, p,
+                                         frame_ip_end, LABEL_TYPE_TRY,
+                                         &else_addr, &end_addr)) {
+            aot_set_last_error("find block end addr failed.");
+            return false;
+        }
+        p = end_addr;
+    }
+
+    if (*p == WASM_OP_DELEGATE) {
+        p++;
+        block->is_delegate = true;
+        block->delegate_depth = read_uint32_leb(&p);
+        /* Let wasm_code_end point to the last byte of delegate opcode */
+        p--;
+    }
+
+    block->wasm_code_end = p;
+    return true;
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 static bool
 handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             uint8 **p_frame_ip)
@@ -237,6 +703,9 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     uint32 i;
     AOTFuncType *func_type;
     LLVMValueRef ret;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    bool switched;
+#endif
 #if WASM_ENABLE_DEBUG_AOT != 0
     LLVMMetadataRef return_location;
 #endif
@@ -274,6 +743,14 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     while (block && !block->is_reachable) {
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        if (!switch_to_next_exce_handler(comp_ctx, func_ctx, block, p_frame_ip,
+                                         &switched))
+            return false;
+        if (switched)
+            return true;
+#endif
+
         block_prev = block->prev;
         block = aot_block_stack_pop(&func_ctx->block_stack);
 
@@ -333,6 +810,14 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         return true;
     }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (!switch_to_next_exce_handler(comp_ctx, func_ctx, block, p_frame_ip,
+                                     &switched))
+        return false;
+    if (switched)
+        return true;
+#endif
+
     *p_frame_ip = block->wasm_code_end + 1;
     SET_BUILDER_POS(block->llvm_end_block);
 
@@ -583,6 +1068,13 @@ aot_compile_op_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     block->block_index = func_ctx->block_stack.block_index[label_type];
     func_ctx->block_stack.block_index[label_type]++;
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (label_type == LABEL_TYPE_TRY
+        && !find_try_block_handlers(block, frame_ip_end,
+                                    (BlockAddr *)block_addr_cache))
+        goto fail;
+#endif
+
     if (comp_ctx->aot_frame) {
         if (label_type != LABEL_TYPE_BLOCK && comp_ctx->enable_gc
             && !aot_gen_commit_values(comp_ctx->aot_frame)) {
@@ -590,7 +1082,11 @@ aot_compile_op_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
     }
 
-    if (label_type == LABEL_TYPE_BLOCK || label_type == LABEL_TYPE_LOOP) {
+    if (label_type == LABEL_TYPE_BLOCK || label_type == LABEL_TYPE_LOOP
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        || label_type == LABEL_TYPE_TRY
+#endif
+    ) {
         /* Create block */
         format_block_name(name, sizeof(name), block->block_index, label_type,
                           LABEL_BEGIN);
@@ -845,6 +1341,183 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+bool
+aot_compile_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint8 **p_frame_ip)
+{
+    AOTBlock *block;
+    LLVMValueRef value;
+    LLVMBasicBlockRef next_llvm_end_block;
+    char name[32];
+    uint32 i, result_index;
+
+    /* Check block stack */
+    if (!(block = func_ctx->block_stack.block_list_end)) {
+        aot_set_last_error("WASM block stack underflow.");
+        return false;
+    }
+    if (block->label_type != LABEL_TYPE_TRY
+        && block->label_type != LABEL_TYPE_CATCH) {
+        aot_set_last_error("Invalid WASM block type.");
+        return false;
+    }
+
+    /* Create the end block */
+    if (!block->llvm_end_block) {
+        format_block_name(name, sizeof(name), block->block_index,
+                          block->label_type, LABEL_END);
+        CREATE_BLOCK(block->llvm_end_block, name);
+        if ((next_llvm_end_block = find_next_llvm_end_block(block)))
+            MOVE_BLOCK_BEFORE(block->llvm_end_block, next_llvm_end_block);
+    }
+
+    if (comp_ctx->aot_frame) {
+        if (comp_ctx->enable_gc
+            && !aot_gen_commit_values(comp_ctx->aot_frame)) {
+            return false;
+        }
+    }
+
+    /* Handle block result values of the try block or the previous
+       catch handler */
+    CREATE_RESULT_VALUE_PHIS(block);
+    for (i = 0; i < block->result_count; i++) {
+        value = NULL;
+        result_index = block->result_count - 1 - i;
+        POP(value, block->result_types[result_index]);
+        bh_assert(value);
+        ADD_TO_RESULT_PHIS(block, value, result_index);
+    }
+
+    /* Jump to the end block */
+    BUILD_BR(block->llvm_end_block);
+
+    block->is_reachable = true;
+
+    /* Let frame_ip point to the catch/catch_all opcode, and switch to
+       translate the handler if it is reachable */
+    *p_frame_ip = *p_frame_ip - 1;
+    return handle_next_reachable_block(comp_ctx, func_ctx, p_frame_ip);
+fail:
+    return false;
+}
+
+bool
+aot_compile_op_throw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint32 tag_index, uint8 **p_frame_ip)
+{
+    WASMFuncType *tag_type = get_tag_type(comp_ctx, tag_index);
+    LLVMBasicBlockRef landing_block;
+    LLVMValueRef value, value_addr, payload_buf, tag_index_value;
+    uint32 i, cell_offset = 0;
+    uint8 value_type;
+
+    /* All the throw opcodes of the function share the same buffer since
+       the payload is copied to exec_env when the exception is thrown */
+    if (!func_ctx->exce_throw_payload_buf
+        && !(func_ctx->exce_throw_payload_buf = create_exce_payload_buf(
+                 comp_ctx, func_ctx, "throw_payload")))
+        return false;
+    payload_buf = func_ctx->exce_throw_payload_buf;
+
+    for (i = 0; i < tag_type->param_count; i++)
+        cell_offset += wasm_value_type_cell_num_internal(
+            tag_type->types[i], comp_ctx->pointer_size);
+
+    /* Pop the payload of the exception and store it to the buffer */
+    for (i = tag_type->param_count; i > 0; i--) {
+        value_type = tag_type->types[i - 1];
+        cell_offset -= wasm_value_type_cell_num_internal(
+            value_type, comp_ctx->pointer_size);
+        POP(value, value_type);
+        if (!(value_addr = get_exce_payload_addr(
+                  comp_ctx, payload_buf, cell_offset, LLVMTypeOf(value))))
+            return false;
+        if (!(value = LLVMBuildStore(comp_ctx->builder, value, value_addr))) {
+            aot_set_last_error("llvm build store failed.");
+            return false;
+        }
+        LLVMSetAlignment(value, 4);
+    }
+
+    if (!(tag_index_value = I32_CONST(tag_index))) {
+        aot_set_last_error("llvm build const failed.");
+        return false;
+    }
+
+    if (!call_throw_wasm_exception(comp_ctx, func_ctx, tag_index_value,
+                                   payload_buf)
+        || !aot_get_exception_landing_block(comp_ctx, func_ctx,
+                                            &landing_block))
+        return false;
+
+    if (!landing_block) {
+        if (!aot_create_func_return_block(comp_ctx, func_ctx))
+            return false;
+        landing_block = func_ctx->func_return_block;
+    }
+    BUILD_BR(landing_block);
+
+    return handle_next_reachable_block(comp_ctx, func_ctx, p_frame_ip);
+fail:
+    return false;
+}
+
+bool
+aot_compile_op_rethrow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       uint32 br_depth, uint8 **p_frame_ip)
+{
+    AOTBlock *block_dst;
+    LLVMBasicBlockRef landing_block;
+
+    if (!(block_dst = get_target_block(func_ctx, br_depth))) {
+        return false;
+    }
+    if (block_dst->label_type != LABEL_TYPE_CATCH
+        && block_dst->label_type != LABEL_TYPE_CATCH_ALL) {
+        aot_set_last_error("Invalid WASM block type.");
+        return false;
+    }
+
+    /* Rethrow the exception caught by the landing pad of the block */
+    if (!call_throw_wasm_exception(comp_ctx, func_ctx,
+                                   block_dst->exce_tag_index,
+                                   block_dst->exce_payload_buf)
+        || !aot_get_exception_landing_block(comp_ctx, func_ctx,
+                                            &landing_block))
+        return false;
+
+    if (!landing_block) {
+        if (!aot_create_func_return_block(comp_ctx, func_ctx))
+            return false;
+        landing_block = func_ctx->func_return_block;
+    }
+    BUILD_BR(landing_block);
+
+    return handle_next_reachable_block(comp_ctx, func_ctx, p_frame_ip);
+fail:
+    return false;
+}
+
+bool
+aot_get_exception_landing_block(AOTCompContext *comp_ctx,
+                                AOTFuncContext *func_ctx,
+                                LLVMBasicBlockRef *p_landing_block)
+{
+    return get_exce_landing_block(comp_ctx, func_ctx,
+                                  func_ctx->block_stack.block_list_end,
+                                  p_landing_block);
+}
+
+bool
+aot_is_in_exception_handler_scope(AOTFuncContext *func_ctx)
+{
+    return get_exce_handler_block(func_ctx->block_stack.block_list_end)
+           != NULL;
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 bool
 check_suspend_flags(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     bool check_terminate_and_suspend)
@@ -50,6 +50,33 @@ bool
 aot_handle_next_reachable_block(AOTCompContext *comp_ctx,
                                 AOTFuncContext *func_ctx, uint8 **p_frame_ip);
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+bool
+aot_compile_op_catch(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint8 **p_frame_ip);
+
+bool
+aot_compile_op_throw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                     uint32 tag_index, uint8 **p_frame_ip);
+
+bool
+aot_compile_op_rethrow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                       uint32 br_depth, uint8 **p_frame_ip);
+
+/* Get the landing pad which handles the exceptions thrown at current
+   position, NULL is returned if the exceptions should be propagated to
+   the caller */
+bool
+aot_get_exception_landing_block(AOTCompContext *comp_ctx,
+                                AOTFuncContext *func_ctx,
+                                LLVMBasicBlockRef *p_landing_block);
+
+/* Whether the exceptions thrown at current position are handled by an
+   enclosing try block of the function */
+bool
+aot_is_in_exception_handler_scope(AOTFuncContext *func_ctx);
+#endif
+
 bool
 check_suspend_flags(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     bool check_terminate_and_suspend);
@@ -53,7 +53,7 @@ aot_emit_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                    LLVMBasicBlockRef cond_br_else_block)
 {
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
-    LLVMValueRef exce_id = I32_CONST((uint32)exception_id), func_const, func;
+    LLVMValueRef exce_id = I32_CONST((uint32)exception_id), func;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
     LLVMValueRef param_values[2];
     bool is_64bit = (comp_ctx->pointer_size == sizeof(uint64)) ? true : false;
@@ -108,16 +108,10 @@ aot_emit_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
 
         if (comp_ctx->is_jit_mode) {
-            /* Create function type */
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-                aot_set_last_error("create LLVM function type failed.");
-                return false;
-            }
             /* Create LLVM function with const function pointer */
-            if (!(func_const =
-                      I64_CONST((uint64)(uintptr_t)jit_set_exception_with_id))
-                || !(func = LLVMConstIntToPtr(func_const, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_func_ref(
+                      comp_ctx, "jit_set_exception_with_id",
+                      (void *)jit_set_exception_with_id, func_type))) {
                 return false;
             }
         }
@@ -187,10 +181,8 @@ aot_emit_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     I32_CONST((uint32)(uintptr_t)(ip - module->load_addr));
         }
         else {
-            if (is_64bit)
-                exce_ip = I64_CONST((uint64)(uintptr_t)ip);
-            else
-                exce_ip = I32_CONST((uint32)(uintptr_t)ip);
+            exce_ip = aot_get_jit_bytecode_addr(
+                comp_ctx, ip, is_64bit ? I64_TYPE : I32_TYPE);
         }
 
         if (!exce_ip) {
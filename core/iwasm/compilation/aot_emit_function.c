@@ -35,8 +35,37 @@ is_win_platform(AOTCompContext *comp_ctx)
     return ret;
 }
 
+/* Whether the wasm exception thrown by the callee may be returned to
+   the caller: the module declares tags, or the call is inside a try
+   block */
 static bool
-create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+need_check_wasm_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+
+    if (comp_ctx->enable_exce_handling
+        && (module->import_tag_count + module->tag_count > 0
+            || aot_is_in_exception_handler_scope(func_ctx)))
+        return true;
+#endif
+    return false;
+}
+
+/* Whether to check the exception after calling a function: the
+   exception is checked after the call returns if the software bound
+   check is enabled, or on Windows platform, or the wasm exception
+   thrown by the callee may be returned to the caller */
+static bool
+need_check_call_exception(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    return comp_ctx->enable_bound_check || is_win_platform(comp_ctx)
+           || need_check_wasm_exception(comp_ctx, func_ctx);
+}
+
+bool
+aot_create_func_return_block(AOTCompContext *comp_ctx,
+                             AOTFuncContext *func_ctx)
 {
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
@@ -52,7 +81,10 @@ create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         /* Create return IR */
         LLVMPositionBuilderAtEnd(comp_ctx->builder,
                                  func_ctx->func_return_block);
-        if (!comp_ctx->enable_bound_check) {
+        /* The wasm exception thrown by the callee may be caught by
+           the caller, so don't jump to the top when exception handling
+           is enabled */
+        if (!comp_ctx->enable_bound_check && !comp_ctx->enable_exce_handling) {
             if (!aot_emit_exception(comp_ctx, func_ctx, EXCE_ALREADY_THROWN,
                                     false, NULL, NULL)) {
                 return false;
@@ -68,15 +100,41 @@ create_func_return_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     return true;
 }
 
+/* Get the block to jump to when an exception was thrown by the callee:
+   the landing pad of the innermost enclosing try block if there is,
+   or the function return block */
+static bool
+get_exception_target_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           LLVMBasicBlockRef *p_target_block)
+{
+    /* Create function return block if it isn't created */
+    if (!aot_create_func_return_block(comp_ctx, func_ctx))
+        return false;
+
+    *p_target_block = func_ctx->func_return_block;
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (comp_ctx->enable_exce_handling) {
+        LLVMBasicBlockRef landing_block;
+
+        if (!aot_get_exception_landing_block(comp_ctx, func_ctx,
+                                             &landing_block))
+            return false;
+        if (landing_block)
+            *p_target_block = landing_block;
+    }
+#endif
+    return true;
+}
+
 /* Check whether there was exception thrown, if yes, return directly */
 static bool
 check_exception_thrown(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 {
-    LLVMBasicBlockRef block_curr, check_exce_succ;
+    LLVMBasicBlockRef block_curr, check_exce_succ, exce_target_block;
     LLVMValueRef value, cmp;
 
-    /* Create function return block if it isn't created */
-    if (!create_func_return_block(comp_ctx, func_ctx))
+    if (!get_exception_target_block(comp_ctx, func_ctx, &exce_target_block))
         return false;
 
     /* Load the first byte of aot_module_inst->cur_exception, and check
@@ -102,7 +160,7 @@ check_exception_thrown(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     LLVMPositionBuilderAtEnd(comp_ctx->builder, block_curr);
     /* Create condition br */
     if (!LLVMBuildCondBr(comp_ctx->builder, cmp, check_exce_succ,
-                         func_ctx->func_return_block)) {
+                         exce_target_block)) {
         aot_set_last_error("llvm build cond br failed.");
         return false;
     }
@@ -116,11 +174,10 @@ static bool
 check_call_return(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                   LLVMValueRef res)
 {
-    LLVMBasicBlockRef block_curr, check_call_succ;
+    LLVMBasicBlockRef block_curr, check_call_succ, exce_target_block;
     LLVMValueRef cmp;
 
-    /* Create function return block if it isn't created */
-    if (!create_func_return_block(comp_ctx, func_ctx))
+    if (!get_exception_target_block(comp_ctx, func_ctx, &exce_target_block))
         return false;
 
     if (!(cmp = LLVMBuildICmp(comp_ctx->builder, LLVMIntNE, res, I8_ZERO,
@@ -142,7 +199,7 @@ check_call_return(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMPositionBuilderAtEnd(comp_ctx->builder, block_curr);
     /* Create condition br */
     if (!LLVMBuildCondBr(comp_ctx->builder, cmp, check_call_succ,
-                         func_ctx->func_return_block)) {
+                         exce_target_block)) {
         aot_set_last_error("llvm build cond br failed.");
         return false;
     }
@@ -180,15 +237,10 @@ call_aot_invoke_native_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func = I64_CONST((uint64)(uintptr_t)llvm_jit_invoke_native))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_func_ref(comp_ctx, "llvm_jit_invoke_native",
+                                          (void *)llvm_jit_invoke_native,
+                                          func_type))) {
             return false;
         }
     }
@@ -441,7 +493,8 @@ call_aot_invoke_c_api_native(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     /* Check whether exception was thrown when executing the function */
-    if (comp_ctx->enable_bound_check
+    if ((comp_ctx->enable_bound_check
+         || need_check_wasm_exception(comp_ctx, func_ctx))
         && !check_call_return(comp_ctx, func_ctx, res)) {
         goto fail;
     }
@@ -500,7 +553,7 @@ static bool
 call_aot_alloc_frame_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           LLVMValueRef func_idx)
 {
-    LLVMValueRef param_values[2], ret_value, value, func;
+    LLVMValueRef param_values[2], ret_value, func;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef frame_alloc_fail, frame_alloc_success;
@@ -560,6 +613,49 @@ fail:
     return false;
 }
 
+static void
+get_frame_size_for_aot_func(AOTCompContext *comp_ctx,
+                            uint32 max_local_cell_num,
+                            uint32 max_stack_cell_num, uint32 *p_frame_size,
+                            uint32 *p_frame_size_with_outs_area)
+{
+    uint32 aot_frame_ptr_num = offsetof(AOTFrame, lp) / sizeof(uintptr_t);
+    uint32 all_cell_num = max_local_cell_num + max_stack_cell_num;
+    uint32 frame_size, frame_size_with_outs_area;
+
+    if (!comp_ctx->is_jit_mode) {
+        /* Refer to aot_alloc_frame */
+        if (!comp_ctx->enable_gc) {
+            frame_size = frame_size_with_outs_area =
+                comp_ctx->pointer_size * aot_frame_ptr_num;
+        }
+        else {
+            frame_size = comp_ctx->pointer_size * aot_frame_ptr_num
+                         + align_uint(all_cell_num * 5, 4);
+            frame_size_with_outs_area =
+                frame_size + comp_ctx->pointer_size * aot_frame_ptr_num
+                + max_stack_cell_num * 4;
+        }
+    }
+    else {
+        /* Refer to wasm_interp_interp_frame_size */
+        if (!comp_ctx->enable_gc) {
+            frame_size = frame_size_with_outs_area =
+                offsetof(WASMInterpFrame, lp);
+        }
+        else {
+            frame_size =
+                offsetof(WASMInterpFrame, lp) + align_uint(all_cell_num * 5, 4);
+            frame_size_with_outs_area = frame_size
+                                        + offsetof(WASMInterpFrame, lp)
+                                        + max_stack_cell_num * 4;
+        }
+    }
+
+    *p_frame_size = frame_size;
+    *p_frame_size_with_outs_area = frame_size_with_outs_area;
+}
+
 static bool
 alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                          uint32 func_idx)
@@ -576,8 +672,7 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     uint32 import_func_count = comp_ctx->comp_data->import_func_count;
     uint32 param_cell_num = 0, local_cell_num = 0, i;
     uint32 max_local_cell_num, max_stack_cell_num;
-    uint32 all_cell_num, frame_size, frame_size_with_outs_area;
-    uint32 aot_frame_ptr_num = offsetof(AOTFrame, lp) / sizeof(uintptr_t);
+    uint32 frame_size, frame_size_with_outs_area;
     AOTImportFunc *import_funcs = comp_ctx->comp_data->import_funcs;
     AOTFuncType *aot_func_type;
     AOTFunc *aot_func = NULL;
@@ -606,38 +701,11 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         max_stack_cell_num = aot_func->max_stack_cell_num;
     }
 
-    all_cell_num = max_local_cell_num + max_stack_cell_num;
-
     /* Get size of the frame to allocate and get size with outs_area to
        check whether wasm operand stack is overflow */
-    if (!comp_ctx->is_jit_mode) {
-        /* Refer to aot_alloc_frame */
-        if (!comp_ctx->enable_gc) {
-            frame_size = frame_size_with_outs_area =
-                comp_ctx->pointer_size * aot_frame_ptr_num;
-        }
-        else {
-            frame_size = comp_ctx->pointer_size * aot_frame_ptr_num
-                         + align_uint(all_cell_num * 5, 4);
-            frame_size_with_outs_area =
-                frame_size + comp_ctx->pointer_size * aot_frame_ptr_num
-                + max_stack_cell_num * 4;
-        }
-    }
-    else {
-        /* Refer to wasm_interp_interp_frame_size */
-        if (!comp_ctx->enable_gc) {
-            frame_size = frame_size_with_outs_area =
-                offsetof(WASMInterpFrame, lp);
-        }
-        else {
-            frame_size =
-                offsetof(WASMInterpFrame, lp) + align_uint(all_cell_num * 5, 4);
-            frame_size_with_outs_area = frame_size
-                                        + offsetof(WASMInterpFrame, lp)
-                                        + max_stack_cell_num * 4;
-        }
-    }
+    get_frame_size_for_aot_func(comp_ctx, max_local_cell_num,
+                                max_stack_cell_num, &frame_size,
+                                &frame_size_with_outs_area);
 
     cur_frame = func_ctx->cur_frame;
 
@@ -705,6 +773,7 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 #if WASM_ENABLE_GC != 0
     if (comp_ctx->enable_gc) {
         LLVMValueRef wasm_stack_top_new, frame_ref, frame_ref_ptr;
+        uint32 aot_frame_ptr_num = offsetof(AOTFrame, lp) / sizeof(uintptr_t);
         uint32 j, k;
 
         /* exec_env->wasm_stack.top += frame_size */
@@ -981,18 +1050,13 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-                aot_set_last_error("create LLVM function type failed.");
-                return false;
-            }
-
 #if WASM_ENABLE_JIT != 0 \
     && (WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_MEMORY_PROFILING != 0)
             /* JIT mode, call the function directly */
-            if (!(func = I64_CONST(
-                      (uint64)(uintptr_t)llvm_jit_frame_update_profile_info))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_func_ref(
+                      comp_ctx, "llvm_jit_frame_update_profile_info",
+                      (void *)llvm_jit_frame_update_profile_info,
+                      func_type))) {
                 return false;
             }
 #endif
@@ -1069,18 +1133,13 @@ free_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-                aot_set_last_error("create LLVM function type failed.");
-                return false;
-            }
-
 #if WASM_ENABLE_JIT != 0 \
     && (WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_MEMORY_PROFILING != 0)
             /* JIT mode, call the function directly */
-            if (!(func = I64_CONST(
-                      (uint64)(uintptr_t)llvm_jit_frame_update_profile_info))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_func_ref(
+                      comp_ctx, "llvm_jit_frame_update_profile_info",
+                      (void *)llvm_jit_frame_update_profile_info,
+                      func_type))) {
                 return false;
             }
 #endif
@@ -1146,6 +1205,59 @@ free_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 }
 #endif /* end of WASM_ENABLE_AOT_STACK_FRAME != 0 */
 
+#if WASM_ENABLE_EXCE_HANDLING != 0
+bool
+aot_restore_frame_for_exce_handling(AOTCompContext *comp_ctx,
+                                    AOTFuncContext *func_ctx)
+{
+#if WASM_ENABLE_AOT_STACK_FRAME != 0
+    AOTFunc *aot_func = func_ctx->aot_func;
+    LLVMValueRef wasm_stack_top, offset;
+    uint32 frame_size, frame_size_with_outs_area;
+
+    if (!comp_ctx->enable_aux_stack_frame)
+        return true;
+
+    /* The frames of the callees which threw the exception weren't
+       freed, restore exec_env->wasm_stack.top to the end of current
+       frame and exec_env->cur_frame to current frame */
+    if (comp_ctx->enable_gc) {
+        get_frame_size_for_aot_func(
+            comp_ctx, aot_func->param_cell_num + aot_func->local_cell_num,
+            aot_func->max_stack_cell_num, &frame_size,
+            &frame_size_with_outs_area);
+
+        offset = I32_CONST(frame_size);
+        CHECK_LLVM_CONST(offset);
+        if (!(wasm_stack_top = LLVMBuildInBoundsGEP2(
+                  comp_ctx->builder, INT8_TYPE, func_ctx->cur_frame, &offset,
+                  1, "wasm_stack_top"))) {
+            aot_set_last_error("llvm build in bounds gep failed");
+            return false;
+        }
+        if (!LLVMBuildStore(comp_ctx->builder, wasm_stack_top,
+                            func_ctx->wasm_stack_top_ptr)) {
+            aot_set_last_error("llvm build store failed");
+            return false;
+        }
+    }
+
+    if (!LLVMBuildStore(comp_ctx->builder, func_ctx->cur_frame,
+                        func_ctx->cur_frame_ptr)) {
+        aot_set_last_error("llvm build store failed");
+        return false;
+    }
+    return true;
+fail:
+    return false;
+#else
+    (void)comp_ctx;
+    (void)func_ctx;
+    return true;
+#endif
+}
+#endif /* end of WASM_ENABLE_EXCE_HANDLING != 0 */
+
 /**
  * Check whether the app address and its buffer are inside the linear memory,
  * if no, throw exception
@@ -1175,16 +1287,10 @@ check_app_addr_and_convert(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func =
-                  I64_CONST((uint64)(uintptr_t)jit_check_app_addr_and_convert))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_func_ref(
+                  comp_ctx, "jit_check_app_addr_and_convert",
+                  (void *)jit_check_app_addr_and_convert, func_type))) {
             return false;
         }
     }
@@ -1238,7 +1344,7 @@ check_app_addr_and_convert(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+    if (need_check_call_exception(comp_ctx, func_ctx)
         && !check_call_return(comp_ctx, func_ctx, res)) {
         return false;
     }
@@ -1632,7 +1738,7 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     goto fail;
                 /* Check whether there was exception thrown when executing
                    the function */
-                if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+                if (need_check_call_exception(comp_ctx, func_ctx)
                     && !check_call_return(comp_ctx, func_ctx, res))
                     goto fail;
             }
@@ -1783,7 +1889,7 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         /* Check whether there was exception thrown when executing
            the function */
         if (!tail_call
-            && (comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+            && need_check_call_exception(comp_ctx, func_ctx)
             && !check_exception_thrown(comp_ctx, func_ctx))
             goto fail;
     }
@@ -1833,7 +1939,7 @@ call_aot_func_type_is_super_of_func(AOTCompContext *comp_ctx,
                                     LLVMValueRef type_idx1,
                                     LLVMValueRef type_idx2)
 {
-    LLVMValueRef param_values[3], ret_value, value, func;
+    LLVMValueRef param_values[3], ret_value, func;
     LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
 
     param_types[0] = comp_ctx->aot_inst_type;
@@ -1904,15 +2010,10 @@ call_aot_call_indirect_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func = I64_CONST((uint64)(uintptr_t)llvm_jit_call_indirect))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_func_ref(comp_ctx, "llvm_jit_call_indirect",
+                                          (void *)llvm_jit_call_indirect,
+                                          func_type))) {
             return false;
         }
     }
@@ -2030,6 +2131,129 @@ call_aot_call_indirect_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+static bool
+is_call_indirect_spec_enabled(const AOTCompContext *comp_ctx, uint32 tbl_idx)
+{
+    /* The speculative call is emitted for both the instrumented build and
+       the profile use build, so that the CFG checksums of the functions
+       are the same when the profile is annotated */
+    return (comp_ctx->enable_llvm_pgo || comp_ctx->use_prof_file)
+           && !comp_ctx->is_jit_mode && !comp_ctx->enable_gc
+           && aot_is_table_content_fixed(comp_ctx->comp_data, tbl_idx);
+}
+
+static LLVMValueRef
+call_spec_placeholder(AOTCompContext *comp_ctx, const char *name,
+                      LLVMTypeRef ret_type, LLVMValueRef *param_values,
+                      uint32 param_count, const char *value_name)
+{
+    LLVMTypeRef param_types[2], func_type;
+    LLVMValueRef func, value;
+    uint32 i;
+
+    bh_assert(param_count <= 2);
+    for (i = 0; i < param_count; i++)
+        param_types[i] = I32_TYPE;
+
+    if (!(func_type =
+              LLVMFunctionType(ret_type, param_types, param_count, false))) {
+        aot_set_last_error("llvm add function type failed.");
+        return NULL;
+    }
+
+    if (!(func = LLVMGetNamedFunction(comp_ctx->module, name))
+        && !(func = LLVMAddFunction(comp_ctx->module, name,
+                                    func_type))) {
+        aot_set_last_error("llvm add function failed.");
+        return NULL;
+    }
+
+    if (!(value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                                 param_values, param_count, value_name))) {
+        aot_set_last_error("llvm build call failed.");
+        return NULL;
+    }
+
+    return value;
+}
+
+static bool
+set_call_indirect_site_info(AOTCompContext *comp_ctx, LLVMValueRef call,
+                            LLVMValueRef site, uint32 tbl_idx, uint32 type_idx)
+{
+    LLVMMetadataRef md_nodes[3], meta_data;
+    unsigned kind_id;
+
+    md_nodes[0] = LLVMValueAsMetadata(site);
+    md_nodes[1] = LLVMValueAsMetadata(I32_CONST(tbl_idx));
+    md_nodes[2] = LLVMValueAsMetadata(I32_CONST(type_idx));
+
+    if (!(meta_data = LLVMMDNodeInContext2(comp_ctx->context, md_nodes, 3))) {
+        aot_set_last_error("llvm create metadata node failed.");
+        return false;
+    }
+
+    kind_id = LLVMGetMDKindIDInContext(comp_ctx->context,
+                                       AOT_CALL_INDIRECT_MD_KIND,
+                                       (uint32)strlen(AOT_CALL_INDIRECT_MD_KIND));
+    LLVMSetMetadata(call, kind_id,
+                    LLVMMetadataAsValue(comp_ctx->context, meta_data));
+    return true;
+}
+
+/* Call the non-import function of call_indirect, check the exception
+   thrown and add the results to the result phis of the return block */
+static bool
+call_indirect_non_import_func(AOTCompContext *comp_ctx,
+                              AOTFuncContext *func_ctx, AOTFuncType *func_type,
+                              LLVMTypeRef llvm_func_type, LLVMValueRef func,
+                              LLVMValueRef *param_values,
+                              uint32 total_param_count,
+                              LLVMValueRef *result_phis, LLVMValueRef *p_call)
+{
+    uint32 func_param_count = func_type->param_count;
+    uint32 func_result_count = func_type->result_count, i;
+    LLVMValueRef value_ret, ext_ret;
+    LLVMBasicBlockRef block_curr;
+    LLVMTypeRef ret_type;
+    char buf[32];
+
+    if (!(value_ret = LLVMBuildCall2(comp_ctx->builder, llvm_func_type, func,
+                                     param_values, total_param_count,
+                                     func_result_count > 0 ? "ret" : ""))) {
+        aot_set_last_error("llvm build call failed.");
+        return false;
+    }
+
+    /* Check whether exception was thrown when executing the function */
+    if (need_check_call_exception(comp_ctx, func_ctx)
+        && !check_exception_thrown(comp_ctx, func_ctx))
+        return false;
+
+    if (func_result_count > 0) {
+        block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+
+        /* Push the first result to stack */
+        LLVMAddIncoming(result_phis[0], &value_ret, &block_curr, 1);
+
+        /* Load extra result from its address and push to stack */
+        for (i = 1; i < func_result_count; i++) {
+            ret_type = TO_LLVM_TYPE(func_type->types[func_param_count + i]);
+            snprintf(buf, sizeof(buf), "ext_ret%d", i - 1);
+            if (!(ext_ret = LLVMBuildLoad2(comp_ctx->builder, ret_type,
+                                           param_values[func_param_count + i],
+                                           buf))) {
+                aot_set_last_error("llvm build load failed.");
+                return false;
+            }
+            LLVMAddIncoming(result_phis[i], &ext_ret, &block_curr, 1);
+        }
+    }
+
+    *p_call = value_ret;
+    return true;
+}
+
 bool
 aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              uint32 type_idx, uint32 tbl_idx)
@@ -2040,7 +2264,7 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMValueRef ftype_idx_ptr, ftype_idx, ftype_idx_const;
     LLVMValueRef cmp_func_obj, cmp_elem_idx, cmp_func_idx, cmp_ftype_idx;
     LLVMValueRef func, func_ptr, table_size_const;
-    LLVMValueRef ext_ret_offset, ext_ret_ptr, ext_ret, res;
+    LLVMValueRef ext_ret_offset, ext_ret_ptr, res;
     LLVMValueRef *param_values = NULL, *value_rets = NULL;
     LLVMValueRef *result_phis = NULL, value_ret, import_func_count;
     LLVMTypeRef *param_types = NULL, ret_type;
@@ -2050,7 +2274,9 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         check_ftype_idx_succ;
     LLVMBasicBlockRef check_func_idx_succ, block_return, block_curr;
     LLVMBasicBlockRef block_call_import, block_call_non_import;
-    LLVMValueRef offset;
+    LLVMBasicBlockRef block_call_spec = NULL, block_check_elem_idx;
+    LLVMValueRef offset, spec_site = NULL, spec_params[2], spec_guard;
+    LLVMValueRef spec_func_idx;
     uint32 total_param_count, func_param_count, func_result_count;
     uint32 ext_cell_num, param_cell_num, i, j;
     uint8 wasm_ret_type, *wasm_ret_types;
@@ -2109,6 +2335,138 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     POP_I32(elem_idx);
 
+    /* Initialize parameter types of the LLVM function */
+    total_param_count = 1 + func_param_count;
+
+    /* Extra function results' addresses (except the first one) are
+       appended to aot function parameters. */
+    if (func_result_count > 1)
+        total_param_count += func_result_count - 1;
+
+    total_size = sizeof(LLVMTypeRef) * (uint64)total_param_count;
+    if (total_size >= UINT32_MAX
+        || !(param_types = wasm_runtime_malloc((uint32)total_size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+
+    /* Prepare param types */
+    j = 0;
+    param_types[j++] = comp_ctx->exec_env_type;
+    for (i = 0; i < func_param_count; i++)
+        param_types[j++] = TO_LLVM_TYPE(func_type->types[i]);
+
+    for (i = 1; i < func_result_count; i++, j++) {
+        param_types[j] = TO_LLVM_TYPE(func_type->types[func_param_count + i]);
+        if (!(param_types[j] = LLVMPointerType(param_types[j], 0))) {
+            aot_set_last_error("llvm get pointer type failed.");
+            goto fail;
+        }
+    }
+
+    /* Resolve return type of the LLVM function */
+    if (func_result_count) {
+        wasm_ret_type = func_type->types[func_param_count];
+        ret_type = TO_LLVM_TYPE(wasm_ret_type);
+    }
+    else {
+        wasm_ret_type = VALUE_TYPE_VOID;
+        ret_type = VOID_TYPE;
+    }
+
+    /* Allocate memory for parameters */
+    total_size = sizeof(LLVMValueRef) * (uint64)total_param_count;
+    if (total_size >= UINT32_MAX
+        || !(param_values = wasm_runtime_malloc((uint32)total_size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+
+    /* First parameter is exec env */
+    j = 0;
+    param_values[j++] = func_ctx->exec_env;
+
+    /* Pop parameters from stack */
+    for (i = func_param_count - 1; (int32)i >= 0; i--)
+        POP(param_values[i + j], func_type->types[i]);
+
+    /* Prepare extra parameters */
+    ext_cell_num = 0;
+    for (i = 1; i < func_result_count; i++) {
+        ext_ret_offset = I32_CONST(ext_cell_num);
+        CHECK_LLVM_CONST(ext_ret_offset);
+
+        snprintf(buf, sizeof(buf), "ext_ret%d_ptr", i - 1);
+        if (!(ext_ret_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE,
+                                                  func_ctx->argv_buf,
+                                                  &ext_ret_offset, 1, buf))) {
+            aot_set_last_error("llvm build GEP failed.");
+            goto fail;
+        }
+
+        ext_ret_ptr_type = param_types[func_param_count + i];
+        snprintf(buf, sizeof(buf), "ext_ret%d_ptr_cast", i - 1);
+        if (!(ext_ret_ptr = LLVMBuildBitCast(comp_ctx->builder, ext_ret_ptr,
+                                             ext_ret_ptr_type, buf))) {
+            aot_set_last_error("llvm build bit cast failed.");
+            goto fail;
+        }
+
+        param_values[func_param_count + i] = ext_ret_ptr;
+        ext_cell_num += wasm_value_type_cell_num_internal(
+            func_type->types[func_param_count + i], comp_ctx->pointer_size);
+    }
+
+    if (ext_cell_num > 64) {
+        aot_set_last_error("prepare call-indirect arguments failed: "
+                           "maximum 64 extra cell number supported.");
+        goto fail;
+    }
+
+    if (!(llvm_func_type =
+              LLVMFunctionType(ret_type, param_types, total_param_count, false))
+        || !(llvm_func_ptr_type = LLVMPointerType(llvm_func_type, 0))) {
+        aot_set_last_error("llvm add function type failed.");
+        goto fail;
+    }
+
+    if (is_call_indirect_spec_enabled(comp_ctx, tbl_idx)) {
+        /* Speculatively call the hottest callee recorded by the value
+           profile directly if elem_idx refers to it, so as to skip the
+           table lookup and the function type check */
+        if (!(spec_site = I32_CONST(comp_ctx->call_indirect_spec_site_count++))) {
+            HANDLE_FAILURE("LLVMConstInt");
+            goto fail;
+        }
+
+        spec_params[0] = spec_site;
+        spec_params[1] = elem_idx;
+        if (!(spec_guard = call_spec_placeholder(
+                  comp_ctx, AOT_CALL_INDIRECT_SPEC_GUARD, INT1_TYPE,
+                  spec_params, 2, "spec_guard")))
+            goto fail;
+
+        block_call_spec = LLVMAppendBasicBlockInContext(
+            comp_ctx->context, func_ctx->func, "call_spec");
+        block_check_elem_idx = LLVMAppendBasicBlockInContext(
+            comp_ctx->context, func_ctx->func, "check_elem_idx");
+        if (!block_call_spec || !block_check_elem_idx) {
+            aot_set_last_error("llvm add basic block failed.");
+            goto fail;
+        }
+
+        LLVMMoveBasicBlockAfter(block_check_elem_idx,
+                                LLVMGetInsertBlock(comp_ctx->builder));
+
+        if (!LLVMBuildCondBr(comp_ctx->builder, spec_guard, block_call_spec,
+                             block_check_elem_idx)) {
+            aot_set_last_error("llvm build cond br failed.");
+            goto fail;
+        }
+
+        LLVMPositionBuilderAtEnd(comp_ctx->builder, block_check_elem_idx);
+    }
+
     /* get the cur size of the table instance */
     if (!(offset = I32_CONST(get_tbl_inst_offset(comp_ctx, func_ctx, tbl_idx)
                              + offsetof(AOTTableInstance, cur_size)))) {
@@ -2342,94 +2700,6 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              cmp_ftype_idx, check_ftype_idx_succ)))
         goto fail;
 
-    /* Initialize parameter types of the LLVM function */
-    total_param_count = 1 + func_param_count;
-
-    /* Extra function results' addresses (except the first one) are
-       appended to aot function parameters. */
-    if (func_result_count > 1)
-        total_param_count += func_result_count - 1;
-
-    total_size = sizeof(LLVMTypeRef) * (uint64)total_param_count;
-    if (total_size >= UINT32_MAX
-        || !(param_types = wasm_runtime_malloc((uint32)total_size))) {
-        aot_set_last_error("allocate memory failed.");
-        goto fail;
-    }
-
-    /* Prepare param types */
-    j = 0;
-    param_types[j++] = comp_ctx->exec_env_type;
-    for (i = 0; i < func_param_count; i++)
-        param_types[j++] = TO_LLVM_TYPE(func_type->types[i]);
-
-    for (i = 1; i < func_result_count; i++, j++) {
-        param_types[j] = TO_LLVM_TYPE(func_type->types[func_param_count + i]);
-        if (!(param_types[j] = LLVMPointerType(param_types[j], 0))) {
-            aot_set_last_error("llvm get pointer type failed.");
-            goto fail;
-        }
-    }
-
-    /* Resolve return type of the LLVM function */
-    if (func_result_count) {
-        wasm_ret_type = func_type->types[func_param_count];
-        ret_type = TO_LLVM_TYPE(wasm_ret_type);
-    }
-    else {
-        wasm_ret_type = VALUE_TYPE_VOID;
-        ret_type = VOID_TYPE;
-    }
-
-    /* Allocate memory for parameters */
-    total_size = sizeof(LLVMValueRef) * (uint64)total_param_count;
-    if (total_size >= UINT32_MAX
-        || !(param_values = wasm_runtime_malloc((uint32)total_size))) {
-        aot_set_last_error("allocate memory failed.");
-        goto fail;
-    }
-
-    /* First parameter is exec env */
-    j = 0;
-    param_values[j++] = func_ctx->exec_env;
-
-    /* Pop parameters from stack */
-    for (i = func_param_count - 1; (int32)i >= 0; i--)
-        POP(param_values[i + j], func_type->types[i]);
-
-    /* Prepare extra parameters */
-    ext_cell_num = 0;
-    for (i = 1; i < func_result_count; i++) {
-        ext_ret_offset = I32_CONST(ext_cell_num);
-        CHECK_LLVM_CONST(ext_ret_offset);
-
-        snprintf(buf, sizeof(buf), "ext_ret%d_ptr", i - 1);
-        if (!(ext_ret_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, I32_TYPE,
-                                                  func_ctx->argv_buf,
-                                                  &ext_ret_offset, 1, buf))) {
-            aot_set_last_error("llvm build GEP failed.");
-            goto fail;
-        }
-
-        ext_ret_ptr_type = param_types[func_param_count + i];
-        snprintf(buf, sizeof(buf), "ext_ret%d_ptr_cast", i - 1);
-        if (!(ext_ret_ptr = LLVMBuildBitCast(comp_ctx->builder, ext_ret_ptr,
-                                             ext_ret_ptr_type, buf))) {
-            aot_set_last_error("llvm build bit cast failed.");
-            goto fail;
-        }
-
-        param_values[func_param_count + i] = ext_ret_ptr;
-        ext_cell_num += wasm_value_type_cell_num_internal(
-            func_type->types[func_param_count + i], comp_ctx->pointer_size);
-    }
-
-    if (ext_cell_num > 64) {
-        aot_set_last_error("prepare call-indirect arguments failed: "
-                           "maximum 64 extra cell number supported.");
-        goto fail;
-    }
-
     if (comp_ctx->enable_aux_stack_frame) {
 #if WASM_ENABLE_AOT_STACK_FRAME != 0
         /*  TODO: use current frame instead of allocating new frame
@@ -2532,7 +2802,8 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
 
     /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+    if ((comp_ctx->enable_bound_check
+         || need_check_wasm_exception(comp_ctx, func_ctx))
         && !check_call_return(comp_ctx, func_ctx, res))
         goto fail;
 
@@ -2563,54 +2834,85 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
-    if (!(llvm_func_type =
-              LLVMFunctionType(ret_type, param_types, total_param_count, false))
-        || !(llvm_func_ptr_type = LLVMPointerType(llvm_func_type, 0))) {
-        aot_set_last_error("llvm add function type failed.");
-        goto fail;
-    }
-
     if (!(func = LLVMBuildBitCast(comp_ctx->builder, func_ptr,
                                   llvm_func_ptr_type, "indirect_func"))) {
         aot_set_last_error("llvm build bit cast failed.");
         goto fail;
     }
 
-    if (!(value_ret = LLVMBuildCall2(comp_ctx->builder, llvm_func_type, func,
-                                     param_values, total_param_count,
-                                     func_result_count > 0 ? "ret" : ""))) {
-        aot_set_last_error("llvm build call failed.");
+    if (!call_indirect_non_import_func(comp_ctx, func_ctx, func_type,
+                                       llvm_func_type, func, param_values,
+                                       total_param_count, result_phis,
+                                       &value_ret))
         goto fail;
-    }
 
-    /* Check whether exception was thrown when executing the function */
-    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
-        && !check_exception_thrown(comp_ctx, func_ctx))
+    /* Record the call site for resolving the speculative call */
+    if (spec_site
+        && !set_call_indirect_site_info(comp_ctx, value_ret, spec_site,
+                                        tbl_idx, type_idx))
         goto fail;
 
-    if (func_result_count > 0) {
-        block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    if (!LLVMBuildBr(comp_ctx->builder, block_return)) {
+        aot_set_last_error("llvm build br failed.");
+        goto fail;
+    }
 
-        /* Push the first result to stack */
-        LLVMAddIncoming(result_phis[0], &value_ret, &block_curr, 1);
+    if (block_call_spec) {
+        /* Translate speculative call block */
+        LLVMMoveBasicBlockAfter(block_call_spec,
+                                LLVMGetInsertBlock(comp_ctx->builder));
+        LLVMPositionBuilderAtEnd(comp_ctx->builder, block_call_spec);
 
-        /* Load extra result from its address and push to stack */
-        for (i = 1; i < func_result_count; i++) {
-            ret_type = TO_LLVM_TYPE(func_type->types[func_param_count + i]);
-            snprintf(buf, sizeof(buf), "ext_ret%d", i - 1);
-            if (!(ext_ret = LLVMBuildLoad2(comp_ctx->builder, ret_type,
-                                           param_values[func_param_count + i],
-                                           buf))) {
+        if (!(spec_func_idx = call_spec_placeholder(
+                  comp_ctx, AOT_CALL_INDIRECT_SPEC_FUNC_IDX, I32_TYPE,
+                  &spec_site, 1, "spec_func_idx")))
+            goto fail;
+
+        if (comp_ctx->enable_aux_stack_frame) {
+#if WASM_ENABLE_AOT_STACK_FRAME != 0
+            if (!call_aot_alloc_frame_func(comp_ctx, func_ctx, spec_func_idx))
+                goto fail;
+#endif
+        }
+
+        if (comp_ctx->is_indirect_mode) {
+            /* Load function pointer like the direct call does */
+            if (!(func_ptr = LLVMBuildInBoundsGEP2(
+                      comp_ctx->builder, OPQ_PTR_TYPE, func_ctx->func_ptrs,
+                      &spec_func_idx, 1, "spec_func_ptr_tmp"))) {
+                aot_set_last_error("llvm build inbounds gep failed.");
+                goto fail;
+            }
+
+            if (!(func_ptr = LLVMBuildLoad2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                            func_ptr, "spec_func_ptr"))) {
                 aot_set_last_error("llvm build load failed.");
                 goto fail;
             }
-            LLVMAddIncoming(result_phis[i], &ext_ret, &block_curr, 1);
         }
-    }
+        else {
+            if (!(func_ptr = call_spec_placeholder(
+                      comp_ctx, AOT_CALL_INDIRECT_SPEC_CALLEE, OPQ_PTR_TYPE,
+                      &spec_site, 1, "spec_func_ptr")))
+                goto fail;
+        }
 
-    if (!LLVMBuildBr(comp_ctx->builder, block_return)) {
-        aot_set_last_error("llvm build br failed.");
-        goto fail;
+        if (!(func = LLVMBuildBitCast(comp_ctx->builder, func_ptr,
+                                      llvm_func_ptr_type, "spec_func"))) {
+            aot_set_last_error("llvm build bit cast failed.");
+            goto fail;
+        }
+
+        if (!call_indirect_non_import_func(comp_ctx, func_ctx, func_type,
+                                           llvm_func_type, func, param_values,
+                                           total_param_count, result_phis,
+                                           &value_ret))
+            goto fail;
+
+        if (!LLVMBuildBr(comp_ctx->builder, block_return)) {
+            aot_set_last_error("llvm build br failed.");
+            goto fail;
+        }
     }
 
     /* Translate function return block */
@@ -3011,7 +3313,8 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
 
     /* Check whether exception was thrown when executing the function */
-    if (comp_ctx->enable_bound_check
+    if ((comp_ctx->enable_bound_check
+         || need_check_wasm_exception(comp_ctx, func_ctx))
         && !check_call_return(comp_ctx, func_ctx, res))
         goto fail;
 
@@ -3088,7 +3391,7 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* Check whether exception was thrown when executing the function */
     if (!tail_call
-        && (comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+        && need_check_call_exception(comp_ctx, func_ctx)
         && !check_exception_thrown(comp_ctx, func_ctx))
         goto fail;
 
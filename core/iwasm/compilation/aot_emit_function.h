@@ -36,6 +36,16 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                         uint32 type_idx, bool tail_call);
 #endif
 
+bool
+aot_create_func_return_block(AOTCompContext *comp_ctx,
+                             AOTFuncContext *func_ctx);
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+bool
+aot_restore_frame_for_exce_handling(AOTCompContext *comp_ctx,
+                                    AOTFuncContext *func_ctx);
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
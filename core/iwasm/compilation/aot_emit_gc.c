@@ -85,7 +85,7 @@ bool
 aot_call_aot_create_func_obj(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              LLVMValueRef func_idx, LLVMValueRef *p_gc_obj)
 {
-    LLVMValueRef gc_obj, cmp_gc_obj, param_values[5], func, value;
+    LLVMValueRef gc_obj, cmp_gc_obj, param_values[5], func;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
     AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
@@ -149,7 +149,7 @@ aot_call_aot_obj_is_instance_of(AOTCompContext *comp_ctx,
                                 AOTFuncContext *func_ctx, LLVMValueRef gc_obj,
                                 LLVMValueRef heap_type, LLVMValueRef *castable)
 {
-    LLVMValueRef param_values[3], func, value, res;
+    LLVMValueRef param_values[3], func, res;
     LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
 
     param_types[0] = INT8_PTR_TYPE;
@@ -186,7 +186,7 @@ aot_call_wasm_obj_is_type_of(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              LLVMValueRef gc_obj, LLVMValueRef heap_type,
                              LLVMValueRef *castable)
 {
-    LLVMValueRef param_values[2], func, value, res;
+    LLVMValueRef param_values[2], func, res;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
 
     param_types[0] = GC_REF_TYPE;
@@ -215,7 +215,7 @@ bool
 aot_call_aot_rtt_type_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           LLVMValueRef type_index, LLVMValueRef *rtt_type)
 {
-    LLVMValueRef param_values[2], func, value, res;
+    LLVMValueRef param_values[2], func, res;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
 
     param_types[0] = INT8_PTR_TYPE;
@@ -271,7 +271,7 @@ static bool
 aot_call_wasm_struct_obj_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              LLVMValueRef rtt_type, LLVMValueRef *struct_obj)
 {
-    LLVMValueRef param_values[2], func, value, res;
+    LLVMValueRef param_values[2], func, res;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
 
     param_types[0] = INT8_PTR_TYPE;
@@ -408,6 +408,66 @@ fail:
     return false;
 }
 
+/* Call wasm_obj_write_barrier() after the reference is stored into the
+   object, the call is skipped if the reference is null or an i31 object */
+static bool
+aot_call_wasm_obj_write_barrier(AOTCompContext *comp_ctx,
+                                AOTFuncContext *func_ctx, LLVMValueRef gc_obj,
+                                LLVMValueRef ref)
+{
+    LLVMValueRef param_values[1], func, ref_int, cmp[2];
+    LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
+    LLVMBasicBlockRef call_barrier, barrier_end;
+
+    ADD_BASIC_BLOCK(call_barrier, "call_write_barrier");
+    MOVE_BLOCK_AFTER_CURR(call_barrier);
+    ADD_BASIC_BLOCK(barrier_end, "write_barrier_end");
+    MOVE_BLOCK_AFTER(barrier_end, call_barrier);
+
+    if (!(ref_int = LLVMBuildPtrToInt(comp_ctx->builder, ref, INTPTR_T_TYPE,
+                                      "ref_int"))) {
+        aot_set_last_error("llvm build ptrtoint failed.");
+        goto fail;
+    }
+    if (!(ref_int =
+              LLVMBuildAnd(comp_ctx->builder, ref_int,
+                           LLVMConstInt(INTPTR_T_TYPE, 1, false), "i31_bit"))) {
+        aot_set_last_error("llvm build and failed.");
+        goto fail;
+    }
+    BUILD_ISNOTNULL(ref, cmp[0], "cmp_ref");
+    BUILD_ICMP(LLVMIntEQ, ref_int, LLVMConstInt(INTPTR_T_TYPE, 0, false),
+               cmp[1], "cmp_i31_bit");
+    if (!(cmp[0] = LLVMBuildAnd(comp_ctx->builder, cmp[0], cmp[1],
+                                "is_heap_obj"))) {
+        aot_set_last_error("llvm build and failed.");
+        goto fail;
+    }
+    BUILD_COND_BR(cmp[0], call_barrier, barrier_end);
+
+    SET_BUILDER_POS(call_barrier);
+
+    param_types[0] = GC_REF_TYPE;
+    ret_type = VOID_TYPE;
+
+    GET_AOT_FUNCTION(wasm_obj_write_barrier, 1);
+
+    /* Call function wasm_obj_write_barrier() */
+    param_values[0] = gc_obj;
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 1,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    BUILD_BR(barrier_end);
+    SET_BUILDER_POS(barrier_end);
+
+    return true;
+fail:
+    return false;
+}
+
 static bool
 aot_struct_obj_get_field(AOTCompContext *comp_ctx, LLVMValueRef struct_obj,
                          LLVMValueRef field_offset, LLVMValueRef *p_field_value,
@@ -707,6 +767,11 @@ aot_compile_op_struct_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                                   field_value, field_type))
         goto fail;
 
+    if (wasm_is_type_reftype(field_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, struct_obj,
+                                            field_value))
+        goto fail;
+
     return true;
 fail:
     return false;
@@ -717,7 +782,7 @@ aot_call_wasm_array_obj_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             LLVMValueRef rtt_type, LLVMValueRef array_len,
                             LLVMValueRef array_elem, LLVMValueRef *array_obj)
 {
-    LLVMValueRef param_values[4], func, value, res, array_elem_ptr;
+    LLVMValueRef param_values[4], func, res, array_elem_ptr;
     LLVMTypeRef param_types[4], ret_type, func_type, func_ptr_type;
 
     if (!(array_elem_ptr = LLVMBuildAlloca(
@@ -925,7 +990,7 @@ aot_call_aot_array_init_with_data(
     LLVMValueRef data_seg_offset, LLVMValueRef array_obj,
     LLVMValueRef elem_size, LLVMValueRef array_len)
 {
-    LLVMValueRef param_values[6], func, value, res, cmp;
+    LLVMValueRef param_values[6], func, res, cmp;
     LLVMTypeRef param_types[6], ret_type, func_type, func_ptr_type;
     LLVMBasicBlockRef init_success;
 
@@ -1446,6 +1511,11 @@ aot_compile_op_array_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
+    if (wasm_is_type_reftype(array_elem_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, array_obj,
+                                            array_elem))
+        goto fail;
+
     return true;
 fail:
     return false;
@@ -1595,6 +1665,11 @@ aot_compile_op_array_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     SET_BUILDER_POS(len_le_zero);
 
+    if (wasm_is_type_reftype(array_elem_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, array_obj,
+                                            fill_value))
+        goto fail;
+
     return true;
 fail:
     return false;
@@ -1606,7 +1681,7 @@ aot_call_wasm_array_obj_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                              LLVMValueRef src_obj, LLVMValueRef src_offset,
                              LLVMValueRef len)
 {
-    LLVMValueRef param_values[5], func, value;
+    LLVMValueRef param_values[5], func;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
 
     param_types[0] = GC_REF_TYPE;
@@ -1970,7 +2045,7 @@ aot_call_wasm_externref_obj_to_internal_obj(AOTCompContext *comp_ctx,
                                             LLVMValueRef externref_obj,
                                             LLVMValueRef *gc_obj)
 {
-    LLVMValueRef param_values[1], func, value, res;
+    LLVMValueRef param_values[1], func, res;
     LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
 
     param_types[0] = GC_REF_TYPE;
@@ -2050,7 +2125,7 @@ aot_call_wasm_internal_obj_to_external_obj(AOTCompContext *comp_ctx,
                                            LLVMValueRef gc_obj,
                                            LLVMValueRef *externref_obj)
 {
-    LLVMValueRef param_values[2], func, value, res;
+    LLVMValueRef param_values[2], func, res;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
 
     param_types[0] = INT8_PTR_TYPE;
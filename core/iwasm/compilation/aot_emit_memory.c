@@ -9,6 +9,7 @@
 #include "../aot/aot_runtime.h"
 #include "aot_intrinsic.h"
 #include "aot_emit_control.h"
+#include "../common/wasm_memory.h"
 
 #define BUILD_ICMP(op, left, right, res, name)                                \
     do {                                                                      \
@@ -54,24 +55,25 @@ zero_extend_u64(AOTCompContext *comp_ctx, LLVMValueRef *value, const char *name)
 
 static LLVMValueRef
 get_memory_check_bound(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                       uint32 bytes)
+                       uint32 mem_idx, uint32 bytes)
 {
+    AOTMemInfo *mem_info = &func_ctx->mem_info[mem_idx];
     LLVMValueRef mem_check_bound = NULL;
     switch (bytes) {
         case 1:
-            mem_check_bound = func_ctx->mem_info[0].mem_bound_check_1byte;
+            mem_check_bound = mem_info->mem_bound_check_1byte;
             break;
         case 2:
-            mem_check_bound = func_ctx->mem_info[0].mem_bound_check_2bytes;
+            mem_check_bound = mem_info->mem_bound_check_2bytes;
             break;
         case 4:
-            mem_check_bound = func_ctx->mem_info[0].mem_bound_check_4bytes;
+            mem_check_bound = mem_info->mem_bound_check_4bytes;
             break;
         case 8:
-            mem_check_bound = func_ctx->mem_info[0].mem_bound_check_8bytes;
+            mem_check_bound = mem_info->mem_bound_check_8bytes;
             break;
         case 16:
-            mem_check_bound = func_ctx->mem_info[0].mem_bound_check_16bytes;
+            mem_check_bound = mem_info->mem_bound_check_16bytes;
             break;
         default:
             bh_assert(0);
@@ -109,12 +111,69 @@ ffs(int n)
 #endif
 
 static LLVMValueRef
-get_memory_curr_page_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+get_memory_curr_page_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx);
+
+/* Branch to check_succ if cmp is false, otherwise the access is out of the
+   linear memory and it is valid only if it is in the shared heap attached
+   to the instance, which is mapped above the linear memory */
+static bool
+check_shared_heap_access(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                         LLVMValueRef cmp, LLVMValueRef offset,
+                         LLVMValueRef bytes, LLVMBasicBlockRef check_succ)
+{
+    LLVMValueRef param_values[3], ret_value, func;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
+    LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    LLVMBasicBlockRef check_shared_heap;
+
+    ADD_BASIC_BLOCK(check_shared_heap, "check_shared_heap");
+    LLVMMoveBasicBlockAfter(check_shared_heap, block_curr);
+
+    if (!LLVMBuildCondBr(comp_ctx->builder, cmp, check_shared_heap,
+                         check_succ)) {
+        aot_set_last_error("llvm build cond br failed.");
+        goto fail;
+    }
+
+    SET_BUILD_POS(check_shared_heap);
+
+    if (LLVMTypeOf(offset) != I64_TYPE
+        && !(offset = LLVMBuildZExt(comp_ctx->builder, offset, I64_TYPE,
+                                    "offset_i64"))) {
+        aot_set_last_error("llvm build zero extend failed.");
+        goto fail;
+    }
+
+    param_types[0] = INT8_PTR_TYPE;
+    param_types[1] = I64_TYPE;
+    param_types[2] = I64_TYPE;
+    ret_type = INT8_TYPE;
+
+    GET_AOT_FUNCTION(wasm_runtime_is_app_addr_in_shared_heap, 3);
+
+    /* Call function wasm_runtime_is_app_addr_in_shared_heap() */
+    param_values[0] = func_ctx->aot_inst;
+    param_values[1] = offset;
+    param_values[2] = bytes;
+    if (!(ret_value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                                     param_values, 3, "call"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    BUILD_ICMP(LLVMIntEQ, ret_value, I8_ZERO, cmp, "not_in_shared_heap");
+    return aot_emit_exception(comp_ctx, func_ctx,
+                              EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
+                              check_succ);
+fail:
+    return false;
+}
 
 LLVMValueRef
 aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                          mem_offset_t offset, uint32 bytes, bool enable_segue,
-                          unsigned int *alignp)
+                          uint32 mem_idx, mem_offset_t offset, uint32 bytes,
+                          bool enable_segue, unsigned int *alignp)
 {
     LLVMValueRef offset_const =
         MEMORY64_COND_VALUE(I64_CONST(offset), I32_CONST(offset));
@@ -123,17 +182,21 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef check_succ;
     AOTValue *aot_value_top;
+    /* The shared heap is mapped above the default memory only */
+    bool enable_shared_heap = comp_ctx->enable_shared_heap && mem_idx == 0;
     uint32 local_idx_of_aot_value = 0;
     uint64 const_value;
     bool is_target_64bit, is_local_of_aot_value = false;
     bool is_const = false;
 #if WASM_ENABLE_SHARED_MEMORY != 0
     bool is_shared_memory =
-        comp_ctx->comp_data->memories[0].flags & SHARED_MEMORY_FLAG;
+        comp_ctx->comp_data->memories[mem_idx].flags & SHARED_MEMORY_FLAG;
 #endif
 
     is_target_64bit = (comp_ctx->pointer_size == sizeof(uint64)) ? true : false;
 
+    bh_assert(!enable_segue || mem_idx == 0);
+
     if (comp_ctx->is_indirect_mode
         && aot_intrinsic_check_capability(
             comp_ctx, MEMORY64_COND_VALUE("i64.const", "i32.const"))) {
@@ -164,12 +227,12 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         || is_shared_memory
 #endif
     ) {
-        mem_base_addr = func_ctx->mem_info[0].mem_base_addr;
+        mem_base_addr = func_ctx->mem_info[mem_idx].mem_base_addr;
     }
     else {
         if (!(mem_base_addr = LLVMBuildLoad2(
                   comp_ctx->builder, OPQ_PTR_TYPE,
-                  func_ctx->mem_info[0].mem_base_addr, "mem_base"))) {
+                  func_ctx->mem_info[mem_idx].mem_base_addr, "mem_base"))) {
             aot_set_last_error("llvm build load failed.");
             goto fail;
         }
@@ -179,8 +242,9 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         func_ctx->block_stack.block_list_end->value_stack.value_list_end;
     if (aot_value_top) {
         /* aot_value_top is freed in the following POP_I32(addr),
-           so save its fields here for further use */
-        is_local_of_aot_value = aot_value_top->is_local;
+           so save its fields here for further use, the checked address
+           list doesn't record the memory index */
+        is_local_of_aot_value = aot_value_top->is_local && mem_idx == 0;
         is_const = aot_value_top->is_const;
         local_idx_of_aot_value = aot_value_top->local_idx;
         const_value = aot_value_top->const_value;
@@ -203,9 +267,9 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
         uint64 mem_offset = value + (uint64)offset;
         uint32 num_bytes_per_page =
-            comp_ctx->comp_data->memories[0].num_bytes_per_page;
+            comp_ctx->comp_data->memories[mem_idx].num_bytes_per_page;
         uint32 init_page_count =
-            comp_ctx->comp_data->memories[0].init_page_count;
+            comp_ctx->comp_data->memories[mem_idx].init_page_count;
         uint64 mem_data_size = (uint64)num_bytes_per_page * init_page_count;
 
         if (alignp != NULL) {
@@ -270,25 +334,56 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* offset1 = offset + addr; */
     BUILD_OP(Add, offset_const, addr, offset1, "offset1");
 
+#if WASM_ENABLE_MEMORY64 != 0
+    if (IS_MEMORY64 && !comp_ctx->enable_bound_check) {
+        /* The reserved space of the linear memory doesn't cover the whole
+           memory64 address range, clamp the address beyond the largest
+           memory, including the overflowed one, to the guard page at the
+           end of it so that the access traps, see
+           MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE */
+        LLVMValueRef mem_limit =
+            I64_CONST(MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE);
+
+        CHECK_LLVM_CONST(mem_limit);
+        BUILD_ICMP(LLVMIntULT, offset1, addr, cmp1, "cmp1");
+        BUILD_ICMP(LLVMIntUGT, offset1, mem_limit, cmp2, "cmp2");
+        BUILD_OP(Or, cmp1, cmp2, cmp, "cmp");
+        if (!(offset1 = LLVMBuildSelect(comp_ctx->builder, cmp, mem_limit,
+                                        offset1, "offset1_clamped"))) {
+            aot_set_last_error("llvm build select failed.");
+            goto fail;
+        }
+    }
+#endif
+
     if (comp_ctx->enable_bound_check
         && !(is_local_of_aot_value
              && aot_checked_addr_list_find(func_ctx, local_idx_of_aot_value,
                                            offset, bytes))) {
         uint32 init_page_count =
-            comp_ctx->comp_data->memories[0].init_page_count;
+            comp_ctx->comp_data->memories[mem_idx].init_page_count;
         if (init_page_count == 0) {
             LLVMValueRef mem_size;
 
-            if (!(mem_size = get_memory_curr_page_count(comp_ctx, func_ctx))) {
+            if (!(mem_size = get_memory_curr_page_count(comp_ctx, func_ctx,
+                                                        mem_idx))) {
                 goto fail;
             }
             BUILD_ICMP(LLVMIntEQ, mem_size,
                        MEMORY64_COND_VALUE(I64_ZERO, I32_ZERO), cmp, "is_zero");
             ADD_BASIC_BLOCK(check_succ, "check_mem_size_succ");
             LLVMMoveBasicBlockAfter(check_succ, block_curr);
-            if (!aot_emit_exception(comp_ctx, func_ctx,
-                                    EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
-                                    check_succ)) {
+            if (enable_shared_heap) {
+                /* The bound of the empty memory is wrapped around, so
+                   the access in the shared heap passes the check below */
+                if (!check_shared_heap_access(comp_ctx, func_ctx, cmp,
+                                              offset1, I64_CONST(bytes),
+                                              check_succ))
+                    goto fail;
+            }
+            else if (!aot_emit_exception(comp_ctx, func_ctx,
+                                         EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true,
+                                         cmp, check_succ)) {
                 goto fail;
             }
 
@@ -297,12 +392,19 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
 
         if (!(mem_check_bound =
-                  get_memory_check_bound(comp_ctx, func_ctx, bytes))) {
+                  get_memory_check_bound(comp_ctx, func_ctx, mem_idx, bytes))) {
             goto fail;
         }
 
         if (is_target_64bit) {
             BUILD_ICMP(LLVMIntUGT, offset1, mem_check_bound, cmp, "cmp");
+#if WASM_ENABLE_MEMORY64 != 0
+            if (IS_MEMORY64) {
+                /* Check integer overflow of the 64-bit address */
+                BUILD_ICMP(LLVMIntULT, offset1, addr, cmp1, "cmp1");
+                BUILD_OP(Or, cmp1, cmp, cmp, "cmp");
+            }
+#endif
         }
         else {
             /* Check integer overflow */
@@ -315,9 +417,14 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         ADD_BASIC_BLOCK(check_succ, "check_succ");
         LLVMMoveBasicBlockAfter(check_succ, block_curr);
 
-        if (!aot_emit_exception(comp_ctx, func_ctx,
-                                EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
-                                check_succ)) {
+        if (enable_shared_heap) {
+            if (!check_shared_heap_access(comp_ctx, func_ctx, cmp, offset1,
+                                          I64_CONST(bytes), check_succ))
+                goto fail;
+        }
+        else if (!aot_emit_exception(comp_ctx, func_ctx,
+                                     EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true,
+                                     cmp, check_succ)) {
             goto fail;
         }
 
@@ -489,16 +596,16 @@ fail:
 
 bool
 aot_compile_op_i32_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset, uint32 bytes,
-                        bool sign, bool atomic)
+                        uint32 mem_idx, uint32 align, mem_offset_t offset,
+                        uint32 bytes, bool sign, bool atomic)
 {
     LLVMValueRef maddr, value = NULL;
     LLVMTypeRef data_type;
-    bool enable_segue = comp_ctx->enable_segue_i32_load;
+    bool enable_segue = comp_ctx->enable_segue_i32_load && mem_idx == 0;
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, &known_align)))
         return false;
 
     switch (bytes) {
@@ -560,16 +667,16 @@ fail:
 
 bool
 aot_compile_op_i64_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset, uint32 bytes,
-                        bool sign, bool atomic)
+                        uint32 mem_idx, uint32 align, mem_offset_t offset,
+                        uint32 bytes, bool sign, bool atomic)
 {
     LLVMValueRef maddr, value = NULL;
     LLVMTypeRef data_type;
-    bool enable_segue = comp_ctx->enable_segue_i64_load;
+    bool enable_segue = comp_ctx->enable_segue_i64_load && mem_idx == 0;
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, &known_align)))
         return false;
 
     switch (bytes) {
@@ -639,14 +746,14 @@ fail:
 
 bool
 aot_compile_op_f32_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset)
+                        uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_f32_load;
+    bool enable_segue = comp_ctx->enable_segue_f32_load && mem_idx == 0;
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, 4,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            4, enable_segue, &known_align)))
         return false;
 
     if (!enable_segue)
@@ -663,14 +770,14 @@ fail:
 
 bool
 aot_compile_op_f64_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset)
+                        uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_f64_load;
+    bool enable_segue = comp_ctx->enable_segue_f64_load && mem_idx == 0;
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, 8,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            8, enable_segue, &known_align)))
         return false;
 
     if (!enable_segue)
@@ -687,17 +794,17 @@ fail:
 
 bool
 aot_compile_op_i32_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset, uint32 bytes,
-                         bool atomic)
+                         uint32 mem_idx, uint32 align, mem_offset_t offset,
+                         uint32 bytes, bool atomic)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_i32_store;
+    bool enable_segue = comp_ctx->enable_segue_i32_store && mem_idx == 0;
 
     POP_I32(value);
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, &known_align)))
         return false;
 
     switch (bytes) {
@@ -739,17 +846,17 @@ fail:
 
 bool
 aot_compile_op_i64_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset, uint32 bytes,
-                         bool atomic)
+                         uint32 mem_idx, uint32 align, mem_offset_t offset,
+                         uint32 bytes, bool atomic)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_i64_store;
+    bool enable_segue = comp_ctx->enable_segue_i64_store && mem_idx == 0;
 
     POP_I64(value);
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, &known_align)))
         return false;
 
     switch (bytes) {
@@ -798,16 +905,16 @@ fail:
 
 bool
 aot_compile_op_f32_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset)
+                         uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_f32_store;
+    bool enable_segue = comp_ctx->enable_segue_f32_store && mem_idx == 0;
 
     POP_F32(value);
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, 4,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            4, enable_segue, &known_align)))
         return false;
 
     if (!enable_segue)
@@ -822,16 +929,16 @@ fail:
 
 bool
 aot_compile_op_f64_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset)
+                         uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
     LLVMValueRef maddr, value;
-    bool enable_segue = comp_ctx->enable_segue_f64_store;
+    bool enable_segue = comp_ctx->enable_segue_f64_store && mem_idx == 0;
 
     POP_F64(value);
 
     unsigned int known_align;
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, 8,
-                                            enable_segue, &known_align)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            8, enable_segue, &known_align)))
         return false;
 
     if (!enable_segue)
@@ -845,17 +952,19 @@ fail:
 }
 
 static LLVMValueRef
-get_memory_curr_page_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+get_memory_curr_page_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx)
 {
     LLVMValueRef mem_size;
 
     if (func_ctx->mem_space_unchanged) {
-        mem_size = func_ctx->mem_info[0].mem_cur_page_count_addr;
+        mem_size = func_ctx->mem_info[mem_idx].mem_cur_page_count_addr;
     }
     else {
         if (!(mem_size = LLVMBuildLoad2(
                   comp_ctx->builder, I32_TYPE,
-                  func_ctx->mem_info[0].mem_cur_page_count_addr, "mem_size"))) {
+                  func_ctx->mem_info[mem_idx].mem_cur_page_count_addr,
+                  "mem_size"))) {
             aot_set_last_error("llvm build load failed.");
             goto fail;
         }
@@ -868,9 +977,11 @@ fail:
 }
 
 bool
-aot_compile_op_memory_size(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+aot_compile_op_memory_size(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx)
 {
-    LLVMValueRef mem_size = get_memory_curr_page_count(comp_ctx, func_ctx);
+    LLVMValueRef mem_size =
+        get_memory_curr_page_count(comp_ctx, func_ctx, mem_idx);
 
     if (mem_size)
         PUSH_PAGE_COUNT(mem_size);
@@ -880,11 +991,13 @@ fail:
 }
 
 bool
-aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx)
 {
-    LLVMValueRef mem_size = get_memory_curr_page_count(comp_ctx, func_ctx);
-    LLVMValueRef delta, param_values[2], ret_value, func, value;
-    LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
+    LLVMValueRef mem_size =
+        get_memory_curr_page_count(comp_ctx, func_ctx, mem_idx);
+    LLVMValueRef delta, param_values[3], ret_value, func;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
     int32 func_index;
 #if WASM_ENABLE_MEMORY64 != 0
     LLVMValueRef u32_max, u32_cmp_result;
@@ -898,8 +1011,19 @@ aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     /* Function type of aot_enlarge_memory() */
     param_types[0] = INT8_PTR_TYPE;
     param_types[1] = I32_TYPE;
+    param_types[2] = I32_TYPE;
     ret_type = INT8_TYPE;
 
+    if (mem_idx != 0) {
+        /* The default memory keeps calling aot_enlarge_memory() so that
+           the AOT file can be loaded by the runtime of older versions */
+        if (comp_ctx->is_jit_mode)
+            GET_AOT_FUNCTION(wasm_enlarge_memory_with_idx, 3);
+        else
+            GET_AOT_FUNCTION(aot_enlarge_memory_with_idx, 3);
+        goto call_enlarge_memory;
+    }
+
     if (!(func_type = LLVMFunctionType(ret_type, param_types, 2, false))) {
         aot_set_last_error("llvm add function type failed.");
         return false;
@@ -907,13 +1031,9 @@ aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 
     if (comp_ctx->is_jit_mode) {
         /* JIT mode, call the function directly */
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("llvm add pointer type failed.");
-            return false;
-        }
-        if (!(value = I64_CONST((uint64)(uintptr_t)wasm_enlarge_memory))
-            || !(func = LLVMConstIntToPtr(value, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_func_ref(comp_ctx, "wasm_enlarge_memory",
+                                          (void *)wasm_enlarge_memory,
+                                          func_type))) {
             return false;
         }
     }
@@ -943,11 +1063,14 @@ aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         }
     }
 
+call_enlarge_memory:
     /* Call function aot_enlarge_memory() */
     param_values[0] = func_ctx->aot_inst;
     param_values[1] = LLVMBuildTrunc(comp_ctx->builder, delta, I32_TYPE, "");
+    param_values[2] = I32_CONST(mem_idx);
     if (!(ret_value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
-                                     param_values, 2, "call"))) {
+                                     param_values, mem_idx != 0 ? 3 : 2,
+                                     "call"))) {
         aot_set_last_error("llvm build call failed.");
         return false;
     }
@@ -981,7 +1104,8 @@ fail:
 #if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_STRINGREF != 0
 LLVMValueRef
 check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           LLVMValueRef offset, LLVMValueRef bytes)
+                           uint32 mem_idx, LLVMValueRef offset,
+                           LLVMValueRef bytes)
 {
     LLVMValueRef maddr, max_addr, cmp;
     LLVMValueRef mem_base_addr;
@@ -991,18 +1115,18 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* Get memory base address and memory data size */
 #if WASM_ENABLE_SHARED_MEMORY != 0
-    bool is_shared_memory = comp_ctx->comp_data->memories[0].flags & 0x02;
+    bool is_shared_memory = comp_ctx->comp_data->memories[mem_idx].flags & 0x02;
 
     if (func_ctx->mem_space_unchanged || is_shared_memory) {
 #else
     if (func_ctx->mem_space_unchanged) {
 #endif
-        mem_base_addr = func_ctx->mem_info[0].mem_base_addr;
+        mem_base_addr = func_ctx->mem_info[mem_idx].mem_base_addr;
     }
     else {
         if (!(mem_base_addr = LLVMBuildLoad2(
                   comp_ctx->builder, OPQ_PTR_TYPE,
-                  func_ctx->mem_info[0].mem_base_addr, "mem_base"))) {
+                  func_ctx->mem_info[mem_idx].mem_base_addr, "mem_base"))) {
             aot_set_last_error("llvm build load failed.");
             goto fail;
         }
@@ -1017,9 +1141,9 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         uint64 mem_offset = (uint64)LLVMConstIntGetZExtValue(offset);
         uint64 mem_len = (uint64)LLVMConstIntGetZExtValue(bytes);
         uint32 num_bytes_per_page =
-            comp_ctx->comp_data->memories[0].num_bytes_per_page;
+            comp_ctx->comp_data->memories[mem_idx].num_bytes_per_page;
         uint32 init_page_count =
-            comp_ctx->comp_data->memories[0].init_page_count;
+            comp_ctx->comp_data->memories[mem_idx].init_page_count;
         uint64 mem_data_size = (uint64)num_bytes_per_page * init_page_count;
         if (mem_data_size > 0 && mem_offset + mem_len <= mem_data_size) {
             /* inside memory space */
@@ -1035,12 +1159,13 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     if (func_ctx->mem_space_unchanged) {
-        mem_size = func_ctx->mem_info[0].mem_data_size_addr;
+        mem_size = func_ctx->mem_info[mem_idx].mem_data_size_addr;
     }
     else {
         if (!(mem_size = LLVMBuildLoad2(
                   comp_ctx->builder, I64_TYPE,
-                  func_ctx->mem_info[0].mem_data_size_addr, "mem_size"))) {
+                  func_ctx->mem_info[mem_idx].mem_data_size_addr,
+                  "mem_size"))) {
             aot_set_last_error("llvm build load failed.");
             goto fail;
         }
@@ -1055,9 +1180,23 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     BUILD_OP(Add, offset, bytes, max_addr, "max_addr");
     BUILD_ICMP(LLVMIntUGT, max_addr, mem_size, cmp, "cmp_max_mem_addr");
-    if (!aot_emit_exception(comp_ctx, func_ctx,
-                            EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
-                            check_succ)) {
+#if WASM_ENABLE_MEMORY64 != 0
+    if (IS_MEMORY64) {
+        LLVMValueRef cmp_overflow;
+
+        /* Check integer overflow of the 64-bit range */
+        BUILD_ICMP(LLVMIntULT, max_addr, offset, cmp_overflow, "cmp_overflow");
+        BUILD_OP(Or, cmp_overflow, cmp, cmp, "cmp");
+    }
+#endif
+    if (comp_ctx->enable_shared_heap && mem_idx == 0) {
+        if (!check_shared_heap_access(comp_ctx, func_ctx, cmp, offset, bytes,
+                                      check_succ))
+            goto fail;
+    }
+    else if (!aot_emit_exception(comp_ctx, func_ctx,
+                                 EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS, true, cmp,
+                                 check_succ)) {
         goto fail;
     }
 
@@ -1076,10 +1215,11 @@ fail:
 #if WASM_ENABLE_BULK_MEMORY != 0
 bool
 aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint32 seg_index)
+                           uint32 mem_idx, uint32 seg_index)
 {
-    LLVMValueRef seg, offset, dst, len, param_values[5], ret_value, func, value;
-    LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
+    LLVMValueRef seg, offset, dst, len, param_values[6], ret_value, func;
+    LLVMTypeRef param_types[6], ret_type, func_type, func_ptr_type;
+    uint32 param_count = 5;
     AOTFuncType *aot_func_type = func_ctx->aot_func->func_type;
     LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
     LLVMBasicBlockRef mem_init_fail, init_success;
@@ -1099,12 +1239,25 @@ aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     param_types[2] = I32_TYPE;
     param_types[3] = I32_TYPE;
     param_types[4] = SIZE_T_TYPE;
+    param_types[5] = I32_TYPE;
     ret_type = INT8_TYPE;
 
-    if (comp_ctx->is_jit_mode)
-        GET_AOT_FUNCTION(llvm_jit_memory_init, 5);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+    if (mem_idx != 0) {
+        param_count = 6;
+        if (comp_ctx->is_jit_mode)
+            GET_AOT_FUNCTION(llvm_jit_memory_init_with_idx, 6);
+        else
+            GET_AOT_FUNCTION(aot_memory_init_with_idx, 6);
+    }
     else
-        GET_AOT_FUNCTION(aot_memory_init, 5);
+#endif
+    {
+        if (comp_ctx->is_jit_mode)
+            GET_AOT_FUNCTION(llvm_jit_memory_init, 5);
+        else
+            GET_AOT_FUNCTION(aot_memory_init, 5);
+    }
 
     /* Call function aot_memory_init() */
     param_values[0] = func_ctx->aot_inst;
@@ -1112,8 +1265,9 @@ aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     param_values[2] = offset;
     param_values[3] = len;
     param_values[4] = dst;
+    param_values[5] = I32_CONST(mem_idx);
     if (!(ret_value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
-                                     param_values, 5, "call"))) {
+                                     param_values, param_count, "call"))) {
         aot_set_last_error("llvm build call failed.");
         return false;
     }
@@ -1150,7 +1304,7 @@ bool
 aot_compile_op_data_drop(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                          uint32 seg_index)
 {
-    LLVMValueRef seg, param_values[2], ret_value, func, value;
+    LLVMValueRef seg, param_values[2], ret_value, func;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
 
     seg = I32_CONST(seg_index);
@@ -1180,7 +1334,8 @@ fail:
 }
 
 bool
-aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 dst_mem_idx, uint32 src_mem_idx)
 {
     LLVMValueRef src, dst, src_addr, dst_addr, len, res;
     bool call_aot_memmove = false;
@@ -1189,10 +1344,12 @@ aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     POP_MEM_OFFSET(src);
     POP_MEM_OFFSET(dst);
 
-    if (!(src_addr = check_bulk_memory_overflow(comp_ctx, func_ctx, src, len)))
+    if (!(src_addr = check_bulk_memory_overflow(comp_ctx, func_ctx,
+                                                src_mem_idx, src, len)))
         return false;
 
-    if (!(dst_addr = check_bulk_memory_overflow(comp_ctx, func_ctx, dst, len)))
+    if (!(dst_addr = check_bulk_memory_overflow(comp_ctx, func_ctx,
+                                                dst_mem_idx, dst, len)))
         return false;
 
     if (!zero_extend_u64(comp_ctx, &len, "len64")) {
@@ -1220,9 +1377,9 @@ aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func = I64_CONST((uint64)(uintptr_t)aot_memmove))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_func_ref(comp_ctx, "aot_memmove",
+                                              (void *)aot_memmove,
+                                              func_type))) {
                 return false;
             }
         }
@@ -1268,7 +1425,8 @@ jit_memset(void *s, int c, size_t n)
 }
 
 bool
-aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx)
 {
     LLVMValueRef val, dst, dst_addr, len, res;
     LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
@@ -1278,7 +1436,8 @@ aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     POP_I32(val);
     POP_MEM_OFFSET(dst);
 
-    if (!(dst_addr = check_bulk_memory_overflow(comp_ctx, func_ctx, dst, len)))
+    if (!(dst_addr = check_bulk_memory_overflow(comp_ctx, func_ctx, mem_idx,
+                                                dst, len)))
         return false;
 
     if (!zero_extend_u64(comp_ctx, &len, "len64")) {
@@ -1301,9 +1460,8 @@ aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     }
 
     if (comp_ctx->is_jit_mode) {
-        if (!(func = I64_CONST((uint64)(uintptr_t)jit_memset))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_func_ref(comp_ctx, "jit_memset",
+                                          (void *)jit_memset, func_type))) {
             return false;
         }
     }
@@ -1345,8 +1503,8 @@ fail:
 #if WASM_ENABLE_SHARED_MEMORY != 0
 bool
 aot_compile_op_atomic_rmw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                          uint8 atomic_op, uint8 op_type, uint32 align,
-                          mem_offset_t offset, uint32 bytes)
+                          uint8 atomic_op, uint8 op_type, uint32 mem_idx,
+                          uint32 align, mem_offset_t offset, uint32 bytes)
 {
     LLVMValueRef maddr, value, result;
     bool enable_segue = (op_type == VALUE_TYPE_I32)
@@ -1355,13 +1513,15 @@ aot_compile_op_atomic_rmw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             : comp_ctx->enable_segue_i64_load
                                   && comp_ctx->enable_segue_i64_store;
 
+    enable_segue = enable_segue && mem_idx == 0;
+
     if (op_type == VALUE_TYPE_I32)
         POP_I32(value);
     else
         POP_I64(value);
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, NULL)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, NULL)))
         return false;
 
     if (!check_memory_alignment(comp_ctx, func_ctx, maddr, align))
@@ -1432,7 +1592,8 @@ fail:
 bool
 aot_compile_op_atomic_cmpxchg(AOTCompContext *comp_ctx,
                               AOTFuncContext *func_ctx, uint8 op_type,
-                              uint32 align, mem_offset_t offset, uint32 bytes)
+                              uint32 mem_idx, uint32 align, mem_offset_t offset,
+                              uint32 bytes)
 {
     LLVMValueRef maddr, value, expect, result;
     bool enable_segue = (op_type == VALUE_TYPE_I32)
@@ -1441,6 +1602,8 @@ aot_compile_op_atomic_cmpxchg(AOTCompContext *comp_ctx,
                             : comp_ctx->enable_segue_i64_load
                                   && comp_ctx->enable_segue_i64_store;
 
+    enable_segue = enable_segue && mem_idx == 0;
+
     if (op_type == VALUE_TYPE_I32) {
         POP_I32(value);
         POP_I32(expect);
@@ -1450,8 +1613,8 @@ aot_compile_op_atomic_cmpxchg(AOTCompContext *comp_ctx,
         POP_I64(expect);
     }
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            enable_segue, NULL)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, enable_segue, NULL)))
         return false;
 
     if (!check_memory_alignment(comp_ctx, func_ctx, maddr, align))
@@ -1537,10 +1700,10 @@ fail:
 
 bool
 aot_compile_op_atomic_wait(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 op_type, uint32 align, mem_offset_t offset,
-                           uint32 bytes)
+                           uint8 op_type, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset, uint32 bytes)
 {
-    LLVMValueRef maddr, value, timeout, expect, cmp;
+    LLVMValueRef maddr, timeout, expect, cmp;
     LLVMValueRef param_values[5], ret_value, func, is_wait64;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
     LLVMBasicBlockRef wait_fail, wait_success;
@@ -1563,8 +1726,8 @@ aot_compile_op_atomic_wait(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     CHECK_LLVM_CONST(is_wait64);
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            false, NULL)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, false, NULL)))
         return false;
 
     if (!check_memory_alignment(comp_ctx, func_ctx, maddr, align))
@@ -1628,17 +1791,17 @@ fail:
 
 bool
 aot_compiler_op_atomic_notify(AOTCompContext *comp_ctx,
-                              AOTFuncContext *func_ctx, uint32 align,
-                              mem_offset_t offset, uint32 bytes)
+                              AOTFuncContext *func_ctx, uint32 mem_idx,
+                              uint32 align, mem_offset_t offset, uint32 bytes)
 {
-    LLVMValueRef maddr, value, count;
+    LLVMValueRef maddr, count;
     LLVMValueRef param_values[3], ret_value, func;
     LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
 
     POP_I32(count);
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes,
-                                            false, NULL)))
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
+                                            bytes, false, NULL)))
         return false;
 
     if (!check_memory_alignment(comp_ctx, func_ctx, maddr, align))
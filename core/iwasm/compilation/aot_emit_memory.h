@@ -17,50 +17,52 @@ extern "C" {
 
 bool
 aot_compile_op_i32_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset, uint32 bytes,
-                        bool sign, bool atomic);
+                        uint32 mem_idx, uint32 align, mem_offset_t offset,
+                        uint32 bytes, bool sign, bool atomic);
 
 bool
 aot_compile_op_i64_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset, uint32 bytes,
-                        bool sign, bool atomic);
+                        uint32 mem_idx, uint32 align, mem_offset_t offset,
+                        uint32 bytes, bool sign, bool atomic);
 
 bool
 aot_compile_op_f32_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset);
+                        uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 bool
 aot_compile_op_f64_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                        uint32 align, mem_offset_t offset);
+                        uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 bool
 aot_compile_op_i32_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset, uint32 bytes,
-                         bool atomic);
+                         uint32 mem_idx, uint32 align, mem_offset_t offset,
+                         uint32 bytes, bool atomic);
 
 bool
 aot_compile_op_i64_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset, uint32 bytes,
-                         bool atomic);
+                         uint32 mem_idx, uint32 align, mem_offset_t offset,
+                         uint32 bytes, bool atomic);
 
 bool
 aot_compile_op_f32_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset);
+                         uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 bool
 aot_compile_op_f64_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                         uint32 align, mem_offset_t offset);
+                         uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 LLVMValueRef
 aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                          mem_offset_t offset, uint32 bytes, bool enable_segue,
-                          unsigned int *alignp);
+                          uint32 mem_idx, mem_offset_t offset, uint32 bytes,
+                          bool enable_segue, unsigned int *alignp);
 
 bool
-aot_compile_op_memory_size(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+aot_compile_op_memory_size(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx);
 
 bool
-aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx);
 
 bool
 check_memory_alignment(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -68,44 +70,48 @@ check_memory_alignment(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 LLVMValueRef
 check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           LLVMValueRef offset, LLVMValueRef bytes);
+                           uint32 mem_idx, LLVMValueRef offset,
+                           LLVMValueRef bytes);
 
 #if WASM_ENABLE_BULK_MEMORY != 0
 bool
 aot_compile_op_memory_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint32 seg_index);
+                           uint32 mem_idx, uint32 seg_index);
 
 bool
 aot_compile_op_data_drop(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                          uint32 seg_index);
 
 bool
-aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 dst_mem_idx, uint32 src_mem_idx);
 
 bool
-aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
+aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                           uint32 mem_idx);
 #endif
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
 bool
 aot_compile_op_atomic_rmw(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                          uint8 atomic_op, uint8 op_type, uint32 align,
-                          mem_offset_t offset, uint32 bytes);
+                          uint8 atomic_op, uint8 op_type, uint32 mem_idx,
+                          uint32 align, mem_offset_t offset, uint32 bytes);
 
 bool
 aot_compile_op_atomic_cmpxchg(AOTCompContext *comp_ctx,
                               AOTFuncContext *func_ctx, uint8 op_type,
-                              uint32 align, mem_offset_t offset, uint32 bytes);
+                              uint32 mem_idx, uint32 align, mem_offset_t offset,
+                              uint32 bytes);
 
 bool
 aot_compile_op_atomic_wait(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 op_type, uint32 align, mem_offset_t offset,
-                           uint32 bytes);
+                           uint8 op_type, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset, uint32 bytes);
 
 bool
 aot_compiler_op_atomic_notify(AOTCompContext *comp_ctx,
-                              AOTFuncContext *func_ctx, uint32 align,
-                              mem_offset_t offset, uint32 bytes);
+                              AOTFuncContext *func_ctx, uint32 mem_idx,
+                              uint32 align, mem_offset_t offset, uint32 bytes);
 
 bool
 aot_compiler_op_atomic_fence(AOTCompContext *comp_ctx,
@@ -106,7 +106,7 @@ aot_call_wasm_stringref_obj_new(AOTCompContext *comp_ctx,
                                 uint32 stringref_type, uint32 pos,
                                 LLVMValueRef *stringref_obj)
 {
-    LLVMValueRef param_values[3], func, value, res;
+    LLVMValueRef param_values[3], func, res;
     LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
     uint32 argc = 2;
 
@@ -374,7 +374,7 @@ aot_compile_op_string_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 encoding)
 {
     LLVMValueRef maddr, byte_length, offset, str_obj, stringref_obj;
-    LLVMValueRef param_values[5], func, value;
+    LLVMValueRef param_values[5], func;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
     DEFINE_STRINGREF_CHECK_VAR();
 
@@ -387,7 +387,7 @@ aot_compile_op_string_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     POP_I32(byte_length);
     POP_I32(offset);
 
-    if (!(maddr = check_bulk_memory_overflow(comp_ctx, func_ctx, offset,
+    if (!(maddr = check_bulk_memory_overflow(comp_ctx, func_ctx, 0, offset,
                                              byte_length)))
         goto fail;
 
@@ -428,8 +428,10 @@ bool
 aot_compile_op_string_const(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             uint32 contents)
 {
-    LLVMValueRef param_values[2], func, value, str_obj, stringref_obj;
+    LLVMValueRef param_values[2], func, str_obj, stringref_obj;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
+    const uint8 *string_literal;
+    char buf[32];
     DEFINE_STRINGREF_CHECK_VAR();
 
     if (!aot_gen_commit_values(comp_ctx->aot_frame))
@@ -445,10 +447,18 @@ aot_compile_op_string_const(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     GET_AOT_FUNCTION(wasm_string_new_const, 2);
 
     bh_assert(contents < comp_ctx->comp_data->string_literal_count);
-    param_values[0] = LLVMConstIntToPtr(
-        I64_CONST((unsigned long long)(uintptr_t)
-                      comp_ctx->comp_data->string_literal_ptrs_wp[contents]),
-        INT8_PTR_TYPE);
+    string_literal = comp_ctx->comp_data->string_literal_ptrs_wp[contents];
+    if (comp_ctx->is_jit_mode) {
+        snprintf(buf, sizeof(buf), "aot_jit_string_literal#%u", contents);
+        if (!(param_values[0] =
+                  aot_get_jit_data_ref(comp_ctx, buf, string_literal)))
+            goto fail;
+    }
+    else {
+        param_values[0] = LLVMConstIntToPtr(
+            I64_CONST((unsigned long long)(uintptr_t)string_literal),
+            INT8_PTR_TYPE);
+    }
     param_values[1] =
         I32_CONST(comp_ctx->comp_data->string_literal_lengths_wp[contents]);
 
@@ -516,8 +526,8 @@ aot_compile_op_string_encode(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
-    if (!(maddr =
-              check_bulk_memory_overflow(comp_ctx, func_ctx, offset, length)))
+    if (!(maddr = check_bulk_memory_overflow(comp_ctx, func_ctx, 0, offset,
+                                             length)))
         goto fail;
 
     param_types[0] = INT8_PTR_TYPE;
@@ -556,7 +566,7 @@ fail:
 bool
 aot_compile_op_string_concat(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 {
-    LLVMValueRef param_values[2], func, value, str_obj_lhs, str_obj_rhs,
+    LLVMValueRef param_values[2], func, str_obj_lhs, str_obj_rhs,
         stringref_obj_lhs, stringref_obj_rhs, stringref_obj_new;
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
     DEFINE_STRINGREF_CHECK_VAR();
@@ -768,8 +778,8 @@ aot_compile_op_stringview_wtf8_encode(AOTCompContext *comp_ctx,
         goto fail;
     }
 
-    if (!(maddr =
-              check_bulk_memory_overflow(comp_ctx, func_ctx, offset, bytes)))
+    if (!(maddr = check_bulk_memory_overflow(comp_ctx, func_ctx, 0, offset,
+                                             bytes)))
         goto fail;
 
     POP_GC_REF(stringref_obj);
@@ -985,7 +995,7 @@ aot_compile_op_stringview_wtf16_encode(AOTCompContext *comp_ctx,
     POP_I32(offset);
 
     if (!(maddr = check_bulk_memory_overflow(
-              comp_ctx, func_ctx, offset,
+              comp_ctx, func_ctx, 0, offset,
               LLVMBuildMul(comp_ctx->builder, len, I32_CONST(2), "wtf16_len"))))
         goto fail;
 
@@ -1303,7 +1313,7 @@ aot_compile_op_string_new_array(AOTCompContext *comp_ctx,
 {
     LLVMValueRef start, end, count, str_obj, stringref_obj, array_obj,
         elem_data_ptr;
-    LLVMValueRef param_values[5], func, value;
+    LLVMValueRef param_values[5], func;
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
     DEFINE_STRINGREF_CHECK_VAR();
 
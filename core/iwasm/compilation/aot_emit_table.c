@@ -95,7 +95,7 @@ aot_compile_op_elem_drop(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                          uint32 tbl_seg_idx)
 {
     LLVMTypeRef param_types[2], ret_type, func_type, func_ptr_type;
-    LLVMValueRef param_values[2], ret_value, func, value;
+    LLVMValueRef param_values[2], ret_value, func;
 
     /* void aot_drop_table_seg(AOTModuleInstance *, uint32 ) */
     param_types[0] = INT8_PTR_TYPE;
@@ -355,7 +355,7 @@ aot_compile_op_table_init(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 tbl_idx, uint32 tbl_seg_idx)
 
 {
-    LLVMValueRef func, param_values[6], value;
+    LLVMValueRef func, param_values[6];
     LLVMTypeRef param_types[6], ret_type, func_type, func_ptr_type;
 
     param_types[0] = INT8_PTR_TYPE;
@@ -407,7 +407,7 @@ aot_compile_op_table_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 src_tbl_idx, uint32 dst_tbl_idx)
 {
     LLVMTypeRef param_types[6], ret_type, func_type, func_ptr_type;
-    LLVMValueRef func, param_values[6], value;
+    LLVMValueRef func, param_values[6];
 
     param_types[0] = INT8_PTR_TYPE;
     param_types[1] = I32_TYPE;
@@ -496,7 +496,7 @@ aot_compile_op_table_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 tbl_idx)
 {
     LLVMTypeRef param_types[4], ret_type, func_type, func_ptr_type;
-    LLVMValueRef func, param_values[4], ret, value;
+    LLVMValueRef func, param_values[4], ret;
 
     param_types[0] = INT8_PTR_TYPE;
     param_types[1] = I32_TYPE;
@@ -557,7 +557,7 @@ aot_compile_op_table_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           uint32 tbl_idx)
 {
     LLVMTypeRef param_types[5], ret_type, func_type, func_ptr_type;
-    LLVMValueRef func, param_values[5], value;
+    LLVMValueRef func, param_values[5];
 
     param_types[0] = INT8_PTR_TYPE;
     param_types[1] = I32_TYPE;
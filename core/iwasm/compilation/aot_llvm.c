@@ -11,6 +11,7 @@
 #include "../aot/aot_runtime.h"
 #include "../aot/aot_intrinsic.h"
 #include "../interpreter/wasm_runtime.h"
+#include "../../version.h"
 
 #if WASM_ENABLE_DEBUG_AOT != 0
 #include "debug/dwarf_extractor.h"
@@ -1187,40 +1188,21 @@ create_local_variables(const AOTCompData *comp_data,
 }
 
 static bool
-create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                   LLVMTypeRef int8_ptr_type, uint32 func_index)
+create_memory_info_of_idx(const AOTCompContext *comp_ctx,
+                          AOTFuncContext *func_ctx, LLVMTypeRef int8_ptr_type,
+                          bool mem_space_unchanged, uint32 mem_idx)
 {
+    AOTMemInfo *mem_info = &func_ctx->mem_info[mem_idx];
     LLVMValueRef offset, mem_info_base;
-    uint32 memory_count;
-    WASMModule *module = comp_ctx->comp_data->wasm_module;
-    WASMFunction *func = module->functions[func_index];
     LLVMTypeRef bound_check_type;
-    bool mem_space_unchanged =
-        (!func->has_op_memory_grow && !func->has_op_func_call)
-        || (!module->possible_memory_grow);
 #if WASM_ENABLE_SHARED_MEMORY != 0
     bool is_shared_memory;
 #endif
 
-    func_ctx->mem_space_unchanged = mem_space_unchanged;
-
-    memory_count = module->memory_count + module->import_memory_count;
-    /* If the module doesn't have memory, reserve
-        one mem_info space with empty content */
-    if (memory_count == 0)
-        memory_count = 1;
-
-    if (!(func_ctx->mem_info =
-              wasm_runtime_malloc(sizeof(AOTMemInfo) * memory_count))) {
-        return false;
-    }
-    memset(func_ctx->mem_info, 0, sizeof(AOTMemInfo));
-
-    /* Currently we only create memory info for memory 0 */
     /* Load memory base address */
 #if WASM_ENABLE_SHARED_MEMORY != 0
     is_shared_memory =
-        comp_ctx->comp_data->memories[0].flags & 0x02 ? true : false;
+        comp_ctx->comp_data->memories[mem_idx].flags & 0x02 ? true : false;
     if (is_shared_memory) {
         LLVMValueRef shared_mem_addr;
         offset = I32_CONST(offsetof(AOTModuleInstance, memories));
@@ -1249,6 +1231,16 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             aot_set_last_error("llvm build load failed");
             return false;
         }
+        if (mem_idx > 0) {
+            /* aot_inst->memories[mem_idx] */
+            offset = I32_CONST(mem_idx * comp_ctx->pointer_size);
+            if (!(shared_mem_addr = LLVMBuildInBoundsGEP2(
+                      comp_ctx->builder, INT8_TYPE, shared_mem_addr, &offset,
+                      1, "shared_mem_addr_offset"))) {
+                aot_set_last_error("llvm build in bounds gep failed");
+                return false;
+            }
+        }
         if (!(shared_mem_addr =
                   LLVMBuildBitCast(comp_ctx->builder, shared_mem_addr,
                                    int8_ptr_type, "shared_mem_addr_ptr"))) {
@@ -1261,26 +1253,25 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             aot_set_last_error("llvm build load failed");
             return false;
         }
-        /* memories[0]->memory_data */
+        /* memories[mem_idx]->memory_data */
         offset = I32_CONST(offsetof(AOTMemoryInstance, memory_data));
-        if (!(func_ctx->mem_info[0].mem_base_addr = LLVMBuildInBoundsGEP2(
+        if (!(mem_info->mem_base_addr = LLVMBuildInBoundsGEP2(
                   comp_ctx->builder, INT8_TYPE, shared_mem_addr, &offset, 1,
                   "mem_base_addr_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
             return false;
         }
-        /* memories[0]->cur_page_count */
+        /* memories[mem_idx]->cur_page_count */
         offset = I32_CONST(offsetof(AOTMemoryInstance, cur_page_count));
-        if (!(func_ctx->mem_info[0].mem_cur_page_count_addr =
-                  LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                        shared_mem_addr, &offset, 1,
-                                        "mem_cur_page_offset"))) {
+        if (!(mem_info->mem_cur_page_count_addr = LLVMBuildInBoundsGEP2(
+                  comp_ctx->builder, INT8_TYPE, shared_mem_addr, &offset, 1,
+                  "mem_cur_page_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
             return false;
         }
-        /* memories[0]->memory_data_size */
+        /* memories[mem_idx]->memory_data_size */
         offset = I32_CONST(offsetof(AOTMemoryInstance, memory_data_size));
-        if (!(func_ctx->mem_info[0].mem_data_size_addr = LLVMBuildInBoundsGEP2(
+        if (!(mem_info->mem_data_size_addr = LLVMBuildInBoundsGEP2(
                   comp_ctx->builder, INT8_TYPE, shared_mem_addr, &offset, 1,
                   "mem_data_size_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
@@ -1298,10 +1289,14 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         else
             offset_of_global_table_data =
                 offsetof(AOTModuleInstance, global_table_data);
+        /* The memory instances are laid out one by one at the beginning
+           of global_table_data */
+        offset_of_global_table_data +=
+            mem_idx * (uint32)sizeof(AOTMemoryInstance);
 
         offset = I32_CONST(offset_of_global_table_data
                            + offsetof(AOTMemoryInstance, memory_data));
-        if (!(func_ctx->mem_info[0].mem_base_addr = LLVMBuildInBoundsGEP2(
+        if (!(mem_info->mem_base_addr = LLVMBuildInBoundsGEP2(
                   comp_ctx->builder, INT8_TYPE, func_ctx->aot_inst, &offset, 1,
                   "mem_base_addr_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
@@ -1309,16 +1304,15 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
         offset = I32_CONST(offset_of_global_table_data
                            + offsetof(AOTMemoryInstance, cur_page_count));
-        if (!(func_ctx->mem_info[0].mem_cur_page_count_addr =
-                  LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                        func_ctx->aot_inst, &offset, 1,
-                                        "mem_cur_page_offset"))) {
+        if (!(mem_info->mem_cur_page_count_addr = LLVMBuildInBoundsGEP2(
+                  comp_ctx->builder, INT8_TYPE, func_ctx->aot_inst, &offset, 1,
+                  "mem_cur_page_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
             return false;
         }
         offset = I32_CONST(offset_of_global_table_data
                            + offsetof(AOTMemoryInstance, memory_data_size));
-        if (!(func_ctx->mem_info[0].mem_data_size_addr = LLVMBuildInBoundsGEP2(
+        if (!(mem_info->mem_data_size_addr = LLVMBuildInBoundsGEP2(
                   comp_ctx->builder, INT8_TYPE, func_ctx->aot_inst, &offset, 1,
                   "mem_data_size_offset"))) {
             aot_set_last_error("llvm build in bounds gep failed");
@@ -1326,43 +1320,43 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
     }
     /* Store mem info base address before cast */
-    mem_info_base = func_ctx->mem_info[0].mem_base_addr;
+    mem_info_base = mem_info->mem_base_addr;
 
-    if (!(func_ctx->mem_info[0].mem_base_addr = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_base_addr,
-              int8_ptr_type, "mem_base_addr_ptr"))) {
+    if (!(mem_info->mem_base_addr =
+              LLVMBuildBitCast(comp_ctx->builder, mem_info->mem_base_addr,
+                               int8_ptr_type, "mem_base_addr_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_cur_page_count_addr = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_cur_page_count_addr,
+    if (!(mem_info->mem_cur_page_count_addr = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_cur_page_count_addr,
               INT32_PTR_TYPE, "mem_cur_page_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_data_size_addr = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_data_size_addr,
-              INT64_PTR_TYPE, "mem_data_size_ptr"))) {
+    if (!(mem_info->mem_data_size_addr =
+              LLVMBuildBitCast(comp_ctx->builder, mem_info->mem_data_size_addr,
+                               INT64_PTR_TYPE, "mem_data_size_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_base_addr = LLVMBuildLoad2(
-                  comp_ctx->builder, OPQ_PTR_TYPE,
-                  func_ctx->mem_info[0].mem_base_addr, "mem_base_addr"))) {
+        if (!(mem_info->mem_base_addr = LLVMBuildLoad2(
+                  comp_ctx->builder, OPQ_PTR_TYPE, mem_info->mem_base_addr,
+                  "mem_base_addr"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
-        if (!(func_ctx->mem_info[0].mem_cur_page_count_addr =
+        if (!(mem_info->mem_cur_page_count_addr =
                   LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
-                                 func_ctx->mem_info[0].mem_cur_page_count_addr,
+                                 mem_info->mem_cur_page_count_addr,
                                  "mem_cur_page_count"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
-        if (!(func_ctx->mem_info[0].mem_data_size_addr = LLVMBuildLoad2(
-                  comp_ctx->builder, I64_TYPE,
-                  func_ctx->mem_info[0].mem_data_size_addr, "mem_data_size"))) {
+        if (!(mem_info->mem_data_size_addr = LLVMBuildLoad2(
+                  comp_ctx->builder, I64_TYPE, mem_info->mem_data_size_addr,
+                  "mem_data_size"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1371,9 +1365,9 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     else if (is_shared_memory) {
         /* The base address for shared memory will never changed,
             we can load the value here */
-        if (!(func_ctx->mem_info[0].mem_base_addr = LLVMBuildLoad2(
-                  comp_ctx->builder, OPQ_PTR_TYPE,
-                  func_ctx->mem_info[0].mem_base_addr, "mem_base_addr"))) {
+        if (!(mem_info->mem_base_addr = LLVMBuildLoad2(
+                  comp_ctx->builder, OPQ_PTR_TYPE, mem_info->mem_base_addr,
+                  "mem_base_addr"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1387,25 +1381,24 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     /* Load memory bound check constants */
     offset = I32_CONST(offsetof(AOTMemoryInstance, mem_bound_check_1byte)
                        - offsetof(AOTMemoryInstance, memory_data));
-    if (!(func_ctx->mem_info[0].mem_bound_check_1byte =
+    if (!(mem_info->mem_bound_check_1byte =
               LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, mem_info_base,
                                     &offset, 1, "bound_check_1byte_offset"))) {
         aot_set_last_error("llvm build in bounds gep failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_bound_check_1byte = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_bound_check_1byte,
+    if (!(mem_info->mem_bound_check_1byte = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_bound_check_1byte,
               bound_check_type, "bound_check_1byte_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_bound_check_1byte = LLVMBuildLoad2(
+        if (!(mem_info->mem_bound_check_1byte = LLVMBuildLoad2(
                   comp_ctx->builder,
                   (comp_ctx->pointer_size == sizeof(uint64)) ? I64_TYPE
                                                              : I32_TYPE,
-                  func_ctx->mem_info[0].mem_bound_check_1byte,
-                  "bound_check_1byte"))) {
+                  mem_info->mem_bound_check_1byte, "bound_check_1byte"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1413,25 +1406,24 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     offset = I32_CONST(offsetof(AOTMemoryInstance, mem_bound_check_2bytes)
                        - offsetof(AOTMemoryInstance, memory_data));
-    if (!(func_ctx->mem_info[0].mem_bound_check_2bytes =
+    if (!(mem_info->mem_bound_check_2bytes =
               LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, mem_info_base,
                                     &offset, 1, "bound_check_2bytes_offset"))) {
         aot_set_last_error("llvm build in bounds gep failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_bound_check_2bytes = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_bound_check_2bytes,
+    if (!(mem_info->mem_bound_check_2bytes = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_bound_check_2bytes,
               bound_check_type, "bound_check_2bytes_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_bound_check_2bytes = LLVMBuildLoad2(
+        if (!(mem_info->mem_bound_check_2bytes = LLVMBuildLoad2(
                   comp_ctx->builder,
                   (comp_ctx->pointer_size == sizeof(uint64)) ? I64_TYPE
                                                              : I32_TYPE,
-                  func_ctx->mem_info[0].mem_bound_check_2bytes,
-                  "bound_check_2bytes"))) {
+                  mem_info->mem_bound_check_2bytes, "bound_check_2bytes"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1439,25 +1431,24 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     offset = I32_CONST(offsetof(AOTMemoryInstance, mem_bound_check_4bytes)
                        - offsetof(AOTMemoryInstance, memory_data));
-    if (!(func_ctx->mem_info[0].mem_bound_check_4bytes =
+    if (!(mem_info->mem_bound_check_4bytes =
               LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, mem_info_base,
                                     &offset, 1, "bound_check_4bytes_offset"))) {
         aot_set_last_error("llvm build in bounds gep failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_bound_check_4bytes = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_bound_check_4bytes,
+    if (!(mem_info->mem_bound_check_4bytes = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_bound_check_4bytes,
               bound_check_type, "bound_check_4bytes_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_bound_check_4bytes = LLVMBuildLoad2(
+        if (!(mem_info->mem_bound_check_4bytes = LLVMBuildLoad2(
                   comp_ctx->builder,
                   (comp_ctx->pointer_size == sizeof(uint64)) ? I64_TYPE
                                                              : I32_TYPE,
-                  func_ctx->mem_info[0].mem_bound_check_4bytes,
-                  "bound_check_4bytes"))) {
+                  mem_info->mem_bound_check_4bytes, "bound_check_4bytes"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1465,25 +1456,24 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     offset = I32_CONST(offsetof(AOTMemoryInstance, mem_bound_check_8bytes)
                        - offsetof(AOTMemoryInstance, memory_data));
-    if (!(func_ctx->mem_info[0].mem_bound_check_8bytes =
+    if (!(mem_info->mem_bound_check_8bytes =
               LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, mem_info_base,
                                     &offset, 1, "bound_check_8bytes_offset"))) {
         aot_set_last_error("llvm build in bounds gep failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_bound_check_8bytes = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_bound_check_8bytes,
+    if (!(mem_info->mem_bound_check_8bytes = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_bound_check_8bytes,
               bound_check_type, "bound_check_8bytes_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_bound_check_8bytes = LLVMBuildLoad2(
+        if (!(mem_info->mem_bound_check_8bytes = LLVMBuildLoad2(
                   comp_ctx->builder,
                   (comp_ctx->pointer_size == sizeof(uint64)) ? I64_TYPE
                                                              : I32_TYPE,
-                  func_ctx->mem_info[0].mem_bound_check_8bytes,
-                  "bound_check_8bytes"))) {
+                  mem_info->mem_bound_check_8bytes, "bound_check_8bytes"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1491,25 +1481,24 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     offset = I32_CONST(offsetof(AOTMemoryInstance, mem_bound_check_16bytes)
                        - offsetof(AOTMemoryInstance, memory_data));
-    if (!(func_ctx->mem_info[0].mem_bound_check_16bytes = LLVMBuildInBoundsGEP2(
+    if (!(mem_info->mem_bound_check_16bytes = LLVMBuildInBoundsGEP2(
               comp_ctx->builder, INT8_TYPE, mem_info_base, &offset, 1,
               "bound_check_16bytes_offset"))) {
         aot_set_last_error("llvm build in bounds gep failed");
         return false;
     }
-    if (!(func_ctx->mem_info[0].mem_bound_check_16bytes = LLVMBuildBitCast(
-              comp_ctx->builder, func_ctx->mem_info[0].mem_bound_check_16bytes,
+    if (!(mem_info->mem_bound_check_16bytes = LLVMBuildBitCast(
+              comp_ctx->builder, mem_info->mem_bound_check_16bytes,
               bound_check_type, "bound_check_16bytes_ptr"))) {
         aot_set_last_error("llvm build bit cast failed");
         return false;
     }
     if (mem_space_unchanged) {
-        if (!(func_ctx->mem_info[0].mem_bound_check_16bytes = LLVMBuildLoad2(
+        if (!(mem_info->mem_bound_check_16bytes = LLVMBuildLoad2(
                   comp_ctx->builder,
                   (comp_ctx->pointer_size == sizeof(uint64)) ? I64_TYPE
                                                              : I32_TYPE,
-                  func_ctx->mem_info[0].mem_bound_check_16bytes,
-                  "bound_check_16bytes"))) {
+                  mem_info->mem_bound_check_16bytes, "bound_check_16bytes"))) {
             aot_set_last_error("llvm build load failed");
             return false;
         }
@@ -1518,6 +1507,44 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+static bool
+create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                   LLVMTypeRef int8_ptr_type, uint32 func_index)
+{
+    uint32 memory_count, i;
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+    WASMFunction *func = module->functions[func_index];
+    bool mem_space_unchanged =
+        (!func->has_op_memory_grow && !func->has_op_func_call)
+        || (!module->possible_memory_grow);
+
+    func_ctx->mem_space_unchanged = mem_space_unchanged;
+
+    memory_count = module->memory_count + module->import_memory_count;
+    /* If the module doesn't have memory, reserve
+        one mem_info space with empty content */
+    if (memory_count == 0)
+        memory_count = 1;
+
+    if (!(func_ctx->mem_info =
+              wasm_runtime_malloc(sizeof(AOTMemInfo) * memory_count))) {
+        return false;
+    }
+    memset(func_ctx->mem_info, 0, sizeof(AOTMemInfo) * memory_count);
+
+#if WASM_ENABLE_MULTI_MEMORY == 0
+    /* Only memory 0 is accessed without multi-memory */
+    memory_count = 1;
+#endif
+    for (i = 0; i < memory_count; i++) {
+        if (!create_memory_info_of_idx(comp_ctx, func_ctx, int8_ptr_type,
+                                       mem_space_unchanged, i))
+            return false;
+    }
+
+    return true;
+}
+
 static bool
 create_cur_exception(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 {
@@ -2365,8 +2392,78 @@ jit_stack_size_callback(void *user_data, const char *name, size_t namelen,
     comp_ctx->jit_stack_sizes[func_idx] = (uint32)stack_size + call_size;
 }
 
+#if WASM_ENABLE_JIT != 0
+static uint64
+jit_cache_hash(uint64 hash, const void *data, uint64 size)
+{
+    const uint8 *p = data, *p_end = p + size;
+
+    /* FNV-1a */
+    while (p < p_end) {
+        hash ^= *p++;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/* The cache key identifies the wasm module, the options which affect the
+   generated code, the host CPU and the runtime build */
+static void
+jit_cache_key(AOTCompContext *comp_ctx, AOTCompOption *option, char *buf,
+              uint32 buf_size)
+{
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+    char *cpu = LLVMGetHostCPUName(), *features = LLVMGetHostCPUFeatures();
+    uint64 module_hash, config_hash = 0xcbf29ce484222325ULL;
+    uint32 config[] = {
+        WAMR_VERSION_MAJOR,
+        WAMR_VERSION_MINOR,
+        WAMR_VERSION_PATCH,
+        LLVM_VERSION_MAJOR,
+        LLVM_VERSION_MINOR,
+        (uint32)sizeof(WASMModuleInstance),
+        (uint32)sizeof(WASMMemoryInstance),
+        (uint32)sizeof(WASMExecEnv),
+        option->opt_level,
+        option->size_level,
+        option->segue_flags,
+        option->bounds_checks,
+        option->enable_bulk_memory,
+        option->enable_thread_mgr,
+        option->enable_tail_call,
+        option->enable_simd,
+        option->enable_ref_types,
+        option->enable_gc,
+        option->enable_exce_handling,
+        option->enable_shared_heap,
+        option->enable_aux_stack_check,
+        option->enable_aux_stack_frame,
+        option->enable_perf_profiling,
+        option->enable_memory_profiling,
+        option->quick_invoke_c_api_import,
+        comp_ctx->enable_bound_check,
+    };
+
+    module_hash = jit_cache_hash(0xcbf29ce484222325ULL, module->load_addr,
+                                 module->load_size);
+    config_hash = jit_cache_hash(config_hash, config, sizeof(config));
+    if (cpu)
+        config_hash = jit_cache_hash(config_hash, cpu, strlen(cpu));
+    if (features)
+        config_hash = jit_cache_hash(config_hash, features, strlen(features));
+
+    snprintf(buf, buf_size, "%016" PRIx64 "-O%u-s%u-%016" PRIx64, module_hash,
+             option->opt_level, option->size_level, config_hash);
+
+    if (cpu)
+        LLVMDisposeMessage(cpu);
+    if (features)
+        LLVMDisposeMessage(features);
+}
+#endif
+
 static bool
-orc_jit_create(AOTCompContext *comp_ctx)
+orc_jit_create(AOTCompContext *comp_ctx, AOTCompOption *option)
 {
     LLVMErrorRef err;
     LLVMOrcLLLazyJITRef orc_jit = NULL;
@@ -2384,6 +2481,36 @@ orc_jit_create(AOTCompContext *comp_ctx)
         LLVMOrcLLJITBuilderSetCompileFunctionCreatorWithStackSizesCallback(
             builder, jit_stack_size_callback, comp_ctx);
 
+#if WASM_ENABLE_JIT != 0
+    if (option->jit_cache_dir) {
+        char key[64];
+
+        if (comp_ctx->enable_stack_bound_check
+            || comp_ctx->enable_stack_estimation) {
+            /* The stack sizes are reported by the code generator, which
+               isn't run for the objects reloaded from the cache */
+            LOG_WARNING("warning: llvm jit object cache is disabled since "
+                        "stack sizes of the jit functions are required");
+        }
+        else if (!comp_ctx->comp_data->wasm_module->load_addr) {
+            LOG_WARNING("warning: llvm jit object cache is disabled since "
+                        "the module isn't loaded from a wasm binary");
+        }
+        else {
+            jit_cache_key(comp_ctx, option, key, sizeof(key));
+            comp_ctx->orc_object_cache =
+                LLVMOrcCreateFileObjectCache(option->jit_cache_dir, key);
+            if (comp_ctx->orc_object_cache)
+                LLVMOrcLLLazyJITBuilderSetObjectCache(
+                    builder, comp_ctx->orc_object_cache);
+            else
+                LOG_WARNING("warning: failed to create llvm jit object cache "
+                            "in %s",
+                            option->jit_cache_dir);
+        }
+    }
+#endif
+
     err = LLVMOrcJITTargetMachineBuilderDetectHost(&jtmb);
     if (err != LLVMErrorSuccess) {
         aot_handle_llvm_errmsg(
@@ -2406,6 +2533,13 @@ orc_jit_create(AOTCompContext *comp_ctx)
     /* Ownership transfer: LLVMOrcLLJITBuilderRef -> LLVMOrcLLJITRef */
     builder = NULL;
 
+#if WASM_ENABLE_JIT != 0
+    /* The cached objects are looked up by the symbols of the partitions,
+       which must be the same in each run */
+    if (comp_ctx->orc_object_cache)
+        LLVMOrcLLLazyJITSetCachePartitionFunction(orc_jit);
+#endif
+
 #if WASM_ENABLE_LINUX_PERF != 0
     if (wasm_runtime_get_linux_perf()) {
         LOG_DEBUG("Enable linux perf support in JIT");
@@ -2460,6 +2594,139 @@ aot_compiler_destroy(void)
     LLVMShutdown();
 }
 
+static uint32
+get_cpu_feature_count(uint64 cpu_features)
+{
+    uint32 count = 0;
+
+    while (cpu_features) {
+        cpu_features &= cpu_features - 1;
+        count++;
+    }
+    return count;
+}
+
+static bool
+create_cpu_variants(AOTCompContext *comp_ctx, const AOTCompData *comp_data,
+                    AOTCompOption *option)
+{
+    const char *p = option->cpu_variants, *p_end;
+    char cpu[64], *endptr;
+    uint32 count = 1, i, j, func_idx;
+    AOTCPUVariant variant;
+    uint64 size;
+
+    if (strcmp(comp_ctx->target_arch, "x86_64")
+        && strcmp(comp_ctx->target_arch, "i386")) {
+        aot_set_last_error("CPU variants are only supported for the x86 "
+                           "targets.");
+        return false;
+    }
+
+    if (comp_ctx->enable_llvm_pgo) {
+        aot_set_last_error("CPU variants can't be generated with "
+                           "--enable-llvm-pgo.");
+        return false;
+    }
+
+    if (comp_ctx->enable_stack_bound_check
+        || comp_ctx->enable_stack_estimation) {
+        /* The stack usage of the variants isn't checked by the precheck
+           functions, which is computed with the function of target CPU */
+        aot_set_last_error("CPU variants can't be generated when the native "
+                           "stack bounds check is enabled, try adding "
+                           "--stack-bounds-checks=0.");
+        return false;
+    }
+
+    if (!option->cpu_variant_funcs && !option->use_prof_file) {
+        aot_set_last_error("--cpu-variant-funcs or --use-prof-file is "
+                           "required to select the functions of the CPU "
+                           "variants.");
+        return false;
+    }
+
+    while ((p = strchr(p, ','))) {
+        count++;
+        p++;
+    }
+
+    size = sizeof(AOTCPUVariant) * (uint64)count;
+    if (!(comp_ctx->cpu_variants = wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(comp_ctx->cpu_variants, 0, (uint32)size);
+
+    p = option->cpu_variants;
+    for (i = 0; i < count; i++) {
+        if (!(p_end = strchr(p, ',')))
+            p_end = p + strlen(p);
+        if (p_end == p || p_end - p >= (int32)sizeof(cpu)) {
+            aot_set_last_error_v("invalid CPU variant \"%.*s\".",
+                                 (int)(p_end - p), p);
+            return false;
+        }
+        bh_memcpy_s(cpu, sizeof(cpu), p, (uint32)(p_end - p));
+        cpu[p_end - p] = '\0';
+
+        if (!aot_resolve_cpu_variant(comp_ctx, cpu,
+                                     &comp_ctx->cpu_variants[i])) {
+            return false;
+        }
+        comp_ctx->cpu_variant_count++;
+        p = p_end + 1;
+    }
+
+    /* Sort the variants so that the runtime selects the last variant
+       supported by the host CPU */
+    for (i = 1; i < count; i++) {
+        variant = comp_ctx->cpu_variants[i];
+        for (j = i; j > 0
+                    && get_cpu_feature_count(
+                           comp_ctx->cpu_variants[j - 1].cpu_features)
+                           > get_cpu_feature_count(variant.cpu_features);
+             j--) {
+            comp_ctx->cpu_variants[j] = comp_ctx->cpu_variants[j - 1];
+        }
+        comp_ctx->cpu_variants[j] = variant;
+    }
+
+    if (!option->cpu_variant_funcs || comp_data->func_count == 0)
+        return true;
+
+    size = sizeof(bool) * (uint64)comp_data->func_count;
+    if (!(comp_ctx->cpu_variant_func_flags =
+              wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(comp_ctx->cpu_variant_func_flags, 0, (uint32)size);
+
+    p = option->cpu_variant_funcs;
+    while (true) {
+        func_idx = (uint32)strtoul(p, &endptr, 10);
+        if (endptr == p || (*endptr != ',' && *endptr != '\0')
+            || func_idx < comp_data->import_func_count
+            || func_idx >= comp_data->import_func_count
+                               + comp_data->func_count) {
+            aot_set_last_error_v("invalid function index \"%s\" of the CPU "
+                                 "variants, it should be the index of a "
+                                 "non-import function.",
+                                 p);
+            return false;
+        }
+        comp_ctx->cpu_variant_func_flags[func_idx
+                                         - comp_data->import_func_count] =
+            true;
+        if (*endptr == '\0')
+            break;
+        p = endptr + 1;
+    }
+
+    return true;
+}
+
 AOTCompContext *
 aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
 {
@@ -2530,7 +2797,8 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     }
 #endif
 
-    if (BH_LIST_ERROR == bh_list_init(&comp_ctx->native_symbols)) {
+    if (BH_LIST_ERROR == bh_list_init(&comp_ctx->native_symbols)
+        || BH_LIST_ERROR == bh_list_init(&comp_ctx->jit_symbols)) {
         goto fail;
     }
 
@@ -2584,6 +2852,12 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->is_indirect_mode)
         comp_ctx->is_indirect_mode = true;
 
+    if (option->enable_shared_text) {
+        /* Call the functions and runtime symbols through the tables */
+        comp_ctx->is_indirect_mode = true;
+        comp_ctx->enable_shared_text = true;
+    }
+
     if (option->disable_llvm_intrinsics)
         comp_ctx->disable_llvm_intrinsics = true;
 
@@ -2611,6 +2885,12 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_gc)
         comp_ctx->enable_gc = true;
 
+    if (option->enable_exce_handling)
+        comp_ctx->enable_exce_handling = true;
+
+    if (option->enable_shared_heap)
+        comp_ctx->enable_shared_heap = true;
+
     comp_ctx->opt_level = option->opt_level;
     comp_ctx->size_level = option->size_level;
 
@@ -2645,7 +2925,7 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
             goto fail;
 
         /* Create LLJIT Instance */
-        if (!orc_jit_create(comp_ctx))
+        if (!orc_jit_create(comp_ctx, option))
             goto fail;
     }
     else {
@@ -3046,11 +3326,20 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
         else
             code_model = LLVMCodeModelSmall;
 
-        /* Create the target machine */
+        if (comp_ctx->enable_shared_text
+            && strncmp(comp_ctx->target_arch, "x86_64", 6)) {
+            aot_set_last_error("shared text is only supported on x86_64.");
+            goto fail;
+        }
+
+        /* Create the target machine, the shared text is position
+           independent so that the constants and jump tables are
+           referenced relatively */
         if (!(comp_ctx->target_machine = LLVMCreateTargetMachineWithOpts(
                   target, triple_norm, cpu, features, opt_level,
-                  LLVMRelocStatic, code_model, false,
-                  comp_ctx->stack_usage_file))) {
+                  comp_ctx->enable_shared_text ? LLVMRelocPIC
+                                               : LLVMRelocStatic,
+                  code_model, false, comp_ctx->stack_usage_file))) {
             aot_set_last_error("create LLVM target machine failed.");
             goto fail;
         }
@@ -3194,6 +3483,10 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
                  aot_create_func_contexts(comp_data, comp_ctx)))
         goto fail;
 
+    if (option->cpu_variants && !comp_ctx->is_jit_mode
+        && !create_cpu_variants(comp_ctx, comp_data, option))
+        goto fail;
+
     if (cpu) {
         uint32 len = (uint32)strlen(cpu) + 1;
         if (!(comp_ctx->target_cpu = wasm_runtime_malloc(len))) {
@@ -3248,6 +3541,10 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
     if (comp_ctx->orc_jit)
         LLVMOrcDisposeLLLazyJIT(comp_ctx->orc_jit);
 
+    /* Used by the compile function of orc_jit */
+    if (comp_ctx->orc_object_cache)
+        LLVMOrcDisposeObjectCache(comp_ctx->orc_object_cache);
+
     if (comp_ctx->func_ctxes)
         aot_destroy_func_contexts(comp_ctx, comp_ctx->func_ctxes,
                                   comp_ctx->func_ctx_count);
@@ -3262,10 +3559,33 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         }
     }
 
+    if (bh_list_length(&comp_ctx->jit_symbols) > 0) {
+        AOTJITSymbol *sym = bh_list_first_elem(&comp_ctx->jit_symbols);
+        while (sym) {
+            AOTJITSymbol *t = bh_list_elem_next(sym);
+            bh_list_remove(&comp_ctx->jit_symbols, sym);
+            wasm_runtime_free(sym);
+            sym = t;
+        }
+    }
+
     if (comp_ctx->target_cpu) {
         wasm_runtime_free(comp_ctx->target_cpu);
     }
 
+    if (comp_ctx->cpu_variants) {
+        uint32 i;
+        for (i = 0; i < comp_ctx->cpu_variant_count; i++) {
+            wasm_runtime_free(comp_ctx->cpu_variants[i].cpu);
+            wasm_runtime_free(comp_ctx->cpu_variants[i].features);
+        }
+        wasm_runtime_free(comp_ctx->cpu_variants);
+    }
+
+    if (comp_ctx->cpu_variant_func_flags) {
+        wasm_runtime_free(comp_ctx->cpu_variant_func_flags);
+    }
+
     if (comp_ctx->aot_frame) {
         wasm_runtime_free(comp_ctx->aot_frame);
     }
@@ -3352,6 +3672,221 @@ aot_get_native_symbol_index(AOTCompContext *comp_ctx, const char *symbol)
     return idx;
 }
 
+static bool
+insert_jit_symbol(AOTCompContext *comp_ctx, const char *symbol, void *addr)
+{
+    AOTJITSymbol *sym = wasm_runtime_malloc(sizeof(AOTJITSymbol));
+    int ret;
+
+    if (!sym) {
+        aot_set_last_error("alloc jit symbol failed.");
+        return false;
+    }
+
+    memset(sym, 0, sizeof(AOTJITSymbol));
+    ret = snprintf(sym->symbol, sizeof(sym->symbol), "%s", symbol);
+    if (ret < 0 || ret + 1 > (int)sizeof(sym->symbol)) {
+        wasm_runtime_free(sym);
+        aot_set_last_error_v("symbol name too long: %s", symbol);
+        return false;
+    }
+    sym->addr = addr;
+
+    if (BH_LIST_ERROR == bh_list_insert(&comp_ctx->jit_symbols, sym)) {
+        wasm_runtime_free(sym);
+        aot_set_last_error("insert jit symbol to list failed.");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get the function pointer of a runtime function called by the JITed
+ * code. The address is embedded as a constant, unless the JIT object
+ * cache is enabled: the address may differ in the process which reloads
+ * the cached object, so the function is referenced by its name and
+ * resolved when the object is linked.
+ */
+LLVMValueRef
+aot_get_jit_func_ref(AOTCompContext *comp_ctx, const char *name, void *addr,
+                     LLVMTypeRef func_type)
+{
+    LLVMTypeRef func_ptr_type;
+    LLVMValueRef func;
+
+    bh_assert(comp_ctx->is_jit_mode);
+
+    if (!comp_ctx->orc_object_cache) {
+        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
+            aot_set_last_error("create LLVM function type failed.");
+            return NULL;
+        }
+        if (!(func = LLVMConstIntToPtr(I64_CONST((uint64)(uintptr_t)addr),
+                                       func_ptr_type))) {
+            aot_set_last_error("create LLVM value failed.");
+            return NULL;
+        }
+        return func;
+    }
+
+    if (!(func = LLVMGetNamedFunction(comp_ctx->module, name))) {
+        if (!(func = LLVMAddFunction(comp_ctx->module, name, func_type))) {
+            aot_set_last_error("llvm add function failed.");
+            return NULL;
+        }
+        if (!insert_jit_symbol(comp_ctx, name, addr))
+            return NULL;
+    }
+    return func;
+}
+
+/* Same as aot_get_jit_func_ref, but for runtime data, the returned value
+   is an i8 pointer */
+LLVMValueRef
+aot_get_jit_data_ref(AOTCompContext *comp_ctx, const char *name,
+                     const void *addr)
+{
+    LLVMValueRef global;
+
+    bh_assert(comp_ctx->is_jit_mode);
+
+    if (!comp_ctx->orc_object_cache) {
+        if (!(global = LLVMConstIntToPtr(I64_CONST((uint64)(uintptr_t)addr),
+                                         INT8_PTR_TYPE))) {
+            aot_set_last_error("create LLVM value failed.");
+            return NULL;
+        }
+        return global;
+    }
+
+    if (!(global = LLVMGetNamedGlobal(comp_ctx->module, name))) {
+        if (!(global = LLVMAddGlobal(comp_ctx->module, INT8_TYPE, name))) {
+            aot_set_last_error("llvm add global failed.");
+            return NULL;
+        }
+        if (!insert_jit_symbol(comp_ctx, name, (void *)addr))
+            return NULL;
+    }
+    return global;
+}
+
+/* Get the runtime address of the wasm bytecode at ip as an integer */
+LLVMValueRef
+aot_get_jit_bytecode_addr(AOTCompContext *comp_ctx, const uint8 *ip,
+                          LLVMTypeRef int_type)
+{
+    WASMModule *module = comp_ctx->comp_data->wasm_module;
+    LLVMValueRef base;
+
+    if (!comp_ctx->orc_object_cache)
+        return LLVMConstInt(int_type, (uint64)(uintptr_t)ip, false);
+
+    if (!(base = aot_get_jit_data_ref(comp_ctx, "aot_jit_bytecode_base",
+                                      module->load_addr)))
+        return NULL;
+
+    return LLVMConstAdd(
+        LLVMConstPtrToInt(base, int_type),
+        LLVMConstInt(int_type, (uint64)(ip - module->load_addr), false));
+}
+
+static bool
+promote_jit_local_symbol(LLVMValueRef value, uint32 *p_idx)
+{
+    LLVMLinkage linkage = LLVMGetLinkage(value);
+    size_t name_len;
+    char buf[32];
+
+    LLVMGetValueName2(value, &name_len);
+    if (linkage != LLVMInternalLinkage && linkage != LLVMPrivateLinkage
+        && name_len > 0)
+        return true;
+
+    snprintf(buf, sizeof(buf), "aot_jit_local#%" PRIu32, (*p_idx)++);
+    LLVMSetValueName2(value, buf, strlen(buf));
+    LLVMSetLinkage(value, LLVMExternalLinkage);
+    LLVMSetVisibility(value, LLVMHiddenVisibility);
+    return true;
+}
+
+/**
+ * Give the local and unnamed symbols of the module unique names in
+ * the module order. Otherwise CompileOnDemandLayer names them when
+ * they are referenced by the partition being compiled, and the names
+ * depend on the order in which the partitions are compiled, which
+ * makes the cached objects unusable in other runs.
+ */
+bool
+aot_promote_jit_local_symbols(AOTCompContext *comp_ctx)
+{
+    LLVMValueRef value;
+    uint32 idx = 0;
+
+    for (value = LLVMGetFirstGlobal(comp_ctx->module); value;
+         value = LLVMGetNextGlobal(value)) {
+        if (!promote_jit_local_symbol(value, &idx))
+            return false;
+    }
+
+    for (value = LLVMGetFirstFunction(comp_ctx->module); value;
+         value = LLVMGetNextFunction(value)) {
+        if (!LLVMIsDeclaration(value)
+            && !promote_jit_local_symbol(value, &idx))
+            return false;
+    }
+
+    for (value = LLVMGetFirstGlobalAlias(comp_ctx->module); value;
+         value = LLVMGetNextGlobalAlias(value)) {
+        if (!promote_jit_local_symbol(value, &idx))
+            return false;
+    }
+
+    return true;
+}
+
+/* Define the symbols referenced by the JITed code in the JIT dylib */
+bool
+aot_define_jit_symbols(AOTCompContext *comp_ctx, LLVMOrcJITDylibRef dylib)
+{
+    LLVMOrcCSymbolMapPairs pairs;
+    LLVMOrcMaterializationUnitRef mu;
+    LLVMErrorRef err;
+    AOTJITSymbol *sym;
+    uint32 count = bh_list_length(&comp_ctx->jit_symbols), i = 0;
+
+    if (count == 0)
+        return true;
+
+    if (!(pairs = wasm_runtime_malloc(sizeof(LLVMJITCSymbolMapPair) * count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    sym = bh_list_first_elem(&comp_ctx->jit_symbols);
+    while (sym) {
+        pairs[i].Name =
+            LLVMOrcLLLazyJITMangleAndIntern(comp_ctx->orc_jit, sym->symbol);
+        pairs[i].Sym.Address = (uint64)(uintptr_t)sym->addr;
+        pairs[i].Sym.Flags.GenericFlags = LLVMJITSymbolGenericFlagsExported;
+        pairs[i].Sym.Flags.TargetFlags = 0;
+        i++;
+        sym = bh_list_elem_next(sym);
+    }
+
+    /* Ownership transfer: symbol string pool entries -> mu */
+    mu = LLVMOrcAbsoluteSymbols(pairs, count);
+    wasm_runtime_free(pairs);
+
+    if ((err = LLVMOrcJITDylibDefine(dylib, mu))) {
+        LLVMOrcDisposeMaterializationUnit(mu);
+        aot_handle_llvm_errmsg("failed to define jit symbols", err);
+        return false;
+    }
+
+    return true;
+}
+
 void
 aot_value_stack_push(const AOTCompContext *comp_ctx, AOTValueStack *stack,
                      AOTValue *value)
@@ -3530,6 +4065,12 @@ aot_block_destroy(AOTCompContext *comp_ctx, AOTBlock *block)
         wasm_runtime_free(block->result_types);
     if (block->result_phis)
         wasm_runtime_free(block->result_phis);
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    if (block->wasm_code_handlers)
+        wasm_runtime_free(block->wasm_code_handlers);
+    if (block->llvm_handler_blocks)
+        wasm_runtime_free(block->llvm_handler_blocks);
+#endif
     wasm_runtime_free(block);
 }
 
@@ -65,6 +65,17 @@ extern "C" {
 #undef DUMP_MODULE
 #endif
 
+/* Placeholder functions of the speculative direct call emitted for
+   call_indirect when PGO is enabled, they are resolved with the value
+   profile of the call site in aot_apply_llvm_new_pass_manager */
+#define AOT_CALL_INDIRECT_SPEC_GUARD "aot_call_indirect_spec_guard"
+#define AOT_CALL_INDIRECT_SPEC_FUNC_IDX "aot_call_indirect_spec_func_idx"
+#define AOT_CALL_INDIRECT_SPEC_CALLEE "aot_call_indirect_spec_callee"
+
+/* Metadata kind of the call_indirect site info: site id, table index
+   and function type index */
+#define AOT_CALL_INDIRECT_MD_KIND "aot.call_indirect"
+
 struct AOTValueSlot;
 
 /**
@@ -144,7 +155,7 @@ typedef struct AOTBlock {
 
     /* Block index */
     uint32 block_index;
-    /* LABEL_TYPE_BLOCK/LOOP/IF/FUNCTION */
+    /* LABEL_TYPE_BLOCK/LOOP/IF/FUNCTION/TRY/CATCH/CATCH_ALL */
     uint32 label_type;
     /* Whether it is reachable */
     bool is_reachable;
@@ -182,6 +193,26 @@ typedef struct AOTBlock {
     /* The max frame stack pointer that br/br_if/br_table/br_on_xxx
        opcodes ever reached when they jumped to the end this block */
     AOTValueSlot *frame_sp_max_reached;
+
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* Code of catch/catch_all opcodes of this block, if it is a TRY block */
+    uint8 **wasm_code_handlers;
+    uint32 handler_count;
+    /* Whether the try block is ended with delegate opcode */
+    bool is_delegate;
+    /* The label depth of the delegate opcode */
+    uint32 delegate_depth;
+
+    /* LLVM label of the landing pad which dispatches the exceptions
+       thrown in the try block to the handlers, created on demand */
+    LLVMBasicBlockRef llvm_landing_block;
+    /* LLVM labels of the handlers, created with the landing pad */
+    LLVMBasicBlockRef *llvm_handler_blocks;
+    /* Tag index and payload of the exception caught by the landing pad,
+       they are used by the handlers and the rethrow opcode */
+    LLVMValueRef exce_tag_index;
+    LLVMValueRef exce_payload_buf;
+#endif
 } AOTBlock;
 
 /**
@@ -191,7 +222,11 @@ typedef struct AOTBlockStack {
     AOTBlock *block_list_head;
     AOTBlock *block_list_end;
     /* Current block index of each block type */
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    uint32 block_index[LABEL_TYPE_TRY + 1];
+#else
     uint32 block_index[3];
+#endif
 } AOTBlockStack;
 
 typedef struct AOTCheckedAddr {
@@ -248,6 +283,10 @@ typedef struct AOTFuncContext {
     /* current ip when exception is thrown */
     LLVMValueRef exception_ip_phi;
     LLVMValueRef func_type_indexes;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    /* The buffer to pass the payload of the exception thrown */
+    LLVMValueRef exce_throw_payload_buf;
+#endif
 #if WASM_ENABLE_DEBUG_AOT != 0
     LLVMMetadataRef debug_func;
 #endif
@@ -357,6 +396,21 @@ typedef struct AOTLLVMConsts {
     LLVMValueRef i8_ptr_null;
 } AOTLLVMConsts;
 
+/**
+ * CPU variant of the functions, the variant of a function is named
+ * "aot_func_variant#<variant index>#<function index>" and is selected
+ * by the runtime instead of aot_func#<function index> when the host
+ * CPU supports all the features of the variant
+ */
+typedef struct AOTCPUVariant {
+    /* CPU which the variant is tuned for */
+    char *cpu;
+    /* LLVM target features of the variant */
+    char *features;
+    /* AOT_CPU_FEATURE_XXX flags required by the variant */
+    uint64 cpu_features;
+} AOTCPUVariant;
+
 /**
  * Compiler context
  */
@@ -383,6 +437,12 @@ typedef struct AOTCompContext {
     LLVMOrcLLLazyJITRef orc_jit;
     LLVMOrcThreadSafeContextRef orc_thread_safe_context;
 
+    /* Persistent object cache of JIT, if it is enabled, the runtime
+       functions and data are referenced by the JITed code through the
+       symbols in jit_symbols instead of the constant addresses */
+    LLVMOrcObjectCacheRef orc_object_cache;
+    bh_list jit_symbols;
+
     LLVMModuleRef module;
 
     bool is_jit_mode;
@@ -391,6 +451,10 @@ typedef struct AOTCompContext {
     bool is_indirect_mode;
     bh_list native_symbols;
 
+    /* Generate the text without relocations so that it can be mapped from
+       the AOT file and shared among processes, implies indirect mode */
+    bool enable_shared_text;
+
     /* Bulk memory feature */
     bool enable_bulk_memory;
 
@@ -443,6 +507,20 @@ typedef struct AOTCompContext {
     /* Use profile file collected by LLVM PGO */
     char *use_prof_file;
 
+    /* Count of call_indirect sites guarded with a speculative direct
+       call, the guards are resolved with the indirect call value
+       profile after the profile is annotated to the LLVM IR */
+    uint32 call_indirect_spec_site_count;
+
+    /* CPU variants of the functions, sorted by the count of the CPU
+       features in ascending order */
+    AOTCPUVariant *cpu_variants;
+    uint32 cpu_variant_count;
+    /* Whether to generate the CPU variants for a function, indexed by
+       the function index excluding the imports, if it is NULL, the
+       variants are generated for the hot functions in the profile */
+    bool *cpu_variant_func_flags;
+
     /* Enable to use segment register as the base addr
        of linear memory for load/store operations */
     bool enable_segue_i32_load;
@@ -464,6 +542,13 @@ typedef struct AOTCompContext {
     /* Enable GC */
     bool enable_gc;
 
+    /* Enable exception handling */
+    bool enable_exce_handling;
+
+    /* Allow the memory accesses to the shared heap mapped above the
+       linear memory in the explicit bounds checks */
+    bool enable_shared_heap;
+
     uint32 opt_level;
     uint32 size_level;
 
@@ -515,6 +600,12 @@ typedef struct AOTCompContext {
     AOTCompFrame *aot_frame;
 } AOTCompContext;
 
+typedef struct AOTJITSymbol {
+    bh_list_link link;
+    char symbol[48];
+    void *addr;
+} AOTJITSymbol;
+
 enum {
     AOT_FORMAT_FILE,
     AOT_OBJECT_FILE,
@@ -616,9 +707,34 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+bool
+aot_resolve_cpu_variant(AOTCompContext *comp_ctx, const char *cpu,
+                        AOTCPUVariant *variant);
+
+bool
+aot_add_cpu_variant_funcs(AOTCompContext *comp_ctx);
+
 void
 aot_handle_llvm_errmsg(const char *string, LLVMErrorRef err);
 
+LLVMValueRef
+aot_get_jit_func_ref(AOTCompContext *comp_ctx, const char *name, void *addr,
+                     LLVMTypeRef func_type);
+
+LLVMValueRef
+aot_get_jit_data_ref(AOTCompContext *comp_ctx, const char *name,
+                     const void *addr);
+
+LLVMValueRef
+aot_get_jit_bytecode_addr(AOTCompContext *comp_ctx, const uint8 *ip,
+                          LLVMTypeRef int_type);
+
+bool
+aot_promote_jit_local_symbols(AOTCompContext *comp_ctx);
+
+bool
+aot_define_jit_symbols(AOTCompContext *comp_ctx, LLVMOrcJITDylibRef dylib);
+
 char *
 aot_compress_aot_func_names(AOTCompContext *comp_ctx, uint32 *p_size);
 
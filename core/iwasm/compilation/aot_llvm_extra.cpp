@@ -10,12 +10,19 @@
 #include <llvm/ADT/Optional.h>
 #include <llvm/ADT/Triple.h>
 #endif
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/ADT/Twine.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/MC/MCSubtargetInfo.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
+#include <llvm/Support/TargetRegistry.h>
+#endif
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm-c/Core.h>
@@ -28,6 +35,7 @@
 #include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
@@ -41,6 +49,7 @@
 #include <llvm/Target/CodeGenCWrappers.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/Utils/Local.h>
 #include <llvm/Transforms/Utils/LowerMemIntrinsics.h>
 #include <llvm/Transforms/Vectorize/LoopVectorize.h>
 #include <llvm/Transforms/Vectorize/LoadStoreVectorizer.h>
@@ -50,16 +59,22 @@
 #include <llvm/Transforms/Scalar/SimpleLoopUnswitch.h>
 #include <llvm/Transforms/Scalar/LICM.h>
 #include <llvm/Transforms/Scalar/GVN.h>
+#include <llvm/Transforms/IPO/HotColdSplitting.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #if LLVM_VERSION_MAJOR >= 12
 #include <llvm/Analysis/AliasAnalysis.h>
 #endif
 #include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/InstrProfReader.h>
+#include <llvm/ProfileData/ProfileCommon.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
 #include <cstring>
 #include "../aot/aot_runtime.h"
 #include "aot_llvm.h"
+#include "aot.h"
 
 using namespace llvm;
 using namespace llvm::orc;
@@ -79,6 +94,13 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+bool
+aot_resolve_cpu_variant(AOTCompContext *comp_ctx, const char *cpu,
+                        AOTCPUVariant *variant);
+
+bool
+aot_add_cpu_variant_funcs(AOTCompContext *comp_ctx);
+
 LLVM_C_EXTERN_C_END
 
 ExitOnError ExitOnErr;
@@ -142,6 +164,290 @@ ExpandMemoryOpPass::run(Function &F, FunctionAnalysisManager &AM)
     return PA;
 }
 
+/* The hottest callee of a call_indirect site is called speculatively if
+   it takes at least this percentage of the calls of the site */
+#define CALL_INDIRECT_SPEC_PERCENT_THRESHOLD 50
+
+struct CallIndirectSpecCallee {
+    uint32 func_idx;
+    /* The table slot which refers to the callee */
+    uint32 elem_idx;
+};
+
+/* Speculative callees of the call_indirect sites, collected from the
+   indirect call value profile right after it is annotated to the IR */
+struct CallIndirectSpecTargets {
+    bool collected = false;
+    DenseMap<uint32, CallIndirectSpecCallee> SiteCallees;
+};
+
+static void
+collectCallIndirectSpecTargets(AOTCompContext *comp_ctx, Module &M,
+                               CallIndirectSpecTargets &Targets)
+{
+    struct SiteProfile {
+        uint32 tbl_idx;
+        uint32 type_idx;
+        uint64 total;
+        DenseMap<uint64, uint64> counts;
+    };
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    DenseMap<uint64, uint32> FuncIdxOfHash;
+    DenseMap<uint32, SiteProfile> Sites;
+    unsigned KindID = M.getContext().getMDKindID(AOT_CALL_INDIRECT_MD_KIND);
+    uint32 i;
+
+    /* The value profile records the MD5 hash of the callee name */
+    for (i = 0; i < comp_ctx->func_ctx_count; i++) {
+        Function *F = unwrap<Function>(comp_ctx->func_ctxes[i]->precheck_func);
+        FuncIdxOfHash[IndexedInstrProf::ComputeHash(getPGOFuncName(*F))] =
+            comp_data->import_func_count + i;
+    }
+
+    for (Function &F : M) {
+        for (BasicBlock &BB : F) {
+            for (Instruction &I : BB) {
+                MDNode *SiteMD = I.getMetadata(KindID);
+                MDNode *ProfMD = I.getMetadata(LLVMContext::MD_prof);
+                MDString *Tag;
+                uint32 Site;
+
+                if (!SiteMD)
+                    continue;
+
+                /* The site may be cloned by the inliner, accumulate the
+                   value profile of all the copies */
+                Site = (uint32)mdconst::extract<ConstantInt>(
+                           SiteMD->getOperand(0))
+                           ->getZExtValue();
+                SiteProfile &Profile = Sites[Site];
+                Profile.tbl_idx = (uint32)mdconst::extract<ConstantInt>(
+                                      SiteMD->getOperand(1))
+                                      ->getZExtValue();
+                Profile.type_idx = (uint32)mdconst::extract<ConstantInt>(
+                                       SiteMD->getOperand(2))
+                                       ->getZExtValue();
+
+                /* !{!"VP", i32 kind, i64 total, i64 value, i64 count, ...} */
+                if (!ProfMD || ProfMD->getNumOperands() < 3
+                    || !(Tag = dyn_cast<MDString>(ProfMD->getOperand(0)))
+                    || Tag->getString() != "VP"
+                    || mdconst::extract<ConstantInt>(ProfMD->getOperand(1))
+                               ->getZExtValue()
+                           != IPVK_IndirectCallTarget)
+                    continue;
+
+                Profile.total +=
+                    mdconst::extract<ConstantInt>(ProfMD->getOperand(2))
+                        ->getZExtValue();
+                for (unsigned j = 3; j + 1 < ProfMD->getNumOperands(); j += 2) {
+                    uint64 Value =
+                        mdconst::extract<ConstantInt>(ProfMD->getOperand(j))
+                            ->getZExtValue();
+                    uint64 Count =
+                        mdconst::extract<ConstantInt>(ProfMD->getOperand(j + 1))
+                            ->getZExtValue();
+                    Profile.counts[Value] += Count;
+                }
+            }
+        }
+    }
+
+    for (auto &It : Sites) {
+        SiteProfile &Profile = It.second;
+        uint64 MaxValue = 0, MaxCount = 0;
+        uint32 func_idx, elem_idx;
+
+        for (auto &Count : Profile.counts) {
+            if (Count.second > MaxCount) {
+                MaxValue = Count.first;
+                MaxCount = Count.second;
+            }
+        }
+
+        if (MaxCount == 0
+            || MaxCount * 100
+                   < Profile.total * CALL_INDIRECT_SPEC_PERCENT_THRESHOLD)
+            continue;
+
+        auto Hash = FuncIdxOfHash.find(MaxValue);
+        if (Hash == FuncIdxOfHash.end())
+            continue;
+        func_idx = Hash->second;
+
+        /* The callee must match the function type of call_indirect, and
+           the table slot which refers to it must be known */
+        if (comp_data->funcs[func_idx - comp_data->import_func_count]
+                ->func_type_index
+            != Profile.type_idx)
+            continue;
+
+        elem_idx =
+            aot_get_table_slot_of_func(comp_data, Profile.tbl_idx, func_idx);
+        if (elem_idx == (uint32)-1)
+            continue;
+
+        Targets.SiteCallees[It.first] = { func_idx, elem_idx };
+    }
+
+    Targets.collected = true;
+}
+
+class CallIndirectSpecPass : public PassInfoMixin<CallIndirectSpecPass>
+{
+  public:
+    CallIndirectSpecPass(AOTCompContext *comp_ctx,
+                         const CallIndirectSpecTargets &Targets,
+                         bool ResolveAll)
+      : comp_ctx(comp_ctx)
+      , Targets(Targets)
+      , ResolveAll(ResolveAll)
+    {}
+
+    PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
+
+  private:
+    AOTCompContext *comp_ctx;
+    const CallIndirectSpecTargets &Targets;
+    /* Resolve the sites not annotated with the profile as not speculated */
+    bool ResolveAll;
+
+    const CallIndirectSpecCallee *getCallee(CallInst *CI)
+    {
+        uint32 Site =
+            (uint32)cast<ConstantInt>(CI->getArgOperand(0))->getZExtValue();
+        auto It = Targets.SiteCallees.find(Site);
+        return It != Targets.SiteCallees.end() ? &It->second : nullptr;
+    }
+};
+
+PreservedAnalyses
+CallIndirectSpecPass::run(Function &F, FunctionAnalysisManager &AM)
+{
+    SmallVector<CallInst *, 8> Guards, Placeholders;
+    SmallVector<BasicBlock *, 8> FoldBlocks;
+
+    /* Wait until the value profile is annotated */
+    if (!Targets.collected && !ResolveAll)
+        return PreservedAnalyses::all();
+
+    for (BasicBlock &BB : F) {
+        for (Instruction &I : BB) {
+            CallInst *CI = dyn_cast<CallInst>(&I);
+            Function *Callee = CI ? CI->getCalledFunction() : nullptr;
+
+            if (!Callee)
+                continue;
+            if (Callee->getName() == AOT_CALL_INDIRECT_SPEC_GUARD)
+                Guards.push_back(CI);
+            else if (Callee->getName() == AOT_CALL_INDIRECT_SPEC_FUNC_IDX
+                     || Callee->getName() == AOT_CALL_INDIRECT_SPEC_CALLEE)
+                Placeholders.push_back(CI);
+        }
+    }
+
+    if (Guards.empty() && Placeholders.empty())
+        return PreservedAnalyses::all();
+
+    /* Replace the guard with elem_idx == slot of the callee, or false
+       if the site isn't speculated */
+    for (CallInst *CI : Guards) {
+        const CallIndirectSpecCallee *Callee = getCallee(CI);
+        Value *Cond;
+
+        if (Callee) {
+            IRBuilder<> Builder(CI);
+            Cond = Builder.CreateICmpEQ(CI->getArgOperand(1),
+                                        Builder.getInt32(Callee->elem_idx),
+                                        "spec_hit");
+        }
+        else {
+            Cond = ConstantInt::getFalse(F.getContext());
+            for (User *U : CI->users()) {
+                if (Instruction *UI = dyn_cast<Instruction>(U))
+                    FoldBlocks.push_back(UI->getParent());
+            }
+        }
+        CI->replaceAllUsesWith(Cond);
+        CI->eraseFromParent();
+    }
+
+    if (!FoldBlocks.empty()) {
+        for (BasicBlock *BB : FoldBlocks)
+            ConstantFoldTerminator(BB);
+        removeUnreachableBlocks(F);
+
+        /* The placeholders of the removed speculative calls are gone */
+        Placeholders.clear();
+        for (BasicBlock &BB : F) {
+            for (Instruction &I : BB) {
+                CallInst *CI = dyn_cast<CallInst>(&I);
+                Function *Callee = CI ? CI->getCalledFunction() : nullptr;
+                if (Callee
+                    && (Callee->getName() == AOT_CALL_INDIRECT_SPEC_FUNC_IDX
+                        || Callee->getName() == AOT_CALL_INDIRECT_SPEC_CALLEE))
+                    Placeholders.push_back(CI);
+            }
+        }
+    }
+
+    for (CallInst *CI : Placeholders) {
+        const CallIndirectSpecCallee *Callee = getCallee(CI);
+        Value *V;
+
+        if (!Callee) {
+            /* Unreachable since the guard is always false */
+            V = UndefValue::get(CI->getType());
+        }
+        else if (CI->getCalledFunction()->getName()
+                 == AOT_CALL_INDIRECT_SPEC_FUNC_IDX) {
+            V = ConstantInt::get(CI->getType(), Callee->func_idx);
+        }
+        else {
+            AOTFuncContext *callee_ctx =
+                comp_ctx->func_ctxes[Callee->func_idx
+                                     - comp_ctx->comp_data->import_func_count];
+            V = ConstantExpr::getPointerCast(
+                unwrap<Function>(callee_ctx->precheck_func), CI->getType());
+        }
+        CI->replaceAllUsesWith(V);
+        CI->eraseFromParent();
+    }
+
+    return PreservedAnalyses::none();
+}
+
+static uint64
+getFunctionEntryCount(const Function *F)
+{
+    auto Count = F->getEntryCount();
+    return Count ? Count->getCount() : 0;
+}
+
+/* Sort the functions by the profiled entry count so that the hot functions
+   are emitted contiguously from the hottest one in their text section */
+static void
+sortFunctionsByHotness(Module &M)
+{
+    std::vector<Function *> Funcs;
+
+    for (Function &F : M) {
+        if (!F.isDeclaration())
+            Funcs.push_back(&F);
+    }
+
+    std::stable_sort(Funcs.begin(), Funcs.end(),
+                     [](const Function *A, const Function *B) {
+                         return getFunctionEntryCount(A)
+                                > getFunctionEntryCount(B);
+                     });
+
+    for (Function *F : Funcs) {
+        F->removeFromParent();
+        M.getFunctionList().push_back(F);
+    }
+}
+
 bool
 aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 {
@@ -183,6 +489,192 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 #endif /* WASM_ENABLE_SIMD */
 }
 
+/* The x86 CPU features which can be checked by the runtime */
+static const struct {
+    const char *name;
+    uint64 flag;
+} cpu_feature_list[] = {
+    { "sse3", AOT_CPU_FEATURE_SSE3 },
+    { "ssse3", AOT_CPU_FEATURE_SSSE3 },
+    { "sse4.1", AOT_CPU_FEATURE_SSE4_1 },
+    { "sse4.2", AOT_CPU_FEATURE_SSE4_2 },
+    { "popcnt", AOT_CPU_FEATURE_POPCNT },
+    { "avx", AOT_CPU_FEATURE_AVX },
+    { "avx2", AOT_CPU_FEATURE_AVX2 },
+    { "fma", AOT_CPU_FEATURE_FMA },
+    { "bmi", AOT_CPU_FEATURE_BMI },
+    { "bmi2", AOT_CPU_FEATURE_BMI2 },
+    { "lzcnt", AOT_CPU_FEATURE_LZCNT },
+    { "movbe", AOT_CPU_FEATURE_MOVBE },
+    { "f16c", AOT_CPU_FEATURE_F16C },
+    { "avx512f", AOT_CPU_FEATURE_AVX512F },
+    { "avx512cd", AOT_CPU_FEATURE_AVX512CD },
+    { "avx512bw", AOT_CPU_FEATURE_AVX512BW },
+    { "avx512dq", AOT_CPU_FEATURE_AVX512DQ },
+    { "avx512vl", AOT_CPU_FEATURE_AVX512VL },
+    { "avx512vnni", AOT_CPU_FEATURE_AVX512VNNI },
+    { "avx512vbmi", AOT_CPU_FEATURE_AVX512VBMI },
+    { "avx512ifma", AOT_CPU_FEATURE_AVX512IFMA },
+    { "avx512vpopcntdq", AOT_CPU_FEATURE_AVX512VPOPCNTDQ },
+    { "avx512bitalg", AOT_CPU_FEATURE_AVX512BITALG },
+    { "avx512vbmi2", AOT_CPU_FEATURE_AVX512VBMI2 },
+};
+
+static char *
+dupString(const std::string &Str)
+{
+    uint32 Size = (uint32)Str.size() + 1;
+    char *Buf = (char *)wasm_runtime_malloc(Size);
+
+    if (Buf)
+        bh_memcpy_s(Buf, Size, Str.c_str(), Size);
+    return Buf;
+}
+
+bool
+aot_resolve_cpu_variant(AOTCompContext *comp_ctx, const char *cpu,
+                        AOTCPUVariant *variant)
+{
+    TargetMachine *TM =
+        reinterpret_cast<TargetMachine *>(comp_ctx->target_machine);
+    const MCSubtargetInfo *BaseSTI = TM->getMCSubtargetInfo();
+    std::string Features = TM->getTargetFeatureString().str();
+    uint64 BaseCPUFeatures = 0, CPUFeatures = 0;
+
+    if (!BaseSTI->isCPUStringValid(cpu)) {
+        aot_set_last_error_v("unknown CPU %s of the CPU variants.", cpu);
+        return false;
+    }
+
+    std::unique_ptr<MCSubtargetInfo> STI(TM->getTarget().createMCSubtargetInfo(
+        TM->getTargetTriple().str(), cpu, ""));
+    if (!STI) {
+        aot_set_last_error("create LLVM subtarget info failed.");
+        return false;
+    }
+
+    for (const auto &Feature : cpu_feature_list) {
+        std::string Name = std::string("+") + Feature.name;
+        if (BaseSTI->checkFeatures(Name))
+            BaseCPUFeatures |= Feature.flag;
+        if (STI->checkFeatures(Name))
+            CPUFeatures |= Feature.flag;
+    }
+
+    if (!(CPUFeatures & ~BaseCPUFeatures)) {
+        aot_set_last_error_v("CPU variant %s has no more features than the "
+                             "target CPU.",
+                             cpu);
+        return false;
+    }
+
+    /* Only enable the features which can be checked by the runtime, the
+       variant keeps the target CPU and is tuned for the variant CPU */
+    for (const auto &Feature : cpu_feature_list) {
+        if (CPUFeatures & ~BaseCPUFeatures & Feature.flag) {
+            if (!Features.empty())
+                Features += ",";
+            Features += std::string("+") + Feature.name;
+        }
+    }
+
+    if (!(variant->cpu = dupString(cpu))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    if (!(variant->features = dupString(Features))) {
+        wasm_runtime_free(variant->cpu);
+        variant->cpu = NULL;
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    variant->cpu_features = BaseCPUFeatures | CPUFeatures;
+    return true;
+}
+
+static bool
+getFuncIndexOfName(StringRef Name, uint32 &FuncIdx)
+{
+    if (!Name.consume_front(AOT_FUNC_PREFIX) || Name.empty()
+        || !isDigit(Name[0]))
+        return false;
+    return !Name.getAsInteger(10, FuncIdx);
+}
+
+/* Get the max counter of each function in the profile, the functions
+   whose max counter reaches the hot count threshold are hot */
+static bool
+readFuncMaxCounts(AOTCompContext *comp_ctx, std::vector<uint64> &MaxCounts,
+                  uint64 &HotThreshold)
+{
+    auto ReaderOrErr = IndexedInstrProfReader::create(comp_ctx->use_prof_file);
+    uint32 FuncIdx;
+
+    if (Error E = ReaderOrErr.takeError()) {
+        aot_set_last_error_v("read profile file %s failed: %s.",
+                             comp_ctx->use_prof_file,
+                             toString(std::move(E)).c_str());
+        return false;
+    }
+
+    std::unique_ptr<IndexedInstrProfReader> Reader = std::move(*ReaderOrErr);
+    const SummaryEntryVector &Summary =
+        Reader->getSummary(false).getDetailedSummary();
+
+    HotThreshold = Summary.empty()
+                       ? UINT64_MAX
+                       : ProfileSummaryBuilder::getHotCountThreshold(Summary);
+    MaxCounts.assign(comp_ctx->func_ctx_count, 0);
+
+    for (const NamedInstrProfRecord &Record : *Reader) {
+        if (!getFuncIndexOfName(Record.Name, FuncIdx)
+            || FuncIdx >= comp_ctx->func_ctx_count)
+            continue;
+        for (uint64 Count : Record.Counts)
+            MaxCounts[FuncIdx] = std::max(MaxCounts[FuncIdx], Count);
+    }
+    return true;
+}
+
+bool
+aot_add_cpu_variant_funcs(AOTCompContext *comp_ctx)
+{
+    std::vector<uint64> MaxCounts;
+    uint64 HotThreshold = 0;
+    uint32 i, j;
+
+    if (comp_ctx->use_prof_file
+        && !readFuncMaxCounts(comp_ctx, MaxCounts, HotThreshold))
+        return false;
+
+    for (i = 0; i < comp_ctx->func_ctx_count; i++) {
+        Function *F = unwrap<Function>(comp_ctx->func_ctxes[i]->func);
+
+        if (comp_ctx->cpu_variant_func_flags
+                ? !comp_ctx->cpu_variant_func_flags[i]
+                : MaxCounts[i] < HotThreshold)
+            continue;
+
+        for (j = 0; j < comp_ctx->cpu_variant_count; j++) {
+            AOTCPUVariant *Variant = comp_ctx->cpu_variants + j;
+            ValueToValueMapTy VMap;
+            Function *Clone = CloneFunction(F, VMap);
+
+            Clone->setName(Twine(AOT_FUNC_VARIANT_PREFIX) + Twine(j) + "#"
+                           + Twine(i));
+            Clone->removeFnAttr("target-features");
+            Clone->addFnAttr("target-features", Variant->features);
+            Clone->addFnAttr("tune-cpu", Variant->cpu);
+            /* The variant isn't in the profile, take the max counter of
+               the function as its entry count to optimize it as hot
+               code rather than for size */
+            if (comp_ctx->use_prof_file && MaxCounts[i] > 0)
+                Clone->setEntryCount(MaxCounts[i]);
+        }
+    }
+    return true;
+}
+
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
 {
@@ -221,17 +713,36 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
 #endif
     }
 
-#ifdef DEBUG_PASS
+    Module *M = reinterpret_cast<Module *>(module);
+    CallIndirectSpecTargets SpecTargets;
     PassInstrumentationCallbacks PIC;
-    PassBuilder PB(TM, PTO, PGO, &PIC);
-#else
 #if LLVM_VERSION_MAJOR == 12
-    PassBuilder PB(false, TM, PTO, PGO);
+    PassBuilder PB(false, TM, PTO, PGO, &PIC);
 #else
-    PassBuilder PB(TM, PTO, PGO);
-#endif
+    PassBuilder PB(TM, PTO, PGO, &PIC);
 #endif
 
+    if (comp_ctx->call_indirect_spec_site_count > 0) {
+        if (comp_ctx->use_prof_file) {
+            /* Collect the hot callees before the value profile is
+               consumed by the indirect call promotion pass */
+            PIC.registerAfterPassCallback(
+                [&](StringRef PassID, Any IR, const PreservedAnalyses &PA) {
+                    if (!SpecTargets.collected
+                        && PassID == "PGOInstrumentationUse")
+                        collectCallIndirectSpecTargets(comp_ctx, *M,
+                                                       SpecTargets);
+                });
+        }
+
+        /* Resolve the speculative calls before the inliner runs on the
+           caller so that the hot callees can be inlined */
+        PB.registerPeepholeEPCallback(
+            [&](FunctionPassManager &FPM, auto Level) {
+                FPM.addPass(CallIndirectSpecPass(comp_ctx, SpecTargets, false));
+            });
+    }
+
     /* Register all the basic analyses with the managers */
     LoopAnalysisManager LAM;
     FunctionAnalysisManager FAM;
@@ -302,7 +813,6 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     disable_llvm_lto = true;
 #endif
 
-    Module *M = reinterpret_cast<Module *>(module);
     if (disable_llvm_lto) {
         for (Function &F : *M) {
             F.addFnAttr("disable-tail-calls", "true");
@@ -374,6 +884,26 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
             else {
                 MPM.addPass(PB.buildPerModuleDefaultPipeline(OL));
             }
+
+            if (comp_ctx->use_prof_file
+                && TM->getTargetTriple().isOSBinFormatELF()
+                && !comp_ctx->enable_stack_bound_check
+                && !comp_ctx->enable_stack_estimation) {
+                /* Outline the cold regions of the functions with the
+                   profile, they are put into the .text.unlikely section
+                   together with the cold functions. Not applied when the
+                   stack usage of each function is checked since the stack
+                   usage of the outlined functions isn't counted. */
+                MPM.addPass(HotColdSplittingPass());
+            }
+        }
+
+        if (comp_ctx->call_indirect_spec_site_count > 0) {
+            /* Resolve the speculative calls which are left, e.g. in the
+               instrumented build or when the function isn't profiled */
+            FunctionPassManager FPM2;
+            FPM2.addPass(CallIndirectSpecPass(comp_ctx, SpecTargets, true));
+            MPM.addPass(createModuleToFunctionPassAdaptor(std::move(FPM2)));
         }
 
         /* Run specific passes for AOT indirect mode in last since general
@@ -387,6 +917,20 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     }
 
     MPM.run(*M, MAM);
+
+    if (comp_ctx->use_prof_file && !comp_ctx->is_jit_mode)
+        sortFunctionsByHotness(*M);
+
+    if (comp_ctx->call_indirect_spec_site_count > 0) {
+        const char *placeholders[] = { AOT_CALL_INDIRECT_SPEC_GUARD,
+                                       AOT_CALL_INDIRECT_SPEC_FUNC_IDX,
+                                       AOT_CALL_INDIRECT_SPEC_CALLEE };
+        for (const char *name : placeholders) {
+            Function *F = M->getFunction(name);
+            if (F && F->use_empty())
+                F->eraseFromParent();
+        }
+    }
 }
 
 char *
@@ -17,6 +17,8 @@
 #include "llvm/ADT/Optional.h"
 #endif
 #include "llvm/ExecutionEngine/JITEventListener.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
@@ -25,9 +27,15 @@
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/Support/CBindingWrapping.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 
 #include "aot_orc_extra.h"
 #include "aot.h"
+#include "bh_log.h"
 
 #if LLVM_VERSION_MAJOR >= 17
 namespace llvm {
@@ -251,6 +259,27 @@ PartitionFunction(GlobalValueSet Requested)
     return Requested;
 }
 
+/* Used with the object cache instead of PartitionFunction: a partition
+   only has the requested symbol with the smallest name, the others are
+   put back and partitioned in the same way. The groups of
+   PartitionFunction depend on the symbols requested together and on the
+   functions compiled before, which vary from run to run, so the objects
+   named by their symbols wouldn't be found in the cache again. */
+static Optional<CompileOnDemandLayer::GlobalValueSet>
+CachePartitionFunction(GlobalValueSet Requested)
+{
+    const GlobalValue *First = nullptr;
+
+    for (auto *GV : Requested) {
+        if (!First || GV->getName() < First->getName())
+            First = GV;
+    }
+
+    if (!First)
+        return Requested;
+    return GlobalValueSet{ First };
+}
+
 LLVMErrorRef
 LLVMOrcCreateLLLazyJIT(LLVMOrcLLLazyJITRef *Result,
                        LLVMOrcLLLazyJITBuilderRef Builder)
@@ -275,6 +304,12 @@ LLVMOrcCreateLLLazyJIT(LLVMOrcLLLazyJITRef *Result,
     return LLVMErrorSuccess;
 }
 
+void
+LLVMOrcLLLazyJITSetCachePartitionFunction(LLVMOrcLLLazyJITRef J)
+{
+    unwrap(J)->setPartitionFunction(CachePartitionFunction);
+}
+
 LLVMErrorRef
 LLVMOrcDisposeLLLazyJIT(LLVMOrcLLLazyJITRef J)
 {
@@ -358,3 +393,122 @@ LLVMOrcLLLazyJITGetObjLinkingLayer(LLVMOrcLLLazyJITRef J)
 {
     return wrap(&unwrap(J)->getObjLinkingLayer());
 }
+
+/* An object cache which saves the objects compiled by LLVM JIT into
+   files of a directory, and reloads them in later runs. Objects are
+   named by the cache key (which identifies the wasm module, the JIT
+   options and the host CPU) and the symbols defined and referenced by
+   the partition module created by CompileOnDemandLayer. The partitions
+   depend on the order in which the functions are requested, and the
+   module identifier isn't enough to tell them apart. */
+class FileObjectCache : public ObjectCache
+{
+  public:
+    FileObjectCache(const char *Dir, const char *Key)
+      : Dir(Dir)
+      , Key(Key)
+    {}
+
+    void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override
+    {
+        SmallString<256> Path, TmpPath;
+        int FD;
+
+        getObjectPath(M, Path);
+
+        /* Write to a temporary file and rename it, so that a concurrent
+           process never reads a partially written object */
+        if (sys::fs::createUniqueFile(Path + ".tmp-%%%%%%", FD, TmpPath)) {
+            LOG_WARNING("failed to create jit cache file %s", Path.c_str());
+            return;
+        }
+
+        {
+            raw_fd_ostream OS(FD, true);
+            OS << Obj.getBuffer();
+            OS.close();
+            if (OS.has_error()) {
+                OS.clear_error();
+                sys::fs::remove(TmpPath);
+                LOG_WARNING("failed to write jit cache file %s", Path.c_str());
+                return;
+            }
+        }
+
+        if (sys::fs::rename(TmpPath, Path)) {
+            sys::fs::remove(TmpPath);
+            return;
+        }
+        LOG_VERBOSE("save jit object %s", Path.c_str());
+    }
+
+    std::unique_ptr<MemoryBuffer> getObject(const Module *M) override
+    {
+        SmallString<256> Path;
+
+        getObjectPath(M, Path);
+
+        auto Buf = MemoryBuffer::getFile(Path, false, false);
+        if (!Buf)
+            return nullptr;
+
+        LOG_VERBOSE("load jit object %s", Path.c_str());
+        return std::move(*Buf);
+    }
+
+  private:
+    void getObjectPath(const Module *M, SmallString<256> &Path)
+    {
+        std::vector<std::string> Symbols;
+        std::string Str;
+
+        /* The content of each symbol is decided by the cache key since
+           the IR is optimized before partitioning */
+        for (auto &GV : M->global_values()) {
+            Symbols.push_back((GV.isDeclaration() ? "U " : "D ")
+                              + GV.getName().str());
+        }
+        std::sort(Symbols.begin(), Symbols.end());
+        for (auto &S : Symbols) {
+            Str += S;
+            Str += '\n';
+        }
+
+        Path = Dir;
+        sys::path::append(Path, Key + "-" + utohexstr(xxHash64(Str)) + ".o");
+    }
+
+    std::string Dir;
+    std::string Key;
+};
+
+DEFINE_SIMPLE_CONVERSION_FUNCTIONS(FileObjectCache, LLVMOrcObjectCacheRef)
+
+LLVMOrcObjectCacheRef
+LLVMOrcCreateFileObjectCache(const char *Dir, const char *Key)
+{
+    if (sys::fs::create_directories(Dir))
+        return nullptr;
+
+    return wrap(new FileObjectCache(Dir, Key));
+}
+
+void
+LLVMOrcDisposeObjectCache(LLVMOrcObjectCacheRef Cache)
+{
+    delete unwrap(Cache);
+}
+
+void
+LLVMOrcLLLazyJITBuilderSetObjectCache(LLVMOrcLLLazyJITBuilderRef Builder,
+                                      LLVMOrcObjectCacheRef Cache)
+{
+    /* Same as the default compile function of LLJIT when compile threads
+       are used, but with the object cache plugged in */
+    unwrap(Builder)->setCompileFunctionCreator(
+        [Cache](JITTargetMachineBuilder JTMB)
+            -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+            return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+                                                          unwrap(Cache));
+        });
+}
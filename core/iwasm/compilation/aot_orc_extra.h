@@ -16,6 +16,7 @@ LLVM_C_EXTERN_C_BEGIN
 
 typedef struct LLVMOrcOpaqueLLLazyJITBuilder *LLVMOrcLLLazyJITBuilderRef;
 typedef struct LLVMOrcOpaqueLLLazyJIT *LLVMOrcLLLazyJITRef;
+typedef struct LLVMOrcOpaqueObjectCache *LLVMOrcObjectCacheRef;
 
 // Extra bindings for LLJIT
 void
@@ -41,6 +42,9 @@ LLVMErrorRef
 LLVMOrcCreateLLLazyJIT(LLVMOrcLLLazyJITRef *Result,
                        LLVMOrcLLLazyJITBuilderRef Builder);
 
+void
+LLVMOrcLLLazyJITSetCachePartitionFunction(LLVMOrcLLLazyJITRef J);
+
 LLVMErrorRef
 LLVMOrcDisposeLLLazyJIT(LLVMOrcLLLazyJITRef J);
 
@@ -79,5 +83,15 @@ LLVMOrcLLJITBuilderSetCompileFunctionCreatorWithStackSizesCallback(
 LLVMOrcObjectLayerRef
 LLVMOrcLLLazyJITGetObjLinkingLayer(LLVMOrcLLLazyJITRef J);
 
+LLVMOrcObjectCacheRef
+LLVMOrcCreateFileObjectCache(const char *Dir, const char *Key);
+
+void
+LLVMOrcDisposeObjectCache(LLVMOrcObjectCacheRef Cache);
+
+void
+LLVMOrcLLLazyJITBuilderSetObjectCache(LLVMOrcLLLazyJITBuilderRef Builder,
+                                      LLVMOrcObjectCacheRef Cache);
+
 LLVM_C_EXTERN_C_END
 #endif
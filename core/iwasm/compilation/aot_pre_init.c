@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot.h"
+#include "../interpreter/wasm_runtime.h"
+#if WASM_ENABLE_GC != 0
+#include "../common/gc/gc_object.h"
+#endif
+
+/* Zero gaps shorter than this are kept inside the data segment rather than
+   starting a new one, as each segment costs more than that in the AOT file */
+#define PRE_INIT_DATA_SEG_MERGE_GAP 32
+
+#define PRE_INIT_STACK_SIZE (64 * 1024)
+
+static bool
+is_init_expr_simple(const InitializerExpression *expr)
+{
+#if WASM_ENABLE_GC != 0
+    /* These expressions own data which is released with the segment */
+    return expr->init_expr_type != INIT_EXPR_TYPE_STRUCT_NEW
+           && expr->init_expr_type != INIT_EXPR_TYPE_ARRAY_NEW
+           && expr->init_expr_type != INIT_EXPR_TYPE_ARRAY_NEW_FIXED;
+#else
+    (void)expr;
+    return true;
+#endif
+}
+
+static bool
+append_data_segment(WASMModule *module, uint32 mem_idx, bool is_memory64,
+                    uint64 offset, const uint8 *data, uint32 length)
+{
+    WASMDataSeg **data_segments, *data_seg;
+    uint64 size = sizeof(WASMDataSeg *) * ((uint64)module->data_seg_count + 1);
+
+    if (size >= UINT32_MAX
+        || !(data_segments = wasm_runtime_realloc(module->data_segments,
+                                                  (uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    module->data_segments = data_segments;
+
+    if (!(data_seg = wasm_runtime_malloc(sizeof(WASMDataSeg)))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(data_seg, 0, sizeof(WASMDataSeg));
+
+    if (!(data_seg->data = wasm_runtime_malloc(length))) {
+        wasm_runtime_free(data_seg);
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    bh_memcpy_s(data_seg->data, length, data, length);
+    data_seg->data_length = length;
+    data_seg->is_data_cloned = true;
+    data_seg->memory_index = mem_idx;
+    if (is_memory64) {
+        data_seg->base_offset.init_expr_type = INIT_EXPR_TYPE_I64_CONST;
+        data_seg->base_offset.u.i64 = (int64)offset;
+    }
+    else {
+        data_seg->base_offset.init_expr_type = INIT_EXPR_TYPE_I32_CONST;
+        data_seg->base_offset.u.i32 = (int32)offset;
+    }
+
+    data_segments[module->data_seg_count++] = data_seg;
+    return true;
+}
+
+static bool
+snapshot_memories(WASMModule *module, WASMModuleInstance *module_inst)
+{
+    WASMMemoryInstance *memory;
+    const uint8 *data;
+    uint64 data_size, begin, end, gap;
+    uint32 i, seg_count = module->data_seg_count;
+
+    /* The active segments have been applied and the dropped passive ones
+       can't be used any more: empty them but keep their indexes, which are
+       referred to by memory.init and data.drop */
+    for (i = 0; i < seg_count; i++) {
+        WASMDataSeg *data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive
+            && !bh_bitmap_get_bit(module_inst->e->common.data_dropped, i))
+            continue;
+#endif
+        data_seg->data_length = 0;
+    }
+
+    for (i = 0; i < module->memory_count; i++) {
+        memory = module_inst->memories[i];
+        data = memory->memory_data;
+        data_size = memory->memory_data_size;
+
+        module->memories[i].init_page_count = memory->cur_page_count;
+
+        begin = 0;
+        while (begin < data_size) {
+            while (begin < data_size && !data[begin])
+                begin++;
+            if (begin == data_size)
+                break;
+
+            end = begin + 1;
+            gap = 0;
+            while (end + gap < data_size && gap < PRE_INIT_DATA_SEG_MERGE_GAP
+                   && end - begin + gap < UINT32_MAX) {
+                if (data[end + gap]) {
+                    end += gap + 1;
+                    gap = 0;
+                }
+                else {
+                    gap++;
+                }
+            }
+
+            if (!append_data_segment(module, i, memory->is_memory64, begin,
+                                     data + begin, (uint32)(end - begin)))
+                return false;
+            begin = end;
+        }
+    }
+
+    return true;
+}
+
+static bool
+snapshot_globals(WASMModule *module, WASMModuleInstance *module_inst)
+{
+    WASMGlobal *global;
+    WASMGlobalInstance *global_inst;
+    InitializerExpression *init_expr;
+    uint8 *global_addr;
+    uint32 i;
+
+    for (i = 0; i < module->global_count; i++) {
+        global = &module->globals[i];
+        if (!global->type.is_mutable)
+            continue;
+
+        global_inst =
+            &module_inst->e->globals[module->import_global_count + i];
+        global_addr = module_inst->global_data + global_inst->data_offset;
+        init_expr = &global->init_expr;
+
+        if (!is_init_expr_simple(init_expr)) {
+            aot_set_last_error_v("pre-initialization of global %u with "
+                                 "aggregate initializer is not supported.",
+                                 module->import_global_count + i);
+            return false;
+        }
+
+        switch (global->type.val_type) {
+            case VALUE_TYPE_I32:
+                init_expr->init_expr_type = INIT_EXPR_TYPE_I32_CONST;
+                init_expr->u.i32 = *(int32 *)global_addr;
+                break;
+            case VALUE_TYPE_I64:
+                init_expr->init_expr_type = INIT_EXPR_TYPE_I64_CONST;
+                init_expr->u.i64 = GET_I64_FROM_ADDR((uint32 *)global_addr);
+                break;
+            case VALUE_TYPE_F32:
+                init_expr->init_expr_type = INIT_EXPR_TYPE_F32_CONST;
+                init_expr->u.f32 = *(float32 *)global_addr;
+                break;
+            case VALUE_TYPE_F64:
+                init_expr->init_expr_type = INIT_EXPR_TYPE_F64_CONST;
+                init_expr->u.f64 = GET_F64_FROM_ADDR((uint32 *)global_addr);
+                break;
+            case VALUE_TYPE_V128:
+                init_expr->init_expr_type = INIT_EXPR_TYPE_V128_CONST;
+                bh_memcpy_s(&init_expr->u.v128, sizeof(V128), global_addr,
+                            sizeof(V128));
+                break;
+            default:
+                /* The reference may point to a host or heap object which
+                   can't be expressed by a constant expression */
+                aot_set_last_error_v("pre-initialization of mutable "
+                                     "reference typed global %u is not "
+                                     "supported.",
+                                     module->import_global_count + i);
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+get_table_elem_init_expr(WASMTableInstance *table, uint32 elem_idx,
+                         InitializerExpression *init_expr)
+{
+    table_elem_type_t elem = table->elems[elem_idx];
+
+    if (elem == NULL_REF) {
+        init_expr->init_expr_type = INIT_EXPR_TYPE_REFNULL_CONST;
+#if WASM_ENABLE_GC == 0
+        init_expr->u.ref_index = NULL_REF;
+#else
+        init_expr->u.gc_obj = NULL_REF;
+#endif
+        return true;
+    }
+
+#if WASM_ENABLE_GC == 0
+    if (table->elem_type != VALUE_TYPE_FUNCREF)
+        return false;
+    init_expr->init_expr_type = INIT_EXPR_TYPE_FUNCREF_CONST;
+    init_expr->u.ref_index = (uint32)elem;
+#else
+    if (!wasm_obj_is_func_obj((WASMObjectRef)elem))
+        return false;
+    init_expr->init_expr_type = INIT_EXPR_TYPE_FUNCREF_CONST;
+    init_expr->u.ref_index =
+        wasm_func_obj_get_func_idx_bound((WASMFuncObjectRef)elem);
+#endif
+    return true;
+}
+
+static bool
+snapshot_tables(WASMModule *module, WASMModuleInstance *module_inst)
+{
+    WASMTableSeg *table_segments, *table_seg;
+    WASMTableInstance *table;
+    uint64 size;
+    uint32 i, j, seg_count = module->table_seg_count;
+
+    /* Empty the applied and the dropped segments, like the data segments */
+    for (i = 0; i < seg_count; i++) {
+        table_seg = &module->table_segments[i];
+#if WASM_ENABLE_REF_TYPES != 0 || WASM_ENABLE_GC != 0
+        if (wasm_elem_is_declarative(table_seg->mode))
+            continue;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+        if (wasm_elem_is_passive(table_seg->mode)
+            && !bh_bitmap_get_bit(module_inst->e->common.elem_dropped, i))
+            continue;
+#endif
+        for (j = 0; j < table_seg->value_count; j++) {
+            if (!is_init_expr_simple(&table_seg->init_values[j])) {
+                aot_set_last_error_v("pre-initialization of element segment "
+                                     "%u with aggregate initializer is not "
+                                     "supported.",
+                                     i);
+                return false;
+            }
+        }
+        table_seg->value_count = 0;
+    }
+
+    if (module->table_count == 0)
+        return true;
+
+    /* Re-create the content of each table with an active segment */
+    size = sizeof(WASMTableSeg) * ((uint64)seg_count + module->table_count);
+    if (size >= UINT32_MAX
+        || !(table_segments =
+                 wasm_runtime_realloc(module->table_segments, (uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    module->table_segments = table_segments;
+
+    for (i = 0; i < module->table_count; i++) {
+        table = module_inst->tables[module->import_table_count + i];
+        module->tables[i].table_type.init_size = table->cur_size;
+        if (table->cur_size == 0)
+            continue;
+
+        table_seg = &table_segments[module->table_seg_count];
+        memset(table_seg, 0, sizeof(WASMTableSeg));
+        /* elemtype + table_idx + active, vec(expr) */
+        table_seg->mode = 6;
+        table_seg->elem_type = module->tables[i].table_type.elem_type;
+#if WASM_ENABLE_GC != 0
+        table_seg->elem_ref_type = module->tables[i].table_type.elem_ref_type;
+#endif
+        table_seg->table_index = module->import_table_count + i;
+        table_seg->base_offset.init_expr_type = INIT_EXPR_TYPE_I32_CONST;
+        table_seg->base_offset.u.i32 = 0;
+
+        size = sizeof(InitializerExpression) * (uint64)table->cur_size;
+        if (size >= UINT32_MAX
+            || !(table_seg->init_values = wasm_runtime_malloc((uint32)size))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        memset(table_seg->init_values, 0, (uint32)size);
+        /* Count the segment now so that it is freed with the module */
+        module->table_seg_count++;
+
+        for (j = 0; j < table->cur_size; j++) {
+            if (!get_table_elem_init_expr(table, j,
+                                          &table_seg->init_values[j])) {
+                aot_set_last_error_v("pre-initialization of table %u with "
+                                     "non-function references is not "
+                                     "supported.",
+                                     table_seg->table_index);
+                return false;
+            }
+        }
+        table_seg->value_count = table->cur_size;
+    }
+
+    return true;
+}
+
+static void
+remove_func_export(WASMModule *module, const char *name)
+{
+    uint32 i;
+
+    for (i = 0; i < module->export_count; i++) {
+        if (module->exports[i].kind == EXPORT_KIND_FUNC
+            && !strcmp(module->exports[i].name, name)) {
+            memmove(&module->exports[i], &module->exports[i + 1],
+                    sizeof(WASMExport) * (module->export_count - i - 1));
+            module->export_count--;
+            return;
+        }
+    }
+}
+
+bool
+aot_pre_initialize_module(void *wasm_module, const char *init_func_name)
+{
+    WASMModule *module = (WASMModule *)wasm_module;
+    WASMModuleInstance *module_inst;
+    wasm_module_inst_t inst;
+    wasm_function_inst_t init_func;
+    wasm_exec_env_t exec_env;
+    /* The functions called by the runtime once the module is instantiated,
+       they must not run again when the snapshot is instantiated */
+    const char *post_inst_func_names[3];
+    uint32 post_inst_func_count = 0, i;
+    bool init_func_called = false, ret = false;
+    char error_buf[128];
+
+    if (module->import_memory_count > 0 || module->import_table_count > 0) {
+        aot_set_last_error("pre-initialization of module with imported "
+                           "memory or table is not supported.");
+        return false;
+    }
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    if (module->import_wasi_api)
+        post_inst_func_names[post_inst_func_count++] = "_initialize";
+#endif
+    post_inst_func_names[post_inst_func_count++] = "__post_instantiate";
+#if WASM_ENABLE_BULK_MEMORY != 0
+#if WASM_ENABLE_LIBC_WASI != 0
+    if (!module->import_wasi_api)
+#endif
+        post_inst_func_names[post_inst_func_count++] = "__wasm_call_ctors";
+#endif
+
+    /* No app heap is inserted so that the memory layout is kept */
+    if (!(inst = wasm_runtime_instantiate(wasm_module, PRE_INIT_STACK_SIZE, 0,
+                                          error_buf, sizeof(error_buf)))) {
+        aot_set_last_error_v("pre-initialization failed: %s", error_buf);
+        return false;
+    }
+    module_inst = (WASMModuleInstance *)inst;
+
+    for (i = 0; i < post_inst_func_count; i++) {
+        if (!strcmp(init_func_name, post_inst_func_names[i]))
+            init_func_called = true;
+    }
+
+    if (!init_func_called) {
+        if (!(init_func = wasm_runtime_lookup_function(inst, init_func_name))) {
+            aot_set_last_error_v("pre-initialization failed: "
+                                 "function %s not found.",
+                                 init_func_name);
+            goto fail;
+        }
+
+        if (wasm_func_get_param_count(init_func, inst) != 0
+            || wasm_func_get_result_count(init_func, inst) != 0) {
+            aot_set_last_error_v("pre-initialization failed: "
+                                 "function %s must be of type [] -> [].",
+                                 init_func_name);
+            goto fail;
+        }
+
+        if (!(exec_env = wasm_runtime_get_exec_env_singleton(inst))) {
+            aot_set_last_error("pre-initialization failed: "
+                               "create exec env failed.");
+            goto fail;
+        }
+
+        if (!wasm_runtime_call_wasm(exec_env, init_func, 0, NULL)) {
+            aot_set_last_error_v("pre-initialization failed: %s",
+                                 wasm_runtime_get_exception(inst));
+            goto fail;
+        }
+    }
+
+    if (!snapshot_memories(module, module_inst)
+        || !snapshot_globals(module, module_inst)
+        || !snapshot_tables(module, module_inst))
+        goto fail;
+
+    /* The effects of the start function and of the initialization
+       functions are part of the snapshot now */
+    module->start_function = (uint32)-1;
+    for (i = 0; i < post_inst_func_count; i++)
+        remove_func_export(module, post_inst_func_names[i]);
+    remove_func_export(module, init_func_name);
+
+    ret = true;
+
+fail:
+    wasm_runtime_deinstantiate(inst);
+    return ret;
+}
@@ -0,0 +1,1846 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot.h"
+#include "../interpreter/wasm_opcode.h"
+
+/*
+ * Link several wasm modules into one wasm module at the binary level: the
+ * imports whose module name is the name of another input module are resolved
+ * to that module's exports, and the index spaces of all modules are merged,
+ * so that the calls between the modules become direct calls of the merged
+ * module, which LLVM can also inline. The remaining imports are kept, and
+ * identical ones are merged.
+ */
+
+/* The section ids which are only defined with some features enabled */
+#define LINK_SECTION_DATACOUNT 12
+#define LINK_SECTION_TAG 13
+#define LINK_SECTION_COUNT 14
+
+/* func, table, memory, global and tag */
+#define LINK_KIND_TAG 4
+#define LINK_KIND_COUNT 5
+
+typedef struct LinkBuf {
+    uint8 *data;
+    uint32 size;
+    uint32 capacity;
+} LinkBuf;
+
+typedef struct LinkImport {
+    const uint8 *module_name;
+    uint32 module_name_len;
+    const uint8 *field_name;
+    uint32 field_name_len;
+    uint8 kind;
+    /* the raw import description following the kind */
+    const uint8 *desc;
+    uint32 desc_len;
+    /* index of the import in the index space of its kind */
+    uint32 index;
+    /* type index of the function or tag, and the type */
+    uint32 type_index;
+    const uint8 *type;
+    uint32 type_len;
+    /* index of the module providing the import, -1 if unresolved */
+    int32 target_module;
+} LinkImport;
+
+typedef struct LinkExport {
+    const uint8 *name;
+    uint32 name_len;
+    uint8 kind;
+    uint32 index;
+} LinkExport;
+
+typedef struct LinkModule {
+    const char *name;
+    const uint8 *sections[LINK_SECTION_COUNT];
+    const uint8 *section_ends[LINK_SECTION_COUNT];
+
+    uint32 type_count;
+    const uint8 **types;
+    uint32 *type_lens;
+
+    uint32 import_count;
+    LinkImport *imports;
+
+    /* imported and defined counts of each kind */
+    uint32 import_counts[LINK_KIND_COUNT];
+    uint32 defined_counts[LINK_KIND_COUNT];
+    /* start of the defined tables and memories in their sections */
+    const uint8 *table_defs, *memory_defs;
+
+    /* type indexes of the defined functions and tags */
+    uint32 *func_type_indexes;
+    uint32 *tag_type_indexes;
+
+    uint32 export_count;
+    LinkExport *exports;
+
+    bool has_start;
+    uint32 start_func;
+
+    uint32 elem_count;
+    uint32 data_count;
+
+    /* indexes in the linked module */
+    uint32 *index_maps[LINK_KIND_COUNT];
+    uint32 type_base;
+    uint32 elem_base;
+    uint32 data_base;
+} LinkModule;
+
+typedef struct LinkContext {
+    LinkModule *modules;
+    uint32 module_count;
+    /* the imports kept in the linked module */
+    LinkImport **imports;
+    uint32 import_count;
+    uint32 import_counts[LINK_KIND_COUNT];
+    uint32 defined_counts[LINK_KIND_COUNT];
+} LinkContext;
+
+static const char *kind_names[LINK_KIND_COUNT] = { "function", "table",
+                                                   "memory", "global", "tag" };
+
+static void
+set_link_error(const LinkModule *module, const char *error)
+{
+    aot_set_last_error_v("link module %s failed: %s.", module->name, error);
+}
+
+static bool
+buf_append(LinkBuf *buf, const void *data, uint32 size)
+{
+    uint8 *new_data;
+    uint64 capacity;
+
+    if ((uint64)buf->size + size > buf->capacity) {
+        capacity = ((uint64)buf->size + size) * 2;
+        if (capacity < 256)
+            capacity = 256;
+        if (capacity >= UINT32_MAX
+            || !(new_data = wasm_runtime_realloc(buf->data, (uint32)capacity))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        buf->data = new_data;
+        buf->capacity = (uint32)capacity;
+    }
+
+    if (size > 0)
+        bh_memcpy_s(buf->data + buf->size, buf->capacity - buf->size, data,
+                    size);
+    buf->size += size;
+    return true;
+}
+
+static bool
+buf_append_u8(LinkBuf *buf, uint8 value)
+{
+    return buf_append(buf, &value, 1);
+}
+
+static bool
+buf_append_uleb(LinkBuf *buf, uint64 value)
+{
+    uint8 bytes[10];
+    uint32 n = 0;
+
+    do {
+        bytes[n] = value & 0x7F;
+        value >>= 7;
+        if (value)
+            bytes[n] |= 0x80;
+        n++;
+    } while (value);
+
+    return buf_append(buf, bytes, n);
+}
+
+static bool
+buf_append_sleb(LinkBuf *buf, int64 value)
+{
+    uint8 bytes[10];
+    uint32 n = 0;
+    bool done;
+
+    do {
+        bytes[n] = value & 0x7F;
+        value >>= 7;
+        done = (value == 0 && !(bytes[n] & 0x40))
+               || (value == -1 && (bytes[n] & 0x40));
+        if (!done)
+            bytes[n] |= 0x80;
+        n++;
+    } while (!done);
+
+    return buf_append(buf, bytes, n);
+}
+
+static bool
+buf_append_name(LinkBuf *buf, const uint8 *name, uint32 name_len)
+{
+    return buf_append_uleb(buf, name_len) && buf_append(buf, name, name_len);
+}
+
+/* Append the section with the content, which is reset for the next one */
+static bool
+buf_append_section(LinkBuf *buf, uint8 section_id, LinkBuf *content)
+{
+    bool ret = buf_append_u8(buf, section_id)
+               && buf_append_uleb(buf, content->size)
+               && buf_append(buf, content->data, content->size);
+
+    content->size = 0;
+    return ret;
+}
+
+static bool
+read_leb(const LinkModule *module, const uint8 **p_buf, const uint8 *buf_end,
+         uint32 maxbits, bool sign, uint64 *p_result)
+{
+    const uint8 *p = *p_buf;
+    uint64 result = 0;
+    uint32 shift = 0;
+    uint8 byte;
+
+    while (true) {
+        if (p >= buf_end || shift >= maxbits + 7) {
+            set_link_error(module, "invalid leb128 integer");
+            return false;
+        }
+        byte = *p++;
+        result |= ((uint64)(byte & 0x7F)) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    if (sign && shift < 64 && (byte & 0x40))
+        result |= ~((uint64)0) << shift;
+
+    *p_buf = p;
+    *p_result = result;
+    return true;
+}
+
+static bool
+read_u32(const LinkModule *module, const uint8 **p_buf, const uint8 *buf_end,
+         uint32 *p_result)
+{
+    uint64 result;
+
+    if (!read_leb(module, p_buf, buf_end, 32, false, &result))
+        return false;
+    *p_result = (uint32)result;
+    return true;
+}
+
+static bool
+read_bytes(const LinkModule *module, const uint8 **p_buf, const uint8 *buf_end,
+           uint32 size, const uint8 **p_bytes)
+{
+    if ((uint64)(buf_end - *p_buf) < size) {
+        set_link_error(module, "unexpected end");
+        return false;
+    }
+    if (p_bytes)
+        *p_bytes = *p_buf;
+    *p_buf += size;
+    return true;
+}
+
+static bool
+read_name(const LinkModule *module, const uint8 **p_buf, const uint8 *buf_end,
+          const uint8 **p_name, uint32 *p_name_len)
+{
+    return read_u32(module, p_buf, buf_end, p_name_len)
+           && read_bytes(module, p_buf, buf_end, *p_name_len, p_name);
+}
+
+static bool
+check_value_type(const LinkModule *module, uint8 type)
+{
+    /* The reference types of GC refer to the type indexes, which
+       aren't handled */
+    if (type == REF_TYPE_HT_NULLABLE || type == REF_TYPE_HT_NON_NULLABLE) {
+        set_link_error(module, "GC types are not supported");
+        return false;
+    }
+    return true;
+}
+
+static bool
+skip_limits(const LinkModule *module, const uint8 **p_buf, const uint8 *buf_end)
+{
+    uint64 value;
+    uint32 flags;
+
+    if (!read_u32(module, p_buf, buf_end, &flags)
+        || !read_leb(module, p_buf, buf_end, 64, false, &value))
+        return false;
+    if ((flags & 1) && !read_leb(module, p_buf, buf_end, 64, false, &value))
+        return false;
+    return true;
+}
+
+static bool
+skip_table_type(const LinkModule *module, const uint8 **p_buf,
+                const uint8 *buf_end)
+{
+    const uint8 *elem_type;
+
+    if (!read_bytes(module, p_buf, buf_end, 1, &elem_type)
+        || !check_value_type(module, *elem_type))
+        return false;
+    return skip_limits(module, p_buf, buf_end);
+}
+
+static uint32
+get_index_count(const LinkModule *module, uint32 kind)
+{
+    return module->import_counts[kind] + module->defined_counts[kind];
+}
+
+static bool
+remap_index(const LinkModule *module, uint32 kind, uint32 index,
+            uint32 *p_new_index)
+{
+    if (index >= get_index_count(module, kind)) {
+        aot_set_last_error_v("link module %s failed: unknown %s %u.",
+                             module->name, kind_names[kind], index);
+        return false;
+    }
+    *p_new_index = module->index_maps[kind][index];
+    return true;
+}
+
+static bool
+load_type_section(LinkModule *module)
+{
+    const uint8 *p = module->sections[SECTION_TYPE_TYPE];
+    const uint8 *p_end = module->section_ends[SECTION_TYPE_TYPE];
+    const uint8 *type_start, *value_types;
+    uint32 i, j, k, count;
+    uint64 size;
+
+    if (!p)
+        return true;
+
+    if (!read_u32(module, &p, p_end, &module->type_count))
+        return false;
+
+    size = (sizeof(uint8 *) + sizeof(uint32)) * (uint64)module->type_count;
+    if (size >= UINT32_MAX
+        || !(module->types = wasm_runtime_malloc((uint32)size + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    module->type_lens = (uint32 *)(module->types + module->type_count);
+
+    for (i = 0; i < module->type_count; i++) {
+        type_start = p;
+        if (p >= p_end || *p++ != 0x60) {
+            set_link_error(module, "only function types are supported");
+            return false;
+        }
+        /* params and results */
+        for (j = 0; j < 2; j++) {
+            if (!read_u32(module, &p, p_end, &count)
+                || !read_bytes(module, &p, p_end, count, &value_types))
+                return false;
+            for (k = 0; k < count; k++) {
+                if (!check_value_type(module, value_types[k]))
+                    return false;
+            }
+        }
+        module->types[i] = type_start;
+        module->type_lens[i] = (uint32)(p - type_start);
+    }
+
+    return true;
+}
+
+static bool
+load_import_section(LinkModule *module)
+{
+    const uint8 *p = module->sections[SECTION_TYPE_IMPORT];
+    const uint8 *p_end = module->section_ends[SECTION_TYPE_IMPORT];
+    LinkImport *import;
+    const uint8 *kind;
+    uint64 size;
+    uint32 i;
+
+    if (!p)
+        return true;
+
+    if (!read_u32(module, &p, p_end, &module->import_count))
+        return false;
+
+    size = sizeof(LinkImport) * (uint64)module->import_count;
+    if (size >= UINT32_MAX
+        || !(module->imports = wasm_runtime_malloc((uint32)size + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(module->imports, 0, (uint32)size);
+
+    for (i = 0; i < module->import_count; i++) {
+        import = &module->imports[i];
+        if (!read_name(module, &p, p_end, &import->module_name,
+                       &import->module_name_len)
+            || !read_name(module, &p, p_end, &import->field_name,
+                          &import->field_name_len)
+            || !read_bytes(module, &p, p_end, 1, &kind))
+            return false;
+
+        import->kind = *kind;
+        import->desc = p;
+        switch (import->kind) {
+            case IMPORT_KIND_FUNC:
+                if (!read_u32(module, &p, p_end, &import->type_index))
+                    return false;
+                break;
+            case IMPORT_KIND_TABLE:
+                if (!skip_table_type(module, &p, p_end))
+                    return false;
+                break;
+            case IMPORT_KIND_MEMORY:
+                if (!skip_limits(module, &p, p_end))
+                    return false;
+                break;
+            case IMPORT_KIND_GLOBAL:
+                if (!read_bytes(module, &p, p_end, 2, NULL)
+                    || !check_value_type(module, import->desc[0]))
+                    return false;
+                break;
+            case LINK_KIND_TAG:
+                if (!read_bytes(module, &p, p_end, 1, NULL)
+                    || !read_u32(module, &p, p_end, &import->type_index))
+                    return false;
+                break;
+            default:
+                set_link_error(module, "unknown import kind");
+                return false;
+        }
+        import->desc_len = (uint32)(p - import->desc);
+
+        if (import->kind == IMPORT_KIND_FUNC || import->kind == LINK_KIND_TAG) {
+            if (import->type_index >= module->type_count) {
+                set_link_error(module, "unknown type");
+                return false;
+            }
+            import->type = module->types[import->type_index];
+            import->type_len = module->type_lens[import->type_index];
+        }
+        import->index = module->import_counts[import->kind]++;
+        import->target_module = -1;
+    }
+
+    return true;
+}
+
+static bool
+load_type_indexes(LinkModule *module, uint32 section_id, uint32 kind,
+                  uint32 **p_type_indexes)
+{
+    const uint8 *p = module->sections[section_id];
+    const uint8 *p_end = module->section_ends[section_id];
+    uint32 *type_indexes, count, i;
+
+    if (!p)
+        return true;
+
+    if (!read_u32(module, &p, p_end, &count))
+        return false;
+
+    if ((uint64)count * sizeof(uint32) >= UINT32_MAX
+        || !(type_indexes = wasm_runtime_malloc(
+                 (uint32)(count * sizeof(uint32)) + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    *p_type_indexes = type_indexes;
+    module->defined_counts[kind] = count;
+
+    for (i = 0; i < count; i++) {
+        /* the attribute of tag */
+        if (kind == LINK_KIND_TAG && !read_bytes(module, &p, p_end, 1, NULL))
+            return false;
+        if (!read_u32(module, &p, p_end, &type_indexes[i]))
+            return false;
+        if (type_indexes[i] >= module->type_count) {
+            set_link_error(module, "unknown type");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+load_definitions(LinkModule *module, uint32 section_id, uint32 kind,
+                 const uint8 **p_defs)
+{
+    const uint8 *p = module->sections[section_id];
+    const uint8 *p_end = module->section_ends[section_id];
+    uint32 count, i;
+
+    if (!p)
+        return true;
+
+    if (!read_u32(module, &p, p_end, &count))
+        return false;
+
+    *p_defs = p;
+    module->defined_counts[kind] = count;
+
+    for (i = 0; i < count; i++) {
+        if (kind == IMPORT_KIND_TABLE ? !skip_table_type(module, &p, p_end)
+                                      : !skip_limits(module, &p, p_end))
+            return false;
+    }
+
+    return true;
+}
+
+static bool
+load_export_section(LinkModule *module)
+{
+    const uint8 *p = module->sections[SECTION_TYPE_EXPORT];
+    const uint8 *p_end = module->section_ends[SECTION_TYPE_EXPORT];
+    LinkExport *export;
+    const uint8 *kind;
+    uint64 size;
+    uint32 i;
+
+    if (!p)
+        return true;
+
+    if (!read_u32(module, &p, p_end, &module->export_count))
+        return false;
+
+    size = sizeof(LinkExport) * (uint64)module->export_count;
+    if (size >= UINT32_MAX
+        || !(module->exports = wasm_runtime_malloc((uint32)size + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    for (i = 0; i < module->export_count; i++) {
+        export = &module->exports[i];
+        if (!read_name(module, &p, p_end, &export->name, &export->name_len)
+            || !read_bytes(module, &p, p_end, 1, &kind)
+            || !read_u32(module, &p, p_end, &export->index))
+            return false;
+        if (*kind >= LINK_KIND_COUNT) {
+            set_link_error(module, "unknown export kind");
+            return false;
+        }
+        export->kind = *kind;
+    }
+
+    return true;
+}
+
+static bool
+load_global_count(LinkModule *module)
+{
+    const uint8 *p = module->sections[SECTION_TYPE_GLOBAL];
+    const uint8 *p_end = module->section_ends[SECTION_TYPE_GLOBAL];
+
+    return !p
+           || read_u32(module, &p, p_end,
+                       &module->defined_counts[IMPORT_KIND_GLOBAL]);
+}
+
+static bool
+load_section_count(LinkModule *module, uint32 section_id, uint32 *p_count)
+{
+    const uint8 *p = module->sections[section_id];
+    const uint8 *p_end = module->section_ends[section_id];
+
+    return !p || read_u32(module, &p, p_end, p_count);
+}
+
+static bool
+load_module(LinkModule *module, const uint8 *buf, uint32 size)
+{
+    const uint8 *p = buf, *p_end = buf + size, *section_end;
+    const uint8 *p_start;
+    uint32 section_size, func_count;
+    uint8 section_id;
+
+    if (size < 8 || memcmp(buf, "\0asm\1\0\0\0", 8)) {
+        set_link_error(module, "invalid wasm file");
+        return false;
+    }
+    p += 8;
+
+    while (p < p_end) {
+        section_id = *p++;
+        if (!read_u32(module, &p, p_end, &section_size)
+            || !read_bytes(module, &p, p_end, section_size, &p_start))
+            return false;
+        section_end = p;
+
+        if (section_id == SECTION_TYPE_USER)
+            continue;
+        if (section_id >= LINK_SECTION_COUNT || module->sections[section_id]) {
+            set_link_error(module, "unknown or duplicated section");
+            return false;
+        }
+        module->sections[section_id] = p_start;
+        module->section_ends[section_id] = section_end;
+    }
+
+    if (!load_type_section(module) || !load_import_section(module)
+        || !load_type_indexes(module, SECTION_TYPE_FUNC, IMPORT_KIND_FUNC,
+                              &module->func_type_indexes)
+        || !load_definitions(module, SECTION_TYPE_TABLE, IMPORT_KIND_TABLE,
+                             &module->table_defs)
+        || !load_definitions(module, SECTION_TYPE_MEMORY, IMPORT_KIND_MEMORY,
+                             &module->memory_defs)
+        || !load_type_indexes(module, LINK_SECTION_TAG, LINK_KIND_TAG,
+                              &module->tag_type_indexes)
+        || !load_global_count(module) || !load_export_section(module)
+        || !load_section_count(module, SECTION_TYPE_ELEM, &module->elem_count)
+        || !load_section_count(module, SECTION_TYPE_DATA, &module->data_count))
+        return false;
+
+    if (module->sections[SECTION_TYPE_START]) {
+        p = module->sections[SECTION_TYPE_START];
+        if (!read_u32(module, &p, module->section_ends[SECTION_TYPE_START],
+                      &module->start_func))
+            return false;
+        module->has_start = true;
+    }
+
+    func_count = module->defined_counts[IMPORT_KIND_FUNC];
+    if (!load_section_count(module, SECTION_TYPE_CODE, &func_count))
+        return false;
+    if (func_count != module->defined_counts[IMPORT_KIND_FUNC]) {
+        set_link_error(module, "function and code section have inconsistent "
+                               "lengths");
+        return false;
+    }
+
+    return true;
+}
+
+static void
+destroy_module(LinkModule *module)
+{
+    uint32 i;
+
+    if (module->types)
+        wasm_runtime_free((void *)module->types);
+    if (module->imports)
+        wasm_runtime_free(module->imports);
+    if (module->func_type_indexes)
+        wasm_runtime_free(module->func_type_indexes);
+    if (module->tag_type_indexes)
+        wasm_runtime_free(module->tag_type_indexes);
+    if (module->exports)
+        wasm_runtime_free(module->exports);
+    for (i = 0; i < LINK_KIND_COUNT; i++) {
+        if (module->index_maps[i])
+            wasm_runtime_free(module->index_maps[i]);
+    }
+}
+
+static bool
+is_same_name(const uint8 *name1, uint32 name1_len, const uint8 *name2,
+             uint32 name2_len)
+{
+    return name1_len == name2_len && !memcmp(name1, name2, name1_len);
+}
+
+static bool
+is_same_import(const LinkImport *import1, const LinkImport *import2)
+{
+    if (import1->kind != import2->kind
+        || !is_same_name(import1->module_name, import1->module_name_len,
+                         import2->module_name, import2->module_name_len)
+        || !is_same_name(import1->field_name, import1->field_name_len,
+                         import2->field_name, import2->field_name_len))
+        return false;
+
+    /* The type indexes in the descriptions are of different modules */
+    if (import1->kind == IMPORT_KIND_FUNC || import1->kind == LINK_KIND_TAG)
+        return is_same_name(import1->type, import1->type_len, import2->type,
+                            import2->type_len);
+    return is_same_name(import1->desc, import1->desc_len, import2->desc,
+                        import2->desc_len);
+}
+
+static const LinkExport *
+find_export(const LinkModule *module, uint8 kind, const uint8 *name,
+            uint32 name_len)
+{
+    uint32 i;
+
+    for (i = 0; i < module->export_count; i++) {
+        if (module->exports[i].kind == kind
+            && is_same_name(module->exports[i].name,
+                            module->exports[i].name_len, name, name_len))
+            return &module->exports[i];
+    }
+    return NULL;
+}
+
+/* Get the type of the function or tag */
+static bool
+get_item_type(const LinkModule *module, uint32 kind, uint32 index,
+              const uint8 **p_type, uint32 *p_type_len)
+{
+    uint32 type_index = (uint32)-1, i;
+
+    if (index < module->import_counts[kind]) {
+        for (i = 0; i < module->import_count; i++) {
+            if (module->imports[i].kind == kind
+                && module->imports[i].index == index)
+                type_index = module->imports[i].type_index;
+        }
+    }
+    else if (index < get_index_count(module, kind)) {
+        index -= module->import_counts[kind];
+        type_index = kind == IMPORT_KIND_FUNC
+                         ? module->func_type_indexes[index]
+                         : module->tag_type_indexes[index];
+    }
+
+    if (type_index >= module->type_count) {
+        set_link_error(module, "unknown type");
+        return false;
+    }
+    *p_type = module->types[type_index];
+    *p_type_len = module->type_lens[type_index];
+    return true;
+}
+
+static bool
+check_import_type(const LinkModule *module, const LinkImport *import,
+                  const LinkModule *target, uint32 target_index)
+{
+    const uint8 *target_type;
+    uint32 target_type_len, i;
+
+    if (import->kind == IMPORT_KIND_FUNC || import->kind == LINK_KIND_TAG) {
+        if (!get_item_type(target, import->kind, target_index, &target_type,
+                           &target_type_len))
+            return false;
+        if (!is_same_name(import->type, import->type_len, target_type,
+                          target_type_len))
+            goto fail;
+    }
+    else if (import->kind == IMPORT_KIND_GLOBAL) {
+        /* the global may be also imported by the target module */
+        for (i = 0; i < target->import_count; i++) {
+            if (target->imports[i].kind == IMPORT_KIND_GLOBAL
+                && target->imports[i].index == target_index
+                && memcmp(target->imports[i].desc, import->desc, 2))
+                goto fail;
+        }
+    }
+    return true;
+
+fail:
+    aot_set_last_error_v("link module %s failed: incompatible import type "
+                         "of %.*s.%.*s.",
+                         module->name, (int)import->module_name_len,
+                         import->module_name, (int)import->field_name_len,
+                         import->field_name);
+    return false;
+}
+
+static LinkImport *
+find_import(const LinkModule *module, uint32 kind, uint32 index)
+{
+    uint32 i;
+
+    for (i = 0; i < module->import_count; i++) {
+        if (module->imports[i].kind == kind
+            && module->imports[i].index == index)
+            return &module->imports[i];
+    }
+    return NULL;
+}
+
+/* Resolve the imports to the exports of the other modules, and collect
+   the imports kept in the linked module */
+static bool
+resolve_imports(LinkContext *ctx)
+{
+    LinkModule *module, *target;
+    LinkImport *import;
+    const LinkExport *export;
+    uint64 size;
+    uint32 i, j, k, total_import_count = 0;
+
+    for (i = 0; i < ctx->module_count; i++)
+        total_import_count += ctx->modules[i].import_count;
+
+    size = sizeof(LinkImport *) * (uint64)total_import_count;
+    if (size >= UINT32_MAX
+        || !(ctx->imports = wasm_runtime_malloc((uint32)size + 1))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (j = 0; j < module->import_count; j++) {
+            import = &module->imports[j];
+
+            for (k = 0; k < ctx->module_count; k++) {
+                if (k != i && ctx->modules[k].name
+                    && is_same_name(import->module_name,
+                                    import->module_name_len,
+                                    (const uint8 *)ctx->modules[k].name,
+                                    (uint32)strlen(ctx->modules[k].name)))
+                    break;
+            }
+
+            if (k < ctx->module_count) {
+                target = &ctx->modules[k];
+                if (!(export = find_export(target, import->kind,
+                                           import->field_name,
+                                           import->field_name_len))) {
+                    aot_set_last_error_v(
+                        "link module %s failed: unknown import %.*s.%.*s.",
+                        module->name, (int)import->module_name_len,
+                        import->module_name, (int)import->field_name_len,
+                        import->field_name);
+                    return false;
+                }
+                if (!check_import_type(module, import, target, export->index))
+                    return false;
+                import->target_module = (int32)k;
+                continue;
+            }
+
+            /* Merge the identical imports */
+            for (k = 0; k < ctx->import_count; k++) {
+                if (is_same_import(ctx->imports[k], import))
+                    break;
+            }
+            if (k == ctx->import_count) {
+                ctx->imports[ctx->import_count++] = import;
+                ctx->import_counts[import->kind]++;
+            }
+        }
+    }
+
+    return true;
+}
+
+static uint32
+get_kept_import_index(const LinkContext *ctx, const LinkImport *import)
+{
+    uint32 i, index = 0;
+
+    for (i = 0; i < ctx->import_count; i++) {
+        if (is_same_import(ctx->imports[i], import))
+            break;
+        if (ctx->imports[i]->kind == import->kind)
+            index++;
+    }
+    return index;
+}
+
+static bool
+create_index_maps(LinkContext *ctx)
+{
+    LinkModule *module, *target;
+    LinkImport *import;
+    const LinkExport *export;
+    uint32 defined_bases[LINK_KIND_COUNT] = { 0 };
+    uint32 type_base = 0, elem_base = 0, data_base = 0;
+    uint32 i, j, kind, index, count, depth;
+    uint64 size;
+
+    /* The defined items follow the kept imports */
+    for (kind = 0; kind < LINK_KIND_COUNT; kind++)
+        defined_bases[kind] = ctx->import_counts[kind];
+
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (kind = 0; kind < LINK_KIND_COUNT; kind++) {
+            count = get_index_count(module, kind);
+            size = sizeof(uint32) * (uint64)count;
+            if (size >= UINT32_MAX
+                || !(module->index_maps[kind] =
+                         wasm_runtime_malloc((uint32)size + 1))) {
+                aot_set_last_error("allocate memory failed.");
+                return false;
+            }
+            for (j = 0; j < module->defined_counts[kind]; j++)
+                module->index_maps[kind][module->import_counts[kind] + j] =
+                    defined_bases[kind] + j;
+            defined_bases[kind] += module->defined_counts[kind];
+            ctx->defined_counts[kind] += module->defined_counts[kind];
+        }
+        module->type_base = type_base;
+        module->elem_base = elem_base;
+        module->data_base = data_base;
+        type_base += module->type_count;
+        elem_base += module->elem_count;
+        data_base += module->data_count;
+    }
+
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (j = 0; j < module->import_count; j++) {
+            import = &module->imports[j];
+            target = module;
+            index = import->index;
+            kind = import->kind;
+
+            /* Follow the re-exported imports */
+            for (depth = 0; depth <= ctx->module_count; depth++) {
+                LinkImport *target_import = find_import(target, kind, index);
+
+                if (!target_import) {
+                    /* defined by the target module */
+                    index = target->index_maps[kind][index];
+                    break;
+                }
+                if (target_import->target_module < 0) {
+                    index = get_kept_import_index(ctx, target_import);
+                    break;
+                }
+                target = &ctx->modules[target_import->target_module];
+                export = find_export(target, kind, target_import->field_name,
+                                     target_import->field_name_len);
+                bh_assert(export);
+                index = export->index;
+                if (index >= get_index_count(target, kind)) {
+                    aot_set_last_error_v(
+                        "link module %s failed: unknown %s %u.", target->name,
+                        kind_names[kind], index);
+                    return false;
+                }
+            }
+
+            if (depth > ctx->module_count) {
+                aot_set_last_error_v("link module %s failed: import %.*s.%.*s "
+                                     "is circular.",
+                                     module->name,
+                                     (int)import->module_name_len,
+                                     import->module_name,
+                                     (int)import->field_name_len,
+                                     import->field_name);
+                return false;
+            }
+            module->index_maps[kind][import->index] = index;
+        }
+    }
+
+    return true;
+}
+
+static bool
+skip_memarg(const LinkModule *module, const uint8 **p_buf,
+            const uint8 *buf_end)
+{
+    uint32 align, memidx;
+    uint64 offset;
+
+    if (!read_u32(module, p_buf, buf_end, &align))
+        return false;
+    /* the memory index follows the alignment with multi-memory */
+    if ((align & 0x40) && !read_u32(module, p_buf, buf_end, &memidx))
+        return false;
+    return read_leb(module, p_buf, buf_end, 64, false, &offset);
+}
+
+typedef struct CodeRewriter {
+    const LinkModule *module;
+    LinkBuf *out;
+    /* start of the bytes which haven't been copied to the output */
+    const uint8 *copy_start;
+} CodeRewriter;
+
+/* Copy the pending bytes, and replace the index following them */
+static bool
+rewrite_index(CodeRewriter *rw, const uint8 **p_buf, const uint8 *buf_end,
+              int32 kind, uint32 base)
+{
+    const uint8 *index_start = *p_buf;
+    uint32 index, new_index;
+
+    if (!read_u32(rw->module, p_buf, buf_end, &index))
+        return false;
+
+    if (kind >= 0) {
+        if (!remap_index(rw->module, (uint32)kind, index, &new_index))
+            return false;
+    }
+    else {
+        new_index = base + index;
+    }
+
+    if (!buf_append(rw->out, rw->copy_start,
+                    (uint32)(index_start - rw->copy_start))
+        || !buf_append_uleb(rw->out, new_index))
+        return false;
+    rw->copy_start = *p_buf;
+    return true;
+}
+
+static bool
+rewrite_block_type(CodeRewriter *rw, const uint8 **p_buf,
+                   const uint8 *buf_end)
+{
+    const uint8 *type_start = *p_buf;
+    uint64 type;
+
+    if (!read_leb(rw->module, p_buf, buf_end, 33, true, &type))
+        return false;
+
+    /* empty or a single value type */
+    if ((int64)type < 0)
+        return true;
+
+    if (type >= rw->module->type_count) {
+        set_link_error(rw->module, "unknown type");
+        return false;
+    }
+    if (!buf_append(rw->out, rw->copy_start,
+                    (uint32)(type_start - rw->copy_start))
+        || !buf_append_sleb(rw->out, (int64)(rw->module->type_base + type)))
+        return false;
+    rw->copy_start = *p_buf;
+    return true;
+}
+
+/**
+ * Rewrite the indexes of the function body or the constant expression,
+ * the expression ends with the end opcode of depth 0.
+ */
+static bool
+rewrite_code(const LinkModule *module, const uint8 **p_buf,
+             const uint8 *buf_end, bool is_expr, LinkBuf *out)
+{
+    const uint8 *p = *p_buf;
+    CodeRewriter rw = { module, out, p };
+    uint32 depth = 0, count, opcode, i;
+    uint8 byte;
+
+#define REWRITE(kind)                                           \
+    do {                                                        \
+        if (!rewrite_index(&rw, &p, buf_end, (int32)(kind), 0)) \
+            return false;                                       \
+    } while (0)
+#define REWRITE_BASE(base)                              \
+    do {                                                \
+        if (!rewrite_index(&rw, &p, buf_end, -1, base)) \
+            return false;                               \
+    } while (0)
+#define SKIP_U32()                                       \
+    do {                                                 \
+        if (!read_u32(module, &p, buf_end, &count))      \
+            return false;                                \
+    } while (0)
+#define SKIP_BYTES(n)                                    \
+    do {                                                 \
+        if (!read_bytes(module, &p, buf_end, (n), NULL)) \
+            return false;                                \
+    } while (0)
+
+    while (p < buf_end) {
+        byte = *p++;
+        switch (byte) {
+            case WASM_OP_BLOCK:
+            case WASM_OP_LOOP:
+            case WASM_OP_IF:
+            case WASM_OP_TRY:
+                if (!rewrite_block_type(&rw, &p, buf_end))
+                    return false;
+                depth++;
+                break;
+            case WASM_OP_END:
+                if (depth == 0 && is_expr) {
+                    *p_buf = p;
+                    return buf_append(out, rw.copy_start,
+                                      (uint32)(p - rw.copy_start));
+                }
+                if (depth > 0)
+                    depth--;
+                break;
+            case WASM_OP_UNREACHABLE:
+            case WASM_OP_NOP:
+            case WASM_OP_ELSE:
+            case WASM_OP_CATCH_ALL:
+            case WASM_OP_RETURN:
+            case WASM_OP_DROP:
+            case WASM_OP_SELECT:
+            case WASM_OP_REF_IS_NULL:
+                break;
+            case WASM_OP_CATCH:
+            case WASM_OP_THROW:
+                REWRITE(LINK_KIND_TAG);
+                break;
+            case WASM_OP_DELEGATE:
+                /* delegate also ends the try block */
+                if (depth > 0)
+                    depth--;
+                SKIP_U32();
+                break;
+            case WASM_OP_RETHROW:
+            case WASM_OP_BR:
+            case WASM_OP_BR_IF:
+            case WASM_OP_GET_LOCAL:
+            case WASM_OP_SET_LOCAL:
+            case WASM_OP_TEE_LOCAL:
+            case WASM_OP_MEMORY_SIZE:
+            case WASM_OP_MEMORY_GROW:
+                SKIP_U32();
+                break;
+            case WASM_OP_BR_TABLE:
+            {
+                uint32 target_count;
+
+                if (!read_u32(module, &p, buf_end, &target_count))
+                    return false;
+                for (i = 0; i <= target_count; i++)
+                    SKIP_U32();
+                break;
+            }
+            case WASM_OP_CALL:
+            case WASM_OP_RETURN_CALL:
+            case WASM_OP_REF_FUNC:
+                REWRITE(IMPORT_KIND_FUNC);
+                break;
+            case WASM_OP_CALL_INDIRECT:
+            case WASM_OP_RETURN_CALL_INDIRECT:
+                REWRITE_BASE(module->type_base);
+                REWRITE(IMPORT_KIND_TABLE);
+                break;
+            case WASM_OP_SELECT_T:
+            {
+                const uint8 *value_types;
+
+                if (!read_u32(module, &p, buf_end, &count)
+                    || !read_bytes(module, &p, buf_end, count, &value_types))
+                    return false;
+                for (i = 0; i < count; i++) {
+                    if (!check_value_type(module, value_types[i]))
+                        return false;
+                }
+                break;
+            }
+            case WASM_OP_GET_GLOBAL:
+            case WASM_OP_SET_GLOBAL:
+                REWRITE(IMPORT_KIND_GLOBAL);
+                break;
+            case WASM_OP_TABLE_GET:
+            case WASM_OP_TABLE_SET:
+                REWRITE(IMPORT_KIND_TABLE);
+                break;
+            case WASM_OP_I32_CONST:
+            case WASM_OP_I64_CONST:
+            {
+                uint64 value;
+
+                if (!read_leb(module, &p, buf_end,
+                              byte == WASM_OP_I32_CONST ? 32 : 64, true,
+                              &value))
+                    return false;
+                break;
+            }
+            case WASM_OP_F32_CONST:
+                SKIP_BYTES(4);
+                break;
+            case WASM_OP_F64_CONST:
+                SKIP_BYTES(8);
+                break;
+            case WASM_OP_REF_NULL:
+            {
+                uint64 heap_type;
+
+                if (!read_leb(module, &p, buf_end, 33, true, &heap_type))
+                    return false;
+                break;
+            }
+            case WASM_OP_MISC_PREFIX:
+                if (!read_u32(module, &p, buf_end, &opcode))
+                    return false;
+                switch (opcode) {
+                    case WASM_OP_MEMORY_INIT:
+                        REWRITE_BASE(module->data_base);
+                        SKIP_U32();
+                        break;
+                    case WASM_OP_DATA_DROP:
+                        REWRITE_BASE(module->data_base);
+                        break;
+                    case WASM_OP_MEMORY_COPY:
+                        SKIP_U32();
+                        SKIP_U32();
+                        break;
+                    case WASM_OP_MEMORY_FILL:
+                        SKIP_U32();
+                        break;
+                    case WASM_OP_TABLE_INIT:
+                        REWRITE_BASE(module->elem_base);
+                        REWRITE(IMPORT_KIND_TABLE);
+                        break;
+                    case WASM_OP_ELEM_DROP:
+                        REWRITE_BASE(module->elem_base);
+                        break;
+                    case WASM_OP_TABLE_COPY:
+                        REWRITE(IMPORT_KIND_TABLE);
+                        REWRITE(IMPORT_KIND_TABLE);
+                        break;
+                    case WASM_OP_TABLE_GROW:
+                    case WASM_OP_TABLE_SIZE:
+                    case WASM_OP_TABLE_FILL:
+                        REWRITE(IMPORT_KIND_TABLE);
+                        break;
+                    default:
+                        /* the saturating truncations */
+                        if (opcode > 0x07)
+                            goto unsupported_opcode;
+                        break;
+                }
+                break;
+            case WASM_OP_SIMD_PREFIX:
+                if (!read_u32(module, &p, buf_end, &opcode))
+                    return false;
+                if (opcode <= SIMD_v128_store
+                    || opcode == SIMD_v128_load32_zero
+                    || opcode == SIMD_v128_load64_zero) {
+                    if (!skip_memarg(module, &p, buf_end))
+                        return false;
+                }
+                else if (opcode == SIMD_v128_const
+                         || opcode == SIMD_v8x16_shuffle) {
+                    SKIP_BYTES(16);
+                }
+                else if (opcode >= SIMD_i8x16_extract_lane_s
+                         && opcode <= SIMD_f64x2_replace_lane) {
+                    SKIP_BYTES(1);
+                }
+                else if (opcode >= SIMD_v128_load8_lane
+                         && opcode <= SIMD_v128_store64_lane) {
+                    if (!skip_memarg(module, &p, buf_end))
+                        return false;
+                    SKIP_BYTES(1);
+                }
+                break;
+            case WASM_OP_ATOMIC_PREFIX:
+                if (!read_u32(module, &p, buf_end, &opcode))
+                    return false;
+                if (opcode == WASM_OP_ATOMIC_FENCE) {
+                    SKIP_BYTES(1);
+                }
+                else if (!skip_memarg(module, &p, buf_end))
+                    return false;
+                break;
+            default:
+                if (byte >= WASM_OP_I32_LOAD && byte <= WASM_OP_I64_STORE32) {
+                    if (!skip_memarg(module, &p, buf_end))
+                        return false;
+                }
+                /* the numeric instructions without immediates */
+                else if (!(byte >= WASM_OP_I32_EQZ
+                           && byte <= WASM_OP_I64_EXTEND32_S)) {
+                    opcode = byte;
+                    goto unsupported_opcode;
+                }
+                break;
+        }
+    }
+
+    if (is_expr) {
+        set_link_error(module, "unexpected end of expression");
+        return false;
+    }
+    *p_buf = p;
+    return buf_append(out, rw.copy_start, (uint32)(p - rw.copy_start));
+
+unsupported_opcode:
+    aot_set_last_error_v("link module %s failed: unsupported opcode 0x%02x.",
+                         module->name, opcode);
+    return false;
+
+#undef REWRITE
+#undef REWRITE_BASE
+#undef SKIP_U32
+#undef SKIP_BYTES
+}
+
+static bool
+emit_type_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content,
+                  bool add_start_type)
+{
+    LinkModule *module;
+    uint32 i, j, count = 0;
+
+    for (i = 0; i < ctx->module_count; i++)
+        count += ctx->modules[i].type_count;
+
+    if (!buf_append_uleb(content, count + (add_start_type ? 1 : 0)))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (j = 0; j < module->type_count; j++) {
+            if (!buf_append(content, module->types[j], module->type_lens[j]))
+                return false;
+        }
+    }
+    /* [] -> [] */
+    if (add_start_type && !buf_append(content, "\x60\x00\x00", 3))
+        return false;
+
+    return buf_append_section(out, SECTION_TYPE_TYPE, content);
+}
+
+static bool
+emit_import_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    LinkImport *import;
+    LinkModule *module = NULL;
+    uint32 i, j;
+
+    if (ctx->import_count == 0)
+        return true;
+
+    if (!buf_append_uleb(content, ctx->import_count))
+        return false;
+
+    for (i = 0; i < ctx->import_count; i++) {
+        import = ctx->imports[i];
+        for (j = 0; j < ctx->module_count; j++) {
+            module = &ctx->modules[j];
+            if (import >= module->imports
+                && import < module->imports + module->import_count)
+                break;
+        }
+        bh_assert(j < ctx->module_count);
+
+        if (!buf_append_name(content, import->module_name,
+                             import->module_name_len)
+            || !buf_append_name(content, import->field_name,
+                                import->field_name_len)
+            || !buf_append_u8(content, import->kind))
+            return false;
+
+        if (import->kind == IMPORT_KIND_FUNC) {
+            if (!buf_append_uleb(content,
+                                 module->type_base + import->type_index))
+                return false;
+        }
+        else if (import->kind == LINK_KIND_TAG) {
+            /* the attribute and the type index */
+            if (!buf_append_u8(content, import->desc[0])
+                || !buf_append_uleb(content,
+                                    module->type_base + import->type_index))
+                return false;
+        }
+        else if (!buf_append(content, import->desc, import->desc_len)) {
+            return false;
+        }
+    }
+
+    return buf_append_section(out, SECTION_TYPE_IMPORT, content);
+}
+
+static bool
+emit_function_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content,
+                      uint32 start_type_index)
+{
+    LinkModule *module;
+    uint32 i, j, count = ctx->defined_counts[IMPORT_KIND_FUNC];
+
+    if (start_type_index != (uint32)-1)
+        count++;
+    if (count == 0)
+        return true;
+
+    if (!buf_append_uleb(content, count))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (j = 0; j < module->defined_counts[IMPORT_KIND_FUNC]; j++) {
+            if (!buf_append_uleb(content, module->type_base
+                                              + module->func_type_indexes[j]))
+                return false;
+        }
+    }
+    if (start_type_index != (uint32)-1
+        && !buf_append_uleb(content, start_type_index))
+        return false;
+
+    return buf_append_section(out, SECTION_TYPE_FUNC, content);
+}
+
+/* Copy the definitions of the tables or memories */
+static bool
+emit_definition_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content,
+                        uint32 section_id, uint32 kind)
+{
+    LinkModule *module;
+    const uint8 *defs;
+    uint32 i;
+
+    if (ctx->defined_counts[kind] == 0)
+        return true;
+
+    if (!buf_append_uleb(content, ctx->defined_counts[kind]))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        if (module->defined_counts[kind] == 0)
+            continue;
+        defs = kind == IMPORT_KIND_TABLE ? module->table_defs
+                                         : module->memory_defs;
+        if (!buf_append(content, defs,
+                        (uint32)(module->section_ends[section_id] - defs)))
+            return false;
+    }
+
+    return buf_append_section(out, section_id, content);
+}
+
+static bool
+emit_tag_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    LinkModule *module;
+    uint32 i, j;
+
+    if (ctx->defined_counts[LINK_KIND_TAG] == 0)
+        return true;
+
+    if (!buf_append_uleb(content, ctx->defined_counts[LINK_KIND_TAG]))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        for (j = 0; j < module->defined_counts[LINK_KIND_TAG]; j++) {
+            /* exception attribute */
+            if (!buf_append_u8(content, 0)
+                || !buf_append_uleb(content, module->type_base
+                                                 + module->tag_type_indexes[j]))
+                return false;
+        }
+    }
+
+    return buf_append_section(out, LINK_SECTION_TAG, content);
+}
+
+static bool
+emit_global_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    LinkModule *module;
+    const uint8 *p, *p_end, *global_type;
+    uint32 i, j, count;
+
+    if (ctx->defined_counts[IMPORT_KIND_GLOBAL] == 0)
+        return true;
+
+    if (!buf_append_uleb(content, ctx->defined_counts[IMPORT_KIND_GLOBAL]))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        if (!(p = module->sections[SECTION_TYPE_GLOBAL]))
+            continue;
+        p_end = module->section_ends[SECTION_TYPE_GLOBAL];
+
+        if (!read_u32(module, &p, p_end, &count))
+            return false;
+        for (j = 0; j < count; j++) {
+            /* value type and mutability */
+            if (!read_bytes(module, &p, p_end, 2, &global_type)
+                || !check_value_type(module, global_type[0])
+                || !buf_append(content, global_type, 2)
+                || !rewrite_code(module, &p, p_end, true, content))
+                return false;
+        }
+    }
+
+    return buf_append_section(out, SECTION_TYPE_GLOBAL, content);
+}
+
+static bool
+emit_export_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    /* Only the main module's exports are kept */
+    LinkModule *module = &ctx->modules[0];
+    LinkExport *export;
+    uint32 i, index;
+
+    if (module->export_count == 0)
+        return true;
+
+    if (!buf_append_uleb(content, module->export_count))
+        return false;
+    for (i = 0; i < module->export_count; i++) {
+        export = &module->exports[i];
+        if (!remap_index(module, export->kind, export->index, &index)
+            || !buf_append_name(content, export->name, export->name_len)
+            || !buf_append_u8(content, export->kind)
+            || !buf_append_uleb(content, index))
+            return false;
+    }
+
+    return buf_append_section(out, SECTION_TYPE_EXPORT, content);
+}
+
+static bool
+emit_elem_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    LinkModule *module;
+    const uint8 *p, *p_end, *elem_type;
+    uint32 i, j, k, count, flags, table_index, value_count, func_index;
+    uint32 elem_count = 0;
+
+    for (i = 0; i < ctx->module_count; i++)
+        elem_count += ctx->modules[i].elem_count;
+    if (elem_count == 0)
+        return true;
+
+    if (!buf_append_uleb(content, elem_count))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        if (!(p = module->sections[SECTION_TYPE_ELEM]))
+            continue;
+        p_end = module->section_ends[SECTION_TYPE_ELEM];
+
+        if (!read_u32(module, &p, p_end, &count)
+            || !read_u32(module, &p, p_end, &flags))
+            return false;
+
+        for (j = 0; j < count; j++) {
+            if (j > 0 && !read_u32(module, &p, p_end, &flags))
+                return false;
+            if (flags > 7) {
+                set_link_error(module, "unknown element segment kind");
+                return false;
+            }
+
+            /* The active segments are always emitted with the table index,
+               which may not be 0 in the linked module */
+            if (!buf_append_uleb(content, (flags & 1) ? flags : (flags | 2)))
+                return false;
+
+            if (!(flags & 1)) {
+                table_index = 0;
+                if ((flags & 2) && !read_u32(module, &p, p_end, &table_index))
+                    return false;
+                if (!remap_index(module, IMPORT_KIND_TABLE, table_index,
+                                 &table_index)
+                    || !buf_append_uleb(content, table_index)
+                    || !rewrite_code(module, &p, p_end, true, content))
+                    return false;
+            }
+
+            /* elemkind or reftype */
+            if (flags & 3) {
+                if (!read_bytes(module, &p, p_end, 1, &elem_type)
+                    || !check_value_type(module, *elem_type)
+                    || !buf_append_u8(content, *elem_type))
+                    return false;
+            }
+            else if (!buf_append_u8(content,
+                                    (flags & 4) ? VALUE_TYPE_FUNCREF : 0)) {
+                return false;
+            }
+
+            if (!read_u32(module, &p, p_end, &value_count)
+                || !buf_append_uleb(content, value_count))
+                return false;
+            for (k = 0; k < value_count; k++) {
+                if (flags & 4) {
+                    if (!rewrite_code(module, &p, p_end, true, content))
+                        return false;
+                }
+                else if (!read_u32(module, &p, p_end, &func_index)
+                         || !remap_index(module, IMPORT_KIND_FUNC, func_index,
+                                         &func_index)
+                         || !buf_append_uleb(content, func_index)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return buf_append_section(out, SECTION_TYPE_ELEM, content);
+}
+
+static bool
+emit_code_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content,
+                  const uint32 *start_funcs, uint32 start_func_count)
+{
+    LinkModule *module;
+    LinkBuf body = { 0 };
+    const uint8 *p, *p_end, *body_end, *locals;
+    uint32 i, j, k, count, body_size, local_group_count, local_count;
+    uint32 func_count = ctx->defined_counts[IMPORT_KIND_FUNC];
+    bool ret = false;
+
+    if (start_func_count > 1)
+        func_count++;
+    if (func_count == 0)
+        return true;
+
+    if (!buf_append_uleb(content, func_count))
+        goto fail;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        if (!(p = module->sections[SECTION_TYPE_CODE]))
+            continue;
+        p_end = module->section_ends[SECTION_TYPE_CODE];
+
+        if (!read_u32(module, &p, p_end, &count))
+            goto fail;
+        for (j = 0; j < count; j++) {
+            if (!read_u32(module, &p, p_end, &body_size)
+                || !read_bytes(module, &p, p_end, body_size, NULL))
+                goto fail;
+            body_end = p;
+            p -= body_size;
+
+            /* The locals are copied as they are */
+            locals = p;
+            if (!read_u32(module, &p, body_end, &local_group_count))
+                goto fail;
+            for (k = 0; k < local_group_count; k++) {
+                const uint8 *local_type;
+
+                if (!read_u32(module, &p, body_end, &local_count)
+                    || !read_bytes(module, &p, body_end, 1, &local_type)
+                    || !check_value_type(module, *local_type))
+                    goto fail;
+            }
+
+            body.size = 0;
+            if (!buf_append(&body, locals, (uint32)(p - locals))
+                || !rewrite_code(module, &p, body_end, false, &body)
+                || !buf_append_uleb(content, body.size)
+                || !buf_append(content, body.data, body.size))
+                goto fail;
+        }
+    }
+
+    /* The start function calling the start functions of all modules */
+    if (start_func_count > 1) {
+        body.size = 0;
+        if (!buf_append_u8(&body, 0))
+            goto fail;
+        for (i = 0; i < start_func_count; i++) {
+            if (!buf_append_u8(&body, WASM_OP_CALL)
+                || !buf_append_uleb(&body, start_funcs[i]))
+                goto fail;
+        }
+        if (!buf_append_u8(&body, WASM_OP_END)
+            || !buf_append_uleb(content, body.size)
+            || !buf_append(content, body.data, body.size))
+            goto fail;
+    }
+
+    ret = buf_append_section(out, SECTION_TYPE_CODE, content);
+
+fail:
+    if (body.data)
+        wasm_runtime_free(body.data);
+    return ret;
+}
+
+static bool
+emit_data_section(LinkContext *ctx, LinkBuf *out, LinkBuf *content)
+{
+    LinkModule *module;
+    const uint8 *p, *p_end, *data;
+    uint32 i, j, count, flags, memory_index, data_len, data_count = 0;
+
+    for (i = 0; i < ctx->module_count; i++)
+        data_count += ctx->modules[i].data_count;
+    if (data_count == 0)
+        return true;
+
+    /* The data count section precedes the code section, emit it here
+       and the data section after the code section */
+    if (!buf_append_uleb(content, data_count)
+        || !buf_append_section(out, LINK_SECTION_DATACOUNT, content))
+        return false;
+
+    if (!buf_append_uleb(content, data_count))
+        return false;
+    for (i = 0; i < ctx->module_count; i++) {
+        module = &ctx->modules[i];
+        if (!(p = module->sections[SECTION_TYPE_DATA]))
+            continue;
+        p_end = module->section_ends[SECTION_TYPE_DATA];
+
+        if (!read_u32(module, &p, p_end, &count))
+            return false;
+        for (j = 0; j < count; j++) {
+            if (!read_u32(module, &p, p_end, &flags))
+                return false;
+            if (flags > 2) {
+                set_link_error(module, "unknown data segment kind");
+                return false;
+            }
+
+            memory_index = 0;
+            if (flags == 2 && !read_u32(module, &p, p_end, &memory_index))
+                return false;
+            if (flags != 1
+                && !remap_index(module, IMPORT_KIND_MEMORY, memory_index,
+                                &memory_index))
+                return false;
+
+            /* There is only one memory in the linked module */
+            bh_assert(memory_index == 0);
+            if (!buf_append_uleb(content, flags == 1 ? 1 : 0))
+                return false;
+            if (flags != 1 && !rewrite_code(module, &p, p_end, true, content))
+                return false;
+
+            if (!read_u32(module, &p, p_end, &data_len)
+                || !read_bytes(module, &p, p_end, data_len, &data)
+                || !buf_append_name(content, data, data_len))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+emit_linked_module(LinkContext *ctx, LinkBuf *out)
+{
+    LinkModule *module;
+    LinkBuf content = { 0 }, data = { 0 };
+    uint32 start_funcs[8], start_func_count = 0, start_func = 0;
+    uint32 type_count = 0, start_type_index = (uint32)-1, i;
+    bool ret = false;
+
+    /* The start functions of the dependencies run first */
+    for (i = 1; i <= ctx->module_count; i++) {
+        module = &ctx->modules[i % ctx->module_count];
+        if (!module->has_start)
+            continue;
+        if (start_func_count >= sizeof(start_funcs) / sizeof(uint32)) {
+            aot_set_last_error("too many start functions.");
+            return false;
+        }
+        if (!remap_index(module, IMPORT_KIND_FUNC, module->start_func,
+                         &start_funcs[start_func_count++]))
+            return false;
+    }
+
+    for (i = 0; i < ctx->module_count; i++)
+        type_count += ctx->modules[i].type_count;
+
+    if (start_func_count > 1) {
+        start_type_index = type_count;
+        start_func = ctx->import_counts[IMPORT_KIND_FUNC]
+                     + ctx->defined_counts[IMPORT_KIND_FUNC];
+    }
+    else if (start_func_count == 1) {
+        start_func = start_funcs[0];
+    }
+
+    if (!buf_append(out, "\0asm\1\0\0\0", 8)
+        || !emit_type_section(ctx, out, &content, start_func_count > 1)
+        || !emit_import_section(ctx, out, &content)
+        || !emit_function_section(ctx, out, &content, start_type_index)
+        || !emit_definition_section(ctx, out, &content, SECTION_TYPE_TABLE,
+                                    IMPORT_KIND_TABLE)
+        || !emit_definition_section(ctx, out, &content, SECTION_TYPE_MEMORY,
+                                    IMPORT_KIND_MEMORY)
+        || !emit_tag_section(ctx, out, &content)
+        || !emit_global_section(ctx, out, &content)
+        || !emit_export_section(ctx, out, &content))
+        goto fail;
+
+    if (start_func_count > 0
+        && (!buf_append_uleb(&content, start_func)
+            || !buf_append_section(out, SECTION_TYPE_START, &content)))
+        goto fail;
+
+    if (!emit_elem_section(ctx, out, &content)
+        /* the data count section is appended to out */
+        || !emit_data_section(ctx, out, &data)
+        || !emit_code_section(ctx, out, &content, start_funcs,
+                              start_func_count))
+        goto fail;
+
+    if (data.size > 0 && !buf_append_section(out, SECTION_TYPE_DATA, &data))
+        goto fail;
+
+    ret = true;
+
+fail:
+    if (content.data)
+        wasm_runtime_free(content.data);
+    if (data.data)
+        wasm_runtime_free(data.data);
+    return ret;
+}
+
+bool
+aot_link_wasm_modules(const char **module_names, uint8 **wasm_bufs,
+                      const uint32 *wasm_buf_sizes, uint32 module_count,
+                      uint8 **p_linked_buf, uint32 *p_linked_size)
+{
+    LinkContext ctx = { 0 };
+    LinkBuf out = { 0 };
+    uint64 size;
+    uint32 i;
+    bool ret = false;
+
+    size = sizeof(LinkModule) * (uint64)module_count;
+    if (module_count == 0 || size >= UINT32_MAX
+        || !(ctx.modules = wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(ctx.modules, 0, (uint32)size);
+    ctx.module_count = module_count;
+
+    for (i = 0; i < module_count; i++) {
+        ctx.modules[i].name = module_names[i];
+        if (!load_module(&ctx.modules[i], wasm_bufs[i], wasm_buf_sizes[i]))
+            goto fail;
+    }
+
+    if (!resolve_imports(&ctx) || !create_index_maps(&ctx))
+        goto fail;
+
+    /* The modules share the linear memory */
+    if (ctx.import_counts[IMPORT_KIND_MEMORY]
+            + ctx.defined_counts[IMPORT_KIND_MEMORY]
+        > 1) {
+        aot_set_last_error("link modules failed: the modules must share one "
+                           "linear memory, import it from the module "
+                           "defining it.");
+        goto fail;
+    }
+
+    if (!emit_linked_module(&ctx, &out))
+        goto fail;
+
+    *p_linked_buf = out.data;
+    *p_linked_size = out.size;
+    out.data = NULL;
+    ret = true;
+
+fail:
+    for (i = 0; i < module_count; i++)
+        destroy_module(&ctx.modules[i]);
+    wasm_runtime_free(ctx.modules);
+    if (ctx.imports)
+        wasm_runtime_free(ctx.imports);
+    if (out.data)
+        wasm_runtime_free(out.data);
+    return ret;
+}
@@ -12,13 +12,13 @@
 
 /* data_length in bytes */
 static LLVMValueRef
-simd_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 align,
-          mem_offset_t offset, uint32 data_length, LLVMTypeRef ptr_type,
-          LLVMTypeRef data_type, bool enable_segue)
+simd_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 mem_idx,
+          uint32 align, mem_offset_t offset, uint32 data_length,
+          LLVMTypeRef ptr_type, LLVMTypeRef data_type, bool enable_segue)
 {
     LLVMValueRef maddr, data;
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset,
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
                                             data_length, enable_segue, NULL))) {
         HANDLE_FAILURE("aot_check_memory_overflow");
         return NULL;
@@ -42,13 +42,13 @@ simd_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 align,
 
 bool
 aot_compile_simd_v128_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint32 align, mem_offset_t offset)
+                           uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
-    bool enable_segue = comp_ctx->enable_segue_v128_load;
+    bool enable_segue = comp_ctx->enable_segue_v128_load && mem_idx == 0;
     LLVMTypeRef v128_ptr_type = enable_segue ? V128_PTR_TYPE_GS : V128_PTR_TYPE;
     LLVMValueRef result;
 
-    if (!(result = simd_load(comp_ctx, func_ctx, align, offset, 16,
+    if (!(result = simd_load(comp_ctx, func_ctx, mem_idx, align, offset, 16,
                              v128_ptr_type, V128_TYPE, enable_segue))) {
         return false;
     }
@@ -62,7 +62,8 @@ fail:
 
 bool
 aot_compile_simd_load_extend(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                             uint8 opcode, uint32 align, mem_offset_t offset)
+                             uint8 opcode, uint32 mem_idx, uint32 align,
+                             mem_offset_t offset)
 {
     LLVMValueRef sub_vector, result;
     uint32 opcode_index = opcode - SIMD_v128_load8x8_s;
@@ -77,7 +78,7 @@ aot_compile_simd_load_extend(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         LLVMVectorType(I32_TYPE, 2),   LLVMVectorType(I32_TYPE, 2),
     };
     LLVMTypeRef sub_vector_type, sub_vector_ptr_type;
-    bool enable_segue = comp_ctx->enable_segue_v128_load;
+    bool enable_segue = comp_ctx->enable_segue_v128_load && mem_idx == 0;
 
     bh_assert(opcode_index < 6);
 
@@ -92,7 +93,7 @@ aot_compile_simd_load_extend(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     if (!(sub_vector =
-              simd_load(comp_ctx, func_ctx, align, offset, 8,
+              simd_load(comp_ctx, func_ctx, mem_idx, align, offset, 8,
                         sub_vector_ptr_type, sub_vector_type, enable_segue))) {
         return false;
     }
@@ -117,7 +118,8 @@ aot_compile_simd_load_extend(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 bool
 aot_compile_simd_load_splat(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint8 opcode, uint32 align, mem_offset_t offset)
+                            uint8 opcode, uint32 mem_idx, uint32 align,
+                            mem_offset_t offset)
 {
     uint32 opcode_index = opcode - SIMD_v128_load8_splat;
     LLVMValueRef element, result;
@@ -141,15 +143,15 @@ aot_compile_simd_load_splat(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         LLVM_CONST(i32x4_zero),
         LLVM_CONST(i32x2_zero),
     };
-    bool enable_segue = comp_ctx->enable_segue_v128_load;
+    bool enable_segue = comp_ctx->enable_segue_v128_load && mem_idx == 0;
 
     bh_assert(opcode_index < 4);
 
     if (!(element = simd_load(
-              comp_ctx, func_ctx, align, offset, data_lengths[opcode_index],
-              comp_ctx->enable_segue_v128_load
-                  ? element_ptr_types_gs[opcode_index]
-                  : element_ptr_types[opcode_index],
+              comp_ctx, func_ctx, mem_idx, align, offset,
+              data_lengths[opcode_index],
+              enable_segue ? element_ptr_types_gs[opcode_index]
+                           : element_ptr_types[opcode_index],
               element_data_types[opcode_index], enable_segue))) {
         return false;
     }
@@ -173,8 +175,8 @@ aot_compile_simd_load_splat(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 bool
 aot_compile_simd_load_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 opcode, uint32 align, mem_offset_t offset,
-                           uint8 lane_id)
+                           uint8 opcode, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset, uint8 lane_id)
 {
     LLVMValueRef element, vector;
     uint32 opcode_index = opcode - SIMD_v128_load8_lane;
@@ -189,7 +191,7 @@ aot_compile_simd_load_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMTypeRef vector_types[] = { V128_i8x16_TYPE, V128_i16x8_TYPE,
                                    V128_i32x4_TYPE, V128_i64x2_TYPE };
     LLVMValueRef lane = simd_lane_id_to_llvm_value(comp_ctx, lane_id);
-    bool enable_segue = comp_ctx->enable_segue_v128_load;
+    bool enable_segue = comp_ctx->enable_segue_v128_load && mem_idx == 0;
 
     bh_assert(opcode_index < 4);
 
@@ -199,10 +201,10 @@ aot_compile_simd_load_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
 
     if (!(element = simd_load(
-              comp_ctx, func_ctx, align, offset, data_lengths[opcode_index],
-              comp_ctx->enable_segue_v128_load
-                  ? element_ptr_types_gs[opcode_index]
-                  : element_ptr_types[opcode_index],
+              comp_ctx, func_ctx, mem_idx, align, offset,
+              data_lengths[opcode_index],
+              enable_segue ? element_ptr_types_gs[opcode_index]
+                           : element_ptr_types[opcode_index],
               element_data_types[opcode_index], enable_segue))) {
         return false;
     }
@@ -218,7 +220,8 @@ aot_compile_simd_load_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 bool
 aot_compile_simd_load_zero(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 opcode, uint32 align, mem_offset_t offset)
+                           uint8 opcode, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset)
 {
     LLVMValueRef element, result, mask;
     uint32 opcode_index = opcode - SIMD_v128_load32_zero;
@@ -241,15 +244,15 @@ aot_compile_simd_load_zero(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
           LLVM_CONST(i32_six) },
         { LLVM_CONST(i32_zero), LLVM_CONST(i32_two) },
     };
-    bool enable_segue = comp_ctx->enable_segue_v128_load;
+    bool enable_segue = comp_ctx->enable_segue_v128_load && mem_idx == 0;
 
     bh_assert(opcode_index < 2);
 
     if (!(element = simd_load(
-              comp_ctx, func_ctx, align, offset, data_lengths[opcode_index],
-              comp_ctx->enable_segue_v128_load
-                  ? element_ptr_types_gs[opcode_index]
-                  : element_ptr_types[opcode_index],
+              comp_ctx, func_ctx, mem_idx, align, offset,
+              data_lengths[opcode_index],
+              enable_segue ? element_ptr_types_gs[opcode_index]
+                           : element_ptr_types[opcode_index],
               element_data_types[opcode_index], enable_segue))) {
         return false;
     }
@@ -280,13 +283,13 @@ aot_compile_simd_load_zero(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
 /* data_length in bytes */
 static bool
-simd_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 align,
-           mem_offset_t offset, uint32 data_length, LLVMValueRef value,
-           LLVMTypeRef value_ptr_type, bool enable_segue)
+simd_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 mem_idx,
+           uint32 align, mem_offset_t offset, uint32 data_length,
+           LLVMValueRef value, LLVMTypeRef value_ptr_type, bool enable_segue)
 {
     LLVMValueRef maddr, result;
 
-    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, offset,
+    if (!(maddr = aot_check_memory_overflow(comp_ctx, func_ctx, mem_idx, offset,
                                             data_length, enable_segue, NULL)))
         return false;
 
@@ -308,15 +311,15 @@ simd_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx, uint32 align,
 
 bool
 aot_compile_simd_v128_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint32 align, mem_offset_t offset)
+                            uint32 mem_idx, uint32 align, mem_offset_t offset)
 {
-    bool enable_segue = comp_ctx->enable_segue_v128_store;
+    bool enable_segue = comp_ctx->enable_segue_v128_store && mem_idx == 0;
     LLVMTypeRef v128_ptr_type = enable_segue ? V128_PTR_TYPE_GS : V128_PTR_TYPE;
     LLVMValueRef value;
 
     POP_V128(value);
 
-    return simd_store(comp_ctx, func_ctx, align, offset, 16, value,
+    return simd_store(comp_ctx, func_ctx, mem_idx, align, offset, 16, value,
                       v128_ptr_type, enable_segue);
 fail:
     return false;
@@ -324,8 +327,8 @@ fail:
 
 bool
 aot_compile_simd_store_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint8 opcode, uint32 align, mem_offset_t offset,
-                            uint8 lane_id)
+                            uint8 opcode, uint32 mem_idx, uint32 align,
+                            mem_offset_t offset, uint8 lane_id)
 {
     LLVMValueRef element, vector;
     uint32 data_lengths[] = { 1, 2, 4, 8 };
@@ -338,7 +341,7 @@ aot_compile_simd_store_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     LLVMTypeRef vector_types[] = { V128_i8x16_TYPE, V128_i16x8_TYPE,
                                    V128_i32x4_TYPE, V128_i64x2_TYPE };
     LLVMValueRef lane = simd_lane_id_to_llvm_value(comp_ctx, lane_id);
-    bool enable_segue = comp_ctx->enable_segue_v128_store;
+    bool enable_segue = comp_ctx->enable_segue_v128_store && mem_idx == 0;
 
     bh_assert(opcode_index < 4);
 
@@ -353,7 +356,7 @@ aot_compile_simd_store_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         return false;
     }
 
-    return simd_store(comp_ctx, func_ctx, align, offset,
+    return simd_store(comp_ctx, func_ctx, mem_idx, align, offset,
                       data_lengths[opcode_index], element,
                       enable_segue ? element_ptr_types_gs[opcode_index]
                                    : element_ptr_types[opcode_index],
@@ -14,33 +14,36 @@ extern "C" {
 
 bool
 aot_compile_simd_v128_load(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint32 align, mem_offset_t offset);
+                           uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 bool
 aot_compile_simd_load_extend(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                             uint8 opcode, uint32 align, mem_offset_t offset);
+                             uint8 opcode, uint32 mem_idx, uint32 align,
+                             mem_offset_t offset);
 
 bool
 aot_compile_simd_load_splat(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint8 opcode, uint32 align, mem_offset_t offset);
+                            uint8 opcode, uint32 mem_idx, uint32 align,
+                            mem_offset_t offset);
 
 bool
 aot_compile_simd_load_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 opcode, uint32 align, mem_offset_t offset,
-                           uint8 lane_id);
+                           uint8 opcode, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset, uint8 lane_id);
 
 bool
 aot_compile_simd_load_zero(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                           uint8 opcode, uint32 align, mem_offset_t offset);
+                           uint8 opcode, uint32 mem_idx, uint32 align,
+                           mem_offset_t offset);
 
 bool
 aot_compile_simd_v128_store(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint32 align, mem_offset_t offset);
+                            uint32 mem_idx, uint32 align, mem_offset_t offset);
 
 bool
 aot_compile_simd_store_lane(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                            uint8 opcode, uint32 align, mem_offset_t offset,
-                            uint8 lane_id);
+                            uint8 opcode, uint32 mem_idx, uint32 align,
+                            mem_offset_t offset, uint8 lane_id);
 
 #ifdef __cplusplus
 } /* end of extern "C" */
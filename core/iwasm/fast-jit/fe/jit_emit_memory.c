@@ -10,6 +10,9 @@
 #include "../jit_codegen.h"
 #include "../../interpreter/wasm_runtime.h"
 #include "jit_emit_control.h"
+#if WASM_ENABLE_SHARED_HEAP != 0
+#include "../../common/wasm_memory.h"
+#endif
 
 #ifndef OS_ENABLE_HW_BOUND_CHECK
 static JitReg
@@ -624,6 +627,26 @@ fail:
 }
 
 #if WASM_ENABLE_BULK_MEMORY != 0
+/* Check whether [offset, offset + len) is in the memory, or in the shared
+   heap mapped above the default memory */
+static bool
+is_app_range_valid(WASMModuleInstance *inst, uint32 mem_idx, uint64 mem_size,
+                   uint32 offset, uint32 len)
+{
+    if (mem_size >= offset && mem_size - offset >= len)
+        return true;
+#if WASM_ENABLE_SHARED_HEAP != 0
+    if (mem_idx == 0
+        && wasm_runtime_is_app_addr_in_shared_heap(
+            (WASMModuleInstanceCommon *)inst, offset, len))
+        return true;
+#else
+    (void)inst;
+    (void)mem_idx;
+#endif
+    return false;
+}
+
 static int
 wasm_init_memory(WASMModuleInstance *inst, uint32 mem_idx, uint32 seg_idx,
                  uint32 len, uint32 mem_offset, uint32 data_offset)
@@ -637,7 +660,7 @@ wasm_init_memory(WASMModuleInstance *inst, uint32 mem_idx, uint32 seg_idx,
     /* if d + n > the length of mem.data */
     mem_inst = inst->memories[mem_idx];
     mem_size = mem_inst->cur_page_count * (uint64)mem_inst->num_bytes_per_page;
-    if (mem_size < mem_offset || mem_size - mem_offset < len)
+    if (!is_app_range_valid(inst, mem_idx, mem_size, mem_offset, len))
         goto out_of_bounds;
 
     /* if s + n > the length of data.data */
@@ -655,7 +678,7 @@ wasm_init_memory(WASMModuleInstance *inst, uint32 mem_idx, uint32 seg_idx,
         goto out_of_bounds;
 
     mem_addr = mem_inst->memory_data + mem_offset;
-    bh_memcpy_s(mem_addr, (uint32)(mem_size - mem_offset), data_addr, len);
+    bh_memcpy_s(mem_addr, len, data_addr, len);
 
     return 0;
 out_of_bounds:
@@ -730,17 +753,17 @@ wasm_copy_memory(WASMModuleInstance *inst, uint32 src_mem_idx,
         dst_mem->cur_page_count * (uint64)dst_mem->num_bytes_per_page;
 
     /* if s + n > the length of mem.data */
-    if (src_mem_size < src_offset || src_mem_size - src_offset < len)
+    if (!is_app_range_valid(inst, src_mem_idx, src_mem_size, src_offset, len))
         goto out_of_bounds;
 
     /* if d + n > the length of mem.data */
-    if (dst_mem_size < dst_offset || dst_mem_size - dst_offset < len)
+    if (!is_app_range_valid(inst, dst_mem_idx, dst_mem_size, dst_offset, len))
         goto out_of_bounds;
 
     src_addr = src_mem->memory_data + src_offset;
     dst_addr = dst_mem->memory_data + dst_offset;
     /* allowing the destination and source to overlap */
-    bh_memmove_s(dst_addr, (uint32)(dst_mem_size - dst_offset), src_addr, len);
+    bh_memmove_s(dst_addr, len, src_addr, len);
 
     return 0;
 out_of_bounds:
@@ -792,7 +815,7 @@ wasm_fill_memory(WASMModuleInstance *inst, uint32 mem_idx, uint32 len,
     mem_inst = inst->memories[mem_idx];
     mem_size = mem_inst->cur_page_count * (uint64)mem_inst->num_bytes_per_page;
 
-    if (mem_size < dst || mem_size - dst < len)
+    if (!is_app_range_valid(inst, mem_idx, mem_size, dst, len))
         goto out_of_bounds;
 
     dst_addr = mem_inst->memory_data + dst;
@@ -9,6 +9,7 @@
 typedef struct AOTCompOption {
     bool is_jit_mode;
     bool is_indirect_mode;
+    bool enable_shared_text;
     char *target_arch;
     char *target_abi;
     char *target_cpu;
@@ -20,6 +21,8 @@ typedef struct AOTCompOption {
     bool enable_simd;
     bool enable_ref_types;
     bool enable_gc;
+    bool enable_exce_handling;
+    bool enable_shared_heap;
     bool enable_aux_stack_check;
     bool enable_aux_stack_frame;
     bool enable_perf_profiling;
@@ -41,6 +44,9 @@ typedef struct AOTCompOption {
     const char *stack_usage_file;
     const char *llvm_passes;
     const char *builtin_intrinsics;
+    const char *cpu_variants;
+    const char *cpu_variant_funcs;
+    const char *jit_cache_dir;
 } AOTCompOption, *aot_comp_option_t;
 
 #endif
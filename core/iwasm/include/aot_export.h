@@ -37,6 +37,26 @@ aot_create_comp_data(void *wasm_module, const char *target_arch,
 void
 aot_destroy_comp_data(aot_comp_data_t comp_data);
 
+/**
+ * Instantiate the wasm module, run the init function and bake the resulting
+ * linear memories, mutable globals and tables into the module, so that the
+ * generated code starts from the initialized state.
+ */
+bool
+aot_pre_initialize_module(void *wasm_module, const char *init_func_name);
+
+/**
+ * Link the wasm modules into one wasm module: the imports whose module name
+ * is the name of another module are resolved to that module's exports, so
+ * the calls between the modules become direct calls. The first module is
+ * the main module whose exports are kept, the modules must share one linear
+ * memory. The linked wasm binary is freed with wasm_runtime_free.
+ */
+bool
+aot_link_wasm_modules(const char **module_names, uint8_t **wasm_bufs,
+                      const uint32_t *wasm_buf_sizes, uint32_t module_count,
+                      uint8_t **p_linked_buf, uint32_t *p_linked_size);
+
 #if WASM_ENABLE_DEBUG_AOT != 0
 typedef void *dwarf_extractor_handle_t;
 dwarf_extractor_handle_t
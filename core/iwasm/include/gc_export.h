@@ -155,6 +155,28 @@ typedef uintptr_t wasm_i31_obj_t;
 
 typedef void (*wasm_obj_finalizer_t)(const wasm_obj_t obj, void *data);
 
+/* Statistics of the GC heap of a module instance */
+typedef struct wasm_gc_heap_stats_t {
+    /* current size of the heap and the free size in it */
+    uint32_t total_size;
+    uint32_t total_free_size;
+    uint32_t highmark_size;
+    /* count and total time in microseconds of the collections, only
+       collected when GC performance profiling is enabled */
+    uint32_t gc_count;
+    uint32_t gc_time;
+    /* the size which the heap can grow to, equal to total_size if the
+       heap can't grow */
+    uint32_t max_size;
+    /* times the heap has grown and shrunk */
+    uint32_t grow_count;
+    uint32_t shrink_count;
+    /* the longest pause in microseconds of the collections, including
+       the steps of the incremental marking, only collected when GC
+       performance profiling is enabled */
+    uint32_t max_gc_time;
+} wasm_gc_heap_stats_t;
+
 /* Defined type related operations */
 
 /**
@@ -756,6 +778,18 @@ wasm_runtime_pin_object(wasm_exec_env_t exec_env, wasm_obj_t obj);
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_unpin_object(wasm_exec_env_t exec_env, wasm_obj_t obj);
 
+/**
+ * Get the statistics of the GC heap of a module instance
+ *
+ * @param module_inst the module instance
+ * @param stats the statistics returned
+ *
+ * @return true if success, false if the module instance has no GC heap
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_gc_heap_stats(wasm_module_inst_t module_inst,
+                               wasm_gc_heap_stats_t *stats);
+
 /**
  * Check whether an object is a struct object
  *
@@ -135,6 +135,14 @@ typedef struct wasm_section_t {
 struct WASMExecEnv;
 typedef struct WASMExecEnv *wasm_exec_env_t;
 
+/* Instance pool */
+struct WASMInstancePool;
+typedef struct WASMInstancePool *wasm_instance_pool_t;
+
+/* Shared heap */
+struct WASMSharedHeap;
+typedef struct WASMSharedHeap *wasm_shared_heap_t;
+
 /* Package Type */
 typedef enum {
     Wasm_Module_Bytecode = 0,
@@ -235,6 +243,14 @@ typedef struct RuntimeInitArgs {
      * - interpreter. TBD
      */
     bool enable_linux_perf;
+    /* Directory of the persistent LLVM JIT object cache, only used when
+       WASM_ENABLE_JIT is defined. If set, the objects compiled by LLVM
+       JIT are saved into it and reloaded when the same module is loaded
+       again with the same JIT options on the same host CPU. */
+    const char *llvm_jit_cache_dir;
+    /* Max size of the GC heap, which grows from gc_heap_size on demand
+       and shrinks after the collections, 0 to keep it at gc_heap_size */
+    uint32_t gc_heap_max_size;
 } RuntimeInitArgs;
 
 #ifndef LOAD_ARGS_OPTION_DEFINED
@@ -248,6 +264,12 @@ typedef struct LoadArgs {
     const strings), making it possible to free the wasm binary buffer after
     loading. */
     bool wasm_binary_freeable;
+    /* False by default, used by AOT loader only.
+    If true, the AOT text is copied, relocated and made executable page by
+    page when it is first touched, instead of all at load time. Requires
+    the hardware bound check and the wasm binary buffer to be kept alive
+    until the module is unloaded, ignored otherwise. */
+    bool aot_lazy_text;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -731,6 +753,139 @@ wasm_runtime_get_running_mode(wasm_module_inst_t module_inst);
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_deinstantiate(wasm_module_inst_t module_inst);
 
+/**
+ * Create a pool of pre-instantiated instances of a WASM module. The
+ * instances released to the pool are reset to the state right after
+ * instantiation, which is much cheaper than deinstantiating them and
+ * instantiating new ones: the dirty pages of the linear memory are
+ * discarded, and the initialized memory pages, globals and tables are
+ * restored from a template captured from the first instance. The
+ * WASI context of a released instance is re-created.
+ *
+ * The instances which can't be reset, e.g. the ones with shared memory,
+ * the ones which import from other wasm modules or when GC is enabled,
+ * are re-instantiated when released. Since all instances are reset to
+ * the same template, the start function of the module should be
+ * deterministic.
+ *
+ * @param module the WASM module to instantiate
+ * @param args the instantiation arguments
+ * @param pool_size the count of the idle instances kept in the pool
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the instance pool created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_instance_pool_t
+wasm_runtime_create_instance_pool(const wasm_module_t module,
+                                  const InstantiationArgs *args,
+                                  uint32_t pool_size, char *error_buf,
+                                  uint32_t error_buf_size);
+
+/**
+ * Destroy an instance pool and deinstantiate its idle instances, the
+ * instances acquired from the pool should be released before.
+ *
+ * @param pool the instance pool to destroy
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_instance_pool(wasm_instance_pool_t pool);
+
+/**
+ * Acquire an instance from the pool, a new instance is instantiated if
+ * the pool is empty. It is thread-safe.
+ *
+ * @param pool the instance pool
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the instance acquired, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_instance_pool_acquire(wasm_instance_pool_t pool, char *error_buf,
+                                   uint32_t error_buf_size);
+
+/**
+ * Release an instance acquired from the pool, the instance is reset and
+ * kept in the pool, or deinstantiated if the pool is full. The instance
+ * mustn't be running and its exec envs created by the user should be
+ * destroyed before. It is thread-safe.
+ *
+ * @param pool the instance pool
+ * @param module_inst the instance to release
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_instance_pool_release(wasm_instance_pool_t pool,
+                                   wasm_module_inst_t module_inst);
+
+/**
+ * Take a snapshot of the state of an instance: the non-zero pages of its
+ * linear memories, the app heap, the globals, the tables and the dropped
+ * segments, which can be restored by wasm_runtime_restore_instance in this
+ * or another process running the same runtime build. The instance mustn't
+ * be running. It fails if GC is enabled, if the instance has shared memory
+ * or sub-modules, or if it has WASI files opened other than the stdio and
+ * the pre-opened directories, since the WASI context is re-created from
+ * the WASI arguments of the module when restoring.
+ *
+ * @param module_inst the instance to take the snapshot of
+ * @param p_buf return the snapshot, which should be freed with
+ *        wasm_runtime_free after use, it can be saved to a file
+ * @param p_size return the size of the snapshot
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_snapshot_instance(const wasm_module_inst_t module_inst,
+                               uint8_t **p_buf, uint32_t *p_size,
+                               char *error_buf, uint32_t error_buf_size);
+
+/**
+ * Instantiate a module and restore the snapshot taken from an instance of
+ * the same module by wasm_runtime_snapshot_instance.
+ *
+ * @param module the module to instantiate
+ * @param args the instantiation arguments, the heap size should be the
+ *        same as the one of the instance the snapshot was taken from
+ * @param buf the snapshot
+ * @param size the size of the snapshot
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the restored instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_restore_instance(const wasm_module_t module,
+                              const InstantiationArgs *args,
+                              const uint8_t *buf, uint32_t size,
+                              char *error_buf, uint32_t error_buf_size);
+
+/**
+ * Create a new instance of the module of an instance with a copy of its
+ * state, the same state as the one saved by wasm_runtime_snapshot_instance.
+ * The state is captured when the instance is cloned the first time and is
+ * shared by all its clones: the linear memory is mapped copy-on-write from
+ * it if the platform supports it, so that cloning costs little more than
+ * the instantiation. The later changes of the cloned instance aren't seen
+ * by the new clones, so it is expected to be a template which isn't run
+ * after it is cloned. It is thread-safe, with the same limitations as
+ * wasm_runtime_snapshot_instance.
+ *
+ * @param module_inst the instance to clone
+ * @param args the instantiation arguments, the heap size should be the
+ *        same as the one of the instance to clone
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the cloned instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_clone_instance(const wasm_module_inst_t module_inst,
+                            const InstantiationArgs *args, char *error_buf,
+                            uint32_t error_buf_size);
+
 /**
  * Get WASM module from WASM module instance
  *
@@ -1910,6 +2065,159 @@ WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_enlarge_memory(wasm_module_inst_t module_inst,
                             uint64_t inc_page_count);
 
+/**
+ * Zero a range of the default memory of a module instance and return its
+ * pages to the system, e.g. the memory freed by the app after a peak
+ * load, so that the resident memory of a long-lived instance follows its
+ * current usage. The partial pages at both ends of the range are cleared
+ * but kept. The app must not expect the previous content of the range.
+ *
+ * @param module_inst the module instance
+ * @param app_offset the app offset of the range
+ * @param size the size of the range
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_discard_memory(wasm_module_inst_t module_inst,
+                            uint64_t app_offset, uint64_t size);
+
+/**
+ * Shrink the default memory of a module instance to page_count pages and
+ * return the trailing pages to the system, they read as zero if the memory
+ * grows again. The app must not use the trailing pages any more, e.g. it
+ * has asked the host to trim its memory. It is only supported when the
+ * hardware bound check is enabled and the memory isn't shared, and the
+ * app heap inserted by the runtime must be below the new size.
+ *
+ * @param module_inst the module instance
+ * @param page_count the new page count of the memory
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_shrink_memory(wasm_module_inst_t module_inst,
+                           uint64_t page_count);
+
+/**
+ * Map a region of a host file, e.g. a memfd holding a received network
+ * frame, into a window of the default linear memory of a module instance,
+ * so that the app reads it without copying. The window replaces the pages
+ * of the linear memory there, it should be reserved by the app, e.g.
+ * allocated from the app heap, until the buffer is unmapped. It is only
+ * supported when the hardware bound check is enabled, and the memory with
+ * a buffer mapped isn't reused by the instance pool or other instances.
+ *
+ * @param module_inst the module instance
+ * @param app_offset the app offset of the window, aligned to the system
+ *        page size
+ * @param size the size of the window, aligned to the system page size
+ * @param fd the raw host handle of the file, the file descriptor on POSIX
+ * @param fd_offset the offset of the region in the file, aligned to the
+ *        system page size
+ * @param share_writes whether the writes of the app go to the file,
+ *        otherwise they are private to the instance
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_map_host_buffer(wasm_module_inst_t module_inst,
+                             uint64_t app_offset, uint64_t size, int64_t fd,
+                             uint64_t fd_offset, bool share_writes);
+
+/**
+ * Unmap the host buffer mapped by wasm_runtime_map_host_buffer, the window
+ * reads as zero afterwards.
+ *
+ * @param module_inst the module instance
+ * @param app_offset the app offset of the window
+ * @param size the size of the window
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_unmap_host_buffer(wasm_module_inst_t module_inst,
+                               uint64_t app_offset, uint64_t size);
+
+/**
+ * Create a shared heap, a host allocated region which is mapped to the
+ * same app offsets at the top of the 4 GB address space of the default
+ * memory of every instance attached to it, so that the host and the
+ * instances exchange data in it without copying. It requires the
+ * hardware bound check and WAMR_BUILD_SHARED_HEAP=1.
+ *
+ * @param size the size of the heap, aligned up to the system page size
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the shared heap created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_shared_heap_t
+wasm_runtime_create_shared_heap(uint64_t size, char *error_buf,
+                                uint32_t error_buf_size);
+
+/**
+ * Destroy the shared heap, the instances attached to it must be detached
+ * or destroyed before.
+ *
+ * @param heap the shared heap to destroy
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_shared_heap(wasm_shared_heap_t heap);
+
+/**
+ * Allocate memory from the shared heap.
+ *
+ * @param heap the shared heap
+ * @param size the size of memory to allocate
+ * @param p_native_addr return the native address of the memory if it is
+ *        not NULL
+ *
+ * @return the app offset of the memory, which is valid in all the
+ *         instances attached, or 0 if failed
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_shared_heap_malloc(wasm_shared_heap_t heap, uint64_t size,
+                                void **p_native_addr);
+
+/**
+ * Free the memory allocated from the shared heap.
+ *
+ * @param heap the shared heap
+ * @param app_offset the app offset returned by
+ *        wasm_runtime_shared_heap_malloc
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_shared_heap_free(wasm_shared_heap_t heap, uint64_t app_offset);
+
+/**
+ * Attach the shared heap to a module instance. The default memory of the
+ * instance must be a non-shared 32-bit memory below the heap, and it
+ * can't grow into the heap afterwards. The plain loads and stores in the
+ * heap pass the hardware bound check, the AOT file must be generated with
+ * `wamrc --enable-shared-heap` to access it with the bulk memory
+ * operations or the explicit bounds checks.
+ *
+ * @param module_inst the module instance
+ * @param heap the shared heap
+ * @param read_only whether the instance can only read the heap
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_attach_shared_heap(wasm_module_inst_t module_inst,
+                                wasm_shared_heap_t heap, bool read_only);
+
+/**
+ * Detach the shared heap from a module instance, the range of the heap
+ * is inaccessible to the instance afterwards. It is called automatically
+ * when the instance is deinstantiated.
+ *
+ * @param module_inst the module instance
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_detach_shared_heap(wasm_module_inst_t module_inst);
+
 typedef enum {
     INTERNAL_ERROR,
     MAX_SIZE_REACHED,
@@ -94,6 +94,10 @@ extern "C" {
 #define SHARED_MEMORY_FLAG 0x02
 #define MEMORY64_FLAG 0x04
 
+/* The flag in the align of memarg, the memory index follows the align if
+   it is set, otherwise the instruction accesses the default memory */
+#define OPT_MEMIDX_FLAG 0x40
+
 #define DEFAULT_NUM_BYTES_PER_PAGE 65536
 #define DEFAULT_MAX_PAGES 65536
 #define DEFAULT_MEM64_MAX_PAGES UINT32_MAX
@@ -103,6 +107,12 @@ extern "C" {
 /* Roughly 274 TB */
 #define MAX_LINEAR_MEM64_MEMORY_SIZE \
     (DEFAULT_MEM64_MAX_PAGES * (uint64)64 * (uint64)BH_KB)
+/* Max size of memory64 linear memory with the hardware bound check, it is
+   reserved 8GB of address space as the 32-bit one and the last page is
+   kept as the guard: the out of bounds addresses are clamped to it so
+   that the accesses trap instead of being checked explicitly */
+#define MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE \
+    (8 * (uint64)BH_GB - 64 * (uint64)BH_KB)
 /* Macro to check memory flag and return appropriate memory size */
 #define GET_MAX_LINEAR_MEMORY_SIZE(is_memory64) \
     (is_memory64 ? MAX_LINEAR_MEM64_MEMORY_SIZE : MAX_LINEAR_MEMORY_SIZE)
@@ -348,6 +358,10 @@ typedef struct WASMType {
     /* The parent type */
     struct WASMType *parent_type;
     uint32 parent_type_idx;
+    /* The super type display, super_types[i] is the super type whose
+       inherit depth is i, or the type itself if i is inherit_depth, it
+       records MIN(inherit_depth + 1, GC_TYPE_SUPER_DISPLAY_SIZE) types */
+    struct WASMType **super_types;
 
     /* The number of internal types in the current rec group, and if
        the type is not in a recursive group, rec_count is 1 since a
@@ -753,6 +767,23 @@ typedef struct WASMDataSeg {
     bool is_data_cloned;
 } WASMDataSeg;
 
+/* The initial content of the linear memory may be mapped copy-on-write
+   from an in-memory file into the memory reserved for the hardware bound
+   check, instead of copying the data segments on each instantiation */
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define WASM_MEM_DATA_IMAGE_SUPPORTED 1
+#else
+#define WASM_MEM_DATA_IMAGE_SUPPORTED 0
+#endif
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+typedef struct WASMDataImage {
+    os_file_handle file;
+    /* Size of the image, aligned to the system page size */
+    uint64 size;
+} WASMDataImage;
+#endif
+
 typedef struct BlockAddr {
     const uint8 *start_addr;
     uint8 *else_addr;
@@ -892,6 +923,11 @@ struct WASMModule {
     WASMExport *exports;
     WASMTableSeg *table_segments;
     WASMDataSeg **data_segments;
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* The image of the active data segments of the first memory,
+       NULL if it isn't created */
+    WASMDataImage *data_image;
+#endif
     uint32 start_function;
 
     /* total global variable size */
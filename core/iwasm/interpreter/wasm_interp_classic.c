@@ -46,6 +46,63 @@ typedef float64 CellType_F64;
 #define get_linear_mem_size() GET_LINEAR_MEMORY_SIZE(memory)
 #endif
 
+/* The size of the current memory is cached in the local variable
+   linear_mem_size for the explicit bound checks if multi-threading is
+   disabled, otherwise it is loaded in each check */
+#if WASM_ENABLE_THREAD_MGR == 0                          \
+    && (!defined(OS_ENABLE_HW_BOUND_CHECK)              \
+        || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+        || WASM_ENABLE_BULK_MEMORY != 0)
+#define CACHE_LINEAR_MEM_SIZE 1
+#else
+#define CACHE_LINEAR_MEM_SIZE 0
+#endif
+
+#if WASM_ENABLE_SHARED_HEAP != 0 && WASM_ENABLE_MULTI_MEMORY != 0
+/* The shared heap is mapped above the default memory only */
+#define is_app_addr_in_shared_heap(start, bytes) \
+    (memory == module->memories[0]               \
+     && wasm_runtime_is_app_addr_in_shared_heap( \
+         (WASMModuleInstanceCommon *)module, start, bytes))
+#elif WASM_ENABLE_SHARED_HEAP != 0
+/* The shared heap is mapped above the linear memory, the accesses to it
+   pass the hardware bound check but fail the explicit ones */
+#define is_app_addr_in_shared_heap(start, bytes) \
+    wasm_runtime_is_app_addr_in_shared_heap(     \
+        (WASMModuleInstanceCommon *)module, start, bytes)
+#else
+#define is_app_addr_in_shared_heap(start, bytes) false
+#endif
+
+#if WASM_ENABLE_MULTI_MEMORY != 0
+/* Switch the cached memory instance and its size to the memory of
+   index memidx, it is a no-op when the memory is cached already */
+#if CACHE_LINEAR_MEM_SIZE != 0
+#define SWITCH_MEMORY(memidx)                                 \
+    do {                                                      \
+        if (memory != module->memories[memidx]) {             \
+            memory = module->memories[memidx];                \
+            linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory); \
+        }                                                     \
+    } while (0)
+#else
+#define SWITCH_MEMORY(memidx) memory = module->memories[memidx]
+#endif
+
+/* Read the align of memarg, and the memory index following it if the
+   flag is set in the align, and switch to the memory */
+#define read_leb_memarg(p, p_end, res)          \
+    do {                                        \
+        uint32 _memidx = 0;                     \
+        read_leb_uint32(p, p_end, res);         \
+        if (res & OPT_MEMIDX_FLAG)              \
+            read_leb_uint32(p, p_end, _memidx); \
+        SWITCH_MEMORY(_memidx);                 \
+    } while (0)
+#else
+#define read_leb_memarg(p, p_end, res) read_leb_uint32(p, p_end, res)
+#endif
+
 #if WASM_ENABLE_MEMORY64 == 0
 
 #if (!defined(OS_ENABLE_HW_BOUND_CHECK) \
@@ -53,7 +110,8 @@ typedef float64 CellType_F64;
 #define CHECK_MEMORY_OVERFLOW(bytes)                                           \
     do {                                                                       \
         uint64 offset1 = (uint64)offset + (uint64)addr;                        \
-        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()) \
+        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()  \
+            || is_app_addr_in_shared_heap(offset1, bytes))                     \
             /* If offset1 is in valid range, maddr must also                   \
                be in valid range, no need to check it again. */                \
             maddr = memory->memory_data + offset1;                             \
@@ -64,7 +122,8 @@ typedef float64 CellType_F64;
 #define CHECK_BULK_MEMORY_OVERFLOW(start, bytes, maddr)                        \
     do {                                                                       \
         uint64 offset1 = (uint32)(start);                                      \
-        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()) \
+        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()  \
+            || is_app_addr_in_shared_heap(offset1, bytes))                     \
             /* App heap space is not valid space for                           \
              bulk memory operation */                                          \
             maddr = memory->memory_data + offset1;                             \
@@ -88,6 +147,8 @@ typedef float64 CellType_F64;
 
 #else /* else of WASM_ENABLE_MEMORY64 == 0 */
 
+#if (!defined(OS_ENABLE_HW_BOUND_CHECK) \
+     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0)
 #define CHECK_MEMORY_OVERFLOW(bytes)                                        \
     do {                                                                    \
         uint64 offset1 = (uint64)offset + (uint64)addr;                     \
@@ -99,6 +160,22 @@ typedef float64 CellType_F64;
         else                                                                \
             goto out_of_bounds;                                             \
     } while (0)
+#else
+/* The address beyond the largest memory64 memory, including the overflowed
+   one, is clamped to the guard page at the end of the reserved space, so
+   the out of bounds access traps, see MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE.
+   The compiler generates a conditional move instead of a branch for it */
+#define CHECK_MEMORY_OVERFLOW(bytes)                           \
+    do {                                                       \
+        uint64 offset1 = (uint64)offset + (uint64)addr;        \
+        if (offset1 < offset                                   \
+            || offset1 > MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE) \
+            offset1 = MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE;    \
+        maddr = memory->memory_data + offset1;                 \
+    } while (0)
+#endif /* end of !defined(OS_ENABLE_HW_BOUND_CHECK) || \
+          WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 */
+
 #define CHECK_BULK_MEMORY_OVERFLOW(start, bytes, maddr)            \
     do {                                                           \
         uint64 offset1 = (uint64)(start);                          \
@@ -1463,16 +1540,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                WASMInterpFrame *prev_frame)
 {
     WASMMemoryInstance *memory = wasm_get_default_memory(module);
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
     uint64 linear_mem_size = 0;
     if (memory)
-#if WASM_ENABLE_THREAD_MGR == 0
         linear_mem_size = memory->memory_data_size;
-#else
-        linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
-#endif
 #endif
     WASMFuncType **wasm_types = (WASMFuncType **)module->module->types;
     WASMGlobalInstance *globals = module->e->globals, *global;
@@ -1503,8 +1574,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
     int32_t exception_tag_index;
 #endif
     uint8 value_type;
-#if !defined(OS_ENABLE_HW_BOUND_CHECK) \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_MEMORY64 != 0
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = !wasm_runtime_is_bounds_checks_enabled(
         (WASMModuleInstanceCommon *)module);
@@ -1601,10 +1673,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     wasm_types[tag_type_index]->param_cell_num;
 
                 /* move exception parameters (if there are any) onto top
-                 * of stack */
+                 * of stack, they follow the tag index */
                 if (cell_num_to_copy > 0) {
-                    word_copy(frame_sp, tgtframe_sp - cell_num_to_copy,
-                              cell_num_to_copy);
+                    word_copy(frame_sp, tgtframe_sp, cell_num_to_copy);
                 }
 
                 frame_sp += cell_num_to_copy;
@@ -1702,19 +1773,21 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                              * exception values for rethrow */
                                             PUSH_I32(exception_tag_index);
                                             if (cell_num_to_copy > 0) {
-                                                word_copy(
+                                                /* the values may overlap
+                                                 * the destination */
+                                                bh_memmove_s(
                                                     frame_sp,
+                                                    cell_num_to_copy * 4,
                                                     frame_sp_old
                                                         - cell_num_to_copy,
-                                                    cell_num_to_copy);
+                                                    cell_num_to_copy * 4);
                                                 frame_sp += cell_num_to_copy;
                                                 /* push exception values for
                                                  * catch
                                                  */
                                                 word_copy(
                                                     frame_sp,
-                                                    frame_sp_old
-                                                        - cell_num_to_copy,
+                                                    frame_sp - cell_num_to_copy,
                                                     cell_num_to_copy);
                                                 frame_sp += cell_num_to_copy;
                                             }
@@ -1774,10 +1847,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                          * exception values for rethrow */
                                         PUSH_I32(exception_tag_index);
                                         if (cell_num_to_copy > 0) {
-                                            word_copy(frame_sp,
-                                                      frame_sp_old
-                                                          - cell_num_to_copy,
-                                                      cell_num_to_copy);
+                                            /* the values may overlap the
+                                             * destination */
+                                            bh_memmove_s(
+                                                frame_sp, cell_num_to_copy * 4,
+                                                frame_sp_old - cell_num_to_copy,
+                                                cell_num_to_copy * 4);
                                             frame_sp += cell_num_to_copy;
                                         }
                                         /* catch_all has no exception values */
@@ -4252,7 +4327,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(4);
@@ -4268,7 +4343,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(8);
@@ -4283,7 +4358,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(1);
@@ -4298,7 +4373,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(1);
@@ -4313,7 +4388,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(2);
@@ -4328,7 +4403,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(2);
@@ -4343,7 +4418,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(1);
@@ -4358,7 +4433,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(1);
@@ -4373,7 +4448,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(2);
@@ -4388,7 +4463,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(2);
@@ -4404,7 +4479,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 mem_offset_t offset, addr;
 
                 opcode = *(frame_ip - 1);
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(4);
@@ -4419,7 +4494,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 addr = POP_MEM_OFFSET();
                 CHECK_MEMORY_OVERFLOW(4);
@@ -4436,7 +4511,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 frame_sp--;
                 addr = POP_MEM_OFFSET();
@@ -4461,7 +4536,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 flags;
                 mem_offset_t offset, addr;
 
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 frame_sp -= 2;
                 addr = POP_MEM_OFFSET();
@@ -4491,7 +4566,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint32 sval;
 
                 opcode = *(frame_ip - 1);
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 sval = (uint32)POP_I32();
                 addr = POP_MEM_OFFSET();
@@ -4518,7 +4593,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 uint64 sval;
 
                 opcode = *(frame_ip - 1);
-                read_leb_uint32(frame_ip, frame_ip_end, flags);
+                read_leb_memarg(frame_ip, frame_ip_end, flags);
                 read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 sval = (uint64)POP_I64();
                 addr = POP_MEM_OFFSET();
@@ -4545,6 +4620,9 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 reserved;
                 read_leb_uint32(frame_ip, frame_ip_end, reserved);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                SWITCH_MEMORY(reserved);
+#endif
                 PUSH_PAGE_COUNT(memory->cur_page_count);
                 (void)reserved;
                 HANDLE_OP_END();
@@ -4552,13 +4630,20 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             HANDLE_OP(WASM_OP_MEMORY_GROW)
             {
-                uint32 reserved, delta,
-                    prev_page_count = memory->cur_page_count;
+                uint32 reserved, delta, prev_page_count;
 
                 read_leb_uint32(frame_ip, frame_ip_end, reserved);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                SWITCH_MEMORY(reserved);
+#endif
+                prev_page_count = memory->cur_page_count;
                 delta = (uint32)POP_PAGE_COUNT();
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                if (!wasm_enlarge_memory_with_idx(module, delta, reserved)) {
+#else
                 if (!wasm_enlarge_memory(module, delta)) {
+#endif
                     /* failed to memory.grow, return -1 */
                     PUSH_PAGE_COUNT(-1);
                 }
@@ -4567,9 +4652,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     PUSH_PAGE_COUNT(prev_page_count);
                     /* update memory size, no need to update memory ptr as
                        it isn't changed in wasm_enlarge_memory */
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
                     linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
 #endif
                 }
@@ -5568,23 +5651,31 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         mem_offset_t addr;
                         uint64 bytes, offset, seg_len;
                         uint8 *data;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 memidx;
+#endif
 
                         read_leb_uint32(frame_ip, frame_ip_end, segment);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        read_leb_uint32(frame_ip, frame_ip_end, memidx);
+                        SWITCH_MEMORY(memidx);
+#else
                         /* skip memory index */
                         frame_ip++;
+#endif
 
                         bytes = (uint64)(uint32)POP_I32();
                         offset = (uint64)(uint32)POP_I32();
                         addr = (mem_offset_t)POP_MEM_OFFSET();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+                        /* The bulk memory operations of memory64 are
+                           checked explicitly as the range may exceed the
+                           reserved space */
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(addr, bytes, maddr);
 #else
-                        if ((uint64)(uint32)addr + bytes > linear_mem_size)
+                        if ((uint64)(uint32)addr + bytes > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)addr, bytes))
                             goto out_of_bounds;
                         maddr = memory->memory_data + (uint32)addr;
 #endif
@@ -5603,8 +5694,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         if (offset + bytes > seg_len)
                             goto out_of_bounds;
 
-                        bh_memcpy_s(maddr, (uint32)(linear_mem_size - addr),
-                                    data + offset, (uint32)bytes);
+                        /* The range is checked above, it may be in the
+                           shared heap above the linear memory */
+                        bh_memcpy_s(maddr, (uint32)bytes, data + offset,
+                                    (uint32)bytes);
                         break;
                     }
                     case WASM_OP_DATA_DROP:
@@ -5620,33 +5713,43 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     {
                         mem_offset_t dst, src, len;
                         uint8 *mdst, *msrc;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 dst_memidx, src_memidx;
 
+                        read_leb_uint32(frame_ip, frame_ip_end, dst_memidx);
+                        read_leb_uint32(frame_ip, frame_ip_end, src_memidx);
+                        SWITCH_MEMORY(src_memidx);
+#else
                         frame_ip += 2;
+#endif
                         len = POP_MEM_OFFSET();
                         src = POP_MEM_OFFSET();
                         dst = POP_MEM_OFFSET();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(src, len, msrc);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        SWITCH_MEMORY(dst_memidx);
+#endif
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else
-                        if ((uint64)(uint32)src + len > linear_mem_size)
+                        if ((uint64)(uint32)src + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)src, len))
                             goto out_of_bounds;
                         msrc = memory->memory_data + (uint32)src;
 
-                        if ((uint64)(uint32)dst + len > linear_mem_size)
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        SWITCH_MEMORY(dst_memidx);
+#endif
+                        if ((uint64)(uint32)dst + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)dst, len))
                             goto out_of_bounds;
                         mdst = memory->memory_data + (uint32)dst;
 #endif
 
                         /* allowing the destination and source to overlap */
 #if WASM_ENABLE_MEMORY64 == 0
-                        bh_memmove_s(mdst, (uint32)(linear_mem_size - dst),
-                                     msrc, (uint32)len);
+                        bh_memmove_s(mdst, (uint32)len, msrc, (uint32)len);
 #else
                         /* use memmove when memory64 is enabled since len
                            may be larger than UINT32_MAX */
@@ -5658,20 +5761,24 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     {
                         mem_offset_t dst, len;
                         uint8 fill_val, *mdst;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 memidx;
+
+                        read_leb_uint32(frame_ip, frame_ip_end, memidx);
+                        SWITCH_MEMORY(memidx);
+#else
                         frame_ip++;
+#endif
 
                         len = POP_MEM_OFFSET();
                         fill_val = POP_I32();
                         dst = POP_MEM_OFFSET();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
-#ifndef OS_ENABLE_HW_BOUND_CHECK
+#if !defined(OS_ENABLE_HW_BOUND_CHECK) || WASM_ENABLE_MEMORY64 != 0
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else
-                        if ((uint64)(uint32)dst + len > linear_mem_size)
+                        if ((uint64)(uint32)dst + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)dst, len))
                             goto out_of_bounds;
                         mdst = memory->memory_data + (uint32)dst;
 #endif
@@ -5902,7 +6009,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 opcode = (uint8)opcode1;
 
                 if (opcode != WASM_OP_ATOMIC_FENCE) {
-                    read_leb_uint32(frame_ip, frame_ip_end, align);
+                    read_leb_memarg(frame_ip, frame_ip_end, align);
                     read_leb_mem_offset(frame_ip, frame_ip_end, offset);
                 }
 
@@ -6456,9 +6563,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             /* update memory size, no need to update memory ptr as
                it isn't changed in wasm_enlarge_memory */
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
             if (memory)
                 linear_mem_size = get_linear_mem_size();
 #endif
@@ -7291,6 +7396,11 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
         if (wasm_interp_create_call_stack(exec_env)) {
             wasm_interp_dump_call_stack(exec_env, true, NULL, 0);
         }
+#endif
+#if WASM_ENABLE_EXCE_HANDLING != 0 && WASM_ENABLE_JIT != 0
+        /* the wasm exception uncaught by the LLVM JITed code is returned
+           to the host as a trap */
+        wasm_runtime_clear_wasm_exception(exec_env);
 #endif
     }
 
@@ -37,12 +37,69 @@ typedef float64 CellType_F64;
 #define get_linear_mem_size() GET_LINEAR_MEMORY_SIZE(memory)
 #endif
 
+/* The size of the current memory is cached in the local variable
+   linear_mem_size for the explicit bound checks if multi-threading is
+   disabled, otherwise it is loaded in each check */
+#if WASM_ENABLE_THREAD_MGR == 0                          \
+    && (!defined(OS_ENABLE_HW_BOUND_CHECK)              \
+        || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+        || WASM_ENABLE_BULK_MEMORY != 0)
+#define CACHE_LINEAR_MEM_SIZE 1
+#else
+#define CACHE_LINEAR_MEM_SIZE 0
+#endif
+
+#if WASM_ENABLE_SHARED_HEAP != 0 && WASM_ENABLE_MULTI_MEMORY != 0
+/* The shared heap is mapped above the default memory only */
+#define is_app_addr_in_shared_heap(start, bytes) \
+    (memory == module->memories[0]               \
+     && wasm_runtime_is_app_addr_in_shared_heap( \
+         (WASMModuleInstanceCommon *)module, start, bytes))
+#elif WASM_ENABLE_SHARED_HEAP != 0
+/* The shared heap is mapped above the linear memory, the accesses to it
+   pass the hardware bound check but fail the explicit ones */
+#define is_app_addr_in_shared_heap(start, bytes) \
+    wasm_runtime_is_app_addr_in_shared_heap(     \
+        (WASMModuleInstanceCommon *)module, start, bytes)
+#else
+#define is_app_addr_in_shared_heap(start, bytes) false
+#endif
+
+#if WASM_ENABLE_MULTI_MEMORY != 0
+/* Switch the cached memory instance and its size to the memory of
+   index memidx, it is a no-op when the memory is cached already */
+#if CACHE_LINEAR_MEM_SIZE != 0
+#define SWITCH_MEMORY(memidx)                                 \
+    do {                                                      \
+        if (memory != module->memories[memidx]) {             \
+            memory = module->memories[memidx];                \
+            linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory); \
+        }                                                     \
+    } while (0)
+#else
+#define SWITCH_MEMORY(memidx) memory = module->memories[memidx]
+#endif
+
+/* Read the offset of memarg and the memory index emitted after it by
+   the loader, and switch to the memory */
+#define read_memarg(p, offset)    \
+    do {                          \
+        uint32 _memidx;           \
+        offset = read_uint32(p);  \
+        _memidx = read_uint32(p); \
+        SWITCH_MEMORY(_memidx);   \
+    } while (0)
+#else
+#define read_memarg(p, offset) offset = read_uint32(p)
+#endif
+
 #if !defined(OS_ENABLE_HW_BOUND_CHECK) \
     || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0
 #define CHECK_MEMORY_OVERFLOW(bytes)                                           \
     do {                                                                       \
         uint64 offset1 = (uint64)offset + (uint64)addr;                        \
-        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()) \
+        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()  \
+            || is_app_addr_in_shared_heap(offset1, bytes))                     \
             /* If offset1 is in valid range, maddr must also                   \
                 be in valid range, no need to check it again. */               \
             maddr = memory->memory_data + offset1;                             \
@@ -53,7 +110,8 @@ typedef float64 CellType_F64;
 #define CHECK_BULK_MEMORY_OVERFLOW(start, bytes, maddr)                        \
     do {                                                                       \
         uint64 offset1 = (uint32)(start);                                      \
-        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()) \
+        if (disable_bounds_checks || offset1 + bytes <= get_linear_mem_size()  \
+            || is_app_addr_in_shared_heap(offset1, bytes))                     \
             /* App heap space is not valid space for                           \
                bulk memory operation */                                        \
             maddr = memory->memory_data + offset1;                             \
@@ -1449,16 +1507,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                WASMInterpFrame *prev_frame)
 {
     WASMMemoryInstance *memory = wasm_get_default_memory(module);
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
     uint64 linear_mem_size = 0;
     if (memory)
-#if WASM_ENABLE_THREAD_MGR == 0
         linear_mem_size = memory->memory_data_size;
-#else
-        linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
-#endif
 #endif
     WASMGlobalInstance *globals = module->e ? module->e->globals : NULL;
     WASMGlobalInstance *global;
@@ -3583,7 +3635,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I32_LOAD)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3595,7 +3647,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3607,7 +3659,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I32_LOAD8_S)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3619,7 +3671,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I32_LOAD8_U)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3631,7 +3683,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I32_LOAD16_S)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3643,7 +3695,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I32_LOAD16_U)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3655,7 +3707,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD8_S)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3668,7 +3720,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD8_U)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3680,7 +3732,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD16_S)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3693,7 +3745,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD16_U)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3705,7 +3757,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD32_S)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3718,7 +3770,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_I64_LOAD32_U)
             {
                 uint32 offset, addr;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 addr = GET_OPERAND(uint32, I32, 0);
                 frame_ip += 2;
                 addr_ret = GET_OFFSET();
@@ -3731,7 +3783,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint32 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint32, I32, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3744,7 +3796,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint32 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint32, I32, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3757,7 +3809,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint32 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint32, I32, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3770,7 +3822,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint64 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint64, I64, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3783,7 +3835,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint64 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint64, I64, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3796,7 +3848,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint64 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint64, I64, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3809,7 +3861,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 offset, addr;
                 uint64 sval;
-                offset = read_uint32(frame_ip);
+                read_memarg(frame_ip, offset);
                 sval = GET_OPERAND(uint64, I64, 0);
                 addr = GET_OPERAND(uint32, I32, 2);
                 frame_ip += 4;
@@ -3822,6 +3874,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             HANDLE_OP(WASM_OP_MEMORY_SIZE)
             {
                 uint32 reserved;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                reserved = read_uint32(frame_ip);
+                SWITCH_MEMORY(reserved);
+#endif
                 addr_ret = GET_OFFSET();
                 frame_lp[addr_ret] = memory->cur_page_count;
                 (void)reserved;
@@ -3830,14 +3886,22 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             HANDLE_OP(WASM_OP_MEMORY_GROW)
             {
-                uint32 reserved, delta,
-                    prev_page_count = memory->cur_page_count;
+                uint32 reserved, delta, prev_page_count;
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                reserved = read_uint32(frame_ip);
+                SWITCH_MEMORY(reserved);
+#endif
+                prev_page_count = memory->cur_page_count;
                 addr1 = GET_OFFSET();
                 addr_ret = GET_OFFSET();
                 delta = (uint32)frame_lp[addr1];
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                if (!wasm_enlarge_memory_with_idx(module, delta, reserved)) {
+#else
                 if (!wasm_enlarge_memory(module, delta)) {
+#endif
                     /* failed to memory.grow, return -1 */
                     frame_lp[addr_ret] = -1;
                 }
@@ -3846,9 +3910,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     frame_lp[addr_ret] = prev_page_count;
                     /* update memory size, no need to update memory ptr as
                        it isn't changed in wasm_enlarge_memory */
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
                     linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
 #endif
                 }
@@ -4970,21 +5032,25 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         uint32 addr, segment;
                         uint64 bytes, offset, seg_len;
                         uint8 *data;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 memidx;
+#endif
 
                         segment = read_uint32(frame_ip);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        memidx = read_uint32(frame_ip);
+                        SWITCH_MEMORY(memidx);
+#endif
 
                         bytes = (uint64)(uint32)POP_I32();
                         offset = (uint64)(uint32)POP_I32();
                         addr = POP_I32();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
 #ifndef OS_ENABLE_HW_BOUND_CHECK
                         CHECK_BULK_MEMORY_OVERFLOW(addr, bytes, maddr);
 #else
-                        if ((uint64)(uint32)addr + bytes > linear_mem_size)
+                        if ((uint64)(uint32)addr + bytes > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)addr, bytes))
                             goto out_of_bounds;
                         maddr = memory->memory_data + (uint32)addr;
 #endif
@@ -5002,8 +5068,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         if (offset + bytes > seg_len)
                             goto out_of_bounds;
 
-                        bh_memcpy_s(maddr, (uint32)(linear_mem_size - addr),
-                                    data + offset, (uint32)bytes);
+                        /* The range is checked above, it may be in the
+                           shared heap above the linear memory */
+                        bh_memcpy_s(maddr, (uint32)bytes, data + offset,
+                                    (uint32)bytes);
                         break;
                     }
                     case WASM_OP_DATA_DROP:
@@ -5019,50 +5087,63 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     {
                         uint32 dst, src, len;
                         uint8 *mdst, *msrc;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 dst_memidx, src_memidx;
+
+                        dst_memidx = read_uint32(frame_ip);
+                        src_memidx = read_uint32(frame_ip);
+                        SWITCH_MEMORY(src_memidx);
+#endif
 
                         len = POP_I32();
                         src = POP_I32();
                         dst = POP_I32();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
 #ifndef OS_ENABLE_HW_BOUND_CHECK
                         CHECK_BULK_MEMORY_OVERFLOW(src, len, msrc);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        SWITCH_MEMORY(dst_memidx);
+#endif
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else
-                        if ((uint64)(uint32)src + len > linear_mem_size)
+                        if ((uint64)(uint32)src + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)src, len))
                             goto out_of_bounds;
                         msrc = memory->memory_data + (uint32)src;
 
-                        if ((uint64)(uint32)dst + len > linear_mem_size)
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        SWITCH_MEMORY(dst_memidx);
+#endif
+                        if ((uint64)(uint32)dst + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)dst, len))
                             goto out_of_bounds;
                         mdst = memory->memory_data + (uint32)dst;
 #endif
 
                         /* allowing the destination and source to overlap */
-                        bh_memmove_s(mdst, (uint32)(linear_mem_size - dst),
-                                     msrc, len);
+                        bh_memmove_s(mdst, len, msrc, len);
                         break;
                     }
                     case WASM_OP_MEMORY_FILL:
                     {
                         uint32 dst, len;
                         uint8 fill_val, *mdst;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        uint32 memidx;
+
+                        memidx = read_uint32(frame_ip);
+                        SWITCH_MEMORY(memidx);
+#endif
 
                         len = POP_I32();
                         fill_val = POP_I32();
                         dst = POP_I32();
 
-#if WASM_ENABLE_THREAD_MGR != 0
-                        linear_mem_size = get_linear_mem_size();
-#endif
-
 #ifndef OS_ENABLE_HW_BOUND_CHECK
                         CHECK_BULK_MEMORY_OVERFLOW(dst, len, mdst);
 #else
-                        if ((uint64)(uint32)dst + len > linear_mem_size)
+                        if ((uint64)(uint32)dst + len > get_linear_mem_size()
+                            && !is_app_addr_in_shared_heap((uint32)dst, len))
                             goto out_of_bounds;
                         mdst = memory->memory_data + (uint32)dst;
 #endif
@@ -5290,7 +5371,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 GET_OPCODE();
 
                 if (opcode != WASM_OP_ATOMIC_FENCE) {
-                    offset = read_uint32(frame_ip);
+                    read_memarg(frame_ip, offset);
                 }
 
                 switch (opcode) {
@@ -5897,9 +5978,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             /* update memory size, no need to update memory ptr as
                it isn't changed in wasm_enlarge_memory */
-#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
-    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
-    || WASM_ENABLE_BULK_MEMORY != 0
+#if CACHE_LINEAR_MEM_SIZE != 0
             if (memory)
                 linear_mem_size = get_linear_mem_size();
 #endif
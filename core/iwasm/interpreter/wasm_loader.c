@@ -86,6 +86,32 @@ set_error_buf_v(char *error_buf, uint32 error_buf_size, const char *format, ...)
     }
 }
 
+#if WASM_ENABLE_MULTI_MEMORY != 0 && WASM_ENABLE_MEMORY64 != 0
+/* The interpreters and the AOT compiler take the index type of the
+   default memory for all memories */
+static bool
+check_memory_index_types(WASMModule *module, char *error_buf,
+                         uint32 error_buf_size)
+{
+    bool is_memory64 = has_module_memory64(module);
+    uint32 i, flags;
+
+    for (i = 0; i < module->import_memory_count + module->memory_count; i++) {
+        if (i < module->import_memory_count)
+            flags = module->import_memories[i].u.memory.mem_type.flags;
+        else
+            flags = module->memories[i - module->import_memory_count].flags;
+        if (!!(flags & MEMORY64_FLAG) != is_memory64) {
+            set_error_buf(error_buf, error_buf_size,
+                          "memories with different index types "
+                          "are not supported");
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 static bool
 check_buf(const uint8 *buf, const uint8 *buf_end, uint32 length,
           char *error_buf, uint32 error_buf_size)
@@ -130,6 +156,19 @@ check_buf1(const uint8 *buf, const uint8 *buf_end, uint32 length,
 #define skip_leb_uint32(p, p_end) skip_leb(p)
 #define skip_leb_int32(p, p_end) skip_leb(p)
 #define skip_leb_mem_offset(p, p_end) skip_leb(p)
+#if WASM_ENABLE_MULTI_MEMORY != 0
+/* Skip the align of memarg, and the memory index following it if the
+   flag is set in the align */
+#define skip_leb_memarg(p, p_end)     \
+    do {                              \
+        uint8 _align = *p;            \
+        skip_leb(p);                  \
+        if (_align & OPT_MEMIDX_FLAG) \
+            skip_leb(p);              \
+    } while (0)
+#else
+#define skip_leb_memarg(p, p_end) skip_leb(p)
+#endif
 
 static bool
 read_leb(uint8 **p_buf, const uint8 *buf_end, uint32 maxbits, bool sign,
@@ -1351,6 +1390,9 @@ destroy_wasm_type(WASMType *type)
         return;
     }
 
+    if (type->super_types)
+        wasm_runtime_free(type->super_types);
+
     if (type->type_flag == WASM_TYPE_FUNC)
         destroy_func_type((WASMFuncType *)type);
     else if (type->type_flag == WASM_TYPE_STRUCT)
@@ -2145,6 +2187,12 @@ load_type_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
                     cur_type->root_type = cur_type;
                     cur_type->inherit_depth = 0;
                 }
+
+                if (!wasm_type_create_super_types(cur_type)) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "allocate memory failed");
+                    return false;
+                }
             }
 
             for (j = 0; j < rec_count; j++) {
@@ -2508,7 +2556,8 @@ wasm_loader_resolve_tag(const char *module_name, const char *tag_name,
     }
 
     /* check function type */
-    if (!wasm_type_equal(expected_tag_type, tag->tag_type)) {
+    if (!wasm_type_equal(expected_tag_type, (WASMType *)tag->tag_type,
+                         module->types, module->type_count)) {
         LOG_DEBUG("%s.%s failed the type check", module_name, tag_name);
         set_error_buf(error_buf, error_buf_size, "incompatible import type");
         return NULL;
@@ -3367,11 +3416,13 @@ load_import_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
                     if (flags & 1)
                         read_leb_uint32(p, p_end, u32);
                     module->import_memory_count++;
+#if WASM_ENABLE_MULTI_MEMORY == 0
                     if (module->import_memory_count > 1) {
                         set_error_buf(error_buf, error_buf_size,
                                       "multiple memories");
                         return false;
                     }
+#endif
                     break;
 
 #if WASM_ENABLE_TAGS != 0
@@ -3552,6 +3603,11 @@ load_import_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
         return false;
     }
 
+#if WASM_ENABLE_MULTI_MEMORY != 0 && WASM_ENABLE_MEMORY64 != 0
+    if (!check_memory_index_types(module, error_buf, error_buf_size))
+        return false;
+#endif
+
     LOG_VERBOSE("Load import section success.\n");
     (void)u8;
     (void)u32;
@@ -3982,11 +4038,13 @@ load_memory_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
     WASMMemory *memory;
 
     read_leb_uint32(p, p_end, memory_count);
+#if WASM_ENABLE_MULTI_MEMORY == 0
     /* a total of one memory is allowed */
     if (module->import_memory_count + memory_count > 1) {
         set_error_buf(error_buf, error_buf_size, "multiple memories");
         return false;
     }
+#endif
 
     if (memory_count) {
         module->memory_count = memory_count;
@@ -4003,6 +4061,11 @@ load_memory_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
                 return false;
     }
 
+#if WASM_ENABLE_MULTI_MEMORY != 0 && WASM_ENABLE_MEMORY64 != 0
+    if (!check_memory_index_types(module, error_buf, error_buf_size))
+        return false;
+#endif
+
     if (p != p_end) {
         set_error_buf(error_buf, error_buf_size, "section size mismatch");
         return false;
@@ -4811,7 +4874,7 @@ load_data_segment_section(const uint8 *buf, const uint8 *buf_end,
 #if WASM_ENABLE_MEMORY64 != 0
                 /* This memory_flag is from memory instead of data segment */
                 uint8 memory_flag;
-                if (module->import_memory_count > 0) {
+                if (mem_index < module->import_memory_count) {
                     memory_flag = module->import_memories[mem_index]
                                       .u.memory.mem_type.flags;
                 }
@@ -5414,6 +5477,7 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.segue_flags = llvm_jit_options->segue_flags;
     option.quick_invoke_c_api_import =
         llvm_jit_options->quick_invoke_c_api_import;
+    option.jit_cache_dir = llvm_jit_options->cache_dir;
 
 #if WASM_ENABLE_BULK_MEMORY != 0
     option.enable_bulk_memory = true;
@@ -5431,6 +5495,12 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.enable_ref_types = true;
 #elif WASM_ENABLE_GC != 0
     option.enable_gc = true;
+#endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    option.enable_exce_handling = true;
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+    option.enable_shared_heap = true;
 #endif
     option.enable_aux_stack_check = true;
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
@@ -7061,6 +7131,8 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     /* stop search and return the address of the catch block */
                     return true;
                 }
+                /* skip tag_index */
+                skip_leb(p);
                 break;
             case WASM_OP_CATCH_ALL:
                 if (block_nested_depth == 1) {
@@ -7337,13 +7409,13 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             case WASM_OP_I64_STORE8:
             case WASM_OP_I64_STORE16:
             case WASM_OP_I64_STORE32:
-                skip_leb_uint32(p, p_end);     /* align */
+                skip_leb_memarg(p, p_end);     /* align */
                 skip_leb_mem_offset(p, p_end); /* offset */
                 break;
 
             case WASM_OP_MEMORY_SIZE:
             case WASM_OP_MEMORY_GROW:
-                skip_leb_uint32(p, p_end); /* 0x00 */
+                skip_leb_uint32(p, p_end); /* memory idx */
                 break;
 
             case WASM_OP_I32_CONST:
@@ -7642,18 +7714,19 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     case WASM_OP_MEMORY_INIT:
                         skip_leb_uint32(p, p_end);
                         /* skip memory idx */
-                        p++;
+                        skip_leb_uint32(p, p_end);
                         break;
                     case WASM_OP_DATA_DROP:
                         skip_leb_uint32(p, p_end);
                         break;
                     case WASM_OP_MEMORY_COPY:
                         /* skip two memory idx */
-                        p += 2;
+                        skip_leb_uint32(p, p_end);
+                        skip_leb_uint32(p, p_end);
                         break;
                     case WASM_OP_MEMORY_FILL:
                         /* skip memory idx */
-                        p++;
+                        skip_leb_uint32(p, p_end);
                         break;
 #endif /* WASM_ENABLE_BULK_MEMORY */
 #if WASM_ENABLE_REF_TYPES != 0
@@ -7707,7 +7780,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     case SIMD_v128_load64_splat:
                     case SIMD_v128_store:
                         /* memarg align */
-                        skip_leb_uint32(p, p_end);
+                        skip_leb_memarg(p, p_end);
                         /* memarg offset */
                         skip_leb_mem_offset(p, p_end);
                         break;
@@ -7747,7 +7820,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     case SIMD_v128_store32_lane:
                     case SIMD_v128_store64_lane:
                         /* memarg align */
-                        skip_leb_uint32(p, p_end);
+                        skip_leb_memarg(p, p_end);
                         /* memarg offset */
                         skip_leb_mem_offset(p, p_end);
                         /* ImmLaneId */
@@ -7758,7 +7831,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                     case SIMD_v128_load32_zero:
                     case SIMD_v128_load64_zero:
                         /* memarg align */
-                        skip_leb_uint32(p, p_end);
+                        skip_leb_memarg(p, p_end);
                         /* memarg offset */
                         skip_leb_mem_offset(p, p_end);
                         break;
@@ -7790,7 +7863,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                 opcode = (uint8)opcode1;
 
                 if (opcode != WASM_OP_ATOMIC_FENCE) {
-                    skip_leb_uint32(p, p_end);     /* align */
+                    skip_leb_memarg(p, p_end);     /* align */
                     skip_leb_mem_offset(p, p_end); /* offset */
                 }
                 else {
@@ -10001,6 +10074,41 @@ check_memory(WASMModule *module, char *error_buf, uint32 error_buf_size)
             goto fail;                                        \
     } while (0)
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+static bool
+check_memory_index(WASMModule *module, uint32 memidx, char *error_buf,
+                   uint32 error_buf_size)
+{
+    if (memidx >= module->import_memory_count + module->memory_count) {
+        set_error_buf_v(error_buf, error_buf_size, "unknown memory %d",
+                        memidx);
+        return false;
+    }
+    return true;
+}
+
+#define CHECK_MEMIDX(memidx)                                                \
+    do {                                                                    \
+        if (!check_memory_index(module, memidx, error_buf, error_buf_size)) \
+            goto fail;                                                      \
+    } while (0)
+
+/* Read the align of memarg, and the memory index following it if the
+   flag is set in the align, otherwise the index is 0 */
+#define read_leb_memarg(p, p_end, res)         \
+    do {                                       \
+        read_leb_uint32(p, p_end, res);        \
+        memidx = 0;                            \
+        if (res & OPT_MEMIDX_FLAG) {           \
+            res &= ~OPT_MEMIDX_FLAG;           \
+            read_leb_uint32(p, p_end, memidx); \
+        }                                      \
+        CHECK_MEMIDX(memidx);                  \
+    } while (0)
+#else
+#define read_leb_memarg(p, p_end, res) read_leb_uint32(p, p_end, res)
+#endif
+
 static bool
 check_memory_access_align(uint8 opcode, uint32 align, char *error_buf,
                           uint32 error_buf_size)
@@ -10925,6 +11033,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     uint32 type_idx, func_idx, local_idx, global_idx, table_idx;
     uint32 table_seg_idx, data_seg_idx, count, align, i;
     mem_offset_t mem_offset;
+#if WASM_ENABLE_MULTI_MEMORY != 0
+    uint32 memidx;
+#endif
     int32 i32_const = 0;
     int64 i64_const;
     uint8 opcode;
@@ -13224,7 +13335,7 @@ re_scan:
                 }
 #endif
                 CHECK_MEMORY();
-                read_leb_uint32(p, p_end, align);          /* align */
+                read_leb_memarg(p, p_end, align);          /* align */
                 read_leb_mem_offset(p, p_end, mem_offset); /* offset */
                 if (!check_memory_access_align(opcode, align, error_buf,
                                                error_buf_size)) {
@@ -13232,6 +13343,9 @@ re_scan:
                 }
 #if WASM_ENABLE_FAST_INTERP != 0
                 emit_uint32(loader_ctx, mem_offset);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                emit_uint32(loader_ctx, memidx);
+#endif
 #endif
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
                 func->has_memory_operations = true;
@@ -13290,12 +13404,20 @@ re_scan:
 
             case WASM_OP_MEMORY_SIZE:
                 CHECK_MEMORY();
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                read_leb_uint32(p, p_end, memidx);
+                CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                emit_uint32(loader_ctx, memidx);
+#endif
+#else
                 /* reserved byte 0x00 */
                 if (*p++ != 0x00) {
                     set_error_buf(error_buf, error_buf_size,
                                   "zero byte expected");
                     goto fail;
                 }
+#endif
                 PUSH_PAGE_COUNT();
 
                 module->possible_memory_grow = true;
@@ -13306,12 +13428,20 @@ re_scan:
 
             case WASM_OP_MEMORY_GROW:
                 CHECK_MEMORY();
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                read_leb_uint32(p, p_end, memidx);
+                CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                emit_uint32(loader_ctx, memidx);
+#endif
+#else
                 /* reserved byte 0x00 */
                 if (*p++ != 0x00) {
                     set_error_buf(error_buf, error_buf_size,
                                   "zero byte expected");
                     goto fail;
                 }
+#endif
                 POP_AND_PUSH(mem_offset_type, mem_offset_type);
 
                 module->possible_memory_grow = true;
@@ -14663,8 +14793,16 @@ re_scan:
                             && module->memory_count == 0)
                             goto fail_unknown_memory;
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        read_leb_uint32(p, p_end, memidx);
+                        CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, memidx);
+#endif
+#else
                         if (*p++ != 0x00)
                             goto fail_zero_byte_expected;
+#endif
 
                         if (data_seg_idx >= module->data_seg_count) {
                             set_error_buf_v(error_buf, error_buf_size,
@@ -14712,11 +14850,26 @@ re_scan:
                     }
                     case WASM_OP_MEMORY_COPY:
                     {
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        /* dst memory index */
+                        read_leb_uint32(p, p_end, memidx);
+                        CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, memidx);
+#endif
+                        /* src memory index */
+                        read_leb_uint32(p, p_end, memidx);
+                        CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, memidx);
+#endif
+#else
                         CHECK_BUF(p, p_end, sizeof(int16));
                         /* both src and dst memory index should be 0 */
                         if (*(int16 *)p != 0x0000)
                             goto fail_zero_byte_expected;
                         p += 2;
+#endif
 
                         if (module->import_memory_count == 0
                             && module->memory_count == 0)
@@ -14735,9 +14888,17 @@ re_scan:
                     }
                     case WASM_OP_MEMORY_FILL:
                     {
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                        read_leb_uint32(p, p_end, memidx);
+                        CHECK_MEMIDX(memidx);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, memidx);
+#endif
+#else
                         if (*p++ != 0x00) {
                             goto fail_zero_byte_expected;
                         }
+#endif
                         if (module->import_memory_count == 0
                             && module->memory_count == 0) {
                             goto fail_unknown_memory;
@@ -14753,10 +14914,12 @@ re_scan:
 #endif
                         break;
                     }
+#if WASM_ENABLE_MULTI_MEMORY == 0
                     fail_zero_byte_expected:
                         set_error_buf(error_buf, error_buf_size,
                                       "zero byte expected");
                         goto fail;
+#endif
 
                     fail_unknown_memory:
                         set_error_buf(error_buf, error_buf_size,
@@ -15018,7 +15181,7 @@ re_scan:
                     {
                         CHECK_MEMORY();
 
-                        read_leb_uint32(p, p_end, align); /* align */
+                        read_leb_memarg(p, p_end, align); /* align */
                         if (!check_simd_memory_access_align(
                                 opcode1, align, error_buf, error_buf_size)) {
                             goto fail;
@@ -15037,7 +15200,7 @@ re_scan:
                     {
                         CHECK_MEMORY();
 
-                        read_leb_uint32(p, p_end, align); /* align */
+                        read_leb_memarg(p, p_end, align); /* align */
                         if (!check_simd_memory_access_align(
                                 opcode1, align, error_buf, error_buf_size)) {
                             goto fail;
@@ -15255,7 +15418,7 @@ re_scan:
 
                         CHECK_MEMORY();
 
-                        read_leb_uint32(p, p_end, align); /* align */
+                        read_leb_memarg(p, p_end, align); /* align */
                         if (!check_simd_memory_access_align(
                                 opcode1, align, error_buf, error_buf_size)) {
                             goto fail;
@@ -15286,7 +15449,7 @@ re_scan:
                     {
                         CHECK_MEMORY();
 
-                        read_leb_uint32(p, p_end, align); /* align */
+                        read_leb_memarg(p, p_end, align); /* align */
                         if (!check_simd_memory_access_align(
                                 opcode1, align, error_buf, error_buf_size)) {
                             goto fail;
@@ -15657,7 +15820,7 @@ re_scan:
 #endif
                 if (opcode1 != WASM_OP_ATOMIC_FENCE) {
                     CHECK_MEMORY();
-                    read_leb_uint32(p, p_end, align);          /* align */
+                    read_leb_memarg(p, p_end, align);          /* align */
                     read_leb_mem_offset(p, p_end, mem_offset); /* offset */
                     if (!check_memory_align_equal(opcode1, align, error_buf,
                                                   error_buf_size)) {
@@ -15665,6 +15828,9 @@ re_scan:
                     }
 #if WASM_ENABLE_FAST_INTERP != 0
                     emit_uint32(loader_ctx, mem_offset);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+                    emit_uint32(loader_ctx, memidx);
+#endif
 #endif
                 }
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
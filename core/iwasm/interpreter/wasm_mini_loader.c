@@ -2152,6 +2152,7 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.segue_flags = llvm_jit_options->segue_flags;
     option.quick_invoke_c_api_import =
         llvm_jit_options->quick_invoke_c_api_import;
+    option.jit_cache_dir = llvm_jit_options->cache_dir;
 
 #if WASM_ENABLE_BULK_MEMORY != 0
     option.enable_bulk_memory = true;
@@ -2167,6 +2168,9 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
 #endif
 #if WASM_ENABLE_REF_TYPES != 0
     option.enable_ref_types = true;
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+    option.enable_shared_heap = true;
 #endif
     option.enable_aux_stack_check = true;
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
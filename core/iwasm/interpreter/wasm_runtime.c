@@ -55,6 +55,80 @@ set_error_buf_v(char *error_buf, uint32 error_buf_size, const char *format, ...)
     }
 }
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+static bool
+get_data_image_offset(const WASMDataSeg *data_seg, uint64 *p_offset)
+{
+    if (data_seg->memory_index != 0)
+        return false;
+    if (data_seg->base_offset.init_expr_type == INIT_EXPR_TYPE_I32_CONST)
+        *p_offset = data_seg->base_offset.u.u32;
+    else if (data_seg->base_offset.init_expr_type == INIT_EXPR_TYPE_I64_CONST)
+        *p_offset = (uint64)data_seg->base_offset.u.i64;
+    else
+        /* The offset may differ between instances */
+        return false;
+    return true;
+}
+
+/* Create the copy-on-write image of the active data segments, so that
+   the instantiation maps it instead of copying the segments. Nothing is
+   created if the offset of any segment isn't a constant or any segment
+   doesn't fit in the initial memory, the instantiation copies them and
+   reports the error then */
+static void
+create_data_image(WASMModule *module)
+{
+    WASMDataSeg *data_seg;
+    WASMDataImage *image;
+    uint64 memory_size, offset, data_size = 0, image_size = 0;
+    uint32 i;
+
+    if (!module || module->import_memory_count > 0 || module->memory_count == 0
+        || (module->memories[0].flags & SHARED_MEMORY_FLAG))
+        return;
+
+    memory_size = (uint64)module->memories[0].num_bytes_per_page
+                  * module->memories[0].init_page_count;
+
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (!get_data_image_offset(data_seg, &offset)
+            || offset + data_seg->data_length > memory_size)
+            return;
+        data_size += data_seg->data_length;
+        if (image_size < offset + data_seg->data_length)
+            image_size = offset + data_seg->data_length;
+    }
+
+    if (WASM_MEM_DATA_IMAGE_MIN_SIZE == 0
+        || data_size < WASM_MEM_DATA_IMAGE_MIN_SIZE
+        || !(image = wasm_data_image_create(image_size)))
+        return;
+
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        get_data_image_offset(data_seg, &offset);
+        if (!wasm_data_image_write(image, offset, data_seg->data,
+                                   data_seg->data_length)) {
+            wasm_data_image_destroy(image);
+            return;
+        }
+    }
+
+    module->data_image = image;
+    LOG_VERBOSE("Create data image of %" PRIu64 " bytes.", image->size);
+}
+#endif /* end of WASM_MEM_DATA_IMAGE_SUPPORTED != 0 */
+
 WASMModule *
 wasm_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -62,24 +136,38 @@ wasm_load(uint8 *buf, uint32 size,
 #endif
           const LoadArgs *name, char *error_buf, uint32 error_buf_size)
 {
-    return wasm_loader_load(buf, size,
+    WASMModule *module = wasm_loader_load(buf, size,
 #if WASM_ENABLE_MULTI_MODULE != 0
-                            main_module,
+                                          main_module,
+#endif
+                                          name, error_buf, error_buf_size);
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    create_data_image(module);
 #endif
-                            name, error_buf, error_buf_size);
+    return module;
 }
 
 WASMModule *
 wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                         uint32 error_buf_size)
 {
-    return wasm_loader_load_from_sections(section_list, error_buf,
-                                          error_buf_size);
+    WASMModule *module = wasm_loader_load_from_sections(
+        section_list, error_buf, error_buf_size);
+
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    create_data_image(module);
+#endif
+    return module;
 }
 
 void
 wasm_unload(WASMModule *module)
 {
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    if (module->data_image)
+        wasm_data_image_destroy(module->data_image);
+#endif
     wasm_loader_unload(module);
 }
 
@@ -168,6 +256,7 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
         heap_offset = (uint64)num_bytes_per_page * init_page_count;
     uint64 memory_data_size, max_memory_data_size;
     uint8 *global_addr;
+    bool is_data_image_mapped = false;
 
     bool is_shared_memory = false;
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -194,6 +283,11 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
     default_max_page =
         memory->is_memory64 ? DEFAULT_MEM64_MAX_PAGES : DEFAULT_MAX_PAGES;
 
+    if (memory_idx > 0) {
+        /* Only the default memory hosts the app heap */
+        heap_size = 0;
+    }
+
     if (heap_size > 0 && module_inst->module->malloc_function != (uint32)-1
         && module_inst->module->free_function != (uint32)-1) {
         /* Disable app heap, use malloc/free function exported
@@ -297,6 +391,24 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
             max_page_count = default_max_page;
     }
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_ENABLE_MEMORY64 != 0
+    if (memory->is_memory64) {
+        /* Keep the guard page at the end of the reserved space, see
+           MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE */
+        if ((uint64)num_bytes_per_page * init_page_count
+            > MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE) {
+            set_error_buf(error_buf, error_buf_size,
+                          "memory64 size exceeds the limit of the hardware "
+                          "bound check");
+            return NULL;
+        }
+        if ((uint64)num_bytes_per_page * max_page_count
+            > MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE)
+            max_page_count = (uint32)(MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE
+                                      / num_bytes_per_page);
+    }
+#endif
+
     LOG_VERBOSE("Memory instantiate:");
     LOG_VERBOSE("  page bytes: %u, init pages: %u, max pages: %u",
                 num_bytes_per_page, init_page_count, max_page_count);
@@ -320,7 +432,16 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
         return NULL;
     }
 
+#if WASM_MEM_DATA_IMAGE_SUPPORTED != 0
+    /* Map the data segments before the app heap is created in the memory,
+       they needn't be copied then */
+    if (memory_idx == 0 && !parent && module->data_image)
+        is_data_image_mapped = wasm_data_image_map(
+            module->data_image, memory->memory_data, memory_data_size);
+#endif
+
     memory->module_type = Wasm_Module_Bytecode;
+    memory->is_data_image_mapped = is_data_image_mapped;
     memory->num_bytes_per_page = num_bytes_per_page;
     memory->cur_page_count = init_page_count;
     memory->max_page_count = max_page_count;
@@ -2292,21 +2413,33 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
 #if WASM_ENABLE_GC != 0
     if (!is_sub_inst) {
         uint32 gc_heap_size = wasm_runtime_get_gc_heap_size_default();
+        uint32 gc_heap_max_size = wasm_runtime_get_gc_heap_max_size_default();
 
         if (gc_heap_size < GC_HEAP_SIZE_MIN)
             gc_heap_size = GC_HEAP_SIZE_MIN;
         if (gc_heap_size > GC_HEAP_SIZE_MAX)
             gc_heap_size = GC_HEAP_SIZE_MAX;
+        if (gc_heap_max_size > GC_HEAP_SIZE_MAX)
+            gc_heap_max_size = GC_HEAP_SIZE_MAX;
+
+        if (gc_heap_max_size > gc_heap_size) {
+            /* the pages of the heap are committed as it grows, fall back
+               to the fixed size heap if it isn't supported */
+            module_inst->e->common.gc_heap_handle =
+                mem_allocator_create_growable(gc_heap_size, gc_heap_max_size);
+        }
 
-        module_inst->e->common.gc_heap_pool =
-            runtime_malloc(gc_heap_size, error_buf, error_buf_size);
-        if (!module_inst->e->common.gc_heap_pool)
-            goto fail;
+        if (!module_inst->e->common.gc_heap_handle) {
+            module_inst->e->common.gc_heap_pool =
+                runtime_malloc(gc_heap_size, error_buf, error_buf_size);
+            if (!module_inst->e->common.gc_heap_pool)
+                goto fail;
 
-        module_inst->e->common.gc_heap_handle = mem_allocator_create(
-            module_inst->e->common.gc_heap_pool, gc_heap_size);
-        if (!module_inst->e->common.gc_heap_handle)
-            goto fail;
+            module_inst->e->common.gc_heap_handle = mem_allocator_create(
+                module_inst->e->common.gc_heap_pool, gc_heap_size);
+            if (!module_inst->e->common.gc_heap_handle)
+                goto fail;
+        }
     }
 #endif
 
@@ -2613,7 +2746,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             goto fail;
         }
 
-        if (memory_data) {
+        if (memory_data && !memory->is_data_image_mapped) {
             bh_memcpy_s(memory_data + base_offset,
                         (uint32)(memory_size - base_offset), data_seg->data,
                         length);
@@ -3166,6 +3299,10 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
         (WASMModuleInstanceCommon *)module_inst);
 #endif
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    wasm_runtime_detach_shared_heap((WASMModuleInstanceCommon *)module_inst);
+#endif
+
     if (module_inst->memory_count > 0)
         memories_deinstantiate(module_inst, module_inst->memories,
                                module_inst->memory_count);
@@ -3217,6 +3354,8 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
         wasm_native_call_context_dtors((WASMModuleInstanceCommon *)module_inst);
     }
 
+    wasm_runtime_destroy_clone_image((WASMModuleInstanceCommon *)module_inst);
+
 #if WASM_ENABLE_BULK_MEMORY != 0
     bh_bitmap_delete(module_inst->e->common.data_dropped);
 #endif
@@ -4373,6 +4512,46 @@ llvm_jit_memory_init(WASMModuleInstance *module_inst, uint32 seg_index,
     return true;
 }
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+bool
+llvm_jit_memory_init_with_idx(WASMModuleInstance *module_inst,
+                              uint32 seg_index, uint32 offset, uint32 len,
+                              size_t dst, uint32 memidx)
+{
+    WASMMemoryInstance *memory_inst;
+    WASMModule *module;
+    uint8 *data = NULL;
+    uint64 seg_len = 0;
+
+    bh_assert(module_inst->module_type == Wasm_Module_Bytecode);
+
+    if (memidx == 0)
+        return llvm_jit_memory_init(module_inst, seg_index, offset, len, dst);
+
+    bh_assert(memidx < module_inst->memory_count);
+    memory_inst = module_inst->memories[memidx];
+
+    if (!bh_bitmap_get_bit(module_inst->e->common.data_dropped, seg_index)) {
+        module = module_inst->module;
+        seg_len = module->data_segments[seg_index]->data_length;
+        data = module->data_segments[seg_index]->data;
+    }
+
+    SHARED_MEMORY_LOCK(memory_inst);
+    if ((uint64)dst + (uint64)len > memory_inst->memory_data_size
+        || (uint64)offset + (uint64)len > seg_len) {
+        SHARED_MEMORY_UNLOCK(memory_inst);
+        wasm_set_exception(module_inst, "out of bounds memory access");
+        return false;
+    }
+    bh_memcpy_s(memory_inst->memory_data + dst,
+                CLAMP_U64_TO_U32(memory_inst->memory_data_size - dst),
+                data + offset, len);
+    SHARED_MEMORY_UNLOCK(memory_inst);
+    return true;
+}
+#endif
+
 bool
 llvm_jit_data_drop(WASMModuleInstance *module_inst, uint32 seg_index)
 {
@@ -106,9 +106,17 @@ struct WASMMemoryInstance {
          0: non-shared memory, > 0: shared memory */
     bh_atomic_16_t ref_count;
 
-    /* Four-byte paddings to ensure the layout of WASMMemoryInstance is the same
-     * in both 64-bit and 32-bit */
-    uint8 _paddings[4];
+    /* Whether the files are mapped into the memory: the beginning of the
+       memory is mapped copy-on-write from the data image of the module, or
+       host buffers are mapped, its pages can't be discarded to zero */
+    uint8 is_data_image_mapped;
+
+    /* Whether a shared heap is mapped after the end of the memory */
+    uint8 is_shared_heap_attached;
+
+    /* Two-byte paddings to ensure the layout of WASMMemoryInstance is the
+     * same in both 64-bit and 32-bit */
+    uint8 _paddings[2];
 
     /* Number bytes per page */
     uint32 num_bytes_per_page;
@@ -308,6 +316,15 @@ typedef struct WASMModuleInstanceExtraCommon {
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap *elem_dropped;
 #endif
+    /* The state captured when the instance is cloned the first time */
+    struct WASMCloneImage *clone_image;
+#if WASM_ENABLE_SHARED_HEAP != 0
+    /* The shared heap attached to the default memory */
+    struct WASMSharedHeap *shared_heap;
+    /* The max page count of the default memory before it is clamped
+       below the shared heap */
+    uint32 max_page_count_unclamped;
+#endif
 
 #if WASM_ENABLE_GC != 0
     /* The gc heap memory pool */
@@ -623,6 +640,10 @@ wasm_get_default_memory(WASMModuleInstance *module_inst);
 bool
 wasm_enlarge_memory(WASMModuleInstance *module_inst, uint32 inc_page_count);
 
+bool
+wasm_enlarge_memory_with_idx(WASMModuleInstance *module_inst,
+                             uint32 inc_page_count, uint32 memidx);
+
 bool
 wasm_call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 elem_idx,
                    uint32 argc, uint32 argv[]);
@@ -758,6 +779,13 @@ bool
 llvm_jit_memory_init(WASMModuleInstance *module_inst, uint32 seg_index,
                      uint32 offset, uint32 len, size_t dst);
 
+#if WASM_ENABLE_MULTI_MEMORY != 0
+bool
+llvm_jit_memory_init_with_idx(WASMModuleInstance *module_inst,
+                              uint32 seg_index, uint32 offset, uint32 len,
+                              size_t dst, uint32 memidx);
+#endif
+
 bool
 llvm_jit_data_drop(WASMModuleInstance *module_inst, uint32 seg_index);
 #endif
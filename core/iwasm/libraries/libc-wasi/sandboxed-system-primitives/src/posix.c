@@ -3026,6 +3026,28 @@ fd_table_destroy(struct fd_table *ft)
     }
 }
 
+// Checks whether the only open file descriptors are the standard ones and
+// the preopened directories, i.e. the table can be re-created from the
+// WASI arguments.
+bool
+fd_table_has_only_preopens(struct fd_table *ft, struct fd_prestats *pt)
+{
+    bool ret = true;
+
+    rwlock_rdlock(&ft->lock);
+    rwlock_rdlock(&pt->lock);
+    for (uint32 i = 3; i < ft->size; i++) {
+        if (ft->entries[i].object != NULL
+            && (i >= pt->size || pt->prestats[i].dir == NULL)) {
+            ret = false;
+            break;
+        }
+    }
+    rwlock_unlock(&pt->lock);
+    rwlock_unlock(&ft->lock);
+    return ret;
+}
+
 void
 fd_prestats_destroy(struct fd_prestats *pt)
 {
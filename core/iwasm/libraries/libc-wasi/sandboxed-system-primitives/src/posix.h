@@ -77,6 +77,8 @@ void
 fd_table_destroy(struct fd_table *ft);
 void
 fd_prestats_destroy(struct fd_prestats *pt);
+bool
+fd_table_has_only_preopens(struct fd_table *ft, struct fd_prestats *pt);
 
 bool
 addr_pool_init(struct addr_pool *);
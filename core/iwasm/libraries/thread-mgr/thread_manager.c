@@ -5,6 +5,7 @@
 
 #include "thread_manager.h"
 #include "../common/wasm_c_api_internal.h"
+#include "../common/wasm_memory.h"
 
 #if WASM_ENABLE_INTERP != 0
 #include "../interpreter/wasm_runtime.h"
@@ -693,6 +694,8 @@ thread_manager_start_routine(void *arg)
 
     os_mutex_unlock(&cluster_list_lock);
 
+    wasm_runtime_memory_flush_thread_cache();
+
     os_thread_exit(ret);
     return ret;
 }
@@ -328,6 +328,93 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
     return true;
 }
 
+static int
+merge_free_hmu(gc_heap_t *heap, hmu_t *hmu, gc_size_t size);
+
+#if GC_SLAB_ENABLED != 0
+/* Keep the freed VM object in the slab list of its size, it is still a
+   VM object with the freed bit set, see hmu_is_vo_freed */
+static void
+slab_push(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
+{
+    gc_uint32 idx = size >> 3;
+    gc_uint8 *obj = (gc_uint8 *)hmu_to_obj(hmu);
+
+    *(gc_uint32 *)obj = heap->slab_lists[idx];
+    heap->slab_lists[idx] = (gc_uint32)(obj - heap->base_addr);
+    hmu_free_vo(hmu);
+}
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+/* Check the block taken from the slab list of the size, it must be a
+   freed VM object of the size */
+static inline bool
+slab_is_valid_hmu(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
+{
+    return hmu_is_in_heap(hmu, heap->base_addr,
+                          heap->base_addr + heap->current_size)
+           && hmu_get_ut(hmu) == HMU_VO && hmu_is_vo_freed(hmu)
+           && hmu_get_size(hmu) == size;
+}
+#endif
+
+static hmu_t *
+slab_alloc(gc_heap_t *heap, gc_size_t size)
+{
+    gc_uint32 idx = size >> 3, offset = heap->slab_lists[idx];
+    gc_uint8 *obj;
+    hmu_t *hmu;
+
+    bh_assert(offset != 0);
+    obj = heap->base_addr + offset;
+    hmu = obj_to_hmu(obj);
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (!slab_is_valid_hmu(heap, hmu, size)) {
+        heap->is_heap_corrupted = true;
+        return NULL;
+    }
+#endif
+    heap->slab_lists[idx] = *(gc_uint32 *)obj;
+
+    heap->total_free_size -= size;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+    return hmu;
+}
+
+/* Merge the blocks in the slab lists into the free chunks, return
+   whether any block is merged */
+static bool
+slab_flush(gc_heap_t *heap)
+{
+    gc_uint32 idx, offset;
+    gc_uint8 *obj;
+    hmu_t *hmu;
+    bool flushed = false;
+
+    for (idx = 0; idx < GC_SLAB_LIST_NUM; idx++) {
+        while ((offset = heap->slab_lists[idx])) {
+            obj = heap->base_addr + offset;
+            hmu = obj_to_hmu(obj);
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+            /* the offsets of the app heap are kept in the linear memory,
+               check the block like slab_alloc before merging it */
+            if (!slab_is_valid_hmu(heap, hmu, idx << 3)) {
+                heap->is_heap_corrupted = true;
+                return false;
+            }
+#endif
+            heap->slab_lists[idx] = *(gc_uint32 *)obj;
+            /* the size is counted as free already */
+            if (merge_free_hmu(heap, hmu, idx << 3) != GC_SUCCESS)
+                return false;
+            flushed = true;
+        }
+    }
+    return flushed;
+}
+#endif /* end of GC_SLAB_ENABLED != 0 */
+
 /**
  * Find a proper hmu for required memory size
  *
@@ -364,7 +451,13 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
     if (size < GC_SMALLEST_SIZE)
         size = GC_SMALLEST_SIZE;
 
-    /* check normal list at first*/
+#if GC_SLAB_ENABLED != 0
+    /* check the slab list of the size at first */
+    if (size <= GC_SLAB_MAX_SIZE && heap->slab_lists[size >> 3] != 0)
+        return slab_alloc(heap, size);
+#endif
+
+    /* check normal list*/
     if (HMU_IS_FC_NORMAL(size)) {
         /* find a non-empty slot in normal_node_list with good size*/
         init_node_idx = (size >> 3);
@@ -488,7 +581,7 @@ do_gc_heap(gc_heap_t *heap)
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
     uint64 start = 0, end = 0, time = 0;
 
-    start = os_time_get_boot_microsecond();
+    start = os_time_get_boot_us();
 #endif
     if (heap->is_reclaim_enabled) {
         UNLOCK_HEAP(heap);
@@ -496,7 +589,7 @@ do_gc_heap(gc_heap_t *heap)
         LOCK_HEAP(heap);
     }
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
-    end = os_time_get_boot_microsecond();
+    end = os_time_get_boot_us();
     time = end - start;
     heap->total_gc_time += time;
     if (time > heap->max_gc_time) {
@@ -506,6 +599,35 @@ do_gc_heap(gc_heap_t *heap)
 #endif
     return ret;
 }
+
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+static int
+do_gc_heap_step(gc_heap_t *heap)
+{
+    int ret = GC_SUCCESS;
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    uint64 start = 0, end = 0, time = 0;
+
+    start = os_time_get_boot_us();
+#endif
+    if (heap->is_reclaim_enabled) {
+        UNLOCK_HEAP(heap);
+        ret = gci_gc_heap_step(heap);
+        LOCK_HEAP(heap);
+    }
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    /* a step pauses the mutator as a collection does, but isn't counted
+       as one */
+    end = os_time_get_boot_us();
+    time = end - start;
+    heap->total_gc_time += time;
+    if (time > heap->max_gc_time) {
+        heap->max_gc_time = time;
+    }
+#endif
+    return ret;
+}
+#endif
 #endif
 
 /**
@@ -533,6 +655,26 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 #if GC_IN_EVERY_ALLOCATION != 0
     if (GC_SUCCESS != do_gc_heap(heap))
         return NULL;
+#else
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    /* Mark the objects in small steps once the free size drops below the
+       threshold, the full collection is only done when the heap is
+       exhausted before the marking finishes */
+    if ((heap->is_doing_mark
+         && heap->total_free_size < heap->mark_step_free_size)
+        || (!heap->is_doing_mark
+            && heap->total_free_size < heap->gc_threshold)) {
+        if (GC_SUCCESS != do_gc_heap_step(heap))
+            return NULL;
+    }
+    {
+        hmu_t *ret = NULL;
+        if ((ret = alloc_hmu(heap, size))) {
+            return ret;
+        }
+        if (GC_SUCCESS != do_gc_heap(heap))
+            return NULL;
+    }
 #else
     if (heap->total_free_size < heap->gc_threshold) {
         if (GC_SUCCESS != do_gc_heap(heap))
@@ -549,9 +691,298 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 #endif
 #endif
 
+#if GC_GENERATIONAL_ENABLED != 0
+    if (heap->is_last_gc_minor) {
+        hmu_t *ret = NULL;
+        if ((ret = alloc_hmu(heap, size))) {
+            return ret;
+        }
+        /* The minor collection doesn't reclaim the dead old objects */
+        heap->is_major_gc_required = 1;
+        if (GC_SUCCESS != do_gc_heap(heap))
+            return NULL;
+    }
+#endif
+#endif
+
+#if GC_SLAB_ENABLED != 0
+    {
+        hmu_t *hmu;
+
+        if ((hmu = alloc_hmu(heap, size)))
+            return hmu;
+        /* Merge the blocks in the slab lists and retry */
+        if (slab_flush(heap) && (hmu = alloc_hmu(heap, size)))
+            return hmu;
+    }
+#endif
+
+#if GC_HEAP_RESIZE_ENABLED != 0
+    {
+        hmu_t *hmu;
+
+        if ((hmu = alloc_hmu(heap, size)))
+            return hmu;
+        /* Grow the heap as the last resort */
+        if (!gci_grow_heap(heap, size))
+            return NULL;
+    }
+#endif
+
     return alloc_hmu(heap, size);
 }
 
+/* Free the VM object of the hmu, the heap must have been locked */
+static int
+free_hmu_vo(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_uint8 *base_addr, *end_addr;
+    gc_size_t size = 0;
+    hmu_type_t ut;
+
+    base_addr = heap->base_addr;
+    end_addr = base_addr + heap->current_size;
+
+    if (!hmu_is_in_heap(hmu, base_addr, end_addr))
+        return GC_SUCCESS;
+
+#if BH_ENABLE_GC_VERIFY != 0
+    hmu_verify(heap, hmu);
+#endif
+    ut = hmu_get_ut(hmu);
+    if (ut != HMU_VO)
+        return GC_ERROR;
+
+    if (hmu_is_vo_freed(hmu)) {
+        /* freed twice, the block is kept in a slab list */
+        LOG_ERROR("[GC_ERROR]The object has been freed already.\n");
+        return GC_ERROR;
+    }
+
+    size = hmu_get_size(hmu);
+
+    heap->total_free_size += size;
+
+#if GC_STAT_DATA != 0
+    heap->total_size_freed += size;
+#endif
+
+#if GC_SLAB_ENABLED != 0
+    if (size <= GC_SLAB_MAX_SIZE) {
+        slab_push(heap, hmu, size);
+        return GC_SUCCESS;
+    }
+#endif
+
+    return merge_free_hmu(heap, hmu, size);
+}
+
+/* Merge the free block with its free neighbours and add it to the
+   free chunks, the heap must have been locked */
+static int
+merge_free_hmu(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
+{
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *prev = NULL;
+    hmu_t *next = NULL;
+
+    if (!hmu_get_pinuse(hmu)) {
+        prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+
+        if (hmu_is_in_heap(prev, base_addr, end_addr)
+            && hmu_get_ut(prev) == HMU_FC) {
+            size += hmu_get_size(prev);
+            hmu = prev;
+            if (!unlink_hmu(heap, prev))
+                return GC_ERROR;
+        }
+    }
+
+    next = (hmu_t *)((char *)hmu + size);
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        if (hmu_get_ut(next) == HMU_FC) {
+            size += hmu_get_size(next);
+            if (!unlink_hmu(heap, next))
+                return GC_ERROR;
+            next = (hmu_t *)((char *)hmu + size);
+        }
+    }
+
+    if (!gci_add_fc(heap, hmu, size))
+        return GC_ERROR;
+
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        hmu_unmark_pinuse(next);
+    }
+
+    return GC_SUCCESS;
+}
+
+#if GC_THREAD_CACHE_ENABLED != 0
+/* The blocks cached by a thread are kept in the lists of size classes
+   indexed by their hmu size / 8, and linked through their objects */
+#define GC_THREAD_CACHE_CLASS_NUM ((GC_THREAD_CACHE_MAX_SIZE >> 3) + 1)
+
+typedef struct gc_thread_cache {
+    /* thread_cache_id of the heap which the blocks are cached for */
+    gc_uint32 heap_cache_id;
+    gc_uint32 counts[GC_THREAD_CACHE_CLASS_NUM];
+    hmu_t *lists[GC_THREAD_CACHE_CLASS_NUM];
+} gc_thread_cache_t;
+
+static bh_atomic_32_t thread_cache_id_max = 0;
+
+static os_thread_local_attribute gc_thread_cache_t thread_cache;
+
+static inline hmu_t *
+thread_cache_get_next(hmu_t *hmu)
+{
+    hmu_t *next;
+
+    /* the object is only 4-byte aligned in 64-bit target */
+    memcpy(&next, hmu_to_obj(hmu), sizeof(hmu_t *));
+    return next;
+}
+
+static inline void
+thread_cache_set_next(hmu_t *hmu, hmu_t *next)
+{
+    memcpy(hmu_to_obj(hmu), &next, sizeof(hmu_t *));
+}
+
+static inline gc_thread_cache_t *
+get_thread_cache(gc_heap_t *heap)
+{
+    gc_thread_cache_t *cache = &thread_cache;
+
+    if (cache->heap_cache_id != heap->thread_cache_id) {
+        /* The blocks cached for the previous heap are dropped, it
+           should have been destroyed */
+        memset(cache, 0, sizeof(gc_thread_cache_t));
+        cache->heap_cache_id = heap->thread_cache_id;
+    }
+    return cache;
+}
+
+static gc_object_t
+thread_cache_alloc(gc_heap_t *heap, gc_size_t tot_size)
+{
+    gc_thread_cache_t *cache;
+    hmu_t *hmu;
+    uint32 idx;
+
+    /* the same size as the one allocated by alloc_hmu */
+    if (tot_size < GC_SMALLEST_SIZE)
+        tot_size = GC_SMALLEST_SIZE;
+
+    if (tot_size > GC_THREAD_CACHE_MAX_SIZE)
+        return NULL;
+
+    cache = get_thread_cache(heap);
+    idx = tot_size >> 3;
+    if (!(hmu = cache->lists[idx]))
+        return NULL;
+
+    cache->lists[idx] = thread_cache_get_next(hmu);
+    cache->counts[idx]--;
+    hmu_unfree_vo(hmu);
+    return hmu_to_obj(hmu);
+}
+
+static bool
+thread_cache_free(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_thread_cache_t *cache;
+    gc_size_t size;
+    uint32 idx;
+
+    /* Leave the invalid objects to the slow path to report the error,
+       the header isn't changed by other threads as it is allocated */
+    if (!hmu_is_in_heap(hmu, heap->base_addr,
+                        heap->base_addr + heap->current_size)
+        || hmu_get_ut(hmu) != HMU_VO || hmu_is_vo_freed(hmu))
+        return false;
+
+    size = hmu_get_size(hmu);
+    if (size > GC_THREAD_CACHE_MAX_SIZE)
+        return false;
+
+    cache = get_thread_cache(heap);
+    idx = size >> 3;
+    if (cache->counts[idx] >= GC_THREAD_CACHE_CLASS_CAPACITY)
+        return false;
+
+    /* mark it freed like the blocks in the slab lists, so that
+       freeing it again is rejected */
+    hmu_free_vo(hmu);
+    thread_cache_set_next(hmu, cache->lists[idx]);
+    cache->lists[idx] = hmu;
+    cache->counts[idx]++;
+    return true;
+}
+
+/* Return the blocks cached by the current thread to the heap, the heap
+   must have been locked, return whether any block is returned */
+static bool
+thread_cache_flush(gc_heap_t *heap)
+{
+    gc_thread_cache_t *cache = &thread_cache;
+    hmu_t *hmu;
+    uint32 idx;
+    bool flushed = false;
+
+    if (heap->thread_cache_id == 0
+        || cache->heap_cache_id != heap->thread_cache_id)
+        return false;
+
+    for (idx = 0; idx < GC_THREAD_CACHE_CLASS_NUM; idx++) {
+        while ((hmu = cache->lists[idx])) {
+            cache->lists[idx] = thread_cache_get_next(hmu);
+            hmu_unfree_vo(hmu);
+            free_hmu_vo(heap, hmu);
+            flushed = true;
+        }
+        cache->counts[idx] = 0;
+    }
+    return flushed;
+}
+
+void
+gc_enable_thread_cache(gc_handle_t handle)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    /* 0 means the caches are disabled */
+    do {
+        heap->thread_cache_id =
+            BH_ATOMIC_32_FETCH_ADD(thread_cache_id_max, 1) + 1;
+    } while (heap->thread_cache_id == 0);
+}
+
+void
+gc_flush_thread_cache(gc_handle_t handle)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    LOCK_HEAP(heap);
+    thread_cache_flush(heap);
+    UNLOCK_HEAP(heap);
+}
+#else
+void
+gc_enable_thread_cache(gc_handle_t handle)
+{
+    (void)handle;
+}
+
+void
+gc_flush_thread_cache(gc_handle_t handle)
+{
+    (void)handle;
+}
+#endif /* end of GC_THREAD_CACHE_ENABLED != 0 */
+
 #if BH_ENABLE_GC_VERIFY == 0
 gc_object_t
 gc_alloc_vo(void *vheap, gc_size_t size)
@@ -580,9 +1011,26 @@ gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
     }
 #endif
 
+#if GC_THREAD_CACHE_ENABLED != 0
+    if (heap->thread_cache_id != 0
+        && (ret = thread_cache_alloc(heap, tot_size))) {
+        tot_size = hmu_get_size(obj_to_hmu(ret));
+        if (tot_size > tot_size_unaligned)
+            /* clear buffer appended by GC_ALIGN_8() */
+            memset((uint8 *)ret + size, 0, tot_size - tot_size_unaligned);
+        return ret;
+    }
+#endif
+
     LOCK_HEAP(heap);
 
     hmu = alloc_hmu_ex(heap, tot_size);
+#if GC_THREAD_CACHE_ENABLED != 0
+    /* the blocks cached by this thread can't be merged with their free
+       neighbours, return them to the heap and try again */
+    if (!hmu && thread_cache_flush(heap))
+        hmu = alloc_hmu_ex(heap, tot_size);
+#endif
     if (!hmu)
         goto finish;
 
@@ -803,6 +1251,9 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 #else
     hmu_unmark_wo(hmu);
 #endif
+#if GC_WRITE_BARRIER_ENABLED != 0
+    hmu_unmark_wo_remembered(hmu);
+#endif
 
 #if BH_ENABLE_GC_VERIFY != 0
     hmu_init_prefix_and_suffix(hmu, tot_size, file, line);
@@ -842,13 +1293,8 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 #endif
 {
     gc_heap_t *heap = (gc_heap_t *)vheap;
-    gc_uint8 *base_addr, *end_addr;
     hmu_t *hmu = NULL;
-    hmu_t *prev = NULL;
-    hmu_t *next = NULL;
-    gc_size_t size = 0;
-    hmu_type_t ut;
-    int ret = GC_SUCCESS;
+    int ret;
 
     if (!obj) {
         return GC_SUCCESS;
@@ -863,75 +1309,13 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 
     hmu = obj_to_hmu(obj);
 
-    base_addr = heap->base_addr;
-    end_addr = base_addr + heap->current_size;
-
-    LOCK_HEAP(heap);
-
-    if (hmu_is_in_heap(hmu, base_addr, end_addr)) {
-#if BH_ENABLE_GC_VERIFY != 0
-        hmu_verify(heap, hmu);
-#endif
-        ut = hmu_get_ut(hmu);
-        if (ut == HMU_VO) {
-            if (hmu_is_vo_freed(hmu)) {
-                bh_assert(0);
-                ret = GC_ERROR;
-                goto out;
-            }
-
-            size = hmu_get_size(hmu);
-
-            heap->total_free_size += size;
-
-#if GC_STAT_DATA != 0
-            heap->total_size_freed += size;
+#if GC_THREAD_CACHE_ENABLED != 0
+    if (heap->thread_cache_id != 0 && thread_cache_free(heap, hmu))
+        return GC_SUCCESS;
 #endif
 
-            if (!hmu_get_pinuse(hmu)) {
-                prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
-
-                if (hmu_is_in_heap(prev, base_addr, end_addr)
-                    && hmu_get_ut(prev) == HMU_FC) {
-                    size += hmu_get_size(prev);
-                    hmu = prev;
-                    if (!unlink_hmu(heap, prev)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                }
-            }
-
-            next = (hmu_t *)((char *)hmu + size);
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
-                    size += hmu_get_size(next);
-                    if (!unlink_hmu(heap, next)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                    next = (hmu_t *)((char *)hmu + size);
-                }
-            }
-
-            if (!gci_add_fc(heap, hmu, size)) {
-                ret = GC_ERROR;
-                goto out;
-            }
-
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                hmu_unmark_pinuse(next);
-            }
-        }
-        else {
-            ret = GC_ERROR;
-            goto out;
-        }
-        ret = GC_SUCCESS;
-        goto out;
-    }
-
-out:
+    LOCK_HEAP(heap);
+    ret = free_hmu_vo(heap, hmu);
     UNLOCK_HEAP(heap);
     return ret;
 }
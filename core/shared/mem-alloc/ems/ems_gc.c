@@ -58,6 +58,48 @@ free_mark_node(mark_node_t *node)
     BH_FREE((gc_object_t)node);
 }
 
+#if GC_HEAP_RESIZE_ENABLED != 0
+/**
+ * Get the size which the growable heap should be resized to after a
+ * collection, according to the live size and the allocation rate
+ *
+ * @param heap should be a valid instance heap which can grow
+ * @param live_size the size of the blocks in use after the collection
+ *
+ * @return the target size of the heap
+ */
+static gc_size_t
+get_heap_target_size(gc_heap_t *heap, gc_size_t live_size)
+{
+    uint64 now = os_time_get_boot_us();
+    uint64 current_size = heap->current_size, target_size = current_size;
+    uint64 free_size = current_size - live_size;
+
+    if (free_size * 100 < current_size * GC_HEAP_MIN_FREE_RATIO) {
+        target_size = (uint64)live_size * 100 / (100 - GC_HEAP_MIN_FREE_RATIO);
+        /* collect less frequently if the allocation rate is high */
+        if (now - heap->last_gc_time < GC_HEAP_MIN_GC_INTERVAL
+            && target_size < current_size + current_size / 2)
+            target_size = current_size + current_size / 2;
+    }
+    else if (free_size * 100 > current_size * GC_HEAP_MAX_FREE_RATIO
+             && heap->gc_count_since_grow >= GC_HEAP_SHRINK_DELAY) {
+        target_size = (uint64)live_size * 100 / (100 - GC_HEAP_MAX_FREE_RATIO);
+        /* don't release the pages for a little gain */
+        if (current_size - target_size < GC_HEAP_RESIZE_STEP)
+            target_size = current_size;
+    }
+    heap->last_gc_time = now;
+    heap->gc_count_since_grow++;
+
+    if (target_size < heap->min_size)
+        target_size = heap->min_size;
+    if (target_size > heap->max_size)
+        target_size = heap->max_size;
+    return (gc_size_t)target_size;
+}
+#endif
+
 /**
  * Sweep phase of mark_sweep algorithm
  * @param heap the heap to sweep, should be a valid instance heap
@@ -71,6 +113,9 @@ sweep_instance_heap(gc_heap_t *heap)
     gc_size_t size;
     int i, lsize;
     gc_size_t tot_free = 0;
+#if GC_HEAP_RESIZE_ENABLED != 0
+    gc_size_t target_size = 0;
+#endif
 
     bh_assert(gci_is_heap_valid(heap));
 
@@ -86,6 +131,10 @@ sweep_instance_heap(gc_heap_t *heap)
     }
     heap->kfc_tree_root->right = NULL;
     heap->root_set = NULL;
+#if GC_SLAB_ENABLED != 0
+    /* the blocks in the slab lists are merged below */
+    memset(heap->slab_lists, 0, sizeof(heap->slab_lists));
+#endif
 
     while (cur < end) {
         ut = hmu_get_ut(cur);
@@ -120,10 +169,12 @@ sweep_instance_heap(gc_heap_t *heap)
                 last = NULL;
             }
 
+#if GC_GENERATIONAL_ENABLED == 0
             if (ut == HMU_WO) {
                 /* unmark it */
                 hmu_unmark_wo(cur);
             }
+#endif
         }
 
         cur = (hmu_t *)((char *)cur + size);
@@ -131,6 +182,23 @@ sweep_instance_heap(gc_heap_t *heap)
 
     bh_assert(cur == end);
 
+#if GC_HEAP_RESIZE_ENABLED != 0
+    if (heap->reserved_size > 0) {
+        gc_size_t tail_size =
+            last ? (gc_size_t)((char *)end - (char *)last) : 0;
+
+        target_size = get_heap_target_size(
+            heap, heap->current_size - tot_free - tail_size);
+        if (last && target_size < heap->current_size) {
+            /* release the free pages at the end of the heap */
+            cur = (hmu_t *)gci_shrink_heap(heap, (gc_uint8 *)last,
+                                           target_size);
+            if (cur == last)
+                last = NULL;
+        }
+    }
+#endif
+
     if (last) {
         tot_free += (gc_size_t)((char *)cur - (char *)last);
         gci_add_fc(heap, last, (gc_size_t)((char *)cur - (char *)last));
@@ -139,6 +207,11 @@ sweep_instance_heap(gc_heap_t *heap)
 
     heap->total_free_size = tot_free;
 
+#if GC_HEAP_RESIZE_ENABLED != 0
+    if (target_size > heap->current_size)
+        gci_grow_heap(heap, target_size - heap->current_size);
+#endif
+
 #if GC_STAT_DATA != 0
     heap->total_gc_count++;
     if ((heap->current_size - tot_free) > heap->highmark_size)
@@ -148,6 +221,76 @@ sweep_instance_heap(gc_heap_t *heap)
     gc_update_threshold(heap);
 }
 
+/**
+ * Push an object to a to-expand list without checking whether it
+ * has been marked
+ *
+ * @param p_stack the to-expand list
+ * @param obj should be a valid wo inside the heap
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+push_wo_to_expand(mark_node_t **p_stack, gc_object_t obj)
+{
+    mark_node_t *mark_node = *p_stack, *new_node = NULL;
+
+    if (!mark_node || mark_node->idx == mark_node->cnt) {
+        new_node = alloc_mark_node();
+        if (!new_node) {
+            LOG_ERROR("can not add obj to mark node because of mark node "
+                      "allocation failed");
+            return GC_ERROR;
+        }
+        new_node->next = mark_node;
+        *p_stack = new_node;
+        mark_node = new_node;
+    }
+
+    mark_node->set[mark_node->idx++] = obj;
+    return GC_SUCCESS;
+}
+
+/**
+ * Pop an object from a to-expand list, the empty nodes are freed
+ *
+ * @param p_stack the to-expand list
+ *
+ * @return the object popped, NULL if the list is empty
+ */
+static gc_object_t
+pop_wo_to_expand(mark_node_t **p_stack)
+{
+    mark_node_t *mark_node;
+
+    while ((mark_node = *p_stack) && mark_node->idx == 0) {
+        *p_stack = mark_node->next;
+        free_mark_node(mark_node);
+    }
+
+    return mark_node ? mark_node->set[--mark_node->idx] : NULL;
+}
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+/**
+ * Append a to-expand list to the to-expand list of the heap
+ */
+static void
+append_to_root_set(gc_heap_t *heap, mark_node_t *stack)
+{
+    mark_node_t *tail = stack;
+
+    if (!stack)
+        return;
+
+    while (tail->next)
+        tail = tail->next;
+    tail->next = (mark_node_t *)heap->root_set;
+    heap->root_set = stack;
+}
+#endif
+
 /**
  * Add a to-expand node to the to-expand list
  *
@@ -160,7 +303,7 @@ sweep_instance_heap(gc_heap_t *heap)
 static int
 add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
 {
-    mark_node_t *mark_node = NULL, *new_node = NULL;
+    mark_node_t *stack = (mark_node_t *)heap->root_set;
     hmu_t *hmu = NULL;
 
     bh_assert(obj);
@@ -175,20 +318,10 @@ add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
     if (hmu_is_wo_marked(hmu))
         return GC_SUCCESS; /* already marked*/
 
-    mark_node = (mark_node_t *)heap->root_set;
-    if (!mark_node || mark_node->idx == mark_node->cnt) {
-        new_node = alloc_mark_node();
-        if (!new_node) {
-            LOG_ERROR("can not add obj to mark node because of mark node "
-                      "allocation failed");
-            return GC_ERROR;
-        }
-        new_node->next = mark_node;
-        heap->root_set = new_node;
-        mark_node = new_node;
-    }
+    if (push_wo_to_expand(&stack, obj) != GC_SUCCESS)
+        return GC_ERROR;
+    heap->root_set = stack;
 
-    mark_node->set[mark_node->idx++] = obj;
     hmu_mark_wo(hmu);
     return GC_SUCCESS;
 }
@@ -232,21 +365,43 @@ gc_add_root(void *heap_p, gc_object_t obj)
 }
 
 /**
- * Unmark all marked objects to do rollback
+ * Traverse the heap to unmark all marked wos
  *
- * @param heap the heap to do rollback, should be a valid instance heap
+ * @param heap should be a valid instance heap
  */
 static void
-rollback_mark(gc_heap_t *heap)
+unmark_all_wo(gc_heap_t *heap)
 {
-    mark_node_t *mark_node = NULL, *next_mark_node = NULL;
     hmu_t *cur = NULL, *end = NULL;
     hmu_type_t ut;
     gc_size_t size;
 
-    bh_assert(gci_is_heap_valid(heap));
+    cur = (hmu_t *)heap->base_addr;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    while (cur < end) {
+        ut = hmu_get_ut(cur);
+        size = hmu_get_size(cur);
+
+        if (ut == HMU_WO && hmu_is_wo_marked(cur)) {
+            hmu_unmark_wo(cur);
+#if GC_WRITE_BARRIER_ENABLED != 0
+            hmu_unmark_wo_remembered(cur);
+#endif
+        }
+
+        cur = (hmu_t *)((char *)cur + size);
+    }
+
+    bh_assert(cur == end);
+}
+
+/* Free the to-expand list of the heap */
+static void
+free_root_set(gc_heap_t *heap)
+{
+    mark_node_t *mark_node = NULL, *next_mark_node = NULL;
 
-    /* roll back*/
     mark_node = (mark_node_t *)heap->root_set;
     while (mark_node) {
         next_mark_node = mark_node->next;
@@ -255,63 +410,629 @@ rollback_mark(gc_heap_t *heap)
     }
 
     heap->root_set = NULL;
+}
 
-    /* then traverse the heap to unmark all marked wos*/
+/**
+ * Unmark all marked objects to do rollback
+ *
+ * @param heap the heap to do rollback, should be a valid instance heap
+ */
+static void
+rollback_mark(gc_heap_t *heap)
+{
+    bh_assert(gci_is_heap_valid(heap));
+
+    /* roll back*/
+    free_root_set(heap);
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    heap->is_doing_mark = 0;
+#endif
+
+    /* then traverse the heap to unmark all marked wos, all objects
+       are young after that and the next collection traces them all */
+    unmark_all_wo(heap);
+}
+
+#if GC_WRITE_BARRIER_ENABLED != 0
+/**
+ * Add the remembered marked objects to the to-expand list, so that the
+ * unmarked objects referred by them are marked, they are the old objects
+ * written since the previous collection in the minor collection, or the
+ * objects written during the incremental marking
+ *
+ * @param heap should be a valid instance heap
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+add_remembered_wo_to_expand(gc_heap_t *heap)
+{
+    mark_node_t *stack = (mark_node_t *)heap->root_set;
+    hmu_t *cur = NULL, *end = NULL;
+    gc_size_t size;
+    int ret = GC_SUCCESS;
 
     cur = (hmu_t *)heap->base_addr;
     end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
 
     while (cur < end) {
-        ut = hmu_get_ut(cur);
         size = hmu_get_size(cur);
 
-        if (ut == HMU_WO && hmu_is_wo_marked(cur)) {
-            hmu_unmark_wo(cur);
+        if (hmu_get_ut(cur) == HMU_WO && hmu_is_wo_marked(cur)
+            && hmu_is_wo_remembered(cur)) {
+            hmu_unmark_wo_remembered(cur);
+            if (push_wo_to_expand(&stack, hmu_to_obj(cur)) != GC_SUCCESS) {
+                ret = GC_ERROR;
+                break;
+            }
         }
 
         cur = (hmu_t *)((char *)cur + size);
     }
 
-    bh_assert(cur == end);
+    heap->root_set = stack;
+    return ret;
 }
+#endif
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+/* The to-expand nodes shared by the markers of a parallel marking */
+typedef struct gc_mark_pool {
+    korp_mutex lock;
+    korp_cond cond;
+    mark_node_t *nodes;
+    /* count of the markers and the markers waiting for the shared nodes */
+    uint32 marker_num;
+    uint32 idle_num;
+    /* the time to stop the marking, 0 for no limit */
+    uint64 deadline;
+    /* whether the markers should stop, it is set when all objects are
+       expanded, the deadline is reached or the marking fails */
+    uint32 is_done;
+    bool is_failed;
+} gc_mark_pool_t;
+#endif
+
+/* A marker expands the objects in its own to-expand list */
+typedef struct gc_marker {
+    gc_heap_t *heap;
+    mark_node_t *stack;
+#if GC_PARALLEL_MARK_ENABLED != 0
+    /* the shared nodes of the parallel marking, NULL if marking serially */
+    gc_mark_pool_t *pool;
+#endif
+} gc_marker_t;
+
+/* Count of the objects expanded between two checks of the deadline
+   and of the idle markers */
+#define MARK_CHECK_INTERVAL 64
 
 /**
- * Reclaim GC instance heap
+ * Mark an object and add it to the to-expand list of the marker if it
+ * hasn't been marked
  *
- * @param heap the heap to reclaim, should be a valid instance heap
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+mark_wo_to_expand(gc_marker_t *marker, gc_object_t obj)
+{
+    gc_heap_t *heap = marker->heap;
+    hmu_t *hmu = obj_to_hmu(obj);
+
+    bh_assert((gc_uint8 *)hmu >= heap->base_addr
+              && (gc_uint8 *)hmu < heap->base_addr + heap->current_size);
+    bh_assert(hmu_get_ut(hmu) == HMU_WO);
+    (void)heap;
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+    if (marker->pool) {
+        /* the object may be marked by other markers at the same time */
+        gc_uint32 mark_bit = (gc_uint32)1 << HMU_WO_MB_OFFSET;
+        if (BH_ATOMIC_32_FETCH_OR(hmu->header, mark_bit) & mark_bit)
+            return GC_SUCCESS; /* already marked*/
+    }
+    else
+#endif
+    {
+        if (hmu_is_wo_marked(hmu))
+            return GC_SUCCESS; /* already marked*/
+        hmu_mark_wo(hmu);
+    }
+
+    return push_wo_to_expand(&marker->stack, obj);
+}
+
+/**
+ * Mark the objects referred by a marked object
  *
- * @return GC_SUCCESS if success, GC_ERROR otherwise
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
  */
 static int
-reclaim_instance_heap(gc_heap_t *heap)
+expand_wo(gc_marker_t *marker, gc_object_t obj)
 {
-    mark_node_t *mark_node = NULL;
-    int idx = 0, j = 0;
-    bool ret, is_compact_mode = false;
-    gc_object_t obj = NULL, ref = NULL;
-    hmu_t *hmu = NULL;
-    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0;
+    bool is_compact_mode = false;
+    gc_object_t ref = NULL;
+    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0, j;
     gc_uint16 *ref_list = NULL;
 
-    bh_assert(gci_is_heap_valid(heap));
+    size = hmu_get_size(obj_to_hmu(obj));
+
+    if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                         &ref_list, &ref_start_offset)) {
+        LOG_ERROR("mark process failed because failed "
+                  "vm_get_wasm_object_ref_list");
+        return GC_ERROR;
+    }
+
+    if (ref_num >= 2U * GB) {
+        LOG_ERROR("Invalid ref_num returned");
+        return GC_ERROR;
+    }
+
+    for (j = 0; j < ref_num; j++) {
+        offset = is_compact_mode ? ref_start_offset + j * sizeof(void *)
+                                 : ref_list[j];
+        bh_assert(offset + sizeof(void *) < size);
+
+        ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+        if (ref == NULL_REF || ((uintptr_t)ref & 1))
+            continue; /* null object or i31 object */
+        if (mark_wo_to_expand(marker, ref) == GC_ERROR) {
+            LOG_ERROR("mark process failed");
+            return GC_ERROR;
+        }
+    }
+
+    (void)size;
+    return GC_SUCCESS;
+}
+
+/**
+ * Expand the objects in the to-expand list of the marker until the list
+ * is empty or the deadline is reached
+ *
+ * @param deadline the time to stop, 0 for no limit
+ * @param is_sharing whether to stop once the list has more than one node,
+ *        whose objects can be shared with other markers
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+expand_serially(gc_marker_t *marker, uint64 deadline, bool is_sharing)
+{
+    gc_object_t obj;
+    uint32 count = 0;
+
+    while ((obj = pop_wo_to_expand(&marker->stack))) {
+        if (expand_wo(marker, obj) != GC_SUCCESS)
+            return GC_ERROR;
+
+        if (is_sharing && marker->stack->next)
+            break;
+
+        if (deadline && ++count % MARK_CHECK_INTERVAL == 0
+            && os_time_get_boot_us() >= deadline)
+            break;
+    }
+
+    return GC_SUCCESS;
+}
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+/* Stop all markers of the parallel marking */
+static void
+stop_markers(gc_mark_pool_t *pool, bool is_failed)
+{
+    os_mutex_lock(&pool->lock);
+    BH_ATOMIC_32_STORE(pool->is_done, 1);
+    if (is_failed)
+        pool->is_failed = true;
+    os_cond_broadcast(&pool->cond);
+    os_mutex_unlock(&pool->lock);
+}
+
+/* Move a node of the to-expand list of the marker to the shared nodes if
+   some markers are waiting for them */
+static void
+share_mark_node(gc_marker_t *marker)
+{
+    gc_mark_pool_t *pool = marker->pool;
+    mark_node_t *mark_node = marker->stack, *shared = NULL;
+    uint32 n;
+
+    if (BH_ATOMIC_32_LOAD(pool->idle_num) == 0 || !mark_node)
+        return;
+
+    if (mark_node->next) {
+        /* the nodes except the first one are full */
+        shared = mark_node->next;
+        mark_node->next = shared->next;
+    }
+    else if (mark_node->idx > 1) {
+        /* split the node */
+        if (!(shared = alloc_mark_node()))
+            return;
+        n = mark_node->idx / 2;
+        mark_node->idx -= n;
+        bh_memcpy_s(shared->set, (uint32)sizeof(shared->set),
+                    mark_node->set + mark_node->idx,
+                    (uint32)(n * sizeof(gc_object_t)));
+        shared->idx = n;
+    }
+    else {
+        return;
+    }
+
+    os_mutex_lock(&pool->lock);
+    shared->next = pool->nodes;
+    pool->nodes = shared;
+    os_cond_signal(&pool->cond);
+    os_mutex_unlock(&pool->lock);
+}
+
+/* Wait for a shared node and move it to the to-expand list of the marker,
+   return false if the marker should stop */
+static bool
+take_mark_node(gc_marker_t *marker)
+{
+    gc_mark_pool_t *pool = marker->pool;
+    mark_node_t *mark_node = NULL;
+
+    os_mutex_lock(&pool->lock);
+    BH_ATOMIC_32_FETCH_ADD(pool->idle_num, 1);
+    while (!pool->nodes && !pool->is_done) {
+        if (pool->idle_num == pool->marker_num) {
+            /* no marker has objects to expand */
+            BH_ATOMIC_32_STORE(pool->is_done, 1);
+            os_cond_broadcast(&pool->cond);
+            break;
+        }
+        os_cond_wait(&pool->cond, &pool->lock);
+    }
+    if (pool->nodes && !pool->is_done) {
+        mark_node = pool->nodes;
+        pool->nodes = mark_node->next;
+        mark_node->next = marker->stack;
+        marker->stack = mark_node;
+        BH_ATOMIC_32_FETCH_SUB(pool->idle_num, 1);
+    }
+    os_mutex_unlock(&pool->lock);
+
+    return mark_node != NULL;
+}
 
+static void *
+expand_in_parallel(void *arg)
+{
+    gc_marker_t *marker = (gc_marker_t *)arg;
+    gc_mark_pool_t *pool = marker->pool;
+    gc_object_t obj;
+    uint32 count = 0;
+
+    do {
+        while ((obj = pop_wo_to_expand(&marker->stack))) {
+            if (expand_wo(marker, obj) != GC_SUCCESS) {
+                stop_markers(pool, true);
+                return NULL;
+            }
+
+            if (++count % MARK_CHECK_INTERVAL == 0) {
+                if (BH_ATOMIC_32_LOAD(pool->is_done))
+                    return NULL;
+                if (pool->deadline && os_time_get_boot_us() >= pool->deadline) {
+                    stop_markers(pool, false);
+                    return NULL;
+                }
+                share_mark_node(marker);
+            }
+        }
+    } while (take_mark_node(marker));
+
+    return NULL;
+}
+
+/* The helper threads of the parallel marking of a heap, they are started
+   in the first parallel marking and wait for the next one after a marking
+   is done, until the heap is destroyed */
+typedef struct gc_mark_helpers {
+    /* the shared nodes of the current marking, the lock of it also
+       protects the fields below */
+    gc_mark_pool_t pool;
+    /* the helpers wait on it for a new marking, and the thread doing the
+       marking waits on it for the helpers to finish */
+    korp_cond cond;
+    korp_tid tids[GC_PARALLEL_MARK_THREAD_NUM];
+    gc_marker_t markers[GC_PARALLEL_MARK_THREAD_NUM];
+    uint32 thread_num;
+    /* sequence number of the markings and count of the helpers which
+       haven't finished the current one */
+    uint32 mark_seq;
+    uint32 busy_num;
+    bool is_exiting;
+} gc_mark_helpers_t;
+
+static void *
+run_mark_helper(void *arg)
+{
+    gc_marker_t *marker = (gc_marker_t *)arg;
+    /* the pool is the first field of the helpers */
+    gc_mark_helpers_t *helpers = (gc_mark_helpers_t *)marker->pool;
+    uint32 mark_seq = 0;
+
+    os_mutex_lock(&helpers->pool.lock);
+    while (true) {
+        while (helpers->mark_seq == mark_seq && !helpers->is_exiting)
+            os_cond_wait(&helpers->cond, &helpers->pool.lock);
+        if (helpers->is_exiting)
+            break;
+        mark_seq = helpers->mark_seq;
+        os_mutex_unlock(&helpers->pool.lock);
+
+        expand_in_parallel(marker);
+
+        os_mutex_lock(&helpers->pool.lock);
+        if (--helpers->busy_num == 0)
+            os_cond_broadcast(&helpers->cond);
+    }
+    os_mutex_unlock(&helpers->pool.lock);
+
+    return NULL;
+}
+
+static gc_mark_helpers_t *
+create_mark_helpers(void)
+{
+    gc_mark_helpers_t *helpers;
+    uint32 i;
+
+    if (!(helpers = BH_MALLOC(sizeof(gc_mark_helpers_t))))
+        return NULL;
+    memset(helpers, 0, sizeof(gc_mark_helpers_t));
+
+    if (os_mutex_init(&helpers->pool.lock) != BHT_OK)
+        goto fail1;
+    if (os_cond_init(&helpers->pool.cond) != BHT_OK)
+        goto fail2;
+    if (os_cond_init(&helpers->cond) != BHT_OK)
+        goto fail3;
+
+    /* the marking is done with the helpers created even if some of them
+       fail to be created */
+    for (i = 0; i < GC_PARALLEL_MARK_THREAD_NUM; i++) {
+        helpers->markers[i].pool = &helpers->pool;
+        if (os_thread_create(&helpers->tids[i], run_mark_helper,
+                             &helpers->markers[i],
+                             APP_THREAD_STACK_SIZE_DEFAULT)
+            != BHT_OK)
+            break;
+        helpers->thread_num++;
+    }
+
+    return helpers;
+
+fail3:
+    os_cond_destroy(&helpers->pool.cond);
+fail2:
+    os_mutex_destroy(&helpers->pool.lock);
+fail1:
+    BH_FREE(helpers);
+    return NULL;
+}
+
+void
+gci_destroy_mark_helpers(gc_heap_t *heap)
+{
+    gc_mark_helpers_t *helpers = heap->mark_helpers;
+    uint32 i;
+
+    if (!helpers)
+        return;
+
+    os_mutex_lock(&helpers->pool.lock);
+    helpers->is_exiting = true;
+    os_cond_broadcast(&helpers->cond);
+    os_mutex_unlock(&helpers->pool.lock);
+
+    for (i = 0; i < helpers->thread_num; i++) {
+        os_thread_join(helpers->tids[i], NULL);
+    }
+
+    os_cond_destroy(&helpers->cond);
+    os_cond_destroy(&helpers->pool.cond);
+    os_mutex_destroy(&helpers->pool.lock);
+    BH_FREE(helpers);
+    heap->mark_helpers = NULL;
+}
+
+/**
+ * Expand the objects in the to-expand list of the heap with the helper
+ * markers until the list is empty or the deadline is reached, the objects
+ * not expanded are added back to the list
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+expand_with_helpers(gc_heap_t *heap, uint64 deadline)
+{
+    gc_mark_helpers_t *helpers = heap->mark_helpers;
+    gc_mark_pool_t *pool;
+    gc_marker_t marker = { 0 };
+    uint32 i;
+
+    if (!helpers && !(helpers = heap->mark_helpers = create_mark_helpers()))
+        return GC_ERROR;
+    pool = &helpers->pool;
+
+    /* start the helpers */
+    os_mutex_lock(&pool->lock);
+    pool->nodes = NULL;
+    pool->marker_num = helpers->thread_num + 1;
+    pool->idle_num = 0;
+    pool->deadline = deadline;
+    pool->is_done = 0;
+    pool->is_failed = false;
+    for (i = 0; i < helpers->thread_num; i++) {
+        helpers->markers[i].heap = heap;
+        helpers->markers[i].stack = NULL;
+    }
+    helpers->busy_num = helpers->thread_num;
+    helpers->mark_seq++;
+    os_cond_broadcast(&helpers->cond);
+    os_mutex_unlock(&pool->lock);
+
+    /* the current thread is the first marker */
+    marker.heap = heap;
+    marker.pool = pool;
+    marker.stack = (mark_node_t *)heap->root_set;
     heap->root_set = NULL;
+    expand_in_parallel(&marker);
+
+    os_mutex_lock(&pool->lock);
+    while (helpers->busy_num > 0)
+        os_cond_wait(&helpers->cond, &pool->lock);
+    os_mutex_unlock(&pool->lock);
+
+    append_to_root_set(heap, marker.stack);
+    for (i = 0; i < helpers->thread_num; i++) {
+        append_to_root_set(heap, helpers->markers[i].stack);
+        helpers->markers[i].stack = NULL;
+    }
+    append_to_root_set(heap, pool->nodes);
+    pool->nodes = NULL;
+
+    return pool->is_failed ? GC_ERROR : GC_SUCCESS;
+}
+#endif /* end of GC_PARALLEL_MARK_ENABLED != 0 */
+
+/**
+ * Expand the objects in the to-expand list of the heap until the list
+ * is empty or the deadline is reached
+ *
+ * @param heap should be a valid instance heap
+ * @param deadline the time to stop, 0 for no limit
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+expand_root_set(gc_heap_t *heap, uint64 deadline)
+{
+    gc_marker_t marker = { 0 };
+    int ret;
+
+    marker.heap = heap;
+    marker.stack = (mark_node_t *)heap->root_set;
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+    /* the helper markers are started only when there are enough objects
+       to share with them */
+    ret = expand_serially(&marker, deadline, true);
+    heap->root_set = marker.stack;
+
+    if (ret == GC_SUCCESS && marker.stack && marker.stack->next
+        && (!deadline || os_time_get_boot_us() < deadline))
+        ret = expand_with_helpers(heap, deadline);
+#else
+    ret = expand_serially(&marker, deadline, false);
+    heap->root_set = marker.stack;
+#endif
+
+    return ret;
+}
+
+/* Whether the rootset of the heap can be enumerated */
+static bool
+has_root_set(gc_heap_t *heap)
+{
+#if WASM_ENABLE_THREAD_MGR == 0
+    return heap->exec_env != NULL;
+#else
+    return heap->cluster != NULL;
+#endif
+}
+
+/**
+ * Add the rootset to the to-expand list
+ *
+ * @param heap should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+add_root_set_to_expand(gc_heap_t *heap)
+{
+    bool ret;
 
 #if WASM_ENABLE_THREAD_MGR == 0
-    if (!heap->exec_env)
-        return GC_SUCCESS;
     ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
 #else
-    if (!heap->cluster)
-        return GC_SUCCESS;
     ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
 #endif
     if (!ret)
         return GC_ERROR;
 
+    /* TODO: when fast marking failed, we can still do slow
+       marking, currently just simply roll it back.  */
+    if (heap->is_fast_marking_failed) {
+        LOG_ERROR("enumerate rootset failed");
+        heap->is_fast_marking_failed = 0;
+        return GC_ERROR;
+    }
+
+    return GC_SUCCESS;
+}
+
+/**
+ * Begin the marking of a collection by marking the rootset
+ *
+ * @param heap should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+begin_mark(gc_heap_t *heap)
+{
 #if BH_ENABLE_GC_VERIFY != 0
-    /* no matter whether the enumeration is successful or not, the data
-       collected should be checked at first */
+    mark_node_t *mark_node = NULL;
+    gc_object_t obj = NULL;
+    hmu_t *hmu = NULL;
+    int idx = 0;
+#endif
+
+    heap->root_set = NULL;
+
+#if GC_GENERATIONAL_ENABLED != 0
+    /* The live objects stay marked after the sweep phase, they are old
+       objects and aren't traced again in the minor collection except the
+       remembered ones. The major collection unmarks them all to trace the
+       whole heap and to reclaim the dead old objects. */
+    heap->is_last_gc_minor = !heap->is_major_gc_required
+                             && heap->minor_gc_count < GC_MINOR_GC_MAX_COUNT;
+    if (heap->is_last_gc_minor) {
+        heap->minor_gc_count++;
+        if (add_remembered_wo_to_expand(heap) != GC_SUCCESS)
+            heap->is_fast_marking_failed = 1;
+    }
+    else {
+        heap->is_major_gc_required = 0;
+        heap->minor_gc_count = 0;
+        unmark_all_wo(heap);
+    }
+#endif
+
+    if (add_root_set_to_expand(heap) != GC_SUCCESS) {
+        LOG_ERROR("all marked wos will be unmarked to keep heap consistency");
+        rollback_mark(heap);
+        return GC_ERROR;
+    }
+
+#if BH_ENABLE_GC_VERIFY != 0
+    /* the data collected should be checked at first */
     mark_node = (mark_node_t *)heap->root_set;
     while (mark_node) {
         /* all nodes except first should be full filled */
@@ -334,104 +1055,85 @@ reclaim_instance_heap(gc_heap_t *heap)
     }
 #endif
 
-    /* TODO: when fast marking failed, we can still do slow
-       marking, currently just simply roll it back.  */
-    if (heap->is_fast_marking_failed) {
-        LOG_ERROR("enumerate rootset failed");
-        LOG_ERROR("all marked wos will be unmarked to keep heap consistency");
+    return GC_SUCCESS;
+}
 
-        rollback_mark(heap);
-        heap->is_fast_marking_failed = 0;
-        return GC_ERROR;
+/**
+ * Finish the marking of a collection and sweep the heap
+ *
+ * @param heap should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+finish_collection(gc_heap_t *heap)
+{
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    if (heap->is_doing_mark) {
+        /* The application has run since the marking began, the rootset
+           is marked again, and the marked objects written since then are
+           expanded again as they may refer to unmarked objects */
+        heap->is_doing_mark = 0;
+        if (add_remembered_wo_to_expand(heap) != GC_SUCCESS
+            || add_root_set_to_expand(heap) != GC_SUCCESS) {
+            rollback_mark(heap);
+            return GC_ERROR;
+        }
     }
+#endif
 
     /* the algorithm we use to mark all objects */
     /* 1. mark rootset and organize them into a mark_node list (last marked
      * roots at list header, i.e. stack top) */
-    /* 2. in every iteration, we use the top node to expand*/
+    /* 2. in every iteration, we pop an object from the stack top to expand
+     * and push the objects it refers */
     /* 3. execute step 2 till no expanding */
-    /* this is a BFS & DFS mixed algorithm, but more like DFS */
-    mark_node = (mark_node_t *)heap->root_set;
-    while (mark_node) {
-        heap->root_set = mark_node->next;
-
-        /* note that mark_node->idx may change in each loop */
-        for (idx = 0; idx < (int)mark_node->idx; idx++) {
-            obj = mark_node->set[idx];
-            hmu = obj_to_hmu(obj);
-            size = hmu_get_size(hmu);
-
-            if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode,
-                                                 &ref_num, &ref_list,
-                                                 &ref_start_offset)) {
-                LOG_ERROR("mark process failed because failed "
-                          "vm_get_wasm_object_ref_list");
-                break;
-            }
-
-            if (ref_num >= 2U * GB) {
-                LOG_ERROR("Invalid ref_num returned");
-                break;
-            }
-
-            if (is_compact_mode) {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_start_offset + j * sizeof(void *);
-                    bh_assert(offset + sizeof(void *) < size);
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("add_wo_to_expand failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
-            else {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_list[j];
-                    bh_assert(offset + sizeof(void *) < size);
-
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("mark process failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
-        }
-        if (idx < (int)mark_node->idx)
-            break; /* not yet done */
-
-        /* obj's in mark_node are all expanded */
-        free_mark_node(mark_node);
-        mark_node = heap->root_set;
-    }
-
-    if (mark_node) {
+    if (expand_root_set(heap, 0) != GC_SUCCESS) {
         LOG_ERROR("mark process is not successfully finished");
 
-        free_mark_node(mark_node);
         /* roll back is required */
         rollback_mark(heap);
 
         return GC_ERROR;
     }
 
+    bh_assert(!heap->root_set);
+
     /* now sweep */
     sweep_instance_heap(heap);
 
-    (void)size;
-
     return GC_SUCCESS;
 }
 
+/**
+ * Reclaim GC instance heap
+ *
+ * @param heap the heap to reclaim, should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+reclaim_instance_heap(gc_heap_t *heap)
+{
+    bh_assert(gci_is_heap_valid(heap));
+
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    /* finish the incremental marking in progress */
+    if (heap->is_doing_mark)
+        return finish_collection(heap);
+#endif
+
+    heap->root_set = NULL;
+
+    if (!has_root_set(heap))
+        return GC_SUCCESS;
+
+    if (begin_mark(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    return finish_collection(heap);
+}
+
 /**
  * Do GC on given heap
  *
@@ -479,12 +1181,84 @@ gci_gc_heap(void *h)
     return ret;
 }
 
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+/**
+ * Do a step of the incremental marking on given heap, which begins the
+ * marking if it isn't in progress and finishes the collection once all
+ * objects are expanded
+ *
+ * @param the heap to do GC, should be a valid heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gci_gc_heap_step(void *h)
+{
+    int ret = GC_SUCCESS;
+    gc_heap_t *heap = (gc_heap_t *)h;
+    uint64 deadline;
+
+    bh_assert(gci_is_heap_valid(heap));
+
+    gct_vm_gc_prepare(NULL);
+
+    gct_vm_mutex_lock(&heap->lock);
+    heap->is_doing_reclaim = 1;
+
+    deadline = os_time_get_boot_us() + GC_INCREMENTAL_MARK_TIME_BUDGET;
+
+    if (!heap->is_doing_mark && has_root_set(heap)) {
+        if ((ret = begin_mark(heap)) == GC_SUCCESS)
+            heap->is_doing_mark = 1;
+    }
+
+    if (heap->is_doing_mark) {
+        if ((ret = expand_root_set(heap, deadline)) != GC_SUCCESS)
+            rollback_mark(heap);
+        else if (!heap->root_set)
+            ret = finish_collection(heap);
+    }
+
+    /* the next step is done after 1/8 of the free space is allocated */
+    heap->mark_step_free_size =
+        heap->total_free_size - heap->total_free_size / 8;
+
+    heap->is_doing_reclaim = 0;
+    gct_vm_mutex_unlock(&heap->lock);
+
+    gct_vm_gc_finished(NULL);
+
+    return ret;
+}
+
+void
+gci_free_mark_stack(gc_heap_t *heap)
+{
+    free_root_set(heap);
+    heap->is_doing_mark = 0;
+}
+#endif /* end of GC_INCREMENTAL_MARK_ENABLED != 0 */
+
 int
 gc_is_dead_object(void *obj)
 {
     return !hmu_is_wo_marked(obj_to_hmu(obj));
 }
 
+/* Check ems_gc.h for description*/
+void
+gc_write_barrier(gc_object_t obj)
+{
+#if GC_WRITE_BARRIER_ENABLED != 0
+    hmu_t *hmu = obj_to_hmu(obj);
+
+    if (hmu_is_wo_marked(hmu) && !hmu_is_wo_remembered(hmu))
+        hmu_mark_wo_remembered(hmu);
+#else
+    (void)obj;
+#endif
+}
+
 #else
 
 int
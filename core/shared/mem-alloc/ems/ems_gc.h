@@ -67,6 +67,10 @@ typedef enum {
     GC_STAT_HIGHMARK,
     GC_STAT_COUNT,
     GC_STAT_TIME,
+    GC_STAT_MAX_SIZE,
+    GC_STAT_GROW_COUNT,
+    GC_STAT_SHRINK_COUNT,
+    GC_STAT_MAX_TIME,
     GC_STAT_MAX
 } GC_STAT_INDEX;
 
@@ -114,6 +118,21 @@ gc_handle_t
 gc_init_with_struct_and_pool(char *struct_buf, gc_size_t struct_buf_size,
                              char *pool_buf, gc_size_t pool_buf_size);
 
+#if WASM_ENABLE_GC != 0
+/**
+ * GC initialization of a growable heap, the address space of max_size
+ * is reserved for the heap and its pages are committed as it grows
+ *
+ * @param init_size the initial size of the heap
+ * @param max_size the max size which the heap can grow to
+ *
+ * @return gc handle if success, NULL if failed or the platform
+ *         doesn't support it
+ */
+gc_handle_t
+gc_init_growable(gc_size_t init_size, gc_size_t max_size);
+#endif
+
 /**
  * Destroy heap which is initilized from a buffer
  *
@@ -147,6 +166,29 @@ gc_enable_gc_reclaim(gc_handle_t handle, void *cluster);
 #endif
 #endif
 
+/**
+ * Enable the per-thread caches of small VM objects for a heap, the objects
+ * freed by a thread are kept in its cache and reused by its allocations
+ * without locking the heap. It is meant for the heap shared by all threads,
+ * i.e. the global pool, only one heap can have the caches at a time: the
+ * blocks cached for the previous heap are dropped when the thread uses the
+ * caches of a new one. The cached blocks are counted as allocated in the
+ * heap stats.
+ *
+ * @param handle handle of the heap
+ */
+void
+gc_enable_thread_cache(gc_handle_t handle);
+
+/**
+ * Return the blocks in the cache of the current thread to the heap, it
+ * should be called before the thread exits.
+ *
+ * @param handle handle of the heap
+ */
+void
+gc_flush_thread_cache(gc_handle_t handle);
+
 /**
  * Return heap struct size
  */
@@ -165,6 +207,22 @@ gc_get_heap_struct_size(void);
 int
 gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size);
 
+/**
+ * Restore the heap from a copy of its heap structure and its pool buffer
+ * content, e.g. saved by another process, whose pool buffer may have been
+ * placed at a different address
+ *
+ * @param handle handle of the heap created in the new pool buffer
+ * @param heap_struct the saved heap struct, of gc_get_heap_struct_size bytes
+ * @param pool_buf the new pool buffer, which holds the saved pool content
+ * @param pool_buf_size the size of new pool buffer
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_restore(gc_handle_t handle, const void *heap_struct, char *pool_buf,
+           gc_size_t pool_buf_size);
+
 /**
  * Check whether the heap is corrupted
  *
@@ -257,6 +315,15 @@ gc_free_wo_internal(void *vheap, void *ptr, const char *file, int line);
 int
 gc_add_root(void *heap, gc_object_t obj);
 
+/**
+ * Write barrier of the generational collection, it must be called after
+ * a reference to another gc object is stored into the object.
+ *
+ * @param obj pointer to a valid WASM object managed by the gc heap.
+ */
+void
+gc_write_barrier(gc_object_t obj);
+
 int
 gci_gc_heap(void *heap);
 
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "bh_platform.h"
+#include "bh_atomic.h"
 #include "ems_gc.h"
 
 /* HMU (heap memory unit) basic block type */
@@ -79,6 +80,68 @@ hmu_verify(void *vheap, hmu_t *hmu);
 
 #define hmu_obj_size(s) ((s)-OBJ_EXTRA_SIZE)
 
+/* The per-thread caches require the thread local storage, and they are
+   disabled when verifying the heap since the cached blocks look leaked */
+#if GC_THREAD_CACHE_MAX_SIZE > 0 && defined(os_thread_local_attribute) \
+    && BH_ENABLE_GC_VERIFY == 0
+#define GC_THREAD_CACHE_ENABLED 1
+#else
+#define GC_THREAD_CACHE_ENABLED 0
+#endif
+
+/* The slab lists are disabled when verifying the heap as the blocks in
+   them aren't merged into the free chunks */
+#if GC_SLAB_MAX_SIZE > 0 && BH_ENABLE_GC_VERIFY == 0
+#define GC_SLAB_ENABLED 1
+/* The slab lists are indexed by the hmu size / 8 */
+#define GC_SLAB_LIST_NUM ((GC_SLAB_MAX_SIZE >> 3) + 1)
+#else
+#define GC_SLAB_ENABLED 0
+#endif
+
+/* The objects marked in a collection stay marked as the old objects until
+   the next major collection, which isn't supported when the objects are
+   freed manually */
+#if WASM_ENABLE_GC != 0 && GC_MINOR_GC_MAX_COUNT > 0 && GC_MANUALLY == 0
+#define GC_GENERATIONAL_ENABLED 1
+#else
+#define GC_GENERATIONAL_ENABLED 0
+#endif
+
+/* The objects are marked by the markers of a collection concurrently,
+   which requires the atomic operations on the hmu header */
+#if WASM_ENABLE_GC != 0 && GC_PARALLEL_MARK_THREAD_NUM > 0 \
+    && BH_ATOMIC_32_IS_ATOMIC != 0
+#define GC_PARALLEL_MARK_ENABLED 1
+#else
+#define GC_PARALLEL_MARK_ENABLED 0
+#endif
+
+/* The application runs between the marking steps, the freed objects may
+   still be in the to-expand list when they are freed manually */
+#if WASM_ENABLE_GC != 0 && GC_INCREMENTAL_MARK_TIME_BUDGET > 0 \
+    && GC_MANUALLY == 0
+#define GC_INCREMENTAL_MARK_ENABLED 1
+#else
+#define GC_INCREMENTAL_MARK_ENABLED 0
+#endif
+
+/* The growable heap reserves the address space of its max size and
+   commits the pages as it grows, which requires the virtual memory APIs
+   of the platforms supporting the hardware bound check */
+#if WASM_ENABLE_GC != 0 && defined(OS_ENABLE_HW_BOUND_CHECK)
+#define GC_HEAP_RESIZE_ENABLED 1
+#else
+#define GC_HEAP_RESIZE_ENABLED 0
+#endif
+
+/* Whether the objects written are remembered by the write barrier */
+#if GC_GENERATIONAL_ENABLED != 0 || GC_INCREMENTAL_MARK_ENABLED != 0
+#define GC_WRITE_BARRIER_ENABLED 1
+#else
+#define GC_WRITE_BARRIER_ENABLED 0
+#endif
+
 #define GC_ALIGN_8(s) (((uint32)(s) + 7) & (uint32)~7)
 
 #define GC_SMALLEST_SIZE \
@@ -143,6 +206,14 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #define hmu_unmark_wo(hmu) CLRBIT((hmu)->header, HMU_WO_MB_OFFSET)
 #define hmu_is_wo_marked(hmu) GETBIT((hmu)->header, HMU_WO_MB_OFFSET)
 
+/* R bit means the old (marked) object has been written since the previous
+   collection and may refer to young objects, see gc_write_barrier */
+#define HMU_WO_RB_OFFSET 27
+
+#define hmu_mark_wo_remembered(hmu) SETBIT((hmu)->header, HMU_WO_RB_OFFSET)
+#define hmu_unmark_wo_remembered(hmu) CLRBIT((hmu)->header, HMU_WO_RB_OFFSET)
+#define hmu_is_wo_remembered(hmu) GETBIT((hmu)->header, HMU_WO_RB_OFFSET)
+
 /**
  * The hmu size is divisible by 8, its lowest 3 bits are 0, so we only
  * store its higher bits of bit [29..3], and bit [2..0] are not stored.
@@ -155,6 +226,7 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #define HMU_VO_FB_OFFSET 28
 
 #define hmu_is_vo_freed(hmu) GETBIT((hmu)->header, HMU_VO_FB_OFFSET)
+#define hmu_free_vo(hmu) SETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 #define hmu_unfree_vo(hmu) CLRBIT((hmu)->header, HMU_VO_FB_OFFSET)
 
 #define hmu_get_size(hmu) \
@@ -271,6 +343,14 @@ typedef struct gc_heap_struct {
          size[left] <= size[cur] < size[right] */
     hmu_tree_node_t *kfc_tree_root;
 
+#if GC_SLAB_ENABLED != 0
+    /* the lists of the freed VM objects which are not merged into the
+       free chunks, of the same hmu size each, a node is the offset of the
+       object to base_addr (0 for the end of list) so that the heap can be
+       migrated, and the next node is stored in the object */
+    gc_uint32 slab_lists[GC_SLAB_LIST_NUM];
+#endif
+
 #if WASM_ENABLE_GC != 0
     /* for rootset enumeration of private heap*/
     void *root_set;
@@ -296,6 +376,50 @@ typedef struct gc_heap_struct {
 
     /* Whether the heap can do reclaim */
     unsigned is_reclaim_enabled : 1;
+
+#if GC_GENERATIONAL_ENABLED != 0
+    /* whether the last collection is a minor collection */
+    unsigned is_last_gc_minor : 1;
+
+    /* whether the next collection must be a major collection */
+    unsigned is_major_gc_required : 1;
+
+    /* count of the minor collections since the last major collection */
+    gc_uint32 minor_gc_count;
+#endif
+
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    /* whether the incremental marking is in progress */
+    unsigned is_doing_mark : 1;
+
+    /* the next marking step is done when the free size is less than it */
+    gc_size_t mark_step_free_size;
+#endif
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+    /* the helper threads of the parallel marking, created lazily */
+    struct gc_mark_helpers *mark_helpers;
+#endif
+
+#if GC_HEAP_RESIZE_ENABLED != 0
+    /* size of the address space reserved for the growable heap, which
+       begins with the heap structure, 0 if the heap can't grow */
+    gc_size_t reserved_size;
+
+    /* the heap is resized between min_size and max_size */
+    gc_size_t min_size;
+    gc_size_t max_size;
+
+    /* times the heap has grown and shrunk */
+    gc_size_t grow_count;
+    gc_size_t shrink_count;
+
+    /* collections done since the heap grew last time */
+    gc_size_t gc_count_since_grow;
+
+    /* the time when the previous collection was done */
+    uint64 last_gc_time;
+#endif
 #endif
 
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -304,6 +428,12 @@ typedef struct gc_heap_struct {
     bool is_heap_corrupted;
 #endif
 
+#if GC_THREAD_CACHE_ENABLED != 0
+    /* id of the per-thread caches of the heap, 0 if they are disabled,
+       see gc_enable_thread_cache */
+    gc_uint32 thread_cache_id;
+#endif
+
     gc_size_t init_size;
     gc_size_t highmark_size;
     gc_size_t total_free_size;
@@ -313,6 +443,7 @@ typedef struct gc_heap_struct {
     gc_size_t gc_threshold_factor;
     gc_size_t total_gc_count;
     gc_size_t total_gc_time;
+    /* the longest pause, a collection or a step of the marking */
     gc_size_t max_gc_time;
     /* Usually there won't be too many extra info node, so we try to use a fixed
      * array to store them, if the fixed array don't have enough space to store
@@ -377,6 +508,46 @@ gci_verify_heap(gc_heap_t *heap);
 void
 gci_dump(gc_heap_t *heap);
 
+#if GC_HEAP_RESIZE_ENABLED != 0
+/**
+ * Grow the growable heap by size bytes at least and add the new pages to
+ * the free chunks, the heap must have been locked
+ */
+bool
+gci_grow_heap(gc_heap_t *heap, gc_size_t size);
+
+/**
+ * Shrink the growable heap towards new_size and release the pages after
+ * the new end, the blocks from tail to the end of the heap must be free
+ * and not in the free chunks. Return the new end of the heap, which is
+ * either tail or large enough for the free block from tail.
+ */
+gc_uint8 *
+gci_shrink_heap(gc_heap_t *heap, gc_uint8 *tail, gc_size_t new_size);
+#endif
+
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+/**
+ * Do a step of the incremental marking
+ */
+int
+gci_gc_heap_step(void *heap);
+
+/**
+ * Free the to-expand list of the incremental marking in progress
+ */
+void
+gci_free_mark_stack(gc_heap_t *heap);
+#endif
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+/**
+ * Stop the helper threads of the parallel marking and free them
+ */
+void
+gci_destroy_mark_helpers(gc_heap_t *heap);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -128,6 +128,163 @@ gc_init_with_struct_and_pool(char *struct_buf, gc_size_t struct_buf_size,
     return gc_init_internal(heap, base_addr, heap_max_size);
 }
 
+#if GC_HEAP_RESIZE_ENABLED != 0
+/* Commit the pages of the address space reserved for the heap */
+static bool
+commit_heap_pages(gc_uint8 *addr, size_t size)
+{
+#ifdef BH_PLATFORM_WINDOWS
+    if (!os_mem_commit(addr, size, MMAP_PROT_READ | MMAP_PROT_WRITE))
+        return false;
+#endif
+    return os_mprotect(addr, size, MMAP_PROT_READ | MMAP_PROT_WRITE) == 0;
+}
+
+/* Return the pages to the system and keep the address space reserved */
+static void
+decommit_heap_pages(gc_uint8 *addr, size_t size)
+{
+#ifdef BH_PLATFORM_WINDOWS
+    os_mem_decommit(addr, size);
+#else
+    os_mem_discard(addr, size);
+    os_mprotect(addr, size, MMAP_PROT_NONE);
+#endif
+}
+
+/* Get the end of the pages committed for the heap of the size */
+static gc_uint8 *
+get_commit_end(gc_heap_t *heap, gc_size_t heap_size)
+{
+    uintptr_t page_size = (uintptr_t)os_getpagesize();
+    uintptr_t end = (uintptr_t)heap->base_addr + heap_size;
+
+    return (gc_uint8 *)((end + page_size - 1) & ~(page_size - 1));
+}
+#endif
+
+gc_handle_t
+gc_init_growable(gc_size_t init_size, gc_size_t max_size)
+{
+#if GC_HEAP_RESIZE_ENABLED != 0
+    uint64 page_size = (uint64)os_getpagesize();
+    uint64 reserved_size, commit_size;
+    gc_heap_t *heap;
+    char *buf;
+
+    if (init_size > max_size) {
+        LOG_ERROR("[GC_ERROR]heap init size (%" PRIu32 ") > max size (%" PRIu32
+                  ")\n",
+                  init_size, max_size);
+        return NULL;
+    }
+
+    reserved_size = ((uint64)max_size + page_size - 1) & ~(page_size - 1);
+    commit_size = ((uint64)init_size + page_size - 1) & ~(page_size - 1);
+    if (reserved_size > UINT32_MAX) {
+        LOG_ERROR("[GC_ERROR]heap max size (%" PRIu32 ") too large\n",
+                  max_size);
+        return NULL;
+    }
+
+    if (!(buf = os_mmap(NULL, (size_t)reserved_size, MMAP_PROT_NONE,
+                        MMAP_MAP_NONE, os_get_invalid_handle())))
+        return NULL;
+
+    if (!commit_heap_pages((gc_uint8 *)buf, (size_t)commit_size)
+        || !(heap = (gc_heap_t *)gc_init_with_pool(buf,
+                                                   (gc_size_t)commit_size))) {
+        os_munmap(buf, (size_t)reserved_size);
+        return NULL;
+    }
+
+    heap->reserved_size = (gc_size_t)reserved_size;
+    heap->min_size = heap->current_size;
+    heap->max_size =
+        (gc_size_t)(buf + reserved_size - (char *)heap->base_addr) & ~7U;
+    return heap;
+#else
+    (void)init_size;
+    (void)max_size;
+    return NULL;
+#endif
+}
+
+#if GC_HEAP_RESIZE_ENABLED != 0
+bool
+gci_grow_heap(gc_heap_t *heap, gc_size_t size)
+{
+    gc_uint8 *old_end = heap->base_addr + heap->current_size;
+    gc_uint8 *commit_end = get_commit_end(heap, heap->current_size);
+    gc_uint8 *commit_end_new;
+    hmu_t *hmu = (hmu_t *)old_end;
+
+    if (heap->reserved_size == 0)
+        return false;
+
+    if (size < GC_HEAP_RESIZE_STEP)
+        size = GC_HEAP_RESIZE_STEP;
+    size = GC_ALIGN_8(size);
+    if (size > heap->max_size - heap->current_size)
+        size = heap->max_size - heap->current_size;
+    if (size < GC_SMALLEST_SIZE)
+        return false;
+
+    commit_end_new = get_commit_end(heap, heap->current_size + size);
+    if (commit_end_new > commit_end
+        && !commit_heap_pages(commit_end,
+                              (size_t)(commit_end_new - commit_end)))
+        return false;
+
+    heap->current_size += size;
+    if (!gci_add_fc(heap, hmu, size))
+        return false;
+    /* the previous block is regarded as in use, the adjacent free blocks
+       are merged in the next sweep */
+    hmu_mark_pinuse(hmu);
+
+    heap->total_free_size += size;
+    heap->grow_count++;
+    heap->gc_count_since_grow = 0;
+    gc_update_threshold(heap);
+    return true;
+}
+
+gc_uint8 *
+gci_shrink_heap(gc_heap_t *heap, gc_uint8 *tail, gc_size_t new_size)
+{
+    uintptr_t page_size = (uintptr_t)os_getpagesize();
+    gc_uint8 *commit_end = get_commit_end(heap, heap->current_size);
+    gc_uint8 *end = heap->base_addr + heap->current_size;
+    gc_uint8 *commit_end_new;
+
+    bh_assert(tail >= heap->base_addr && tail <= end);
+
+    if (new_size < heap->min_size)
+        new_size = heap->min_size;
+    if (new_size < (gc_size_t)(tail - heap->base_addr))
+        new_size = (gc_size_t)(tail - heap->base_addr);
+
+    /* the pages after the new end are released, and the free block left
+       before the new end must be large enough to be added to the free
+       chunks */
+    commit_end_new = get_commit_end(heap, new_size);
+    new_size = (gc_size_t)(commit_end_new - heap->base_addr) & ~7U;
+    if (heap->base_addr + new_size > tail
+        && heap->base_addr + new_size - tail < GC_SMALLEST_SIZE) {
+        commit_end_new += page_size;
+        new_size = (gc_size_t)(commit_end_new - heap->base_addr) & ~7U;
+    }
+    if (commit_end_new >= commit_end)
+        return end;
+
+    decommit_heap_pages(commit_end_new, (size_t)(commit_end - commit_end_new));
+    heap->current_size = new_size;
+    heap->shrink_count++;
+    return heap->base_addr + new_size;
+}
+#endif
+
 int
 gc_destroy_with_pool(gc_handle_t handle)
 {
@@ -137,6 +294,15 @@ gc_destroy_with_pool(gc_handle_t handle)
 #if WASM_ENABLE_GC != 0
     gc_size_t i = 0;
 
+#if GC_INCREMENTAL_MARK_ENABLED != 0
+    if (heap->is_doing_mark)
+        gci_free_mark_stack(heap);
+#endif
+
+#if GC_PARALLEL_MARK_ENABLED != 0
+    gci_destroy_mark_helpers(heap);
+#endif
+
     if (heap->extra_info_node_cnt > 0) {
         for (i = 0; i < heap->extra_info_node_cnt; i++) {
             extra_info_node_t *node = heap->extra_info_nodes[i];
@@ -172,6 +338,13 @@ gc_destroy_with_pool(gc_handle_t handle)
 #endif
 
     os_mutex_destroy(&heap->lock);
+#if GC_HEAP_RESIZE_ENABLED != 0
+    if (heap->reserved_size > 0) {
+        /* the heap structure is in the reserved address space */
+        os_munmap(heap, heap->reserved_size);
+        return ret;
+    }
+#endif
     memset(heap->base_addr, 0, heap->current_size);
     memset(heap, 0, sizeof(gc_heap_t));
     return ret;
@@ -212,41 +385,17 @@ adjust_ptr(uint8 **p_ptr, intptr_t offset)
         *p_ptr = (uint8 *)((intptr_t)(*p_ptr) + offset);
 }
 
-int
-gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
+/* Adjust the pointers of the heap whose pool buffer has been moved by
+   offset, the tree nodes whose parent is old_root are the children of
+   the root node of the heap structure */
+static int
+adjust_heap_ptrs(gc_heap_t *heap, intptr_t offset, hmu_tree_node_t *old_root)
 {
-    gc_heap_t *heap = (gc_heap_t *)handle;
-    char *base_addr_new = pool_buf_new + GC_HEAD_PADDING;
-    char *pool_buf_end = pool_buf_new + pool_buf_size;
-    intptr_t offset = (uint8 *)base_addr_new - (uint8 *)heap->base_addr;
     hmu_t *cur = NULL, *end = NULL;
     hmu_tree_node_t *tree_node;
     uint8 **p_left, **p_right, **p_parent;
-    gc_size_t heap_max_size, size;
-
-    if ((((uintptr_t)pool_buf_new) & 7) != 0) {
-        LOG_ERROR("[GC_ERROR]heap migrate pool buf not 8-byte aligned\n");
-        return GC_ERROR;
-    }
-
-    heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
-
-    if (pool_buf_end < base_addr_new || heap_max_size < heap->current_size) {
-        LOG_ERROR("[GC_ERROR]heap migrate invlaid pool buf size\n");
-        return GC_ERROR;
-    }
-
-    if (offset == 0)
-        return 0;
-
-#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-    if (heap->is_heap_corrupted) {
-        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
-        return GC_ERROR;
-    }
-#endif
-
-    heap->base_addr = (uint8 *)base_addr_new;
+    gc_size_t size;
+    uint32 i;
 
     ASSERT_TREE_NODE_ALIGNED_ACCESS(heap->kfc_tree_root);
 
@@ -260,6 +409,9 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     adjust_ptr(p_right, offset);
     adjust_ptr(p_parent, offset);
 
+    for (i = 0; i < HMU_NORMAL_NODE_CNT; i++)
+        adjust_ptr((uint8 **)&heap->kfc_normal_list[i].next, offset);
+
     cur = (hmu_t *)heap->base_addr;
     end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
 
@@ -287,9 +439,11 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
                                   + offsetof(hmu_tree_node_t, parent));
             adjust_ptr(p_left, offset);
             adjust_ptr(p_right, offset);
-            if (tree_node->parent != heap->kfc_tree_root)
+            if (tree_node->parent == old_root)
                 /* The root node belongs to heap structure,
-                   it is fixed part and isn't changed. */
+                   it isn't moved with the pool buffer. */
+                tree_node->parent = heap->kfc_tree_root;
+            else
                 adjust_ptr(p_parent, offset);
         }
         cur = (hmu_t *)((char *)cur + size);
@@ -308,6 +462,95 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     return 0;
 }
 
+int
+gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    char *base_addr_new = pool_buf_new + GC_HEAD_PADDING;
+    char *pool_buf_end = pool_buf_new + pool_buf_size;
+    intptr_t offset = (uint8 *)base_addr_new - (uint8 *)heap->base_addr;
+    gc_size_t heap_max_size;
+
+    if ((((uintptr_t)pool_buf_new) & 7) != 0) {
+        LOG_ERROR("[GC_ERROR]heap migrate pool buf not 8-byte aligned\n");
+        return GC_ERROR;
+    }
+
+    heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
+
+    if (pool_buf_end < base_addr_new || heap_max_size < heap->current_size) {
+        LOG_ERROR("[GC_ERROR]heap migrate invlaid pool buf size\n");
+        return GC_ERROR;
+    }
+
+    if (offset == 0)
+        return 0;
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
+        return GC_ERROR;
+    }
+#endif
+
+    heap->base_addr = (uint8 *)base_addr_new;
+
+    return adjust_heap_ptrs(heap, offset, heap->kfc_tree_root);
+}
+
+int
+gc_restore(gc_handle_t handle, const void *heap_struct, char *pool_buf,
+           gc_size_t pool_buf_size)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    const gc_heap_t *heap_saved = (const gc_heap_t *)heap_struct;
+    char *base_addr_new = pool_buf + GC_HEAD_PADDING;
+    char *pool_buf_end = pool_buf + pool_buf_size;
+    intptr_t offset = (uint8 *)base_addr_new - (uint8 *)heap_saved->base_addr;
+    gc_size_t heap_max_size;
+
+#if WASM_ENABLE_GC != 0
+    /* The root set and the finalizers refer to the objects of the runtime
+       which saved the heap */
+    LOG_ERROR("[GC_ERROR]heap restore isn't supported by GC heap\n");
+    return GC_ERROR;
+#endif
+
+    if ((((uintptr_t)pool_buf) & 7) != 0) {
+        LOG_ERROR("[GC_ERROR]heap restore pool buf not 8-byte aligned\n");
+        return GC_ERROR;
+    }
+
+    heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
+
+    if (pool_buf_end < base_addr_new
+        || heap_max_size < heap_saved->current_size) {
+        LOG_ERROR("[GC_ERROR]heap restore invalid pool buf size\n");
+        return GC_ERROR;
+    }
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap_saved->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap restore failed.\n");
+        return GC_ERROR;
+    }
+#endif
+
+    /* Copy the fields except the lock, which is re-created, and redirect
+       the pointers to the saved heap structure to this one */
+    os_mutex_destroy(&heap->lock);
+    bh_memcpy_s(heap, sizeof(gc_heap_t), heap_saved, sizeof(gc_heap_t));
+    if (os_mutex_init(&heap->lock) != 0) {
+        memset(heap, 0, sizeof(gc_heap_t));
+        return GC_ERROR;
+    }
+    heap->heap_id = (gc_handle_t)heap;
+    heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
+    heap->base_addr = (uint8 *)base_addr_new;
+
+    return adjust_heap_ptrs(heap, offset, heap_saved->kfc_tree_root);
+}
+
 bool
 gc_is_heap_corrupted(gc_handle_t handle)
 {
@@ -452,8 +695,29 @@ gc_heap_stats(void *heap_arg, uint32 *stats, int size)
             case GC_STAT_TIME:
                 stats[i] = heap->total_gc_time;
                 break;
+            case GC_STAT_MAX_TIME:
+                stats[i] = heap->max_gc_time;
+                break;
+#endif
+            case GC_STAT_MAX_SIZE:
+#if GC_HEAP_RESIZE_ENABLED != 0
+                if (heap->reserved_size > 0) {
+                    stats[i] = heap->max_size;
+                    break;
+                }
+#endif
+                stats[i] = heap->current_size;
+                break;
+#if GC_HEAP_RESIZE_ENABLED != 0
+            case GC_STAT_GROW_COUNT:
+                stats[i] = heap->grow_count;
+                break;
+            case GC_STAT_SHRINK_COUNT:
+                stats[i] = heap->shrink_count;
+                break;
 #endif
             default:
+                stats[i] = 0;
                 break;
         }
     }
@@ -515,9 +779,9 @@ gc_dump_perf_profiling(gc_handle_t *handle)
     gc_heap_t *gc_heap_handle = (void *)handle;
     if (gc_heap_handle) {
         os_printf("\nGC performance summary\n");
-        os_printf("    Total GC time (ms): %u\n",
+        os_printf("    Total GC time (us): %u\n",
                   gc_heap_handle->total_gc_time);
-        os_printf("    Max GC time (ms): %u\n", gc_heap_handle->max_gc_time);
+        os_printf("    Max GC time (us): %u\n", gc_heap_handle->max_gc_time);
     }
     else {
         os_printf("Failed to dump GC performance\n");
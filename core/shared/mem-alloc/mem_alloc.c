@@ -58,6 +58,19 @@ mem_allocator_free(mem_allocator_t allocator, void *ptr)
 }
 
 #if WASM_ENABLE_GC != 0
+mem_allocator_t
+mem_allocator_create_growable(uint32_t init_size, uint32_t max_size)
+{
+    return gc_init_growable(init_size, max_size);
+}
+
+bool
+mem_allocator_get_gc_heap_stats(mem_allocator_t allocator, void *stats)
+{
+    gc_heap_stats((gc_handle_t)allocator, stats, GC_STAT_MAX);
+    return true;
+}
+
 void *
 mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size)
 {
@@ -92,8 +105,26 @@ mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj)
 {
     return gc_add_root((gc_handle_t)allocator, (gc_object_t)obj);
 }
+
+void
+mem_allocator_write_barrier(WASMObjectRef obj)
+{
+    gc_write_barrier((gc_object_t)obj);
+}
 #endif
 
+void
+mem_allocator_enable_thread_cache(mem_allocator_t allocator)
+{
+    gc_enable_thread_cache((gc_handle_t)allocator);
+}
+
+void
+mem_allocator_flush_thread_cache(mem_allocator_t allocator)
+{
+    gc_flush_thread_cache((gc_handle_t)allocator);
+}
+
 int
 mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
                       uint32 pool_buf_size)
@@ -101,6 +132,14 @@ mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
     return gc_migrate((gc_handle_t)allocator, pool_buf_new, pool_buf_size);
 }
 
+int
+mem_allocator_restore(mem_allocator_t allocator, const void *heap_struct,
+                      char *pool_buf, uint32 pool_buf_size)
+{
+    return gc_restore((gc_handle_t)allocator, heap_struct, pool_buf,
+                      pool_buf_size);
+}
+
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator)
 {
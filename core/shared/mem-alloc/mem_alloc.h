@@ -46,14 +46,33 @@ mem_allocator_realloc(mem_allocator_t allocator, void *ptr, uint32_t size);
 void
 mem_allocator_free(mem_allocator_t allocator, void *ptr);
 
+void
+mem_allocator_enable_thread_cache(mem_allocator_t allocator);
+
+void
+mem_allocator_flush_thread_cache(mem_allocator_t allocator);
+
 int
 mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
                       uint32 pool_buf_size);
 
+int
+mem_allocator_restore(mem_allocator_t allocator, const void *heap_struct,
+                      char *pool_buf, uint32 pool_buf_size);
+
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator);
 
 #if WASM_ENABLE_GC != 0
+/* Create a gc heap which grows from init_size to max_size, return NULL
+   if the platform doesn't support it */
+mem_allocator_t
+mem_allocator_create_growable(uint32_t init_size, uint32_t max_size);
+
+/* Get the statistics of the gc heap, see wasm_gc_heap_stats_t */
+bool
+mem_allocator_get_gc_heap_stats(mem_allocator_t allocator, void *stats);
+
 void *
 mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size);
 
@@ -73,6 +92,9 @@ mem_allocator_enable_gc_reclaim(mem_allocator_t allocator, void *cluster);
 int
 mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj);
 
+void
+mem_allocator_write_barrier(WASMObjectRef obj);
+
 bool
 mem_allocator_set_gc_finalizer(mem_allocator_t allocator, void *obj,
                                gc_finalizer_t cb, void *data);
@@ -10,6 +10,13 @@
 #include <TargetConditionals.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
 #ifndef BH_ENABLE_TRACE_MMAP
 #define BH_ENABLE_TRACE_MMAP 0
 #endif
@@ -50,13 +57,18 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     uint64 request_size, page_size;
     uint8 *addr = MAP_FAILED;
     uint32 i;
+    bool is_file_mapping = file != os_get_invalid_handle();
 
     page_size = (uint64)getpagesize();
     request_size = (size + page_size - 1) & ~(page_size - 1);
 
+    if (is_file_mapping)
+        /* The pages are shared with the page cache until written */
+        map_flags &= ~MAP_ANONYMOUS;
+
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
     /* huge page isn't supported on MacOS and NuttX */
-    if (request_size >= HUGE_PAGE_SIZE)
+    if (request_size >= HUGE_PAGE_SIZE && !is_file_mapping)
         /* apply one extra huge page */
         request_size += HUGE_PAGE_SIZE;
 #endif
@@ -162,7 +174,7 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
 
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
     /* huge page isn't supported on MacOS and NuttX */
-    if (request_size > HUGE_PAGE_SIZE) {
+    if (request_size > HUGE_PAGE_SIZE && !is_file_mapping) {
         uintptr_t huge_start, huge_end;
         size_t prefix_size = 0, suffix_size = HUGE_PAGE_SIZE;
 
@@ -277,6 +289,98 @@ os_mprotect(void *addr, size_t size, int prot)
     return mprotect(addr, request_size, map_prot);
 }
 
+int
+os_mem_discard(void *addr, size_t size)
+{
+    uint64 page_size = (uint64)getpagesize();
+    uint64 request_size = (size + page_size - 1) & ~(page_size - 1);
+
+    if (!addr)
+        return 0;
+
+#if defined(__linux__) && defined(MADV_DONTNEED)
+    /* The private anonymous pages are zero-filled on next access */
+    return madvise(addr, request_size, MADV_DONTNEED);
+#else
+    /* MADV_DONTNEED may keep the content on other systems, replace
+       the pages with new anonymous pages instead */
+    if (mmap(addr, request_size, PROT_READ | PROT_WRITE,
+             MAP_ANON | MAP_PRIVATE | MAP_FIXED, -1, 0)
+        != addr)
+        return -1;
+    return 0;
+#endif
+}
+
+os_file_handle
+os_mem_image_create(const char *name, size_t size)
+{
+#if defined(__linux__) && defined(__NR_memfd_create)
+    int fd = (int)syscall(__NR_memfd_create, name, MFD_CLOEXEC);
+
+    if (fd < 0)
+        return os_get_invalid_handle();
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return os_get_invalid_handle();
+    }
+    return fd;
+#else
+    (void)name;
+    (void)size;
+    return os_get_invalid_handle();
+#endif
+}
+
+int
+os_mem_image_write(os_file_handle file, size_t offset, const void *data,
+                   size_t size)
+{
+    const uint8 *p = data;
+    ssize_t ret;
+
+    while (size > 0) {
+        ret = pwrite(file, p, size, (off_t)offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += ret;
+        offset += (size_t)ret;
+        size -= (size_t)ret;
+    }
+    return 0;
+}
+
+void
+os_mem_image_destroy(os_file_handle file)
+{
+    if (file != os_get_invalid_handle())
+        close(file);
+}
+
+int
+os_mem_map_file(void *addr, size_t size, os_file_handle file, uint64 offset,
+                bool is_shared)
+{
+    uint64 page_size = (uint64)getpagesize();
+    int map_flags = MAP_FIXED | (is_shared ? MAP_SHARED : MAP_PRIVATE);
+
+    if (((uintptr_t)addr | (uint64)size | offset) & (page_size - 1))
+        return -1;
+
+    if (file == os_get_invalid_handle())
+        map_flags = MAP_ANON | MAP_PRIVATE | MAP_FIXED;
+
+    if (mmap(addr, size, PROT_READ | PROT_WRITE, map_flags, file,
+             (off_t)offset)
+        != addr)
+        return -1;
+    return 0;
+}
+
 void
 os_dcache_flush(void)
 {}
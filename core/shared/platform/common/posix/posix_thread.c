@@ -613,9 +613,12 @@ signal_callback(int sig_num, siginfo_t *sig_info, void *sig_ucontext)
 
     mask_signals(SIG_BLOCK);
 
-    /* Try to handle signal with the registered signal handler */
+    /* Try to handle signal with the registered signal handler, if the
+       fault is resolved (e.g. a lazily loaded AOT code page is
+       materialized), return to re-execute the faulting instruction */
     if (signal_handler && (sig_num == SIGSEGV || sig_num == SIGBUS)) {
-        signal_handler(sig_addr);
+        if (signal_handler(sig_addr))
+            return;
     }
 
     if (sig_num == SIGSEGV)
@@ -135,6 +135,9 @@ enum {
     MMAP_MAP_FIXED = 2,
 };
 
+/* Map the memory, or map the file from its beginning as a private
+   copy-on-write mapping if file isn't os_get_invalid_handle(), the latter
+   may be unsupported by the platform */
 void *
 os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file);
 void
@@ -142,6 +145,38 @@ os_munmap(void *addr, size_t size);
 int
 os_mprotect(void *addr, size_t size, int prot);
 
+/* Discard the pages of the anonymous memory mapped by os_mmap, the pages
+   are readable and writable and read as zero afterwards, and the physical
+   memory is returned to the system. It is required by the platforms which
+   define OS_ENABLE_HW_BOUND_CHECK */
+int
+os_mem_discard(void *addr, size_t size);
+
+/* Create an in-memory file of the size, whose content reads as zero until
+   written by os_mem_image_write and which can be mapped by os_mmap, return
+   os_get_invalid_handle() if it isn't supported. It is required by the
+   platforms which define OS_ENABLE_HW_BOUND_CHECK */
+os_file_handle
+os_mem_image_create(const char *name, size_t size);
+
+int
+os_mem_image_write(os_file_handle file, size_t offset, const void *data,
+                   size_t size);
+
+void
+os_mem_image_destroy(os_file_handle file);
+
+/* Map the region [offset, offset + size) of the file at addr, replacing
+   the pages of the mapping created by os_mmap there, addr, size and offset
+   must be aligned to the page size. The writes go to the file if is_shared,
+   otherwise the mapping is private copy-on-write. The pages are replaced
+   with zero-filled anonymous pages if file is os_get_invalid_handle().
+   Return 0 if success. It is required by the platforms which define
+   OS_ENABLE_HW_BOUND_CHECK, and may be unsupported */
+int
+os_mem_map_file(void *addr, size_t size, os_file_handle file, uint64 offset,
+                bool is_shared);
+
 static inline void *
 os_mremap_slow(void *old_addr, size_t old_size, size_t new_size)
 {
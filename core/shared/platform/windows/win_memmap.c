@@ -144,3 +144,55 @@ os_mprotect(void *addr, size_t size, int prot)
 #endif
     return VirtualProtect((LPVOID)addr, request_size, protect, NULL);
 }
+
+int
+os_mem_discard(void *addr, size_t size)
+{
+    if (!addr)
+        return 0;
+
+    /* The decommitted pages are zero-filled when committed again */
+    os_mem_decommit(addr, size);
+    if (!os_mem_commit(addr, size, MMAP_PROT_READ | MMAP_PROT_WRITE))
+        return -1;
+    return 0;
+}
+
+os_file_handle
+os_mem_image_create(const char *name, size_t size)
+{
+    /* The file mapping of os_mmap isn't supported */
+    (void)name;
+    (void)size;
+    return os_get_invalid_handle();
+}
+
+int
+os_mem_image_write(os_file_handle file, size_t offset, const void *data,
+                   size_t size)
+{
+    (void)file;
+    (void)offset;
+    (void)data;
+    (void)size;
+    return -1;
+}
+
+void
+os_mem_image_destroy(os_file_handle file)
+{
+    (void)file;
+}
+
+int
+os_mem_map_file(void *addr, size_t size, os_file_handle file, uint64 offset,
+                bool is_shared)
+{
+    /* The views of the file can't be placed in the reserved memory */
+    (void)addr;
+    (void)size;
+    (void)file;
+    (void)offset;
+    (void)is_shared;
+    return -1;
+}
@@ -56,12 +56,17 @@ print_help()
     printf("                           default is %u KB\n", FAST_JIT_DEFAULT_CODE_CACHE_SIZE / 1024);
 #endif
 #if WASM_ENABLE_GC != 0
-    printf("  --gc-heap-size=n         Set maximum gc heap size in bytes,\n");
+    printf("  --gc-heap-size=n         Set gc heap size in bytes,\n");
     printf("                           default is %u KB\n", GC_HEAP_SIZE_DEFAULT / 1024);
+    printf("  --gc-heap-max-size=n     Set maximum gc heap size in bytes, the gc heap\n");
+    printf("                           grows from gc-heap-size on demand if it is set\n");
 #endif
 #if WASM_ENABLE_JIT != 0
     printf("  --llvm-jit-size-level=n  Set LLVM JIT size level, default is 3\n");
     printf("  --llvm-jit-opt-level=n   Set LLVM JIT optimization level, default is 3\n");
+    printf("  --llvm-jit-cache-dir=<dir>\n");
+    printf("                           Save the LLVM JIT compiled code into the directory\n");
+    printf("                           and reload it when running the same module again\n");
 #if defined(os_writegsbase)
     printf("  --enable-segue[=<flags>] Enable using segment register GS as the base address of\n");
     printf("                           linear memory, which may improve performance, flags can be:\n");
@@ -79,6 +84,10 @@ print_help()
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     printf("  --disable-bounds-checks  Disable bounds checks for memory accesses\n");
 #endif
+#if WASM_ENABLE_AOT != 0
+    printf("  --aot-lazy-text          Load the AOT code page by page when it is first\n"
+           "                           executed, instead of all at startup\n");
+#endif
 #if WASM_ENABLE_LIBC_WASI != 0
     libc_wasi_print_help();
 #endif
@@ -390,6 +399,36 @@ unregister_and_unload_native_libs(uint32 native_lib_count,
 }
 #endif /* BH_HAS_DLFCN */
 
+#if WASM_ENABLE_AOT != 0 && WASM_MEM_DUAL_BUS_MIRROR == 0
+/**
+ * Map the XIP file privately instead of copying it, the text pages which
+ * aren't patched by the loader stay in the page cache and are shared among
+ * the processes running the same file, see wamrc --enable-shared-text.
+ * The file must not be modified while it is mapped.
+ */
+static uint8 *
+map_xip_file(const char *file_name, const uint8 *file_buf, uint32 file_size)
+{
+    int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
+    int map_flags = MMAP_MAP_32BIT;
+    uint8 *mapped;
+    int fd;
+
+    if ((fd = open(file_name, O_RDONLY)) < 0)
+        return NULL;
+
+    mapped = os_mmap(NULL, file_size, map_prot, map_flags, fd);
+    close(fd);
+
+    /* the file was changed, or the platform doesn't support to map it */
+    if (mapped && memcmp(mapped, file_buf, file_size) != 0) {
+        os_munmap(mapped, file_size);
+        return NULL;
+    }
+    return mapped;
+}
+#endif
+
 #if WASM_ENABLE_MULTI_MODULE != 0
 static char *
 handle_module_path(const char *module_path)
@@ -577,11 +616,13 @@ main(int argc, char *argv[])
 #endif
 #if WASM_ENABLE_GC != 0
     uint32 gc_heap_size = GC_HEAP_SIZE_DEFAULT;
+    uint32 gc_heap_max_size = 0;
 #endif
 #if WASM_ENABLE_JIT != 0
     uint32 llvm_jit_size_level = 3;
     uint32 llvm_jit_opt_level = 3;
     uint32 segue_flags = 0;
+    const char *llvm_jit_cache_dir = NULL;
 #endif
 #if WASM_ENABLE_LINUX_PERF != 0
     bool enable_linux_perf = false;
@@ -596,6 +637,9 @@ main(int argc, char *argv[])
 #endif
     bool is_repl_mode = false;
     bool is_xip_file = false;
+#if WASM_ENABLE_AOT != 0
+    bool aot_lazy_text = false;
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = false;
 #endif
@@ -667,6 +711,11 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--disable-bounds-checks")) {
             disable_bounds_checks = true;
         }
+#endif
+#if WASM_ENABLE_AOT != 0
+        else if (!strcmp(argv[0], "--aot-lazy-text")) {
+            aot_lazy_text = true;
+        }
 #endif
         else if (!strncmp(argv[0], "--stack-size=", 13)) {
             if (argv[0][13] == '\0')
@@ -691,6 +740,11 @@ main(int argc, char *argv[])
                 return print_help();
             gc_heap_size = atoi(argv[0] + 15);
         }
+        else if (!strncmp(argv[0], "--gc-heap-max-size=", 19)) {
+            if (argv[0][19] == '\0')
+                return print_help();
+            gc_heap_max_size = atoi(argv[0] + 19);
+        }
 #endif
 #if WASM_ENABLE_JIT != 0
         else if (!strncmp(argv[0], "--llvm-jit-size-level=", 22)) {
@@ -723,6 +777,11 @@ main(int argc, char *argv[])
                 llvm_jit_opt_level = 3;
             }
         }
+        else if (!strncmp(argv[0], "--llvm-jit-cache-dir=", 21)) {
+            if (argv[0][21] == '\0')
+                return print_help();
+            llvm_jit_cache_dir = argv[0] + 21;
+        }
         else if (!strcmp(argv[0], "--enable-segue")) {
             /* all flags are enabled */
             segue_flags = 0x1F1F;
@@ -849,12 +908,14 @@ main(int argc, char *argv[])
 
 #if WASM_ENABLE_GC != 0
     init_args.gc_heap_size = gc_heap_size;
+    init_args.gc_heap_max_size = gc_heap_max_size;
 #endif
 
 #if WASM_ENABLE_JIT != 0
     init_args.llvm_jit_size_level = llvm_jit_size_level;
     init_args.llvm_jit_opt_level = llvm_jit_opt_level;
     init_args.segue_flags = segue_flags;
+    init_args.llvm_jit_cache_dir = llvm_jit_cache_dir;
 #endif
 #if WASM_ENABLE_LINUX_PERF != 0
     init_args.enable_linux_perf = enable_linux_perf;
@@ -887,8 +948,22 @@ main(int argc, char *argv[])
               (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
         goto fail1;
 
-#if WASM_ENABLE_AOT != 0
+#if WASM_ENABLE_AOT != 0 && WASM_MEM_DUAL_BUS_MIRROR == 0
     if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
+        uint8 *wasm_file_mapped =
+            map_xip_file(wasm_file, wasm_file_buf, wasm_file_size);
+
+        if (wasm_file_mapped) {
+            wasm_runtime_free(wasm_file_buf);
+            wasm_file_buf = wasm_file_mapped;
+            is_xip_file = true;
+        }
+    }
+#endif
+
+#if WASM_ENABLE_AOT != 0
+    if (!is_xip_file
+        && wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
         uint8 *wasm_file_mapped;
         uint8 *daddr;
         int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
@@ -922,8 +997,21 @@ main(int argc, char *argv[])
 #endif
 
     /* load WASM module */
-    if (!(wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
-                                          error_buf, sizeof(error_buf)))) {
+#if WASM_ENABLE_AOT != 0
+    if (aot_lazy_text) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+        load_args.aot_lazy_text = true;
+        wasm_module = wasm_runtime_load_ex(wasm_file_buf, wasm_file_size,
+                                           &load_args, error_buf,
+                                           sizeof(error_buf));
+    }
+    else
+#endif
+        wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
+                                        error_buf, sizeof(error_buf));
+    if (!wasm_module) {
         printf("%s\n", error_buf);
         goto fail2;
     }
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <vector>
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "aot_runtime.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+
+#define NEVER_SUPPORTED_FEATURES (1ULL << 63)
+
+/* (func (export "f0") (param i32) (result i32) x * 3 + 1)
+   (func (export "f1") (param i32) (result i32) x + 5) */
+static const uint8_t wasm_bytes[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    /* type section */
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    /* function section */
+    0x03, 0x03, 0x02, 0x00, 0x00,
+    /* export section */
+    0x07, 0x0b, 0x02, 0x02, 'f', '0', 0x00, 0x00, 0x02, 'f', '1', 0x00, 0x01,
+    /* code section */
+    0x0a, 0x14, 0x02,
+    0x0a, 0x00, 0x20, 0x00, 0x41, 0x03, 0x6c, 0x41, 0x01, 0x6a, 0x0b,
+    0x07, 0x00, 0x20, 0x00, 0x41, 0x05, 0x6a, 0x0b,
+};
+
+/* The function entries of a variant in the function variant section */
+struct VariantInfo {
+    uint8_t *cpu_features;
+    uint32_t func_count;
+    uint32_t *funcs;
+};
+
+class aot_cpu_variant_test_suit : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        std::vector<uint8_t> wasm(wasm_bytes, wasm_bytes + sizeof(wasm_bytes));
+        char error_buf[128] = { 0 };
+        wasm_module_t wasm_module;
+        AOTCompData *comp_data;
+        AOTCompContext *comp_ctx;
+        AOTCompOption option = { 0 };
+
+        wasm_module = wasm_runtime_load(wasm.data(), (uint32_t)wasm.size(),
+                                        error_buf, sizeof(error_buf));
+        ASSERT_NE(wasm_module, nullptr) << error_buf;
+
+        /* Variants of f0 for two CPUs with more features than the baseline,
+           the section lists them from the least capable one */
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.target_arch = (char *)"x86_64";
+        option.target_cpu = (char *)"x86-64";
+        option.cpu_variants = "nehalem,haswell";
+        option.cpu_variant_funcs = "0";
+        comp_data =
+            aot_create_comp_data((WASMModule *)wasm_module, NULL, false);
+        ASSERT_NE(comp_data, nullptr);
+        comp_ctx = aot_create_comp_context(comp_data, &option);
+        ASSERT_NE(comp_ctx, nullptr) << aot_get_last_error();
+        ASSERT_TRUE(aot_compile_wasm(comp_ctx)) << aot_get_last_error();
+        aot_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_size);
+        ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        wasm_runtime_unload(wasm_module);
+
+        ASSERT_TRUE(find_variants());
+        ASSERT_EQ(variants.size(), 2u);
+    }
+
+    virtual void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+        if (aot_buf)
+            wasm_runtime_free(aot_buf);
+    }
+
+    /* Walk the sections of the AOT file to the function variant section,
+       the fields are aligned to 4 bytes like the loader reads them */
+    bool find_variants()
+    {
+        uint32_t offset = 8, section_type, section_size, section_end;
+        uint32_t variant_count, i;
+        VariantInfo variant;
+
+        while (offset + 8 <= aot_size) {
+            offset = (offset + 3) & ~3u;
+            section_type = *(uint32_t *)(aot_buf + offset);
+            section_size = *(uint32_t *)(aot_buf + offset + 4);
+            offset += 8;
+            section_end = offset + section_size;
+
+            if (section_type != AOT_SECTION_TYPE_CUSTOM
+                || *(uint32_t *)(aot_buf + offset)
+                       != AOT_CUSTOM_SECTION_FUNC_VARIANT) {
+                offset = section_end;
+                continue;
+            }
+
+            variant_count = *(uint32_t *)(aot_buf + offset + 4);
+            offset += 8;
+            for (i = 0; i < variant_count; i++) {
+                variant.cpu_features = aot_buf + offset;
+                variant.func_count = *(uint32_t *)(aot_buf + offset + 8);
+                variant.funcs = (uint32_t *)(aot_buf + offset + 12);
+                offset += 12 + variant.func_count * 8;
+                if (offset > section_end)
+                    return false;
+                variants.push_back(variant);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /* The 64-bit field may be unaligned */
+    void set_cpu_features(uint32_t variant_idx, uint64_t cpu_features)
+    {
+        memcpy(variants[variant_idx].cpu_features, &cpu_features,
+               sizeof(uint64_t));
+    }
+
+    void load(char *error_buf, uint32_t error_buf_size)
+    {
+        module =
+            wasm_runtime_load(aot_buf, aot_size, error_buf, error_buf_size);
+    }
+
+    void *func_ptr(uint32_t func_idx)
+    {
+        return ((AOTModule *)module)->func_ptrs[func_idx];
+    }
+
+    void *variant_ptr(uint32_t variant_idx)
+    {
+        AOTModule *aot_module = (AOTModule *)module;
+
+        EXPECT_EQ(variants[variant_idx].func_count, 1u);
+        EXPECT_EQ(variants[variant_idx].funcs[0], 0u);
+        return (uint8_t *)aot_module->code + variants[variant_idx].funcs[1];
+    }
+
+    /* Check the results of both functions, f0 runs the selected variant */
+    void check_results()
+    {
+        char error_buf[128] = { 0 };
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        uint32_t argv[1];
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        func = wasm_runtime_lookup_function(module_inst, "f0");
+        ASSERT_NE(func, nullptr);
+        argv[0] = 7;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        EXPECT_EQ(argv[0], 22u);
+
+        func = wasm_runtime_lookup_function(module_inst, "f1");
+        ASSERT_NE(func, nullptr);
+        argv[0] = 7;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        EXPECT_EQ(argv[0], 12u);
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    uint8_t *aot_buf = nullptr;
+    uint32_t aot_size = 0;
+    std::vector<VariantInfo> variants;
+    wasm_module_t module = nullptr;
+};
+
+TEST_F(aot_cpu_variant_test_suit, no_supported_variant)
+{
+    char error_buf[128] = { 0 };
+
+    set_cpu_features(0, NEVER_SUPPORTED_FEATURES);
+    set_cpu_features(1, NEVER_SUPPORTED_FEATURES);
+    load(error_buf, sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+
+    /* f0 keeps the baseline code */
+    EXPECT_NE(func_ptr(0), variant_ptr(0));
+    EXPECT_NE(func_ptr(0), variant_ptr(1));
+    check_results();
+}
+
+TEST_F(aot_cpu_variant_test_suit, select_supported_variant)
+{
+    char error_buf[128] = { 0 };
+
+    /* the nehalem variant requires no feature, so that it can run on any
+       host */
+    set_cpu_features(0, 0);
+    set_cpu_features(1, NEVER_SUPPORTED_FEATURES);
+    load(error_buf, sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+
+    EXPECT_EQ(func_ptr(0), variant_ptr(0));
+    /* f1 has no variant */
+    EXPECT_NE(func_ptr(1), variant_ptr(0));
+    EXPECT_NE(func_ptr(1), variant_ptr(1));
+    check_results();
+}
+
+TEST_F(aot_cpu_variant_test_suit, last_supported_variant_wins)
+{
+    char error_buf[128] = { 0 };
+
+    /* the haswell variant may not run on the host, only check the
+       selection */
+    set_cpu_features(0, 0);
+    set_cpu_features(1, 0);
+    load(error_buf, sizeof(error_buf));
+    ASSERT_NE(module, nullptr) << error_buf;
+
+    EXPECT_EQ(func_ptr(0), variant_ptr(1));
+}
+
+TEST_F(aot_cpu_variant_test_suit, invalid_func_index)
+{
+    char error_buf[128] = { 0 };
+
+    /* the index of the function variant is out of the functions */
+    variants[1].funcs[0] = 2;
+    load(error_buf, sizeof(error_buf));
+    EXPECT_EQ(module, nullptr);
+    EXPECT_STREQ(error_buf, "AOT module load failed: invalid function variant");
+}
+
+#endif /* end of defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) */
@@ -100,7 +100,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_check_memory_overflow)
 
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
         offset = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
-        aot_check_memory_overflow(comp_ctx, func_ctx, offset, bytes, false,
+        aot_check_memory_overflow(comp_ctx, func_ctx, 0, offset, bytes, false,
                                   NULL);
     }
 }
@@ -117,7 +117,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i32_load)
         align = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
         offset = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
         bytes = (1 + (rand() % (4 - 1 + 1)));
-        printf("---%d", aot_compile_op_i32_load(comp_ctx, func_ctx, align,
+        printf("---%d", aot_compile_op_i32_load(comp_ctx, func_ctx, 0, align,
                                                 offset, bytes, sign, atomic));
     }
 }
@@ -136,8 +136,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i64_load)
         bytes = (1 + (rand() % (4 - 1 + 1)));
         sign = !sign;
         atomic = !atomic;
-        aot_compile_op_i64_load(comp_ctx, func_ctx, align, offset, bytes, sign,
-                                atomic);
+        aot_compile_op_i64_load(comp_ctx, func_ctx, 0, align, offset, bytes,
+                                sign, atomic);
     }
 }
 
@@ -149,7 +149,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f32_load)
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
         align = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
         offset = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
-        aot_compile_op_f32_load(comp_ctx, func_ctx, align, offset);
+        aot_compile_op_f32_load(comp_ctx, func_ctx, 0, align, offset);
     }
 }
 
@@ -161,7 +161,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f64_load)
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
         align = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
         offset = (1 + (rand() % (DEFAULT_MAX_RAND_NUM - 1 + 1)));
-        aot_compile_op_f64_load(comp_ctx, func_ctx, align, offset);
+        aot_compile_op_f64_load(comp_ctx, func_ctx, 0, align, offset);
     }
 }
 
@@ -172,8 +172,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i32_store)
     uint32 bytes = 0;
     bool atomic = false;
 
-    EXPECT_FALSE(aot_compile_op_i32_store(comp_ctx, func_ctx, align, offset,
-                                          bytes, atomic));
+    EXPECT_FALSE(aot_compile_op_i32_store(comp_ctx, func_ctx, 0, align,
+                                          offset, bytes, atomic));
 
     /* Generate random number range：[m,n] int a=m+rand()%(n-m+1); */
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
@@ -182,8 +182,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i32_store)
         align = (1 + (rand() % (0xFFFFFFFF - 1 + 1)));
         atomic = !atomic;
 
-        EXPECT_FALSE(aot_compile_op_i32_store(comp_ctx, func_ctx, align, offset,
-                                              bytes, atomic));
+        EXPECT_FALSE(aot_compile_op_i32_store(comp_ctx, func_ctx, 0, align,
+                                              offset, bytes, atomic));
     }
 }
 
@@ -194,8 +194,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i64_store)
     uint32 bytes = 0;
     bool atomic = false;
 
-    EXPECT_FALSE(aot_compile_op_i64_store(comp_ctx, func_ctx, align, offset,
-                                          bytes, atomic));
+    EXPECT_FALSE(aot_compile_op_i64_store(comp_ctx, func_ctx, 0, align,
+                                          offset, bytes, atomic));
 
     /* Generate random number range：[m,n] int a=m+rand()%(n-m+1); */
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
@@ -204,8 +204,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_i64_store)
         align = (1 + (rand() % (0xFFFFFFFF - 1 + 1)));
         atomic = !atomic;
 
-        EXPECT_FALSE(aot_compile_op_i64_store(comp_ctx, func_ctx, align, offset,
-                                              bytes, atomic));
+        EXPECT_FALSE(aot_compile_op_i64_store(comp_ctx, func_ctx, 0, align,
+                                              offset, bytes, atomic));
     }
 }
 
@@ -214,7 +214,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f32_store)
     uint32 align = 0;
     uint32 offset = 0;
 
-    EXPECT_FALSE(aot_compile_op_f32_store(comp_ctx, func_ctx, align, offset));
+    EXPECT_FALSE(
+        aot_compile_op_f32_store(comp_ctx, func_ctx, 0, align, offset));
 
     /* Generate random number range：[m,n] int a=m+rand()%(n-m+1); */
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
@@ -222,7 +223,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f32_store)
         align = (1 + (rand() % (0xFFFFFFFF - 1 + 1)));
 
         EXPECT_FALSE(
-            aot_compile_op_f32_store(comp_ctx, func_ctx, align, offset));
+            aot_compile_op_f32_store(comp_ctx, func_ctx, 0, align, offset));
     }
 }
 
@@ -231,7 +232,8 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f64_store)
     uint32 align = 0;
     uint32 offset = 0;
 
-    EXPECT_FALSE(aot_compile_op_f64_store(comp_ctx, func_ctx, align, offset));
+    EXPECT_FALSE(
+        aot_compile_op_f64_store(comp_ctx, func_ctx, 0, align, offset));
 
     /* Generate random number range：[m,n] int a=m+rand()%(n-m+1); */
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
@@ -239,18 +241,18 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_f64_store)
         align = (1 + (rand() % (0xFFFFFFFF - 1 + 1)));
 
         EXPECT_FALSE(
-            aot_compile_op_f64_store(comp_ctx, func_ctx, align, offset));
+            aot_compile_op_f64_store(comp_ctx, func_ctx, 0, align, offset));
     }
 }
 
 TEST_F(compilation_aot_emit_memory_test, aot_compile_op_memory_size)
 {
-    aot_compile_op_memory_size(comp_ctx, func_ctx);
+    aot_compile_op_memory_size(comp_ctx, func_ctx, 0);
 }
 
 TEST_F(compilation_aot_emit_memory_test, aot_compile_op_memory_grow)
 {
-    aot_compile_op_memory_grow(comp_ctx, func_ctx);
+    aot_compile_op_memory_grow(comp_ctx, func_ctx, 0);
 }
 
 #if WASM_ENABLE_BULK_MEMORY != 0
@@ -261,7 +263,7 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_memory_init)
     /* Generate random number range：[m,n] int a=m+rand()%(n-m+1); */
     for (uint32 i = 0; i < DEFAULT_CYCLE_TIMES; i++) {
         seg_index = (1 + (rand() % (0xFFFFFFFF - 1 + 1)));
-        aot_compile_op_memory_init(comp_ctx, func_ctx, seg_index);
+        aot_compile_op_memory_init(comp_ctx, func_ctx, 0, seg_index);
     }
 }
 
@@ -278,12 +280,12 @@ TEST_F(compilation_aot_emit_memory_test, aot_compile_op_data_drop)
 
 TEST_F(compilation_aot_emit_memory_test, aot_compile_op_memory_copy)
 {
-    aot_compile_op_memory_copy(comp_ctx, func_ctx);
+    aot_compile_op_memory_copy(comp_ctx, func_ctx, 0, 0);
 }
 
 TEST_F(compilation_aot_emit_memory_test, aot_compile_op_memory_fill)
 {
-    aot_compile_op_memory_fill(comp_ctx, func_ctx);
+    aot_compile_op_memory_fill(comp_ctx, func_ctx, 0);
 }
 #endif
 
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <thread>
+#include <vector>
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "aot_runtime.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+#if AOT_LAZY_TEXT_SUPPORTED != 0
+
+#define FUNC_COUNT 16
+#define STEP_COUNT 512
+#define THREAD_COUNT 4
+
+/* Each function mixes its argument with a chain of multiplications and
+   xors, long enough for the code of each function to span pages */
+static uint32_t
+step_mul(uint32_t func_idx, uint32_t step)
+{
+    return (func_idx * 1000 + step) * 2 + 1;
+}
+
+static uint32_t
+step_xor(uint32_t func_idx, uint32_t step)
+{
+    return func_idx * 7919 + step;
+}
+
+static uint32_t
+expected_result(uint32_t func_idx, uint32_t arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < STEP_COUNT; i++)
+        arg = (arg * step_mul(func_idx, i)) ^ step_xor(func_idx, i);
+    return arg;
+}
+
+static void
+append_leb(std::vector<uint8_t> &buf, uint32_t value, bool sign)
+{
+    uint8_t byte;
+
+    do {
+        byte = value & 0x7f;
+        value >>= 7;
+        /* the constants are positive, keep the sign bit clear */
+        if (value != 0 || (sign && (byte & 0x40)))
+            byte |= 0x80;
+        buf.push_back(byte);
+    } while (byte & 0x80);
+}
+
+static void
+append_section(std::vector<uint8_t> &module, uint8_t id,
+               const std::vector<uint8_t> &content)
+{
+    module.push_back(id);
+    append_leb(module, (uint32_t)content.size(), false);
+    module.insert(module.end(), content.begin(), content.end());
+}
+
+/* (func (export "fN") (param i32) (result i32) ...) for N in FUNC_COUNT */
+static std::vector<uint8_t>
+build_wasm_module()
+{
+    std::vector<uint8_t> module = { 0x00, 0x61, 0x73, 0x6d,
+                                    0x01, 0x00, 0x00, 0x00 };
+    std::vector<uint8_t> types = { 1, 0x60, 1, 0x7f, 1, 0x7f };
+    std::vector<uint8_t> funcs, exports, codes, body;
+    uint32_t i, j;
+
+    append_leb(funcs, FUNC_COUNT, false);
+    append_leb(exports, FUNC_COUNT, false);
+    append_leb(codes, FUNC_COUNT, false);
+    for (i = 0; i < FUNC_COUNT; i++) {
+        std::string name = "f" + std::to_string(i);
+
+        funcs.push_back(0);
+
+        append_leb(exports, (uint32_t)name.size(), false);
+        exports.insert(exports.end(), name.begin(), name.end());
+        exports.push_back(0);
+        append_leb(exports, i, false);
+
+        body.assign(1, 0);
+        for (j = 0; j < STEP_COUNT; j++) {
+            /* local.get 0, i32.const, i32.mul, i32.const, i32.xor,
+               local.set 0 */
+            body.insert(body.end(), { 0x20, 0 });
+            body.push_back(0x41);
+            append_leb(body, step_mul(i, j), true);
+            body.push_back(0x6c);
+            body.push_back(0x41);
+            append_leb(body, step_xor(i, j), true);
+            body.insert(body.end(), { 0x73, 0x21, 0 });
+        }
+        body.insert(body.end(), { 0x20, 0, 0x0b });
+        append_leb(codes, (uint32_t)body.size(), false);
+        codes.insert(codes.end(), body.begin(), body.end());
+    }
+
+    append_section(module, 1, types);
+    append_section(module, 3, funcs);
+    append_section(module, 7, exports);
+    append_section(module, 10, codes);
+    return module;
+}
+
+class aot_lazy_text_test_suit : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        std::vector<uint8_t> wasm = build_wasm_module();
+        char error_buf[128] = { 0 };
+        wasm_module_t wasm_module;
+        AOTCompData *comp_data;
+        AOTCompContext *comp_ctx;
+        AOTCompOption option = { 0 };
+
+        wasm_module = wasm_runtime_load(wasm.data(), (uint32_t)wasm.size(),
+                                        error_buf, sizeof(error_buf));
+        ASSERT_NE(wasm_module, nullptr) << error_buf;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        comp_data =
+            aot_create_comp_data((WASMModule *)wasm_module, NULL, false);
+        ASSERT_NE(comp_data, nullptr);
+        comp_ctx = aot_create_comp_context(comp_data, &option);
+        ASSERT_NE(comp_ctx, nullptr);
+        ASSERT_TRUE(aot_compile_wasm(comp_ctx));
+        aot_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_size);
+        ASSERT_NE(aot_buf, nullptr);
+
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        wasm_runtime_unload(wasm_module);
+    }
+
+    virtual void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+        /* the lazy text reads the AOT file buffer until unloading */
+        if (aot_buf)
+            wasm_runtime_free(aot_buf);
+    }
+
+    void load_lazy_text()
+    {
+        LoadArgs args = { 0 };
+        char error_buf[128] = { 0 };
+
+        args.aot_lazy_text = true;
+        module = wasm_runtime_load_ex(aot_buf, aot_size, &args, error_buf,
+                                      sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+    }
+
+    uint32_t loaded_page_count()
+    {
+        AOTLazyText *lazy_text = ((AOTModule *)module)->lazy_text;
+        uint32_t i, count = 0;
+
+        for (i = 0; i < lazy_text->page_count; i++) {
+            if (BH_ATOMIC_32_LOAD(lazy_text->page_state[i])
+                & AOT_LAZY_TEXT_PAGE_LOADED)
+                count++;
+        }
+        return count;
+    }
+
+    WAMRRuntimeRAII<1024 * 1024> runtime;
+    uint8_t *aot_buf = nullptr;
+    uint32_t aot_size = 0;
+    wasm_module_t module = nullptr;
+};
+
+/* Call the functions starting from first_func, return the number of the
+   wrong results */
+static uint32_t
+call_functions(wasm_module_t module, uint32_t first_func)
+{
+    char error_buf[128] = { 0 };
+    wasm_module_inst_t module_inst;
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    uint32_t i, func_idx, argv[1], failed = 0;
+
+    module_inst =
+        wasm_runtime_instantiate(module, 8192, 0, error_buf, sizeof(error_buf));
+    if (!module_inst)
+        return FUNC_COUNT;
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+
+    for (i = 0; i < FUNC_COUNT; i++) {
+        func_idx = (first_func + i) % FUNC_COUNT;
+        func = wasm_runtime_lookup_function(
+            module_inst, ("f" + std::to_string(func_idx)).c_str());
+        argv[0] = func_idx + 1;
+        if (!func || !wasm_runtime_call_wasm(exec_env, func, 1, argv)
+            || argv[0] != expected_result(func_idx, func_idx + 1))
+            failed++;
+    }
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    return failed;
+}
+
+TEST_F(aot_lazy_text_test_suit, run_functions_on_several_pages)
+{
+    AOTLazyText *lazy_text;
+    uint32_t loaded_count;
+
+    load_lazy_text();
+    lazy_text = ((AOTModule *)module)->lazy_text;
+    ASSERT_NE(lazy_text, nullptr);
+    ASSERT_GE(lazy_text->page_count, (uint32_t)FUNC_COUNT);
+
+    /* only the pages of the plt table are materialized at load time */
+    loaded_count = loaded_page_count();
+    EXPECT_LT(loaded_count, lazy_text->page_count / 2);
+
+    EXPECT_EQ(call_functions(module, 0), 0u);
+    EXPECT_GT(loaded_page_count(), loaded_count + FUNC_COUNT / 2);
+
+    /* the materialized pages are run again without faults */
+    EXPECT_EQ(call_functions(module, FUNC_COUNT / 2), 0u);
+}
+
+TEST_F(aot_lazy_text_test_suit, run_functions_in_several_threads)
+{
+    std::vector<std::thread> threads;
+    uint32_t failed[THREAD_COUNT] = { 0 };
+    uint32_t i;
+
+    load_lazy_text();
+    ASSERT_NE(((AOTModule *)module)->lazy_text, nullptr);
+
+    /* the threads fault on the same pages concurrently, each page must be
+       materialized once and the other threads wait for it */
+    for (i = 0; i < THREAD_COUNT; i++) {
+        threads.emplace_back([this, i, &failed]() {
+            if (!wasm_runtime_init_thread_env()) {
+                failed[i] = FUNC_COUNT;
+                return;
+            }
+            failed[i] = call_functions(module, i * (FUNC_COUNT / 4));
+            wasm_runtime_destroy_thread_env();
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (i = 0; i < THREAD_COUNT; i++)
+        EXPECT_EQ(failed[i], 0u) << "thread " << i;
+}
+
+#endif /* end of AOT_LAZY_TEXT_SUPPORTED != 0 */
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <functional>
+#include <vector>
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "bh_read_file.h"
+#include "aot_runtime.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+#if WASM_ENABLE_STATIC_PGO != 0 && defined(LLVM_PROFDATA)
+
+static std::string CWD;
+
+static std::string
+get_binary_path()
+{
+    char cwd[1024];
+    memset(cwd, 0, 1024);
+
+    if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+    }
+
+    char *path_end = strrchr(cwd, '/');
+    if (path_end != NULL) {
+        *path_end = '\0';
+    }
+
+    return std::string(cwd);
+}
+
+typedef std::function<void(wasm_module_inst_t, wasm_exec_env_t)> RunFunc;
+
+/* Compile the wasm file with the instrumentation, run it to collect the
+   profile, then compile it again with the profile like wamrc
+   --enable-llvm-pgo and --use-prof-file do */
+class aot_pgo_test_suit : public testing::Test
+{
+  protected:
+    static void SetUpTestCase() { CWD = get_binary_path(); }
+
+    virtual void SetUp()
+    {
+        memset(&option, 0, sizeof(option));
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+    }
+
+    virtual void TearDown()
+    {
+        if (wasm_buf)
+            BH_FREE(wasm_buf);
+        if (prof_file.size() > 0) {
+            remove(prof_file.c_str());
+            remove((prof_file + "raw").c_str());
+        }
+    }
+
+    void load_wasm(const char *name)
+    {
+        wasm_buf = (uint8_t *)bh_read_file_to_buffer(
+            (CWD + "/" + name).c_str(), &wasm_buf_size);
+        ASSERT_NE(wasm_buf, nullptr);
+        prof_file = CWD + "/" + name + ".profdata";
+    }
+
+    /* Compile the loaded wasm file, the IR after the optimization is
+       returned in p_ir if it isn't NULL */
+    uint8_t *compile(uint32_t *p_aot_size, std::string *p_ir = NULL)
+    {
+        char error_buf[128] = { 0 };
+        wasm_module_t wasm_module;
+        AOTCompData *comp_data = NULL;
+        AOTCompContext *comp_ctx = NULL;
+        uint8_t *aot_buf = NULL;
+        char *ir;
+        /* the loader may modify the buffer, load a copy each time */
+        std::vector<uint8_t> buf(wasm_buf, wasm_buf + wasm_buf_size);
+
+        if (!(wasm_module = wasm_runtime_load(buf.data(), wasm_buf_size,
+                                              error_buf, sizeof(error_buf)))) {
+            ADD_FAILURE() << error_buf;
+            return NULL;
+        }
+
+        if ((comp_data = aot_create_comp_data((WASMModule *)wasm_module, NULL,
+                                              false))
+            && (comp_ctx = aot_create_comp_context(comp_data, &option))
+            && aot_compile_wasm(comp_ctx)) {
+            if (p_ir) {
+                ir = LLVMPrintModuleToString(comp_ctx->module);
+                *p_ir = ir;
+                LLVMDisposeMessage(ir);
+            }
+            aot_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, p_aot_size);
+        }
+
+        if (comp_ctx)
+            aot_destroy_comp_context(comp_ctx);
+        if (comp_data)
+            aot_destroy_comp_data(comp_data);
+        wasm_runtime_unload(wasm_module);
+        return aot_buf;
+    }
+
+    /* Load and instantiate the AOT file and call run with the instance */
+    void run_aot(uint8_t *aot_buf, uint32_t aot_size, const RunFunc &run)
+    {
+        char error_buf[128] = { 0 };
+        wasm_module_t module;
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+
+        module = wasm_runtime_load(aot_buf, aot_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        run(module_inst, exec_env);
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+    }
+
+    /* Run the instrumented AOT file with train and merge the raw profile,
+       the later compilations use it */
+    void collect_profile(const RunFunc &train)
+    {
+        uint8_t *aot_buf;
+        uint32_t aot_size = 0;
+        std::string raw_file = prof_file + "raw";
+        std::string cmd;
+
+        option.enable_llvm_pgo = true;
+        aot_buf = compile(&aot_size);
+        option.enable_llvm_pgo = false;
+        ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+
+        run_aot(aot_buf, aot_size,
+                [&](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+                    uint32_t size;
+                    std::vector<char> buf;
+                    FILE *file;
+
+                    train(module_inst, exec_env);
+
+                    /* the value profile grows when running */
+                    size = wasm_runtime_get_pgo_prof_data_size(module_inst);
+                    ASSERT_GT(size, 0u);
+                    buf.resize(size);
+                    ASSERT_EQ(wasm_runtime_dump_pgo_prof_data_to_buf(
+                                  module_inst, buf.data(), size),
+                              size);
+                    ASSERT_NE(file = fopen(raw_file.c_str(), "wb"), nullptr);
+                    EXPECT_EQ(fwrite(buf.data(), 1, size, file), size);
+                    fclose(file);
+                });
+        wasm_runtime_free(aot_buf);
+
+        cmd = std::string(LLVM_PROFDATA) + " merge -o " + prof_file + " "
+              + raw_file;
+        ASSERT_EQ(system(cmd.c_str()), 0) << cmd;
+        option.use_prof_file = (char *)prof_file.c_str();
+    }
+
+    WAMRRuntimeRAII<1024 * 1024> runtime;
+    AOTCompOption option;
+    uint8_t *wasm_buf = NULL;
+    uint32_t wasm_buf_size = 0;
+    std::string prof_file;
+};
+
+static void
+call_dispatch(wasm_exec_env_t exec_env, wasm_function_inst_t func,
+              uint32_t elem_idx, uint32_t x, uint32_t expected)
+{
+    uint32_t argv[2] = { elem_idx, x };
+
+    ASSERT_TRUE(wasm_runtime_call_wasm(exec_env, func, 2, argv))
+        << wasm_runtime_get_exception(
+               wasm_runtime_get_module_inst(exec_env));
+    EXPECT_EQ(argv[0], expected) << "elem_idx " << elem_idx;
+}
+
+static void
+call_dispatch_trap(wasm_exec_env_t exec_env, wasm_function_inst_t func,
+                   uint32_t elem_idx, const char *exception)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    uint32_t argv[2] = { elem_idx, 5 };
+
+    EXPECT_FALSE(wasm_runtime_call_wasm(exec_env, func, 2, argv));
+    EXPECT_NE(strstr(wasm_runtime_get_exception(module_inst), exception),
+              nullptr)
+        << wasm_runtime_get_exception(module_inst);
+    wasm_runtime_clear_exception(module_inst);
+}
+
+TEST_F(aot_pgo_test_suit, call_indirect_speculation)
+{
+    uint8_t *aot_buf;
+    uint32_t aot_size = 0;
+    std::string ir;
+
+    load_wasm("pgo_call_indirect.wasm");
+
+    /* $mul2 in slot 1 takes most of the calls of the call_indirect site */
+    collect_profile([](wasm_module_inst_t module_inst,
+                       wasm_exec_env_t exec_env) {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, "dispatch");
+        uint32_t i;
+
+        ASSERT_NE(func, nullptr);
+        for (i = 0; i < 100; i++)
+            call_dispatch(exec_env, func, 1, i, i * 2);
+        for (i = 0; i < 10; i++)
+            call_dispatch(exec_env, func, 0, i, i + 1);
+    });
+
+    aot_buf = compile(&aot_size, &ir);
+    ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+
+    /* The guard compares elem_idx with the slot of $mul2, and the
+       placeholders are all resolved */
+    EXPECT_NE(ir.find("spec_hit"), std::string::npos);
+    EXPECT_EQ(ir.find(AOT_CALL_INDIRECT_SPEC_GUARD), std::string::npos);
+    EXPECT_EQ(ir.find(AOT_CALL_INDIRECT_SPEC_FUNC_IDX), std::string::npos);
+    EXPECT_EQ(ir.find(AOT_CALL_INDIRECT_SPEC_CALLEE), std::string::npos);
+
+    run_aot(aot_buf, aot_size,
+            [](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+                wasm_function_inst_t func =
+                    wasm_runtime_lookup_function(module_inst, "dispatch");
+
+                ASSERT_NE(func, nullptr);
+                /* the guard hits */
+                call_dispatch(exec_env, func, 1, 5, 10);
+                /* the guard misses, the table lookup and the type check
+                   still run */
+                call_dispatch(exec_env, func, 0, 5, 6);
+                call_dispatch(exec_env, func, 2, 5, 2);
+                call_dispatch_trap(exec_env, func, 3,
+                                   "indirect call type mismatch");
+                call_dispatch_trap(exec_env, func, 4, "undefined element");
+                call_dispatch_trap(exec_env, func, UINT32_MAX,
+                                   "undefined element");
+            });
+    wasm_runtime_free(aot_buf);
+}
+
+TEST_F(aot_pgo_test_suit, call_indirect_no_speculation)
+{
+    uint8_t *aot_buf;
+    uint32_t aot_size = 0;
+    std::string ir;
+
+    load_wasm("pgo_call_indirect.wasm");
+
+    /* No callee takes half of the calls */
+    collect_profile([](wasm_module_inst_t module_inst,
+                       wasm_exec_env_t exec_env) {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, "dispatch");
+        uint32_t i;
+
+        ASSERT_NE(func, nullptr);
+        for (i = 0; i < 30; i++) {
+            call_dispatch(exec_env, func, 0, i, i + 1);
+            call_dispatch(exec_env, func, 1, i, i * 2);
+            call_dispatch(exec_env, func, 2, i, i - 3);
+        }
+    });
+
+    aot_buf = compile(&aot_size, &ir);
+    ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+
+    /* The guard is resolved to false and the original path is kept */
+    EXPECT_EQ(ir.find("spec_hit"), std::string::npos);
+    EXPECT_EQ(ir.find(AOT_CALL_INDIRECT_SPEC_GUARD), std::string::npos);
+
+    run_aot(aot_buf, aot_size,
+            [](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+                wasm_function_inst_t func =
+                    wasm_runtime_lookup_function(module_inst, "dispatch");
+
+                ASSERT_NE(func, nullptr);
+                call_dispatch(exec_env, func, 0, 5, 6);
+                call_dispatch(exec_env, func, 1, 5, 10);
+                call_dispatch(exec_env, func, 2, 5, 2);
+                call_dispatch_trap(exec_env, func, 3,
+                                   "indirect call type mismatch");
+                call_dispatch_trap(exec_env, func, 4, "undefined element");
+            });
+    wasm_runtime_free(aot_buf);
+}
+
+static void
+call_layout_func(wasm_module_inst_t module_inst, wasm_exec_env_t exec_env,
+                 const char *name, uint32_t count)
+{
+    wasm_function_inst_t func = wasm_runtime_lookup_function(module_inst, name);
+    uint32_t i, argv[1];
+
+    ASSERT_NE(func, nullptr);
+    for (i = 0; i < count; i++) {
+        argv[0] = i;
+        ASSERT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+    }
+}
+
+/* Get the text addresses of the functions "cold", "warm" and "hot", which
+   are the defined functions 0, 1 and 2 */
+static void
+get_layout_func_ptrs(wasm_module_inst_t module_inst, uintptr_t func_ptrs[3])
+{
+    AOTModule *module = (AOTModule *)wasm_runtime_get_module(module_inst);
+    uint32_t i;
+
+    ASSERT_EQ(module->func_count, 3u);
+    for (i = 0; i < 3; i++)
+        func_ptrs[i] = (uintptr_t)module->func_ptrs[i];
+}
+
+TEST_F(aot_pgo_test_suit, hot_cold_function_order)
+{
+    uint8_t *aot_buf;
+    uint32_t aot_size = 0;
+    uintptr_t func_ptrs[3];
+
+    load_wasm("pgo_layout.wasm");
+
+    /* Without the profile the functions are laid out in the order they
+       are defined */
+    aot_buf = compile(&aot_size);
+    ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+    run_aot(aot_buf, aot_size,
+            [&](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+                get_layout_func_ptrs(module_inst, func_ptrs);
+            });
+    wasm_runtime_free(aot_buf);
+    EXPECT_LT(func_ptrs[0], func_ptrs[1]);
+    EXPECT_LT(func_ptrs[1], func_ptrs[2]);
+
+    collect_profile(
+        [](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+            call_layout_func(module_inst, exec_env, "hot", 1000);
+            call_layout_func(module_inst, exec_env, "warm", 100);
+        });
+
+    /* With the profile the hot functions are laid out together from the
+       hottest one, the function never called is put in the unlikely
+       text */
+    aot_buf = compile(&aot_size);
+    ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+    run_aot(aot_buf, aot_size,
+            [&](wasm_module_inst_t module_inst, wasm_exec_env_t exec_env) {
+                uint32_t argv[1] = { 1 };
+
+                get_layout_func_ptrs(module_inst, func_ptrs);
+
+                /* the functions are still called by their index */
+                ASSERT_TRUE(wasm_runtime_call_wasm(
+                    exec_env,
+                    wasm_runtime_lookup_function(module_inst, "cold"), 1,
+                    argv));
+                EXPECT_EQ(argv[0], 6u);
+                argv[0] = 1;
+                ASSERT_TRUE(wasm_runtime_call_wasm(
+                    exec_env, wasm_runtime_lookup_function(module_inst, "hot"),
+                    1, argv));
+                EXPECT_EQ(argv[0], 28u);
+            });
+    wasm_runtime_free(aot_buf);
+    EXPECT_LT(func_ptrs[2], func_ptrs[1]);
+    EXPECT_FALSE(func_ptrs[2] < func_ptrs[0] && func_ptrs[0] < func_ptrs[1]);
+}
+
+#endif /* end of WASM_ENABLE_STATIC_PGO != 0 && defined(LLVM_PROFDATA) */
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "aot_runtime.h"
+#include "aot_compiler.h"
+#include "aot_emit_aot_file.h"
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+
+/* (func (export "f") (param f64) (result f64) x * 1.5 + 0.25)
+   (func (export "g") (param i32) (result i32)
+     (br_table 0 1 2 3 (local.get 0)) returning 10, 20, 30 or 40)
+   The constants of f and the table of g are put into the read-only data
+   sections of the object file */
+static const uint8_t wasm_bytes[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    /* type section */
+    0x01, 0x0b, 0x02, 0x60, 0x01, 0x7c, 0x01, 0x7c, 0x60, 0x01, 0x7f, 0x01,
+    0x7f,
+    /* function section */
+    0x03, 0x03, 0x02, 0x00, 0x01,
+    /* export section */
+    0x07, 0x09, 0x02, 0x01, 'f', 0x00, 0x00, 0x01, 'g', 0x00, 0x01,
+    /* code section */
+    0x0a, 0x3c, 0x02,
+    /* f */
+    0x18, 0x00, 0x20, 0x00, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8,
+    0x3f, 0xa2, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd0, 0x3f, 0xa0,
+    0x0b,
+    /* g */
+    0x21, 0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00,
+    0x0e, 0x03, 0x00, 0x01, 0x02, 0x03, 0x0b, 0x41, 0x0a, 0x0f, 0x0b, 0x41,
+    0x14, 0x0f, 0x0b, 0x41, 0x1e, 0x0f, 0x0b, 0x41, 0x28, 0x0b,
+};
+
+/* A relocation group of the AOT file, and the symbols referred to by its
+   relocations */
+struct RelocationGroup {
+    std::string name;
+    std::set<std::string> symbols;
+};
+
+class aot_shared_text_test_suit : public testing::Test
+{
+  protected:
+    virtual void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+        if (mapped)
+            os_munmap(mapped, aot_size);
+        if (aot_buf)
+            wasm_runtime_free(aot_buf);
+        if (!file_name.empty())
+            unlink(file_name.c_str());
+    }
+
+    void compile(bool enable_shared_text)
+    {
+        std::vector<uint8_t> wasm(wasm_bytes, wasm_bytes + sizeof(wasm_bytes));
+        char error_buf[128] = { 0 };
+        wasm_module_t wasm_module;
+        AOTCompData *comp_data;
+        AOTCompContext *comp_ctx;
+        AOTCompOption option = { 0 };
+
+        wasm_module = wasm_runtime_load(wasm.data(), (uint32_t)wasm.size(),
+                                        error_buf, sizeof(error_buf));
+        ASSERT_NE(wasm_module, nullptr) << error_buf;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.target_arch = (char *)"x86_64";
+        option.is_indirect_mode = true;
+        option.enable_shared_text = enable_shared_text;
+        comp_data =
+            aot_create_comp_data((WASMModule *)wasm_module, NULL, false);
+        ASSERT_NE(comp_data, nullptr);
+        comp_ctx = aot_create_comp_context(comp_data, &option);
+        ASSERT_NE(comp_ctx, nullptr) << aot_get_last_error();
+        ASSERT_TRUE(aot_compile_wasm(comp_ctx)) << aot_get_last_error();
+        aot_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_size);
+        ASSERT_NE(aot_buf, nullptr) << aot_get_last_error();
+
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+        wasm_runtime_unload(wasm_module);
+    }
+
+    /* Get the offset of the first section of the type in the AOT file */
+    uint32_t find_section(uint32_t type)
+    {
+        uint32_t offset = 8, section_size;
+
+        while (offset + 8 <= aot_size) {
+            offset = (offset + 3) & ~3u;
+            section_size = *(uint32_t *)(aot_buf + offset + 4);
+            if (*(uint32_t *)(aot_buf + offset) == type)
+                return offset;
+            offset += 8 + section_size;
+        }
+        return 0;
+    }
+
+    /* Parse the relocation section, see aot_emit_relocation_section */
+    std::vector<RelocationGroup> read_relocation_groups()
+    {
+        std::vector<RelocationGroup> groups;
+        std::vector<std::string> symbols;
+        uint32_t offset = find_section(AOT_SECTION_TYPE_RELOCATION);
+        uint32_t symbol_count, group_count, relocation_count, i, j;
+        uint8_t *strings;
+
+        EXPECT_NE(offset, 0u);
+        if (!offset)
+            return groups;
+        offset += 8;
+
+        symbol_count = *(uint32_t *)(aot_buf + offset);
+        strings = aot_buf + offset + 4 + symbol_count * 4 + 4;
+        for (i = 0; i < symbol_count; i++) {
+            uint32_t symbol_offset =
+                *(uint32_t *)(aot_buf + offset + 4 + i * 4);
+            /* string length including '\0' + string */
+            symbols.push_back((const char *)strings + symbol_offset + 2);
+        }
+        offset = (uint32_t)(strings - aot_buf)
+                 + *(uint32_t *)(strings - sizeof(uint32_t));
+        offset = (offset + 3) & ~3u;
+
+        group_count = *(uint32_t *)(aot_buf + offset);
+        offset += 4;
+        for (i = 0; i < group_count; i++) {
+            RelocationGroup group;
+
+            group.name = symbols[*(uint32_t *)(aot_buf + offset)];
+            relocation_count = *(uint32_t *)(aot_buf + offset + 4);
+            offset += 8;
+            for (j = 0; j < relocation_count; j++) {
+                /* offset (8 bytes), addend (8 bytes), type, symbol index */
+                group.symbols.insert(
+                    symbols[*(uint32_t *)(aot_buf + offset + 20)]);
+                offset += 24;
+            }
+            groups.push_back(group);
+        }
+        return groups;
+    }
+
+    /* Load the AOT file from a private file mapping like iwasm does for
+       the XIP files */
+    void load_from_file_mapping()
+    {
+        char error_buf[128] = { 0 };
+        char file_template[] = "/tmp/wamr_shared_text_XXXXXX";
+        int fd;
+
+        ASSERT_GE(fd = mkstemp(file_template), 0);
+        file_name = file_template;
+        ASSERT_EQ(write(fd, aot_buf, aot_size), (ssize_t)aot_size);
+        mapped = (uint8_t *)os_mmap(
+            NULL, aot_size,
+            MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC, 0, fd);
+        close(fd);
+        ASSERT_NE(mapped, nullptr);
+
+        ASSERT_TRUE(wasm_runtime_is_xip_file(mapped, aot_size));
+        module =
+            wasm_runtime_load(mapped, aot_size, error_buf, sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+    }
+
+    void check_results()
+    {
+        char error_buf[128] = { 0 };
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        wasm_val_t args[1], results[1];
+        int32_t i;
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        func = wasm_runtime_lookup_function(module_inst, "f");
+        ASSERT_NE(func, nullptr);
+        args[0].kind = WASM_F64;
+        args[0].of.f64 = 2.0;
+        EXPECT_TRUE(
+            wasm_runtime_call_wasm_a(exec_env, func, 1, results, 1, args));
+        EXPECT_EQ(results[0].of.f64, 3.25);
+
+        func = wasm_runtime_lookup_function(module_inst, "g");
+        ASSERT_NE(func, nullptr);
+        for (i = 0; i < 5; i++) {
+            args[0].kind = WASM_I32;
+            args[0].of.i32 = i;
+            EXPECT_TRUE(
+                wasm_runtime_call_wasm_a(exec_env, func, 1, results, 1, args));
+            EXPECT_EQ(results[0].of.i32, (i < 3 ? i + 1 : 4) * 10);
+        }
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    uint8_t *aot_buf = nullptr;
+    uint32_t aot_size = 0;
+    uint8_t *mapped = nullptr;
+    std::string file_name;
+    wasm_module_t module = nullptr;
+};
+
+static bool
+is_text_section(const std::string &name)
+{
+    return name.find(".text") != std::string::npos
+           || name.find(".rodata") != std::string::npos;
+}
+
+TEST_F(aot_shared_text_test_suit, indirect_mode_has_text_relocations)
+{
+    bool found = false;
+
+    /* Without shared text, the code refers to its constants in the
+       read-only data sections through relocations */
+    compile(false);
+    for (auto &group : read_relocation_groups()) {
+        if (group.name != ".rela.text")
+            continue;
+        for (auto &symbol : group.symbols) {
+            if (symbol.find(".rodata") == 0)
+                found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST_F(aot_shared_text_test_suit, no_text_relocations)
+{
+    uint32_t offset, padding, text_size;
+    std::vector<uint8_t> text;
+
+    compile(true);
+
+    /* Only the relocations of the writable data may remain */
+    for (auto &group : read_relocation_groups())
+        EXPECT_FALSE(is_text_section(group.name)) << group.name;
+
+    /* The code follows the padding and is aligned in the file */
+    offset = find_section(AOT_SECTION_TYPE_TEXT);
+    ASSERT_NE(offset, 0u);
+    padding = *(uint32_t *)(aot_buf + offset + 8);
+    text_size = *(uint32_t *)(aot_buf + offset + 4) - 4 - padding;
+    offset += 12 + padding;
+    EXPECT_EQ(offset % 64, 0u);
+    text.assign(aot_buf + offset, aot_buf + offset + text_size);
+
+    /* The text is run in place and the loader doesn't patch it */
+    load_from_file_mapping();
+    check_results();
+    EXPECT_EQ(memcmp(mapped + offset, text.data(), text_size), 0);
+}
+
+#endif /* end of defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) */
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+#include "aot_export.h"
+#include "bh_read_file.h"
+
+static std::string CWD;
+
+static std::string
+get_binary_path()
+{
+    char cwd[1024];
+    memset(cwd, 0, 1024);
+
+    if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+    }
+
+    char *path_end = strrchr(cwd, '/');
+    if (path_end != NULL) {
+        *path_end = '\0';
+    }
+
+    return std::string(cwd);
+}
+
+static uint32_t host_add_calls;
+
+static int32_t
+host_add(wasm_exec_env_t exec_env, int32_t a, int32_t b)
+{
+    host_add_calls++;
+    return a + b;
+}
+
+static NativeSymbol native_symbols[] = {
+    { "host_add", (void *)host_add, "(ii)i", NULL },
+};
+
+class aot_static_link_test_suit : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        host_add_calls = 0;
+        ASSERT_TRUE(wasm_runtime_register_natives(
+            "env", native_symbols,
+            sizeof(native_symbols) / sizeof(NativeSymbol)));
+    }
+
+    static void SetUpTestCase() { CWD = get_binary_path(); }
+
+    virtual void TearDown()
+    {
+        uint32_t i;
+
+        for (i = 0; i < module_count; i++)
+            BH_FREE(wasm_bufs[i]);
+        if (linked_buf)
+            wasm_runtime_free(linked_buf);
+    }
+
+    /* The module name is the file name without the extension */
+    void load_modules(std::initializer_list<const char *> names)
+    {
+        for (const char *name : names) {
+            std::string path = CWD + "/" + name + ".wasm";
+
+            ASSERT_LT(module_count, 4u);
+            module_names[module_count] = name;
+            wasm_bufs[module_count] = (uint8_t *)bh_read_file_to_buffer(
+                path.c_str(), &wasm_buf_sizes[module_count]);
+            ASSERT_NE(wasm_bufs[module_count], nullptr);
+            module_count++;
+        }
+    }
+
+    bool link()
+    {
+        return aot_link_wasm_modules(module_names, wasm_bufs, wasm_buf_sizes,
+                                     module_count, &linked_buf, &linked_size);
+    }
+
+    /* Instantiate the module, which runs the start functions, and check
+       the calls through all the modules */
+    void run_linked_module(uint8_t *buf, uint32_t size)
+    {
+        char error_buf[128] = { 0 };
+        wasm_module_t module;
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        wasm_val_t args[1], results[1];
+
+        module = wasm_runtime_load(buf, size, error_buf, sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        /* the imports of env.host_add are merged and the exports of the
+           libraries are dropped */
+        EXPECT_EQ(wasm_runtime_get_import_count(module), 1);
+        EXPECT_EQ(wasm_runtime_get_export_count(module), 3);
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        /* the start functions of the libraries run before the one of the
+           main module, each appends its digit to mem[0] */
+        func = wasm_runtime_lookup_function(module_inst, "start_order");
+        ASSERT_NE(func, nullptr);
+        ASSERT_TRUE(
+            wasm_runtime_call_wasm_a(exec_env, func, 1, results, 0, NULL));
+        EXPECT_EQ(results[0].of.i32, 123);
+
+        /* main -> libfoo -> libbar, and libbar's mul re-exported by libfoo,
+           test(x) = (x * x + 1) * 2 + 3 */
+        func = wasm_runtime_lookup_function(module_inst, "test");
+        ASSERT_NE(func, nullptr);
+        args[0].kind = WASM_I32;
+        args[0].of.i32 = 3;
+        ASSERT_TRUE(
+            wasm_runtime_call_wasm_a(exec_env, func, 1, results, 1, args));
+        EXPECT_EQ(results[0].of.i32, 23);
+        EXPECT_EQ(host_add_calls, 2u);
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    const char *module_names[4];
+    uint8_t *wasm_bufs[4] = { 0 };
+    uint32_t wasm_buf_sizes[4];
+    uint32_t module_count = 0;
+    uint8_t *linked_buf = nullptr;
+    uint32_t linked_size = 0;
+};
+
+TEST_F(aot_static_link_test_suit, link_and_run)
+{
+    load_modules({ "link_main", "link_libfoo", "link_libbar" });
+    ASSERT_TRUE(link()) << aot_get_last_error();
+    ASSERT_NE(linked_buf, nullptr);
+
+    run_linked_module(linked_buf, linked_size);
+}
+
+TEST_F(aot_static_link_test_suit, link_and_run_aot)
+{
+    char error_buf[128] = { 0 };
+    wasm_module_t wasm_module;
+    aot_comp_data_t comp_data;
+    aot_comp_context_t comp_ctx;
+    AOTCompOption option = { 0 };
+    uint8_t *aot_buf;
+    uint32_t aot_size = 0;
+
+    load_modules({ "link_main", "link_libfoo", "link_libbar" });
+    ASSERT_TRUE(link()) << aot_get_last_error();
+
+    wasm_module = wasm_runtime_load(linked_buf, linked_size, error_buf,
+                                    sizeof(error_buf));
+    ASSERT_NE(wasm_module, nullptr) << error_buf;
+
+    option.opt_level = 3;
+    option.size_level = 3;
+    option.output_format = AOT_FORMAT_FILE;
+    option.bounds_checks = 2;
+    option.enable_bulk_memory = true;
+    comp_data = aot_create_comp_data(wasm_module, NULL, false);
+    ASSERT_NE(comp_data, nullptr);
+    comp_ctx = aot_create_comp_context(comp_data, &option);
+    ASSERT_NE(comp_ctx, nullptr);
+    ASSERT_TRUE(aot_compile_wasm(comp_ctx));
+    aot_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_size);
+    ASSERT_NE(aot_buf, nullptr);
+
+    run_linked_module(aot_buf, aot_size);
+
+    wasm_runtime_free(aot_buf);
+    aot_destroy_comp_context(comp_ctx);
+    aot_destroy_comp_data(comp_data);
+    wasm_runtime_unload(wasm_module);
+}
+
+TEST_F(aot_static_link_test_suit, circular_re_export)
+{
+    load_modules(
+        { "link_circular_main", "link_circular_a", "link_circular_b" });
+    EXPECT_FALSE(link());
+    EXPECT_EQ(linked_buf, nullptr);
+    EXPECT_NE(strstr(aot_get_last_error(), "is circular"), nullptr)
+        << aot_get_last_error();
+}
+
+TEST_F(aot_static_link_test_suit, import_type_mismatch)
+{
+    /* imports libbar.mul as (i32)->i32 instead of (i32, i32)->i32 */
+    load_modules({ "link_type_mismatch", "link_libbar" });
+    EXPECT_FALSE(link());
+    EXPECT_EQ(linked_buf, nullptr);
+    EXPECT_NE(strstr(aot_get_last_error(), "incompatible import type"),
+              nullptr)
+        << aot_get_last_error();
+}
+
+TEST_F(aot_static_link_test_suit, gc_types)
+{
+    load_modules({ "link_main", "link_gc_type" });
+    EXPECT_FALSE(link());
+    EXPECT_EQ(linked_buf, nullptr);
+    EXPECT_NE(strstr(aot_get_last_error(), "GC types are not supported"),
+              nullptr)
+        << aot_get_last_error();
+}
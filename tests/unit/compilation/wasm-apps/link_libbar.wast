@@ -0,0 +1,17 @@
+(module
+  (import "link_main" "memory" (memory 1))
+  (import "env" "host_add" (func $host_add (param i32 i32) (result i32)))
+
+  (func (export "mul") (param i32 i32) (result i32)
+    (i32.mul (local.get 0) (local.get 1))
+  )
+  (func (export "add3") (param i32) (result i32)
+    (call $host_add (local.get 0) (i32.const 3))
+  )
+
+  (func $start
+    (i32.store (i32.const 0)
+      (i32.add (i32.mul (i32.load (i32.const 0)) (i32.const 10)) (i32.const 2)))
+  )
+  (start $start)
+)
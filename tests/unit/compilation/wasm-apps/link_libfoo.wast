@@ -0,0 +1,17 @@
+(module
+  (import "link_main" "memory" (memory 1))
+  ;; the same import as the main module
+  (import "env" "host_add" (func $host_add (param i32 i32) (result i32)))
+  (import "link_libbar" "mul" (func $mul (param i32 i32) (result i32)))
+
+  (func (export "square_plus") (param i32) (result i32)
+    (call $host_add (call $mul (local.get 0) (local.get 0)) (i32.const 1))
+  )
+  (export "mul" (func $mul))
+
+  (func $start
+    (i32.store (i32.const 0)
+      (i32.add (i32.mul (i32.load (i32.const 0)) (i32.const 10)) (i32.const 1)))
+  )
+  (start $start)
+)
@@ -0,0 +1,20 @@
+(module
+  (import "env" "host_add" (func $host_add (param i32 i32) (result i32)))
+  (import "link_libfoo" "square_plus" (func $square_plus (param i32) (result i32)))
+  ;; libbar's mul re-exported by libfoo
+  (import "link_libfoo" "mul" (func $mul (param i32 i32) (result i32)))
+  (import "link_libbar" "add3" (func $add3 (param i32) (result i32)))
+  (memory (export "memory") 1)
+
+  ;; (x * x + 1) * 2 + 3
+  (func (export "test") (param i32) (result i32)
+    (call $add3 (call $mul (call $square_plus (local.get 0)) (i32.const 2)))
+  )
+  (func (export "start_order") (result i32) (i32.load (i32.const 0)))
+
+  (func $start
+    (i32.store (i32.const 0)
+      (i32.add (i32.mul (i32.load (i32.const 0)) (i32.const 10)) (i32.const 3)))
+  )
+  (start $start)
+)
@@ -0,0 +1,17 @@
+(module
+  (type $i32_i32 (func (param i32) (result i32)))
+  (type $i32_i32_i32 (func (param i32 i32) (result i32)))
+
+  ;; not exported nor modified, so the slots are known at compile time
+  (table 4 funcref)
+  (elem (i32.const 0) $add1 $mul2 $sub3 $add)
+
+  (func $add1 (type $i32_i32) (i32.add (local.get 0) (i32.const 1)))
+  (func $mul2 (type $i32_i32) (i32.mul (local.get 0) (i32.const 2)))
+  (func $sub3 (type $i32_i32) (i32.sub (local.get 0) (i32.const 3)))
+  (func $add (type $i32_i32_i32) (i32.add (local.get 0) (local.get 1)))
+
+  (func (export "dispatch") (param $elem_idx i32) (param $x i32) (result i32)
+    (call_indirect (type $i32_i32) (local.get $x) (local.get $elem_idx))
+  )
+)
@@ -0,0 +1,12 @@
+(module
+  ;; defined from the coldest to the hottest
+  (func (export "cold") (param i32) (result i32)
+    (i32.mul (i32.add (local.get 0) (i32.const 1)) (i32.const 3))
+  )
+  (func (export "warm") (param i32) (result i32)
+    (i32.mul (i32.add (local.get 0) (i32.const 2)) (i32.const 5))
+  )
+  (func (export "hot") (param i32) (result i32)
+    (i32.mul (i32.add (local.get 0) (i32.const 3)) (i32.const 7))
+  )
+)
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "aot_export.h"
+
+#include <vector>
+
+static std::string
+get_binary_path()
+{
+    char cwd[1024] = { 0 };
+
+    if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+        return NULL;
+    }
+
+    char *path_end = strrchr(cwd, '/');
+    if (path_end != NULL) {
+        *path_end = '\0';
+    }
+
+    return std::string(cwd);
+}
+
+/* The wasm module and the AOT file compiled from it with the exception
+   handling enabled, the module is compiled before all the tests since
+   LLVM can't be initialized again after it is shut down by the
+   wasm_runtime_destroy of each test */
+class ExceptionHandlingEnvironment : public testing::Environment
+{
+  private:
+    /* Compile the wasm module to an AOT file in the buffer */
+    static bool compile(wasm_module_t module)
+    {
+        AOTCompOption option = { 0 };
+        aot_comp_data_t comp_data;
+        aot_comp_context_t comp_ctx;
+        uint8 *aot_file_buf = NULL;
+        uint32 aot_file_size;
+
+        option.opt_level = 3;
+        option.size_level = 3;
+        option.output_format = AOT_FORMAT_FILE;
+        option.bounds_checks = 2;
+        option.enable_bulk_memory = true;
+        option.enable_ref_types = true;
+        option.enable_exce_handling = true;
+
+        if (!(comp_data = aot_create_comp_data(module, NULL, false)))
+            return false;
+
+        if (!(comp_ctx = aot_create_comp_context(comp_data, &option))) {
+            aot_destroy_comp_data(comp_data);
+            return false;
+        }
+
+        if (aot_compile_wasm(comp_ctx))
+            aot_file_buf = aot_emit_aot_file_buf(comp_ctx, comp_data,
+                                                 &aot_file_size);
+
+        aot_destroy_comp_context(comp_ctx);
+        aot_destroy_comp_data(comp_data);
+
+        if (!aot_file_buf)
+            return false;
+        aot_file.assign(aot_file_buf, aot_file_buf + aot_file_size);
+        wasm_runtime_free(aot_file_buf);
+        return true;
+    }
+
+  public:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/exception_handling.wasm";
+        unsigned char *wasm_file_buf;
+        uint32 wasm_file_size;
+        wasm_module_t module;
+        char error_buf[128];
+
+        ASSERT_TRUE(wasm_runtime_init());
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+        /* keep a copy, the loader may modify the buffer */
+        wasm_file.assign(wasm_file_buf, wasm_file_buf + wasm_file_size);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        EXPECT_NE(module, nullptr) << error_buf;
+        if (module) {
+            EXPECT_TRUE(compile(module)) << aot_get_last_error();
+            wasm_runtime_unload(module);
+        }
+
+        wasm_runtime_free(wasm_file_buf);
+        wasm_runtime_destroy();
+    }
+
+    static std::vector<uint8> wasm_file;
+    static std::vector<uint8> aot_file;
+};
+
+std::vector<uint8> ExceptionHandlingEnvironment::wasm_file;
+std::vector<uint8> ExceptionHandlingEnvironment::aot_file;
+
+static testing::Environment *const exception_handling_env =
+    testing::AddGlobalTestEnvironment(new ExceptionHandlingEnvironment);
+
+/* Set a trap with the message of a wasm exception, the AOT code must not
+   take it as a wasm exception */
+static int32
+host_trap(wasm_exec_env_t exec_env, int32 x)
+{
+    wasm_module_inst_t inst = wasm_runtime_get_module_inst(exec_env);
+
+    wasm_runtime_set_exception(inst, x == 0 ? "uncaught wasm exception"
+                                            : "exception thrown by stdc++");
+    return 0;
+}
+
+static NativeSymbol native_symbols[] = {
+    { "host_trap", (void *)host_trap, "(i)i", NULL },
+};
+
+/* Tests of try/catch/throw/rethrow/delegate, the module is run by the
+   interpreter and as AOT code, the results must be the same */
+class ExceptionHandlingTest : public testing::TestWithParam<bool>
+{
+  protected:
+    void SetUp()
+    {
+        ASSERT_TRUE(wasm_runtime_register_natives(
+            "env", native_symbols,
+            sizeof(native_symbols) / sizeof(NativeSymbol)));
+
+        /* the loader may modify the buffer, load from a copy */
+        buf = GetParam() ? ExceptionHandlingEnvironment::aot_file
+                         : ExceptionHandlingEnvironment::wasm_file;
+        ASSERT_FALSE(buf.empty());
+
+        module = wasm_runtime_load(buf.data(), (uint32)buf.size(), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        ASSERT_EQ(wasm_runtime_get_module_package_type(module),
+                  GetParam() ? Wasm_Module_AoT : Wasm_Module_Bytecode);
+
+        inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                        sizeof(error_buf));
+        ASSERT_NE(inst, nullptr) << error_buf;
+    }
+
+    void TearDown()
+    {
+        if (inst)
+            wasm_runtime_deinstantiate(inst);
+        if (module)
+            wasm_runtime_unload(module);
+    }
+
+  public:
+    bool call(const char *name, uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, 1, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 call_i32(const char *name, uint32 arg)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call(name, argv))
+            << name << " " << wasm_runtime_get_exception(inst);
+        return argv[0];
+    }
+
+    /* The call fails with the exception */
+    void expect_exception(const char *name, uint32 arg, const char *expected)
+    {
+        uint32 argv[1] = { arg };
+        const char *exception;
+
+        EXPECT_FALSE(call(name, argv)) << name;
+        exception = wasm_runtime_get_exception(inst);
+        ASSERT_NE(exception, nullptr) << name;
+        EXPECT_NE(strstr(exception, expected), nullptr) << exception;
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    std::vector<uint8> buf;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t inst = NULL;
+    char error_buf[128];
+};
+
+TEST_P(ExceptionHandlingTest, test_catch)
+{
+    /* the exceptions thrown by the callee are caught by the tags */
+    EXPECT_EQ(call_i32("test_catch", 0), 142);
+    EXPECT_EQ(call_i32("test_catch", 1), 200);
+    EXPECT_EQ(call_i32("test_catch", 5), 5);
+    EXPECT_EQ(call_i32("test_catch_all", 0), (uint32)-1);
+    EXPECT_EQ(call_i32("test_catch_all", 1), (uint32)-1);
+    EXPECT_EQ(call_i32("test_catch_all", 5), 5);
+
+    /* thrown and caught in the same function */
+    EXPECT_EQ(call_i32("test_local_throw", 3), 4);
+}
+
+TEST_P(ExceptionHandlingTest, test_rethrow)
+{
+    EXPECT_EQ(call_i32("test_rethrow", 0), 1042);
+    EXPECT_EQ(call_i32("test_rethrow", 5), 5);
+    EXPECT_EQ(call_i32("test_rethrow_i64", 1), 3022);
+    EXPECT_EQ(call_i32("test_rethrow_i64", 5), 5);
+
+    /* rethrown by the callee and caught by the caller */
+    EXPECT_EQ(call_i32("test_rethrow_frames", 0), 3042);
+    EXPECT_EQ(call_i32("test_rethrow_frames", 4), 4);
+    expect_exception("test_rethrow_frames", 1, "uncaught wasm exception");
+    expect_exception("rethrow_inner", 0, "uncaught wasm exception");
+}
+
+TEST_P(ExceptionHandlingTest, test_delegate)
+{
+    EXPECT_EQ(call_i32("test_delegate", 0), 2042);
+    EXPECT_EQ(call_i32("test_delegate", 5), 5);
+    expect_exception("test_delegate", 1, "uncaught wasm exception");
+}
+
+TEST_P(ExceptionHandlingTest, test_uncaught)
+{
+    expect_exception("test_uncaught", 0, "uncaught wasm exception");
+    expect_exception("thrower", 1, "uncaught wasm exception");
+
+    /* the instance can still be used after the exception */
+    EXPECT_EQ(call_i32("test_uncaught", 5), 5);
+    EXPECT_EQ(call_i32("test_catch", 0), 142);
+}
+
+TEST_P(ExceptionHandlingTest, test_trap_not_caught)
+{
+    expect_exception("test_trap", 0, "unreachable");
+}
+
+TEST_P(ExceptionHandlingTest, test_catch_in_loop)
+{
+    /* each iteration enters the handler and leaves it */
+    EXPECT_EQ(call_i32("test_catch_in_loop", 1), 1);
+    EXPECT_EQ(call_i32("test_catch_in_loop", 1000), 1000);
+}
+
+TEST_P(ExceptionHandlingTest, test_host_trap_not_caught)
+{
+    /* the classic interpreter tells them apart by the message */
+    if (!GetParam())
+        return;
+
+    expect_exception("test_host_trap", 0, "uncaught wasm exception");
+    expect_exception("test_host_trap", 1, "exception thrown by stdc++");
+
+    /* the wasm exception returned to the host isn't caught later */
+    expect_exception("test_uncaught", 0, "uncaught wasm exception");
+    expect_exception("test_host_trap", 0, "uncaught wasm exception");
+    EXPECT_EQ(call_i32("test_catch", 0), 142);
+}
+
+/* false for the interpreter and true for AOT */
+INSTANTIATE_TEST_CASE_P(RunningMode, ExceptionHandlingTest,
+                        testing::Values(false, true));
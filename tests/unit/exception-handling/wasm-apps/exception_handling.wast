@@ -0,0 +1,132 @@
+(module
+  ;; sets a trap with the same message as a wasm exception
+  (import "env" "host_trap" (func $host_trap (param i32) (result i32)))
+
+  (tag $e0 (param i32))
+  (tag $e1 (param i64 f64))
+
+  ;; throw $e0 (42) if x is 0, $e1 (7, 1.5) if x is 1, otherwise return x
+  (func $thrower (export "thrower") (param $x i32) (result i32)
+    (if (i32.eqz (local.get $x))
+      (then (throw $e0 (i32.const 42))))
+    (if (i32.eq (local.get $x) (i32.const 1))
+      (then (throw $e1 (i64.const 7) (f64.const 1.5))))
+    (local.get $x)
+  )
+
+  (func (export "test_catch") (param $x i32) (result i32)
+    (try (result i32)
+      (do (call $thrower (local.get $x)))
+      (catch $e0 (i32.add (i32.const 100)))
+      (catch $e1 (drop) (drop) (i32.const 200))
+    )
+  )
+
+  (func (export "test_catch_all") (param $x i32) (result i32)
+    (try (result i32)
+      (do (call $thrower (local.get $x)))
+      (catch_all (i32.const -1))
+    )
+  )
+
+  (func (export "test_rethrow") (param $x i32) (result i32)
+    (try (result i32)
+      (do
+        (try (result i32)
+          (do (call $thrower (local.get $x)))
+          (catch $e0 (drop) (rethrow 0))
+        )
+      )
+      (catch $e0 (i32.add (i32.const 1000)))
+    )
+  )
+
+  (func (export "test_delegate") (param $x i32) (result i32)
+    (try (result i32)
+      (do
+        (try (result i32)
+          (do (call $thrower (local.get $x)))
+          (delegate 0)
+        )
+      )
+      (catch $e0 (i32.add (i32.const 2000)))
+    )
+  )
+
+  (func (export "test_uncaught") (param $x i32) (result i32)
+    (call $thrower (local.get $x))
+  )
+
+  ;; traps are not caught
+  (func (export "test_trap") (param $x i32) (result i32)
+    (try (result i32)
+      (do (unreachable))
+      (catch_all (i32.const 5))
+    )
+  )
+
+  (func (export "test_local_throw") (param $x i32) (result i32)
+    (try (result i32)
+      (do (throw $e0 (local.get $x)))
+      (catch $e0 (i32.add (i32.const 1)))
+    )
+  )
+
+  (func $rethrow_inner (export "rethrow_inner") (param $x i32) (result i32)
+    (try (result i32)
+      (do (call $thrower (local.get $x)))
+      (catch_all (rethrow 0))
+    )
+  )
+
+  ;; the exception rethrown by the callee is caught by the caller
+  (func (export "test_rethrow_frames") (param $x i32) (result i32)
+    (try (result i32)
+      (do (call $rethrow_inner (local.get $x)))
+      (catch $e0 (i32.add (i32.const 3000)))
+    )
+  )
+
+  ;; catch an exception in each of the n iterations, return the count
+  (func (export "test_catch_in_loop") (param $n i32) (result i32)
+    (local $i i32) (local $count i32)
+    (loop $loop
+      (try
+        (do (drop (call $thrower (i32.const 0))))
+        (catch $e0
+          (drop)
+          (local.set $count (i32.add (local.get $count) (i32.const 1))))
+      )
+      (br_if $loop
+        (i32.lt_u (local.tee $i (i32.add (local.get $i) (i32.const 1)))
+                  (local.get $n)))
+    )
+    (local.get $count)
+  )
+
+  ;; the values of the exception are kept when rethrown
+  (func (export "test_rethrow_i64") (param $x i32) (result i32)
+    (local $f f64)
+    (try (result i32)
+      (do
+        (try (result i32)
+          (do (call $thrower (local.get $x)))
+          (catch $e1 (drop) (drop) (rethrow 0))
+        )
+      )
+      (catch $e1
+        (local.set $f)
+        (i32.add (i32.wrap_i64)
+                 (i32.trunc_f64_s (f64.mul (local.get $f) (f64.const 10))))
+        (i32.add (i32.const 3000)))
+    )
+  )
+
+  ;; the traps set by the host are not caught
+  (func (export "test_host_trap") (param $x i32) (result i32)
+    (try (result i32)
+      (do (call $host_trap (local.get $x)))
+      (catch_all (i32.const -1))
+    )
+  )
+)
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "gc_export.h"
+
+#define GC_HEAP_INIT_SIZE (64 * 1024)
+#define GC_HEAP_MAX_SIZE (16 * 1024 * 1024)
+
+/* Tests of the GC heap which grows from gc_heap_size to gc_heap_max_size
+   on demand, heap1.wasm allocates arrays of 1KB */
+class WasmGCHeapTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.gc_heap_size = GC_HEAP_INIT_SIZE;
+        init_args.gc_heap_max_size = GC_HEAP_MAX_SIZE;
+
+        ASSERT_EQ(wasm_runtime_full_init(&init_args), true);
+    }
+
+    void TearDown()
+    {
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    bool instantiate(const char *wasm_file)
+    {
+        std::string file = CWD + "/" + wasm_file;
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        if (!wasm_file_buf)
+            return false;
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        if (!module)
+            return false;
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        if (!module_inst)
+            return false;
+
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        return exec_env != NULL;
+    }
+
+    bool call_argv(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+
+        return func && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    bool call(const char *name, uint32 argc, uint32 arg)
+    {
+        uint32 argv[1] = { arg };
+
+        return call_argv(name, argc, argv);
+    }
+
+    uint32 call_i32(const char *name, uint32 argc, uint32 arg)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call_argv(name, argc, argv)) << name;
+        return argv[0];
+    }
+
+    wasm_gc_heap_stats_t get_stats()
+    {
+        wasm_gc_heap_stats_t stats;
+
+        memset(&stats, 0, sizeof(stats));
+        EXPECT_TRUE(wasm_runtime_get_gc_heap_stats(module_inst, &stats));
+        return stats;
+    }
+
+  public:
+    std::string CWD;
+    RuntimeInitArgs init_args;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+    char error_buf[128];
+};
+
+TEST_F(WasmGCHeapTest, test_heap_stats)
+{
+    wasm_gc_heap_stats_t stats;
+
+    ASSERT_TRUE(instantiate("heap1.wasm"));
+
+    stats = get_stats();
+    EXPECT_GE(stats.total_size, GC_HEAP_INIT_SIZE - 1024);
+    EXPECT_LE(stats.total_size, GC_HEAP_INIT_SIZE);
+    EXPECT_GT(stats.total_free_size, 0);
+    EXPECT_LE(stats.total_free_size, stats.total_size);
+    EXPECT_GT(stats.max_size, GC_HEAP_MAX_SIZE - 64 * 1024);
+    EXPECT_LE(stats.max_size, GC_HEAP_MAX_SIZE);
+    EXPECT_EQ(stats.grow_count, 0);
+    EXPECT_EQ(stats.shrink_count, 0);
+}
+
+TEST_F(WasmGCHeapTest, test_heap_grow)
+{
+    wasm_gc_heap_stats_t stats;
+
+    ASSERT_TRUE(instantiate("heap1.wasm"));
+
+    /* 2MB of live objects don't fit in the initial heap */
+    ASSERT_TRUE(call("fill", 1, 2048));
+
+    stats = get_stats();
+    EXPECT_GT(stats.grow_count, 0);
+    EXPECT_GT(stats.total_size, 2 * 1024 * 1024);
+    EXPECT_LE(stats.total_size, stats.max_size);
+    EXPECT_GE(stats.highmark_size, 2 * 1024 * 1024);
+}
+
+TEST_F(WasmGCHeapTest, test_heap_grow_to_max_size)
+{
+    wasm_gc_heap_stats_t stats;
+
+    ASSERT_TRUE(instantiate("heap1.wasm"));
+
+    /* 32MB of live objects exceed the max size */
+    EXPECT_FALSE(call("fill", 1, 32 * 1024));
+
+    stats = get_stats();
+    EXPECT_EQ(stats.total_size, stats.max_size);
+}
+
+TEST_F(WasmGCHeapTest, test_heap_shrink)
+{
+    wasm_gc_heap_stats_t stats;
+    uint32 grown_size;
+
+    ASSERT_TRUE(instantiate("heap1.wasm"));
+
+    ASSERT_TRUE(call("fill", 1, 2048));
+    grown_size = get_stats().total_size;
+
+    /* the heap is shrunk in the collections after the objects die */
+    ASSERT_TRUE(call("clear", 0, 0));
+    ASSERT_TRUE(call("churn", 1, 64 * 1024));
+
+    stats = get_stats();
+    EXPECT_GT(stats.shrink_count, 0);
+    EXPECT_LT(stats.total_size, grown_size);
+    EXPECT_GE(stats.total_size, GC_HEAP_INIT_SIZE - 1024);
+}
+
+TEST_F(WasmGCHeapTest, test_heap_no_grow_without_pressure)
+{
+    wasm_gc_heap_stats_t stats;
+
+    ASSERT_TRUE(instantiate("heap1.wasm"));
+
+    /* the frequent collections free almost the whole heap, the heap
+       needn't grow no matter how high the allocation rate is */
+    ASSERT_TRUE(call("churn", 1, 64 * 1024));
+
+    stats = get_stats();
+    EXPECT_EQ(stats.grow_count, 0);
+    EXPECT_LE(stats.total_size, GC_HEAP_INIT_SIZE);
+}
+
+TEST_F(WasmGCHeapTest, test_minor_gc_old_to_young_ref)
+{
+    uint32 argv[2], i;
+
+    ASSERT_TRUE(instantiate("generational1.wasm"));
+
+    /* the holder and the node survive the collections and become old */
+    ASSERT_TRUE(call("init", 1, 16));
+    ASSERT_TRUE(call("churn", 1, 128));
+
+    /* the new boxes are only referred by the old objects, the write
+       barrier remembers the old objects so that the minor collections
+       trace them, otherwise the boxes are freed and overwritten */
+    for (i = 0; i < 16; i++) {
+        argv[0] = i;
+        argv[1] = 1000 + i;
+        ASSERT_TRUE(call_argv("set", 2, argv));
+    }
+    ASSERT_TRUE(call("set_node", 1, 2000));
+    ASSERT_TRUE(call("churn", 1, 128));
+
+    for (i = 0; i < 16; i++)
+        EXPECT_EQ(call_i32("get", 1, i), 1000 + i);
+    EXPECT_EQ(call_i32("get_node", 0, 0), 2000);
+
+    /* the old objects are remembered again when written again */
+    argv[0] = 3;
+    argv[1] = 3000;
+    ASSERT_TRUE(call_argv("set", 2, argv));
+    ASSERT_TRUE(call("set_node", 1, 4000));
+    ASSERT_TRUE(call("churn", 1, 128));
+
+    EXPECT_EQ(call_i32("get", 1, 3), 3000);
+    EXPECT_EQ(call_i32("get", 1, 4), 1004);
+    EXPECT_EQ(call_i32("get_node", 0, 0), 4000);
+}
+
+TEST_F(WasmGCHeapTest, test_incremental_mark_root_rescan)
+{
+    /* sum of the values 0 .. 49999 of the list */
+    uint32 sum = 49999 * 25000;
+
+    ASSERT_TRUE(instantiate("incremental1.wasm"));
+
+    ASSERT_TRUE(call("init", 1, 50000));
+    EXPECT_EQ(call_i32("sum", 0, 0), sum);
+
+    /* the boxes allocated while the marking is in progress aren't marked,
+       they are kept by marking the root set and the objects written again
+       when the marking finishes, otherwise they are freed and overwritten */
+    EXPECT_EQ(call_i32("run", 1, 500), 0);
+
+    /* the head of the list refers to the box of the last round */
+    EXPECT_EQ(call_i32("sum", 0, 0), sum - 49999 + 501);
+}
+
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+TEST_F(WasmGCHeapTest, test_gc_pause_time)
+{
+    wasm_gc_heap_stats_t stats;
+
+    ASSERT_TRUE(instantiate("incremental1.wasm"));
+
+    ASSERT_TRUE(call("init", 1, 50000));
+    EXPECT_EQ(call_i32("run", 1, 500), 0);
+
+    stats = get_stats();
+    EXPECT_GT(stats.max_gc_time, 0);
+    EXPECT_GE(stats.gc_time, stats.max_gc_time);
+#if GC_INCREMENTAL_MARK_TIME_BUDGET > 0
+    /* the marking is done in steps, none of which pauses as long as all
+       of them */
+    EXPECT_LT(stats.max_gc_time, stats.gc_time);
+#endif
+}
+#endif
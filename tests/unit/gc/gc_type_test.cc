@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "gc_export.h"
+#include "gc_type.h"
+
+#include <vector>
+
+/* Depth of the deepest type of the main chain, deeper than the types
+   kept in the super type display */
+#define CHAIN_DEPTH (GC_TYPE_SUPER_DISPLAY_SIZE + 8)
+/* Depth of the parent type of the branch */
+#define BRANCH_DEPTH 20
+
+/* Tests of the super type display, the module has a chain of struct types
+   0 .. CHAIN_DEPTH, each of which is the subtype of the previous one, and
+   a branch of struct types with a field which starts from the subtype of
+   type BRANCH_DEPTH and is as deep as the chain */
+class WasmGCTypeTest : public testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        std::vector<uint8> types;
+        uint32 i, count = CHAIN_DEPTH + 1 + CHAIN_DEPTH - BRANCH_DEPTH;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        /* the type indexes are less than 128, each is encoded in a byte */
+        ASSERT_LT(count, 128);
+        types.push_back((uint8)count);
+        /* sub (struct) without parent */
+        types.insert(types.end(), { 0x50, 0x00, 0x5f, 0x00 });
+        for (i = 1; i <= CHAIN_DEPTH; i++)
+            /* sub i - 1 (struct) */
+            types.insert(types.end(), { 0x50, 0x01, (uint8)(i - 1), 0x5f,
+                                        0x00 });
+        for (i = BRANCH_DEPTH + 1; i <= CHAIN_DEPTH; i++)
+            /* sub parent (struct (field i32)) */
+            types.insert(types.end(),
+                         { 0x50, 0x01,
+                           (uint8)(i == BRANCH_DEPTH + 1 ? BRANCH_DEPTH
+                                                         : type_idx(i - 1)),
+                           0x5f, 0x01, 0x7f, 0x00 });
+
+        buf = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01 };
+        ASSERT_LT(types.size(), 1 << 14);
+        /* the section size in two bytes of LEB128 */
+        buf.push_back((uint8)(0x80 | (types.size() & 0x7f)));
+        buf.push_back((uint8)(types.size() >> 7));
+        buf.insert(buf.end(), types.begin(), types.end());
+
+        module = wasm_runtime_load(buf.data(), (uint32)buf.size(), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        ASSERT_EQ(wasm_get_defined_type_count(module), count);
+    }
+
+    void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    /* Type index of the branch type of the depth */
+    static uint32 type_idx(uint32 branch_depth)
+    {
+        return CHAIN_DEPTH + branch_depth - BRANCH_DEPTH;
+    }
+
+    WASMType *get_type(uint32 idx)
+    {
+        return (WASMType *)wasm_get_defined_type(module, idx);
+    }
+
+    /* The check before the display, which walks the parent types */
+    static bool is_super_or_self_of(const WASMType *type1,
+                                    const WASMType *type2)
+    {
+        for (; type2; type2 = type2->parent_type) {
+            if (type2 == type1)
+                return true;
+        }
+        return false;
+    }
+
+  public:
+    RuntimeInitArgs init_args;
+    std::vector<uint8> buf;
+    wasm_module_t module = NULL;
+    char error_buf[128];
+};
+
+TEST_F(WasmGCTypeTest, test_super_types_max_depth)
+{
+    WASMType *type;
+    uint32 i, depth;
+
+    for (depth = 0; depth <= CHAIN_DEPTH; depth++) {
+        type = get_type(depth);
+        ASSERT_EQ(type->inherit_depth, depth);
+        ASSERT_NE(type->super_types, nullptr);
+
+        /* the display keeps the first GC_TYPE_SUPER_DISPLAY_SIZE super
+           types, including the type itself */
+        for (i = 0; i <= depth && i < GC_TYPE_SUPER_DISPLAY_SIZE; i++)
+            EXPECT_EQ(type->super_types[i], get_type(i)) << depth << " " << i;
+    }
+
+    /* the deepest type kept in the display */
+    type = get_type(GC_TYPE_SUPER_DISPLAY_SIZE - 1);
+    EXPECT_EQ(type->super_types[GC_TYPE_SUPER_DISPLAY_SIZE - 1], type);
+
+    /* the branch shares the super types above the branch point */
+    type = get_type(type_idx(CHAIN_DEPTH));
+    ASSERT_EQ(type->inherit_depth, CHAIN_DEPTH);
+    for (i = 0; i <= BRANCH_DEPTH; i++)
+        EXPECT_EQ(type->super_types[i], get_type(i)) << i;
+    for (; i < GC_TYPE_SUPER_DISPLAY_SIZE; i++)
+        EXPECT_EQ(type->super_types[i], get_type(type_idx(i))) << i;
+}
+
+TEST_F(WasmGCTypeTest, test_super_types_parent_walk)
+{
+    uint32 count = wasm_get_defined_type_count(module), i, j;
+    WASMType *type1, *type2;
+
+    /* the display gives the same result as walking the parent types for
+       the types above, at and below the display size */
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < count; j++) {
+            type1 = get_type(i);
+            type2 = get_type(j);
+            EXPECT_EQ(wasm_type_is_super_or_self_of(type1, type2),
+                      is_super_or_self_of(type1, type2))
+                << i << " " << j;
+        }
+    }
+
+    /* some of the results of the parent walk */
+    EXPECT_TRUE(is_super_or_self_of(get_type(0), get_type(CHAIN_DEPTH)));
+    EXPECT_TRUE(is_super_or_self_of(get_type(CHAIN_DEPTH - 1),
+                                    get_type(CHAIN_DEPTH)));
+    EXPECT_TRUE(is_super_or_self_of(get_type(BRANCH_DEPTH),
+                                    get_type(type_idx(CHAIN_DEPTH))));
+    EXPECT_FALSE(is_super_or_self_of(get_type(BRANCH_DEPTH + 1),
+                                     get_type(type_idx(CHAIN_DEPTH))));
+    EXPECT_FALSE(is_super_or_self_of(get_type(CHAIN_DEPTH - 1),
+                                     get_type(type_idx(CHAIN_DEPTH))));
+    EXPECT_FALSE(is_super_or_self_of(get_type(CHAIN_DEPTH),
+                                     get_type(CHAIN_DEPTH - 1)));
+}
+
+TEST_F(WasmGCTypeTest, test_obj_is_instance_of_max_depth)
+{
+    wasm_module_inst_t module_inst;
+    wasm_exec_env_t exec_env;
+    wasm_struct_obj_t obj1, obj2;
+    wasm_obj_t obj;
+    uint32 count = wasm_get_defined_type_count(module), i;
+
+    module_inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                           sizeof(error_buf));
+    ASSERT_NE(module_inst, nullptr) << error_buf;
+    exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+    ASSERT_NE(exec_env, nullptr);
+
+    /* the objects of the deepest types of the chain and the branch */
+    obj1 = wasm_struct_obj_new_with_type(
+        exec_env, (wasm_struct_type_t)get_type(CHAIN_DEPTH));
+    obj2 = wasm_struct_obj_new_with_type(
+        exec_env, (wasm_struct_type_t)get_type(type_idx(CHAIN_DEPTH)));
+    ASSERT_NE(obj1, nullptr);
+    ASSERT_NE(obj2, nullptr);
+
+    for (i = 0; i < count; i++) {
+        obj = (wasm_obj_t)obj1;
+        EXPECT_EQ(wasm_obj_is_instance_of_defined_type(
+                      obj, (wasm_defined_type_t)get_type(i), module),
+                  is_super_or_self_of(get_type(i), get_type(CHAIN_DEPTH)))
+            << i;
+        obj = (wasm_obj_t)obj2;
+        EXPECT_EQ(
+            wasm_obj_is_instance_of_defined_type(
+                obj, (wasm_defined_type_t)get_type(i), module),
+            is_super_or_self_of(get_type(i), get_type(type_idx(CHAIN_DEPTH))))
+            << i;
+    }
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+}
@@ -0,0 +1,47 @@
+(module
+  (type $block (array (mut i32)))
+  (type $box (struct (field (mut i32))))
+  (type $node (struct (field (mut (ref null $box)))))
+  (type $holder (array (mut (ref null $box))))
+
+  (global $holder (mut (ref null $holder)) (ref.null $holder))
+  (global $node (mut (ref null $node)) (ref.null $node))
+
+  (func (export "init") (param $n i32)
+    (global.set $holder (array.new_default $holder (local.get $n)))
+    (global.set $node (struct.new_default $node))
+  )
+
+  ;; allocate n blocks of 1KB which become garbage immediately, the memory
+  ;; of the objects freed is overwritten with 0x5a5a5a5a
+  (func (export "churn") (param $n i32) (local $i i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (drop (array.new $block (i32.const 0x5a5a5a5a) (i32.const 256)))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)
+      )
+    )
+  )
+
+  ;; store a new box into the holder and the node, which are old objects
+  ;; once they survive a collection
+  (func (export "set") (param $i i32) (param $v i32)
+    (array.set $holder (global.get $holder) (local.get $i)
+      (struct.new $box (local.get $v)))
+  )
+
+  (func (export "get") (param $i i32) (result i32)
+    (struct.get $box 0
+      (array.get $holder (global.get $holder) (local.get $i)))
+  )
+
+  (func (export "set_node") (param $v i32)
+    (struct.set $node 0 (global.get $node) (struct.new $box (local.get $v)))
+  )
+
+  (func (export "get_node") (result i32)
+    (struct.get $box 0 (struct.get $node 0 (global.get $node)))
+  )
+)
@@ -0,0 +1,36 @@
+(module
+  (type $block (array (mut i32)))
+  (type $holder (array (mut (ref null $block))))
+
+  (global $blocks (mut (ref null $holder)) (ref.null $holder))
+
+  ;; keep n blocks of 1KB alive
+  (func (export "fill") (param $n i32) (local $i i32)
+    (global.set $blocks (array.new_default $holder (local.get $n)))
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (array.set $holder (global.get $blocks) (local.get $i)
+          (array.new_default $block (i32.const 256)))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)
+      )
+    )
+  )
+
+  (func (export "clear")
+    (global.set $blocks (ref.null $holder))
+  )
+
+  ;; allocate n blocks of 1KB which become garbage immediately
+  (func (export "churn") (param $n i32) (local $i i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (drop (array.new_default $block (i32.const 256)))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)
+      )
+    )
+  )
+)
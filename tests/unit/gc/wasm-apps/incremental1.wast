@@ -0,0 +1,78 @@
+(module
+  (type $block (array (mut i32)))
+  (type $box (struct (field (mut i32))))
+  (type $node (struct (field (mut (ref null $node))) (field (mut (ref null $box)))))
+
+  (global $list (mut (ref null $node)) (ref.null $node))
+  (global $fresh (mut (ref null $box)) (ref.null $box))
+
+  ;; build a list of n nodes, the marking of which takes many steps
+  (func (export "init") (param $n i32) (local $i i32)
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (global.set $list
+          (struct.new $node (global.get $list) (struct.new $box (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)
+      )
+    )
+  )
+
+  (func (export "sum") (result i32) (local $s i32) (local $p (ref null $node))
+    (local.set $p (global.get $list))
+    (block $done
+      (loop $loop
+        (br_if $done (ref.is_null (local.get $p)))
+        (local.set $s
+          (i32.add (local.get $s)
+            (struct.get $box 0 (struct.get $node 1 (local.get $p)))))
+        (local.set $p (struct.get $node 0 (local.get $p)))
+        (br $loop)
+      )
+    )
+    (local.get $s)
+  )
+
+  ;; in each round, allocate a box referred only by a global, one referred
+  ;; only by a local and one referred only by the head of the list, then
+  ;; allocate 16 blocks of 1KB which become garbage immediately, the memory
+  ;; of the objects freed is overwritten with 0x5a5a5a5a. Return the first
+  ;; round (from 1) in which a box was lost, or 0
+  (func (export "run") (param $n i32) (result i32)
+    (local $i i32) (local $j i32) (local $box (ref null $box))
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (global.set $fresh (struct.new $box (local.get $i)))
+        (local.set $box
+          (struct.new $box (i32.add (local.get $i) (i32.const 1))))
+        (struct.set $node 1 (global.get $list)
+          (struct.new $box (i32.add (local.get $i) (i32.const 2))))
+        (local.set $j (i32.const 0))
+        (block $churn_done
+          (loop $churn
+            (br_if $churn_done (i32.ge_u (local.get $j) (i32.const 16)))
+            (drop (array.new $block (i32.const 0x5a5a5a5a) (i32.const 256)))
+            (local.set $j (i32.add (local.get $j) (i32.const 1)))
+            (br $churn)
+          )
+        )
+        (if (i32.or
+              (i32.or
+                (i32.ne (struct.get $box 0 (global.get $fresh))
+                        (local.get $i))
+                (i32.ne (struct.get $box 0 (local.get $box))
+                        (i32.add (local.get $i) (i32.const 1))))
+              (i32.ne (struct.get $box 0
+                        (struct.get $node 1 (global.get $list)))
+                      (i32.add (local.get $i) (i32.const 2))))
+          (then (return (i32.add (local.get $i) (i32.const 1))))
+        )
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)
+      )
+    )
+    (i32.const 0)
+  )
+)
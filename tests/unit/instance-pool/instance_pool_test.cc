@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* "wamr" at offset 16 and "init" in the passive data segment */
+#define ACTIVE_DATA 0x726d6177
+#define PASSIVE_DATA 0x74696e69
+
+class InstancePoolTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/state.wasm";
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        memset(&args, 0, sizeof(InstantiationArgs));
+        args.default_stack_size = 8192;
+    }
+
+    void TearDown()
+    {
+        if (pool)
+            wasm_runtime_destroy_instance_pool(pool);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+    }
+
+  public:
+    bool call(wasm_module_inst_t inst, const char *name, uint32 argc,
+              uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 call_i32(wasm_module_inst_t inst, const char *name,
+                    uint32 arg = 0)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call(inst, name, 1, argv)) << name;
+        return argv[0];
+    }
+
+    void expect_initial_state(wasm_module_inst_t inst)
+    {
+        uint32 argv[1] = { 65536 + 100 };
+
+        EXPECT_EQ(call_i32(inst, "get_global"), 100);
+        EXPECT_EQ(call_i32(inst, "load", 16), ACTIVE_DATA);
+        EXPECT_EQ(call_i32(inst, "load", 1024), 0);
+        EXPECT_EQ(call_i32(inst, "size"), 1);
+        EXPECT_FALSE(call(inst, "load", 1, argv));
+        EXPECT_EQ(call_i32(inst, "table_size"), 2);
+        EXPECT_EQ(call_i32(inst, "call_elem", 0), 1);
+        EXPECT_EQ(call_i32(inst, "call_elem", 1), 2);
+    }
+
+    /* Change the globals, the memory and the tables, and drop the
+       passive segments */
+    void change_state(wasm_module_inst_t inst)
+    {
+        uint32 argv[2];
+
+        argv[0] = 7;
+        ASSERT_TRUE(call(inst, "set_global", 1, argv));
+        argv[0] = 16;
+        argv[1] = 0x12345678;
+        ASSERT_TRUE(call(inst, "store", 2, argv));
+        argv[0] = 1024;
+        argv[1] = 42;
+        ASSERT_TRUE(call(inst, "store", 2, argv));
+        EXPECT_EQ(call_i32(inst, "grow", 1), 1);
+        argv[0] = 65536 + 100;
+        argv[1] = 5;
+        ASSERT_TRUE(call(inst, "store", 2, argv));
+        EXPECT_EQ(call_i32(inst, "table_grow", 2), 2);
+        argv[0] = 0;
+        ASSERT_TRUE(call(inst, "set_elem", 1, argv));
+        EXPECT_EQ(call_i32(inst, "call_elem", 0), 2);
+
+        ASSERT_TRUE(call(inst, "data_drop", 0, argv));
+        ASSERT_TRUE(call(inst, "elem_drop", 0, argv));
+        argv[0] = 300;
+        EXPECT_FALSE(call(inst, "data_init", 1, argv));
+        argv[0] = 0;
+        EXPECT_FALSE(call(inst, "elem_init", 1, argv));
+    }
+
+    /* The dropped segments can be used again */
+    void expect_segments_restored(wasm_module_inst_t inst)
+    {
+        uint32 argv[1];
+
+        argv[0] = 300;
+        EXPECT_TRUE(call(inst, "data_init", 1, argv));
+        EXPECT_EQ(call_i32(inst, "load", 300), PASSIVE_DATA);
+        argv[0] = 0;
+        EXPECT_TRUE(call(inst, "elem_init", 1, argv));
+        EXPECT_EQ(call_i32(inst, "call_elem", 0), 2);
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_instance_pool_t pool = NULL;
+    InstantiationArgs args;
+    char error_buf[128];
+};
+
+TEST_F(InstancePoolTest, test_acquire_release)
+{
+    wasm_module_inst_t inst1, inst2, inst3;
+
+    pool = wasm_runtime_create_instance_pool(module, &args, 2, error_buf,
+                                             sizeof(error_buf));
+    ASSERT_NE(pool, nullptr) << error_buf;
+
+    inst1 = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                               sizeof(error_buf));
+    ASSERT_NE(inst1, nullptr) << error_buf;
+    expect_initial_state(inst1);
+
+    /* A new instance is instantiated if the pool is empty */
+    inst2 = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                               sizeof(error_buf));
+    inst3 = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                               sizeof(error_buf));
+    ASSERT_NE(inst2, nullptr) << error_buf;
+    ASSERT_NE(inst3, nullptr) << error_buf;
+    EXPECT_NE(inst1, inst2);
+    EXPECT_NE(inst2, inst3);
+    expect_initial_state(inst3);
+
+    /* The third instance released exceeds the capacity */
+    wasm_runtime_instance_pool_release(pool, inst1);
+    wasm_runtime_instance_pool_release(pool, inst2);
+    wasm_runtime_instance_pool_release(pool, inst3);
+
+    /* The idle instances are reused */
+    inst3 = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                               sizeof(error_buf));
+    EXPECT_TRUE(inst3 == inst1 || inst3 == inst2);
+    expect_initial_state(inst3);
+    wasm_runtime_instance_pool_release(pool, inst3);
+}
+
+TEST_F(InstancePoolTest, test_reset)
+{
+    wasm_module_inst_t inst, inst_reset;
+
+    pool = wasm_runtime_create_instance_pool(module, &args, 1, error_buf,
+                                             sizeof(error_buf));
+    ASSERT_NE(pool, nullptr) << error_buf;
+
+    inst = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                              sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    change_state(inst);
+    wasm_runtime_instance_pool_release(pool, inst);
+
+    /* The same instance is reset rather than re-instantiated, the memory
+       grown can only be shrunk back with the hardware bound check */
+    inst_reset = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                                    sizeof(error_buf));
+    ASSERT_NE(inst_reset, nullptr) << error_buf;
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    ASSERT_EQ(inst_reset, inst);
+#endif
+    expect_initial_state(inst_reset);
+    expect_segments_restored(inst_reset);
+
+    /* Reset it again after the segments were used */
+    change_state(inst_reset);
+    wasm_runtime_instance_pool_release(pool, inst_reset);
+    inst_reset = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                                    sizeof(error_buf));
+    ASSERT_NE(inst_reset, nullptr) << error_buf;
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    ASSERT_EQ(inst_reset, inst);
+#endif
+    expect_initial_state(inst_reset);
+    expect_segments_restored(inst_reset);
+    wasm_runtime_instance_pool_release(pool, inst_reset);
+}
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(InstancePoolTest, test_reinstantiate)
+{
+    uint32 page_size = (uint32)sysconf(_SC_PAGESIZE);
+    uint32 offset = 8 * page_size;
+    wasm_module_inst_t inst;
+    int fd;
+
+    ASSERT_LE(offset + page_size, 65536);
+
+    pool = wasm_runtime_create_instance_pool(module, &args, 1, error_buf,
+                                             sizeof(error_buf));
+    ASSERT_NE(pool, nullptr) << error_buf;
+
+    fd = memfd_create("instance_pool_test", 0);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, page_size), 0);
+    ASSERT_EQ(pwrite(fd, "\x01\x02\x03\x04", 4, 0), 4);
+
+    inst = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                              sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    change_state(inst);
+
+    /* The memory with a host buffer mapped can't be reset, the instance
+       is replaced with a new one when released */
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, offset, page_size, fd, 0,
+                                             false));
+    EXPECT_EQ(call_i32(inst, "load", offset), 0x04030201);
+    wasm_runtime_instance_pool_release(pool, inst);
+
+    inst = wasm_runtime_instance_pool_acquire(pool, error_buf,
+                                              sizeof(error_buf));
+    ASSERT_NE(inst, nullptr) << error_buf;
+    expect_initial_state(inst);
+    expect_segments_restored(inst);
+    EXPECT_EQ(call_i32(inst, "load", offset), 0);
+    wasm_runtime_instance_pool_release(pool, inst);
+
+    close(fd);
+}
+#endif
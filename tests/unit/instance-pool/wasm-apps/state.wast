@@ -0,0 +1,46 @@
+(module
+  (type $ret_i32 (func (result i32)))
+
+  (table $t 2 8 funcref)
+  (memory (export "memory") 1 4)
+  (global $g (mut i32) (i32.const 100))
+
+  (func $f1 (type $ret_i32) (i32.const 1))
+  (func $f2 (type $ret_i32) (i32.const 2))
+
+  (func (export "get_global") (result i32) (global.get $g))
+  (func (export "set_global") (param i32) (global.set $g (local.get 0)))
+
+  (func (export "load") (param i32) (result i32) (i32.load (local.get 0)))
+  (func (export "store") (param i32 i32)
+    (i32.store (local.get 0) (local.get 1))
+  )
+  (func (export "grow") (param i32) (result i32) (memory.grow (local.get 0)))
+  (func (export "size") (result i32) (memory.size))
+
+  (func (export "data_drop") (data.drop $passive_data))
+  (func (export "data_init") (param i32)
+    (memory.init $passive_data (local.get 0) (i32.const 0) (i32.const 4))
+  )
+
+  (func (export "table_size") (result i32) (table.size $t))
+  (func (export "table_grow") (param i32) (result i32)
+    (table.grow $t (ref.null func) (local.get 0))
+  )
+  (func (export "call_elem") (param i32) (result i32)
+    (call_indirect $t (type $ret_i32) (local.get 0))
+  )
+  (func (export "elem_drop") (elem.drop $passive_elem))
+  (func (export "elem_init") (param i32)
+    (table.init $t $passive_elem (local.get 0) (i32.const 0) (i32.const 1))
+  )
+  (func (export "set_elem") (param i32)
+    (table.set $t (local.get 0) (ref.func $f2))
+  )
+
+  (elem (table $t) (i32.const 0) func $f1 $f2)
+  (elem $passive_elem func $f2)
+
+  (data (i32.const 16) "wamr")
+  (data $passive_data "init")
+)
@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#include <vector>
+
+/* "wamr" at offset 16 of the memory */
+#define ACTIVE_DATA 0x726d6177
+
+class InstanceSnapshotTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/state.wasm";
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        memset(&args, 0, sizeof(InstantiationArgs));
+        args.default_stack_size = 8192;
+    }
+
+    void TearDown()
+    {
+        for (wasm_module_inst_t inst : insts)
+            wasm_runtime_deinstantiate(inst);
+        if (snapshot)
+            wasm_runtime_free(snapshot);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+    }
+
+  public:
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate_ex(
+            module, &args, error_buf, sizeof(error_buf));
+
+        EXPECT_NE(inst, nullptr) << error_buf;
+        if (inst)
+            insts.push_back(inst);
+        return inst;
+    }
+
+    wasm_module_inst_t restore()
+    {
+        wasm_module_inst_t inst = wasm_runtime_restore_instance(
+            module, &args, snapshot, snapshot_size, error_buf,
+            sizeof(error_buf));
+
+        EXPECT_NE(inst, nullptr) << error_buf;
+        if (inst)
+            insts.push_back(inst);
+        return inst;
+    }
+
+    bool take_snapshot(wasm_module_inst_t inst)
+    {
+        if (snapshot)
+            wasm_runtime_free(snapshot);
+        snapshot = NULL;
+        return wasm_runtime_snapshot_instance(inst, &snapshot, &snapshot_size,
+                                              error_buf, sizeof(error_buf));
+    }
+
+    bool call(wasm_module_inst_t inst, const char *name, uint32 argc,
+              uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 call_i32(wasm_module_inst_t inst, const char *name,
+                    uint32 arg = 0)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call(inst, name, 1, argv)) << name;
+        return argv[0];
+    }
+
+    void store(wasm_module_inst_t inst, uint32 offset, uint32 value)
+    {
+        uint32 argv[2] = { offset, value };
+
+        EXPECT_TRUE(call(inst, "store", 2, argv));
+    }
+
+    /* Change the globals, the memory and the tables, and drop the
+       passive segments */
+    void change_state(wasm_module_inst_t inst)
+    {
+        uint32 argv[1];
+
+        argv[0] = 7;
+        ASSERT_TRUE(call(inst, "set_global", 1, argv));
+        store(inst, 16, 0x12345678);
+        store(inst, 1024, 42);
+        EXPECT_EQ(call_i32(inst, "grow", 1), 1);
+        store(inst, 65536 + 100, 5);
+        EXPECT_EQ(call_i32(inst, "table_grow", 2), 2);
+        argv[0] = 0;
+        ASSERT_TRUE(call(inst, "set_elem", 1, argv));
+        ASSERT_TRUE(call(inst, "data_drop", 0, argv));
+        ASSERT_TRUE(call(inst, "elem_drop", 0, argv));
+    }
+
+    void expect_changed_state(wasm_module_inst_t inst)
+    {
+        uint32 argv[1];
+
+        EXPECT_EQ(call_i32(inst, "get_global"), 7);
+        EXPECT_EQ(call_i32(inst, "load", 16), 0x12345678);
+        EXPECT_EQ(call_i32(inst, "load", 1024), 42);
+        EXPECT_EQ(call_i32(inst, "load", 2048), 0);
+        EXPECT_EQ(call_i32(inst, "size"), 2);
+        EXPECT_EQ(call_i32(inst, "load", 65536 + 100), 5);
+        EXPECT_EQ(call_i32(inst, "table_size"), 4);
+        EXPECT_EQ(call_i32(inst, "call_elem", 0), 2);
+        EXPECT_EQ(call_i32(inst, "call_elem", 1), 2);
+
+        /* The segments remain dropped */
+        argv[0] = 300;
+        EXPECT_FALSE(call(inst, "data_init", 1, argv));
+        argv[0] = 0;
+        EXPECT_FALSE(call(inst, "elem_init", 1, argv));
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    std::vector<wasm_module_inst_t> insts;
+    InstantiationArgs args;
+    uint8_t *snapshot = NULL;
+    uint32_t snapshot_size = 0;
+    char error_buf[128];
+};
+
+TEST_F(InstanceSnapshotTest, test_snapshot_initial_state)
+{
+    wasm_module_inst_t inst, restored;
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    ASSERT_TRUE(take_snapshot(inst)) << error_buf;
+    ASSERT_NE(restored = restore(), nullptr);
+
+    EXPECT_EQ(call_i32(restored, "get_global"), 100);
+    EXPECT_EQ(call_i32(restored, "load", 16), ACTIVE_DATA);
+    EXPECT_EQ(call_i32(restored, "size"), 1);
+    EXPECT_EQ(call_i32(restored, "table_size"), 2);
+    EXPECT_EQ(call_i32(restored, "call_elem", 0), 1);
+}
+
+TEST_F(InstanceSnapshotTest, test_snapshot_round_trip)
+{
+    wasm_module_inst_t inst, restored;
+    uint32 argv[1];
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+    ASSERT_TRUE(take_snapshot(inst)) << error_buf;
+
+    /* The later changes of the instance aren't in the snapshot */
+    argv[0] = 9;
+    ASSERT_TRUE(call(inst, "set_global", 1, argv));
+    store(inst, 16, 0);
+    store(inst, 2048, 77);
+    EXPECT_EQ(call_i32(inst, "table_grow", 1), 4);
+
+    /* The memory of the new instance is grown to the size in the
+       snapshot */
+    ASSERT_NE(restored = restore(), nullptr);
+    expect_changed_state(restored);
+
+    /* The instances are independent */
+    store(restored, 1024, 43);
+    EXPECT_EQ(call_i32(inst, "load", 1024), 42);
+    EXPECT_EQ(call_i32(inst, "get_global"), 9);
+    EXPECT_EQ(call_i32(inst, "table_size"), 5);
+}
+
+TEST_F(InstanceSnapshotTest, test_snapshot_of_restored_instance)
+{
+    wasm_module_inst_t inst, restored;
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+    ASSERT_TRUE(take_snapshot(inst)) << error_buf;
+    ASSERT_NE(restored = restore(), nullptr);
+
+    /* Grow the restored memory again and restore it once more */
+    EXPECT_EQ(call_i32(restored, "grow", 1), 2);
+    store(restored, 2 * 65536 + 8, 11);
+    ASSERT_TRUE(take_snapshot(restored)) << error_buf;
+    ASSERT_NE(restored = restore(), nullptr);
+    EXPECT_EQ(call_i32(restored, "size"), 3);
+    EXPECT_EQ(call_i32(restored, "load", 2 * 65536 + 8), 11);
+    EXPECT_EQ(call_i32(restored, "load", 65536 + 100), 5);
+    EXPECT_EQ(call_i32(restored, "get_global"), 7);
+}
+
+TEST_F(InstanceSnapshotTest, test_snapshot_app_heap)
+{
+    wasm_module_inst_t inst, restored;
+    uint64 offset, offset_restored;
+    void *native_addr;
+
+    args.host_managed_heap_size = 8192;
+    ASSERT_NE(inst = instantiate(), nullptr);
+    offset = wasm_runtime_module_malloc(inst, 100, &native_addr);
+    ASSERT_NE(offset, 0);
+    memcpy(native_addr, "snapshot", 9);
+    ASSERT_TRUE(take_snapshot(inst)) << error_buf;
+    ASSERT_NE(restored = restore(), nullptr);
+
+    EXPECT_STREQ((char *)wasm_runtime_addr_app_to_native(restored, offset),
+                 "snapshot");
+    /* The allocation is kept in the restored heap */
+    offset_restored = wasm_runtime_module_malloc(restored, 100, NULL);
+    EXPECT_NE(offset_restored, 0);
+    EXPECT_NE(offset_restored, offset);
+    wasm_runtime_module_free(restored, offset);
+    wasm_runtime_module_free(restored, offset_restored);
+}
+
+TEST_F(InstanceSnapshotTest, test_restore_invalid_snapshot)
+{
+    wasm_module_inst_t inst;
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+    ASSERT_TRUE(take_snapshot(inst)) << error_buf;
+
+    EXPECT_EQ(wasm_runtime_restore_instance(module, &args, snapshot,
+                                            snapshot_size - 1, error_buf,
+                                            sizeof(error_buf)),
+              nullptr);
+    EXPECT_EQ(wasm_runtime_restore_instance(module, &args, snapshot, 8,
+                                            error_buf, sizeof(error_buf)),
+              nullptr);
+}
+
+TEST_F(InstanceSnapshotTest, test_clone_state)
+{
+    wasm_module_inst_t inst, clone;
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+
+    clone = wasm_runtime_clone_instance(inst, &args, error_buf,
+                                        sizeof(error_buf));
+    ASSERT_NE(clone, nullptr) << error_buf;
+    insts.push_back(clone);
+    expect_changed_state(clone);
+}
+
+TEST_F(InstanceSnapshotTest, test_clone_isolation)
+{
+    wasm_module_inst_t inst, clone1, clone2;
+    uint32 argv[1];
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+
+    clone1 = wasm_runtime_clone_instance(inst, &args, error_buf,
+                                         sizeof(error_buf));
+    ASSERT_NE(clone1, nullptr) << error_buf;
+    insts.push_back(clone1);
+
+    /* The writes of the source aren't seen by the clone, both to the
+       pages with data and to the zero pages */
+    store(inst, 1024, 100);
+    store(inst, 65536 + 100, 6);
+    store(inst, 8192, 7);
+    EXPECT_EQ(call_i32(clone1, "load", 1024), 42);
+    EXPECT_EQ(call_i32(clone1, "load", 65536 + 100), 5);
+    EXPECT_EQ(call_i32(clone1, "load", 8192), 0);
+
+    /* The writes of the clone aren't seen by the source */
+    store(clone1, 16, 0xdead);
+    store(clone1, 65536 + 200, 8);
+    store(clone1, 12288, 9);
+    argv[0] = 55;
+    ASSERT_TRUE(call(clone1, "set_global", 1, argv));
+    EXPECT_EQ(call_i32(inst, "load", 16), 0x12345678);
+    EXPECT_EQ(call_i32(inst, "load", 65536 + 200), 0);
+    EXPECT_EQ(call_i32(inst, "load", 12288), 0);
+    EXPECT_EQ(call_i32(inst, "get_global"), 7);
+
+    /* The clones share the state captured by the first clone, and don't
+       see the writes of each other */
+    clone2 = wasm_runtime_clone_instance(inst, &args, error_buf,
+                                         sizeof(error_buf));
+    ASSERT_NE(clone2, nullptr) << error_buf;
+    insts.push_back(clone2);
+    expect_changed_state(clone2);
+    EXPECT_EQ(call_i32(clone2, "load", 8192), 0);
+    EXPECT_EQ(call_i32(clone2, "load", 65536 + 200), 0);
+    EXPECT_EQ(call_i32(clone2, "load", 12288), 0);
+
+    store(clone2, 1024, 12);
+    EXPECT_EQ(call_i32(clone1, "load", 1024), 42);
+    EXPECT_EQ(call_i32(inst, "load", 1024), 100);
+}
+
+TEST_F(InstanceSnapshotTest, test_clone_outlives_source)
+{
+    wasm_module_inst_t inst, clone;
+
+    ASSERT_NE(inst = instantiate(), nullptr);
+    change_state(inst);
+
+    clone = wasm_runtime_clone_instance(inst, &args, error_buf,
+                                        sizeof(error_buf));
+    ASSERT_NE(clone, nullptr) << error_buf;
+
+    /* The clone keeps the content of the image after the source and its
+       image are destroyed */
+    insts.erase(insts.begin());
+    wasm_runtime_deinstantiate(inst);
+    insts.push_back(clone);
+    expect_changed_state(clone);
+    store(clone, 1024, 13);
+    EXPECT_EQ(call_i32(clone, "load", 1024), 13);
+}
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* "wamr" at offset 16 and "data" at offset 8192 */
+#define DATA1 0x726d6177
+#define DATA2 0x61746164
+
+class LinearMemoryMappingTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/mem.wasm";
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        /* No app heap, the memory only has the pages of the module */
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        ASSERT_NE(inst, nullptr) << error_buf;
+
+        page_size = (uint32)sysconf(_SC_PAGESIZE);
+        /* A window of two pages above the data segments */
+        offset = 8 * page_size;
+        ASSERT_LE(offset + 2 * page_size, 65536);
+        ASSERT_LT(8192 + 4, offset);
+    }
+
+    void TearDown()
+    {
+        if (fd >= 0)
+            close(fd);
+        if (inst)
+            wasm_runtime_deinstantiate(inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+    }
+
+  public:
+    bool call(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 load(uint32 addr)
+    {
+        uint32 argv[1] = { addr };
+
+        EXPECT_TRUE(call("load", 1, argv)) << addr;
+        return argv[0];
+    }
+
+    void store(uint32 addr, uint32 value)
+    {
+        uint32 argv[2] = { addr, value };
+
+        EXPECT_TRUE(call("store", 2, argv)) << addr;
+    }
+
+    /* Create a host buffer of two pages, with 0x04030201 at the start of
+       each page */
+    void create_host_buffer()
+    {
+        fd = memfd_create("linear_memory_mapping_test", 0);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(ftruncate(fd, 2 * page_size), 0);
+        ASSERT_EQ(pwrite(fd, "\x01\x02\x03\x04", 4, 0), 4);
+        ASSERT_EQ(pwrite(fd, "\x01\x02\x03\x04", 4, page_size), 4);
+    }
+
+    uint32 read_host_buffer(uint32 buf_offset)
+    {
+        uint32 value = 0;
+
+        EXPECT_EQ(pread(fd, &value, sizeof(value), buf_offset), 4);
+        return value;
+    }
+
+    void expect_exception(const char *exception)
+    {
+        const char *cur_exception = wasm_runtime_get_exception(inst);
+
+        ASSERT_NE(cur_exception, nullptr);
+        EXPECT_NE(strstr(cur_exception, exception), nullptr) << cur_exception;
+        wasm_runtime_clear_exception(inst);
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t inst = NULL;
+    uint32 page_size = 0;
+    uint32 offset = 0;
+    int fd = -1;
+    char error_buf[128];
+};
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(LinearMemoryMappingTest, test_map_invalid_window)
+{
+    create_host_buffer();
+
+    /* The window must be page aligned and not empty */
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, offset + 8, page_size, fd,
+                                              0, true));
+    expect_exception("invalid host buffer mapping window");
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, offset, page_size + 8, fd,
+                                              0, true));
+    expect_exception("invalid host buffer mapping window");
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, offset, 0, fd, 0, true));
+    expect_exception("invalid host buffer mapping window");
+    EXPECT_FALSE(wasm_runtime_unmap_host_buffer(inst, offset + 8, page_size));
+    expect_exception("invalid host buffer mapping window");
+
+    /* The window must be within the memory */
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, 65536 - page_size,
+                                              2 * page_size, fd, 0, true));
+    expect_exception("out of bounds memory access");
+    EXPECT_FALSE(wasm_runtime_unmap_host_buffer(inst, 65536, page_size));
+    expect_exception("out of bounds memory access");
+
+    /* The buffer must be valid and mapped at a page aligned offset */
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, offset, page_size, -1, 0,
+                                              true));
+    expect_exception("invalid host buffer");
+    EXPECT_FALSE(wasm_runtime_map_host_buffer(inst, offset, page_size, fd, 8,
+                                              true));
+    expect_exception("map host buffer failed");
+
+    /* The memory isn't changed */
+    EXPECT_EQ(load(16), DATA1);
+    EXPECT_EQ(load(8192), DATA2);
+    EXPECT_EQ(load(offset), 0);
+    EXPECT_EQ(load(65536 - page_size), 0);
+}
+
+TEST_F(LinearMemoryMappingTest, test_map_shared_writes)
+{
+    create_host_buffer();
+
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, offset, 2 * page_size, fd,
+                                             0, true));
+    EXPECT_EQ(load(offset), 0x04030201);
+    EXPECT_EQ(load(offset + page_size), 0x04030201);
+
+    /* The writes of the app go to the host buffer and vice versa */
+    store(offset + page_size + 8, 0x12345678);
+    EXPECT_EQ(read_host_buffer(page_size + 8), 0x12345678);
+    ASSERT_EQ(pwrite(fd, "\x05\x06\x07\x08", 4, 16), 4);
+    EXPECT_EQ(load(offset + 16), 0x08070605);
+
+    /* The pages out of the window are kept */
+    EXPECT_EQ(load(16), DATA1);
+    EXPECT_EQ(load(8192), DATA2);
+    EXPECT_EQ(load(offset - 4), 0);
+    EXPECT_EQ(load(offset + 2 * page_size), 0);
+
+    /* A window at an offset of the buffer */
+    ASSERT_TRUE(wasm_runtime_unmap_host_buffer(inst, offset, 2 * page_size));
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, offset, page_size, fd,
+                                             page_size, true));
+    EXPECT_EQ(load(offset + 8), 0x12345678);
+}
+
+TEST_F(LinearMemoryMappingTest, test_map_private_writes)
+{
+    create_host_buffer();
+
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, offset, 2 * page_size, fd,
+                                             0, false));
+    EXPECT_EQ(load(offset), 0x04030201);
+
+    /* The writes of the app are only visible to the app */
+    store(offset, 0x12345678);
+    EXPECT_EQ(load(offset), 0x12345678);
+    EXPECT_EQ(read_host_buffer(0), 0x04030201);
+}
+
+TEST_F(LinearMemoryMappingTest, test_unmap_zeroes_window)
+{
+    create_host_buffer();
+
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, offset, 2 * page_size, fd,
+                                             0, true));
+    store(offset + 8, 0x12345678);
+    ASSERT_TRUE(wasm_runtime_unmap_host_buffer(inst, offset, 2 * page_size));
+
+    /* The window reads as zero and is no longer backed by the buffer */
+    EXPECT_EQ(load(offset), 0);
+    EXPECT_EQ(load(offset + 8), 0);
+    EXPECT_EQ(load(offset + page_size), 0);
+    store(offset, 0x11111111);
+    EXPECT_EQ(load(offset), 0x11111111);
+    EXPECT_EQ(read_host_buffer(0), 0x04030201);
+    EXPECT_EQ(read_host_buffer(8), 0x12345678);
+
+    /* The pages out of the window are kept */
+    EXPECT_EQ(load(16), DATA1);
+    EXPECT_EQ(load(8192), DATA2);
+}
+
+TEST_F(LinearMemoryMappingTest, test_unmap_data_image_pages)
+{
+    create_host_buffer();
+
+    /* Map a buffer over the data segments, the memory created from the
+       data image reads as zero there after unmapping */
+    ASSERT_TRUE(wasm_runtime_map_host_buffer(inst, 0, page_size, fd, 0,
+                                             false));
+    EXPECT_EQ(load(0), 0x04030201);
+    EXPECT_EQ(load(16), 0);
+    ASSERT_TRUE(wasm_runtime_unmap_host_buffer(inst, 0, page_size));
+    EXPECT_EQ(load(0), 0);
+    EXPECT_EQ(load(16), 0);
+    EXPECT_EQ(load(8192), DATA2);
+}
+#endif
+
+TEST_F(LinearMemoryMappingTest, test_discard_pages)
+{
+    store(offset, 0x12345678);
+    store(offset + page_size + 8, 0x12345678);
+    store(offset + 2 * page_size, 0x12345678);
+
+    ASSERT_TRUE(wasm_runtime_discard_memory(inst, offset, 2 * page_size));
+    EXPECT_EQ(load(offset), 0);
+    EXPECT_EQ(load(offset + page_size + 8), 0);
+    EXPECT_EQ(load(offset + 2 * page_size), 0x12345678);
+
+    /* The pages can be written again */
+    store(offset, 0x11111111);
+    EXPECT_EQ(load(offset), 0x11111111);
+}
+
+TEST_F(LinearMemoryMappingTest, test_discard_data_image_pages)
+{
+    /* The pages of the data segments read as zero rather than the
+       content of the data image */
+    ASSERT_TRUE(wasm_runtime_discard_memory(inst, 0, page_size));
+    EXPECT_EQ(load(16), 0);
+    EXPECT_EQ(load(8192), DATA2);
+
+    /* Also after they are written */
+    store(8192 + 4, 0x12345678);
+    ASSERT_TRUE(wasm_runtime_discard_memory(inst, 8192 & ~(page_size - 1),
+                                            page_size));
+    EXPECT_EQ(load(8192), 0);
+    EXPECT_EQ(load(8192 + 4), 0);
+
+    store(16, 0x11111111);
+    EXPECT_EQ(load(16), 0x11111111);
+}
+
+TEST_F(LinearMemoryMappingTest, test_discard_partial_pages)
+{
+    /* Only the bytes in the range are cleared, "w" and "r" are kept */
+    ASSERT_TRUE(wasm_runtime_discard_memory(inst, 17, 2));
+    EXPECT_EQ(load(16), 0x72000077);
+
+    /* A range with partial pages at both ends */
+    store(offset, 0x12345678);
+    store(offset + 8, 0x12345678);
+    store(offset + page_size + 8, 0x12345678);
+    store(offset + 2 * page_size + 8, 0x12345678);
+    store(offset + 2 * page_size + 12, 0x12345678);
+    ASSERT_TRUE(wasm_runtime_discard_memory(inst, offset + 8,
+                                            2 * page_size + 4));
+    EXPECT_EQ(load(offset), 0x12345678);
+    EXPECT_EQ(load(offset + 8), 0);
+    EXPECT_EQ(load(offset + page_size + 8), 0);
+    EXPECT_EQ(load(offset + 2 * page_size + 8), 0);
+    EXPECT_EQ(load(offset + 2 * page_size + 12), 0x12345678);
+}
+
+TEST_F(LinearMemoryMappingTest, test_discard_out_of_bounds)
+{
+    EXPECT_FALSE(wasm_runtime_discard_memory(inst, 65536 - 4, 8));
+    expect_exception("out of bounds memory access");
+    EXPECT_FALSE(wasm_runtime_discard_memory(inst, 0, 65536 + page_size));
+    expect_exception("out of bounds memory access");
+    EXPECT_TRUE(wasm_runtime_discard_memory(inst, 65536, 0));
+
+    /* The memory isn't changed */
+    EXPECT_EQ(load(16), DATA1);
+    EXPECT_EQ(load(8192), DATA2);
+}
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(LinearMemoryMappingTest, test_shrink_memory)
+{
+    uint32 argv[2];
+
+    argv[0] = 2;
+    ASSERT_TRUE(call("grow", 1, argv));
+    EXPECT_EQ(argv[0], 1);
+    store(65536 + 8, 0x12345678);
+    store(2 * 65536 + 8, 0x12345678);
+
+    /* The memory can't grow by shrinking */
+    EXPECT_FALSE(wasm_runtime_shrink_memory(inst, 4));
+    expect_exception("shrink memory failed");
+
+    ASSERT_TRUE(wasm_runtime_shrink_memory(inst, 1));
+    argv[0] = 0;
+    ASSERT_TRUE(call("size", 0, argv));
+    EXPECT_EQ(argv[0], 1);
+    EXPECT_EQ(load(16), DATA1);
+    EXPECT_EQ(load(65536 - 4), 0);
+
+    /* The accesses beyond the new size trap */
+    argv[0] = 65536 + 8;
+    EXPECT_FALSE(call("load", 1, argv));
+    expect_exception("out of bounds memory access");
+    argv[0] = 65536 - 2;
+    EXPECT_FALSE(call("load", 1, argv));
+    expect_exception("out of bounds memory access");
+    argv[0] = 2 * 65536 + 8;
+    argv[1] = 0;
+    EXPECT_FALSE(call("store", 2, argv));
+    expect_exception("out of bounds memory access");
+    EXPECT_FALSE(wasm_runtime_discard_memory(inst, 65536, page_size));
+    expect_exception("out of bounds memory access");
+
+    /* The released pages read as zero when the memory grows again */
+    argv[0] = 3;
+    ASSERT_TRUE(call("grow", 1, argv));
+    EXPECT_EQ(argv[0], 1);
+    EXPECT_EQ(load(65536 + 8), 0);
+    EXPECT_EQ(load(2 * 65536 + 8), 0);
+    store(3 * 65536 + 8, 0x12345678);
+    EXPECT_EQ(load(3 * 65536 + 8), 0x12345678);
+}
+
+TEST_F(LinearMemoryMappingTest, test_shrink_data_image_pages)
+{
+    uint32 argv[1];
+
+    /* Shrink the memory to zero pages, the pages of the data image are
+       released too */
+    store(16, 0x12345678);
+    ASSERT_TRUE(wasm_runtime_shrink_memory(inst, 0));
+    argv[0] = 16;
+    EXPECT_FALSE(call("load", 1, argv));
+    expect_exception("out of bounds memory access");
+
+    argv[0] = 1;
+    ASSERT_TRUE(call("grow", 1, argv));
+    EXPECT_EQ(argv[0], 0);
+    EXPECT_EQ(load(16), 0);
+    EXPECT_EQ(load(8192), 0);
+}
+#endif
@@ -0,0 +1,13 @@
+(module
+  (memory (export "memory") 1 4)
+
+  (func (export "load") (param i32) (result i32) (i32.load (local.get 0)))
+  (func (export "store") (param i32 i32)
+    (i32.store (local.get 0) (local.get 1))
+  )
+  (func (export "grow") (param i32) (result i32) (memory.grow (local.get 0)))
+  (func (export "size") (result i32) (memory.size))
+
+  (data (i32.const 16) "wamr")
+  (data (i32.const 8192) "data")
+)
@@ -325,3 +325,81 @@ TEST_F(TEST_SUITE_NAME, test_mem_grow_out_of_bounds)
 failed_out_of_bounds:
     destroy_module_env(tmp_module_env);
 }
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0 \
+    && WASM_MEM_SLOT_CACHE_SIZE > 0
+static bool
+call_func(struct ret_env *module_env, const char *name, uint32 argc,
+          uint32 argv[])
+{
+    WASMFunctionInstanceCommon *func = wasm_runtime_lookup_function(
+        module_env->wasm_module_inst, name);
+
+    EXPECT_NE(func, nullptr) << name;
+    return func
+           && wasm_runtime_call_wasm(module_env->exec_env, func, argc, argv);
+}
+
+TEST_F(TEST_SUITE_NAME, test_reused_memory_slot)
+{
+    struct ret_env tmp_module_env;
+    uint8 *memory_data;
+    uint32 argv[2];
+
+    // Test case: module((memory 1 8)), grow to 4 pages and write the first
+    // and the last page, then instantiate the module again.
+    tmp_module_env = load_wasm((char *)"/mem_slot_reuse.wasm", 0);
+    ASSERT_NE(tmp_module_env.exec_env, nullptr) << tmp_module_env.error_buf;
+    memory_data = (uint8 *)wasm_runtime_addr_app_to_native(
+        tmp_module_env.wasm_module_inst, 0);
+    ASSERT_NE(memory_data, nullptr);
+
+    argv[0] = 0;
+    argv[1] = 0x12345678;
+    ASSERT_TRUE(call_func(&tmp_module_env, "store", 2, argv));
+    argv[0] = 3;
+    ASSERT_TRUE(call_func(&tmp_module_env, "mem_grow", 1, argv));
+    EXPECT_EQ(1, argv[0]);
+    argv[0] = 3 * 64 * 1024;
+    argv[1] = 0x55aa55aa;
+    ASSERT_TRUE(call_func(&tmp_module_env, "store", 2, argv));
+
+    wasm_runtime_destroy_exec_env(tmp_module_env.exec_env);
+    wasm_runtime_deinstantiate(tmp_module_env.wasm_module_inst);
+
+    // The released reservation of the memory is taken again
+    tmp_module_env.wasm_module_inst =
+        wasm_runtime_instantiate(tmp_module_env.wasm_module, 16 * 1024, 0,
+                                 tmp_module_env.error_buf, 128);
+    ASSERT_NE(tmp_module_env.wasm_module_inst, nullptr)
+        << tmp_module_env.error_buf;
+    tmp_module_env.exec_env = wasm_runtime_create_exec_env(
+        tmp_module_env.wasm_module_inst, 16 * 1024);
+    ASSERT_NE(tmp_module_env.exec_env, nullptr);
+    EXPECT_EQ(memory_data,
+              wasm_runtime_addr_app_to_native(tmp_module_env.wasm_module_inst,
+                                              0));
+
+    // The written page is zeroed
+    argv[0] = 0;
+    ASSERT_TRUE(call_func(&tmp_module_env, "load", 1, argv));
+    EXPECT_EQ(0, argv[0]);
+
+    // The pages beyond the initial size are protected again
+    argv[0] = 3 * 64 * 1024;
+    EXPECT_FALSE(call_func(&tmp_module_env, "load", 1, argv));
+    EXPECT_STREQ("Exception: out of bounds memory access",
+                 wasm_runtime_get_exception(tmp_module_env.wasm_module_inst));
+    wasm_runtime_clear_exception(tmp_module_env.wasm_module_inst);
+
+    // and zeroed when the memory grows again
+    argv[0] = 3;
+    ASSERT_TRUE(call_func(&tmp_module_env, "mem_grow", 1, argv));
+    EXPECT_EQ(1, argv[0]);
+    argv[0] = 3 * 64 * 1024;
+    ASSERT_TRUE(call_func(&tmp_module_env, "load", 1, argv));
+    EXPECT_EQ(0, argv[0]);
+
+    destroy_module_env(tmp_module_env);
+}
+#endif
@@ -0,0 +1,20 @@
+(module
+  (memory 1 8)
+  (export "load" (func $load))
+  (export "store" (func $store))
+  (export "mem_grow" (func $mem_grow))
+
+  (func $load (param i32) (result i32)
+    local.get 0
+    i32.load
+    )
+  (func $store (param i32 i32)
+    local.get 0
+    local.get 1
+    i32.store
+    )
+  (func $mem_grow (param i32) (result i32)
+    local.get 0
+    memory.grow 0
+    )
+)
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "wasm_export.h"
+
+/* Offset of the i32.const operand of the multiplication in f0 */
+#define MUL_CONST_OFFSET 42
+
+/* (func (export "f0") (param i32) (result i32) x * 3 + 1)
+   (func (export "f1") (param i32) (result i32) x + 5) */
+static const uint8_t wasm_bytes[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    /* type section */
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    /* function section */
+    0x03, 0x03, 0x02, 0x00, 0x00,
+    /* export section */
+    0x07, 0x0b, 0x02, 0x02, 'f', '0', 0x00, 0x00, 0x02, 'f', '1', 0x00, 0x01,
+    /* code section */
+    0x0a, 0x14, 0x02,
+    0x0a, 0x00, 0x20, 0x00, 0x41, 0x03, 0x6c, 0x41, 0x01, 0x6a, 0x0b,
+    0x07, 0x00, 0x20, 0x00, 0x41, 0x05, 0x6a, 0x0b,
+};
+
+/* The inode of each file in the cache directory, a cached object which
+   is saved again is renamed from a new temporary file */
+typedef std::map<std::string, ino_t> CacheFiles;
+
+class llvm_jit_cache_test_suite : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        char dir_template[] = "/tmp/wamr_jit_cache_XXXXXX";
+
+        ASSERT_NE(mkdtemp(dir_template), nullptr);
+        cache_dir = dir_template;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        init_args.running_mode = Mode_LLVM_JIT;
+        init_args.llvm_jit_opt_level = 3;
+        init_args.llvm_jit_size_level = 3;
+        init_args.llvm_jit_cache_dir = cache_dir.c_str();
+
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        cleanup = true;
+    }
+
+    virtual void TearDown()
+    {
+        if (cleanup) {
+            wasm_runtime_destroy();
+            cleanup = false;
+        }
+
+        for (auto &file : list_cache_files())
+            unlink((cache_dir + "/" + file.first).c_str());
+        rmdir(cache_dir.c_str());
+    }
+
+    CacheFiles list_cache_files()
+    {
+        CacheFiles files;
+        DIR *dir = opendir(cache_dir.c_str());
+        struct dirent *entry;
+        struct stat st;
+
+        if (!dir)
+            return files;
+        while ((entry = readdir(dir))) {
+            std::string path = cache_dir + "/" + entry->d_name;
+
+            if (entry->d_name[0] != '.' && stat(path.c_str(), &st) == 0)
+                files[entry->d_name] = st.st_ino;
+        }
+        closedir(dir);
+        return files;
+    }
+
+    /* Load the module with the JIT, which compiles the functions or
+       reloads them from the cache, and check the results */
+    void run_module(uint8_t mul_const)
+    {
+        std::vector<uint8_t> wasm(wasm_bytes, wasm_bytes + sizeof(wasm_bytes));
+        char error_buf[128] = { 0 };
+        wasm_module_t module;
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        uint32_t argv[1];
+
+        wasm[MUL_CONST_OFFSET] = mul_const;
+        module = wasm_runtime_load(wasm.data(), (uint32_t)wasm.size(),
+                                   error_buf, sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(module_inst, nullptr) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(module_inst, 8192);
+        ASSERT_NE(exec_env, nullptr);
+
+        func = wasm_runtime_lookup_function(module_inst, "f0");
+        ASSERT_NE(func, nullptr);
+        argv[0] = 7;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        EXPECT_EQ(argv[0], 7u * mul_const + 1);
+
+        func = wasm_runtime_lookup_function(module_inst, "f1");
+        ASSERT_NE(func, nullptr);
+        argv[0] = 7;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        EXPECT_EQ(argv[0], 12u);
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(module_inst);
+        wasm_runtime_unload(module);
+    }
+
+    std::string cache_dir;
+    bool cleanup = false;
+    char global_heap_buf[4 * 1024 * 1024];
+};
+
+TEST_F(llvm_jit_cache_test_suite, reuse_cached_objects)
+{
+    CacheFiles files;
+
+    run_module(3);
+    files = list_cache_files();
+    ASSERT_FALSE(files.empty());
+
+    /* The same module is reloaded from the cache, no object is compiled
+       and saved again */
+    run_module(3);
+    EXPECT_EQ(list_cache_files(), files);
+}
+
+TEST_F(llvm_jit_cache_test_suite, module_key_mismatch)
+{
+    CacheFiles files, new_files;
+    std::string key;
+
+    run_module(3);
+    files = list_cache_files();
+    ASSERT_FALSE(files.empty());
+
+    /* Another module misses the cache and f0 returns the result of its
+       own constant, the objects of the first module are left untouched */
+    run_module(4);
+    new_files = list_cache_files();
+    EXPECT_EQ(new_files.size(), files.size() * 2);
+
+    /* The file names start with the hash of the wasm binary */
+    key = files.begin()->first.substr(0, 16);
+    for (auto &file : files) {
+        EXPECT_EQ(file.first.substr(0, 16), key);
+        ASSERT_EQ(new_files.count(file.first), 1u);
+        EXPECT_EQ(new_files[file.first], file.second);
+    }
+    for (auto &file : new_files) {
+        if (!files.count(file.first))
+            EXPECT_NE(file.first.substr(0, 16), key);
+    }
+}
@@ -67,6 +67,35 @@ class memory64_test_suite : public testing::TestWithParam<RunningMode>
         wasm_runtime_unload(module);
     }
 
+    bool call_func(const char *func_name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, func_name);
+
+        if (!func)
+            return false;
+
+        wasm_runtime_clear_exception(module_inst);
+        return wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    // Check that the access to the address with the function traps, the
+    // address is followed by the value to store if argc is 3
+    void expect_out_of_bounds(const char *func_name, uint32 argc,
+                              uint64 addr)
+    {
+        uint32 wasm_argv[3] = { 0 };
+        const char *exception;
+
+        PUT_I64_TO_ADDR(wasm_argv, addr);
+        ASSERT_FALSE(call_func(func_name, argc, wasm_argv))
+            << func_name << " 0x" << std::hex << addr;
+        exception = wasm_runtime_get_exception(module_inst);
+        ASSERT_TRUE(exception != NULL);
+        ASSERT_TRUE(strstr(exception, "out of bounds memory access") != NULL)
+            << exception;
+    }
+
   public:
     //  If your test fixture defines SetUpTestSuite() or TearDownTestSuite()
     //  they must be declared public rather than protected in order to use
@@ -150,6 +179,9 @@ TEST_F(memory64_test_suite, page_u32_max)
     ASSERT_TRUE(ret);
 }
 
+#ifndef OS_ENABLE_HW_BOUND_CHECK
+// The memory64 size is limited to MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE with
+// the hardware bound check, see memory_8GB_hw_bound_check
 TEST_P(memory64_test_suite, memory_8GB)
 {
     RunningMode running_mode = GetParam();
@@ -203,6 +235,7 @@ TEST_P(memory64_test_suite, memory_8GB)
 
     destory_exec_env();
 }
+#endif
 
 TEST_P(memory64_test_suite, mem64_from_clang)
 {
@@ -231,5 +264,153 @@ TEST_P(memory64_test_suite, mem64_from_clang)
     destory_exec_env();
 }
 
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(memory64_test_suite, memory_8GB_hw_bound_check)
+{
+    bool ret;
+
+    ret = load_wasm_file("8GB_memory.wasm");
+    ASSERT_TRUE(ret);
+    module_inst = wasm_runtime_instantiate(module, stack_size, heap_size,
+                                           error_buf, sizeof(error_buf));
+    ASSERT_TRUE(module_inst == NULL);
+    ASSERT_TRUE(strstr(error_buf, "memory64 size exceeds the limit of the "
+                                  "hardware bound check")
+                != NULL)
+        << error_buf;
+    wasm_runtime_unload(module);
+}
+
+TEST_P(memory64_test_suite, hw_bound_check_clamp)
+{
+    RunningMode running_mode = GetParam();
+    const uint64 max_size = MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE;
+    const uint64 addrs_oob[] = { 0x10000 - 3,
+                                 0x10000,
+                                 max_size - 8,
+                                 max_size - 3,
+                                 max_size,
+                                 max_size + 1,
+                                 8 * (uint64)BH_GB - 4,
+                                 8 * (uint64)BH_GB,
+                                 12 * (uint64)BH_GB,
+                                 (uint64)1 << 63,
+                                 UINT64_MAX - 3,
+                                 UINT64_MAX };
+    uint32_t wasm_argv[3];
+    bool ret;
+
+    // No app heap is inserted into the memory
+    heap_size = 0;
+    ret = load_wasm_file("hw_bound_check.wasm");
+    ASSERT_TRUE(ret);
+    ret = init_exec_env();
+    ASSERT_TRUE(ret);
+
+    ret = wasm_runtime_set_running_mode(module_inst, running_mode);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ(running_mode, wasm_runtime_get_running_mode(module_inst));
+
+    PUT_I64_TO_ADDR(wasm_argv, 0x10000 - 4);
+    wasm_argv[2] = 0xbeefdead;
+    ASSERT_TRUE(call_func("i32_store", 3, wasm_argv));
+
+    // The addresses beyond the memory, the largest memory and the reserved
+    // space are clamped to the guard page and trap
+    for (uint64 addr : addrs_oob) {
+        expect_out_of_bounds("i32_load", 2, addr);
+        expect_out_of_bounds("i32_store", 3, addr);
+        expect_out_of_bounds("i64_load", 2, addr);
+    }
+
+    // The effective address overflows and wraps to a valid offset
+    expect_out_of_bounds("i32_load_offset_max", 2, 0);
+    expect_out_of_bounds("i32_load_offset_max", 2, 0x10);
+    expect_out_of_bounds("i32_load_offset_max", 2, 0x20);
+    expect_out_of_bounds("i32_load_offset_max", 2, max_size + 0x10);
+
+    PUT_I64_TO_ADDR(wasm_argv, 0x10000 - 4);
+    ASSERT_TRUE(call_func("i32_load", 2, wasm_argv));
+    ASSERT_EQ(0xbeefdead, wasm_argv[0]);
+
+    destory_exec_env();
+}
+
+TEST_P(memory64_test_suite, hw_bound_check_max_size)
+{
+    RunningMode running_mode = GetParam();
+    const uint64 max_size = MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE;
+    const uint64 max_page_count = max_size / 0x10000;
+    uint32_t wasm_argv[3];
+    bool ret;
+
+    heap_size = 0;
+    ret = load_wasm_file("hw_bound_check.wasm");
+    ASSERT_TRUE(ret);
+    ret = init_exec_env();
+    ASSERT_TRUE(ret);
+
+    ret = wasm_runtime_set_running_mode(module_inst, running_mode);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ(running_mode, wasm_runtime_get_running_mode(module_inst));
+
+    // The max page count of the module is 8GB, it is limited to the size
+    // with the guard page kept
+    PUT_I64_TO_ADDR(wasm_argv, max_page_count);
+    ASSERT_TRUE(call_func("grow", 2, wasm_argv));
+    ASSERT_EQ(UINT64_MAX, GET_U64_FROM_ADDR(wasm_argv));
+
+    // Grow a small amount, the pages beyond the memory size are reserved
+    // but not accessible
+    PUT_I64_TO_ADDR(wasm_argv, 1);
+    ASSERT_TRUE(call_func("grow", 2, wasm_argv));
+    ASSERT_EQ(1, GET_U64_FROM_ADDR(wasm_argv));
+    PUT_I64_TO_ADDR(wasm_argv, 2 * 0x10000 - 4);
+    wasm_argv[2] = 0xbeefdead;
+    ASSERT_TRUE(call_func("i32_store", 3, wasm_argv));
+    PUT_I64_TO_ADDR(wasm_argv, 2 * 0x10000 - 4);
+    ASSERT_TRUE(call_func("i32_load", 2, wasm_argv));
+    ASSERT_EQ(0xbeefdead, wasm_argv[0]);
+    expect_out_of_bounds("i32_load", 2, 2 * 0x10000 - 3);
+    expect_out_of_bounds("i32_store", 3, 2 * 0x10000);
+
+    // The accesses at or beyond the limit trap
+    expect_out_of_bounds("i32_load", 2, max_size - 4);
+    expect_out_of_bounds("i32_load", 2, max_size);
+    expect_out_of_bounds("i64_load", 2, 8 * (uint64)BH_GB - 8);
+    expect_out_of_bounds("i32_load", 2, UINT64_MAX);
+    expect_out_of_bounds("i32_load_offset_max", 2, 0x10);
+
+    // Growing to the limit needs the whole reservation to be committed,
+    // which the system may refuse
+    PUT_I64_TO_ADDR(wasm_argv, max_page_count - 2);
+    ASSERT_TRUE(call_func("grow", 2, wasm_argv));
+    if (GET_U64_FROM_ADDR(wasm_argv) == UINT64_MAX) {
+        destory_exec_env();
+        GTEST_SKIP() << "can't grow the memory to the limit";
+    }
+    ASSERT_EQ(2, GET_U64_FROM_ADDR(wasm_argv));
+    ASSERT_TRUE(call_func("size", 0, wasm_argv));
+    ASSERT_EQ(max_page_count, GET_U64_FROM_ADDR(wasm_argv));
+
+    // The last bytes of the largest memory are accessible, the accesses
+    // crossing the end of it trap
+    PUT_I64_TO_ADDR(wasm_argv, max_size - 4);
+    wasm_argv[2] = 0xbeefdead;
+    ASSERT_TRUE(call_func("i32_store", 3, wasm_argv));
+    PUT_I64_TO_ADDR(wasm_argv, max_size - 8);
+    ASSERT_TRUE(call_func("i64_load", 2, wasm_argv));
+    ASSERT_EQ((uint64)0xbeefdead << 32, GET_U64_FROM_ADDR(wasm_argv));
+    expect_out_of_bounds("i32_load", 2, max_size - 3);
+    expect_out_of_bounds("i64_load", 2, max_size - 7);
+
+    PUT_I64_TO_ADDR(wasm_argv, 1);
+    ASSERT_TRUE(call_func("grow", 2, wasm_argv));
+    ASSERT_EQ(UINT64_MAX, GET_U64_FROM_ADDR(wasm_argv));
+
+    destory_exec_env();
+}
+#endif
+
 INSTANTIATE_TEST_CASE_P(RunningMode, memory64_test_suite,
                         testing::ValuesIn(running_mode_supported));
\ No newline at end of file
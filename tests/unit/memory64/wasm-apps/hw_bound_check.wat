@@ -0,0 +1,30 @@
+(module
+  ;; The max size is limited to 8GB - 64KB with the hardware bound check,
+  ;; see MAX_LINEAR_MEM64_HW_BOUND_CHECK_SIZE
+  (memory (;0;) i64 1 131072)
+
+  (func (export "i32_load") (param $addr i64) (result i32)
+    (i32.load (local.get $addr))
+  )
+
+  (func (export "i32_store") (param $addr i64) (param $value i32)
+    (i32.store (local.get $addr) (local.get $value))
+  )
+
+  (func (export "i64_load") (param $addr i64) (result i64)
+    (i64.load (local.get $addr))
+  )
+
+  ;; The effective address overflows if $addr >= 0x10
+  (func (export "i32_load_offset_max") (param $addr i64) (result i32)
+    (i32.load offset=0xfffffffffffffff0 (local.get $addr))
+  )
+
+  (func (export "grow") (param $delta i64) (result i64)
+    (memory.grow (local.get $delta))
+  )
+
+  (func (export "size") (result i64)
+    (memory.size)
+  )
+)
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#include <vector>
+
+/* "mem0" and "mem1" at offset 16 of memory 0 and memory 1 */
+#define DATA0 0x306d656d
+#define DATA1 0x316d656d
+
+class MultiMemoryTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/multi_memory.wasm";
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        ASSERT_NE(inst, nullptr) << error_buf;
+    }
+
+    void TearDown()
+    {
+        if (inst)
+            wasm_runtime_deinstantiate(inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+    }
+
+  public:
+    bool call(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 call_i32(const char *name, uint32 arg = 0)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call(name, 1, argv)) << name;
+        return argv[0];
+    }
+
+    void store(const char *name, uint32 addr, uint32 value)
+    {
+        uint32 argv[2] = { addr, value };
+
+        EXPECT_TRUE(call(name, 2, argv)) << name;
+    }
+
+    /* The access traps with out of bounds memory access */
+    void expect_oob(const char *name, uint32 addr)
+    {
+        uint32 argv[2] = { addr, 0 };
+        const char *exception;
+
+        EXPECT_FALSE(call(name, 2, argv)) << name << " " << addr;
+        exception = wasm_runtime_get_exception(inst);
+        ASSERT_NE(exception, nullptr);
+        EXPECT_NE(strstr(exception, "out of bounds memory access"), nullptr)
+            << exception;
+    }
+
+    /* Build a module with memory_count memories of one page and a function
+       of type [] -> [i32] with the code, and return whether it loads */
+    bool load_module(uint8 memory_count, std::vector<uint8> code)
+    {
+        std::vector<uint8> buf = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00,
+                                   0x00,
+                                   /* type section */
+                                   0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7f,
+                                   /* function section */
+                                   0x03, 0x02, 0x01, 0x00 };
+        wasm_module_t module_loaded;
+
+        if (memory_count > 0) {
+            buf.insert(buf.end(), { 0x05, (uint8)(1 + memory_count * 2),
+                                    memory_count });
+            for (uint8 i = 0; i < memory_count; i++)
+                buf.insert(buf.end(), { 0x00, 0x01 });
+        }
+
+        /* code section, the body has no locals and ends with end */
+        buf.insert(buf.end(), { 0x0a, (uint8)(code.size() + 4), 0x01,
+                                (uint8)(code.size() + 2), 0x00 });
+        buf.insert(buf.end(), code.begin(), code.end());
+        buf.push_back(0x0b);
+
+        module_loaded = wasm_runtime_load(buf.data(), (uint32)buf.size(),
+                                          error_buf, sizeof(error_buf));
+        if (!module_loaded)
+            return false;
+        wasm_runtime_unload(module_loaded);
+        return true;
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t inst = NULL;
+    char error_buf[128];
+};
+
+TEST_F(MultiMemoryTest, test_load_store)
+{
+    /* The data segments are copied to their own memories */
+    EXPECT_EQ(call_i32("load0", 16), DATA0);
+    EXPECT_EQ(call_i32("load1", 16), DATA1);
+    EXPECT_EQ(call_i32("load1_8u_offset", 12), 'm');
+    EXPECT_EQ(call_i32("load1_8u_offset", 15), '1');
+
+    /* The stores go to the memory of the index */
+    store("store1", 100, 0x12345678);
+    EXPECT_EQ(call_i32("load1", 100), 0x12345678);
+    EXPECT_EQ(call_i32("load0", 100), 0);
+    store("store0", 100, 0x11111111);
+    EXPECT_EQ(call_i32("load0", 100), 0x11111111);
+    EXPECT_EQ(call_i32("load1", 100), 0x12345678);
+    EXPECT_EQ(call_i32("load1_8u_offset", 96), 0x78);
+}
+
+TEST_F(MultiMemoryTest, test_bounds)
+{
+    /* Each memory is checked against its own size */
+    expect_oob("load0", 65536);
+    expect_oob("store0", 65536 - 2);
+    store("store1", 65536, 0x12345678);
+    EXPECT_EQ(call_i32("load1", 65536), 0x12345678);
+    expect_oob("load1", 2 * 65536 - 2);
+    expect_oob("load1_8u_offset", 2 * 65536 - 4);
+    expect_oob("load2", 0);
+    expect_oob("store2", 0);
+}
+
+TEST_F(MultiMemoryTest, test_size_grow)
+{
+    EXPECT_EQ(call_i32("size0"), 1);
+    EXPECT_EQ(call_i32("size1"), 2);
+    EXPECT_EQ(call_i32("size2"), 0);
+
+    /* Only the memory of the index grows */
+    EXPECT_EQ(call_i32("grow1", 1), 2);
+    EXPECT_EQ(call_i32("size1"), 3);
+    EXPECT_EQ(call_i32("size0"), 1);
+    EXPECT_EQ(call_i32("size2"), 0);
+    store("store1", 2 * 65536 + 8, 0x12345678);
+    EXPECT_EQ(call_i32("load1", 2 * 65536 + 8), 0x12345678);
+    expect_oob("load0", 65536);
+
+    EXPECT_EQ(call_i32("grow2", 1), 0);
+    EXPECT_EQ(call_i32("size2"), 1);
+    store("store2", 8, 0x11111111);
+    EXPECT_EQ(call_i32("load2", 8), 0x11111111);
+    EXPECT_EQ(call_i32("load0", 8), 0);
+    EXPECT_EQ(call_i32("load1", 8), 0);
+    expect_oob("load2", 65536);
+
+    /* The maximum page count of each memory is checked */
+    EXPECT_EQ(call_i32("grow1", 2), (uint32)-1);
+    EXPECT_EQ(call_i32("grow1", 1), 3);
+    EXPECT_EQ(call_i32("grow2", 2), (uint32)-1);
+    EXPECT_EQ(call_i32("grow0", 1), 1);
+    EXPECT_EQ(call_i32("size1"), 4);
+    EXPECT_EQ(call_i32("size2"), 1);
+    EXPECT_EQ(call_i32("load1", 16), DATA1);
+}
+
+TEST_F(MultiMemoryTest, test_load_memidx)
+{
+    /* i32.const 0, i32.load with the memory index flag in the align */
+    EXPECT_TRUE(load_module(2, { 0x41, 0x00, 0x28, 0x42, 0x01, 0x00 }))
+        << error_buf;
+    EXPECT_TRUE(load_module(1, { 0x41, 0x00, 0x28, 0x42, 0x00, 0x00 }))
+        << error_buf;
+
+    EXPECT_FALSE(load_module(1, { 0x41, 0x00, 0x28, 0x42, 0x01, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory 1"), nullptr) << error_buf;
+    EXPECT_FALSE(load_module(2, { 0x41, 0x00, 0x28, 0x42, 0x02, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory 2"), nullptr) << error_buf;
+
+    /* The align without the flag is still checked */
+    EXPECT_FALSE(load_module(2, { 0x41, 0x00, 0x28, 0x43, 0x01, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "alignment must not be larger than natural"),
+              nullptr)
+        << error_buf;
+}
+
+TEST_F(MultiMemoryTest, test_store_memidx)
+{
+    /* i32.const 0, i32.const 0, i32.store, i32.const 0 */
+    EXPECT_TRUE(load_module(2, { 0x41, 0x00, 0x41, 0x00, 0x36, 0x42, 0x01,
+                                 0x00, 0x41, 0x00 }))
+        << error_buf;
+
+    EXPECT_FALSE(load_module(1, { 0x41, 0x00, 0x41, 0x00, 0x36, 0x42, 0x01,
+                                  0x00, 0x41, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory 1"), nullptr) << error_buf;
+}
+
+TEST_F(MultiMemoryTest, test_size_grow_memidx)
+{
+    /* memory.size and memory.grow with the memory index */
+    EXPECT_TRUE(load_module(2, { 0x3f, 0x01 })) << error_buf;
+    EXPECT_TRUE(load_module(2, { 0x41, 0x00, 0x40, 0x01 })) << error_buf;
+
+    EXPECT_FALSE(load_module(2, { 0x3f, 0x02 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory 2"), nullptr) << error_buf;
+    EXPECT_FALSE(load_module(2, { 0x41, 0x00, 0x40, 0x02 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory 2"), nullptr) << error_buf;
+
+    /* The instructions require a memory */
+    EXPECT_FALSE(load_module(0, { 0x3f, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory"), nullptr) << error_buf;
+    EXPECT_FALSE(load_module(0, { 0x41, 0x00, 0x28, 0x02, 0x00 }));
+    EXPECT_NE(strstr(error_buf, "unknown memory"), nullptr) << error_buf;
+}
@@ -0,0 +1,45 @@
+(module
+  (memory $m0 1)
+  (memory $m1 2 4)
+  (memory $m2 0 2)
+
+  (func (export "load0") (param i32) (result i32)
+    (i32.load $m0 (local.get 0))
+  )
+  (func (export "store0") (param i32 i32)
+    (i32.store $m0 (local.get 0) (local.get 1))
+  )
+  (func (export "size0") (result i32) (memory.size $m0))
+  (func (export "grow0") (param i32) (result i32)
+    (memory.grow $m0 (local.get 0))
+  )
+
+  (func (export "load1") (param i32) (result i32)
+    (i32.load $m1 (local.get 0))
+  )
+  (func (export "store1") (param i32 i32)
+    (i32.store $m1 (local.get 0) (local.get 1))
+  )
+  (func (export "size1") (result i32) (memory.size $m1))
+  (func (export "grow1") (param i32) (result i32)
+    (memory.grow $m1 (local.get 0))
+  )
+
+  (func (export "load2") (param i32) (result i32)
+    (i32.load $m2 (local.get 0))
+  )
+  (func (export "store2") (param i32 i32)
+    (i32.store $m2 (local.get 0) (local.get 1))
+  )
+  (func (export "size2") (result i32) (memory.size $m2))
+  (func (export "grow2") (param i32) (result i32)
+    (memory.grow $m2 (local.get 0))
+  )
+
+  (func (export "load1_8u_offset") (param i32) (result i32)
+    (i32.load8_u $m1 offset=4 (local.get 0))
+  )
+
+  (data (memory $m0) (i32.const 16) "mem0")
+  (data (memory $m1) (i32.const 16) "mem1")
+)
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "wasm_runtime.h"
+
+#include <unistd.h>
+
+#define HEAP_SIZE (1024 * 1024)
+/* The heap is mapped to the top of the 4 GB app address space */
+#define HEAP_START ((uint32)((1ULL << 32) - HEAP_SIZE))
+/* The max page count of the memory clamped below the heap */
+#define CLAMPED_MAX_PAGE_COUNT (HEAP_START / 65536)
+
+class SharedHeapTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        std::string file = get_binary_path() + "/shared_heap.wasm";
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_NE(wasm_file_buf, nullptr);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_NE(module, nullptr) << error_buf;
+
+        for (uint32 i = 0; i < 2; i++) {
+            insts[i] = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                                sizeof(error_buf));
+            ASSERT_NE(insts[i], nullptr) << error_buf;
+        }
+
+        heap = wasm_runtime_create_shared_heap(HEAP_SIZE, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_NE(heap, nullptr) << error_buf;
+    }
+
+    void TearDown()
+    {
+        /* Deinstantiating detaches the heap */
+        for (uint32 i = 0; i < 2; i++) {
+            if (insts[i])
+                wasm_runtime_deinstantiate(insts[i]);
+        }
+        if (heap)
+            wasm_runtime_destroy_shared_heap(heap);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+    }
+
+  public:
+    bool call(wasm_module_inst_t inst, const char *name, uint32 argc,
+              uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!func || !(exec_env = wasm_runtime_create_exec_env(inst, 8192)))
+            return false;
+
+        wasm_runtime_clear_exception(inst);
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    uint32 load(wasm_module_inst_t inst, uint32 addr)
+    {
+        uint32 argv[1] = { addr };
+
+        EXPECT_TRUE(call(inst, "load", 1, argv)) << addr;
+        return argv[0];
+    }
+
+    void store(wasm_module_inst_t inst, uint32 addr, uint32 value)
+    {
+        uint32 argv[2] = { addr, value };
+
+        EXPECT_TRUE(call(inst, "store", 2, argv)) << addr;
+    }
+
+    /* Call the bulk memory operation, and expect it to trap if
+       out_of_bounds is true */
+    void bulk(wasm_module_inst_t inst, const char *name, uint32 arg0,
+              uint32 arg1, uint32 n, bool out_of_bounds = false)
+    {
+        uint32 argv[3] = { arg0, arg1, n };
+
+        if (!out_of_bounds) {
+            EXPECT_TRUE(call(inst, name, 3, argv))
+                << name << " 0x" << std::hex << arg0;
+            return;
+        }
+        EXPECT_FALSE(call(inst, name, 3, argv))
+            << name << " 0x" << std::hex << arg0;
+        expect_exception(inst, "out of bounds memory access");
+    }
+
+    uint32 get_max_page_count(wasm_module_inst_t inst)
+    {
+        return ((WASMModuleInstance *)inst)->memories[0]->max_page_count;
+    }
+
+    void expect_exception(wasm_module_inst_t inst, const char *exception)
+    {
+        const char *cur_exception = wasm_runtime_get_exception(inst);
+
+        ASSERT_NE(cur_exception, nullptr);
+        EXPECT_NE(strstr(cur_exception, exception), nullptr) << cur_exception;
+        wasm_runtime_clear_exception(inst);
+    }
+
+  public:
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t insts[2] = { NULL, NULL };
+    wasm_shared_heap_t heap = NULL;
+    char error_buf[128];
+};
+
+TEST_F(SharedHeapTest, test_attach_detach)
+{
+    wasm_module_inst_t inst = insts[0];
+    uint32 max_page_count = get_max_page_count(inst);
+    uint32 argv[2];
+
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(inst, heap, false));
+    store(inst, HEAP_START, 0x12345678);
+    EXPECT_EQ(load(inst, HEAP_START), 0x12345678);
+    store(inst, (uint32)-4, 0x12345678);
+
+    /* A heap can only be attached once */
+    EXPECT_FALSE(wasm_runtime_attach_shared_heap(inst, heap, false));
+    expect_exception(inst, "shared heap is already attached");
+
+    /* The memory can't grow into the heap */
+    EXPECT_EQ(get_max_page_count(inst), CLAMPED_MAX_PAGE_COUNT);
+    argv[0] = CLAMPED_MAX_PAGE_COUNT;
+    ASSERT_TRUE(call(inst, "grow", 1, argv));
+    EXPECT_EQ(argv[0], (uint32)-1);
+
+    /* The max page count is restored and the heap is inaccessible after
+       it is detached */
+    wasm_runtime_detach_shared_heap(inst);
+    EXPECT_EQ(get_max_page_count(inst), max_page_count);
+    argv[0] = HEAP_START;
+    EXPECT_FALSE(call(inst, "load", 1, argv));
+    expect_exception(inst, "out of bounds memory access");
+    argv[0] = HEAP_START;
+    argv[1] = 0;
+    EXPECT_FALSE(call(inst, "store", 2, argv));
+    expect_exception(inst, "out of bounds memory access");
+    bulk(inst, "fill", HEAP_START, 0, 4, true);
+
+    /* Detaching it again is a no-op, and it can be attached again with
+       the content kept */
+    wasm_runtime_detach_shared_heap(inst);
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(inst, heap, false));
+    EXPECT_EQ(load(inst, HEAP_START), 0x12345678);
+    EXPECT_EQ(get_max_page_count(inst), CLAMPED_MAX_PAGE_COUNT);
+}
+
+TEST_F(SharedHeapTest, test_malloc_free_across_instances)
+{
+    uint64 app_offset1, app_offset2;
+    void *native_addr1, *native_addr2;
+
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(insts[0], heap, false));
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(insts[1], heap, false));
+
+    app_offset1 = wasm_runtime_shared_heap_malloc(heap, 64, &native_addr1);
+    app_offset2 = wasm_runtime_shared_heap_malloc(heap, 64, &native_addr2);
+    ASSERT_GE(app_offset1, HEAP_START);
+    ASSERT_GE(app_offset2, HEAP_START);
+    ASSERT_LE(app_offset1 + 64, 1ULL << 32);
+    ASSERT_LE(app_offset2 + 64, 1ULL << 32);
+    ASSERT_NE(app_offset1, app_offset2);
+
+    /* The writes of the host and the instances are visible to each other
+       at the same app offset */
+    *(uint32 *)native_addr1 = 0x12345678;
+    EXPECT_EQ(load(insts[0], (uint32)app_offset1), 0x12345678);
+    EXPECT_EQ(load(insts[1], (uint32)app_offset1), 0x12345678);
+    store(insts[0], (uint32)app_offset2 + 8, 0x11111111);
+    EXPECT_EQ(load(insts[1], (uint32)app_offset2 + 8), 0x11111111);
+    EXPECT_EQ(*(uint32 *)((uint8 *)native_addr2 + 8), 0x11111111);
+
+    /* The app offset is valid in the native API of the instances */
+    EXPECT_TRUE(wasm_runtime_validate_app_addr(insts[1], app_offset2, 64));
+    native_addr2 = wasm_runtime_addr_app_to_native(insts[1], app_offset2);
+    ASSERT_NE(native_addr2, nullptr);
+    EXPECT_EQ(*(uint32 *)((uint8 *)native_addr2 + 8), 0x11111111);
+    EXPECT_EQ(wasm_runtime_addr_native_to_app(insts[1], native_addr2),
+              app_offset2);
+
+    /* The memory freed is allocated again */
+    wasm_runtime_shared_heap_free(heap, app_offset1);
+    EXPECT_EQ(wasm_runtime_shared_heap_malloc(heap, 64, NULL), app_offset1);
+    wasm_runtime_shared_heap_free(heap, app_offset1);
+    wasm_runtime_shared_heap_free(heap, app_offset2);
+
+    /* The allocations larger than the heap fail */
+    EXPECT_EQ(wasm_runtime_shared_heap_malloc(heap, HEAP_SIZE, NULL), 0);
+}
+
+TEST_F(SharedHeapTest, test_read_only)
+{
+    uint64 app_offset;
+    void *native_addr;
+    uint32 argv[2];
+
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(insts[0], heap, false));
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(insts[1], heap, true));
+
+    app_offset = wasm_runtime_shared_heap_malloc(heap, 64, &native_addr);
+    ASSERT_NE(app_offset, 0);
+    store(insts[0], (uint32)app_offset, 0x12345678);
+    EXPECT_EQ(load(insts[1], (uint32)app_offset), 0x12345678);
+
+    /* The stores of the read-only instance trap, including the bulk
+       memory operations */
+    argv[0] = (uint32)app_offset;
+    argv[1] = 0;
+    EXPECT_FALSE(call(insts[1], "store", 2, argv));
+    expect_exception(insts[1], "out of bounds memory access");
+    bulk(insts[1], "fill", (uint32)app_offset, 0, 4, true);
+    bulk(insts[1], "copy", (uint32)app_offset, 0, 4, true);
+    EXPECT_EQ(*(uint32 *)native_addr, 0x12345678);
+
+    /* Reading the heap into its own memory is allowed */
+    bulk(insts[1], "copy", 16, (uint32)app_offset, 4);
+    EXPECT_EQ(load(insts[1], 16), 0x12345678);
+}
+
+TEST_F(SharedHeapTest, test_bulk_memory)
+{
+    wasm_module_inst_t inst = insts[0];
+    uint32 argv[2];
+
+    ASSERT_TRUE(wasm_runtime_attach_shared_heap(inst, heap, false));
+
+    /* memory.fill, memory.copy and memory.init in the heap */
+    bulk(inst, "fill", HEAP_START, 0x11, 8);
+    EXPECT_EQ(load(inst, HEAP_START + 4), 0x11111111);
+    store(inst, 16, 0x12345678);
+    bulk(inst, "copy", HEAP_START + 64, 16, 4);
+    EXPECT_EQ(load(inst, HEAP_START + 64), 0x12345678);
+    bulk(inst, "copy", (uint32)-4, HEAP_START + 64, 4);
+    EXPECT_EQ(load(inst, (uint32)-4), 0x12345678);
+    bulk(inst, "copy", 32, (uint32)-4, 4);
+    EXPECT_EQ(load(inst, 32), 0x12345678);
+    bulk(inst, "init", HEAP_START + 128, 0, 4);
+    EXPECT_EQ(load(inst, HEAP_START + 128), 0x726d6177);
+
+    /* The ranges crossing the end of the heap, or between the memory
+       and the heap trap */
+    bulk(inst, "fill", (uint32)-4, 0, 8, true);
+    bulk(inst, "fill", HEAP_START - 4, 0, 8, true);
+    bulk(inst, "fill", 65536 - 4, 0, 8, true);
+    bulk(inst, "fill", 65536, 0, 4, true);
+    bulk(inst, "copy", HEAP_START - 4, 16, 4, true);
+    bulk(inst, "copy", 16, (uint32)-2, 4, true);
+    bulk(inst, "init", (uint32)-2, 0, 4, true);
+    argv[0] = HEAP_START - 4;
+    EXPECT_FALSE(call(inst, "load", 1, argv));
+    expect_exception(inst, "out of bounds memory access");
+
+    /* The memory isn't changed by the operations trapped */
+    EXPECT_EQ(load(inst, (uint32)-4), 0x12345678);
+    EXPECT_EQ(load(inst, 16), 0x12345678);
+}
@@ -0,0 +1,40 @@
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Build SHARED_HEAP_TEST with the interpreter set by WAMR_BUILD_FAST_INTERP
+
+include (${CMAKE_CURRENT_LIST_DIR}/../unit_common.cmake)
+
+include_directories (${CMAKE_CURRENT_LIST_DIR})
+
+set (UNIT_SOURCE ${CMAKE_CURRENT_LIST_DIR}/shared_heap_test.cc)
+
+set (unit_test_sources
+    ${UNIT_SOURCE}
+    ${WAMR_RUNTIME_LIB_SOURCE}
+    ${UNCOMMON_SHARED_SOURCE}
+    ${SRC_LIST}
+    ${PLATFORM_SHARED_SOURCE}
+    ${UTILS_SHARED_SOURCE}
+    ${MEM_ALLOC_SHARED_SOURCE}
+    ${LIB_HOST_AGENT_SOURCE}
+    ${NATIVE_INTERFACE_SOURCE}
+    ${LIBC_BUILTIN_SOURCE}
+    ${IWASM_COMMON_SOURCE}
+    ${IWASM_INTERP_SOURCE}
+    ${IWASM_AOT_SOURCE}
+    ${IWASM_COMPL_SOURCE}
+    ${WASM_APP_LIB_SOURCE_ALL}
+)
+
+add_executable (${SHARED_HEAP_TEST} ${unit_test_sources})
+target_link_libraries (${SHARED_HEAP_TEST} gtest_main)
+
+add_custom_command(TARGET ${SHARED_HEAP_TEST} POST_BUILD
+  COMMAND ${CMAKE_COMMAND} -E copy
+  ${CMAKE_CURRENT_LIST_DIR}/wasm-apps/shared_heap.wasm
+  ${CMAKE_CURRENT_BINARY_DIR}
+  COMMENT "Copy wasm files to directory ${CMAKE_CURRENT_BINARY_DIR}"
+)
+
+gtest_discover_tests(${SHARED_HEAP_TEST})
@@ -0,0 +1,22 @@
+(module
+  ;; No max page count, it is clamped below the shared heap when attached
+  (memory (export "memory") 1)
+
+  (func (export "load") (param i32) (result i32) (i32.load (local.get 0)))
+  (func (export "store") (param i32 i32)
+    (i32.store (local.get 0) (local.get 1))
+  )
+  (func (export "grow") (param i32) (result i32) (memory.grow (local.get 0)))
+
+  (func (export "fill") (param $dst i32) (param $value i32) (param $n i32)
+    (memory.fill (local.get $dst) (local.get $value) (local.get $n))
+  )
+  (func (export "copy") (param $dst i32) (param $src i32) (param $n i32)
+    (memory.copy (local.get $dst) (local.get $src) (local.get $n))
+  )
+  (func (export "init") (param $dst i32) (param $offset i32) (param $n i32)
+    (memory.init $data (local.get $dst) (local.get $offset) (local.get $n))
+  )
+
+  (data $data "wamr")
+)
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "bh_platform.h"
+#include "ems/ems_gc.h"
+
+#include "gtest/gtest.h"
+
+/* Size of the VM objects kept in the slab lists */
+#define SMALL_OBJ_SIZE 32
+
+/* Tests of the EMS heap under wamr/core/shared/mem-alloc */
+class mem_alloc_test_suite : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        heap = gc_init_with_pool(heap_buf, sizeof(heap_buf));
+        ASSERT_NE(heap, nullptr);
+    }
+
+    virtual void TearDown() { gc_destroy_with_pool(heap); }
+
+  public:
+    char heap_buf[64 * 1024];
+    gc_handle_t heap = NULL;
+};
+
+TEST_F(mem_alloc_test_suite, double_free)
+{
+    void *obj1, *obj2;
+
+    obj1 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    ASSERT_NE(obj1, nullptr);
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_SUCCESS);
+
+    /* the block is kept in the slab list, freeing it again is rejected */
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_ERROR);
+    EXPECT_FALSE(gc_is_heap_corrupted(heap));
+
+    /* the block is only handed out once */
+    obj1 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    obj2 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    ASSERT_NE(obj1, nullptr);
+    ASSERT_NE(obj2, nullptr);
+    EXPECT_NE(obj1, obj2);
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_SUCCESS);
+    EXPECT_EQ(gc_free_vo(heap, obj2), GC_SUCCESS);
+}
+
+TEST_F(mem_alloc_test_suite, thread_cache_double_free)
+{
+    void *obj1, *obj2;
+
+    gc_enable_thread_cache(heap);
+
+    obj1 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    ASSERT_NE(obj1, nullptr);
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_SUCCESS);
+
+    /* the block is kept in the thread cache, freeing it again is
+       rejected instead of caching it twice */
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_ERROR);
+    EXPECT_FALSE(gc_is_heap_corrupted(heap));
+
+    obj1 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    obj2 = gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    ASSERT_NE(obj1, nullptr);
+    ASSERT_NE(obj2, nullptr);
+    EXPECT_NE(obj1, obj2);
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_SUCCESS);
+    EXPECT_EQ(gc_free_vo(heap, obj2), GC_SUCCESS);
+
+    /* the blocks returned to the heap are still rejected when freed
+       again */
+    gc_flush_thread_cache(heap);
+    EXPECT_EQ(gc_free_vo(heap, obj2), GC_ERROR);
+    EXPECT_FALSE(gc_is_heap_corrupted(heap));
+}
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+TEST_F(mem_alloc_test_suite, slab_flush_corrupted_list)
+{
+    uint8 *obj1, *obj2, *obj3, *base_addr;
+
+    obj1 = (uint8 *)gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    obj2 = (uint8 *)gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    obj3 = (uint8 *)gc_alloc_vo(heap, SMALL_OBJ_SIZE);
+    ASSERT_NE(obj1, nullptr);
+    ASSERT_NE(obj2, nullptr);
+    ASSERT_NE(obj3, nullptr);
+
+    /* the slab list is obj3 -> obj1, each freed object keeps the offset
+       of the next one from the heap base */
+    EXPECT_EQ(gc_free_vo(heap, obj1), GC_SUCCESS);
+    EXPECT_EQ(gc_free_vo(heap, obj3), GC_SUCCESS);
+    base_addr = obj1 - *(uint32 *)obj3;
+
+    /* link the allocated obj2 to the list like a guest writing the app
+       heap, the flush must not merge it into the free chunks */
+    *(uint32 *)obj1 = (uint32)(obj2 - base_addr);
+
+    /* an allocation larger than the free chunks flushes the slab lists */
+    EXPECT_EQ(gc_alloc_vo(heap, sizeof(heap_buf)), nullptr);
+    EXPECT_TRUE(gc_is_heap_corrupted(heap));
+}
+#endif
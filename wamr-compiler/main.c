@@ -126,6 +126,12 @@ print_help()
     printf("                            Use +feature to enable a feature, or -feature to disable it\n");
     printf("                            For example, --cpu-features=+feature1,-feature2\n");
     printf("                            Use --cpu-features=+help to list all the features supported\n");
+    printf("  --cpu-variants=<cpus>     Also generate the functions for the specified x86 CPUs, using comma to\n");
+    printf("                            separate, e.g. --cpu-variants=x86-64-v3,x86-64-v4, the runtime selects\n");
+    printf("                            the variant of the most capable CPU supported by the host at load time\n");
+    printf("  --cpu-variant-funcs=<indexes>\n");
+    printf("                            Set the indexes of the functions to generate the CPU variants, using\n");
+    printf("                            comma to separate, default is the hot functions in --use-prof-file\n");
     printf("  --opt-level=n             Set the optimization level (0 to 3, default is 3)\n");
     printf("  --size-level=n            Set the code size level (0 to 3, default is 3)\n");
     printf("                              0 - Large code model\n");
@@ -168,7 +174,13 @@ print_help()
     printf("  --enable-memory-profiling Enable memory usage profiling\n");
     printf("  --xip                     A shorthand of --enable-indirect-mode --disable-llvm-intrinsics\n");
     printf("  --enable-indirect-mode    Enable call function through symbol table but not direct call\n");
+    printf("  --enable-shared-text      Generate the text without relocations so that the runtime can map it\n");
+    printf("                              from the AOT file and share it among processes, implies\n");
+    printf("                              --enable-indirect-mode, only supported on x86_64\n");
     printf("  --enable-gc               Enable GC (Garbage Collection) feature\n");
+    printf("  --enable-exce-handling    Enable the exception handling feature (try/catch/throw/rethrow)\n");
+    printf("  --enable-shared-heap      Allow the memory accesses to the shared heap attached by the runtime\n");
+    printf("                              in the explicit bounds checks and the bulk memory operations\n");
     printf("  --disable-llvm-intrinsics Disable the LLVM built-in intrinsics\n");
     printf("  --enable-builtin-intrinsics=<flags>\n");
     printf("                            Enable the specified built-in intrinsics, it will override the default\n");
@@ -181,6 +193,9 @@ print_help()
     printf("  --enable-llvm-passes=<passes>\n");
     printf("                            Enable the specified LLVM passes, using comma to separate\n");
     printf("  --use-prof-file=<file>    Use profile file collected by LLVM PGO (Profile-Guided Optimization)\n");
+    printf("  --pre-init=<function>     Instantiate the module, call the exported function and bake the resulting\n");
+    printf("                            linear memory, globals and tables into the generated file, so that the\n");
+    printf("                            initialization doesn't need to run again at startup\n");
     printf("  --enable-segue[=<flags>]  Enable using segment register GS as the base address of linear memory,\n");
     printf("                            only available on linux x86-64, which may improve performance,\n");
     printf("                            flags can be: i32.load, i64.load, f32.load, f64.load, v128.load,\n");
@@ -196,6 +211,10 @@ print_help()
     printf("                            are shared object (.so) files, for example:\n");
     printf("                              --native-lib=test1.so --native-lib=test2.so\n");
 #endif
+    printf("  --link-module=<file>      Link the wasm module statically, the imports of module name \"foo\" are\n");
+    printf("                            resolved to the exports of --link-module=path/to/foo.wasm, and the\n");
+    printf("                            calls between the modules become direct calls, the modules must share\n");
+    printf("                            one linear memory, e.g. --link-module=libfoo.wasm --link-module=libbar.wasm\n");
     printf("  --invoke-c-api-import     Treat unknown import function as wasm-c-api import function and\n");
     printf("                            quick call it from AOT code\n");
 #if WASM_ENABLE_LINUX_PERF != 0
@@ -261,6 +280,76 @@ split_string(char *str, int *count, const char *delimer)
     return res;
 }
 
+/* The module name of "path/to/foo.wasm" is "foo" */
+static char *
+get_module_name(const char *file_name)
+{
+    const char *p = strrchr(file_name, '/');
+    char *module_name;
+    size_t len;
+
+    if (p)
+        file_name = p + 1;
+    len = strlen(file_name);
+    if (len > 5 && !strcmp(file_name + len - 5, ".wasm"))
+        len -= 5;
+
+    if (!(module_name = malloc(len + 1)))
+        return NULL;
+    memcpy(module_name, file_name, len);
+    module_name[len] = '\0';
+    return module_name;
+}
+
+/* Replace the main wasm file buffer with the linked one */
+static bool
+link_wasm_modules(const char *wasm_file_name, uint8 **p_wasm_file,
+                  uint32 *p_wasm_file_size, const char **link_module_list,
+                  uint32 link_module_count)
+{
+    const char *module_names[9] = { NULL };
+    uint8 *wasm_bufs[9] = { NULL }, *linked_buf;
+    uint32 wasm_buf_sizes[9], linked_size, i;
+    bool ret = false;
+
+    bh_assert(link_module_count < sizeof(module_names) / sizeof(char *));
+
+    wasm_bufs[0] = *p_wasm_file;
+    wasm_buf_sizes[0] = *p_wasm_file_size;
+    for (i = 0; i <= link_module_count; i++) {
+        if (!(module_names[i] = get_module_name(
+                  i == 0 ? wasm_file_name : link_module_list[i - 1]))) {
+            printf("Allocate memory failed.\n");
+            goto fail;
+        }
+        if (i > 0
+            && !(wasm_bufs[i] = (uint8 *)bh_read_file_to_buffer(
+                     link_module_list[i - 1], &wasm_buf_sizes[i])))
+            goto fail;
+    }
+
+    if (!aot_link_wasm_modules(module_names, wasm_bufs, wasm_buf_sizes,
+                               link_module_count + 1, &linked_buf,
+                               &linked_size)) {
+        printf("%s\n", aot_get_last_error());
+        goto fail;
+    }
+
+    wasm_runtime_free(*p_wasm_file);
+    *p_wasm_file = linked_buf;
+    *p_wasm_file_size = linked_size;
+    ret = true;
+
+fail:
+    for (i = 0; i <= link_module_count; i++) {
+        if (module_names[i])
+            free((char *)module_names[i]);
+        if (i > 0 && wasm_bufs[i])
+            wasm_runtime_free(wasm_bufs[i]);
+    }
+    return ret;
+}
+
 static uint32
 resolve_segue_flags(char *str_flags)
 {
@@ -333,6 +422,9 @@ main(int argc, char *argv[])
     AOTCompOption option = { 0 };
     char error_buf[128];
     int log_verbose_level = 2;
+    const char *pre_init_func = NULL;
+    const char *link_module_list[8] = { NULL };
+    uint32 link_module_count = 0;
     bool sgx_mode = false, size_level_set = false, use_dummy_wasm = false;
     int exit_status = EXIT_FAILURE;
 #if BH_HAS_DLFCN
@@ -398,6 +490,16 @@ main(int argc, char *argv[])
                 use_dummy_wasm = true;
             }
         }
+        else if (!strncmp(argv[0], "--cpu-variants=", 15)) {
+            if (argv[0][15] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.cpu_variants = argv[0] + 15;
+        }
+        else if (!strncmp(argv[0], "--cpu-variant-funcs=", 20)) {
+            if (argv[0][20] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.cpu_variant_funcs = argv[0] + 20;
+        }
         else if (!strncmp(argv[0], "--opt-level=", 12)) {
             if (argv[0][12] == '\0')
                 PRINT_HELP_AND_EXIT();
@@ -487,10 +589,20 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--enable-indirect-mode")) {
             option.is_indirect_mode = true;
         }
+        else if (!strcmp(argv[0], "--enable-shared-text")) {
+            option.is_indirect_mode = true;
+            option.enable_shared_text = true;
+        }
         else if (!strcmp(argv[0], "--enable-gc")) {
             option.enable_aux_stack_frame = true;
             option.enable_gc = true;
         }
+        else if (!strcmp(argv[0], "--enable-exce-handling")) {
+            option.enable_exce_handling = true;
+        }
+        else if (!strcmp(argv[0], "--enable-shared-heap")) {
+            option.enable_shared_heap = true;
+        }
         else if (!strcmp(argv[0], "--disable-llvm-intrinsics")) {
             option.disable_llvm_intrinsics = true;
         }
@@ -515,6 +627,11 @@ main(int argc, char *argv[])
                 PRINT_HELP_AND_EXIT();
             option.use_prof_file = argv[0] + 16;
         }
+        else if (!strncmp(argv[0], "--pre-init=", 11)) {
+            if (argv[0][11] == '\0')
+                PRINT_HELP_AND_EXIT();
+            pre_init_func = argv[0] + 11;
+        }
         else if (!strcmp(argv[0], "--enable-segue")) {
             /* all flags are enabled */
             option.segue_flags = 0x1F1F;
@@ -551,6 +668,17 @@ main(int argc, char *argv[])
             native_lib_list[native_lib_count++] = argv[0] + 13;
         }
 #endif
+        else if (!strncmp(argv[0], "--link-module=", 14)) {
+            if (argv[0][14] == '\0')
+                PRINT_HELP_AND_EXIT();
+            if (link_module_count
+                >= sizeof(link_module_list) / sizeof(char *)) {
+                printf("Only allow max link module number %d\n",
+                       (int)(sizeof(link_module_list) / sizeof(char *)));
+                goto fail0;
+            }
+            link_module_list[link_module_count++] = argv[0] + 14;
+        }
         else if (!strcmp(argv[0], "--invoke-c-api-import")) {
             option.quick_invoke_c_api_import = true;
         }
@@ -677,6 +805,14 @@ main(int argc, char *argv[])
         goto fail2;
     }
 
+    if (link_module_count > 0 && !use_dummy_wasm) {
+        bh_print_time("Begin to link wasm modules");
+
+        if (!link_wasm_modules(wasm_file_name, &wasm_file, &wasm_file_size,
+                               link_module_list, link_module_count))
+            goto fail2;
+    }
+
     /* load WASM module */
     if (!(wasm_module = wasm_runtime_load(wasm_file, wasm_file_size, error_buf,
                                           sizeof(error_buf)))) {
@@ -684,6 +820,19 @@ main(int argc, char *argv[])
         goto fail2;
     }
 
+    if (pre_init_func) {
+        bh_print_time("Begin to pre-initialize");
+
+#if WASM_ENABLE_LIBC_WASI != 0
+        wasm_runtime_set_wasi_args(wasm_module, NULL, 0, NULL, 0, NULL, 0, NULL,
+                                   0);
+#endif
+        if (!aot_pre_initialize_module(wasm_module, pre_init_func)) {
+            printf("%s\n", aot_get_last_error());
+            goto fail3;
+        }
+    }
+
     if (!(comp_data = aot_create_comp_data(wasm_module, option.target_arch,
                                            option.enable_gc))) {
         printf("%s\n", aot_get_last_error());